@@ -0,0 +1,186 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Conversion of a cao model file into a binary model file.
+ *
+ *****************************************************************************/
+
+/*!
+  \file mbtConvertModel.cpp
+
+  \brief Conversion of a cao model file, and the files it includes, into a
+  binary model file that the model-based trackers load without parsing.
+*/
+
+/*!
+  \example mbtConvertModel.cpp
+
+  Conversion of a cao model file, and the files it includes, into a binary
+  model file that the model-based trackers load without parsing.
+*/
+
+#include <iostream>
+#include <stdio.h>
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/io/vpParseArgv.h>
+#include <visp3/mbt/vpMbtCadModel.h>
+
+#define GETOPTARGS "i:o:vh"
+
+void usage(const char *name, const char *badparam);
+bool getOptions(int argc, const char **argv, std::string &input, std::string &output, bool &verbose);
+
+void usage(const char *name, const char *badparam)
+{
+  fprintf(stdout, "\n\
+Convert a cao model file into a binary model file.\n\
+\n\
+SYNOPSIS\n\
+  %s -i <input cao file> [-o <output bcao file>] [-v] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -i <input cao file>\n\
+     CAD model in the cao format. The files it includes\n\
+     are converted with it.\n\
+\n\
+  -o <output bcao file>                                input with .bcao\n\
+     Binary model file to create.\n\
+\n\
+  -v\n\
+     Print the content of the model.\n\
+\n\
+  -h\n\
+     Print the help.\n");
+
+  if (badparam)
+    fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+}
+
+bool getOptions(int argc, const char **argv, std::string &input, std::string &output, bool &verbose)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'i':
+      input = optarg_;
+      break;
+    case 'o':
+      output = optarg_;
+      break;
+    case 'v':
+      verbose = true;
+      break;
+    case 'h':
+      usage(argv[0], NULL);
+      return false;
+      break;
+
+    default:
+      usage(argv[0], optarg_);
+      return false;
+      break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  if (input.empty()) {
+    usage(argv[0], NULL);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  The input cao file is missing" << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    std::string input, output;
+    bool verbose = false;
+
+    if (!getOptions(argc, argv, input, output, verbose)) {
+      return EXIT_FAILURE;
+    }
+
+    if (output.empty()) {
+      output = vpIoTools::getNameWE(input) + ".bcao";
+      output = vpIoTools::createFilePath(vpIoTools::getParent(input), output);
+    }
+
+    vpMbtCadModel model;
+    model.loadCAO(input, verbose);
+    model.saveBinary(output);
+
+    std::cout << "Model " << input << " converted into " << output << std::endl;
+    std::cout << "> " << model.getNbPoints() << " points" << std::endl;
+    std::cout << "> " << model.getNbPrimitives() << " primitives" << std::endl;
+
+    // Check that the binary model can be read back
+    vpMbtCadModel binary;
+    binary.loadBinary(output);
+    if (binary.getNbPrimitives() != model.getNbPrimitives() || binary.getPoints() != model.getPoints() ||
+        binary.getPointIndexes() != model.getPointIndexes()) {
+      std::cerr << "The binary model " << output << " does not match " << input << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+
+int main()
+{
+  std::cout << "Cannot run this example: visp_mbt module is not available." << std::endl;
+  return 0;
+}
+
+#endif
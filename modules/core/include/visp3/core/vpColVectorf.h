@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Single precision column vector.
+ *
+ *****************************************************************************/
+
+#ifndef _vpColVectorf_h_
+#define _vpColVectorf_h_
+
+#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpColVector.h>
+
+/*!
+  \file vpColVectorf.h
+  \brief Definition of the single precision column vector class.
+*/
+
+/*!
+  \class vpColVectorf
+  \ingroup group_core_matrices
+
+  \brief Implementation of a column vector of single precision values.
+
+  This class is the float counterpart of vpColVector. It is intended for
+  throughput bound pipelines, like the interaction matrices built from dense
+  depth or luminance features, where the memory traffic and the SIMD width
+  matter more than the precision of each coefficient. The reductions
+  (dot products, norms) are accumulated in double precision.
+
+  The conversion with vpColVector is explicit:
+  \code
+#include <visp3/core/vpColVectorf.h>
+
+int main()
+{
+  vpColVector v(3, 1.);
+  vpColVectorf vf(v);           // double to float
+  vpColVector v2 = vf.toColVector(); // float to double
+}
+  \endcode
+
+  \sa vpMatrixf
+*/
+class VISP_EXPORT vpColVectorf : public vpArray2D<float>
+{
+  friend class vpMatrixf;
+
+public:
+  //! Basic constructor that creates an empty 0-size column vector.
+  vpColVectorf() : vpArray2D<float>() {}
+  //! Construct a column vector of size n. All the elements are initialized to zero.
+  explicit vpColVectorf(unsigned int n) : vpArray2D<float>(n, 1) {}
+  //! Construct a column vector of size n. Each element is set to \e val.
+  vpColVectorf(unsigned int n, float val) : vpArray2D<float>(n, 1, val) {}
+  //! Copy constructor.
+  vpColVectorf(const vpColVectorf &v) : vpArray2D<float>(v) {}
+  explicit vpColVectorf(const vpColVector &v);
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  vpColVectorf(vpColVectorf &&v);
+#endif
+  /*!
+    Destructor.
+  */
+  virtual ~vpColVectorf() {}
+
+  void buildFrom(const vpColVector &v);
+
+  double frobeniusNorm() const;
+  void insert(unsigned int i, const vpColVectorf &v);
+
+  inline float &operator[](unsigned int n) { return *(data + n); }
+  inline const float &operator[](unsigned int n) const { return *(data + n); }
+  vpColVectorf &operator=(const vpColVectorf &v);
+  vpColVectorf &operator=(float x);
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  vpColVectorf &operator=(vpColVectorf &&v);
+#endif
+
+  double operator*(const vpColVectorf &v) const;
+  vpColVectorf operator*(float x) const;
+  vpColVectorf &operator*=(float x);
+  vpColVectorf operator+(const vpColVectorf &v) const;
+  vpColVectorf &operator+=(const vpColVectorf &v);
+  vpColVectorf operator-(const vpColVectorf &v) const;
+  vpColVectorf &operator-=(const vpColVectorf &v);
+  vpColVectorf operator-() const;
+
+  /*!
+    Modify the size of the column vector.
+    \param i : Size of the vector.
+    \param flagNullify : If true, set the data to zero.
+   */
+  void resize(unsigned int i, bool flagNullify = true) { vpArray2D<float>::resize(i, 1, flagNullify); }
+
+  double sumSquare() const;
+  vpColVector toColVector() const;
+};
+
+#endif
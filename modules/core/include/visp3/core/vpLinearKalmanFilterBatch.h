@@ -0,0 +1,180 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Batched linear Kalman filtering of many independent signals.
+ *
+ *****************************************************************************/
+
+#ifndef vpLinearKalmanFilterBatch_h
+#define vpLinearKalmanFilterBatch_h
+
+#include <vector>
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpLinearKalmanFilterInstantiation.h>
+#include <visp3/core/vpMatrix.h>
+
+/*!
+  \file vpLinearKalmanFilterBatch.h
+  \brief Batched implementation of the linear Kalman filters of
+  vpLinearKalmanFilterInstantiation.
+*/
+
+/*!
+  \class vpLinearKalmanFilterBatch
+  \ingroup group_core_kalman
+  \brief Batched implementation of the linear Kalman filters provided by
+  vpLinearKalmanFilterInstantiation, intended to filter a large number of
+  independent signals (e.g. hundreds of tracked blobs or points).
+
+  vpLinearKalmanFilterInstantiation stacks all the signals in a single state
+  vector and uses dense \f$ n \times n \f$ matrices with \f$ n \f$ the state
+  size multiplied by the number of signals, so that the cost of one iteration
+  grows with the cube of the number of signals. Since the signals are
+  independent and share the same state model, all the matrices are block
+  diagonal with identical transition blocks.
+
+  This class only stores, for each signal, its state vector and its
+  symmetric state covariance in a structure of arrays layout: the
+  \f$ k \f$-th component of all the signals is contiguous in memory.
+  Prediction and filtering are then run with SIMD instructions over the
+  signals, using the known constant velocity or acceleration transition
+  block. The cost of one iteration is linear in the number of signals.
+
+  The state models, the initialization and the results are the same as the
+  ones of vpLinearKalmanFilterInstantiation.
+
+  \code
+#include <visp3/core/vpLinearKalmanFilterBatch.h>
+
+int main()
+{
+  unsigned int nsignal = 500;
+  vpLinearKalmanFilterBatch kalman;
+  kalman.setStateModel(vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos);
+
+  vpColVector sigma_state(2 * nsignal), sigma_measure(nsignal, 1e-6);
+  for (unsigned int i = 0; i < nsignal; i++) {
+    sigma_state[2 * i] = 1e-6;
+  }
+  double dt = 0.04, dummy = 0;
+  kalman.initFilter(nsignal, sigma_state, sigma_measure, dummy, dt);
+
+  vpColVector z(nsignal);
+  for ( ; ; ) {
+    // z[i] = ... measured position of the i-th signal
+    kalman.filter(z);
+    // kalman.getStateEstimate(i, 0) is the filtered position of the i-th signal
+    // kalman.getStateEstimate(i, 1) is its velocity
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpLinearKalmanFilterBatch
+{
+public:
+  vpLinearKalmanFilterBatch();
+  /*! Destructor that does nothing. */
+  virtual ~vpLinearKalmanFilterBatch() {}
+
+  void filter(const vpColVector &z);
+  void filtering(const vpColVector &z);
+  void prediction();
+
+  vpMatrix getCovarianceEstimate(unsigned int signal) const;
+  vpMatrix getCovariancePrediction(unsigned int signal) const;
+  /*!
+    Return the iteration number.
+  */
+  inline long getIteration() const { return m_iter; }
+  /*!
+    Return the size of the measure vector for one signal.
+  */
+  inline unsigned int getMeasureSize() const { return m_size_measure; }
+  /*!
+    Return the number of signal to filter.
+  */
+  inline unsigned int getNumberOfSignal() const { return m_nsignal; }
+  /*!
+    Return the current state model.
+  */
+  inline vpLinearKalmanFilterInstantiation::vpStateModel getStateModel() const { return m_model; }
+  /*!
+    Return the \e i-th component of the updated state estimate of a signal.
+  */
+  inline double getStateEstimate(unsigned int signal, unsigned int i) const { return m_xest[i][signal]; }
+  void getStateEstimate(vpColVector &Xest) const;
+  /*!
+    Return the \e i-th component of the predicted state of a signal.
+  */
+  inline double getStatePrediction(unsigned int signal, unsigned int i) const { return m_xpre[i][signal]; }
+  void getStatePrediction(vpColVector &Xpre) const;
+  /*!
+    Return the size of the state vector for one signal.
+  */
+  inline unsigned int getStateSize() const { return m_size_state; }
+
+  void initFilter(unsigned int nsignal, const vpColVector &sigma_state, const vpColVector &sigma_measure, double rho,
+                  double dt);
+  void setStateModel(vpLinearKalmanFilterInstantiation::vpStateModel model);
+
+protected:
+  //! State model.
+  vpLinearKalmanFilterInstantiation::vpStateModel m_model;
+  //! Filter iteration. When set to zero, initialize the filter.
+  long m_iter;
+  //! Size of the state vector of one signal.
+  unsigned int m_size_state;
+  //! Size of the measure vector of one signal.
+  unsigned int m_size_measure;
+  //! Number of signal to filter.
+  unsigned int m_nsignal;
+  //! Sampling time.
+  double m_dt;
+  //! Transition block shared by all the signals.
+  double m_F[3][3];
+  //! Updated state estimate, one array per state component.
+  std::vector<double> m_xest[3];
+  //! Predicted state, one array per state component.
+  std::vector<double> m_xpre[3];
+  //! Updated state covariance, one array per coefficient of the upper triangle.
+  std::vector<double> m_pest[6];
+  //! Predicted state covariance, one array per coefficient of the upper triangle.
+  std::vector<double> m_ppre[6];
+  //! Process noise covariance, one array per coefficient of the upper triangle.
+  std::vector<double> m_q[6];
+  //! Measurement noise variance.
+  std::vector<double> m_r;
+
+  void init(unsigned int nsignal);
+};
+
+#endif
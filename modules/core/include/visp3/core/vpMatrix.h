@@ -515,6 +515,7 @@ vpMatrix M(R);
 
   // singular value decomposition SVD
   void svd(vpColVector &w, vpMatrix &V);
+  void svdJacobi(vpColVector &w, vpMatrix &V);
 #ifdef VISP_HAVE_EIGEN3
   void svdEigen3(vpColVector &w, vpMatrix &V);
 #endif
@@ -0,0 +1,163 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Single precision matrix.
+ *
+ *****************************************************************************/
+
+#ifndef _vpMatrixf_h_
+#define _vpMatrixf_h_
+
+#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpColVectorf.h>
+#include <visp3/core/vpMatrix.h>
+
+/*!
+  \file vpMatrixf.h
+  \brief Definition of the single precision matrix class.
+*/
+
+/*!
+  \class vpMatrixf
+  \ingroup group_core_matrices
+
+  \brief Implementation of a matrix of single precision values.
+
+  This class is the float counterpart of vpMatrix. It is intended to store
+  tall matrices, like the interaction matrices of dense depth or luminance
+  features that have tens of thousands of rows, with half the memory of a
+  vpMatrix and twice the SIMD width.
+
+  The normal equations built from such a matrix, \f$ {\bf A}^T {\bf A} \f$
+  with AtA() and \f$ {\bf A}^T {\bf b} \f$ with AtB(), are accumulated in
+  double precision and returned as vpMatrix and vpColVector so that the
+  small linear system that follows is solved in double precision.
+
+  \code
+#include <visp3/core/vpMatrixf.h>
+
+int main()
+{
+  vpMatrixf L(10000, 6);
+  vpColVector e(10000);
+  // ... fill L and e
+
+  vpMatrix LTL;
+  vpColVector LTe;
+  L.AtA(LTL);    // accumulated in double
+  L.AtB(e, LTe); // accumulated in double
+  vpColVector v = -LTL.pseudoInverse() * LTe;
+}
+  \endcode
+
+  The conversion with vpMatrix is explicit, see vpMatrixf(const vpMatrix &)
+  and toMatrix().
+
+  \sa vpColVectorf
+*/
+class VISP_EXPORT vpMatrixf : public vpArray2D<float>
+{
+public:
+  //! Basic constructor of a matrix of float. Number of columns and rows are zero.
+  vpMatrixf() : vpArray2D<float>(0, 0) {}
+  //! Constructor that initialize a matrix of float with 0.
+  vpMatrixf(unsigned int r, unsigned int c) : vpArray2D<float>(r, c) {}
+  //! Constructor that initialize a matrix of float with \e val.
+  vpMatrixf(unsigned int r, unsigned int c, float val) : vpArray2D<float>(r, c, val) {}
+  //! Copy constructor.
+  vpMatrixf(const vpMatrixf &A) : vpArray2D<float>(A) {}
+  explicit vpMatrixf(const vpMatrix &A);
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  vpMatrixf(vpMatrixf &&A);
+#endif
+
+  //! Destructor (Memory de-allocation)
+  virtual ~vpMatrixf() {}
+
+  /** @name Conversion with double precision  */
+  //@{
+  void buildFrom(const vpMatrix &A);
+  vpMatrix toMatrix() const;
+  //@}
+
+  /** @name Setting a diagonal matrix  */
+  //@{
+  void eye();
+  void eye(unsigned int n);
+  //@}
+
+  /** @name Assignment operators  */
+  //@{
+  vpMatrixf &operator=(const vpMatrixf &A);
+  vpMatrixf &operator=(float x);
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  vpMatrixf &operator=(vpMatrixf &&A);
+#endif
+  //@}
+
+  /** @name Matrix operations  */
+  //@{
+  vpMatrixf operator*(const vpMatrixf &B) const;
+  vpColVectorf operator*(const vpColVectorf &v) const;
+  vpMatrixf operator*(float x) const;
+  vpMatrixf &operator*=(float x);
+  vpMatrixf operator+(const vpMatrixf &B) const;
+  vpMatrixf &operator+=(const vpMatrixf &B);
+  vpMatrixf operator-(const vpMatrixf &B) const;
+  vpMatrixf &operator-=(const vpMatrixf &B);
+
+  vpMatrixf t() const;
+  vpMatrixf transpose() const;
+  void transpose(vpMatrixf &At) const;
+
+  double frobeniusNorm() const;
+  //@}
+
+  /** @name Normal equations accumulated in double precision  */
+  //@{
+  vpMatrix AtA() const;
+  void AtA(vpMatrix &AtA) const;
+  void AtB(const vpColVector &b, vpColVector &Atb) const;
+  //@}
+
+  /** @name Insert  */
+  //@{
+  void insert(const vpMatrixf &A, unsigned int r, unsigned int c);
+  //@}
+
+  /** @name SVD decomposition  */
+  //@{
+  void svd(vpColVectorf &w, vpMatrixf &V);
+  //@}
+};
+
+#endif
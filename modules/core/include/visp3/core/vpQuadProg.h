@@ -66,7 +66,13 @@
   Inequality constraints are solved with active sets.
 
   In order to be used sequentially, the decomposition of the equality constraint may be stored.
-  The last active set is always stored and used to warm start the next call.
+  The last active set and the last solution are always stored and used to warm start the next call.
+  The decomposition of the equality constraint passed to solveQP() is also kept and reused as long as
+  this constraint does not change. This is typically the case in a control loop that solves
+  nearly the same QP at each iteration.
+
+  The number of active set iterations and the solving time of the last call are available with
+  getIterationCount() and getSolvingTime().
 
   \warning The solvers are only available if c++11 or higher is activated during build.
   Configure ViSP using cmake -DUSE_CXX_STANDARD=11.
@@ -75,6 +81,12 @@ class VISP_EXPORT vpQuadProg
 {
 public:
 #if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  vpQuadProg()
+    : active(), inactive(), x1(), Z(), x_last(), A_eq(), b_eq(), Z_eq(), x1_eq(), tol_eq(0), iter_count(0),
+      solving_time(0), warm_started(false)
+  {
+  }
+
   /** @name Instanciated solvers  */
   //@{
   bool solveQPe(const vpMatrix &Q, const vpColVector &r,
@@ -96,14 +108,32 @@ public:
   //@{
   bool setEqualityConstraint(const vpMatrix &A, const vpColVector &b, const double &tol = 1e-6);
   /*!
-    Resets the active set that was found by a previous call to solveQP() or solveQPi(), if any.
+    Resets the active set and the solution that were found by a previous call to solveQP() or solveQPi(), if any.
   */
   void resetActiveSet()
   {
     active.clear();
+    x_last.resize(0);
   }
   //@}
 
+  /** @name Statistics of the last call to solvers  */
+  //@{
+  /*!
+    Return the number of active set iterations of the last call to solveQP() or solveQPi().
+  */
+  unsigned int getIterationCount() const { return iter_count; }
+  /*!
+    Return the time in ms spent in the last call to solveQP() or solveQPi().
+  */
+  double getSolvingTime() const { return solving_time; }
+  /*!
+    Return true if the last call to solveQP() or solveQPi() started from the previous active set or solution,
+    false if a feasible point had to be computed with the simplex.
+  */
+  bool isWarmStarted() const { return warm_started; }
+  //@}
+
   static void fromCanonicalCost(const vpMatrix &H, const vpColVector &c, vpMatrix &Q, vpColVector &r, const double &tol = 1e-6);
   static bool solveQPe(const vpMatrix &Q, const vpColVector &r,
                 vpMatrix A, vpColVector b,
@@ -126,6 +156,33 @@ protected:
     Stored projection to the kernel from the last call to setEqualityConstraint().
   */
   vpMatrix Z;
+  /*!
+    Solution from the last call to solveQP() or solveQPi(), in the coordinates of the original problem. Used for warm
+    starting the next call if still feasible.
+  */
+  vpColVector x_last;
+  /*!
+    Equality constraint from the last call to solveQP(), compared to the next one to reuse its decomposition.
+  */
+  vpMatrix A_eq;
+  vpColVector b_eq;
+  /*!
+    Decomposition of the equality constraint from the last call to solveQP().
+  */
+  vpMatrix Z_eq;
+  vpColVector x1_eq;
+  double tol_eq;
+  //! Number of active set iterations of the last call.
+  unsigned int iter_count;
+  //! Time in ms of the last call.
+  double solving_time;
+  //! True if the last call did not need the simplex to find a feasible point.
+  bool warm_started;
+
+  bool solveActiveSet(const vpMatrix &Q, const vpColVector &r,
+                      const vpMatrix &C, const vpColVector &d,
+                      vpColVector &x, const vpMatrix &Zr, const vpColVector &xr,
+                      const double &tol = 1e-6);
 
   static vpColVector solveSVDorQR(const vpMatrix &A, const vpColVector &b);
 
@@ -44,6 +44,8 @@
 #ifndef CROBUST_HH
 #define CROBUST_HH
 
+#include <vector>
+
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpMath.h>
@@ -54,6 +56,12 @@
   \brief Contains an M-Estimator and various influence function.
 
   Supported methods: M-estimation, Tukey, Cauchy and Huber
+
+  The median and the median absolute deviation are obtained with a linear
+  time selection (std::nth_element) on internal buffers that are kept between
+  two calls, so that iterative estimations with a constant number of residues
+  do not allocate memory. The influence functions are evaluated with SSE2
+  when the CPU supports it.
 */
 class VISP_EXPORT vpRobust
 {
@@ -64,11 +72,11 @@ public:
 
 private:
   //! Normalized residue
-  vpColVector normres;
+  std::vector<double> normres;
   //! Sorted normalized Residues
-  vpColVector sorted_normres;
+  std::vector<double> sorted_normres;
   //! Sorted residues
-  vpColVector sorted_residues;
+  std::vector<double> sorted_residues;
 
   //! Noise threshold
   double NoiseThreshold;
@@ -76,8 +84,6 @@ private:
   double sig_prev;
   //!
   unsigned int it;
-  //! Vairiable used in swap method
-  double swap;
   //! Size of the containers
   unsigned int size;
 
@@ -126,11 +132,14 @@ public:
 
 private:
   //! Compute normalized median
-  double computeNormalizedMedian(vpColVector &all_normres, const vpColVector &residues, const vpColVector &all_residues,
-                                 const vpColVector &weights);
+  double computeNormalizedMedian(std::vector<double> &all_normres, const vpColVector &residues,
+                                 const vpColVector &all_residues, const vpColVector &weights);
 
   //! Calculate various scale estimates
-  double simultscale(vpColVector &x);
+  double simultscale(const vpColVector &x);
+
+  //! Compute the weights from the normalized residues and the scale
+  void psi(vpRobustEstimatorType method, double sigma, const std::vector<double> &x, unsigned int n, vpColVector &w);
 
   //---------------------------------
   //  Partial derivative of loss function with respect to the residue
@@ -138,11 +147,11 @@ private:
   /** @name PsiFunctions  */
   //@{
   //! Tuckey influence function
-  void psiTukey(double sigma, vpColVector &x, vpColVector &w);
+  void psiTukey(double sigma, const std::vector<double> &x, unsigned int n, vpColVector &w);
   //! Caucht influence function
-  void psiCauchy(double sigma, vpColVector &x, vpColVector &w);
+  void psiCauchy(double sigma, const std::vector<double> &x, unsigned int n, vpColVector &w);
   //! Huber influence function
-  void psiHuber(double sigma, vpColVector &x, vpColVector &w);
+  void psiHuber(double sigma, const std::vector<double> &x, unsigned int n, vpColVector &w);
   //@}
 
   //! Partial derivative of loss function
@@ -178,19 +187,12 @@ private:
 //@}
 #endif
 
-  /** @name Sort function  */
+  /** @name Selection functions  */
   //@{
-  //! Swap two value
-  void exch(double &A, double &B)
-  {
-    swap = A;
-    A = B;
-    B = swap;
-  }
-  //! Sort function using partition method
-  int partition(vpColVector &a, int l, int r);
-  //! Sort the vector and select a value in the sorted vector
-  double select(vpColVector &a, int l, int r, int k);
+  //! Select the k-th smallest value among the n first elements of a vector
+  static double select(std::vector<double> &a, unsigned int n, unsigned int k);
+  //! Compute the absolute deviation of the n first residues to a given value
+  static void absDiff(const double *residues, unsigned int n, double med, std::vector<double> &normres);
   //@}
 };
 
@@ -0,0 +1,481 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Batched linear Kalman filtering of many independent signals.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpLinearKalmanFilterBatch.cpp
+  \brief Batched implementation of some specific linear Kalman filters.
+*/
+
+#include <algorithm>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpLinearKalmanFilterBatch.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Index of the coefficient (i, j) in the packed upper triangle of a n-by-n
+// symmetric matrix
+inline unsigned int upper(unsigned int n, unsigned int i, unsigned int j)
+{
+  if (i > j) {
+    std::swap(i, j);
+  }
+  return i * n - (i * (i - 1)) / 2 + (j - i);
+}
+
+// The kernels below are written once for a generic "lane" that processes
+// one signal (ScalarLane) or two signals (SSE2Lane) at a time.
+struct ScalarLane {
+  typedef double type;
+  static const unsigned int width = 1;
+  static inline type load(const double *p) { return *p; }
+  static inline void store(double *p, type v) { *p = v; }
+  static inline type set1(double v) { return v; }
+  static inline type zero() { return 0.0; }
+  static inline type add(type a, type b) { return a + b; }
+  static inline type sub(type a, type b) { return a - b; }
+  static inline type mul(type a, type b) { return a * b; }
+  static inline type div(type a, type b) { return a / b; }
+};
+
+#if VISP_HAVE_SSE2
+struct SSE2Lane {
+  typedef __m128d type;
+  static const unsigned int width = 2;
+  static inline type load(const double *p) { return _mm_loadu_pd(p); }
+  static inline void store(double *p, type v) { _mm_storeu_pd(p, v); }
+  static inline type set1(double v) { return _mm_set1_pd(v); }
+  static inline type zero() { return _mm_setzero_pd(); }
+  static inline type add(type a, type b) { return _mm_add_pd(a, b); }
+  static inline type sub(type a, type b) { return _mm_sub_pd(a, b); }
+  static inline type mul(type a, type b) { return _mm_mul_pd(a, b); }
+  static inline type div(type a, type b) { return _mm_div_pd(a, b); }
+};
+#endif
+
+/*
+  Prediction of the signals in [begin, end) by chunks of Lane::width signals:
+  Xpre = F Xest and Ppre = F Pest F^T + Q. Returns the first signal that was
+  not processed.
+*/
+template <class Lane>
+unsigned int predict(unsigned int n, const double F[3][3], const std::vector<double> *xest,
+                     const std::vector<double> *pest, const std::vector<double> *q, std::vector<double> *xpre,
+                     std::vector<double> *ppre, unsigned int begin, unsigned int end)
+{
+  typedef typename Lane::type T;
+  unsigned int s = begin;
+  for (; s + Lane::width <= end; s += Lane::width) {
+    T x[3], P[3][3], FP[3][3];
+    for (unsigned int i = 0; i < n; i++) {
+      x[i] = Lane::load(&xest[i][s]);
+      for (unsigned int j = i; j < n; j++) {
+        P[i][j] = P[j][i] = Lane::load(&pest[upper(n, i, j)][s]);
+      }
+    }
+
+    // The transition block is sparse, zero coefficients are skipped
+    for (unsigned int i = 0; i < n; i++) {
+      T xi = Lane::zero();
+      for (unsigned int k = 0; k < n; k++) {
+        if (F[i][k] != 0.0) {
+          xi = Lane::add(xi, Lane::mul(Lane::set1(F[i][k]), x[k]));
+        }
+      }
+      Lane::store(&xpre[i][s], xi);
+
+      for (unsigned int j = 0; j < n; j++) {
+        FP[i][j] = Lane::zero();
+        for (unsigned int k = 0; k < n; k++) {
+          if (F[i][k] != 0.0) {
+            FP[i][j] = Lane::add(FP[i][j], Lane::mul(Lane::set1(F[i][k]), P[k][j]));
+          }
+        }
+      }
+    }
+
+    for (unsigned int i = 0; i < n; i++) {
+      for (unsigned int j = i; j < n; j++) {
+        const unsigned int idx = upper(n, i, j);
+        T pij = Lane::load(&q[idx][s]);
+        for (unsigned int k = 0; k < n; k++) {
+          if (F[j][k] != 0.0) {
+            pij = Lane::add(pij, Lane::mul(FP[i][k], Lane::set1(F[j][k])));
+          }
+        }
+        Lane::store(&ppre[idx][s], pij);
+      }
+    }
+  }
+  return s;
+}
+
+/*
+  Filtering of the signals in [begin, end) by chunks of Lane::width signals.
+  Since the measure is the first state component, H = [1 0 0] and the
+  innovation covariance S = H Ppre H^T + R is a scalar. The gain is
+  W = Ppre H^T / S and Pest = Ppre - W S W^T. Returns the first signal that
+  was not processed.
+*/
+template <class Lane>
+unsigned int update(unsigned int n, const double *z, const std::vector<double> &r, const std::vector<double> *xpre,
+                    const std::vector<double> *ppre, std::vector<double> *xest, std::vector<double> *pest,
+                    unsigned int begin, unsigned int end)
+{
+  typedef typename Lane::type T;
+  unsigned int s = begin;
+  for (; s + Lane::width <= end; s += Lane::width) {
+    T P0[3];
+    for (unsigned int i = 0; i < n; i++) {
+      P0[i] = Lane::load(&ppre[upper(n, 0, i)][s]);
+    }
+    const T S = Lane::add(P0[0], Lane::load(&r[s]));
+    const T innovation = Lane::sub(Lane::load(z + s), Lane::load(&xpre[0][s]));
+
+    T W[3];
+    for (unsigned int i = 0; i < n; i++) {
+      W[i] = Lane::div(P0[i], S);
+      Lane::store(&xest[i][s], Lane::add(Lane::load(&xpre[i][s]), Lane::mul(W[i], innovation)));
+    }
+
+    for (unsigned int i = 0; i < n; i++) {
+      for (unsigned int j = i; j < n; j++) {
+        const unsigned int idx = upper(n, i, j);
+        Lane::store(&pest[idx][s], Lane::sub(Lane::load(&ppre[idx][s]), Lane::mul(Lane::mul(W[i], S), W[j])));
+      }
+    }
+  }
+  return s;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default batched linear Kalman filter.
+
+  By default the state model is unknown and set to
+  vpLinearKalmanFilterInstantiation::unknown.
+*/
+vpLinearKalmanFilterBatch::vpLinearKalmanFilterBatch()
+  : m_model(vpLinearKalmanFilterInstantiation::unknown), m_iter(0), m_size_state(0), m_size_measure(0),
+    m_nsignal(0), m_dt(-1), m_r()
+{
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 3; j++) {
+      m_F[i][j] = 0;
+    }
+  }
+}
+
+/*!
+  Set the Kalman state model. Depending on the state model, we set the state
+  vector size and the measure vector size.
+
+  \sa vpLinearKalmanFilterInstantiation::setStateModel()
+*/
+void vpLinearKalmanFilterBatch::setStateModel(vpLinearKalmanFilterInstantiation::vpStateModel model)
+{
+  m_model = model;
+  switch (m_model) {
+  case vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos:
+  case vpLinearKalmanFilterInstantiation::stateConstVelWithColoredNoise_MeasureVel:
+    m_size_state = 2;
+    m_size_measure = 1;
+    break;
+  case vpLinearKalmanFilterInstantiation::stateConstAccWithColoredNoise_MeasureVel:
+    m_size_state = 3;
+    m_size_measure = 1;
+    break;
+  case vpLinearKalmanFilterInstantiation::unknown:
+    m_size_state = 0;
+    m_size_measure = 0;
+    break;
+  }
+}
+
+void vpLinearKalmanFilterBatch::init(unsigned int nsignal)
+{
+  m_nsignal = nsignal;
+  m_iter = 0;
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 3; j++) {
+      m_F[i][j] = 0;
+    }
+    m_xest[i].assign(i < m_size_state ? nsignal : 0, 0.0);
+    m_xpre[i].assign(i < m_size_state ? nsignal : 0, 0.0);
+  }
+  const unsigned int nupper = (m_size_state * (m_size_state + 1)) / 2;
+  for (unsigned int i = 0; i < 6; i++) {
+    m_pest[i].assign(i < nupper ? nsignal : 0, 0.0);
+    m_ppre[i].assign(i < nupper ? nsignal : 0, 0.0);
+    m_q[i].assign(i < nupper ? nsignal : 0, 0.0);
+  }
+  m_r.assign(nsignal, 0.0);
+}
+
+/*!
+  Initialize the filter for the state model set with setStateModel().
+
+  The parameters and their layout are the same as the ones of
+  vpLinearKalmanFilterInstantiation::initFilter(): \e sigma_state has
+  getStateSize() values per signal and \e sigma_measure one value per signal.
+
+  \exception vpException::badValue : Bad rho value wich is not in [0:1[ or
+  bad vector size.
+
+  \exception vpException::notInitialized : If the state model is not
+  initialized. To initialize it you need to call setStateModel().
+*/
+void vpLinearKalmanFilterBatch::initFilter(unsigned int nsignal, const vpColVector &sigma_state,
+                                           const vpColVector &sigma_measure, double rho, double dt)
+{
+  if (m_model == vpLinearKalmanFilterInstantiation::unknown) {
+    throw(vpException(vpException::notInitialized, "Kalman state model is not set"));
+  }
+  if (m_model != vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos && ((rho < 0) || (rho >= 1))) {
+    throw(vpException(vpException::badValue, "Bad rho value %g; should be in [0:1[", rho));
+  }
+  if (sigma_state.getRows() < m_size_state * nsignal || sigma_measure.getRows() < m_size_measure * nsignal) {
+    throw(vpException(vpException::badValue, "Bad state or measure variance vector size"));
+  }
+
+  init(nsignal);
+  m_dt = dt;
+
+  double dt2 = dt * dt;
+  double dt3 = dt2 * dt;
+  unsigned int n = m_size_state;
+
+  switch (m_model) {
+  case vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos:
+    m_F[0][0] = 1;
+    m_F[0][1] = dt;
+    m_F[1][1] = 1;
+    for (unsigned int i = 0; i < nsignal; i++) {
+      double sR = sigma_measure[i];
+      double sQ = sigma_state[2 * i];
+      m_r[i] = sR;
+      m_q[upper(n, 0, 0)][i] = sQ * dt3 / 3;
+      m_q[upper(n, 0, 1)][i] = sQ * dt2 / 2;
+      m_q[upper(n, 1, 1)][i] = sQ * dt;
+      m_pest[upper(n, 0, 0)][i] = sR;
+      m_pest[upper(n, 0, 1)][i] = sR / (2 * dt);
+      m_pest[upper(n, 1, 1)][i] = sQ * 2 * dt / 3.0 + sR / (2 * dt2);
+    }
+    break;
+
+  case vpLinearKalmanFilterInstantiation::stateConstVelWithColoredNoise_MeasureVel:
+    m_F[0][0] = 1;
+    m_F[0][1] = 1;
+    m_F[1][1] = rho;
+    for (unsigned int i = 0; i < nsignal; i++) {
+      double sR = sigma_measure[i];
+      double sQ = sigma_state[2 * i + 1];
+      m_r[i] = sR;
+      m_q[upper(n, 1, 1)][i] = sQ;
+      m_pest[upper(n, 0, 0)][i] = sR;
+      m_pest[upper(n, 1, 1)][i] = sQ / (1 - rho * rho);
+    }
+    break;
+
+  case vpLinearKalmanFilterInstantiation::stateConstAccWithColoredNoise_MeasureVel:
+    m_F[0][0] = 1;
+    m_F[0][1] = 1;
+    m_F[0][2] = dt;
+    m_F[1][1] = rho;
+    m_F[2][2] = 1;
+    for (unsigned int i = 0; i < nsignal; i++) {
+      double sR = sigma_measure[i];
+      double sQ1 = sigma_state[3 * i + 1];
+      double sQ2 = sigma_state[3 * i + 2];
+      m_r[i] = sR;
+      m_q[upper(n, 1, 1)][i] = sQ1;
+      m_q[upper(n, 2, 2)][i] = sQ2;
+      m_pest[upper(n, 0, 0)][i] = sR;
+      m_pest[upper(n, 0, 2)][i] = sR / dt;
+      m_pest[upper(n, 1, 1)][i] = sQ1 / (1 - rho * rho);
+      m_pest[upper(n, 1, 2)][i] = -rho * sQ1 / ((1 - rho * rho) * dt);
+      m_pest[upper(n, 2, 2)][i] = (2 * sR + sQ1 / (1 - rho * rho)) / (dt * dt);
+    }
+    break;
+
+  case vpLinearKalmanFilterInstantiation::unknown:
+    break;
+  }
+}
+
+/*!
+  Compute the prediction \f$ {\bf x}_{k|k-1} = {\bf F} {\bf x}_{k-1|k-1} \f$
+  and \f$ {\bf P}_{k|k-1} = {\bf F} {\bf P}_{k-1|k-1} {\bf F}^T + {\bf Q} \f$
+  of all the signals.
+*/
+void vpLinearKalmanFilterBatch::prediction()
+{
+  unsigned int s = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    s = predict<SSE2Lane>(m_size_state, m_F, m_xest, m_pest, m_q, m_xpre, m_ppre, s, m_nsignal);
+  }
+#endif
+  predict<ScalarLane>(m_size_state, m_F, m_xest, m_pest, m_q, m_xpre, m_ppre, s, m_nsignal);
+}
+
+/*!
+  Update the state of all the signals from their measures.
+
+  \param z : Measures, one per signal.
+*/
+void vpLinearKalmanFilterBatch::filtering(const vpColVector &z)
+{
+  if (z.getRows() < m_nsignal) {
+    throw(vpException(vpException::dimensionError, "Bad measure vector size %d, expected %d", z.getRows(),
+                      m_nsignal));
+  }
+  unsigned int s = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    s = update<SSE2Lane>(m_size_state, z.data, m_r, m_xpre, m_ppre, m_xest, m_pest, s, m_nsignal);
+  }
+#endif
+  update<ScalarLane>(m_size_state, z.data, m_r, m_xpre, m_ppre, m_xest, m_pest, s, m_nsignal);
+  m_iter++;
+}
+
+/*!
+  Do the filtering and prediction of the measure signals, following the same
+  initialization steps as vpLinearKalmanFilterInstantiation::filter().
+
+  \param z : Measures, one per signal.
+
+  \exception vpException::notInitialized : If the filter is not
+  initialized. To initialize the filter see initFilter().
+*/
+void vpLinearKalmanFilterBatch::filter(const vpColVector &z)
+{
+  if (m_nsignal < 1) {
+    throw(vpException(vpException::notInitialized, "Bad signal number. You need to initialize the Kalman filter"));
+  }
+  if (z.getRows() < m_nsignal) {
+    throw(vpException(vpException::dimensionError, "Bad measure vector size %d, expected %d", z.getRows(),
+                      m_nsignal));
+  }
+
+  if (m_iter == 0) {
+    for (unsigned int k = 0; k < m_size_state; k++) {
+      std::fill(m_xest[k].begin(), m_xest[k].end(), 0.0);
+    }
+    for (unsigned int i = 0; i < m_nsignal; i++) {
+      m_xest[0][i] = z[i];
+    }
+    prediction();
+    m_iter++;
+    return;
+  } else if (m_iter == 1 && m_model == vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos) {
+    for (unsigned int i = 0; i < m_nsignal; i++) {
+      double z_prev = m_xest[0][i]; // Previous measured position
+      m_xest[0][i] = z[i];
+      m_xest[1][i] = (z[i] - z_prev) / m_dt;
+    }
+    prediction();
+    m_iter++;
+    return;
+  }
+
+  filtering(z);
+  prediction();
+}
+
+/*!
+  Get the updated state estimate of all the signals with the same layout as
+  vpKalmanFilter::Xest.
+*/
+void vpLinearKalmanFilterBatch::getStateEstimate(vpColVector &Xest) const
+{
+  Xest.resize(m_size_state * m_nsignal, false);
+  for (unsigned int i = 0; i < m_nsignal; i++) {
+    for (unsigned int k = 0; k < m_size_state; k++) {
+      Xest[m_size_state * i + k] = m_xest[k][i];
+    }
+  }
+}
+
+/*!
+  Get the predicted state of all the signals with the same layout as
+  vpKalmanFilter::Xpre.
+*/
+void vpLinearKalmanFilterBatch::getStatePrediction(vpColVector &Xpre) const
+{
+  Xpre.resize(m_size_state * m_nsignal, false);
+  for (unsigned int i = 0; i < m_nsignal; i++) {
+    for (unsigned int k = 0; k < m_size_state; k++) {
+      Xpre[m_size_state * i + k] = m_xpre[k][i];
+    }
+  }
+}
+
+/*!
+  Return the updated state covariance \f$ {\bf P}_{k|k} \f$ of a signal.
+*/
+vpMatrix vpLinearKalmanFilterBatch::getCovarianceEstimate(unsigned int signal) const
+{
+  vpMatrix P(m_size_state, m_size_state);
+  for (unsigned int i = 0; i < m_size_state; i++) {
+    for (unsigned int j = 0; j < m_size_state; j++) {
+      P[i][j] = m_pest[upper(m_size_state, i, j)][signal];
+    }
+  }
+  return P;
+}
+
+/*!
+  Return the predicted state covariance \f$ {\bf P}_{k|k-1} \f$ of a signal.
+*/
+vpMatrix vpLinearKalmanFilterBatch::getCovariancePrediction(unsigned int signal) const
+{
+  vpMatrix P(m_size_state, m_size_state);
+  for (unsigned int i = 0; i < m_size_state; i++) {
+    for (unsigned int j = 0; j < m_size_state; j++) {
+      P[i][j] = m_ppre[upper(m_size_state, i, j)][signal];
+    }
+  }
+  return P;
+}
@@ -0,0 +1,289 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Single precision column vector.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpColVectorf.cpp
+  \brief Single precision column vector.
+*/
+
+#include <cmath>
+#include <string.h>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpColVectorf.h>
+#include <visp3/core/vpException.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+/*!
+  Construct a single precision column vector from a double precision one.
+*/
+vpColVectorf::vpColVectorf(const vpColVector &v) : vpArray2D<float>() { buildFrom(v); }
+
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+/*!
+  Move constructor.
+*/
+vpColVectorf::vpColVectorf(vpColVectorf &&v) : vpArray2D<float>()
+{
+  rowNum = v.rowNum;
+  colNum = v.colNum;
+  rowPtrs = v.rowPtrs;
+  dsize = v.dsize;
+  data = v.data;
+
+  v.rowNum = 0;
+  v.colNum = 0;
+  v.rowPtrs = NULL;
+  v.dsize = 0;
+  v.data = NULL;
+}
+
+/*!
+  Move operator.
+*/
+vpColVectorf &vpColVectorf::operator=(vpColVectorf &&other)
+{
+  if (this != &other) {
+    free(data);
+    free(rowPtrs);
+
+    rowNum = other.rowNum;
+    colNum = other.colNum;
+    rowPtrs = other.rowPtrs;
+    dsize = other.dsize;
+    data = other.data;
+
+    other.rowNum = 0;
+    other.colNum = 0;
+    other.rowPtrs = NULL;
+    other.dsize = 0;
+    other.data = NULL;
+  }
+
+  return *this;
+}
+#endif
+
+/*!
+  Initialize the vector from a double precision column vector. The values
+  are rounded to the nearest float.
+*/
+void vpColVectorf::buildFrom(const vpColVector &v)
+{
+  resize(v.getRows(), false);
+  for (unsigned int i = 0; i < rowNum; i++) {
+    data[i] = static_cast<float>(v[i]);
+  }
+}
+
+/*!
+  Convert the vector into a double precision column vector.
+*/
+vpColVector vpColVectorf::toColVector() const
+{
+  vpColVector v(rowNum);
+  for (unsigned int i = 0; i < rowNum; i++) {
+    v[i] = static_cast<double>(data[i]);
+  }
+  return v;
+}
+
+/*!
+  Copy operator.
+*/
+vpColVectorf &vpColVectorf::operator=(const vpColVectorf &v)
+{
+  resize(v.getRows(), false);
+  if (rowNum != 0) {
+    memcpy(data, v.data, rowNum * sizeof(float));
+  }
+  return *this;
+}
+
+/*!
+  Set each element of the vector to \e x.
+*/
+vpColVectorf &vpColVectorf::operator=(float x)
+{
+  for (unsigned int i = 0; i < rowNum; i++) {
+    data[i] = x;
+  }
+  return *this;
+}
+
+/*!
+  Insert a column vector.
+  \param i : Index of the first element to introduce. This index starts from 0.
+  \param v : Column vector to insert.
+*/
+void vpColVectorf::insert(unsigned int i, const vpColVectorf &v)
+{
+  if (i + v.size() > this->size()) {
+    throw(vpException(vpException::dimensionError, "Unable to insert a column vector"));
+  }
+  if (v.size() != 0) {
+    memcpy(data + i, v.data, v.size() * sizeof(float));
+  }
+}
+
+/*!
+  Dot product between two column vectors, accumulated in double precision.
+*/
+double vpColVectorf::operator*(const vpColVectorf &v) const
+{
+  if (v.getRows() != rowNum) {
+    throw(vpException(vpException::dimensionError, "Cannot compute the dot product between column vectors "
+                                                    "with different dimensions (%d) and (%d)",
+                      getRows(), v.getRows()));
+  }
+  double sum = 0.0;
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && rowNum >= 4) {
+    __m128d v_sum1 = _mm_setzero_pd(), v_sum2 = _mm_setzero_pd();
+    for (; i <= rowNum - 4; i += 4) {
+      __m128 v_mul = _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(v.data + i));
+      v_sum1 = _mm_add_pd(v_sum1, _mm_cvtps_pd(v_mul));
+      v_sum2 = _mm_add_pd(v_sum2, _mm_cvtps_pd(_mm_movehl_ps(v_mul, v_mul)));
+    }
+    double res[2];
+    _mm_storeu_pd(res, _mm_add_pd(v_sum1, v_sum2));
+    sum = res[0] + res[1];
+  }
+#endif
+
+  for (; i < rowNum; i++) {
+    sum += static_cast<double>(data[i]) * v.data[i];
+  }
+  return sum;
+}
+
+/*!
+  Return the sum square of all the elements, accumulated in double precision.
+*/
+double vpColVectorf::sumSquare() const { return (*this) * (*this); }
+
+/*!
+  Compute and return the Euclidean norm, accumulated in double precision.
+*/
+double vpColVectorf::frobeniusNorm() const { return std::sqrt(sumSquare()); }
+
+/*!
+  Multiply each element of the vector by \e x.
+*/
+vpColVectorf vpColVectorf::operator*(float x) const
+{
+  vpColVectorf v(*this);
+  v *= x;
+  return v;
+}
+
+/*!
+  Multiply each element of the vector by \e x.
+*/
+vpColVectorf &vpColVectorf::operator*=(float x)
+{
+  for (unsigned int i = 0; i < rowNum; i++) {
+    data[i] *= x;
+  }
+  return *this;
+}
+
+/*!
+  Add two column vectors.
+*/
+vpColVectorf vpColVectorf::operator+(const vpColVectorf &v) const
+{
+  vpColVectorf r(*this);
+  r += v;
+  return r;
+}
+
+/*!
+  Add a column vector to the current one.
+*/
+vpColVectorf &vpColVectorf::operator+=(const vpColVectorf &v)
+{
+  if (getRows() != v.getRows()) {
+    throw(vpException(vpException::dimensionError, "Cannot add (%dx1) column vector to (%dx1) column vector",
+                      getRows(), v.getRows()));
+  }
+  for (unsigned int i = 0; i < rowNum; i++) {
+    data[i] += v.data[i];
+  }
+  return *this;
+}
+
+/*!
+  Subtract two column vectors.
+*/
+vpColVectorf vpColVectorf::operator-(const vpColVectorf &v) const
+{
+  vpColVectorf r(*this);
+  r -= v;
+  return r;
+}
+
+/*!
+  Subtract a column vector to the current one.
+*/
+vpColVectorf &vpColVectorf::operator-=(const vpColVectorf &v)
+{
+  if (getRows() != v.getRows()) {
+    throw(vpException(vpException::dimensionError, "Cannot subtract (%dx1) column vector to (%dx1) column vector",
+                      getRows(), v.getRows()));
+  }
+  for (unsigned int i = 0; i < rowNum; i++) {
+    data[i] -= v.data[i];
+  }
+  return *this;
+}
+
+/*!
+  Operator that allows to negate all the column vector elements.
+*/
+vpColVectorf vpColVectorf::operator-() const
+{
+  vpColVectorf r(rowNum);
+  for (unsigned int i = 0; i < rowNum; i++) {
+    r.data[i] = -data[i];
+  }
+  return r;
+}
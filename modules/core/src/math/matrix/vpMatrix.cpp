@@ -66,6 +66,8 @@
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpTranslationVector.h>
 
+#include "vpMatrix_jacobi_impl.h"
+
 #if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
 #include <emmintrin.h>
 #define VISP_HAVE_SSE2 1
@@ -2003,14 +2005,18 @@ vpColVector vpMatrix::solveBySVD(const vpColVector &B) const
 
   Matrix singular value decomposition (SVD).
 
-  This function calls the first following function that is available:
+  Small matrices with at most 16 columns, as the ones encountered in
+  homography, pose estimation or rotation orthonormalization, are decomposed
+  with the built-in svdJacobi() that avoids the overhead of the 3rd party
+  calls. Otherwise this function calls the first following function that is
+  available:
   - svdLapack() if Lapack 3rd party is installed
   - svdEigen3() if Eigen3 3rd party is installed
   - svdOpenCV() if OpenCV 3rd party is installed
   - svdGsl() if GSL 3rd party is installed.
 
   If none of these previous 3rd parties is installed, we use by default
-svdLapack() with a Lapack built-in version.
+svdJacobi() whatever the size of the matrix.
 
   Given matrix \f$M\f$, this function computes it singular value decomposition
 such as
@@ -2061,10 +2067,15 @@ int main()
 }
   \endcode
 
-  \sa svdLapack(), svdEigen3(), svdOpenCV(), svdGsl()
+  \sa svdJacobi(), svdLapack(), svdEigen3(), svdOpenCV(), svdGsl()
 */
 void vpMatrix::svd(vpColVector &w, vpMatrix &V)
 {
+  if (colNum <= 16) {
+    svdJacobi(w, V);
+    return;
+  }
+
 #if defined(VISP_HAVE_LAPACK)
   svdLapack(w, V);
 #elif defined(VISP_HAVE_EIGEN3)
@@ -2074,9 +2085,7 @@ void vpMatrix::svd(vpColVector &w, vpMatrix &V)
 #elif defined(VISP_HAVE_GSL)
   svdGsl(w, V);
 #else
-  (void)w;
-  (void)V;
-  throw(vpException(vpException::fatalError, "Cannot compute SVD. Install Lapack, Eigen3, OpenCV or GSL 3rd party"));
+  svdJacobi(w, V);
 #endif
 }
 
@@ -4927,13 +4936,11 @@ void vpMatrix::insert(const vpMatrix &A, unsigned int r, unsigned int c)
 
   \return The eigenvalues of a n-by-n real symmetric matrix.
 
-  \warning This method is only available if the Gnu Scientific Library
-  (GSL) is detected as a third party library.
+  \note When the Gnu Scientific Library (GSL) is not detected as a third
+  party library, a built-in cyclic Jacobi method is used.
 
   \exception vpException::dimensionError If the matrix is not square.
   \exception vpException::fatalError If the matrix is not symmetric.
-  \exception vpException::functionNotImplementedError If the GSL library is
-not detected.
 
   Here an example:
 \code
@@ -5011,8 +5018,10 @@ vpColVector vpMatrix::eigenValues() const
   }
 #else
   {
-    throw(vpException(vpException::functionNotImplementedError, "Eigen values computation is not implemented. You "
-                                                                "should install GSL rd party"));
+    vpColVector evalue;
+    vpMatrix evector;
+    eigenValues(evalue, evector);
+    return evalue;
   }
 #endif
 }
@@ -5021,8 +5030,8 @@ vpColVector vpMatrix::eigenValues() const
   Compute the eigenvalues of a n-by-n real symmetric matrix.
   \return The eigenvalues of a n-by-n real symmetric matrix.
 
-  \warning This method is only available if the Gnu Scientific Library
-  (GSL) is detected as a third party library.
+  \note When the Gnu Scientific Library (GSL) is not detected as a third
+  party library, a built-in cyclic Jacobi method is used.
 
   \param evalue : Eigenvalues of the matrix.
 
@@ -5030,8 +5039,6 @@ vpColVector vpMatrix::eigenValues() const
 
   \exception vpException::dimensionError If the matrix is not square.
   \exception vpException::fatalError If the matrix is not symmetric.
-  \exception vpException::functionNotImplementedError If the GSL library is
-not detected.
 
   Here an example:
 \code
@@ -5070,11 +5077,7 @@ int main()
 \sa eigenValues()
 
 */
-#ifdef VISP_HAVE_GSL /* be careful of the copy below */
 void vpMatrix::eigenValues(vpColVector &evalue, vpMatrix &evector) const
-#else
-void vpMatrix::eigenValues(vpColVector & /* evalue */, vpMatrix & /* evector */) const
-#endif
 {
   if (rowNum != colNum) {
     throw(vpException(vpException::dimensionError, "Cannot compute eigen values on a non square matrix (%dx%d)", rowNum,
@@ -5132,8 +5135,22 @@ void vpMatrix::eigenValues(vpColVector & /* evalue */, vpMatrix & /* evector */)
   }
 #else
   {
-    throw(vpException(vpException::functionNotImplementedError, "Eigen values computation is not implemented. You "
-                                                                "should install GSL rd party"));
+    // Check if the matrix is symetric: At - A = 0
+    for (unsigned int i = 0; i < rowNum; i++) {
+      for (unsigned int j = i + 1; j < colNum; j++) {
+        if (std::fabs((*this)[i][j] - (*this)[j][i]) > std::numeric_limits<double>::epsilon()) {
+          throw(vpException(vpException::fatalError, "Cannot compute eigen values on a non symetric matrix"));
+        }
+      }
+    }
+
+    // Built-in cyclic Jacobi method
+    evalue.resize(rowNum, false);
+    evector.resize(rowNum, colNum, false, false);
+    vpMatrix A(*this);
+    if (!vpJacobi::eigen(A.data, rowNum, evalue.data, evector.data)) {
+      throw(vpException(vpException::fatalError, "The eigen values computation failed to converge"));
+    }
   }
 #endif
 }
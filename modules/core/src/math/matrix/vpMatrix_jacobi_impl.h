@@ -0,0 +1,286 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Built-in Jacobi SVD and symmetric eigen decomposition.
+ *
+ *****************************************************************************/
+
+#ifndef _vpMatrix_jacobi_impl_h_
+#define _vpMatrix_jacobi_impl_h_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*
+ * Dependency free Jacobi methods used when no 3rd party is available or
+ * when the matrix is small enough that the overhead of the 3rd party call is
+ * higher than the decomposition itself.
+ *
+ * Matrices are passed as row-major raw buffers so that the same code can be
+ * used with double and float data.
+ */
+namespace vpJacobi
+{
+/*
+ * One-sided (Hestenes) Jacobi SVD of a m-by-n matrix A = U diag(w) V^T.
+ *
+ * \param at : n-by-m row-major buffer that contains the transpose of A. On
+ * output it contains the transpose of U, meaning that each row is a left
+ * singular vector.
+ * \param m, n : Size of A.
+ * \param w : n singular values sorted in decreasing order, as the 3rd party
+ * backends.
+ * \param vt : n-by-n row-major buffer that contains on output the transpose
+ * of V. The component of largest magnitude of each right singular vector is
+ * positive.
+ * \param max_sweeps : Maximum number of sweeps.
+ * \return true if the decomposition converged.
+ */
+template <typename T>
+bool svd(T *at, unsigned int m, unsigned int n, T *w, T *vt, unsigned int max_sweeps = 60)
+{
+  const T eps = std::numeric_limits<T>::epsilon();
+
+  for (unsigned int i = 0; i < n * n; i++) {
+    vt[i] = 0;
+  }
+  for (unsigned int i = 0; i < n; i++) {
+    vt[i * n + i] = 1;
+  }
+
+  // Columns whose norm falls below eps * ||A|| are numerically zero (they
+  // always appear when m < n) and must not prevent the convergence
+  T fro2 = 0;
+  for (unsigned int i = 0; i < m * n; i++) {
+    fro2 += at[i] * at[i];
+  }
+  const T tiny = eps * eps * fro2;
+
+  // Working on the transposed matrices makes the columns of A and V
+  // contiguous in memory, which is the access pattern of the rotations
+  bool converged = false;
+  for (unsigned int sweep = 0; sweep < max_sweeps && !converged; sweep++) {
+    converged = true;
+    for (unsigned int p = 0; p + 1 < n; p++) {
+      T *up = at + p * m;
+      for (unsigned int q = p + 1; q < n; q++) {
+        T *uq = at + q * m;
+        T alpha = 0, beta = 0, gamma = 0;
+        for (unsigned int k = 0; k < m; k++) {
+          alpha += up[k] * up[k];
+          beta += uq[k] * uq[k];
+          gamma += up[k] * uq[k];
+        }
+
+        if (std::fabs(gamma) <= eps * std::sqrt(alpha * beta) || std::fabs(gamma) <= std::numeric_limits<T>::min() ||
+            alpha <= tiny || beta <= tiny) {
+          continue;
+        }
+        converged = false;
+
+        T zeta = (beta - alpha) / (2 * gamma);
+        T t = (zeta >= 0 ? 1 : -1) / (std::fabs(zeta) + std::sqrt(1 + zeta * zeta));
+        T c = 1 / std::sqrt(1 + t * t);
+        T s = c * t;
+
+        for (unsigned int k = 0; k < m; k++) {
+          T tmp = up[k];
+          up[k] = c * tmp - s * uq[k];
+          uq[k] = s * tmp + c * uq[k];
+        }
+        T *vp = vt + p * n;
+        T *vq = vt + q * n;
+        for (unsigned int k = 0; k < n; k++) {
+          T tmp = vp[k];
+          vp[k] = c * tmp - s * vq[k];
+          vq[k] = s * tmp + c * vq[k];
+        }
+      }
+    }
+  }
+
+  // Singular values are the norms of the orthogonalized columns
+  for (unsigned int j = 0; j < n; j++) {
+    T *uj = at + j * m;
+    T norm = 0;
+    for (unsigned int k = 0; k < m; k++) {
+      norm += uj[k] * uj[k];
+    }
+    norm = std::sqrt(norm);
+    w[j] = norm;
+    if (norm > std::numeric_limits<T>::min()) {
+      for (unsigned int k = 0; k < m; k++) {
+        uj[k] /= norm;
+      }
+    }
+  }
+
+  // Sort in decreasing order with a selection sort that swaps rows of U^T and V^T
+  for (unsigned int i = 0; i + 1 < n; i++) {
+    unsigned int imax = i;
+    for (unsigned int j = i + 1; j < n; j++) {
+      if (w[j] > w[imax]) {
+        imax = j;
+      }
+    }
+    if (imax != i) {
+      std::swap(w[i], w[imax]);
+      std::swap_ranges(at + i * m, at + (i + 1) * m, at + imax * m);
+      std::swap_ranges(vt + i * n, vt + (i + 1) * n, vt + imax * n);
+    }
+  }
+
+  // The sign of each pair of singular vectors is arbitrary, the component of
+  // largest magnitude of the right singular vector is made positive
+  for (unsigned int i = 0; i < n; i++) {
+    T *vi = vt + i * n;
+    unsigned int kmax = 0;
+    for (unsigned int k = 1; k < n; k++) {
+      if (std::fabs(vi[k]) > std::fabs(vi[kmax])) {
+        kmax = k;
+      }
+    }
+    if (vi[kmax] < 0) {
+      for (unsigned int k = 0; k < n; k++) {
+        vi[k] = -vi[k];
+      }
+      T *ui = at + i * m;
+      for (unsigned int k = 0; k < m; k++) {
+        ui[k] = -ui[k];
+      }
+    }
+  }
+
+  return converged;
+}
+
+/*
+ * Cyclic Jacobi eigen decomposition of a n-by-n real symmetric matrix.
+ *
+ * \param a : n-by-n row-major symmetric matrix, destroyed on output.
+ * \param n : Size of the matrix.
+ * \param evalue : n eigenvalues sorted by increasing absolute value.
+ * \param evector : n-by-n row-major matrix whose columns are the
+ * corresponding eigenvectors.
+ * \param max_sweeps : Maximum number of sweeps.
+ * \return true if the decomposition converged.
+ */
+template <typename T> bool eigen(T *a, unsigned int n, T *evalue, T *evector, unsigned int max_sweeps = 60)
+{
+  for (unsigned int i = 0; i < n * n; i++) {
+    evector[i] = 0;
+  }
+  for (unsigned int i = 0; i < n; i++) {
+    evector[i * n + i] = 1;
+  }
+
+  bool converged = false;
+  for (unsigned int sweep = 0; sweep < max_sweeps && !converged; sweep++) {
+    T off = 0, diag = 0;
+    for (unsigned int p = 0; p < n; p++) {
+      diag += a[p * n + p] * a[p * n + p];
+      for (unsigned int q = p + 1; q < n; q++) {
+        off += a[p * n + q] * a[p * n + q];
+      }
+    }
+    if (off <= std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon() * diag ||
+        off <= std::numeric_limits<T>::min()) {
+      converged = true;
+      break;
+    }
+
+    for (unsigned int p = 0; p + 1 < n; p++) {
+      for (unsigned int q = p + 1; q < n; q++) {
+        T apq = a[p * n + q];
+        if (std::fabs(apq) <= std::numeric_limits<T>::min()) {
+          continue;
+        }
+        T theta = (a[q * n + q] - a[p * n + p]) / (2 * apq);
+        T t = (theta >= 0 ? 1 : -1) / (std::fabs(theta) + std::sqrt(1 + theta * theta));
+        T c = 1 / std::sqrt(1 + t * t);
+        T s = c * t;
+
+        // A <- J^T A J with J the rotation in the (p,q) plane
+        for (unsigned int k = 0; k < n; k++) {
+          T akp = a[k * n + p];
+          T akq = a[k * n + q];
+          a[k * n + p] = c * akp - s * akq;
+          a[k * n + q] = s * akp + c * akq;
+        }
+        for (unsigned int k = 0; k < n; k++) {
+          T apk = a[p * n + k];
+          T aqk = a[q * n + k];
+          a[p * n + k] = c * apk - s * aqk;
+          a[q * n + k] = s * apk + c * aqk;
+        }
+        a[p * n + q] = a[q * n + p] = 0;
+
+        for (unsigned int k = 0; k < n; k++) {
+          T vkp = evector[k * n + p];
+          T vkq = evector[k * n + q];
+          evector[k * n + p] = c * vkp - s * vkq;
+          evector[k * n + q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < n; i++) {
+    evalue[i] = a[i * n + i];
+  }
+
+  // Sort by increasing absolute value, swapping the eigenvector columns
+  for (unsigned int i = 0; i + 1 < n; i++) {
+    unsigned int imin = i;
+    for (unsigned int j = i + 1; j < n; j++) {
+      if (std::fabs(evalue[j]) < std::fabs(evalue[imin])) {
+        imin = j;
+      }
+    }
+    if (imin != i) {
+      std::swap(evalue[i], evalue[imin]);
+      for (unsigned int k = 0; k < n; k++) {
+        std::swap(evector[k * n + i], evector[k * n + imin]);
+      }
+    }
+  }
+
+  return converged;
+}
+}
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
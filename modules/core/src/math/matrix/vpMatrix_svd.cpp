@@ -48,6 +48,8 @@
 #include <iostream>
 #include <limits> // numeric_limits
 
+#include "vpMatrix_jacobi_impl.h"
+
 #ifdef VISP_HAVE_EIGEN3
 #include <Eigen/SVD>
 #endif
@@ -83,6 +85,65 @@ SVD related functions
 
 ---------------------------------------------------------------------*/
 
+/*!
+
+  Singular value decomposition (SVD) using the built-in one-sided Jacobi
+  method, that doesn't require any 3rd party.
+
+  Given matrix \f$M\f$, this function computes it singular value decomposition
+such as
+
+  \f[ M = U \Sigma V^{\top} \f]
+
+  The method orthogonalizes the columns of \f$M\f$ by plane rotations. It is
+  very accurate and, for matrices with a few columns like the ones
+  encountered in homography or pose estimation, faster than the 3rd party
+  implementations since there is no conversion nor dynamic dispatch. That is
+  why svd() uses this method for matrices that have at most 16 columns.
+
+  \warning This method is destructive wrt. to the matrix \f$ M \f$ to
+  decompose. You should make a COPY of that matrix if needed.
+
+  \param w : Vector of singular values: \f$ \Sigma = diag(w) \f$.
+
+  \param V : Matrix \f$ V \f$.
+
+  \return Matrix \f$ U \f$.
+
+  \note The singular values are ordered in decreasing
+  fashion in \e w. It means that the highest singular value is in \e w[0].
+  Since the sign of each pair of singular vectors is arbitrary, the component
+  of largest magnitude of each column of \e V is made positive, the
+  corresponding column of \e U being negated accordingly.
+
+  \exception vpMatrixException::fatalError If the decomposition failed to
+  converge.
+
+  \sa svd(), svdEigen3(), svdLapack(), svdOpenCV(), svdGsl()
+*/
+void vpMatrix::svdJacobi(vpColVector &w, vpMatrix &V)
+{
+  unsigned int m = this->getRows();
+  unsigned int n = this->getCols();
+
+  w.resize(n, false);
+  V.resize(n, n, false, false);
+  if (m == 0 || n == 0) {
+    return;
+  }
+
+  // Transposed copies make the columns of U and V contiguous
+  vpMatrix Ut, Vt(n, n);
+  this->transpose(Ut);
+
+  if (!vpJacobi::svd(Ut.data, m, n, w.data, Vt.data)) {
+    throw(vpMatrixException(vpMatrixException::fatalError, "The algorithm computing SVD failed to converge."));
+  }
+
+  Ut.transpose(*this);
+  Vt.transpose(V);
+}
+
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020101) // Require opencv >= 2.1.1
 
 /*!
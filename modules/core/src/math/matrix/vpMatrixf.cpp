@@ -0,0 +1,488 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Single precision matrix.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMatrixf.cpp
+  \brief Single precision matrix.
+*/
+
+#include <cmath>
+#include <string.h>
+#include <vector>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpMatrixException.h>
+#include <visp3/core/vpMatrixf.h>
+
+#include "vpMatrix_jacobi_impl.h"
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+/*!
+  Construct a single precision matrix from a double precision one.
+*/
+vpMatrixf::vpMatrixf(const vpMatrix &A) : vpArray2D<float>() { buildFrom(A); }
+
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+/*!
+  Move constructor.
+*/
+vpMatrixf::vpMatrixf(vpMatrixf &&A) : vpArray2D<float>()
+{
+  rowNum = A.rowNum;
+  colNum = A.colNum;
+  rowPtrs = A.rowPtrs;
+  dsize = A.dsize;
+  data = A.data;
+
+  A.rowNum = 0;
+  A.colNum = 0;
+  A.rowPtrs = NULL;
+  A.dsize = 0;
+  A.data = NULL;
+}
+
+/*!
+  Move operator.
+*/
+vpMatrixf &vpMatrixf::operator=(vpMatrixf &&other)
+{
+  if (this != &other) {
+    free(data);
+    free(rowPtrs);
+
+    rowNum = other.rowNum;
+    colNum = other.colNum;
+    rowPtrs = other.rowPtrs;
+    dsize = other.dsize;
+    data = other.data;
+
+    other.rowNum = 0;
+    other.colNum = 0;
+    other.rowPtrs = NULL;
+    other.dsize = 0;
+    other.data = NULL;
+  }
+
+  return *this;
+}
+#endif
+
+/*!
+  Initialize the matrix from a double precision matrix. The values are
+  rounded to the nearest float.
+*/
+void vpMatrixf::buildFrom(const vpMatrix &A)
+{
+  resize(A.getRows(), A.getCols(), false, false);
+  for (unsigned int i = 0; i < dsize; i++) {
+    data[i] = static_cast<float>(A.data[i]);
+  }
+}
+
+/*!
+  Convert the matrix into a double precision matrix.
+*/
+vpMatrix vpMatrixf::toMatrix() const
+{
+  vpMatrix A(rowNum, colNum);
+  for (unsigned int i = 0; i < dsize; i++) {
+    A.data[i] = static_cast<double>(data[i]);
+  }
+  return A;
+}
+
+/*!
+  Set the matrix as an identity matrix.
+*/
+void vpMatrixf::eye()
+{
+  for (unsigned int i = 0; i < rowNum; i++) {
+    for (unsigned int j = 0; j < colNum; j++) {
+      rowPtrs[i][j] = (i == j) ? 1.f : 0.f;
+    }
+  }
+}
+
+/*!
+  Set an n-by-n matrix to identity.
+*/
+void vpMatrixf::eye(unsigned int n)
+{
+  resize(n, n, false, false);
+  eye();
+}
+
+/*!
+  Copy operator.
+*/
+vpMatrixf &vpMatrixf::operator=(const vpMatrixf &A)
+{
+  resize(A.getRows(), A.getCols(), false, false);
+  if (dsize != 0) {
+    memcpy(data, A.data, dsize * sizeof(float));
+  }
+  return *this;
+}
+
+/*!
+  Set all the elements of the matrix to \e x.
+*/
+vpMatrixf &vpMatrixf::operator=(float x)
+{
+  for (unsigned int i = 0; i < dsize; i++) {
+    data[i] = x;
+  }
+  return *this;
+}
+
+/*!
+  Matrix product.
+*/
+vpMatrixf vpMatrixf::operator*(const vpMatrixf &B) const
+{
+  if (colNum != B.getRows()) {
+    throw(vpException(vpException::dimensionError, "Cannot multiply a (%dx%d) matrix by a (%dx%d) matrix", rowNum,
+                      colNum, B.getRows(), B.getCols()));
+  }
+  vpMatrixf C(rowNum, B.getCols());
+
+  // i-k-j loop order to read B and write C contiguously
+  for (unsigned int i = 0; i < rowNum; i++) {
+    const float *a = rowPtrs[i];
+    float *c = C.rowPtrs[i];
+    for (unsigned int k = 0; k < colNum; k++) {
+      const float aik = a[k];
+      const float *b = B.rowPtrs[k];
+      for (unsigned int j = 0; j < B.getCols(); j++) {
+        c[j] += aik * b[j];
+      }
+    }
+  }
+  return C;
+}
+
+/*!
+  Matrix-vector product.
+*/
+vpColVectorf vpMatrixf::operator*(const vpColVectorf &v) const
+{
+  if (colNum != v.getRows()) {
+    throw(vpException(vpException::dimensionError, "Cannot multiply a (%dx%d) matrix by a (%d) column vector",
+                      rowNum, colNum, v.getRows()));
+  }
+  vpColVectorf r(rowNum);
+
+  for (unsigned int i = 0; i < rowNum; i++) {
+    const float *a = rowPtrs[i];
+    unsigned int j = 0;
+    float sum = 0.f;
+#if VISP_HAVE_SSE2
+    if (vpCPUFeatures::checkSSE2() && colNum >= 4) {
+      __m128 v_sum = _mm_setzero_ps();
+      for (; j <= colNum - 4; j += 4) {
+        v_sum = _mm_add_ps(v_sum, _mm_mul_ps(_mm_loadu_ps(a + j), _mm_loadu_ps(v.data + j)));
+      }
+      float res[4];
+      _mm_storeu_ps(res, v_sum);
+      sum = (res[0] + res[1]) + (res[2] + res[3]);
+    }
+#endif
+    for (; j < colNum; j++) {
+      sum += a[j] * v.data[j];
+    }
+    r.data[i] = sum;
+  }
+  return r;
+}
+
+/*!
+  Multiply all the elements of the matrix by \e x.
+*/
+vpMatrixf vpMatrixf::operator*(float x) const
+{
+  vpMatrixf C(*this);
+  C *= x;
+  return C;
+}
+
+/*!
+  Multiply all the elements of the matrix by \e x.
+*/
+vpMatrixf &vpMatrixf::operator*=(float x)
+{
+  for (unsigned int i = 0; i < dsize; i++) {
+    data[i] *= x;
+  }
+  return *this;
+}
+
+/*!
+  Matrix addition.
+*/
+vpMatrixf vpMatrixf::operator+(const vpMatrixf &B) const
+{
+  vpMatrixf C(*this);
+  C += B;
+  return C;
+}
+
+/*!
+  Add a matrix to the current one.
+*/
+vpMatrixf &vpMatrixf::operator+=(const vpMatrixf &B)
+{
+  if ((rowNum != B.getRows()) || (colNum != B.getCols())) {
+    throw(vpException(vpException::dimensionError, "Cannot add (%dx%d) matrix to (%dx%d) matrix", rowNum, colNum,
+                      B.getRows(), B.getCols()));
+  }
+  for (unsigned int i = 0; i < dsize; i++) {
+    data[i] += B.data[i];
+  }
+  return *this;
+}
+
+/*!
+  Matrix subtraction.
+*/
+vpMatrixf vpMatrixf::operator-(const vpMatrixf &B) const
+{
+  vpMatrixf C(*this);
+  C -= B;
+  return C;
+}
+
+/*!
+  Subtract a matrix to the current one.
+*/
+vpMatrixf &vpMatrixf::operator-=(const vpMatrixf &B)
+{
+  if ((rowNum != B.getRows()) || (colNum != B.getCols())) {
+    throw(vpException(vpException::dimensionError, "Cannot subtract (%dx%d) matrix to (%dx%d) matrix", rowNum,
+                      colNum, B.getRows(), B.getCols()));
+  }
+  for (unsigned int i = 0; i < dsize; i++) {
+    data[i] -= B.data[i];
+  }
+  return *this;
+}
+
+/*!
+  Compute and return the transpose of the matrix.
+*/
+vpMatrixf vpMatrixf::t() const { return transpose(); }
+
+/*!
+  Compute and return the transpose of the matrix.
+*/
+vpMatrixf vpMatrixf::transpose() const
+{
+  vpMatrixf At;
+  transpose(At);
+  return At;
+}
+
+/*!
+  Compute the transpose of the matrix.
+  \param At (output) : Resulting transpose matrix.
+*/
+void vpMatrixf::transpose(vpMatrixf &At) const
+{
+  At.resize(colNum, rowNum, false, false);
+  for (unsigned int i = 0; i < rowNum; i++) {
+    const float *a = rowPtrs[i];
+    for (unsigned int j = 0; j < colNum; j++) {
+      At.rowPtrs[j][i] = a[j];
+    }
+  }
+}
+
+/*!
+  Compute and return the Frobenius norm, accumulated in double precision.
+*/
+double vpMatrixf::frobeniusNorm() const
+{
+  double norm = 0.0;
+  for (unsigned int i = 0; i < dsize; i++) {
+    norm += static_cast<double>(data[i]) * data[i];
+  }
+  return std::sqrt(norm);
+}
+
+/*!
+  Compute and return \f$ {\bf A}^T {\bf A} \f$ accumulated in double precision.
+  \sa AtA(vpMatrix &) const
+*/
+vpMatrix vpMatrixf::AtA() const
+{
+  vpMatrix B;
+  AtA(B);
+  return B;
+}
+
+/*!
+  Compute \f$ {\bf B} = {\bf A}^T {\bf A} \f$ where \f${\bf A}\f$ is the
+  current matrix. The products of the float coefficients are accumulated in
+  double precision.
+
+  \param B (output) : Resulting symmetric n-by-n matrix with n the number of
+  columns of the current matrix.
+*/
+void vpMatrixf::AtA(vpMatrix &B) const
+{
+  B.resize(colNum, colNum, true, false);
+  if (rowNum == 0 || colNum == 0) {
+    return;
+  }
+
+  std::vector<double> a(colNum + 1);
+
+  for (unsigned int r = 0; r < rowNum; r++) {
+    const float *row = rowPtrs[r];
+    for (unsigned int k = 0; k < colNum; k++) {
+      a[k] = row[k];
+    }
+
+    // Only the upper triangular part is accumulated
+    for (unsigned int i = 0; i < colNum; i++) {
+      double *b = B[i];
+      unsigned int j = i;
+#if VISP_HAVE_SSE2
+      if (vpCPUFeatures::checkSSE2() && colNum - i >= 2) {
+        __m128d v_ai = _mm_set1_pd(a[i]);
+        for (; j <= colNum - 2; j += 2) {
+          _mm_storeu_pd(b + j, _mm_add_pd(_mm_loadu_pd(b + j), _mm_mul_pd(v_ai, _mm_loadu_pd(&a[j]))));
+        }
+      }
+#endif
+      for (; j < colNum; j++) {
+        b[j] += a[i] * a[j];
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < colNum; i++) {
+    for (unsigned int j = 0; j < i; j++) {
+      B[i][j] = B[j][i];
+    }
+  }
+}
+
+/*!
+  Compute \f$ {\bf A}^T {\bf b} \f$ where \f${\bf A}\f$ is the current
+  matrix, accumulated in double precision.
+
+  \param b : Column vector with as many rows as the current matrix.
+  \param Atb (output) : Resulting vector with as many rows as the number of
+  columns of the current matrix.
+*/
+void vpMatrixf::AtB(const vpColVector &b, vpColVector &Atb) const
+{
+  if (b.getRows() != rowNum) {
+    throw(vpException(vpException::dimensionError, "Cannot multiply a (%dx%d) transposed matrix by a (%d) vector",
+                      rowNum, colNum, b.getRows()));
+  }
+  Atb.resize(colNum, true);
+
+  for (unsigned int r = 0; r < rowNum; r++) {
+    const float *row = rowPtrs[r];
+    const double br = b[r];
+    for (unsigned int j = 0; j < colNum; j++) {
+      Atb[j] += row[j] * br;
+    }
+  }
+}
+
+/*!
+  Insert matrix A at the given position in the current matrix.
+
+  \param A : The matrix to insert.
+  \param r : The index of the row to begin to insert data.
+  \param c : The index of the column to begin to insert data.
+*/
+void vpMatrixf::insert(const vpMatrixf &A, unsigned int r, unsigned int c)
+{
+  if ((r + A.getRows()) > rowNum || (c + A.getCols()) > colNum) {
+    throw(vpException(vpException::dimensionError,
+                      "Cannot insert (%dx%d) matrix in (%dx%d) matrix at position (%d,%d)", A.getRows(), A.getCols(),
+                      rowNum, colNum, r, c));
+  }
+  if (A.getCols() == 0) {
+    return;
+  }
+  for (unsigned int i = 0; i < A.getRows(); i++) {
+    memcpy(rowPtrs[r + i] + c, A.rowPtrs[i], sizeof(float) * A.getCols());
+  }
+}
+
+/*!
+  Singular value decomposition (SVD) using the built-in one-sided Jacobi
+  method in single precision.
+
+  \f[ M = U \Sigma V^{\top} \f]
+
+  \warning This method is destructive wrt. to the matrix \f$ M \f$ to
+  decompose. On output the matrix is equal to \f$ U \f$.
+
+  \param w : Vector of singular values sorted in decreasing order.
+  \param V : Matrix \f$ V \f$.
+
+  \sa vpMatrix::svdJacobi()
+*/
+void vpMatrixf::svd(vpColVectorf &w, vpMatrixf &V)
+{
+  unsigned int m = rowNum;
+  unsigned int n = colNum;
+
+  w.resize(n, false);
+  V.resize(n, n, false, false);
+  if (m == 0 || n == 0) {
+    return;
+  }
+
+  vpMatrixf Ut, Vt(n, n);
+  transpose(Ut);
+
+  if (!vpJacobi::svd(Ut.data, m, n, w.data, Vt.data)) {
+    throw(vpMatrixException(vpMatrixException::fatalError, "The algorithm computing SVD failed to converge."));
+  }
+
+  Ut.transpose(*this);
+  Vt.transpose(V);
+}
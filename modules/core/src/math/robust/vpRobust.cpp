@@ -41,21 +41,42 @@
   \file vpRobust.cpp
 */
 
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpDebug.h>
 #include <visp3/core/vpMath.h>
 
-#include <cmath>  // std::fabs
-#include <limits> // numeric_limits
+#include <algorithm> // std::nth_element
+#include <cmath>     // std::fabs
+#include <limits>    // numeric_limits
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <visp3/core/vpRobust.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 #define vpITMAX 100
 #define vpEPS 3.0e-7
 #define vpCST 1
 
+#if VISP_HAVE_SSE2
+namespace
+{
+inline __m128d abs_pd(__m128d x)
+{
+  static const __m128d sign_mask = _mm_set1_pd(-0.); // -0. = 1 << 63
+  return _mm_andnot_pd(sign_mask, x);
+}
+
+// Select a when mask is set, b otherwise
+inline __m128d select_pd(__m128d mask, __m128d a, __m128d b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+}
+#endif
+
 // ===================================================================
 /*!
   \brief Constructor.
@@ -63,7 +84,7 @@
 
 */
 vpRobust::vpRobust(unsigned int n_data)
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(n_data)
+  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), size(n_data)
 {
   vpCDEBUG(2) << "vpRobust constructor reached" << std::endl;
 
@@ -77,7 +98,7 @@ vpRobust::vpRobust(unsigned int n_data)
   Default constructor.
 */
 vpRobust::vpRobust()
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(0)
+  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), size(0)
 {
 }
 
@@ -97,7 +118,6 @@ vpRobust &vpRobust::operator=(const vpRobust &other)
   NoiseThreshold = other.NoiseThreshold;
   sig_prev = other.sig_prev;
   it = other.it;
-  swap = other.swap;
   size = other.size;
   return *this;
 }
@@ -114,7 +134,6 @@ vpRobust &vpRobust::operator=(const vpRobust &&other)
   NoiseThreshold = std::move(other.NoiseThreshold);
   sig_prev = std::move(other.sig_prev);
   it = std::move(other.it);
-  swap = std::move(other.swap);
   size = std::move(other.size);
   return *this;
 }
@@ -124,6 +143,8 @@ vpRobust &vpRobust::operator=(const vpRobust &&other)
   \brief Resize containers.
   \param n_data : size of input data vector.
 
+  The memory already allocated is kept when the size decreases, so that
+  alternating between different sizes does not reallocate the buffers.
 */
 void vpRobust::resize(unsigned int n_data)
 {
@@ -182,24 +203,25 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
 
   // resize vector only if the size of residue vector has changed
   unsigned int n_data = residues.getRows();
+  if (n_data == 0) {
+    return;
+  }
   resize(n_data);
 
-  sorted_residues = residues;
+  std::copy(residues.data, residues.data + n_data, sorted_residues.begin());
 
   unsigned int ind_med = (unsigned int)(ceil(n_data / 2.0)) - 1;
 
   // Calculate median
-  med = select(sorted_residues, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
+  med = select(sorted_residues, n_data, ind_med /*(int)n_data/2*/);
   // residualMedian = med ;
 
   // Normalize residues
-  for (unsigned int i = 0; i < n_data; i++) {
-    normres[i] = (fabs(residues[i] - med));
-    sorted_normres[i] = (fabs(sorted_residues[i] - med));
-  }
+  absDiff(residues.data, n_data, med, normres);
+  std::copy(normres.begin(), normres.begin() + n_data, sorted_normres.begin());
 
   // Calculate MAD
-  normmedian = select(sorted_normres, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
+  normmedian = select(sorted_normres, n_data, ind_med /*(int)n_data/2*/);
   // normalizedResidualMedian = normmedian ;
   // 1.48 keeps scale estimate consistent for a normal probability dist.
   sigma = 1.4826 * normmedian; // median Absolute Deviation
@@ -210,22 +232,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
     sigma = NoiseThreshold;
   }
 
-  switch (method) {
-  case TUKEY: {
-    psiTukey(sigma, normres, weights);
-
-    vpCDEBUG(2) << "Tukey's function computed" << std::endl;
-    break;
-  }
-  case CAUCHY: {
-    psiCauchy(sigma, normres, weights);
-    break;
-  }
-  case HUBER: {
-    psiHuber(sigma, normres, weights);
-    break;
-  }
-  }
+  psi(method, sigma, normres, n_data, weights);
 }
 
 void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector &residues,
@@ -235,12 +242,10 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
   double normmedian = 0; // Normalized median
   double sigma = 0;      // Standard Deviation
 
-  unsigned int n_all_data = all_residues.getRows();
-  vpColVector all_normres(n_all_data);
-
   // compute median with the residues vector, return all_normres which are the
-  // normalized all_residues vector.
-  normmedian = computeNormalizedMedian(all_normres, residues, all_residues, weights);
+  // normalized all_residues vector. The normalized residues are kept in the
+  // normres buffer that is resized to the number of all the residues.
+  normmedian = computeNormalizedMedian(normres, residues, all_residues, weights);
 
   // 1.48 keeps scale estimate consistent for a normal probability dist.
   sigma = 1.4826 * normmedian; // Median Absolute Deviation
@@ -251,25 +256,10 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
     sigma = NoiseThreshold;
   }
 
-  switch (method) {
-  case TUKEY: {
-    psiTukey(sigma, all_normres, weights);
-
-    vpCDEBUG(2) << "Tukey's function computed" << std::endl;
-    break;
-  }
-  case CAUCHY: {
-    psiCauchy(sigma, all_normres, weights);
-    break;
-  }
-  case HUBER: {
-    psiHuber(sigma, all_normres, weights);
-    break;
-  }
-  };
+  psi(method, sigma, normres, all_residues.getRows(), weights);
 }
 
-double vpRobust::computeNormalizedMedian(vpColVector &all_normres, const vpColVector &residues,
+double vpRobust::computeNormalizedMedian(std::vector<double> &all_normres, const vpColVector &residues,
                                          const vpColVector &all_residues, const vpColVector &weights)
 {
   double med = 0;
@@ -278,53 +268,38 @@ double vpRobust::computeNormalizedMedian(vpColVector &all_normres, const vpColVe
   unsigned int n_all_data = all_residues.getRows();
   unsigned int n_data = residues.getRows();
 
-  // resize vector only if the size of residue vector has changed
-  resize(n_data);
-
-  sorted_residues = residues;
-  vpColVector no_null_weight_residues;
-  no_null_weight_residues.resize(n_data);
-
-  // all_normres.resize(n_all_data); // Normalized Residue
-  // vpColVector sorted_normres(n_data); // Normalized Residue
-  // vpColVector sorted_residues = residues;
-  // vpColVector sorted_residues;
+  // resize vector only if the size of residue vectors has changed, the
+  // normalized residues are computed for all the residues
+  resize((std::max)(n_data, n_all_data));
 
+  // Be careful to not use the rejected residues for the
+  // calculation.
   unsigned int index = 0;
   for (unsigned int j = 0; j < n_data; j++) {
     // if(weights[j]!=0)
     if (std::fabs(weights[j]) > std::numeric_limits<double>::epsilon()) {
-      no_null_weight_residues[index] = residues[j];
+      sorted_residues[index] = residues[j];
       index++;
     }
   }
-  sorted_residues.resize(index);
-  memcpy(sorted_residues.data, no_null_weight_residues.data, index * sizeof(double));
   n_data = index;
 
   vpCDEBUG(2) << "vpRobust MEstimator reached. No. data = " << n_data << std::endl;
 
-  // Calculate Median
-  // Be careful to not use the rejected residues for the
-  // calculation.
+  if (n_data == 0) {
+    return 0;
+  }
 
+  // Calculate Median
   unsigned int ind_med = (unsigned int)(ceil(n_data / 2.0)) - 1;
-  med = select(sorted_residues, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
+  med = select(sorted_residues, n_data, ind_med /*(int)n_data/2*/);
 
-  unsigned int i;
   // Normalize residues
-  for (i = 0; i < n_all_data; i++) {
-    all_normres[i] = (fabs(all_residues[i] - med));
-  }
+  absDiff(all_residues.data, n_all_data, med, all_normres);
+  absDiff(sorted_residues.data(), n_data, med, sorted_normres);
 
-  for (i = 0; i < n_data; i++) {
-    sorted_normres[i] = (fabs(sorted_residues[i] - med));
-  }
   // MAD calculated only on first iteration
-
-  // normmedian = Median(normres, weights);
-  // normmedian = Median(normres);
-  normmedian = select(sorted_normres, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
+  normmedian = select(sorted_normres, n_data, ind_med /*(int)n_data/2*/);
 
   return normmedian;
 }
@@ -345,24 +320,29 @@ vpColVector vpRobust::simultMEstimator(vpColVector &residues)
   double sigma = 0; // Standard Deviation
 
   unsigned int n_data = residues.getRows();
-  vpColVector norm_res(n_data); // Normalized Residue
   vpColVector w(n_data);
 
   vpCDEBUG(2) << "vpRobust MEstimator reached. No. data = " << n_data << std::endl;
 
+  if (n_data == 0) {
+    return w;
+  }
+  resize(n_data);
+
   // Calculate Median
+  std::copy(residues.data, residues.data + n_data, sorted_residues.begin());
   unsigned int ind_med = (unsigned int)(ceil(n_data / 2.0)) - 1;
-  med = select(residues, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
+  med = select(sorted_residues, n_data, ind_med /*(int)n_data/2*/);
 
   // Normalize residues
-  for (unsigned int i = 0; i < n_data; i++)
-    norm_res[i] = (fabs(residues[i] - med));
+  absDiff(residues.data, n_data, med, normres);
 
   // Check for various methods.
   // For Huber compute Simultaneous scale estimate
   // For Others use MAD calculated on first iteration
   if (it == 0) {
-    double normmedian = select(norm_res, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/); // Normalized Median
+    std::copy(normres.begin(), normres.begin() + n_data, sorted_normres.begin());
+    double normmedian = select(sorted_normres, n_data, ind_med /*(int)n_data/2*/); // Normalized Median
     // 1.48 keeps scale estimate consistent for a normal probability dist.
     sigma = 1.4826 * normmedian; // Median Absolute Deviation
   } else {
@@ -378,14 +358,14 @@ vpColVector vpRobust::simultMEstimator(vpColVector &residues)
 
   vpCDEBUG(2) << "MAD and C computed" << std::endl;
 
-  psiHuber(sigma, norm_res, w);
+  psiHuber(sigma, normres, n_data, w);
 
   sig_prev = sigma;
 
   return w;
 }
 
-double vpRobust::simultscale(vpColVector &x)
+double vpRobust::simultscale(const vpColVector &x)
 {
   unsigned int p = 6; // Number of parameters to be estimated.
   unsigned int n = x.getRows();
@@ -522,22 +502,77 @@ double vpRobust::simult_chi_huber(double x)
 
   return sct;
 }
+/*!
+  \brief Dispatch the computation of the weights to the selected influence
+  function.
+
+  \param method : Type of M-Estimator.
+  \param sigma : sigma parameters
+  \param x : normalized residue vector
+  \param n : number of normalized residues to consider, the first n elements
+  of x
+  \param weights : weight vector
+*/
+void vpRobust::psi(vpRobustEstimatorType method, double sigma, const std::vector<double> &x, unsigned int n,
+                   vpColVector &weights)
+{
+  switch (method) {
+  case TUKEY: {
+    psiTukey(sigma, x, n, weights);
+
+    vpCDEBUG(2) << "Tukey's function computed" << std::endl;
+    break;
+  }
+  case CAUCHY: {
+    psiCauchy(sigma, x, n, weights);
+    break;
+  }
+  case HUBER: {
+    psiHuber(sigma, x, n, weights);
+    break;
+  }
+  }
+}
 
 /*!
   \brief calculation of Tukey's influence function
 
   \param sigma : sigma parameters
   \param x : normalized residue vector
+  \param n : number of normalized residues to consider, the first n elements
+  of x
   \param weights : weight vector
 */
 
-void vpRobust::psiTukey(double sig, vpColVector &x, vpColVector &weights)
+void vpRobust::psiTukey(double sig, const std::vector<double> &x, unsigned int n, vpColVector &weights)
 {
 
-  unsigned int n_data = x.getRows();
+  unsigned int n_data = std::min<unsigned int>(weights.getRows(), n);
   double cst_const = vpCST * 4.6851;
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  // The sigma == 0 case is handled by the scalar loop below
+  if (vpCPUFeatures::checkSSE2() && std::fabs(sig) > std::numeric_limits<double>::epsilon() && n_data >= 2) {
+    const __m128d v_sig = _mm_set1_pd(sig);
+    const __m128d v_cst = _mm_set1_pd(cst_const);
+    const __m128d v_eps = _mm_set1_pd(std::numeric_limits<double>::epsilon());
+    const __m128d v_one = _mm_set1_pd(1.0);
+
+    for (; i <= n_data - 2; i += 2) {
+      __m128d v_xi_sig = _mm_div_pd(_mm_loadu_pd(&x[i]), v_sig);
+      __m128d v_w = _mm_loadu_pd(weights.data + i);
+      __m128d v_inlier =
+          _mm_and_pd(_mm_cmple_pd(abs_pd(v_xi_sig), v_cst), _mm_cmpgt_pd(abs_pd(v_w), v_eps));
+
+      __m128d v_tmp = _mm_div_pd(v_xi_sig, v_cst);
+      v_tmp = _mm_sub_pd(v_one, _mm_mul_pd(v_tmp, v_tmp));
+      _mm_storeu_pd(weights.data + i, _mm_and_pd(v_inlier, _mm_mul_pd(v_tmp, v_tmp)));
+    }
+  }
+#endif
 
-  for (unsigned int i = 0; i < n_data; i++) {
+  for (; i < n_data; i++) {
     // if(sig==0 && weights[i]!=0)
     if (std::fabs(sig) <= std::numeric_limits<double>::epsilon() &&
         std::fabs(weights[i]) > std::numeric_limits<double>::epsilon()) {
@@ -563,14 +598,34 @@ void vpRobust::psiTukey(double sig, vpColVector &x, vpColVector &weights)
 
   \param sigma : sigma parameters
   \param x : normalized residue vector
+  \param n : number of normalized residues to consider, the first n elements
+  of x
   \param weights : weight vector
 */
-void vpRobust::psiHuber(double sig, vpColVector &x, vpColVector &weights)
+void vpRobust::psiHuber(double sig, const std::vector<double> &x, unsigned int n, vpColVector &weights)
 {
   double c = 1.2107; // 1.345;
-  unsigned int n_data = x.getRows();
+  unsigned int n_data = std::min<unsigned int>(weights.getRows(), n);
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && n_data >= 2) {
+    const __m128d v_sig = _mm_set1_pd(sig);
+    const __m128d v_c = _mm_set1_pd(c);
+    const __m128d v_eps = _mm_set1_pd(std::numeric_limits<double>::epsilon());
+    const __m128d v_one = _mm_set1_pd(1.0);
+
+    for (; i <= n_data - 2; i += 2) {
+      __m128d v_abs_xi_sig = abs_pd(_mm_div_pd(_mm_loadu_pd(&x[i]), v_sig));
+      __m128d v_w = _mm_loadu_pd(weights.data + i);
+      __m128d v_huber = select_pd(_mm_cmple_pd(v_abs_xi_sig, v_c), v_one, _mm_div_pd(v_c, v_abs_xi_sig));
+      // Rejected residues keep their null weight
+      _mm_storeu_pd(weights.data + i, select_pd(_mm_cmpgt_pd(abs_pd(v_w), v_eps), v_huber, v_w));
+    }
+  }
+#endif
 
-  for (unsigned int i = 0; i < n_data; i++) {
+  for (; i < n_data; i++) {
     // if(weights[i]!=0)
     if (std::fabs(weights[i]) > std::numeric_limits<double>::epsilon()) {
       double xi_sig = x[i] / sig;
@@ -587,76 +642,76 @@ void vpRobust::psiHuber(double sig, vpColVector &x, vpColVector &weights)
 
   \param sigma : sigma parameters
   \param x : normalized residue vector
+  \param n : number of normalized residues to consider, the first n elements
+  of x
   \param weights : weight vector
 */
 
-void vpRobust::psiCauchy(double sig, vpColVector &x, vpColVector &weights)
+void vpRobust::psiCauchy(double sig, const std::vector<double> &x, unsigned int n, vpColVector &weights)
 {
-  unsigned int n_data = x.getRows();
+  unsigned int n_data = std::min<unsigned int>(weights.getRows(), n);
   double const_sig = 2.3849 * sig;
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && n_data >= 2) {
+    const __m128d v_const_sig = _mm_set1_pd(const_sig);
+    const __m128d v_one = _mm_set1_pd(1.0);
+
+    for (; i <= n_data - 2; i += 2) {
+      __m128d v_tmp = _mm_div_pd(_mm_loadu_pd(&x[i]), v_const_sig);
+      _mm_storeu_pd(weights.data + i, _mm_div_pd(v_one, _mm_add_pd(v_one, _mm_mul_pd(v_tmp, v_tmp))));
+    }
+  }
+#endif
 
   // Calculate Cauchy's equation
-  for (unsigned int i = 0; i < n_data; i++) {
+  for (; i < n_data; i++) {
     weights[i] = 1 / (1 + vpMath::sqr(x[i] / (const_sig)));
-
-    // If one coordinate is an outlier the other is too!
-    // w[i] < 0.01 is a threshold to be set
-    /*if(w[i] < 0.01)
-      {
-      if(i%2 == 0)
-      {
-      w[i+1] = w[i];
-      i++;
-      }
-      else
-      w[i-1] = w[i];
-      }*/
   }
 }
 
 /*!
-  \brief partition function
-  \param a : vector to be sorted
-  \param l : first value to be considered
-  \param r : last value to be considered
+  \brief Select the k-th smallest value of the n first elements of a vector
+  in linear time. The n first elements are partially reordered.
+
+  \param a : vector to be partially sorted
+  \param n : number of values to consider
+  \param k : index of the value to be selected
 */
-int vpRobust::partition(vpColVector &a, int l, int r)
+double vpRobust::select(std::vector<double> &a, unsigned int n, unsigned int k)
 {
-  int i = l - 1;
-  int j = r;
-  double v = a[(unsigned int)r];
-
-  for (;;) {
-    while (a[(unsigned int)++i] < v)
-      ;
-    while (v < a[(unsigned int)--j])
-      if (j == l)
-        break;
-    if (i >= j)
-      break;
-    exch(a[(unsigned int)i], a[(unsigned int)j]);
-  }
-  exch(a[(unsigned int)i], a[(unsigned int)r]);
-  return i;
+  std::nth_element(a.begin(), a.begin() + k, a.begin() + n);
+  return a[k];
 }
 
 /*!
-  \brief sort a part of a vector and select a value of this new vector
-  \param a : vector to be sorted
-  \param l : first value to be considered
-  \param r : last value to be considered
-  \param k : value to be selected
+  \brief Compute the absolute deviation of residues to a given value.
+
+  \param residues : pointer to the residues
+  \param n : number of residues
+  \param med : value from which the deviation is computed, typically the median
+  \param normres : absolute deviations \f$ |r_i - med| \f$, resized to at least n
 */
-double vpRobust::select(vpColVector &a, int l, int r, int k)
+void vpRobust::absDiff(const double *residues, unsigned int n, double med, std::vector<double> &normres)
 {
-  while (r > l) {
-    int i = partition(a, l, r);
-    if (i >= k)
-      r = i - 1;
-    if (i <= k)
-      l = i + 1;
+  if (normres.size() < n) {
+    normres.resize(n);
+  }
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && n >= 2) {
+    const __m128d v_med = _mm_set1_pd(med);
+    for (; i <= n - 2; i += 2) {
+      _mm_storeu_pd(&normres[i], abs_pd(_mm_sub_pd(_mm_loadu_pd(residues + i), v_med)));
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    normres[i] = std::fabs(residues[i] - med);
   }
-  return a[(unsigned int)k];
 }
 
 #if !defined(VISP_HAVE_FUNC_ERFC) && !defined(VISP_HAVE_FUNC_STD_ERFC)
@@ -39,9 +39,28 @@
 #include <algorithm>
 #include <visp3/core/vpMatrixException.h>
 #include <visp3/core/vpQuadProg.h>
+#include <visp3/core/vpTime.h>
 
 #if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Stores the time elapsed between construction and destruction. Nested
+// solvers write first, so that the outermost call sets the final value.
+class vpSolvingTimer
+{
+public:
+  explicit vpSolvingTimer(double &t) : m_t(t), m_t0(vpTime::measureTimeMs()) {}
+  ~vpSolvingTimer() { m_t = vpTime::measureTimeMs() - m_t0; }
+
+private:
+  double &m_t;
+  double m_t0;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
 Changes a canonical quadratic cost \f$\min \frac{1}{2}\mathbf{x}^T\mathbf{H}\mathbf{x} + \mathbf{c}^T\mathbf{x}\f$
 to the formulation used by this class \f$ \min ||\mathbf{Q}\mathbf{x} - \mathbf{r}||^2\f$.
@@ -392,25 +411,46 @@ bool vpQuadProg::solveQP(const vpMatrix &Q, const vpColVector &r,
                          vpColVector &x,
                          const double &tol)
 {
+  vpSolvingTimer timer(solving_time);
+
   if(A.getRows() == 0)
     return solveQPi(Q, r, C, d, x, false, tol);
 
   checkDimensions(Q, r, &A, &b, &C, &d, "solveQP");
+  iter_count = 0;
+  warm_started = false;
 
-  if(!vpLinProg::colReduction(A, b, false, tol))
+  // reuse the decomposition of the last call if the equality constraint did not change
+  if(A_eq.getRows() && tol == tol_eq && A == A_eq && b == b_eq)
   {
-    std::cout << "vpQuadProg::solveQP: equality constraint infeasible" << std::endl;
-    return false;
+    A = Z_eq;
+    b = x1_eq;
+  }
+  else
+  {
+    A_eq = A;
+    b_eq = b;
+    tol_eq = tol;
+    if(!vpLinProg::colReduction(A, b, false, tol))
+    {
+      A_eq.resize(0, 0);
+      std::cout << "vpQuadProg::solveQP: equality constraint infeasible" << std::endl;
+      return false;
+    }
+    Z_eq = A;
+    x1_eq = b;
   }
 
-  if(A.getCols() && solveQPi(Q*A, r - Q*b, C*A, d - C*b, x, false, tol))
+  if(A.getCols() && solveActiveSet(Q*A, r - Q*b, C*A, d - C*b, x, A, b, tol))
   {
     x = b + A*x;
+    x_last = x;
     return true;
   }
   else if(vpLinProg::allLesser(C, b, d, tol))  // Ax = b has only 1 solution
   {
     x = b;
+    x_last = x;
     return true;
   }
   std::cout << "vpQuadProg::solveQP: inequality constraint infeasible" << std::endl;
@@ -467,21 +507,26 @@ bool vpQuadProg::solveQPi(const vpMatrix &Q, const vpColVector &r,
                           vpColVector &x, bool use_equality,
                           const double &tol)
 {
+  vpSolvingTimer timer(solving_time);
   unsigned int n = checkDimensions(Q, r, nullptr, nullptr, &C, &d, "solveQPi");
+  iter_count = 0;
+  warm_started = false;
 
   if(use_equality)
   {
     if(Z.getRows() == n)
     {
-      if(Z.getCols() && solveQPi(Q*Z, r - Q*x1, C*Z, d - C*x1, x, false, tol))
+      if(Z.getCols() && solveActiveSet(Q*Z, r - Q*x1, C*Z, d - C*x1, x, Z, x1, tol))
       {
         // back to initial solution
         x = x1 + Z*x;
+        x_last = x;
         return true;
       }
       else if(vpLinProg::allLesser(C, x1, d, tol))
       {
         x = x1;
+        x_last = x;
         return true;
       }
       std::cout << "vpQuadProg::solveQPi: inequality constraint infeasible" << std::endl;
@@ -491,6 +536,36 @@ bool vpQuadProg::solveQPi(const vpMatrix &Q, const vpColVector &r,
       std::cout << "vpQuadProg::solveQPi: use_equality before setEqualityConstraint" << std::endl;
   }
 
+  if(!solveActiveSet(Q, r, C, d, x, vpMatrix(), vpColVector(), tol))
+    return false;
+  x_last = x;
+  return true;
+}
+
+/*!
+  Active set solver of solveQPi() and solveQP(), that does not store the solution.
+
+  The problem may be expressed in the coordinates of the kernel of an equality constraint, where the original
+  variable is \f$\mathbf{x}_r + \mathbf{Z}_r\mathbf{x}\f$. The solution of the previous call, stored in the original
+  coordinates, is then brought back to the kernel coordinates to warm start the solver.
+
+  \param Q : cost matrix (dimension c x n)
+  \param r : cost vector (dimension c)
+  \param C : inequality matrix (dimension p x n)
+  \param d : inequality vector (dimension p)
+  \param x : solution (dimension n)
+  \param Zr : projection to the kernel of the equality constraint (dimension n0 x n), empty if none
+  \param xr : particular solution of the equality constraint (dimension n0), empty if none
+  \param tol : tolerance to test the ranks
+
+  \return True if the solution was found.
+*/
+bool vpQuadProg::solveActiveSet(const vpMatrix &Q, const vpColVector &r,
+                                const vpMatrix &C, const vpColVector &d,
+                                vpColVector &x, const vpMatrix &Zr, const vpColVector &xr,
+                                const double &tol)
+{
+  const unsigned int n = Q.getCols();
   const unsigned int p = C.getRows();
 
   // look for trivial solution
@@ -516,6 +591,9 @@ bool vpQuadProg::solveQPi(const vpMatrix &Q, const vpColVector &r,
       break;
     }
   }
+  // at most n constraints can be active, the dimension of the problem may have changed since last call
+  if(active.size() > n)
+    active.clear();
 
   // warm start from previous active set
   A.resize((unsigned int)active.size(), n);
@@ -529,6 +607,34 @@ bool vpQuadProg::solveQPi(const vpMatrix &Q, const vpColVector &r,
   if(!solveByProjection(Q, r, A, b, x, tol))
     x.resize(n);
 
+  // or from the previous solution if it is still feasible, with at most n of the constraints it reaches as active set
+  if(!vpLinProg::allLesser(C, x, d, tol))
+  {
+    vpColVector x_start;
+    if(Zr.getRows())
+    {
+      // previous solution in the coordinates of the kernel
+      if(x_last.getRows() == Zr.getRows())
+        x_start = solveSVDorQR(Zr, x_last - xr);
+    }
+    else if(x_last.getRows() == n)
+      x_start = x_last;
+
+    if(x_start.getRows() == n && vpLinProg::allLesser(C, x_start, d, tol))
+    {
+      x = x_start;
+      active.clear();
+      inactive.clear();
+      for(unsigned int i = 0; i < p; ++i)
+      {
+        if(active.size() < n && C.getRow(i)*x - d[i] >= -tol)
+          active.push_back(i);
+        else
+          inactive.push_back(i);
+      }
+    }
+  }
+
   // or from simplex if we really have no clue
   if(!vpLinProg::allLesser(C, x, d, tol))
   {
@@ -601,6 +707,7 @@ bool vpQuadProg::solveQPi(const vpMatrix &Q, const vpColVector &r,
   }
   else  // warm start feasible
   {
+    warm_started = true;
     // using previous active set, check that inactive is sync
     if(active.size() + inactive.size() != p)
     {
@@ -622,6 +729,7 @@ bool vpQuadProg::solveQPi(const vpMatrix &Q, const vpColVector &r,
   // solve at one iteration
   while (true)
   {
+    iter_count++;
     A.resize((unsigned int)active.size(), n);
     b.resize((unsigned int)active.size());
     for(unsigned int i = 0; i < active.size(); ++i)
@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark batched Kalman filtering.
+ *
+ *****************************************************************************/
+
+/*!
+  \example perfKalmanFilter.cpp
+
+  \brief Check that vpLinearKalmanFilterBatch gives the same results as
+  vpLinearKalmanFilterInstantiation and benchmark both implementations with
+  a large number of signals.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+#ifdef VISP_HAVE_CATCH2
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_RUNNER
+#include <catch.hpp>
+
+#include <visp3/core/vpLinearKalmanFilterBatch.h>
+#include <visp3/core/vpLinearKalmanFilterInstantiation.h>
+#include <visp3/core/vpMath.h>
+
+namespace
+{
+bool g_runBenchmark = false;
+unsigned int g_nbSignals = 500;
+
+void initVariances(vpLinearKalmanFilterInstantiation::vpStateModel model, unsigned int nsignal,
+                   vpColVector &sigma_state, vpColVector &sigma_measure)
+{
+  unsigned int size_state = (model == vpLinearKalmanFilterInstantiation::stateConstAccWithColoredNoise_MeasureVel) ? 3 : 2;
+  sigma_state.resize(size_state * nsignal);
+  sigma_measure.resize(nsignal);
+  for (unsigned int i = 0; i < nsignal; i++) {
+    sigma_measure[i] = 1e-4 * (1 + i % 3);
+    for (unsigned int k = 0; k < size_state; k++) {
+      sigma_state[size_state * i + k] = 1e-5 * (1 + (i + k) % 4);
+    }
+  }
+}
+
+void measure(unsigned int nsignal, unsigned int iter, vpColVector &z)
+{
+  z.resize(nsignal, false);
+  for (unsigned int i = 0; i < nsignal; i++) {
+    z[i] = 3 + 2 * i + 0.3 * sin(vpMath::rad(360. / 200 * iter + i));
+  }
+}
+
+void checkModel(vpLinearKalmanFilterInstantiation::vpStateModel model, unsigned int nsignal)
+{
+  const double rho = 0.5, dt = 0.04;
+  vpColVector sigma_state, sigma_measure;
+  initVariances(model, nsignal, sigma_state, sigma_measure);
+
+  vpLinearKalmanFilterInstantiation kalman;
+  kalman.setStateModel(model);
+  kalman.initFilter(nsignal, sigma_state, sigma_measure, rho, dt);
+
+  vpLinearKalmanFilterBatch kalman_batch;
+  kalman_batch.setStateModel(model);
+  kalman_batch.initFilter(nsignal, sigma_state, sigma_measure, rho, dt);
+  REQUIRE(kalman_batch.getStateSize() == kalman.getStateSize());
+
+  vpColVector z, Xest, Xpre;
+  for (unsigned int iter = 0; iter < 50; iter++) {
+    measure(nsignal, iter, z);
+    kalman.filter(z);
+    kalman_batch.filter(z);
+
+    kalman_batch.getStateEstimate(Xest);
+    kalman_batch.getStatePrediction(Xpre);
+    for (unsigned int i = 0; i < Xest.getRows(); i++) {
+      REQUIRE(Xest[i] == Approx(kalman.Xest[i]).margin(1e-9));
+      REQUIRE(Xpre[i] == Approx(kalman.Xpre[i]).margin(1e-9));
+    }
+    for (unsigned int s = 0; s < nsignal; s++) {
+      vpMatrix P = kalman_batch.getCovariancePrediction(s);
+      for (unsigned int i = 0; i < P.getRows(); i++) {
+        for (unsigned int j = 0; j < P.getCols(); j++) {
+          unsigned int off = s * kalman.getStateSize();
+          REQUIRE(P[i][j] == Approx(kalman.Ppre[off + i][off + j]).epsilon(1e-6).margin(1e-12));
+        }
+      }
+    }
+  }
+  REQUIRE(kalman_batch.getIteration() == kalman.getIteration());
+}
+}
+
+TEST_CASE("Batched Kalman filter consistency", "[kalman]")
+{
+  // An odd number of signals exercises the scalar tail of the SIMD kernels
+  const unsigned int nsignal = 7;
+  SECTION("Constant velocity, position measures")
+  {
+    checkModel(vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos, nsignal);
+  }
+  SECTION("Constant velocity with colored noise, velocity measures")
+  {
+    checkModel(vpLinearKalmanFilterInstantiation::stateConstVelWithColoredNoise_MeasureVel, nsignal);
+  }
+  SECTION("Constant acceleration with colored noise, velocity measures")
+  {
+    checkModel(vpLinearKalmanFilterInstantiation::stateConstAccWithColoredNoise_MeasureVel, nsignal);
+  }
+}
+
+TEST_CASE("Benchmark batched Kalman filter", "[benchmark]")
+{
+  if (g_runBenchmark) {
+    const vpLinearKalmanFilterInstantiation::vpStateModel models[] = {
+        vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos,
+        vpLinearKalmanFilterInstantiation::stateConstAccWithColoredNoise_MeasureVel};
+    const std::string names[] = {"constant velocity", "constant acceleration"};
+    const double rho = 0.5, dt = 0.04;
+
+    for (size_t m = 0; m < 2; m++) {
+      vpColVector sigma_state, sigma_measure, z;
+      initVariances(models[m], g_nbSignals, sigma_state, sigma_measure);
+      measure(g_nbSignals, 0, z);
+
+      vpLinearKalmanFilterBatch kalman_batch;
+      kalman_batch.setStateModel(models[m]);
+      kalman_batch.initFilter(g_nbSignals, sigma_state, sigma_measure, rho, dt);
+      kalman_batch.filter(z);
+      kalman_batch.filter(z);
+
+      std::ostringstream oss;
+      oss << g_nbSignals << " signals, " << names[m] << " - vpLinearKalmanFilterBatch";
+      BENCHMARK(oss.str().c_str())
+      {
+        kalman_batch.filter(z);
+        return kalman_batch.getStateEstimate(0, 0);
+      };
+
+      // The dense implementation is cubic in the number of signals
+      if (g_nbSignals <= 500) {
+        vpLinearKalmanFilterInstantiation kalman;
+        kalman.setStateModel(models[m]);
+        kalman.initFilter(g_nbSignals, sigma_state, sigma_measure, rho, dt);
+        kalman.filter(z);
+        kalman.filter(z);
+
+        oss.str("");
+        oss << g_nbSignals << " signals, " << names[m] << " - vpLinearKalmanFilterInstantiation";
+        BENCHMARK(oss.str().c_str())
+        {
+          kalman.filter(z);
+          return kalman.Xest[0];
+        };
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Catch::Session session; // There must be exactly one instance
+
+  // Build a new parser on top of Catch's
+  using namespace Catch::clara;
+  auto cli = session.cli()         // Get Catch's composite command line parser
+             | Opt(g_runBenchmark) // bind variable to a new option, with a hint string
+                   ["--benchmark"] // the option names it will respond to
+             ("run benchmark?")    // description string for the help output
+             | Opt(g_nbSignals, "nbSignals")["--nb-signals"]("Number of signals to filter");
+
+  // Now pass the new composite back to Catch so it uses that
+  session.cli(cli);
+
+  // Let Catch (using Clara) parse the command line
+  session.applyCommandLine(argc, argv);
+
+  int numFailed = session.run();
+
+  // numFailed is clamped to 255 as some unices only use the lower 8 bits.
+  // This clamping has already been applied, so just return it here
+  // You can also do any post run clean-up here
+  return numFailed;
+}
+#else
+#include <iostream>
+
+int main() { return 0; }
+#endif
@@ -0,0 +1,262 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Latency of sequential calls to the QP solver on a visual servoing sized problem.
+ *
+ *****************************************************************************/
+
+/*!
+  \example perfQuadProg.cpp
+
+  Latency of sequential calls to vpQuadProg, with and without warm start, on a
+  problem of the size of a constrained visual servoing control law: 6 velocity
+  unknowns, 4 image points, velocity bounds and one equality constraint.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_CATCH2) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_RUNNER
+#include <catch.hpp>
+
+#include <visp3/core/vpQuadProg.h>
+#include <visp3/core/vpUniRand.h>
+
+namespace
+{
+bool g_runBenchmark = false;
+
+// Sequence of QPs solved by a servo loop: min ||L v + lambda e||^2 s.t. wz = 0 and |v_i| <= v_max
+class ServoProblem
+{
+public:
+  ServoProblem() : L(8, 6), e(8), A(1, 6), b(1), C(12, 6), d(12), x(4), y(4), Z(4)
+  {
+    vpUniRand rng(1);
+    for (unsigned int i = 0; i < 4; i++) {
+      x[i] = rng.uniform(-0.3, 0.3);
+      y[i] = rng.uniform(-0.3, 0.3);
+      Z[i] = rng.uniform(1.0, 1.5);
+      // desired features are shifted and rotated current ones
+      e[2 * i] = 0.2 + 0.5 * y[i];
+      e[2 * i + 1] = -0.1 - 0.5 * x[i];
+    }
+    A[0][5] = 1;
+    for (unsigned int i = 0; i < 6; i++) {
+      C[2 * i][i] = 1;
+      C[2 * i + 1][i] = -1;
+      d[2 * i] = d[2 * i + 1] = i < 3 ? 0.05 : 0.1;
+    }
+    update(vpColVector(6));
+  }
+
+  // Integrate the velocity and update the interaction matrix
+  void update(const vpColVector &v)
+  {
+    const double dt = 0.01, lambda = 5.;
+    if (v.getRows()) {
+      vpColVector de = L * v * dt;
+      e += de;
+      for (unsigned int i = 0; i < 4; i++) {
+        x[i] += de[2 * i];
+        y[i] += de[2 * i + 1];
+        Z[i] -= v[2] * dt;
+      }
+    }
+    for (unsigned int i = 0; i < 4; i++) {
+      double xi = x[i], yi = y[i], zi = 1. / Z[i];
+      double *Lx = L[2 * i], *Ly = L[2 * i + 1];
+      Lx[0] = -zi; Lx[1] = 0;   Lx[2] = xi * zi; Lx[3] = xi * yi;      Lx[4] = -(1 + xi * xi); Lx[5] = yi;
+      Ly[0] = 0;   Ly[1] = -zi; Ly[2] = yi * zi; Ly[3] = 1 + yi * yi;  Ly[4] = -xi * yi;       Ly[5] = -xi;
+    }
+    r = -lambda * e;
+  }
+
+  vpMatrix L;
+  vpColVector e, r;
+  vpMatrix A;
+  vpColVector b;
+  vpMatrix C;
+  vpColVector d;
+
+private:
+  vpColVector x, y, Z;
+};
+
+const unsigned int g_nbIterations = 200;
+}
+
+TEST_CASE("Warm started QP gives the same solutions", "[quadprog]")
+{
+  ServoProblem pb;
+  vpQuadProg qp_ws;
+  unsigned int iter_ws = 0, iter_cold = 0, nb_warm = 0;
+
+  for (unsigned int k = 0; k < g_nbIterations; k++) {
+    vpColVector v_cold, v_ws;
+    vpQuadProg qp;
+    REQUIRE(qp.solveQP(pb.L, pb.r, pb.A, pb.b, pb.C, pb.d, v_cold));
+    iter_cold += qp.getIterationCount();
+
+    REQUIRE(qp_ws.solveQP(pb.L, pb.r, pb.A, pb.b, pb.C, pb.d, v_ws));
+    iter_ws += qp_ws.getIterationCount();
+    nb_warm += qp_ws.isWarmStarted() ? 1 : 0;
+    REQUIRE(qp_ws.getSolvingTime() >= 0);
+
+    // the cold start may stop on a slightly sub-optimal vertex in degenerate cases, hence the cost comparison
+    const double cost_cold = (pb.L * v_cold - pb.r).sumSquare();
+    const double cost_ws = (pb.L * v_ws - pb.r).sumSquare();
+    REQUIRE(cost_ws <= cost_cold + 1e-9);
+    REQUIRE(vpLinProg::allClose(pb.A, v_ws, pb.b, 1e-6));
+    REQUIRE(vpLinProg::allLesser(pb.C, v_ws, pb.d, 1e-6));
+
+    pb.update(v_ws);
+  }
+
+  std::cout << "Active set iterations for " << g_nbIterations << " QPs: " << iter_ws << " with warm start, "
+            << iter_cold << " without; " << nb_warm << " warm started calls" << std::endl;
+  CHECK(iter_ws <= iter_cold);
+  CHECK(nb_warm >= g_nbIterations - 1);
+}
+
+TEST_CASE("Warm start alternating equality constrained and inequality only QPs", "[quadprog]")
+{
+  // the same solver alternates the servo QP with 6 unknowns and wz = 0, that is solved in a kernel of dimension 5,
+  // and the same QP written with the 5 remaining unknowns: the stored solution must not mix both coordinates
+  ServoProblem pb;
+  vpQuadProg qp_ws;
+  vpMatrix C5(10, 5);
+  vpColVector d5(10);
+  for (unsigned int i = 0; i < 10; i++) {
+    for (unsigned int j = 0; j < 5; j++)
+      C5[i][j] = pb.C[i][j];
+    d5[i] = pb.d[i];
+  }
+
+  for (unsigned int k = 0; k < 40; k++) {
+    vpColVector v_cold, v_ws;
+    vpQuadProg qp;
+    if (k % 2) {
+      const vpMatrix L5 = pb.L.extract(0, 0, 8, 5);
+      REQUIRE(qp.solveQPi(L5, pb.r, C5, d5, v_cold));
+      REQUIRE(qp_ws.solveQPi(L5, pb.r, C5, d5, v_ws));
+      REQUIRE(v_ws.getRows() == 5);
+      REQUIRE((L5 * v_ws - pb.r).sumSquare() <= (L5 * v_cold - pb.r).sumSquare() + 1e-9);
+      REQUIRE(vpLinProg::allLesser(C5, v_ws, d5, 1e-6));
+      v_ws.stack(0.);
+    } else {
+      REQUIRE(qp.solveQP(pb.L, pb.r, pb.A, pb.b, pb.C, pb.d, v_cold));
+      REQUIRE(qp_ws.solveQP(pb.L, pb.r, pb.A, pb.b, pb.C, pb.d, v_ws));
+      REQUIRE(v_ws.getRows() == 6);
+      REQUIRE((pb.L * v_ws - pb.r).sumSquare() <= (pb.L * v_cold - pb.r).sumSquare() + 1e-9);
+      REQUIRE(vpLinProg::allClose(pb.A, v_ws, pb.b, 1e-6));
+      REQUIRE(vpLinProg::allLesser(pb.C, v_ws, pb.d, 1e-6));
+    }
+    pb.update(v_ws);
+  }
+}
+
+TEST_CASE("Benchmark sequential QP latency", "[benchmark]")
+{
+  if (g_runBenchmark) {
+    BENCHMARK("Servo loop of 200 QPs - cold start")
+    {
+      ServoProblem pb;
+      vpColVector v;
+      for (unsigned int k = 0; k < g_nbIterations; k++) {
+        vpQuadProg qp;
+        qp.solveQP(pb.L, pb.r, pb.A, pb.b, pb.C, pb.d, v);
+        pb.update(v);
+      }
+      return v;
+    };
+
+    BENCHMARK("Servo loop of 200 QPs - warm start")
+    {
+      ServoProblem pb;
+      vpColVector v;
+      vpQuadProg qp;
+      for (unsigned int k = 0; k < g_nbIterations; k++) {
+        qp.solveQP(pb.L, pb.r, pb.A, pb.b, pb.C, pb.d, v);
+        pb.update(v);
+      }
+      return v;
+    };
+
+    // Per call latency reported by the solver
+    ServoProblem pb;
+    vpColVector v;
+    vpQuadProg qp_ws;
+    double t_cold = 0, t_ws = 0, t_ws_max = 0;
+    for (unsigned int k = 0; k < g_nbIterations; k++) {
+      vpQuadProg qp;
+      qp.solveQP(pb.L, pb.r, pb.A, pb.b, pb.C, pb.d, v);
+      t_cold += qp.getSolvingTime();
+      qp_ws.solveQP(pb.L, pb.r, pb.A, pb.b, pb.C, pb.d, v);
+      t_ws += qp_ws.getSolvingTime();
+      t_ws_max = std::max(t_ws_max, qp_ws.getSolvingTime());
+      pb.update(v);
+    }
+    std::cout << "Mean latency: " << t_cold / g_nbIterations << " ms cold, " << t_ws / g_nbIterations
+              << " ms warm (max " << t_ws_max << " ms)" << std::endl;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Catch::Session session; // There must be exactly one instance
+
+  // Build a new parser on top of Catch's
+  using namespace Catch::clara;
+  auto cli = session.cli()         // Get Catch's composite command line parser
+             | Opt(g_runBenchmark) // bind variable to a new option, with a hint string
+                   ["--benchmark"] // the option names it will respond to
+             ("run benchmark?");   // description string for the help output
+
+  // Now pass the new composite back to Catch so it uses that
+  session.cli(cli);
+
+  // Let Catch (using Clara) parse the command line
+  session.applyCommandLine(argc, argv);
+
+  int numFailed = session.run();
+
+  // numFailed is clamped to 255 as some unices only use the lower 8 bits.
+  // This clamping has already been applied, so just return it here
+  // You can also do any post run clean-up here
+  return numFailed;
+}
+#else
+#include <iostream>
+
+int main() { return 0; }
+#endif
@@ -0,0 +1,196 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test single precision matrix and column vector.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMatrixf.cpp
+
+  Test single precision matrix and column vector against their double
+  precision counterpart.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpColVectorf.h>
+#include <visp3/core/vpMatrixf.h>
+#include <visp3/core/vpUniRand.h>
+
+namespace
+{
+vpMatrix randMatrix(vpUniRand &rng, unsigned int rows, unsigned int cols)
+{
+  vpMatrix M(rows, cols);
+  for (unsigned int i = 0; i < M.size(); i++) {
+    M.data[i] = rng.uniform(-1.0, 1.0);
+  }
+  return M;
+}
+
+vpColVector randVector(vpUniRand &rng, unsigned int rows)
+{
+  vpColVector v(rows);
+  for (unsigned int i = 0; i < v.size(); i++) {
+    v[i] = rng.uniform(-1.0, 1.0);
+  }
+  return v;
+}
+
+bool check(const std::string &name, double err, double threshold)
+{
+  std::cout << name << ": max abs error " << err << std::endl;
+  if (!(err <= threshold)) {
+    std::cerr << name << " failed, error " << err << " > " << threshold << std::endl;
+    return false;
+  }
+  return true;
+}
+
+double maxAbsDiff(const vpMatrix &A, const vpMatrix &B)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols()) {
+    return HUGE_VAL;
+  }
+  double err = 0;
+  for (unsigned int i = 0; i < A.size(); i++) {
+    err = std::max(err, std::fabs(A.data[i] - B.data[i]));
+  }
+  return err;
+}
+
+double maxAbsDiff(const vpColVector &a, const vpColVector &b)
+{
+  if (a.getRows() != b.getRows()) {
+    return HUGE_VAL;
+  }
+  double err = 0;
+  for (unsigned int i = 0; i < a.size(); i++) {
+    err = std::max(err, std::fabs(a[i] - b[i]));
+  }
+  return err;
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rng(42);
+    const double eps = 1e-5;
+
+    // Conversion
+    vpMatrix A = randMatrix(rng, 1003, 6);
+    vpMatrixf Af(A);
+    if (!check("conversion", maxAbsDiff(A, Af.toMatrix()), eps)) {
+      return EXIT_FAILURE;
+    }
+
+    vpColVector b = randVector(rng, A.getRows());
+    vpColVectorf bf(b);
+    if (!check("vector conversion", maxAbsDiff(b, bf.toColVector()), eps)) {
+      return EXIT_FAILURE;
+    }
+
+    // Reductions
+    if (!check("dot product", std::fabs(b.t() * b - bf * bf) / (b.t() * b), eps) ||
+        !check("sum square", std::fabs(b.sumSquare() - bf.sumSquare()) / b.sumSquare(), eps) ||
+        !check("Frobenius norm", std::fabs(A.frobeniusNorm() - Af.frobeniusNorm()) / A.frobeniusNorm(), eps)) {
+      return EXIT_FAILURE;
+    }
+
+    // Normal equations accumulated in double precision
+    vpMatrix AtA_ref = A.AtA();
+    vpMatrix AtA;
+    Af.AtA(AtA);
+    vpColVector Atb_ref = A.t() * b;
+    vpColVector Atb;
+    Af.AtB(b, Atb);
+    if (!check("AtA", maxAbsDiff(AtA_ref, AtA) / AtA_ref.frobeniusNorm(), eps) ||
+        !check("AtB", maxAbsDiff(Atb_ref, Atb) / Atb_ref.frobeniusNorm(), eps)) {
+      return EXIT_FAILURE;
+    }
+    for (unsigned int i = 0; i < AtA.getRows(); i++) {
+      for (unsigned int j = 0; j < i; j++) {
+        if (AtA[i][j] != AtA[j][i]) {
+          std::cerr << "AtA is not symmetric" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Products
+    vpMatrix B = randMatrix(rng, 6, 7);
+    vpMatrixf Bf(B);
+    vpColVector x = randVector(rng, 6);
+    vpColVectorf xf(x);
+    if (!check("matrix product", maxAbsDiff(A * B, (Af * Bf).toMatrix()), eps) ||
+        !check("matrix vector product", maxAbsDiff(A * x, (Af * xf).toColVector()), eps) ||
+        !check("transpose", maxAbsDiff(A.t(), Af.t().toMatrix()), eps) ||
+        !check("addition", maxAbsDiff(A + A * 2, (Af + Af * 2.f).toMatrix()), eps) ||
+        !check("subtraction", maxAbsDiff(b - b * 3, (bf - bf * 3.f).toColVector()), eps)) {
+      return EXIT_FAILURE;
+    }
+
+    // Insert
+    vpMatrixf C(10, 10);
+    C.insert(Bf, 2, 3);
+    if (C[2][3] != Bf[0][0] || C[7][9] != Bf[5][6] || C[1][3] != 0.f) {
+      std::cerr << "insert failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // SVD
+    vpMatrixf U(Bf.t());
+    vpColVectorf w;
+    vpMatrixf V;
+    U.svd(w, V);
+    vpMatrixf S(w.getRows(), w.getRows());
+    for (unsigned int i = 0; i < w.getRows(); i++) {
+      S[i][i] = w[i];
+      if (i > 0 && w[i] > w[i - 1]) {
+        std::cerr << "Singular values are not sorted" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    if (!check("svd", maxAbsDiff(B.t(), (U * S * V.t()).toMatrix()), 1e-4)) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testMatrixf succeed" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
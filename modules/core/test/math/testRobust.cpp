@@ -42,6 +42,7 @@
   Test some vpMath functionalities.
 */
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <stdio.h>
@@ -49,12 +50,15 @@
 #include <string>
 #include <visp3/core/vpIoTools.h>
 #include <visp3/core/vpRobust.h>
+#include <visp3/core/vpUniRand.h>
 #include <visp3/io/vpParseArgv.h>
 // List of allowed command line options
 #define GETOPTARGS "cdho:"
 
 void usage(const char *name, const char *badparam, std::string ofilename);
 bool getOptions(int argc, const char **argv, std::string &ofilename);
+bool checkWeights(vpRobust::vpRobustEstimatorType method, unsigned int n);
+bool checkReusedBuffers(vpRobust::vpRobustEstimatorType method);
 
 /*!
 
@@ -139,6 +143,106 @@ bool getOptions(int argc, const char **argv, std::string &ofilename)
   return true;
 }
 
+/*!
+
+  Compare the weights computed by vpRobust::MEstimator() with a reference
+  implementation based on a full sort of the residues.
+
+  \param method : Influence function to check.
+  \param n : Number of residues.
+  \return true if the weights are the same, false otherwise.
+*/
+bool checkWeights(vpRobust::vpRobustEstimatorType method, unsigned int n)
+{
+  vpUniRand rng;
+  vpColVector residues(n);
+  for (unsigned int i = 0; i < n; i++) {
+    residues[i] = rng.uniform(-1.0, 1.0);
+    // Add some outliers
+    if (i % 10 == 0) {
+      residues[i] *= 20;
+    }
+  }
+
+  std::vector<double> sorted(residues.data, residues.data + n);
+  std::sort(sorted.begin(), sorted.end());
+  unsigned int ind_med = (unsigned int)(ceil(n / 2.0)) - 1;
+  double med = sorted[ind_med];
+  std::vector<double> normres(n);
+  for (unsigned int i = 0; i < n; i++) {
+    normres[i] = fabs(residues[i] - med);
+  }
+  sorted = normres;
+  std::sort(sorted.begin(), sorted.end());
+  double sigma = std::max(1.4826 * sorted[ind_med], 0.0017);
+
+  vpColVector weights(n, 1.0);
+  vpRobust robust;
+  robust.MEstimator(method, residues, weights);
+
+  for (unsigned int i = 0; i < n; i++) {
+    double w = 0, xi_sig = normres[i] / sigma;
+    switch (method) {
+    case vpRobust::TUKEY:
+      w = fabs(xi_sig) <= 4.6851 ? vpMath::sqr(1 - vpMath::sqr(xi_sig / 4.6851)) : 0;
+      break;
+    case vpRobust::HUBER:
+      w = fabs(xi_sig) <= 1.2107 ? 1 : 1.2107 / fabs(xi_sig);
+      break;
+    case vpRobust::CAUCHY:
+      w = 1 / (1 + vpMath::sqr(normres[i] / (2.3849 * sigma)));
+      break;
+    }
+
+    if (!vpMath::equal(w, weights[i], std::numeric_limits<double>::epsilon())) {
+      std::cerr << "Weight " << i << " differs: " << weights[i] << " (expected " << w << ")" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*!
+
+  Check that the weights past the residues are left untouched when the
+  estimator is reused after a call with more normalized residues.
+
+  \param method : Influence function to check.
+  \return true if only the weights of the residues are modified, false otherwise.
+*/
+bool checkReusedBuffers(vpRobust::vpRobustEstimatorType method)
+{
+  vpUniRand rng;
+  const unsigned int n = 11, n_all = 101;
+  vpColVector residues(n), all_residues(n_all);
+  for (unsigned int i = 0; i < n_all; i++) {
+    all_residues[i] = rng.uniform(-1.0, 1.0);
+  }
+  for (unsigned int i = 0; i < n; i++) {
+    residues[i] = all_residues[i];
+  }
+
+  vpRobust robust;
+  vpColVector weights(n_all, 1.0);
+  robust.MEstimator(method, residues, all_residues, weights);
+
+  // Weights larger than the residues, the last ones must be kept
+  weights = 1.0;
+  for (unsigned int i = n; i < n_all; i++) {
+    weights[i] = -1.0;
+  }
+  robust.MEstimator(method, residues, weights);
+  for (unsigned int i = n; i < n_all; i++) {
+    if (weights[i] != -1.0) {
+      std::cerr << "Weight " << i << " past the " << n << " residues is modified: " << weights[i] << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
 int main(int argc, const char **argv)
 {
   try {
@@ -203,6 +307,16 @@ int main(int argc, const char **argv)
       f << x << "  " << w << std::endl;
       x += 0.01;
     }
+
+    const vpRobust::vpRobustEstimatorType methods[] = {vpRobust::TUKEY, vpRobust::HUBER, vpRobust::CAUCHY};
+    for (unsigned int i = 0; i < 3; i++) {
+      if (!checkWeights(methods[i], 1001) || !checkWeights(methods[i], 4) || !checkReusedBuffers(methods[i])) {
+        std::cerr << "Bad weights computed with M-estimator " << methods[i] << std::endl;
+        return 1;
+      }
+    }
+    std::cout << "M-estimator weights are the expected ones" << std::endl;
+
     return 0;
   } catch (const vpException &e) {
     std::cout << "Catch an exception: " << e << std::endl;
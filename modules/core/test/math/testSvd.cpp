@@ -43,6 +43,7 @@
 */
 
 #include <algorithm>
+#include <cmath>
 #include <stdio.h>
 #include <stdlib.h>
 #include <vector>
@@ -232,6 +233,59 @@ int test_svd(std::vector<vpMatrix> M, std::vector<vpMatrix> U, std::vector<vpCol
   return EXIT_SUCCESS;
 }
 
+int test_svd_jacobi(bool verbose, const std::vector<vpMatrix> &bench, double &time)
+{
+  if (verbose)
+    std::cout << "Test SVD using built-in Jacobi method" << std::endl;
+  // Compute inverse
+  if (verbose)
+    std::cout << "  SVD on a " << bench[0].getRows() << "x" << bench[0].getCols() << " matrix" << std::endl;
+
+  std::vector<vpMatrix> U = bench;
+  std::vector<vpMatrix> V(bench.size());
+  std::vector<vpColVector> s(bench.size());
+
+  double t = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < bench.size(); i++) {
+    U[i].svdJacobi(s[i], V[i]);
+  }
+  time = vpTime::measureTimeMs() - t;
+
+  for (unsigned int i = 0; i < bench.size(); i++) {
+    for (unsigned int j = 1; j < s[i].size(); j++) {
+      if (s[i][j] > s[i][j - 1]) {
+        std::cout << "Singular values are not sorted in decreasing order" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    // The component of largest magnitude of each right singular vector is positive
+    for (unsigned int j = 0; j < V[i].getCols(); j++) {
+      unsigned int kmax = 0;
+      for (unsigned int k = 1; k < V[i].getRows(); k++) {
+        if (std::fabs(V[i][k][j]) > std::fabs(V[i][kmax][j])) {
+          kmax = k;
+        }
+      }
+      if (V[i][kmax][j] < 0) {
+        std::cout << "Right singular vector " << j << " does not follow the sign convention" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    // svd() dispatches small matrices to the Jacobi method
+    if (bench[i].getCols() <= 16) {
+      vpMatrix U_svd = bench[i], V_svd;
+      vpColVector s_svd;
+      U_svd.svd(s_svd, V_svd);
+      if (s_svd != s[i] || V_svd != V[i] || U_svd != U[i]) {
+        std::cout << "svd() does not use the Jacobi method on a small matrix" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return test_svd(bench, U, s, V);
+}
+
 #if defined(VISP_HAVE_EIGEN3)
 int test_svd_eigen3(bool verbose, const std::vector<vpMatrix> &bench, double &time)
 {
@@ -338,8 +392,6 @@ void save_time(const std::string &method, bool verbose, bool use_plot_file, std:
 int main(int argc, const char *argv[])
 {
   try {
-#if defined(VISP_HAVE_EIGEN3) || defined(VISP_HAVE_LAPACK) || (VISP_HAVE_OPENCV_VERSION >= 0x020101) ||                \
-    defined(VISP_HAVE_GSL)
     unsigned int nb_matrices = 100;
     unsigned int nb_iterations = 10;
     unsigned int nb_rows = 6;
@@ -359,6 +411,8 @@ int main(int argc, const char *argv[])
       of.open(plotfile.c_str());
       of << "iter"
          << "\t";
+      of << "\"SVD Jacobi\""
+         << "\t";
 
 #if defined(VISP_HAVE_LAPACK)
       of << "\"SVD Lapack\""
@@ -388,6 +442,9 @@ int main(int argc, const char *argv[])
         of << iter << "\t";
       double time;
 
+      ret += test_svd_jacobi(verbose, bench_random_matrices, time);
+      save_time("SVD (Jacobi): ", verbose, use_plot_file, of, time);
+
 #if defined(VISP_HAVE_LAPACK)
       ret += test_svd_lapack(verbose, bench_random_matrices, time);
       save_time("SVD (Lapack): ", verbose, use_plot_file, of, time);
@@ -415,6 +472,28 @@ int main(int argc, const char *argv[])
       std::cout << "Result saved in " << plotfile << std::endl;
     }
 
+    // Benchmark the sizes encountered in rotation orthonormalization (3x3),
+    // homography DLT (9x9) and pose estimation (2N x 12)
+    const unsigned int bench_sizes[3][2] = {{3, 3}, {9, 9}, {24, 12}};
+    for (unsigned int i = 0; i < 3; i++) {
+      std::vector<vpMatrix> bench_random_matrices;
+      create_bench_random_matrix(nb_matrices, bench_sizes[i][0], bench_sizes[i][1], verbose, bench_random_matrices);
+      std::cout << "SVD of " << nb_matrices << " " << bench_sizes[i][0] << "x" << bench_sizes[i][1] << " matrices"
+                << std::endl;
+      double time;
+
+      ret += test_svd_jacobi(verbose, bench_random_matrices, time);
+      std::cout << "  SVD (Jacobi): " << time << std::endl;
+#if defined(VISP_HAVE_LAPACK)
+      ret += test_svd_lapack(verbose, bench_random_matrices, time);
+      std::cout << "  SVD (Lapack): " << time << std::endl;
+#endif
+#if defined(VISP_HAVE_EIGEN3)
+      ret += test_svd_eigen3(verbose, bench_random_matrices, time);
+      std::cout << "  SVD (Eigen3): " << time << std::endl;
+#endif
+    }
+
     if (ret == EXIT_SUCCESS) {
       std::cout << "Test succeed" << std::endl;
     } else {
@@ -422,14 +501,6 @@ int main(int argc, const char *argv[])
     }
 
     return ret;
-#else
-    (void)argc;
-    (void)argv;
-    std::cout << "Test does nothing since you dont't have Eigen3, Lapack, "
-                 "OpenCV or GSL 3rd party"
-              << std::endl;
-    return EXIT_SUCCESS;
-#endif
   } catch (const vpException &e) {
     std::cout << "Catch an exception: " << e.getStringMessage() << std::endl;
     return EXIT_FAILURE;
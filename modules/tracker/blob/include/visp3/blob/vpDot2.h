@@ -54,6 +54,8 @@
 #include <list>
 #include <vector>
 
+class vpDotRunLabelling;
+
 /*!
   \class vpDot2
 
@@ -126,6 +128,16 @@
 class VISP_EXPORT vpDot2 : public vpTracker
 {
 public:
+  /*!
+    Method used by searchDotsInArea() to find the dots in the area.
+  */
+  typedef enum {
+    SEARCH_BORDER_FOLLOWING, /*!< Start from the nodes of a grid and follow
+                                the border of each candidate dot (default). */
+    SEARCH_LABELLING         /*!< Label all the connected components of the
+                                area in a single pass. */
+  } vpSearchMode;
+
   vpDot2();
   explicit vpDot2(const vpImagePoint &ip);
   vpDot2(const vpDot2 &twinDot);
@@ -205,6 +217,12 @@ public:
     \sa getGrayLevelMin()
   */
   inline unsigned int getGrayLevelMax() const { return gray_level_max; };
+  /*!
+    Return the method used by searchDotsInArea() to find the dots.
+
+    \sa setSearchMode()
+  */
+  inline vpSearchMode getSearchMode() const { return searchMode; }
   double getGrayLevelPrecision() const;
 
   double getHeight() const;
@@ -254,6 +272,20 @@ public:
 
   */
   void setComputeMoments(bool activate) { compute_moment = activate; }
+  /*!
+    Set the method used by searchDotsInArea() to find the dots.
+
+    \param mode : With vpDot2::SEARCH_BORDER_FOLLOWING (default) the border of
+    the candidate dots is followed from the nodes of a grid. With
+    vpDot2::SEARCH_LABELLING the pixels of the area that have the right gray
+    level are grouped in 8-connected components in a single pass over the
+    area, the moments of the components being computed on the fly. This last
+    mode does not depend on the grid size and is faster when the area
+    contains many dots. The surface and the moments of the dots that are found
+    are then computed from the pixels of the dot, and the list of border
+    points is empty until the next call to track().
+  */
+  inline void setSearchMode(const vpSearchMode &mode) { searchMode = mode; }
 
   /*!
     Set the percentage of sampled points that are considered non conform
@@ -414,6 +446,8 @@ public:
          */
 
 private:
+  friend class vpDotTracker;
+
   virtual bool isValid(const vpImage<unsigned char> &I, const vpDot2 &wantedDot);
 
   virtual bool hasGoodLevel(const vpImage<unsigned char> &I, const unsigned int &u, const unsigned int &v) const;
@@ -425,6 +459,10 @@ private:
 
   bool computeParameters(const vpImage<unsigned char> &I, const double &u = -1.0, const double &v = -1.0);
 
+  void searchDotsByLabelling(const vpImage<unsigned char> &I, int area_u, int area_v, unsigned int area_w,
+                             unsigned int area_h, std::list<vpDot2> &niceDots);
+  void setComponent(const vpDotRunLabelling &labelling, unsigned int c);
+
   bool findFirstBorder(const vpImage<unsigned char> &I, const unsigned int &u, const unsigned int &v,
                        unsigned int &border_u, unsigned int &border_v);
   void computeMeanGrayLevel(const vpImage<unsigned char> &I);
@@ -498,6 +536,8 @@ private:
 
   unsigned int thickness; // Graphics thickness
 
+  vpSearchMode searchMode; // Method used to search dots in an area
+
   // Bounding box
   int bbox_u_min, bbox_u_max, bbox_v_min, bbox_v_max;
 
@@ -0,0 +1,220 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Track a set of dots in a single pass over their regions of interest.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpDotTracker.h
+  \brief Track a set of dots in a single pass over their regions of interest.
+*/
+
+#ifndef vpDotTracker_hh
+#define vpDotTracker_hh
+
+#include <utility>
+#include <vector>
+
+#include <visp3/blob/vpDot2.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+
+/*!
+  \class vpDotTracker
+
+  \ingroup module_blob
+
+  \brief Track a set of similar dots (calibration grid, motion capture
+  markers...) sharing the same gray level interval.
+
+  Tracking N dots with vpDot2::track() means N scans of the image from the
+  previous position of each dot, each one following the border of its dot
+  and updating its own gray level interval. vpDotTracker binarises the image
+  once with a gray level interval shared by all the dots, and only in the
+  union of the regions of interest of the dots. The region of interest of a
+  dot is centered on its previous center of gravity, and its size is the
+  size of the dot scaled by setSearchWindowScale().
+
+  The pixels of the union are labelled in 8-connected components in a
+  single pass, in parallel over bands of rows, and the moments of the
+  components are accumulated from their runs of pixels. Each dot then takes
+  the component that contains its previous center of gravity. The component
+  is accepted if it lies in the region of interest of the dot and passes the
+  same validity test as vpDot2::track(), the dots being updated in parallel
+  with OpenMP when setUseParallelTracking() is enabled. Otherwise the dot is
+  tracked with vpDot2::track(), which searches it in a larger window. The
+  outcome for each dot is given by getStatus():
+  - vpDotTracker::TRACKED when the dot was found in the shared labelling;
+  - vpDotTracker::SEARCHED when the dot was found by vpDot2::track();
+  - vpDotTracker::LOST when vpDot2::track() failed. The parameters of a lost
+    dot are unchanged.
+
+  As with vpDot2::SEARCH_LABELLING, the surface and the moments of a dot
+  found in the shared labelling are computed from its pixels. The list of
+  its border points is only filled when setStoreContours() is enabled, so
+  that the memory used by the tracker does not depend on the length of the
+  contours.
+
+  The shared gray level interval is initialized from the intervals of the
+  dots that are added, and is then updated after each frame from the mean
+  gray level of the tracked dots, with the gray level precision and the gamma
+  of the first dot (see vpDot2::setGrayLevelPrecision()).
+
+  \code
+#include <visp3/blob/vpDotTracker.h>
+
+int main()
+{
+  vpImage<unsigned char> I;
+  // ... acquire I
+  vpDotTracker tracker;
+  std::list<vpDot2> dots;
+  vpDot2 blob;
+  // ... set the characteristics of the dots to find in blob
+  blob.searchDotsInArea(I, dots);
+  for (std::list<vpDot2>::const_iterator it = dots.begin(); it != dots.end(); ++it) {
+    tracker.addDot(*it);
+  }
+  tracker.setUseParallelTracking(true);
+
+  while (true) {
+    // ... acquire I
+    tracker.track(I);
+    for (unsigned int i = 0; i < tracker.getNbDots(); i++) {
+      if (tracker.getStatus(i) != vpDotTracker::LOST) {
+        vpImagePoint cog = tracker.getCog(i);
+      }
+    }
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpDotTracker
+{
+public:
+  //! Outcome of the tracking of a dot at the last frame
+  typedef enum {
+    NOT_TRACKED, ///< No frame tracked yet
+    TRACKED,     ///< Found in the shared labelling of the regions of interest
+    SEARCHED,    ///< Found by vpDot2::track()
+    LOST         ///< vpDot2::track() failed, the dot is unchanged
+  } vpDotStatus;
+
+  vpDotTracker();
+  virtual ~vpDotTracker();
+
+  unsigned int addDot(const vpDot2 &dot);
+  void clear();
+  void display(const vpImage<unsigned char> &I, vpColor color = vpColor::red, unsigned int thickness = 1) const;
+
+  vpImagePoint getCog(unsigned int index) const;
+  const vpDot2 &getDot(unsigned int index) const;
+  //! \return The minimal gray level of the dots.
+  inline unsigned int getGrayLevelMin() const { return m_grayLevelMin; }
+  //! \return The maximal gray level of the dots.
+  inline unsigned int getGrayLevelMax() const { return m_grayLevelMax; }
+  //! \return The number of dots.
+  inline unsigned int getNbDots() const { return static_cast<unsigned int>(m_dots.size()); }
+  unsigned int getNbLost() const;
+  //! \return The scale factor between the size of a dot and its region of interest.
+  inline double getSearchWindowScale() const { return m_searchWindowScale; }
+  vpDotStatus getStatus(unsigned int index) const;
+  //! \return True if the border points of the dots are stored.
+  inline bool getStoreContours() const { return m_storeContours; }
+  //! \return True if the dots are updated concurrently.
+  inline bool getUseParallelTracking() const { return m_useParallelTracking; }
+
+  void setGrayLevelMin(unsigned int min);
+  void setGrayLevelMax(unsigned int max);
+  /*!
+    Set the number of threads used by setUseParallelTracking().
+
+    \param nb : Number of threads, 0 to use the OpenMP default.
+  */
+  inline void setNbParallelThreads(unsigned int nb) { m_nbParallelThreads = nb; }
+  void setSearchWindowScale(double scale);
+  /*!
+    Enable or disable the storage of the border points of the dots.
+
+    \param store : If true, the border points of a dot found in the shared
+    labelling are stored in raster order and available with
+    vpDot2::getEdges(). If false (default), the border points of the dots
+    are cleared after each frame.
+  */
+  inline void setStoreContours(bool store) { m_storeContours = store; }
+  /*!
+    Enable or disable the parallel labelling and the concurrent update of
+    the dots. Without OpenMP, or when the graphics of a dot are enabled,
+    the dots are updated one after the other.
+
+    \param parallel : If true, the dots are updated concurrently.
+  */
+  inline void setUseParallelTracking(bool parallel) { m_useParallelTracking = parallel; }
+
+  void track(const vpImage<unsigned char> &I);
+
+private:
+  vpDotTracker(const vpDotTracker &);            // noncopyable
+  vpDotTracker &operator=(const vpDotTracker &); //
+
+  void buildRegions(const vpImage<unsigned char> &I);
+  void storeContour(const vpImage<unsigned char> &I, unsigned int index, unsigned int c);
+  void trackDot(const vpImage<unsigned char> &I, unsigned int index);
+  void updateGrayLevels();
+
+  //! Tracked dots
+  std::vector<vpDot2> m_dots;
+  //! Outcome of each dot at the last frame
+  std::vector<vpDotStatus> m_status;
+  //! Regions of interest of the dots at the last frame
+  std::vector<int> m_roiUMin, m_roiUMax, m_roiVMin, m_roiVMax;
+  //! Union of the regions of interest, as intervals of columns per row
+  std::vector<unsigned int> m_rowIntervals;
+  std::vector<std::pair<int, int> > m_intervals;
+  //! First row of the union of the regions of interest
+  int m_firstRow;
+  //! Labelling of the union of the regions of interest
+  vpDotRunLabelling *m_labelling;
+  //! Shared gray level interval
+  unsigned int m_grayLevelMin;
+  unsigned int m_grayLevelMax;
+  //! Scale factor between the size of a dot and its region of interest
+  double m_searchWindowScale;
+  //! True if the border points of the dots are stored
+  bool m_storeContours;
+  //! True if the dots are updated concurrently
+  bool m_useParallelTracking;
+  //! Number of threads, 0 for the OpenMP default
+  unsigned int m_nbParallelThreads;
+};
+
+#endif
@@ -51,12 +51,25 @@
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpTrackingException.h>
 
-#include <cmath> // std::fabs
+#include <algorithm> // std::stable_sort
+#include <cmath>     // std::fabs
 #include <iostream>
 #include <limits> // numeric_limits
 #include <math.h>
 #include <visp3/blob/vpDot2.h>
 
+#include "vpDotRunLabelling.h"
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+bool closerToAreaCenter(const std::pair<double, vpDot2> &a, const std::pair<double, vpDot2> &b)
+{
+  return a.first < b.first;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /******************************************************************************
  *
  *      CONSTRUCTORS AND DESTRUCTORS
@@ -96,6 +109,7 @@ void vpDot2::init()
   compute_moment = false;
   graphics = false;
   thickness = 1;
+  searchMode = SEARCH_BORDER_FOLLOWING;
 }
 
 /*!
@@ -106,7 +120,8 @@ vpDot2::vpDot2()
     surface(0), gray_level_min(128), gray_level_max(255), mean_gray_level(0), grayLevelPrecision(0.8), gamma(1.5),
     sizePrecision(0.65), ellipsoidShapePrecision(0.65), maxSizeSearchDistancePrecision(0.65),
     allowedBadPointsPercentage_(0.), area(), direction_list(), ip_edges_list(), compute_moment(false), graphics(false),
-    thickness(1), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0), firstBorder_u(0), firstBorder_v()
+    thickness(1), searchMode(SEARCH_BORDER_FOLLOWING), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0),
+    firstBorder_u(0), firstBorder_v()
 {
 }
 
@@ -123,7 +138,8 @@ vpDot2::vpDot2(const vpImagePoint &ip)
     surface(0), gray_level_min(128), gray_level_max(255), mean_gray_level(0), grayLevelPrecision(0.8), gamma(1.5),
     sizePrecision(0.65), ellipsoidShapePrecision(0.65), maxSizeSearchDistancePrecision(0.65),
     allowedBadPointsPercentage_(0.), area(), direction_list(), ip_edges_list(), compute_moment(false), graphics(false),
-    thickness(1), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0), firstBorder_u(0), firstBorder_v()
+    thickness(1), searchMode(SEARCH_BORDER_FOLLOWING), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0),
+    firstBorder_u(0), firstBorder_v()
 {
 }
 
@@ -135,8 +151,8 @@ vpDot2::vpDot2(const vpDot2 &twinDot)
     width(0), height(0), surface(0), gray_level_min(128), gray_level_max(255), mean_gray_level(0),
     grayLevelPrecision(0.8), gamma(1.5), sizePrecision(0.65), ellipsoidShapePrecision(0.65),
     maxSizeSearchDistancePrecision(0.65), allowedBadPointsPercentage_(0.), area(), direction_list(), ip_edges_list(),
-    compute_moment(false), graphics(false), thickness(1), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0),
-    firstBorder_u(0), firstBorder_v()
+    compute_moment(false), graphics(false), thickness(1), searchMode(SEARCH_BORDER_FOLLOWING), bbox_u_min(0),
+    bbox_u_max(0), bbox_v_min(0), bbox_v_max(0), firstBorder_u(0), firstBorder_v()
 {
   *this = twinDot;
 }
@@ -169,6 +185,7 @@ vpDot2 &vpDot2::operator=(const vpDot2 &twinDot)
   compute_moment = twinDot.compute_moment;
   graphics = twinDot.graphics;
   thickness = twinDot.thickness;
+  searchMode = twinDot.searchMode;
 
   bbox_u_min = twinDot.bbox_u_min;
   bbox_u_max = twinDot.bbox_u_max;
@@ -974,6 +991,8 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char> &I, std::list<vpDot2>
   \warning Allocates memory for the list of vpDot2 returned by this method.
   Desallocation has to be done by yourself, see searchDotsInArea()
 
+  The way the dots are searched in the area is given by setSearchMode().
+
   \sa searchDotsInArea(vpImage<unsigned char>& I, std::list<vpDot2> &)
 */
 void vpDot2::searchDotsInArea(const vpImage<unsigned char> &I, int area_u, int area_v, unsigned int area_w,
@@ -987,6 +1006,11 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char> &I, int area_u, int a
   // this area and the image.
   setArea(I, area_u, area_v, area_w, area_h);
 
+  if (searchMode == SEARCH_LABELLING) {
+    searchDotsByLabelling(I, area_u, area_v, area_w, area_h, niceDots);
+    return;
+  }
+
   // compute the size of the search grid
   unsigned int gridWidth;
   unsigned int gridHeight;
@@ -1207,6 +1231,147 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char> &I, int area_u, int a
     delete dotToTest;
 }
 
+/*!
+
+  Look for the dots matching this dot parameters within the area by
+  labelling the connected components of the pixels that have the right gray
+  level. This is the implementation of searchDotsInArea() when the search
+  mode is vpDot2::SEARCH_LABELLING.
+
+  The area is cut in horizontal bands that are processed in parallel when
+  OpenMP is available. In each band the rows are encoded as runs of pixels
+  having the right gray level, and the 8-connected runs of consecutive rows
+  are merged with a union-find structure. The bands are then stitched
+  together along their boundary rows. Since the moments of a run have a closed
+  form, the moments of each component are obtained by accumulating the
+  moments of its runs, without following the border of the dot (see
+  setComponent()).
+
+  The dots that are found are tested with isValid() and sorted by distance
+  to the center of the input area like in the border following mode.
+
+  \param I : Image to process.
+  \param area_u : Coordinate (column) of the upper-left corner of the input
+  area.
+  \param area_v : Coordinate (row) of the upper-left corner of the input
+  area.
+  \param area_w : Width of the input area.
+  \param area_h : Height of the input area.
+  \param niceDots: List of the dots that are found.
+
+  \sa setSearchMode()
+*/
+void vpDot2::searchDotsByLabelling(const vpImage<unsigned char> &I, int area_u, int area_v, unsigned int area_w,
+                                   unsigned int area_h, std::list<vpDot2> &niceDots)
+{
+  if (area.getWidth() < 1 || area.getHeight() < 1) {
+    return;
+  }
+
+  if (gray_level_min > gray_level_max || gray_level_min > 255) {
+    return;
+  }
+
+  // One interval per row of the area
+  const unsigned int nbRows = (unsigned int)area.getHeight();
+  std::vector<unsigned int> rowIntervals(nbRows + 1);
+  for (unsigned int r = 0; r <= nbRows; r++) {
+    rowIntervals[r] = r;
+  }
+  std::vector<std::pair<int, int> > intervals(nbRows, std::make_pair((int)area.getLeft(), (int)area.getRight()));
+
+  vpDotRunLabelling labelling;
+  labelling.label(I, (unsigned char)gray_level_min, (unsigned char)vpMath::minimum(gray_level_max, 255u),
+                  (int)area.getTop(), rowIntervals, intervals, 0);
+
+  // Build the dots and keep the valid ones
+  const double area_center_u = area_u + area_w / 2.0 - 0.5;
+  const double area_center_v = area_v + area_h / 2.0 - 0.5;
+
+  vpDot2 dotToTest;
+  dotToTest.setGrayLevelMin(getGrayLevelMin());
+  dotToTest.setGrayLevelMax(getGrayLevelMax());
+  dotToTest.setGrayLevelPrecision(getGrayLevelPrecision());
+  dotToTest.setSizePrecision(getSizePrecision());
+  dotToTest.setGraphics(graphics);
+  dotToTest.setGraphicsThickness(thickness);
+  dotToTest.setComputeMoments(true);
+  dotToTest.setArea(area);
+  dotToTest.setEllipsoidShapePrecision(ellipsoidShapePrecision);
+  dotToTest.setEllipsoidBadPointsPercentage(allowedBadPointsPercentage_);
+  dotToTest.setSearchMode(searchMode);
+
+  std::vector<std::pair<double, vpDot2> > validDots;
+  for (unsigned int c = 0; c < labelling.getNbComponents(); c++) {
+    // Same rejection as computeParameters()
+    if (labelling.m00[c] < 2.) {
+      continue;
+    }
+    dotToTest.setComponent(labelling, c);
+
+    if (dotToTest.isValid(I, *this)) {
+      double diff_u = dotToTest.cog.get_u() - area_center_u;
+      double diff_v = dotToTest.cog.get_v() - area_center_v;
+      validDots.push_back(std::make_pair(sqrt(diff_u * diff_u + diff_v * diff_v), dotToTest));
+    }
+  }
+
+  std::stable_sort(validDots.begin(), validDots.end(), closerToAreaCenter);
+
+  // As with the border following, a dot is not added when its center is close
+  // to the one of a dot that was already found
+  for (size_t k = 0; k < validDots.size(); k++) {
+    const vpImagePoint &cogDot = validDots[k].second.cog;
+    bool duplicate = false;
+    for (std::list<vpDot2>::const_iterator it = niceDots.begin(); it != niceDots.end() && !duplicate; ++it) {
+      double epsilon = 3.0;
+      duplicate = (fabs(it->cog.get_u() - cogDot.get_u()) < epsilon && fabs(it->cog.get_v() - cogDot.get_v()) < epsilon);
+    }
+    if (!duplicate) {
+      niceDots.push_back(validDots[k].second);
+    }
+  }
+}
+
+/*!
+
+  Set the parameters of the dot from a connected component labelled by
+  vpDotRunLabelling: moments, center of gravity, bounding box, size and mean
+  gray level. The surface is the number of pixels of the component. The
+  Freeman chain and the list of border points are cleared.
+
+  \param labelling : Result of the labelling.
+  \param c : Index of the component.
+*/
+void vpDot2::setComponent(const vpDotRunLabelling &labelling, unsigned int c)
+{
+  m00 = labelling.m00[c];
+  m10 = labelling.m10[c];
+  m01 = labelling.m01[c];
+  m11 = labelling.m11[c];
+  m20 = labelling.m20[c];
+  m02 = labelling.m02[c];
+
+  double cog_u = m10 / m00;
+  double cog_v = m01 / m00;
+  mu11 = m11 - cog_u * m01;
+  mu02 = m02 - cog_v * m01;
+  mu20 = m20 - cog_u * m10;
+  cog.set_uv(cog_u, cog_v);
+
+  bbox_u_min = labelling.u_min[c];
+  bbox_u_max = labelling.u_max[c];
+  bbox_v_min = labelling.v_min[c];
+  bbox_v_max = labelling.v_max[c];
+  width = bbox_u_max - bbox_u_min + 1;
+  height = bbox_v_max - bbox_v_min + 1;
+  surface = m00;
+  mean_gray_level = labelling.sum_gray[c] / m00;
+
+  direction_list.clear();
+  ip_edges_list.clear();
+}
+
 /*!
 
   Check if the dot is "like" the wanted dot passed in.
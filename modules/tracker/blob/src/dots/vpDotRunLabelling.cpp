@@ -0,0 +1,287 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Connected component labelling of the pixels of a dot.
+ *
+ *****************************************************************************/
+
+#include "vpDotRunLabelling.h"
+
+#include <visp3/core/vpMath.h>
+
+#if defined(VISP_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+namespace
+{
+// Sum of the squares of the integers in [0, x]
+inline double sumOfSquares(double x) { return x * (x + 1.) * (2. * x + 1.) / 6.; }
+}
+
+vpDotRunLabelling::vpDotRunLabelling()
+  : row_min(0), runs(), rowBegin(), component(), m00(), m10(), m01(), m11(), m20(), m02(), sum_gray(), u_min(),
+    u_max(), v_min(), v_max(), bandRuns(), bandRowBegin(), parent()
+{
+}
+
+/*
+  Return the component of the pixel (u, v), or -1 if the pixel was not
+  labelled.
+*/
+int vpDotRunLabelling::findComponent(int u, int v) const
+{
+  if (v < row_min || v - row_min + 1 >= static_cast<int>(rowBegin.size())) {
+    return -1;
+  }
+  unsigned int first = rowBegin[static_cast<size_t>(v - row_min)];
+  unsigned int last = rowBegin[static_cast<size_t>(v - row_min) + 1];
+  while (first < last) {
+    unsigned int middle = (first + last) / 2;
+    if (runs[middle].u_max < u) {
+      first = middle + 1;
+    } else if (runs[middle].u_min > u) {
+      last = middle;
+    } else {
+      return static_cast<int>(component[middle]);
+    }
+  }
+  return -1;
+}
+
+/*
+  Label the pixels of the rows [first_row, first_row + rowIntervals.size() - 2].
+
+  The columns of row r that are processed are the inclusive intervals
+  intervals[rowIntervals[r]] to intervals[rowIntervals[r + 1] - 1]. The
+  intervals of a row must be sorted, within the image and neither overlap
+  nor touch.
+
+  nbThreads is the maximal number of bands processed in parallel, 0 to use
+  the OpenMP default.
+*/
+void vpDotRunLabelling::label(const vpImage<unsigned char> &I, unsigned char level_min, unsigned char level_max,
+                              int first_row, const std::vector<unsigned int> &rowIntervals,
+                              const std::vector<std::pair<int, int> > &intervals, unsigned int nbThreads)
+{
+  const unsigned int nbRows = rowIntervals.empty() ? 0 : static_cast<unsigned int>(rowIntervals.size() - 1);
+  row_min = first_row;
+  runs.clear();
+  rowBegin.assign(nbRows + 1, 0);
+  component.clear();
+  m00.clear();
+  m10.clear();
+  m01.clear();
+  m11.clear();
+  m20.clear();
+  m02.clear();
+  sum_gray.clear();
+  u_min.clear();
+  u_max.clear();
+  v_min.clear();
+  v_max.clear();
+  if (nbRows == 0) {
+    return;
+  }
+
+  // Cut the rows in bands of at least 16 rows
+  unsigned int nbBands = 1;
+#if defined(VISP_HAVE_OPENMP)
+  if (nbThreads == 0) {
+    nbThreads = static_cast<unsigned int>(omp_get_max_threads());
+  }
+  nbBands = vpMath::maximum(1u, vpMath::minimum(nbThreads, nbRows / 16));
+#else
+  (void)nbThreads;
+#endif
+  std::vector<unsigned int> bandFirstRow(nbBands + 1);
+  for (unsigned int b = 0; b <= nbBands; b++) {
+    bandFirstRow[b] = (b * nbRows) / nbBands;
+  }
+
+  // Run-length encoding of the rows of each band
+  bandRuns.resize(nbBands);
+  bandRowBegin.resize(nbBands);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static, 1) num_threads(nbBands)
+#endif
+  for (int b = 0; b < static_cast<int>(nbBands); b++) {
+    std::vector<vpRun> &band_runs = bandRuns[static_cast<size_t>(b)];
+    std::vector<unsigned int> &band_row_begin = bandRowBegin[static_cast<size_t>(b)];
+    band_runs.clear();
+    band_row_begin.clear();
+    for (unsigned int r = bandFirstRow[static_cast<size_t>(b)]; r < bandFirstRow[static_cast<size_t>(b) + 1]; r++) {
+      band_row_begin.push_back(static_cast<unsigned int>(band_runs.size()));
+      const int v = first_row + static_cast<int>(r);
+      const unsigned char *row = I[static_cast<unsigned int>(v)];
+      for (unsigned int k = rowIntervals[r]; k < rowIntervals[r + 1]; k++) {
+        int u = intervals[k].first;
+        const int u_end = intervals[k].second;
+        while (u <= u_end) {
+          if (row[u] < level_min || row[u] > level_max) {
+            ++u;
+            continue;
+          }
+          vpRun run;
+          run.v = v;
+          run.u_min = u;
+          run.sum_gray = 0;
+          while (u <= u_end && row[u] >= level_min && row[u] <= level_max) {
+            run.sum_gray += row[u];
+            ++u;
+          }
+          run.u_max = u - 1;
+          band_runs.push_back(run);
+        }
+      }
+    }
+    band_row_begin.push_back(static_cast<unsigned int>(band_runs.size()));
+  }
+
+  // Gather the runs in raster order
+  size_t nbRuns = 0;
+  for (unsigned int b = 0; b < nbBands; b++) {
+    nbRuns += bandRuns[b].size();
+  }
+  runs.reserve(nbRuns);
+  for (unsigned int b = 0; b < nbBands; b++) {
+    const unsigned int offset = static_cast<unsigned int>(runs.size());
+    for (unsigned int r = bandFirstRow[b]; r <= bandFirstRow[b + 1]; r++) {
+      rowBegin[r] = offset + bandRowBegin[b][r - bandFirstRow[b]];
+    }
+    runs.insert(runs.end(), bandRuns[b].begin(), bandRuns[b].end());
+  }
+
+  // Union of the connected runs within each band, then along the band
+  // boundaries. Each band only touches its own runs.
+  parent.resize(runs.size());
+  for (unsigned int i = 0; i < parent.size(); i++) {
+    parent[i] = i;
+  }
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static, 1) num_threads(nbBands)
+#endif
+  for (int b = 0; b < static_cast<int>(nbBands); b++) {
+    for (unsigned int r = bandFirstRow[static_cast<size_t>(b)] + 1; r < bandFirstRow[static_cast<size_t>(b) + 1];
+         r++) {
+      connectRows(r);
+    }
+  }
+  for (unsigned int b = 1; b < nbBands; b++) {
+    connectRows(bandFirstRow[b]);
+  }
+
+  // Accumulate the moments of the runs in their component
+  component.resize(runs.size());
+  for (unsigned int i = 0; i < runs.size(); i++) {
+    const vpRun &run = runs[i];
+    unsigned int root = findRoot(i);
+    if (root == i) {
+      component[i] = static_cast<unsigned int>(m00.size());
+      m00.push_back(0.);
+      m10.push_back(0.);
+      m01.push_back(0.);
+      m11.push_back(0.);
+      m20.push_back(0.);
+      m02.push_back(0.);
+      sum_gray.push_back(0.);
+      u_min.push_back(run.u_min);
+      u_max.push_back(run.u_max);
+      v_min.push_back(run.v);
+      v_max.push_back(run.v);
+    } else {
+      component[i] = component[root];
+    }
+    const unsigned int c = component[i];
+
+    const double n = run.u_max - run.u_min + 1;
+    const double su = 0.5 * (run.u_min + run.u_max) * n;
+    const double v = run.v;
+    m00[c] += n;
+    m10[c] += su;
+    m01[c] += v * n;
+    m11[c] += v * su;
+    m20[c] += sumOfSquares(run.u_max) - sumOfSquares(run.u_min - 1);
+    m02[c] += v * v * n;
+    sum_gray[c] += run.sum_gray;
+    u_min[c] = vpMath::minimum(u_min[c], run.u_min);
+    u_max[c] = vpMath::maximum(u_max[c], run.u_max);
+    v_max[c] = run.v;
+  }
+}
+
+// Merge the 8-connected runs of a row with the ones of the previous row
+void vpDotRunLabelling::connectRows(unsigned int row)
+{
+  unsigned int i = rowBegin[row - 1], j = rowBegin[row];
+  const unsigned int prev_end = rowBegin[row], cur_end = rowBegin[row + 1];
+  while (i < prev_end && j < cur_end) {
+    if (runs[i].u_max + 1 < runs[j].u_min) {
+      ++i;
+    } else if (runs[j].u_max + 1 < runs[i].u_min) {
+      ++j;
+    } else {
+      unite(i, j);
+      if (runs[i].u_max < runs[j].u_max) {
+        ++i;
+      } else {
+        ++j;
+      }
+    }
+  }
+}
+
+// Root of a set, with path halving
+unsigned int vpDotRunLabelling::findRoot(unsigned int i)
+{
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+// The root of the union is the smallest index, so that the labels do not
+// depend on the order of the unions
+void vpDotRunLabelling::unite(unsigned int i, unsigned int j)
+{
+  i = findRoot(i);
+  j = findRoot(j);
+  if (i < j) {
+    parent[j] = i;
+  } else if (j < i) {
+    parent[i] = j;
+  }
+}
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Connected component labelling of the pixels of a dot.
+ *
+ *****************************************************************************/
+
+#ifndef vpDotRunLabelling_h
+#define vpDotRunLabelling_h
+
+#include <utility>
+#include <vector>
+
+#include <visp3/core/vpImage.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*
+  Labelling in 8-connected components of the pixels whose gray level is in
+  [level_min, level_max], restricted to a set of intervals per row.
+
+  The rows are cut in bands that are processed in parallel when OpenMP is
+  available. In each band the rows are encoded as runs of pixels, and the
+  connected runs of consecutive rows are merged with a union-find whose roots
+  are the smallest run index. The bands are then stitched along their
+  boundary rows. Since the moments of a run have a closed form, the moments
+  of a component are accumulated from the moments of its runs. They are sums
+  of integers that are exactly represented, so that the result does not
+  depend on the number of bands.
+
+  The moments of the components are stored as structure of arrays, and the
+  buffers are kept from one call to the next.
+
+  Internal to the blob module, used by vpDot2 and vpDotTracker.
+*/
+class vpDotRunLabelling
+{
+public:
+  // Horizontal run of pixels having the right gray level
+  struct vpRun {
+    int v;
+    int u_min;
+    int u_max;
+    unsigned int sum_gray;
+  };
+
+  vpDotRunLabelling();
+
+  int findComponent(int u, int v) const;
+  inline unsigned int getNbComponents() const { return static_cast<unsigned int>(m00.size()); }
+  void label(const vpImage<unsigned char> &I, unsigned char level_min, unsigned char level_max, int first_row,
+             const std::vector<unsigned int> &rowIntervals, const std::vector<std::pair<int, int> > &intervals,
+             unsigned int nbThreads);
+
+  // First row of the labelled rows
+  int row_min;
+  // Runs in raster order, and index of the first run of each row
+  std::vector<vpRun> runs;
+  std::vector<unsigned int> rowBegin;
+  // Component of each run
+  std::vector<unsigned int> component;
+  // Moments, sum of the gray levels and bounding box of each component
+  std::vector<double> m00, m10, m01, m11, m20, m02, sum_gray;
+  std::vector<int> u_min, u_max, v_min, v_max;
+
+private:
+  void connectRows(unsigned int row);
+  unsigned int findRoot(unsigned int i);
+  void unite(unsigned int i, unsigned int j);
+
+  std::vector<std::vector<vpRun> > bandRuns;
+  std::vector<std::vector<unsigned int> > bandRowBegin;
+  std::vector<unsigned int> parent;
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+#endif
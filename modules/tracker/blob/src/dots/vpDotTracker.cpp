@@ -0,0 +1,450 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Track a set of dots in a single pass over their regions of interest.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpDotTracker.cpp
+  \brief Track a set of dots in a single pass over their regions of interest.
+*/
+
+#include <visp3/blob/vpDotTracker.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <visp3/core/vpDisplay.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpMath.h>
+
+#include "vpDotRunLabelling.h"
+
+/*!
+  Default constructor. The dots are updated one after the other and their
+  border points are not stored.
+*/
+vpDotTracker::vpDotTracker()
+  : m_dots(), m_status(), m_roiUMin(), m_roiUMax(), m_roiVMin(), m_roiVMax(), m_rowIntervals(), m_intervals(),
+    m_firstRow(0), m_labelling(new vpDotRunLabelling), m_grayLevelMin(255), m_grayLevelMax(0), m_searchWindowScale(3.),
+    m_storeContours(false), m_useParallelTracking(false), m_nbParallelThreads(0)
+{
+}
+
+/*!
+  Destructor.
+*/
+vpDotTracker::~vpDotTracker() { delete m_labelling; }
+
+/*!
+  Add a dot to the tracker. The dot must be initialized, for instance with
+  vpDot2::initTracking() or vpDot2::searchDotsInArea(). The shared gray level
+  interval is extended to the one of the dot.
+
+  \param dot : Dot to track, copied in the tracker.
+
+  \return The index of the dot.
+*/
+unsigned int vpDotTracker::addDot(const vpDot2 &dot)
+{
+  m_dots.push_back(dot);
+  m_status.push_back(NOT_TRACKED);
+  m_grayLevelMin = vpMath::minimum(m_grayLevelMin, dot.getGrayLevelMin());
+  m_grayLevelMax = vpMath::maximum(m_grayLevelMax, dot.getGrayLevelMax());
+
+  if (!m_storeContours) {
+    m_dots.back().direction_list.clear();
+    m_dots.back().ip_edges_list.clear();
+  }
+
+  return static_cast<unsigned int>(m_dots.size() - 1);
+}
+
+/*!
+  Remove all the dots and reset the shared gray level interval.
+*/
+void vpDotTracker::clear()
+{
+  m_dots.clear();
+  m_status.clear();
+  m_grayLevelMin = 255;
+  m_grayLevelMax = 0;
+}
+
+/*!
+  Display the center of gravity of the dots that are not lost, and their
+  border points if they are stored.
+
+  \param I : Image.
+  \param color : The color used for the display.
+  \param thickness : Thickness of the displayed cross located at the dot cog.
+*/
+void vpDotTracker::display(const vpImage<unsigned char> &I, vpColor color, unsigned int thickness) const
+{
+  for (unsigned int i = 0; i < m_dots.size(); i++) {
+    if (m_status[i] != LOST) {
+      vpDot2::display(I, m_dots[i].getCog(), m_dots[i].ip_edges_list, color, thickness);
+    }
+  }
+}
+
+/*!
+  \param index : Index of the dot.
+  \return The center of gravity of the dot.
+*/
+vpImagePoint vpDotTracker::getCog(unsigned int index) const { return getDot(index).getCog(); }
+
+/*!
+  \param index : Index of the dot.
+  \return The dot.
+*/
+const vpDot2 &vpDotTracker::getDot(unsigned int index) const
+{
+  if (index >= m_dots.size()) {
+    throw(vpException(vpException::dimensionError, "Dot index %d out of range", index));
+  }
+  return m_dots[index];
+}
+
+/*!
+  \return The number of dots that are LOST at the last frame.
+*/
+unsigned int vpDotTracker::getNbLost() const
+{
+  return static_cast<unsigned int>(std::count(m_status.begin(), m_status.end(), LOST));
+}
+
+/*!
+  \param index : Index of the dot.
+  \return The outcome of the tracking of the dot at the last frame.
+*/
+vpDotTracker::vpDotStatus vpDotTracker::getStatus(unsigned int index) const
+{
+  if (index >= m_status.size()) {
+    throw(vpException(vpException::dimensionError, "Dot index %d out of range", index));
+  }
+  return m_status[index];
+}
+
+/*!
+  Set the minimal gray level of the dots. It is updated after each frame.
+
+  \param min : Minimal gray level.
+*/
+void vpDotTracker::setGrayLevelMin(unsigned int min) { m_grayLevelMin = vpMath::minimum(min, 255u); }
+
+/*!
+  Set the maximal gray level of the dots. It is updated after each frame.
+
+  \param max : Maximal gray level.
+*/
+void vpDotTracker::setGrayLevelMax(unsigned int max) { m_grayLevelMax = vpMath::minimum(max, 255u); }
+
+/*!
+  Set the size of the region of interest of the dots.
+
+  \param scale : Scale factor between the size of a dot and its region of
+  interest. It must be greater than 1, the default value being 3. A dot that
+  moves by more than (scale - 1) / 2 times its size between two frames is
+  searched by vpDot2::track().
+*/
+void vpDotTracker::setSearchWindowScale(double scale)
+{
+  if (scale <= 1.) {
+    throw(vpException(vpException::badValue, "The search window scale must be greater than 1"));
+  }
+  m_searchWindowScale = scale;
+}
+
+/*!
+  Track the dots in a new image. See the detailed description of the class.
+
+  \param I : Image to process.
+*/
+void vpDotTracker::track(const vpImage<unsigned char> &I)
+{
+  if (m_dots.empty()) {
+    return;
+  }
+
+  // The dots share the gray level interval
+  for (unsigned int i = 0; i < m_dots.size(); i++) {
+    m_dots[i].gray_level_min = m_grayLevelMin;
+    m_dots[i].gray_level_max = m_grayLevelMax;
+  }
+
+  buildRegions(I);
+
+  if (m_grayLevelMin > m_grayLevelMax) {
+    m_rowIntervals.clear();
+  }
+  m_labelling->label(I, static_cast<unsigned char>(vpMath::minimum(m_grayLevelMin, 255u)),
+                     static_cast<unsigned char>(vpMath::minimum(m_grayLevelMax, 255u)), m_firstRow, m_rowIntervals,
+                     m_intervals, m_useParallelTracking ? m_nbParallelThreads : 1);
+
+  // The display is not thread safe
+  bool parallel = m_useParallelTracking;
+  for (unsigned int i = 0; i < m_dots.size() && parallel; i++) {
+    parallel = !m_dots[i].graphics;
+  }
+
+#if defined(VISP_HAVE_OPENMP)
+  int nbDots = static_cast<int>(m_dots.size());
+  if (parallel) {
+    if (m_nbParallelThreads > 0) {
+#pragma omp parallel for schedule(dynamic, 1) num_threads(m_nbParallelThreads)
+      for (int i = 0; i < nbDots; i++) {
+        trackDot(I, static_cast<unsigned int>(i));
+      }
+    } else {
+#pragma omp parallel for schedule(dynamic, 1)
+      for (int i = 0; i < nbDots; i++) {
+        trackDot(I, static_cast<unsigned int>(i));
+      }
+    }
+  } else
+#endif
+  {
+    (void)parallel;
+    for (unsigned int i = 0; i < m_dots.size(); i++) {
+      trackDot(I, i);
+    }
+  }
+
+  updateGrayLevels();
+}
+
+/*!
+  Compute the region of interest of each dot and their union, as sorted
+  intervals of columns per row.
+*/
+void vpDotTracker::buildRegions(const vpImage<unsigned char> &I)
+{
+  const int width = static_cast<int>(I.getWidth());
+  const int height = static_cast<int>(I.getHeight());
+  const size_t nbDots = m_dots.size();
+  m_roiUMin.resize(nbDots);
+  m_roiUMax.resize(nbDots);
+  m_roiVMin.resize(nbDots);
+  m_roiVMax.resize(nbDots);
+
+  int row_min = height, row_max = -1;
+  for (size_t i = 0; i < nbDots; i++) {
+    const vpDot2 &dot = m_dots[i];
+    double half_w = 40., half_h = 40.;
+    if (std::fabs(dot.getWidth()) > std::numeric_limits<double>::epsilon() &&
+        std::fabs(dot.getHeight()) > std::numeric_limits<double>::epsilon()) {
+      half_w = m_searchWindowScale * dot.getWidth() / 2.;
+      half_h = m_searchWindowScale * dot.getHeight() / 2.;
+    }
+    const vpImagePoint cog = dot.getCog();
+    m_roiUMin[i] = vpMath::maximum(0, static_cast<int>(std::floor(cog.get_u() - half_w)));
+    m_roiUMax[i] = vpMath::minimum(width - 1, static_cast<int>(std::ceil(cog.get_u() + half_w)));
+    m_roiVMin[i] = vpMath::maximum(0, static_cast<int>(std::floor(cog.get_v() - half_h)));
+    m_roiVMax[i] = vpMath::minimum(height - 1, static_cast<int>(std::ceil(cog.get_v() + half_h)));
+    if (m_roiUMin[i] <= m_roiUMax[i] && m_roiVMin[i] <= m_roiVMax[i]) {
+      row_min = vpMath::minimum(row_min, m_roiVMin[i]);
+      row_max = vpMath::maximum(row_max, m_roiVMax[i]);
+    }
+  }
+
+  m_rowIntervals.clear();
+  m_intervals.clear();
+  m_firstRow = row_min;
+  if (row_max < row_min) {
+    return;
+  }
+  std::vector<std::pair<int, int> > row_intervals;
+  m_rowIntervals.reserve(static_cast<size_t>(row_max - row_min + 2));
+  for (int v = row_min; v <= row_max; v++) {
+    m_rowIntervals.push_back(static_cast<unsigned int>(m_intervals.size()));
+    row_intervals.clear();
+    for (size_t i = 0; i < nbDots; i++) {
+      if (m_roiVMin[i] <= v && v <= m_roiVMax[i] && m_roiUMin[i] <= m_roiUMax[i]) {
+        row_intervals.push_back(std::make_pair(m_roiUMin[i], m_roiUMax[i]));
+      }
+    }
+    std::sort(row_intervals.begin(), row_intervals.end());
+    for (size_t k = 0; k < row_intervals.size(); k++) {
+      if (m_intervals.size() > m_rowIntervals.back() && row_intervals[k].first <= m_intervals.back().second + 1) {
+        m_intervals.back().second = vpMath::maximum(m_intervals.back().second, row_intervals[k].second);
+      } else {
+        m_intervals.push_back(row_intervals[k]);
+      }
+    }
+  }
+  m_rowIntervals.push_back(static_cast<unsigned int>(m_intervals.size()));
+}
+
+/*!
+  Store the border points of a component in the list of border points of a
+  dot. A point of the component is on the border when one of its 4
+  neighbours does not have the right gray level. The points are stored in
+  raster order.
+
+  \param I : Image.
+  \param index : Index of the dot.
+  \param c : Index of the component.
+*/
+void vpDotTracker::storeContour(const vpImage<unsigned char> &I, unsigned int index, unsigned int c)
+{
+  const vpDotRunLabelling &labelling = *m_labelling;
+  vpDot2 &dot = m_dots[index];
+  const int height = static_cast<int>(I.getHeight());
+  const unsigned char level_min = static_cast<unsigned char>(vpMath::minimum(m_grayLevelMin, 255u));
+  const unsigned char level_max = static_cast<unsigned char>(vpMath::minimum(m_grayLevelMax, 255u));
+
+  dot.ip_edges_list.clear();
+  for (int v = labelling.v_min[c]; v <= labelling.v_max[c]; v++) {
+    const unsigned char *prev_row = v > 0 ? I[static_cast<unsigned int>(v - 1)] : NULL;
+    const unsigned char *next_row = v + 1 < height ? I[static_cast<unsigned int>(v + 1)] : NULL;
+    const size_t r = static_cast<size_t>(v - labelling.row_min);
+    for (unsigned int k = labelling.rowBegin[r]; k < labelling.rowBegin[r + 1]; k++) {
+      if (labelling.component[k] != c) {
+        continue;
+      }
+      const vpDotRunLabelling::vpRun &run = labelling.runs[k];
+      for (int u = run.u_min; u <= run.u_max; u++) {
+        bool border = (u == run.u_min || u == run.u_max);
+        border = border || prev_row == NULL || prev_row[u] < level_min || prev_row[u] > level_max;
+        border = border || next_row == NULL || next_row[u] < level_min || next_row[u] > level_max;
+        if (border) {
+          dot.ip_edges_list.push_back(vpImagePoint(v, u));
+        }
+      }
+    }
+  }
+}
+
+/*!
+  Update a dot from the component that contains its previous center of
+  gravity, or with vpDot2::track() when this component is not valid.
+
+  \param I : Image.
+  \param index : Index of the dot.
+*/
+void vpDotTracker::trackDot(const vpImage<unsigned char> &I, unsigned int index)
+{
+  vpDot2 &dot = m_dots[index];
+  const vpDotRunLabelling &labelling = *m_labelling;
+  const int width = static_cast<int>(I.getWidth());
+  const int height = static_cast<int>(I.getHeight());
+
+  int c = -1;
+  if (m_roiUMin[index] <= m_roiUMax[index] && m_roiVMin[index] <= m_roiVMax[index]) {
+    c = labelling.findComponent(static_cast<int>(dot.getCog().get_u()), static_cast<int>(dot.getCog().get_v()));
+  }
+
+  // The component is complete when it does not touch the border of the
+  // region of interest, unless this border is the one of the image
+  if (c >= 0 && labelling.m00[static_cast<size_t>(c)] >= 2. &&
+      (labelling.u_min[static_cast<size_t>(c)] > m_roiUMin[index] || m_roiUMin[index] == 0) &&
+      (labelling.u_max[static_cast<size_t>(c)] < m_roiUMax[index] || m_roiUMax[index] == width - 1) &&
+      (labelling.v_min[static_cast<size_t>(c)] > m_roiVMin[index] || m_roiVMin[index] == 0) &&
+      (labelling.v_max[static_cast<size_t>(c)] < m_roiVMax[index] || m_roiVMax[index] == height - 1)) {
+    // Move the border points aside to copy the dot cheaply
+    std::list<vpImagePoint> edges;
+    std::list<unsigned int> chain;
+    edges.swap(dot.ip_edges_list);
+    chain.swap(dot.direction_list);
+
+    vpDot2 candidate(dot);
+    candidate.setArea(I);
+    candidate.setComponent(labelling, static_cast<unsigned int>(c));
+    if (candidate.isValid(I, dot)) {
+      dot = candidate;
+      if (m_storeContours) {
+        storeContour(I, index, static_cast<unsigned int>(c));
+      }
+      if (dot.graphics) {
+        vpDisplay::displayCross(I, dot.cog, 3 * dot.thickness + 8, vpColor::red, dot.thickness);
+      }
+      m_status[index] = TRACKED;
+      return;
+    }
+    edges.swap(dot.ip_edges_list);
+    chain.swap(dot.direction_list);
+  }
+
+  vpDot2 previous(dot);
+  try {
+    dot.track(I);
+    if (!m_storeContours) {
+      dot.direction_list.clear();
+      dot.ip_edges_list.clear();
+    }
+    m_status[index] = SEARCHED;
+  } catch (const vpException &) {
+    dot = previous;
+    m_status[index] = LOST;
+  }
+}
+
+/*!
+  Update the shared gray level interval from the mean gray level of the dots
+  that are not lost, as vpDot2::track() does for a single dot.
+*/
+void vpDotTracker::updateGrayLevels()
+{
+  double sum = 0.;
+  unsigned int nb = 0;
+  for (unsigned int i = 0; i < m_dots.size(); i++) {
+    if (m_status[i] == TRACKED || m_status[i] == SEARCHED) {
+      sum += m_dots[i].getMeanGrayLevel();
+      nb++;
+    }
+  }
+  if (nb == 0) {
+    return;
+  }
+
+  const double precision = m_dots[0].getGrayLevelPrecision();
+  const double gamma = m_dots[0].getGamma();
+  double Ip = pow(sum / nb / 255, 1 / gamma);
+
+  if (Ip - (1 - precision) < 0) {
+    m_grayLevelMin = 0;
+  } else {
+    m_grayLevelMin = (unsigned int)(255 * pow(Ip - (1 - precision), gamma));
+    if (m_grayLevelMin > 255)
+      m_grayLevelMin = 255;
+  }
+  m_grayLevelMax = (unsigned int)(255 * pow(Ip + (1 - precision), gamma));
+  if (m_grayLevelMax > 255)
+    m_grayLevelMax = 255;
+
+  for (unsigned int i = 0; i < m_dots.size(); i++) {
+    m_dots[i].gray_level_min = m_grayLevelMin;
+    m_dots[i].gray_level_max = m_grayLevelMax;
+  }
+}
@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the tracking of a set of dots with vpDotTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testDotTracker.cpp
+
+  \brief Track a grid of dots on a synthetic sequence with vpDotTracker.
+  The centers of gravity must match the ground truth and the ones given by
+  vpDot2::track(), a dot that jumps must be found by vpDot2::track(), a dot
+  that disappears must be lost, and the results must be the same with the
+  dots updated sequentially or concurrently.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_BLOB)
+
+#include <visp3/blob/vpDotTracker.h>
+#include <visp3/core/vpTime.h>
+
+namespace
+{
+const unsigned int nbFrames = 10;
+const unsigned int nbCols = 6;
+const unsigned int nbRows = 5;
+// Dot that jumps at frame jumpFrame, dot that disappears at frame hiddenFrame
+const unsigned int jumpDot = 7;
+const unsigned int jumpFrame = 4;
+const unsigned int hiddenDot = 20;
+const unsigned int hiddenFrame = 7;
+
+// Draw a filled disc and return the center of gravity of its pixels
+vpImagePoint drawDisc(vpImage<unsigned char> &I, double uc, double vc, double radius, unsigned char level)
+{
+  double sum_u = 0, sum_v = 0, n = 0;
+  for (int v = (int)(vc - radius) - 1; v <= (int)(vc + radius) + 1; v++) {
+    for (int u = (int)(uc - radius) - 1; u <= (int)(uc + radius) + 1; u++) {
+      if ((u - uc) * (u - uc) + (v - vc) * (v - vc) <= radius * radius) {
+        I[(unsigned int)v][(unsigned int)u] = level;
+        sum_u += u;
+        sum_v += v;
+        n++;
+      }
+    }
+  }
+  return vpImagePoint(sum_v / n, sum_u / n);
+}
+
+// Render a frame of the sequence and return the center of gravity of each dot
+std::vector<vpImagePoint> render(vpImage<unsigned char> &I, unsigned int frame)
+{
+  I.resize(480, 640, 30);
+  std::vector<vpImagePoint> truth;
+  for (unsigned int j = 0; j < nbRows; j++) {
+    for (unsigned int i = 0; i < nbCols; i++) {
+      unsigned int k = j * nbCols + i;
+      double uc = 70 + 100 * i + 1.3 * frame + 0.1 * j;
+      double vc = 60 + 90 * j - 0.7 * frame + 0.1 * i;
+      if (k == jumpDot && frame >= jumpFrame) {
+        uc += 30;
+      }
+      if (k == hiddenDot && frame >= hiddenFrame) {
+        truth.push_back(vpImagePoint());
+        continue;
+      }
+      truth.push_back(drawDisc(I, uc, vc, 8, (unsigned char)(200 - 4 * frame)));
+    }
+  }
+  return truth;
+}
+
+bool sameDots(const vpDotTracker &t1, const vpDotTracker &t2)
+{
+  for (unsigned int i = 0; i < t1.getNbDots(); i++) {
+    if (t1.getStatus(i) != t2.getStatus(i) || t1.getCog(i).get_u() != t2.getCog(i).get_u() ||
+        t1.getCog(i).get_v() != t2.getCog(i).get_v() || t1.getDot(i).getArea() != t2.getDot(i).getArea()) {
+      return false;
+    }
+  }
+  return t1.getGrayLevelMin() == t2.getGrayLevelMin() && t1.getGrayLevelMax() == t2.getGrayLevelMax();
+}
+}
+
+int main()
+{
+  vpImage<unsigned char> I;
+  std::vector<vpImagePoint> truth = render(I, 0);
+
+  vpDotTracker sequential, parallel;
+  parallel.setUseParallelTracking(true);
+  parallel.setNbParallelThreads(4);
+  parallel.setStoreContours(true);
+  std::vector<vpDot2> references(truth.size());
+  for (size_t k = 0; k < truth.size(); k++) {
+    references[k].initTracking(I, truth[k]);
+    sequential.addDot(references[k]);
+    parallel.addDot(references[k]);
+  }
+
+  bool success = true;
+  double trackerTime = 0, referenceTime = 0;
+  for (unsigned int frame = 1; frame < nbFrames; frame++) {
+    truth = render(I, frame);
+
+    double t = vpTime::measureTimeMs();
+    sequential.track(I);
+    trackerTime += vpTime::measureTimeMs() - t;
+    parallel.track(I);
+
+    t = vpTime::measureTimeMs();
+    for (size_t k = 0; k < references.size(); k++) {
+      try {
+        references[k].track(I);
+      } catch (const vpException &) {
+      }
+    }
+    referenceTime += vpTime::measureTimeMs() - t;
+
+    if (!sameDots(sequential, parallel)) {
+      std::cerr << "Frame " << frame << ": the dots updated concurrently differ" << std::endl;
+      success = false;
+    }
+
+    for (unsigned int k = 0; k < sequential.getNbDots(); k++) {
+      vpDotTracker::vpDotStatus expected = vpDotTracker::TRACKED;
+      if (k == jumpDot && frame == jumpFrame) {
+        expected = vpDotTracker::SEARCHED;
+      }
+      if (k == hiddenDot && frame >= hiddenFrame) {
+        expected = vpDotTracker::LOST;
+      }
+      if (sequential.getStatus(k) != expected) {
+        std::cerr << "Frame " << frame << ": unexpected status " << sequential.getStatus(k) << " of dot " << k
+                  << std::endl;
+        success = false;
+        continue;
+      }
+
+      const vpDot2 &dot = sequential.getDot(k);
+      if (expected == vpDotTracker::TRACKED && vpImagePoint::distance(dot.getCog(), truth[k]) > 1e-6) {
+        std::cerr << "Frame " << frame << ": dot " << k << " at " << dot.getCog() << " instead of " << truth[k]
+                  << std::endl;
+        success = false;
+      }
+      if (expected != vpDotTracker::LOST && vpImagePoint::distance(dot.getCog(), references[k].getCog()) > 0.5) {
+        std::cerr << "Frame " << frame << ": dot " << k << " at " << dot.getCog() << " while vpDot2 gives "
+                  << references[k].getCog() << std::endl;
+        success = false;
+      }
+      if (!dot.getEdges().empty()) {
+        std::cerr << "Frame " << frame << ": the border of dot " << k << " is stored" << std::endl;
+        success = false;
+      }
+      if (expected == vpDotTracker::TRACKED && parallel.getDot(k).getEdges().empty()) {
+        std::cerr << "Frame " << frame << ": the border of dot " << k << " is not stored" << std::endl;
+        success = false;
+      }
+    }
+  }
+
+  std::cout << "Mean time per frame with vpDotTracker: " << trackerTime / (nbFrames - 1)
+            << " ms, with vpDot2::track(): " << referenceTime / (nbFrames - 1) << " ms" << std::endl;
+
+  if (!success) {
+    std::cerr << "testDotTracker failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testDotTracker is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable blob module (VISP_HAVE_MODULE_BLOB) to launch this test." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
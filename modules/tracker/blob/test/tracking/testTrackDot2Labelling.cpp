@@ -0,0 +1,231 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the search of dots by connected component labelling with vpDot2.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTrackDot2Labelling.cpp
+
+  \brief Search dots in a synthetic image with vpDot2::searchDotsInArea()
+  using the connected component labelling. The centers of gravity must match
+  the ground truth and the dots found by following their border, and must not
+  depend on the number of threads.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_BLOB)
+
+#include <visp3/blob/vpDot2.h>
+
+#if defined(VISP_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+namespace
+{
+const unsigned char background = 30;
+const unsigned char foreground = 200;
+
+// Draw a filled disc and return the center of gravity of its pixels
+vpImagePoint drawDisc(vpImage<unsigned char> &I, double uc, double vc, double radius)
+{
+  double sum_u = 0, sum_v = 0, n = 0;
+  for (unsigned int v = 0; v < I.getHeight(); v++) {
+    for (unsigned int u = 0; u < I.getWidth(); u++) {
+      if ((u - uc) * (u - uc) + (v - vc) * (v - vc) <= radius * radius) {
+        I[v][u] = foreground;
+        sum_u += u;
+        sum_v += v;
+        n++;
+      }
+    }
+  }
+  return vpImagePoint(sum_v / n, sum_u / n);
+}
+
+void drawRectangle(vpImage<unsigned char> &I, unsigned int u, unsigned int v, unsigned int w, unsigned int h)
+{
+  for (unsigned int i = v; i < v + h; i++) {
+    for (unsigned int j = u; j < u + w; j++) {
+      I[i][j] = foreground;
+    }
+  }
+}
+
+void configure(vpDot2 &d)
+{
+  d.setWidth(21);
+  d.setHeight(21);
+  d.setArea(M_PI * 10 * 10);
+  d.setGrayLevelMin(150);
+  d.setGrayLevelMax(255);
+  d.setGrayLevelPrecision(0.8);
+  d.setSizePrecision(0.65);
+  d.setEllipsoidShapePrecision(0.65);
+}
+
+bool findDot(const std::list<vpDot2> &dots, const vpImagePoint &ip, double threshold)
+{
+  for (std::list<vpDot2>::const_iterator it = dots.begin(); it != dots.end(); ++it) {
+    if (vpImagePoint::distance(it->getCog(), ip) < threshold) {
+      return true;
+    }
+  }
+  return false;
+}
+}
+
+int main()
+{
+  // 6 x 5 dots with sub-pixel centers, a large rectangle, an elongated
+  // blob and isolated pixels that must be rejected
+  vpImage<unsigned char> I(560, 640, background);
+  std::vector<vpImagePoint> truth;
+  for (unsigned int j = 0; j < 5; j++) {
+    for (unsigned int i = 0; i < 6; i++) {
+      truth.push_back(drawDisc(I, 60 + 100 * i + 0.3 * i, 50 + 90 * j + 0.2 * j, 10));
+    }
+  }
+  drawRectangle(I, 40, 480, 60, 40);
+  drawRectangle(I, 200, 495, 60, 6);
+  for (unsigned int k = 0; k < 20; k++) {
+    I[470 + 3 * (k % 5)][320 + 17 * k] = foreground;
+  }
+
+  bool success = true;
+
+  vpDot2 labelling;
+  configure(labelling);
+  labelling.setSearchMode(vpDot2::SEARCH_LABELLING);
+  std::list<vpDot2> labellingDots;
+  labelling.searchDotsInArea(I, labellingDots);
+
+  vpDot2 border;
+  configure(border);
+  std::list<vpDot2> borderDots;
+  border.searchDotsInArea(I, borderDots);
+
+  std::cout << "Found " << labellingDots.size() << " dots by labelling and " << borderDots.size()
+            << " dots by following their border" << std::endl;
+
+  if (labellingDots.size() != truth.size() || borderDots.size() != truth.size()) {
+    std::cerr << "Expected " << truth.size() << " dots" << std::endl;
+    success = false;
+  }
+
+  for (size_t k = 0; k < truth.size(); k++) {
+    if (!findDot(labellingDots, truth[k], 1e-6)) {
+      std::cerr << "Dot " << truth[k] << " not found by labelling" << std::endl;
+      success = false;
+    }
+    if (!findDot(borderDots, truth[k], 0.5)) {
+      std::cerr << "Dot " << truth[k] << " not found by following the border" << std::endl;
+      success = false;
+    }
+  }
+
+  // The dots are sorted by distance to the center of the area
+  double prevDist = 0;
+  vpImagePoint center(I.getHeight() / 2.0 - 0.5, I.getWidth() / 2.0 - 0.5);
+  for (std::list<vpDot2>::const_iterator it = labellingDots.begin(); it != labellingDots.end(); ++it) {
+    double dist = vpImagePoint::distance(it->getCog(), center);
+    if (dist < prevDist) {
+      std::cerr << "Dots are not sorted by distance to the area center" << std::endl;
+      success = false;
+    }
+    prevDist = dist;
+  }
+
+#if defined(VISP_HAVE_OPENMP)
+  // The labels are merged along the bands processed by each thread; the
+  // result must be the same with a single band
+  int nbThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  std::list<vpDot2> singleBandDots;
+  labelling.searchDotsInArea(I, singleBandDots);
+  omp_set_num_threads(4);
+  std::list<vpDot2> fourBandsDots;
+  labelling.searchDotsInArea(I, fourBandsDots);
+  omp_set_num_threads(nbThreads);
+
+  if (singleBandDots.size() != fourBandsDots.size()) {
+    std::cerr << "The number of dots depends on the number of threads" << std::endl;
+    success = false;
+  } else {
+    std::list<vpDot2>::const_iterator it1 = singleBandDots.begin(), it2 = fourBandsDots.begin();
+    for (; it1 != singleBandDots.end(); ++it1, ++it2) {
+      if (it1->getCog().get_u() != it2->getCog().get_u() || it1->getCog().get_v() != it2->getCog().get_v() ||
+          it1->getArea() != it2->getArea()) {
+        std::cerr << "The dots depend on the number of threads" << std::endl;
+        success = false;
+      }
+    }
+  }
+#endif
+
+  // A dot found by labelling can be tracked, its border being computed
+  if (!labellingDots.empty()) {
+    vpDot2 d = labellingDots.front();
+    vpImagePoint cog = d.getCog();
+    try {
+      d.track(I);
+      if (vpImagePoint::distance(d.getCog(), cog) > 0.5 || d.getEdges().empty()) {
+        std::cerr << "Tracking of the dot " << cog << " failed: " << d.getCog() << std::endl;
+        success = false;
+      }
+    } catch (const vpException &e) {
+      std::cerr << "Tracking of the dot " << cog << " failed: " << e.what() << std::endl;
+      success = false;
+    }
+  }
+
+  if (!success) {
+    std::cerr << "testTrackDot2Labelling failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testTrackDot2Labelling is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable blob module (VISP_HAVE_MODULE_BLOB) to launch this test." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
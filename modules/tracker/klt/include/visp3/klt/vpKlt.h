@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Native KLT (Kanade-Lucas-Tomasi) feature tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpKlt.h
+
+  \brief Native KLT (Kanade-Lucas-Tomasi) feature tracker, without
+  third-party dependency.
+*/
+
+#ifndef vpKlt_h
+#define vpKlt_h
+
+#include <vector>
+
+#include <visp3/core/vpColor.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImagePoint.h>
+
+/*!
+  \class vpKlt
+
+  \ingroup module_klt
+
+  \brief KLT (Kanade-Lucas-Tomasi) feature tracker implemented in ViSP, with
+  the interface of vpKltOpencv but without the OpenCV dependency.
+
+  The features are detected with the Shi-Tomasi detector: the minimal
+  eigenvalue of the gradient covariance matrix is computed over a
+  getBlockSize() x getBlockSize() neighbourhood, the corners whose quality is
+  lower than getQuality() times the best quality are rejected, and the
+  remaining local maxima are kept in decreasing order of quality if they are
+  farther than getMinDistance() from the already selected ones. Their
+  location is then refined to the sub-pixel accuracy.
+
+  The features are tracked with the pyramidal Lucas-Kanade method, from the
+  coarsest level of a Gaussian pyramid of getPyramidLevels() + 1 levels to
+  the full resolution image. Since only a translation of the window is
+  estimated, the inverse compositional formulation is used: the gradient and
+  the normal matrix of the window are computed once per level on the previous
+  image, each iteration only samples the current image. The sampling uses a
+  fixed-point bilinear interpolation, vectorized with SSE2 when available,
+  and the features are tracked concurrently when OpenMP is available.
+
+  The parameters have the same meaning and the same default values as in
+  vpKltOpencv, so that both classes give similar results. A feature is lost
+  when its window leaves the image or when the minimal eigenvalue of its
+  normal matrix, normalized as in OpenCV, is lower than the threshold given
+  with setMinEigThreshold().
+
+  \code
+#include <visp3/klt/vpKlt.h>
+
+int main()
+{
+  vpImage<unsigned char> I;
+  // ... acquire I
+  vpKlt klt;
+  klt.setMaxFeatures(200);
+  klt.setWindowSize(10);
+  klt.setQuality(0.01);
+  klt.setMinDistance(15);
+  klt.setPyramidLevels(3);
+  klt.initTracking(I);
+
+  while (true) {
+    // ... acquire I
+    klt.track(I);
+    for (int i = 0; i < klt.getNbFeatures(); i++) {
+      long id;
+      float u, v;
+      klt.getFeature(i, id, u, v);
+    }
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpKlt
+{
+public:
+  vpKlt();
+  vpKlt(const vpKlt &copy);
+  virtual ~vpKlt();
+
+  void addFeature(const float &x, const float &y);
+  void addFeature(const long &id, const float &x, const float &y);
+  void addFeature(const vpImagePoint &f);
+
+  void display(const vpImage<unsigned char> &I, const vpColor &color = vpColor::red, unsigned int thickness = 1);
+  static void display(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &features,
+                      const vpColor &color = vpColor::green, unsigned int thickness = 1);
+  static void display(const vpImage<vpRGBa> &I, const std::vector<vpImagePoint> &features,
+                      const vpColor &color = vpColor::green, unsigned int thickness = 1);
+  static void display(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &features,
+                      const std::vector<long> &featuresid, const vpColor &color = vpColor::green,
+                      unsigned int thickness = 1);
+  static void display(const vpImage<vpRGBa> &I, const std::vector<vpImagePoint> &features,
+                      const std::vector<long> &featuresid, const vpColor &color = vpColor::green,
+                      unsigned int thickness = 1);
+
+  //! Get the size of the averaging block used to detect the features.
+  int getBlockSize() const { return m_blockSize; }
+  void getFeature(const int &index, long &id, float &x, float &y) const;
+  //! Get the list of current features.
+  std::vector<vpImagePoint> getFeatures() const { return m_points[1]; }
+  //! Get the unique id of each feature.
+  std::vector<long> getFeaturesId() const { return m_points_id; }
+  //! Get the free parameter of the Harris detector.
+  double getHarrisFreeParameter() const { return m_harris_k; }
+  //! Get the maximum number of features to track in the image.
+  int getMaxFeatures() const { return m_maxCount; }
+  //! Get the minimal Euclidean distance between detected corners during
+  //! initialization.
+  double getMinDistance() const { return m_minDistance; }
+  //! Get the minimal eigenvalue threshold used to reject a feature during the
+  //! tracking.
+  double getMinEigThreshold() const { return m_minEigThreshold; }
+  //! Get the number of current features
+  int getNbFeatures() const { return (int)m_points[1].size(); }
+  //! Get the number of previous features.
+  int getNbPrevFeatures() const { return (int)m_points[0].size(); }
+  //! Get the list of previous features
+  std::vector<vpImagePoint> getPrevFeatures() const { return m_points[0]; }
+  //! Get the maximal pyramid level.
+  int getPyramidLevels() const { return m_pyrMaxLevel; }
+  //! Get the parameter characterizing the minimal accepted quality of image
+  //! corners.
+  double getQuality() const { return m_qualityLevel; }
+  //! Get the window size used to track the features and to refine the corner
+  //! locations.
+  int getWindowSize() const { return m_winSize; }
+
+  void initTracking(const vpImage<unsigned char> &I, const vpImage<unsigned char> *mask = NULL);
+  void initTracking(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &pts);
+  void initTracking(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &pts,
+                    const std::vector<long> &ids);
+
+  vpKlt &operator=(const vpKlt &copy);
+  void track(const vpImage<unsigned char> &I);
+  void setBlockSize(int blockSize);
+  void setHarrisFreeParameter(double harris_k);
+  void setInitialGuess(const std::vector<vpImagePoint> &guess_pts);
+  void setInitialGuess(const std::vector<vpImagePoint> &init_pts, const std::vector<vpImagePoint> &guess_pts,
+                       const std::vector<long> &fid);
+  void setMaxFeatures(int maxCount);
+  void setMinDistance(double minDistance);
+  void setMinEigThreshold(double minEigThreshold);
+  void setPyramidLevels(int pyrMaxLevel);
+  void setQuality(double qualityLevel);
+  //! Does nothing. Just here for compat with vpKltOpencv.
+  void setTrackerId(int tid) { (void)tid; }
+  void setUseHarris(int useHarrisDetector);
+  void setWindowSize(int winSize);
+  void suppressFeature(const int &index);
+
+protected:
+  void buildPyramid(const vpImage<unsigned char> &I, std::vector<vpImage<unsigned char> > &pyramid) const;
+  void detectFeatures(const vpImage<unsigned char> &I, const vpImage<unsigned char> *mask,
+                      std::vector<vpImagePoint> &corners) const;
+  void refineCorners(const vpImage<unsigned char> &I, std::vector<vpImagePoint> &corners) const;
+
+  //! Gaussian pyramid of the previous [0] and current [1] images
+  std::vector<vpImage<unsigned char> > m_pyramid[2];
+  std::vector<vpImagePoint> m_points[2]; //!< Previous [0] and current [1] keypoint location
+  std::vector<long> m_points_id;         //!< Keypoint id
+  int m_maxCount;
+  int m_maxIterations; //!< Maximal number of iterations of the tracking and of the corner refinement
+  double m_epsilon;    //!< Minimal displacement, in pixel, to keep on iterating
+  int m_winSize;
+  double m_qualityLevel;
+  double m_minDistance;
+  double m_minEigThreshold;
+  double m_harris_k;
+  int m_blockSize;
+  int m_useHarrisDetector;
+  int m_pyrMaxLevel;
+  long m_next_points_id;
+  bool m_initial_guess;
+};
+
+#endif
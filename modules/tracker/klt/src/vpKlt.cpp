@@ -0,0 +1,1326 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Native KLT (Kanade-Lucas-Tomasi) feature tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpKlt.cpp
+
+  \brief Native KLT (Kanade-Lucas-Tomasi) feature tracker, without
+  third-party dependency.
+*/
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <sstream>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpDisplay.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTrackingException.h>
+#include <visp3/klt/vpKlt.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#if defined(VISP_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+namespace
+{
+// Fixed-point bilinear interpolation: the weights are coded on W_BITS bits,
+// the interpolated intensities keep 5 fractional bits (as the derivatives
+// computed with the Scharr kernel, whose weights sum to 32)
+const int W_BITS = 14;
+const int W_ROUND = 1 << (W_BITS - 1);
+const int I_SHIFT = W_BITS - 5;
+const int I_ROUND = 1 << (I_SHIFT - 1);
+// Scale of the normal matrix, such that the eigenvalue threshold has the
+// same meaning as in cv::calcOpticalFlowPyrLK()
+const float FLT_SCALE = 1.f / (1 << 20);
+
+inline int reflect101(int i, int n)
+{
+  if (n == 1) {
+    return 0;
+  }
+  while (i < 0 || i >= n) {
+    i = i < 0 ? -i : 2 * n - 2 - i;
+  }
+  return i;
+}
+
+inline int clamp(int i, int n) { return i < 0 ? 0 : (i >= n ? n - 1 : i); }
+
+inline int descale(int x, int n) { return (x + (1 << (n - 1))) >> n; }
+
+// Shi-Tomasi corner candidate, sorted by decreasing quality then by position
+struct vpCornerCandidate {
+  float value;
+  int index;
+  bool operator<(const vpCornerCandidate &c) const
+  {
+    return value > c.value || (value == c.value && index < c.index);
+  }
+};
+
+// Fixed-point weights of the bilinear interpolation at the fractional position (a, b)
+inline void bilinearWeights(float a, float b, int &iw00, int &iw01, int &iw10, int &iw11)
+{
+  iw00 = vpMath::round((1.f - a) * (1.f - b) * (1 << W_BITS));
+  iw01 = vpMath::round(a * (1.f - b) * (1 << W_BITS));
+  iw10 = vpMath::round((1.f - a) * b * (1 << W_BITS));
+  iw11 = (1 << W_BITS) - iw00 - iw01 - iw10;
+}
+
+// Horizontal and vertical derivatives with the Scharr kernel
+void scharrDerivatives(const vpImage<unsigned char> &I, vpImage<short> &dx, vpImage<short> &dy)
+{
+  const int h = (int)I.getHeight(), w = (int)I.getWidth();
+  dx.resize(I.getHeight(), I.getWidth(), false);
+  dy.resize(I.getHeight(), I.getWidth(), false);
+
+  for (int i = 0; i < h; i++) {
+    const unsigned char *r0 = I[reflect101(i - 1, h)], *r1 = I[i], *r2 = I[reflect101(i + 1, h)];
+    short *px = dx[i], *py = dy[i];
+    for (int j = 0; j < w; j++) {
+      const int jm = j > 0 ? j - 1 : reflect101(j - 1, w), jp = j < w - 1 ? j + 1 : reflect101(j + 1, w);
+      px[j] = (short)(3 * (r0[jp] - r0[jm] + r2[jp] - r2[jm]) + 10 * (r1[jp] - r1[jm]));
+      py[j] = (short)(3 * (r2[jm] - r0[jm] + r2[jp] - r0[jp]) + 10 * (r2[j] - r0[j]));
+    }
+  }
+}
+
+// Per thread buffers of trackFeature()
+struct vpKltWindowBuffers {
+  explicit vpKltWindowBuffers(int winSize)
+    : Ibuf((size_t)(winSize * winSize)), derivBuf((size_t)(2 * winSize * winSize)),
+      stride(winSize + 8), Ipatch((size_t)((winSize + 1) * stride)), dxPatch(Ipatch.size()),
+      dyPatch(Ipatch.size()), Jpatch(Ipatch.size()), Irows((size_t)(winSize + 1)), dxRows(Irows.size()),
+      dyRows(Irows.size()), Jrows(Irows.size())
+  {
+  }
+
+  std::vector<int> Ibuf;
+  std::vector<float> derivBuf;
+  // Copies of the windows crossing the image border, with eight extra
+  // columns such that the SSE2 loads stay in the rows
+  int stride;
+  std::vector<unsigned char> Ipatch;
+  std::vector<short> dxPatch, dyPatch;
+  std::vector<unsigned char> Jpatch;
+  std::vector<const unsigned char *> Irows;
+  std::vector<const short *> dxRows, dyRows;
+  std::vector<const unsigned char *> Jrows;
+};
+
+// Rows of the (winSize + 1) x (winSize + 1) neighbourhood of I at (x0, y0)
+// read by the bilinear interpolation. When the neighbourhood crosses the
+// image border, it is copied into patch with the border pixels replicated,
+// or set to zero for the derivatives, as the padded pyramid of
+// cv::calcOpticalFlowPyrLK(). Returns the number of elements that can be
+// read from each row.
+template <typename Type>
+int windowRows(const vpImage<Type> &I, int x0, int y0, int winSize, int stride, bool replicate,
+               std::vector<Type> &patch, std::vector<const Type *> &rows)
+{
+  const int w = (int)I.getWidth(), h = (int)I.getHeight();
+  if (x0 >= 0 && y0 >= 0 && x0 + winSize < w && y0 + winSize < h) {
+    for (int y = 0; y <= winSize; y++) {
+      rows[(size_t)y] = I[y0 + y] + x0;
+    }
+    return w - x0;
+  }
+
+  for (int y = 0; y <= winSize; y++) {
+    const int yy = y0 + y;
+    const Type *src = I[clamp(yy, h)];
+    Type *dst = &patch[(size_t)(y * stride)];
+    for (int x = 0; x < stride; x++) {
+      const int xx = x0 + x;
+      dst[x] = replicate || (xx >= 0 && yy >= 0 && xx < w && yy < h) ? src[clamp(xx, w)] : 0;
+    }
+    rows[(size_t)y] = dst;
+  }
+  return stride;
+}
+
+// Products of the Sobel derivatives at the column j of the rows r0, r1, r2
+inline void sobelCovariance(const unsigned char *r0, const unsigned char *r1, const unsigned char *r2, int w, int j,
+                            float *cxx, float *cxy, float *cyy)
+{
+  const int jm = reflect101(j - 1, w), jp = reflect101(j + 1, w);
+  const float dx = (float)(r0[jp] - r0[jm] + 2 * (r1[jp] - r1[jm]) + r2[jp] - r2[jm]);
+  const float dy = (float)(r2[jm] - r0[jm] + 2 * (r2[j] - r0[j]) + r2[jp] - r0[jp]);
+  cxx[j] = dx * dx;
+  cxy[j] = dx * dy;
+  cyy[j] = dy * dy;
+}
+
+// Products of the Sobel derivatives of the row i of I
+void sobelCovarianceRow(const vpImage<unsigned char> &I, int i, bool useSSE2, float *cxx, float *cxy, float *cyy)
+{
+  const int h = (int)I.getHeight(), w = (int)I.getWidth();
+  const unsigned char *r0 = I[reflect101(i - 1, h)], *r1 = I[i], *r2 = I[reflect101(i + 1, h)];
+  int j = 0;
+#if VISP_HAVE_SSE2
+  if (useSSE2 && w > 9) {
+    sobelCovariance(r0, r1, r2, w, j++, cxx, cxy, cyy);
+    const __m128i z = _mm_setzero_si128();
+    // Eight pixels at a time, the bytes j - 1 to j + 8 are read
+    for (; j + 9 <= w; j += 8) {
+      const __m128i a0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r0 + j - 1)), z);
+      const __m128i b0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r0 + j)), z);
+      const __m128i c0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r0 + j + 1)), z);
+      const __m128i a1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r1 + j - 1)), z);
+      const __m128i c1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r1 + j + 1)), z);
+      const __m128i a2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r2 + j - 1)), z);
+      const __m128i b2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r2 + j)), z);
+      const __m128i c2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r2 + j + 1)), z);
+      const __m128i dx = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(c0, a0), _mm_sub_epi16(c2, a2)),
+                                       _mm_slli_epi16(_mm_sub_epi16(c1, a1), 1));
+      const __m128i dy = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(a2, a0), _mm_sub_epi16(c2, c0)),
+                                       _mm_slli_epi16(_mm_sub_epi16(b2, b0), 1));
+      // Sign extension of the 16 bits derivatives
+      const __m128 dx0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(dx, dx), 16));
+      const __m128 dx1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(dx, dx), 16));
+      const __m128 dy0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(dy, dy), 16));
+      const __m128 dy1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(dy, dy), 16));
+      _mm_storeu_ps(cxx + j, _mm_mul_ps(dx0, dx0));
+      _mm_storeu_ps(cxx + j + 4, _mm_mul_ps(dx1, dx1));
+      _mm_storeu_ps(cxy + j, _mm_mul_ps(dx0, dy0));
+      _mm_storeu_ps(cxy + j + 4, _mm_mul_ps(dx1, dy1));
+      _mm_storeu_ps(cyy + j, _mm_mul_ps(dy0, dy0));
+      _mm_storeu_ps(cyy + j + 4, _mm_mul_ps(dy1, dy1));
+    }
+  }
+#else
+  (void)useSSE2;
+#endif
+  for (; j < w; j++) {
+    sobelCovariance(r0, r1, r2, w, j, cxx, cxy, cyy);
+  }
+}
+
+// Sum of the rows i - block / 2 to i - block / 2 + block - 1 of a plane of
+// the covariance, with the border rows reflected
+void columnBoxSumRow(const float *plane, int h, int w, int i, int block, bool useSSE2, float *s)
+{
+  const int r = block / 2;
+  for (int j = 0; j < w; j++) {
+    s[j] = 0.f;
+  }
+  for (int k = -r; k < block - r; k++) {
+    const float *c = plane + (size_t)reflect101(i + k, h) * (size_t)w;
+    int j = 0;
+#if VISP_HAVE_SSE2
+    if (useSSE2) {
+      for (; j + 4 <= w; j += 4) {
+        _mm_storeu_ps(s + j, _mm_add_ps(_mm_loadu_ps(s + j), _mm_loadu_ps(c + j)));
+      }
+    }
+#else
+    (void)useSSE2;
+#endif
+    for (; j < w; j++) {
+      s[j] += c[j];
+    }
+  }
+}
+
+// Minimal eigenvalue of the covariance summed over the block centred on the
+// column j, from the sums along the columns
+inline float minEigenvalue(const float *sxx, const float *sxy, const float *syy, int w, int j, int block)
+{
+  const int r = block / 2;
+  float a = 0.f, b = 0.f, c = 0.f;
+  for (int k = -r; k < block - r; k++) {
+    const int jj = reflect101(j + k, w);
+    a += sxx[jj];
+    b += sxy[jj];
+    c += syy[jj];
+  }
+  a *= 0.5f;
+  c *= 0.5f;
+  return (a + c) - std::sqrt((a - c) * (a - c) + b * b);
+}
+
+// Minimal eigenvalues of a row from the sums along the columns, returns their
+// maximum
+float minEigenvalueRow(const float *sxx, const float *sxy, const float *syy, int w, int block, bool useSSE2, float *e)
+{
+  const int r = block / 2;
+  float maxEig = 0.f;
+  int j = 0;
+#if VISP_HAVE_SSE2
+  if (useSSE2) {
+    for (; j < r && j < w; j++) {
+      e[j] = minEigenvalue(sxx, sxy, syy, w, j, block);
+      maxEig = (std::max)(maxEig, e[j]);
+    }
+    // Four columns at a time whose block stays in the row
+    const __m128 half = _mm_set1_ps(0.5f);
+    __m128 qmax = _mm_setzero_ps();
+    for (; j + block - r + 3 <= w; j += 4) {
+      __m128 a = _mm_setzero_ps(), b = _mm_setzero_ps(), c = _mm_setzero_ps();
+      for (int k = -r; k < block - r; k++) {
+        a = _mm_add_ps(a, _mm_loadu_ps(sxx + j + k));
+        b = _mm_add_ps(b, _mm_loadu_ps(sxy + j + k));
+        c = _mm_add_ps(c, _mm_loadu_ps(syy + j + k));
+      }
+      a = _mm_mul_ps(a, half);
+      c = _mm_mul_ps(c, half);
+      const __m128 d = _mm_sub_ps(a, c);
+      const __m128 eig = _mm_sub_ps(_mm_add_ps(a, c),
+                                    _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(d, d), _mm_mul_ps(b, b))));
+      _mm_storeu_ps(e + j, eig);
+      qmax = _mm_max_ps(qmax, eig);
+    }
+    float maxs[4];
+    _mm_storeu_ps(maxs, qmax);
+    maxEig = (std::max)(maxEig, (std::max)((std::max)(maxs[0], maxs[1]), (std::max)(maxs[2], maxs[3])));
+  }
+#else
+  (void)useSSE2;
+#endif
+  for (; j < w; j++) {
+    e[j] = minEigenvalue(sxx, sxy, syy, w, j, block);
+    maxEig = (std::max)(maxEig, e[j]);
+  }
+  return maxEig;
+}
+
+// Track one feature from the previous pyramid to the current one. On return
+// nextPt holds the tracked location, the returned value is false if the
+// feature is lost.
+bool trackFeature(int maxLevel, const std::vector<vpImage<unsigned char> > &prevPyramid,
+                  const std::vector<vpImage<short> > &prevDx, const std::vector<vpImage<short> > &prevDy,
+                  const std::vector<vpImage<unsigned char> > &nextPyramid, const vpImagePoint &point,
+                  vpImagePoint &nextPt_, bool useInitialFlow, int winSize, int maxIterations, double epsilon,
+                  double minEigThreshold, bool useSSE2, vpKltWindowBuffers &buf)
+{
+  const float halfWin = (winSize - 1) * 0.5f;
+  const int area = winSize * winSize;
+  const float eps2 = (float)(epsilon * epsilon);
+  int *Iwin = &buf.Ibuf[0];
+  float *Ixwin = &buf.derivBuf[0], *Iywin = &buf.derivBuf[(size_t)area];
+
+  float nextX = 0.f, nextY = 0.f;
+  bool status = true;
+
+  for (int level = maxLevel; level >= 0; level--) {
+    const float scale = 1.f / (1 << level);
+    const vpImage<unsigned char> &I = prevPyramid[(size_t)level];
+    const vpImage<unsigned char> &J = nextPyramid[(size_t)level];
+    const vpImage<short> &dx = prevDx[(size_t)level];
+    const vpImage<short> &dy = prevDy[(size_t)level];
+    const int w = (int)I.getWidth(), h = (int)I.getHeight();
+
+    const float prevX = (float)point.get_u() * scale - halfWin, prevY = (float)point.get_v() * scale - halfWin;
+    if (level == maxLevel) {
+      nextX = useInitialFlow ? (float)nextPt_.get_u() * scale : (float)point.get_u() * scale;
+      nextY = useInitialFlow ? (float)nextPt_.get_v() * scale : (float)point.get_v() * scale;
+    } else {
+      nextX *= 2.f;
+      nextY *= 2.f;
+    }
+    nextX -= halfWin;
+    nextY -= halfWin;
+
+    // The window may cross the image border, the feature is lost when it
+    // leaves the image
+    const int ix0 = (int)std::floor(prevX), iy0 = (int)std::floor(prevY);
+    if (ix0 < -winSize || iy0 < -winSize || ix0 >= w || iy0 >= h) {
+      if (level == 0) {
+        status = false;
+      }
+      nextX += halfWin;
+      nextY += halfWin;
+      continue;
+    }
+
+    // Window of the previous image and its gradient, computed once per level
+    int iw00, iw01, iw10, iw11;
+    bilinearWeights(prevX - ix0, prevY - iy0, iw00, iw01, iw10, iw11);
+    windowRows(I, ix0, iy0, winSize, buf.stride, true, buf.Ipatch, buf.Irows);
+    windowRows(dx, ix0, iy0, winSize, buf.stride, false, buf.dxPatch, buf.dxRows);
+    windowRows(dy, ix0, iy0, winSize, buf.stride, false, buf.dyPatch, buf.dyRows);
+    float A11 = 0.f, A12 = 0.f, A22 = 0.f;
+    for (int y = 0; y < winSize; y++) {
+      const unsigned char *src0 = buf.Irows[(size_t)y], *src1 = buf.Irows[(size_t)y + 1];
+      const short *dx0 = buf.dxRows[(size_t)y], *dx1 = buf.dxRows[(size_t)y + 1];
+      const short *dy0 = buf.dyRows[(size_t)y], *dy1 = buf.dyRows[(size_t)y + 1];
+      for (int x = 0; x < winSize; x++) {
+        const int k = y * winSize + x;
+        Iwin[k] = descale(src0[x] * iw00 + src0[x + 1] * iw01 + src1[x] * iw10 + src1[x + 1] * iw11, I_SHIFT);
+        const int ixval = descale(dx0[x] * iw00 + dx0[x + 1] * iw01 + dx1[x] * iw10 + dx1[x + 1] * iw11, W_BITS);
+        const int iyval = descale(dy0[x] * iw00 + dy0[x + 1] * iw01 + dy1[x] * iw10 + dy1[x + 1] * iw11, W_BITS);
+        Ixwin[k] = (float)ixval;
+        Iywin[k] = (float)iyval;
+        A11 += (float)(ixval * ixval);
+        A12 += (float)(ixval * iyval);
+        A22 += (float)(iyval * iyval);
+      }
+    }
+    A11 *= FLT_SCALE;
+    A12 *= FLT_SCALE;
+    A22 *= FLT_SCALE;
+
+    const float D = A11 * A22 - A12 * A12;
+    const float minEig = (A22 + A11 - std::sqrt((A11 - A22) * (A11 - A22) + 4.f * A12 * A12)) / (2 * area);
+    if (minEig < minEigThreshold || D < FLT_EPSILON) {
+      if (level == 0) {
+        status = false;
+      }
+      nextX += halfWin;
+      nextY += halfWin;
+      continue;
+    }
+    const float invD = 1.f / D;
+
+    float prevDeltaX = 0.f, prevDeltaY = 0.f;
+    for (int iter = 0; iter < maxIterations; iter++) {
+      const int jx0 = (int)std::floor(nextX), jy0 = (int)std::floor(nextY);
+      if (jx0 < -winSize || jy0 < -winSize || jx0 >= w || jy0 >= h) {
+        if (level == 0) {
+          status = false;
+        }
+        break;
+      }
+      const int avail = windowRows(J, jx0, jy0, winSize, buf.stride, true, buf.Jpatch, buf.Jrows);
+
+      bilinearWeights(nextX - jx0, nextY - jy0, iw00, iw01, iw10, iw11);
+      float b1 = 0.f, b2 = 0.f;
+      for (int y = 0; y < winSize; y++) {
+        const unsigned char *src0 = buf.Jrows[(size_t)y], *src1 = buf.Jrows[(size_t)y + 1];
+        const int *Irow = Iwin + y * winSize;
+        const float *Ixrow = Ixwin + y * winSize, *Iyrow = Iywin + y * winSize;
+        int x = 0;
+#if VISP_HAVE_SSE2
+        if (useSSE2) {
+          // Pairs of weights (iw00, iw01) and (iw10, iw11) for _mm_madd_epi16
+          const __m128i qw0 = _mm_set1_epi32((iw00 & 0xffff) | (iw01 << 16));
+          const __m128i qw1 = _mm_set1_epi32((iw10 & 0xffff) | (iw11 << 16));
+          const __m128i qdelta = _mm_set1_epi32(I_ROUND);
+          const __m128i z = _mm_setzero_si128();
+          __m128 qb1 = _mm_setzero_ps(), qb2 = _mm_setzero_ps();
+          // Eight bytes are read from x + 1, stay in the row
+          for (; x + 4 <= winSize && x + 9 <= avail; x += 4) {
+            const __m128i v00 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src0 + x)), z);
+            const __m128i v01 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src0 + x + 1)), z);
+            const __m128i v10 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src1 + x)), z);
+            const __m128i v11 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src1 + x + 1)), z);
+            __m128i t = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(v00, v01), qw0),
+                                      _mm_madd_epi16(_mm_unpacklo_epi16(v10, v11), qw1));
+            t = _mm_srai_epi32(_mm_add_epi32(t, qdelta), I_SHIFT);
+            const __m128 diff =
+                _mm_cvtepi32_ps(_mm_sub_epi32(t, _mm_loadu_si128((const __m128i *)(Irow + x))));
+            qb1 = _mm_add_ps(qb1, _mm_mul_ps(diff, _mm_loadu_ps(Ixrow + x)));
+            qb2 = _mm_add_ps(qb2, _mm_mul_ps(diff, _mm_loadu_ps(Iyrow + x)));
+          }
+          float sums[4];
+          _mm_storeu_ps(sums, qb1);
+          b1 += sums[0] + sums[1] + sums[2] + sums[3];
+          _mm_storeu_ps(sums, qb2);
+          b2 += sums[0] + sums[1] + sums[2] + sums[3];
+        }
+#else
+        (void)useSSE2;
+#endif
+        for (; x < winSize; x++) {
+          const int diff = descale(src0[x] * iw00 + src0[x + 1] * iw01 + src1[x] * iw10 + src1[x + 1] * iw11, I_SHIFT) -
+                           Irow[x];
+          b1 += diff * Ixrow[x];
+          b2 += diff * Iyrow[x];
+        }
+      }
+      b1 *= FLT_SCALE;
+      b2 *= FLT_SCALE;
+
+      const float deltaX = (A12 * b2 - A22 * b1) * invD;
+      const float deltaY = (A12 * b1 - A11 * b2) * invD;
+      nextX += deltaX;
+      nextY += deltaY;
+
+      if (deltaX * deltaX + deltaY * deltaY <= eps2) {
+        break;
+      }
+      // Oscillation around the solution
+      if (iter > 0 && std::fabs(deltaX + prevDeltaX) < 0.01f && std::fabs(deltaY + prevDeltaY) < 0.01f) {
+        nextX -= deltaX * 0.5f;
+        nextY -= deltaY * 0.5f;
+        break;
+      }
+      prevDeltaX = deltaX;
+      prevDeltaY = deltaY;
+    }
+
+    nextX += halfWin;
+    nextY += halfWin;
+  }
+
+  // A feature that left the image is lost, even if its window still overlaps it
+  const vpImage<unsigned char> &J = nextPyramid[0];
+  if (nextX < 0.f || nextY < 0.f || nextX > J.getWidth() - 1.f || nextY > J.getHeight() - 1.f) {
+    status = false;
+  }
+
+  nextPt_.set_uv(nextX, nextY);
+  return status;
+}
+}
+
+/*!
+  Default constructor.
+ */
+vpKlt::vpKlt()
+  : m_points_id(), m_maxCount(500), m_maxIterations(20), m_epsilon(0.03), m_winSize(10), m_qualityLevel(0.01),
+    m_minDistance(15), m_minEigThreshold(1e-4), m_harris_k(0.04), m_blockSize(3), m_useHarrisDetector(1),
+    m_pyrMaxLevel(3), m_next_points_id(0), m_initial_guess(false)
+{
+}
+
+/*!
+  Copy constructor.
+ */
+vpKlt::vpKlt(const vpKlt &copy)
+  : m_points_id(), m_maxCount(500), m_maxIterations(20), m_epsilon(0.03), m_winSize(10), m_qualityLevel(0.01),
+    m_minDistance(15), m_minEigThreshold(1e-4), m_harris_k(0.04), m_blockSize(3), m_useHarrisDetector(1),
+    m_pyrMaxLevel(3), m_next_points_id(0), m_initial_guess(false)
+{
+  *this = copy;
+}
+
+/*!
+  Copy operator.
+ */
+vpKlt &vpKlt::operator=(const vpKlt &copy)
+{
+  for (size_t i = 0; i < 2; i++) {
+    m_pyramid[i] = copy.m_pyramid[i];
+    m_points[i] = copy.m_points[i];
+  }
+  m_points_id = copy.m_points_id;
+  m_maxCount = copy.m_maxCount;
+  m_maxIterations = copy.m_maxIterations;
+  m_epsilon = copy.m_epsilon;
+  m_winSize = copy.m_winSize;
+  m_qualityLevel = copy.m_qualityLevel;
+  m_minDistance = copy.m_minDistance;
+  m_minEigThreshold = copy.m_minEigThreshold;
+  m_harris_k = copy.m_harris_k;
+  m_blockSize = copy.m_blockSize;
+  m_useHarrisDetector = copy.m_useHarrisDetector;
+  m_pyrMaxLevel = copy.m_pyrMaxLevel;
+  m_next_points_id = copy.m_next_points_id;
+  m_initial_guess = copy.m_initial_guess;
+
+  return *this;
+}
+
+vpKlt::~vpKlt() {}
+
+/*!
+  Build the Gaussian pyramid of an image, with the 5x5 kernel of
+  cv::pyrDown(). The pyramid has getPyramidLevels() + 1 levels at most, the
+  coarser levels that would be smaller than the tracking window are not
+  built.
+
+  \param I : Full resolution image.
+  \param pyramid : Images of the pyramid, pyramid[0] is a copy of \e I.
+*/
+void vpKlt::buildPyramid(const vpImage<unsigned char> &I, std::vector<vpImage<unsigned char> > &pyramid) const
+{
+  pyramid.resize(1);
+  pyramid[0] = I;
+
+  std::vector<int> rows;
+  for (int level = 1; level <= m_pyrMaxLevel; level++) {
+    const vpImage<unsigned char> &src = pyramid[(size_t)level - 1];
+    const int sh = (int)src.getHeight(), sw = (int)src.getWidth();
+    const int dh = (sh + 1) / 2, dw = (sw + 1) / 2;
+    if (dh <= m_winSize || dw <= m_winSize) {
+      break;
+    }
+
+    // Horizontal filtering and decimation of all the source rows, then
+    // vertical filtering and decimation
+    rows.resize((size_t)sh * (size_t)dw);
+    for (int i = 0; i < sh; i++) {
+      const unsigned char *s = src[i];
+      int *r = &rows[(size_t)i * (size_t)dw];
+      for (int j = 0; j < dw; j++) {
+        const int c = 2 * j;
+        if (c >= 2 && c + 2 < sw) {
+          r[j] = s[c - 2] + 4 * (s[c - 1] + s[c + 1]) + 6 * s[c] + s[c + 2];
+        } else {
+          r[j] = s[reflect101(c - 2, sw)] + 4 * (s[reflect101(c - 1, sw)] + s[reflect101(c + 1, sw)]) + 6 * s[c] +
+                 s[reflect101(c + 2, sw)];
+        }
+      }
+    }
+
+    pyramid.push_back(vpImage<unsigned char>((unsigned int)dh, (unsigned int)dw));
+    vpImage<unsigned char> &dst = pyramid.back();
+    for (int i = 0; i < dh; i++) {
+      const int c = 2 * i;
+      const int *r0 = &rows[(size_t)reflect101(c - 2, sh) * (size_t)dw];
+      const int *r1 = &rows[(size_t)reflect101(c - 1, sh) * (size_t)dw];
+      const int *r2 = &rows[(size_t)c * (size_t)dw];
+      const int *r3 = &rows[(size_t)reflect101(c + 1, sh) * (size_t)dw];
+      const int *r4 = &rows[(size_t)reflect101(c + 2, sh) * (size_t)dw];
+      unsigned char *d = dst[i];
+      for (int j = 0; j < dw; j++) {
+        d[j] = (unsigned char)((r0[j] + 4 * (r1[j] + r3[j]) + 6 * r2[j] + r4[j] + 128) >> 8);
+      }
+    }
+  }
+}
+
+/*!
+  Detect the Shi-Tomasi corners of an image, as cv::goodFeaturesToTrack().
+
+  \param I : Input image.
+  \param mask : If not NULL, the corners are only detected where the mask is
+  not null.
+  \param corners : Detected corners, in decreasing order of quality.
+*/
+void vpKlt::detectFeatures(const vpImage<unsigned char> &I, const vpImage<unsigned char> *mask,
+                           std::vector<vpImagePoint> &corners) const
+{
+  corners.clear();
+  const int h = (int)I.getHeight(), w = (int)I.getWidth();
+  if (h < 3 || w < 3) {
+    return;
+  }
+  if (mask != NULL && (mask->getHeight() != I.getHeight() || mask->getWidth() != I.getWidth())) {
+    throw vpTrackingException(vpTrackingException::initializationError, "The mask and the image sizes differ");
+  }
+
+  // Covariance matrix of the Sobel derivatives, summed over the block with a
+  // running sum along the columns then along the rows. The three planes of
+  // the covariance are stored one after the other.
+  const int block = (std::max)(m_blockSize, 1);
+  const size_t size = (size_t)h * (size_t)w;
+  std::vector<float> cov(3 * size), sum(3 * size);
+  vpImage<float> eig((unsigned int)h, (unsigned int)w);
+  std::vector<float> rowMaxEig((size_t)h);
+  bool useSSE2 = false;
+#if VISP_HAVE_SSE2
+  useSSE2 = vpCPUFeatures::checkSSE2();
+#endif
+
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel if (size > 160 * 120)
+#endif
+  {
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < h; i++) {
+      const size_t offset = (size_t)i * (size_t)w;
+      sobelCovarianceRow(I, i, useSSE2, &cov[offset], &cov[size + offset], &cov[2 * size + offset]);
+    }
+
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < h; i++) {
+      const size_t offset = (size_t)i * (size_t)w;
+      for (size_t p = 0; p < 3; p++) {
+        columnBoxSumRow(&cov[p * size], h, w, i, block, useSSE2, &sum[p * size + offset]);
+      }
+    }
+
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < h; i++) {
+      const size_t offset = (size_t)i * (size_t)w;
+      rowMaxEig[(size_t)i] =
+          minEigenvalueRow(&sum[offset], &sum[size + offset], &sum[2 * size + offset], w, block, useSSE2, eig[i]);
+    }
+  }
+
+  float maxEig = 0.f;
+  for (int i = 0; i < h; i++) {
+    maxEig = (std::max)(maxEig, rowMaxEig[(size_t)i]);
+  }
+  if (maxEig <= 0.f) {
+    return;
+  }
+
+  // Local maxima above the quality threshold
+  const float threshold = (float)(maxEig * m_qualityLevel);
+  std::vector<vpCornerCandidate> candidates;
+  for (int i = 1; i < h - 1; i++) {
+    for (int j = 1; j < w - 1; j++) {
+      const float e = eig[i][j];
+      if (e <= threshold || (mask != NULL && (*mask)[i][j] == 0)) {
+        continue;
+      }
+      bool isMax = true;
+      for (int k = -1; k <= 1 && isMax; k++) {
+        for (int l = -1; l <= 1; l++) {
+          if (eig[i + k][j + l] > e) {
+            isMax = false;
+            break;
+          }
+        }
+      }
+      if (isMax) {
+        vpCornerCandidate c = {e, i * w + j};
+        candidates.push_back(c);
+      }
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  // Greedy selection of the corners farther than the minimal distance, with a
+  // grid of cells of the size of the minimal distance
+  const int cell = (std::max)(vpMath::round(m_minDistance), 1);
+  const int gw = (w + cell - 1) / cell, gh = (h + cell - 1) / cell;
+  std::vector<std::vector<vpImagePoint> > grid((size_t)gw * (size_t)gh);
+  const double minDist2 = m_minDistance * m_minDistance;
+  for (size_t n = 0; n < candidates.size(); n++) {
+    if (m_maxCount > 0 && (int)corners.size() >= m_maxCount) {
+      break;
+    }
+    const int y = candidates[n].index / w, x = candidates[n].index % w;
+    const vpImagePoint ip(y, x);
+    bool good = true;
+    if (m_minDistance >= 1) {
+      const int cx = x / cell, cy = y / cell;
+      for (int gy = (std::max)(cy - 1, 0); gy <= (std::min)(cy + 1, gh - 1) && good; gy++) {
+        for (int gx = (std::max)(cx - 1, 0); gx <= (std::min)(cx + 1, gw - 1) && good; gx++) {
+          const std::vector<vpImagePoint> &pts = grid[(size_t)gy * (size_t)gw + (size_t)gx];
+          for (size_t k = 0; k < pts.size(); k++) {
+            if (vpImagePoint::sqrDistance(pts[k], ip) < minDist2) {
+              good = false;
+              break;
+            }
+          }
+        }
+      }
+      if (good) {
+        grid[(size_t)cy * (size_t)gw + (size_t)cx].push_back(ip);
+      }
+    }
+    if (good) {
+      corners.push_back(ip);
+    }
+  }
+}
+
+/*!
+  Refine the location of the corners to the sub-pixel accuracy, as
+  cv::cornerSubPix() with a half window of getWindowSize() pixels.
+
+  \param I : Input image.
+  \param corners : Corners to refine.
+*/
+void vpKlt::refineCorners(const vpImage<unsigned char> &I, std::vector<vpImagePoint> &corners) const
+{
+  const int half = (std::max)(m_winSize, 1), win = 2 * half + 1, patch = win + 2;
+  const int h = (int)I.getHeight(), w = (int)I.getWidth();
+
+  std::vector<float> weights((size_t)win * (size_t)win);
+  std::vector<float> maskX((size_t)win);
+  for (int i = 0; i < win; i++) {
+    const float x = (float)(i - half) / half;
+    maskX[(size_t)i] = std::exp(-x * x);
+  }
+  for (int i = 0; i < win; i++) {
+    for (int j = 0; j < win; j++) {
+      weights[(size_t)(i * win + j)] = maskX[(size_t)i] * maskX[(size_t)j];
+    }
+  }
+
+  std::vector<float> subpix((size_t)patch * (size_t)patch);
+  const double eps2 = m_epsilon * m_epsilon;
+  for (size_t n = 0; n < corners.size(); n++) {
+    const double u0 = corners[n].get_u(), v0 = corners[n].get_v();
+    double u = u0, v = v0, err = 0;
+    int iter = 0;
+    do {
+      // Bilinear sampling of the patch around the current estimate, with
+      // the border pixels replicated
+      const double pu = u - (patch - 1) * 0.5, pv = v - (patch - 1) * 0.5;
+      const int iu = (int)std::floor(pu), iv = (int)std::floor(pv);
+      const float a = (float)(pu - iu), b = (float)(pv - iv);
+      for (int i = 0; i < patch; i++) {
+        const int y0 = clamp(iv + i, h), y1 = clamp(iv + i + 1, h);
+        for (int j = 0; j < patch; j++) {
+          const int x0 = clamp(iu + j, w), x1 = clamp(iu + j + 1, w);
+          subpix[(size_t)(i * patch + j)] = (1.f - a) * (1.f - b) * I[y0][x0] + a * (1.f - b) * I[y0][x1] +
+                                            (1.f - a) * b * I[y1][x0] + a * b * I[y1][x1];
+        }
+      }
+
+      double A = 0, B = 0, C = 0, bb1 = 0, bb2 = 0;
+      for (int i = 0; i < win; i++) {
+        const double py = i - half;
+        for (int j = 0; j < win; j++) {
+          const double px = j - half;
+          const double m = weights[(size_t)(i * win + j)];
+          const double tgx = subpix[(size_t)((i + 1) * patch + j + 2)] - subpix[(size_t)((i + 1) * patch + j)];
+          const double tgy = subpix[(size_t)((i + 2) * patch + j + 1)] - subpix[(size_t)(i * patch + j + 1)];
+          const double gxx = tgx * tgx * m, gxy = tgx * tgy * m, gyy = tgy * tgy * m;
+          A += gxx;
+          B += gxy;
+          C += gyy;
+          bb1 += gxx * px + gxy * py;
+          bb2 += gxy * px + gyy * py;
+        }
+      }
+
+      const double det = A * C - B * B;
+      if (std::fabs(det) <= DBL_EPSILON * DBL_EPSILON) {
+        break;
+      }
+      const double u2 = u + (C * bb1 - B * bb2) / det;
+      const double v2 = v + (A * bb2 - B * bb1) / det;
+      err = (u2 - u) * (u2 - u) + (v2 - v) * (v2 - v);
+      u = u2;
+      v = v2;
+      if (u < 0 || u >= w || v < 0 || v >= h) {
+        break;
+      }
+    } while (++iter < m_maxIterations && err > eps2);
+
+    // Keep the initial location if the refinement went out of the window
+    if (std::fabs(u - u0) <= half && std::fabs(v - v0) <= half) {
+      corners[n].set_uv(u, v);
+    }
+  }
+}
+
+/*!
+  Initialise the tracking by extracting KLT keypoints on the provided image.
+
+  \param I : Grey level image used as input.
+  \param mask : Image mask used to restrict the keypoint detection area to
+  its non null pixels. If mask is NULL, all the image will be considered.
+
+  \exception vpTrackingException::initializationError : If the mask and the
+  image sizes differ.
+*/
+void vpKlt::initTracking(const vpImage<unsigned char> &I, const vpImage<unsigned char> *mask)
+{
+  m_next_points_id = 0;
+  m_initial_guess = false;
+
+  buildPyramid(I, m_pyramid[1]);
+  m_pyramid[0].clear();
+
+  for (size_t i = 0; i < 2; i++) {
+    m_points[i].clear();
+  }
+  m_points_id.clear();
+
+  detectFeatures(I, mask, m_points[1]);
+
+  if (m_points[1].size() > 0) {
+    refineCorners(I, m_points[1]);
+
+    for (size_t i = 0; i < m_points[1].size(); i++)
+      m_points_id.push_back(m_next_points_id++);
+  }
+}
+
+/*!
+  Set the points that will be used as initialization during the next call to
+  track().
+
+  \param I : Input image.
+  \param pts : Vector of points that should be tracked.
+*/
+void vpKlt::initTracking(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &pts)
+{
+  m_initial_guess = false;
+  m_points[1] = pts;
+  m_next_points_id = 0;
+  m_points_id.clear();
+  for (size_t i = 0; i < m_points[1].size(); i++) {
+    m_points_id.push_back(m_next_points_id++);
+  }
+
+  buildPyramid(I, m_pyramid[1]);
+  m_pyramid[0].clear();
+}
+
+/*!
+  Set the points that will be used as initialization during the next call to
+  track().
+
+  \param I : Input image.
+  \param pts : Vector of points that should be tracked.
+  \param ids : Identifiers of the points. If the size differs from the one of
+  \e pts, new identifiers are given to the points.
+*/
+void vpKlt::initTracking(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &pts,
+                         const std::vector<long> &ids)
+{
+  m_initial_guess = false;
+  m_points[1] = pts;
+  m_points_id.clear();
+
+  if (ids.size() != pts.size()) {
+    m_next_points_id = 0;
+    for (size_t i = 0; i < m_points[1].size(); i++)
+      m_points_id.push_back(m_next_points_id++);
+  } else {
+    long max = 0;
+    for (size_t i = 0; i < m_points[1].size(); i++) {
+      m_points_id.push_back(ids[i]);
+      if (ids[i] > max)
+        max = ids[i];
+    }
+    m_next_points_id = max + 1;
+  }
+
+  buildPyramid(I, m_pyramid[1]);
+  m_pyramid[0].clear();
+}
+
+/*!
+   Track KLT keypoints using the iterative Lucas-Kanade method with pyramids.
+
+   \param I : Input image.
+
+   \exception vpTrackingException::fatalError : If there is no keypoint to
+   track.
+ */
+void vpKlt::track(const vpImage<unsigned char> &I)
+{
+  if (m_points[1].size() == 0)
+    throw vpTrackingException(vpTrackingException::fatalError, "Not enough key points to track.");
+
+  std::swap(m_pyramid[0], m_pyramid[1]);
+  const bool useInitialFlow = m_initial_guess;
+  if (m_initial_guess) {
+    m_initial_guess = false;
+  } else {
+    std::swap(m_points[1], m_points[0]);
+  }
+
+  buildPyramid(I, m_pyramid[1]);
+  if (m_pyramid[0].empty() || m_pyramid[0][0].getHeight() != I.getHeight() ||
+      m_pyramid[0][0].getWidth() != I.getWidth()) {
+    m_pyramid[0] = m_pyramid[1];
+  }
+  if (!useInitialFlow) {
+    m_points[1] = m_points[0];
+  }
+
+  // The two pyramids must have the same number of levels
+  const size_t nbLevels = (std::min)(m_pyramid[0].size(), m_pyramid[1].size());
+  std::vector<vpImage<short> > prevDx(nbLevels), prevDy(nbLevels);
+  for (size_t level = 0; level < nbLevels; level++) {
+    scharrDerivatives(m_pyramid[0][level], prevDx[level], prevDy[level]);
+  }
+
+  const int winSize = (std::max)(m_winSize, 2);
+  const int nbPoints = (int)m_points[0].size();
+  std::vector<unsigned char> status((size_t)nbPoints, 1);
+  bool useSSE2 = false;
+#if VISP_HAVE_SSE2
+  useSSE2 = vpCPUFeatures::checkSSE2();
+#endif
+
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel if (nbPoints > 16)
+#endif
+  {
+    vpKltWindowBuffers buf(winSize);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < nbPoints; i++) {
+      status[(size_t)i] =
+          trackFeature((int)nbLevels - 1, m_pyramid[0], prevDx, prevDy, m_pyramid[1], m_points[0][(size_t)i], m_points[1][(size_t)i],
+                       useInitialFlow, winSize, m_maxIterations, m_epsilon, m_minEigThreshold, useSSE2, buf)
+              ? 1
+              : 0;
+    }
+  }
+
+  // Remove points that are lost
+  for (int i = nbPoints - 1; i >= 0; i--) {
+    if (status[(size_t)i] == 0) { // point is lost
+      m_points[0].erase(m_points[0].begin() + i);
+      m_points[1].erase(m_points[1].begin() + i);
+      m_points_id.erase(m_points_id.begin() + i);
+    }
+  }
+}
+
+/*!
+
+  Get the 'index'th feature image coordinates.  Beware that
+  getFeature(i,...) may not represent the same feature before and
+  after a tracking iteration (if a feature is lost, features are
+  shifted in the array).
+
+  \param index : Index of feature.
+  \param id : id of the feature.
+  \param x : x coordinate, along the columns.
+  \param y : y coordinate, along the rows.
+
+*/
+void vpKlt::getFeature(const int &index, long &id, float &x, float &y) const
+{
+  if ((size_t)index >= m_points[1].size()) {
+    throw(vpException(vpException::badValue, "Feature [%d] doesn't exist", index));
+  }
+
+  x = (float)m_points[1][(size_t)index].get_u();
+  y = (float)m_points[1][(size_t)index].get_v();
+  id = m_points_id[(size_t)index];
+}
+
+/*!
+  Display features position and id.
+
+  \param I : Image used as background. Display should be initialized on it.
+  \param color : Color used to display the features.
+  \param thickness : Thickness of the drawings.
+  */
+void vpKlt::display(const vpImage<unsigned char> &I, const vpColor &color, unsigned int thickness)
+{
+  vpKlt::display(I, m_points[1], m_points_id, color, thickness);
+}
+
+/*!
+
+  Display features list.
+
+  \param I : The image used as background.
+
+  \param features : Vector of features.
+
+  \param color : Color used to display the points.
+
+  \param thickness : Thickness of the points.
+*/
+void vpKlt::display(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &features, const vpColor &color,
+                    unsigned int thickness)
+{
+  for (size_t i = 0; i < features.size(); i++) {
+    vpDisplay::displayCross(I, features[i], 10 + thickness, color, thickness);
+  }
+}
+
+/*!
+
+  Display features list.
+
+  \param I : The image used as background.
+
+  \param features : Vector of features.
+
+  \param color : Color used to display the points.
+
+  \param thickness : Thickness of the points.
+*/
+void vpKlt::display(const vpImage<vpRGBa> &I, const std::vector<vpImagePoint> &features, const vpColor &color,
+                    unsigned int thickness)
+{
+  for (size_t i = 0; i < features.size(); i++) {
+    vpDisplay::displayCross(I, features[i], 10 + thickness, color, thickness);
+  }
+}
+
+/*!
+
+  Display features list with ids.
+
+  \param I : The image used as background.
+
+  \param features : Vector of features.
+
+  \param featuresid : Vector of ids corresponding to the features.
+
+  \param color : Color used to display the points.
+
+  \param thickness : Thickness of the points
+*/
+void vpKlt::display(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &features,
+                    const std::vector<long> &featuresid, const vpColor &color, unsigned int thickness)
+{
+  for (size_t i = 0; i < features.size(); i++) {
+    vpDisplay::displayCross(I, features[i], 10, color, thickness);
+
+    std::ostringstream id;
+    id << featuresid[i];
+    vpDisplay::displayText(I, features[i] + vpImagePoint(0, 5), id.str(), color);
+  }
+}
+
+/*!
+
+  Display features list with ids.
+
+  \param I : The image used as background.
+
+  \param features : Vector of features.
+
+  \param featuresid : Vector of ids corresponding to the features.
+
+  \param color : Color used to display the points.
+
+  \param thickness : Thickness of the points
+*/
+void vpKlt::display(const vpImage<vpRGBa> &I, const std::vector<vpImagePoint> &features,
+                    const std::vector<long> &featuresid, const vpColor &color, unsigned int thickness)
+{
+  for (size_t i = 0; i < features.size(); i++) {
+    vpDisplay::displayCross(I, features[i], 10, color, thickness);
+
+    std::ostringstream id;
+    id << featuresid[i];
+    vpDisplay::displayText(I, features[i] + vpImagePoint(0, 5), id.str(), color);
+  }
+}
+
+/*!
+  Set the maximum number of features to track in the image.
+
+  \param maxCount : Maximum number of features to detect and track. Default
+  value is set to 500.
+*/
+void vpKlt::setMaxFeatures(int maxCount) { m_maxCount = maxCount; }
+
+/*!
+  Set the window size used to track the features and to refine the corner
+  locations.
+
+  \param winSize : Side of the tracking window, and half side of the window
+  of the corner refinement, as in vpKltOpencv. Default value is set to 10.
+*/
+void vpKlt::setWindowSize(int winSize) { m_winSize = winSize; }
+
+/*!
+  Set the parameter characterizing the minimal accepted quality of image
+  corners.
+
+  \param qualityLevel : Quality level parameter. Default value is set to 0.01.
+  The parameter value is multiplied by the best corner quality measure, which
+  is the minimal eigenvalue of the gradient covariance matrix. The corners
+  with the quality measure less than the product are rejected.
+ */
+void vpKlt::setQuality(double qualityLevel) { m_qualityLevel = qualityLevel; }
+
+/*!
+  Set the free parameter of the Harris detector.
+
+  \param harris_k : Free parameter of the Harris detector. Default value is
+  set to 0.04.
+
+  \note As in vpKltOpencv, the corners are detected with the minimal
+  eigenvalue, the parameter is only kept for compatibility.
+*/
+void vpKlt::setHarrisFreeParameter(double harris_k) { m_harris_k = harris_k; }
+
+/*!
+  Set the parameter indicating whether to use a Harris detector or
+  the minimal eigenvalue of gradient matrices for corner detection.
+
+  \param useHarrisDetector : Default value is 1.
+
+  \note As in vpKltOpencv, the corners are detected with the minimal
+  eigenvalue, the parameter is only kept for compatibility.
+*/
+void vpKlt::setUseHarris(int useHarrisDetector) { m_useHarrisDetector = useHarrisDetector; }
+
+/*!
+  Set the minimal Euclidean distance between detected corners during
+  initialization.
+
+  \param minDistance : Minimal possible Euclidean distance between the
+  detected corners. Default value is set to 15.
+*/
+void vpKlt::setMinDistance(double minDistance) { m_minDistance = minDistance; }
+
+/*!
+  Set the minimal eigen value threshold used to reject a point during the
+  tracking.
+
+  \param minEigThreshold : Minimal eigen value threshold. Default value is
+  set to 1e-4.
+*/
+void vpKlt::setMinEigThreshold(double minEigThreshold) { m_minEigThreshold = minEigThreshold; }
+
+/*!
+  Set the size of the averaging block used to detect the features.
+
+  \param blockSize : Size of an average block for computing a derivative
+  covariation matrix over each pixel neighborhood. Default value is set to 3.
+*/
+void vpKlt::setBlockSize(int blockSize) { m_blockSize = blockSize; }
+
+/*!
+  Set the maximal pyramid level. If the level is zero, then no pyramid is
+  computed for the optical flow.
+
+  \param pyrMaxLevel : 0-based maximal pyramid level number; if set to 0,
+  pyramids are not used (single level), if set to 1, two levels are used, and
+  so on. Default value is set to 3.
+*/
+void vpKlt::setPyramidLevels(int pyrMaxLevel) { m_pyrMaxLevel = pyrMaxLevel; }
+
+/*!
+  Set the points that will be used as initial guess during the next call to
+  track(). A typical usage of this function is to predict the position of the
+  features before the next call to track().
+
+  \param guess_pts : Vector of points that should be tracked. The size of this
+  vector should be the same as the one returned by getFeatures(). If this is
+  not the case, an exception is returned. Note also that the id of the points
+  is not modified.
+
+  \sa initTracking()
+*/
+void vpKlt::setInitialGuess(const std::vector<vpImagePoint> &guess_pts)
+{
+  if (guess_pts.size() != m_points[1].size()) {
+    throw(vpException(vpException::badValue,
+                      "Cannot set initial guess: size feature vector [%d] "
+                      "and guess vector [%d] doesn't match",
+                      m_points[1].size(), guess_pts.size()));
+  }
+
+  m_points[0] = m_points[1];
+  m_points[1] = guess_pts;
+  m_initial_guess = true;
+}
+
+/*!
+  Set the points that will be used as initial guess during the next call to
+  track(). A typical usage of this function is to predict the position of the
+  features before the next call to track().
+
+  \param init_pts : Initial points (could be obtained from getPrevFeatures()
+  or getFeatures()).
+  \param guess_pts : Prediction of the new position of the initial points.
+  The size of this vector must be the same as the size of the vector of
+  initial points.
+  \param fid : Identifiers of the initial points.
+
+  \sa getPrevFeatures(), getFeatures(), getFeaturesId()
+  \sa initTracking()
+*/
+void vpKlt::setInitialGuess(const std::vector<vpImagePoint> &init_pts, const std::vector<vpImagePoint> &guess_pts,
+                            const std::vector<long> &fid)
+{
+  if (guess_pts.size() != init_pts.size()) {
+    throw(vpException(vpException::badValue,
+                      "Cannot set initial guess: size init vector [%d] and "
+                      "guess vector [%d] doesn't match",
+                      init_pts.size(), guess_pts.size()));
+  }
+
+  m_points[0] = init_pts;
+  m_points[1] = guess_pts;
+  m_points_id = fid;
+  m_initial_guess = true;
+}
+
+/*!
+
+  Add a keypoint at the end of the feature list. The id of the feature is set
+  to ensure that it is unique.
+
+  \param x,y : Coordinates of the feature in the image, along the columns and
+  the rows.
+
+*/
+void vpKlt::addFeature(const float &x, const float &y)
+{
+  m_points[1].push_back(vpImagePoint(y, x));
+  m_points_id.push_back(m_next_points_id++);
+}
+
+/*!
+
+  Add a keypoint at the end of the feature list.
+
+  \warning This function doesn't ensure that the id of the feature is unique.
+  You should rather use addFeature(const float &, const float &) or
+  addFeature(const vpImagePoint &).
+
+  \param id : Feature id. Should be unique
+  \param x,y : Coordinates of the feature in the image, along the columns and
+  the rows.
+
+*/
+void vpKlt::addFeature(const long &id, const float &x, const float &y)
+{
+  m_points[1].push_back(vpImagePoint(y, x));
+  m_points_id.push_back(id);
+  if (id >= m_next_points_id)
+    m_next_points_id = id + 1;
+}
+
+/*!
+
+  Add a keypoint at the end of the feature list. The id of the feature is set
+  to ensure that it is unique.
+
+  \param f : Coordinates of the feature in the image.
+
+*/
+void vpKlt::addFeature(const vpImagePoint &f)
+{
+  m_points[1].push_back(f);
+  m_points_id.push_back(m_next_points_id++);
+}
+
+/*!
+   Remove the feature with the given index as parameter.
+
+   \param index : Index of the feature to remove.
+ */
+void vpKlt::suppressFeature(const int &index)
+{
+  if ((size_t)index >= m_points[1].size()) {
+    throw(vpException(vpException::badValue, "Feature [%d] doesn't exist", index));
+  }
+
+  m_points[1].erase(m_points[1].begin() + index);
+  m_points_id.erase(m_points_id.begin() + index);
+}
@@ -0,0 +1,204 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the native KLT tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testKlt.cpp
+
+  \brief Detect and track features with vpKlt on a synthetic sequence of a
+  textured image undergoing a known translation. The tracked locations must
+  follow the translation to a fraction of pixel, with and without the
+  pyramid and with an initial guess.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/klt/vpKlt.h>
+
+namespace
+{
+struct Blob {
+  double u, v, sigma, amplitude;
+};
+
+// Sum of Gaussian blobs, translated by (du, dv)
+void render(const std::vector<Blob> &blobs, double du, double dv, vpImage<unsigned char> &I)
+{
+  I.resize(240, 320);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double value = 128;
+      for (size_t k = 0; k < blobs.size(); k++) {
+        const double x = j - du - blobs[k].u, y = i - dv - blobs[k].v;
+        const double d2 = (x * x + y * y) / (2 * blobs[k].sigma * blobs[k].sigma);
+        if (d2 < 20) {
+          value += blobs[k].amplitude * exp(-d2);
+        }
+      }
+      I[i][j] = (unsigned char)vpMath::round((std::max)(0.0, (std::min)(255.0, value)));
+    }
+  }
+}
+
+// Track the features on the sequence and check the tracked locations
+bool trackSequence(const std::string &name, vpKlt &klt, const std::vector<Blob> &blobs, double speed_u,
+                   double speed_v, bool useInitialGuess)
+{
+  vpImage<unsigned char> I;
+  render(blobs, 0, 0, I);
+  klt.initTracking(I);
+
+  const std::vector<vpImagePoint> initial = klt.getFeatures();
+  if (initial.size() < 50) {
+    std::cerr << name << ": only " << initial.size() << " features detected" << std::endl;
+    return false;
+  }
+
+  const unsigned int nb_frames = 10;
+  const double margin = klt.getWindowSize();
+  double maxError = 0, meanError = 0;
+  for (unsigned int frame = 1; frame <= nb_frames; frame++) {
+    if (useInitialGuess) {
+      // Start from the true motion, up to one pixel
+      std::vector<vpImagePoint> guess = klt.getFeatures();
+      for (size_t i = 0; i < guess.size(); i++) {
+        guess[i].set_uv(guess[i].get_u() + speed_u + 0.7, guess[i].get_v() + speed_v - 0.6);
+      }
+      klt.setInitialGuess(guess);
+    }
+
+    render(blobs, speed_u * frame, speed_v * frame, I);
+    klt.track(I);
+
+    meanError = 0;
+    for (int i = 0; i < klt.getNbFeatures(); i++) {
+      long id;
+      float u, v;
+      klt.getFeature(i, id, u, v);
+      const vpImagePoint &ip0 = initial[(size_t)id];
+      const double u0 = ip0.get_u() + speed_u * frame, v0 = ip0.get_v() + speed_v * frame;
+      const double error = sqrt(vpMath::sqr(u - u0) + vpMath::sqr(v - v0));
+      // The texture out of the image is unknown, the maximal error is only
+      // checked on the features whose window stays in the image
+      if (u0 > margin && v0 > margin && u0 < I.getWidth() - margin && v0 < I.getHeight() - margin) {
+        maxError = (std::max)(maxError, error);
+      }
+      meanError += error;
+    }
+    meanError /= (std::max)(klt.getNbFeatures(), 1);
+  }
+
+  // Features that stay in the image, their window may cross the border
+  unsigned int nbVisible = 0;
+  for (size_t i = 0; i < initial.size(); i++) {
+    const double u = initial[i].get_u() + speed_u * nb_frames, v = initial[i].get_v() + speed_v * nb_frames;
+    if (u >= 0 && v >= 0 && u < I.getWidth() - 1 && v < I.getHeight() - 1) {
+      nbVisible++;
+    }
+  }
+
+  std::cout << name << ": " << klt.getNbFeatures() << "/" << nbVisible
+            << " features tracked, mean error at the last frame " << meanError << ", max error " << maxError
+            << std::endl;
+
+  if (klt.getNbFeatures() < 0.95 * nbVisible || meanError > 0.1 || maxError > 0.5) {
+    std::cerr << name << " failed" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  // Random texture
+  vpUniRand rng(42);
+  std::vector<Blob> blobs;
+  for (unsigned int k = 0; k < 300; k++) {
+    Blob b;
+    b.u = rng.uniform(-20.0, 340.0);
+    b.v = rng.uniform(-20.0, 260.0);
+    b.sigma = rng.uniform(2.0, 6.0);
+    b.amplitude = rng.uniform(-80.0, 80.0);
+    blobs.push_back(b);
+  }
+
+  vpKlt klt;
+  klt.setMaxFeatures(200);
+  klt.setWindowSize(9);
+  klt.setQuality(0.01);
+  klt.setMinDistance(10);
+  klt.setBlockSize(3);
+
+  bool success = true;
+
+  // Small motion tracked without pyramid
+  klt.setPyramidLevels(0);
+  success = trackSequence("no pyramid", klt, blobs, 0.6, -0.35, false) && success;
+
+  // Motion larger than the window, requires the pyramid
+  klt.setPyramidLevels(3);
+  success = trackSequence("pyramid", klt, blobs, 4.3, 2.7, false) && success;
+
+  // Initial guess from a motion model
+  success = trackSequence("initial guess", klt, blobs, 4.3, 2.7, true) && success;
+
+  // A copy tracks as the original
+  vpImage<unsigned char> I;
+  render(blobs, 0, 0, I);
+  klt.initTracking(I);
+  vpKlt copy(klt);
+  render(blobs, 1.5, 0.5, I);
+  klt.track(I);
+  copy.track(I);
+  if (copy.getNbFeatures() != klt.getNbFeatures()) {
+    std::cerr << "The copy of the tracker tracks " << copy.getNbFeatures() << " features instead of "
+              << klt.getNbFeatures() << std::endl;
+    success = false;
+  }
+
+  if (!success) {
+    std::cerr << "testKlt failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testKlt is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Bounding volume hierarchy over the faces of a CAD model.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbBoundingVolumeHierarchy.h
+  \brief Bounding volume hierarchy over the faces of a CAD model.
+*/
+
+#ifndef vpMbBoundingVolumeHierarchy_HH
+#define vpMbBoundingVolumeHierarchy_HH
+
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpPoint.h>
+
+/*!
+  \class vpMbBoundingVolumeHierarchy
+
+  \ingroup group_mbt_faces
+
+  \brief Bounding volume hierarchy of axis-aligned boxes over the polygons of
+  a CAD model.
+
+  The hierarchy is built once per model from the object frame coordinates of
+  the polygons, it does not depend on the pose. It is used by vpMbHiddenFaces
+  to answer the two queries of the ray casting visibility test without
+  looping over all the polygons:
+  - frustumCulling() flags the polygons whose bounding box intersects the
+    viewing frustum of the camera. A subtree that lies outside of a side of
+    the frustum is discarded at once, a subtree that lies inside of all the
+    sides is accepted at once.
+  - isOccluded() checks if a segment, typically going from the optical
+    center to a point of a face, crosses a polygon. Only the subtrees whose
+    box is crossed by the segment are visited, and the traversal stops at the
+    first occluder found.
+
+  The results are the same as the ones of the per-polygon tests. A hierarchy
+  built with a maximal leaf size larger than the number of polygons has a
+  single leaf and performs these per-polygon tests.
+
+  Only the polygons flagged as occluders in build() stop the rays. The
+  polygons are assumed planar, they may be concave.
+*/
+class VISP_EXPORT vpMbBoundingVolumeHierarchy
+{
+public:
+  vpMbBoundingVolumeHierarchy();
+
+  void build(const std::vector<std::vector<vpPoint> > &polygons, const std::vector<bool> &occluders);
+  void clear();
+
+  void frustumCulling(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, unsigned int width,
+                      unsigned int height, std::vector<bool> &inFrustum) const;
+
+  /*!
+    \return The maximal number of polygons in a leaf used by the next call to
+    build().
+  */
+  inline unsigned int getMaxLeafSize() const { return m_maxLeafSize; }
+
+  /*!
+    \return The number of nodes of the hierarchy, 0 if it was not built.
+  */
+  inline unsigned int getNbNodes() const { return static_cast<unsigned int>(m_nodes.size()); }
+
+  /*!
+    \return The number of polygons given to build().
+  */
+  inline unsigned int getNbPolygons() const { return static_cast<unsigned int>(m_boxes.size() / 6); }
+
+  bool isOccluded(const vpColVector &origin, const vpColVector &target, int ignored = -1) const;
+
+  void setMaxLeafSize(unsigned int size);
+
+private:
+  //! Node of the hierarchy: a box and either two children or a range of polygons
+  struct vpNode {
+    vpNode() : first(0), count(0), right(0)
+    {
+      for (unsigned int i = 0; i < 3; i++) {
+        bmin[i] = 0.0;
+        bmax[i] = 0.0;
+      }
+    }
+    double bmin[3];
+    double bmax[3];
+    //! First polygon of m_order in a leaf
+    unsigned int first;
+    //! Number of polygons in a leaf, 0 for an inner node
+    unsigned int count;
+    //! Second child of an inner node, the first one is the next node
+    unsigned int right;
+  };
+
+  unsigned int buildNode(unsigned int first, unsigned int last, std::vector<double> &centroids);
+  bool intersectPolygon(unsigned int index, const double *origin, const double *dir) const;
+  bool isOccluded(unsigned int node, const double *origin, const double *dir, const double *inv_dir,
+                  int ignored) const;
+
+  //! Maximal number of polygons in a leaf
+  unsigned int m_maxLeafSize;
+  //! Nodes in depth-first order, the root is the first one
+  std::vector<vpNode> m_nodes;
+  //! Polygon indexes sorted by leaf
+  std::vector<unsigned int> m_order;
+  //! Bounding box of each polygon: xmin, ymin, zmin, xmax, ymax, zmax
+  std::vector<double> m_boxes;
+  //! Plane of each polygon: a, b, c, d with (a, b, c) the unit normal
+  std::vector<double> m_planes;
+  //! First vertex of each polygon in m_vertices, the last value is the total
+  //! number of vertices
+  std::vector<unsigned int> m_firstVertex;
+  //! Object frame coordinates of the vertices
+  std::vector<double> m_vertices;
+  //! Polygons that stop the rays
+  std::vector<bool> m_occluders;
+};
+
+#endif
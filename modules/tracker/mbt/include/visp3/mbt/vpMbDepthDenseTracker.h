@@ -57,8 +57,28 @@ public:
   virtual void display(const vpImage<vpRGBa> &I, const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
                        const vpColor &col, unsigned int thickness = 1, bool displayFullModel = false);
 
+  /*!
+    Return true if the interaction matrix is built in single precision.
+    \sa setDepthDenseSinglePrecision()
+  */
+  inline bool getDepthDenseSinglePrecision() const { return m_useSinglePrecision_depthDense; }
+
+  /*!
+    Return true if the normal equations are accumulated face by face without
+    building the interaction matrix.
+    \sa setDepthDenseFusedNormalEquations()
+  */
+  inline bool getDepthDenseFusedNormalEquations() const { return m_useFusedNormalEquations_depthDense; }
+
   virtual inline vpColVector getError() const { return m_error_depthDense; }
 
+  /*!
+    Return the number of threads used to process the faces concurrently, 0
+    means the OpenMP default.
+    \sa setNbParallelDepthDenseThreads()
+  */
+  inline unsigned int getNbParallelDepthDenseThreads() const { return m_nbParallelThreads_depthDense; }
+
   virtual std::vector<std::vector<double> > getModelForDisplay(unsigned int width, unsigned int height,
                                                                const vpHomogeneousMatrix &cMo,
                                                                const vpCameraParameters &cam,
@@ -66,6 +86,12 @@ public:
 
   virtual inline vpColVector getRobustWeights() const { return m_w_depthDense; }
 
+  /*!
+    Return true if the faces are processed concurrently.
+    \sa setUseParallelDepthDense()
+  */
+  inline bool getUseParallelDepthDense() const { return m_useParallel_depthDense; }
+
   virtual void init(const vpImage<unsigned char> &I);
 
   virtual void loadConfigFile(const std::string &configFile);
@@ -86,6 +112,22 @@ public:
   virtual void setDepthDenseFilteringMinDistance(double minDistance);
   virtual void setDepthDenseFilteringOccupancyRatio(double occupancyRatio);
 
+  /*!
+    Accumulate the normal equations \f$ {\bf L}^T {\bf W}^2 {\bf L} \f$ and
+    \f$ {\bf L}^T {\bf W}^2 {\bf e} \f$ face by face, see
+    vpMbtFaceDepthDense::computeNormalEquations(), instead of building,
+    weighting and multiplying the interaction matrix at each iteration. The
+    interaction matrix is still built at the first iteration to check its
+    rank, and at each iteration when the covariance is computed. The pose
+    differs from the one obtained with the interaction matrix by rounding
+    errors only. This setting is only used by the vpMbDepthDenseTracker pose
+    estimation and has precedence over setDepthDenseSinglePrecision().
+
+    \param fused : If true, fuse the interaction matrix into the normal
+    equations.
+  */
+  inline void setDepthDenseFusedNormalEquations(bool fused) { m_useFusedNormalEquations_depthDense = fused; }
+
   inline void setDepthDenseSamplingStep(unsigned int stepX, unsigned int stepY)
   {
     if (stepX == 0 || stepY == 0) {
@@ -97,6 +139,29 @@ public:
     m_depthDenseSamplingStepY = stepY;
   }
 
+  /*!
+    Build the interaction matrix in single precision (vpMatrixf) instead of
+    double precision. The normal equations \f$ {\bf L}^T {\bf L} \f$ and
+    \f$ {\bf L}^T {\bf e} \f$ are still accumulated in double precision and
+    the pose increment is computed in double precision. This halves the memory
+    footprint of the interaction matrix that can have tens of thousands of rows.
+    This setting is only used by the vpMbDepthDenseTracker pose estimation.
+
+    \param useSinglePrecision : If true, use a single precision interaction matrix.
+  */
+  inline void setDepthDenseSinglePrecision(bool useSinglePrecision)
+  {
+    m_useSinglePrecision_depthDense = useSinglePrecision;
+  }
+
+  /*!
+    Set the number of threads used to process the faces concurrently when
+    setUseParallelDepthDense() is enabled.
+
+    \param nb : Number of threads, 0 to use the OpenMP default.
+  */
+  inline void setNbParallelDepthDenseThreads(unsigned int nb) { m_nbParallelThreads_depthDense = nb; }
+
   virtual void setOgreVisibilityTest(const bool &v);
 
   virtual void setPose(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cdMo);
@@ -109,6 +174,8 @@ public:
 
   void setUseDepthDenseTracking(const std::string &name, const bool &useDepthDenseTracking);
 
+  void setUseParallelDepthDense(bool parallel);
+
   virtual void testTracking();
 
   virtual void track(const vpImage<unsigned char> &);
@@ -135,6 +202,16 @@ protected:
   vpColVector m_error_depthDense;
   //! Interaction matrix
   vpMatrix m_L_depthDense;
+  //! Interaction matrix in single precision
+  vpMatrixf m_Lf_depthDense;
+  //! If true, build the interaction matrix in single precision
+  bool m_useSinglePrecision_depthDense;
+  //! If true, accumulate the normal equations face by face
+  bool m_useFusedNormalEquations_depthDense;
+  //! If true, process the faces concurrently
+  bool m_useParallel_depthDense;
+  //! Number of threads used to process the faces, 0 for the OpenMP default
+  unsigned int m_nbParallelThreads_depthDense;
   //! Tukey M-Estimator
   vpMbtTukeyEstimator<double> m_robust_depthDense;
   //! Robust weights
@@ -153,6 +230,8 @@ protected:
   void computeVVS();
   virtual void computeVVSInit();
   virtual void computeVVSInteractionMatrixAndResidu();
+  void computeVVSNormalEquations(vpMatrix &LTL, vpColVector &LTR);
+  void computeVVSResidu();
   virtual void computeVVSWeights();
   using vpMbTracker::computeVVSWeights;
 
@@ -47,7 +47,7 @@
 
 #include <visp3/core/vpConfig.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
 #include <visp3/core/vpExponentialMap.h>
 #include <visp3/core/vpPoseVector.h>
@@ -63,7 +63,8 @@
   \ingroup group_mbt_trackers
   \warning This class is deprecated for user usage. You should rather use the high level
   vpMbGenericTracker class.
-  \warning This class is only available if OpenCV is installed, and used.
+  \warning When OpenCV is not available, the KLT points are tracked with the
+  native vpKlt tracker instead of vpKltOpencv.
 
   \brief Hybrid tracker based on moving-edges and keypoints tracked using KLT
   tracker.
@@ -53,6 +53,7 @@
 #include <visp3/mbt/vpMbtDistanceLine.h>
 #include <visp3/mbt/vpMbtMeLine.h>
 #include <visp3/me/vpMe.h>
+#include <visp3/me/vpMeGradientLookup.h>
 
 #include <fstream>
 #include <iostream>
@@ -331,6 +332,20 @@ protected:
   vpRobust m_robust_edge;
   //! Display features
   std::vector<std::vector<double> > m_featuresToBeDisplayedEdge;
+  //! If true, the moving edges of the lines, cylinders and circles are processed concurrently
+  bool m_useParallelMovingEdge;
+  //! Number of threads used to process the moving edges, 0 to use the OpenMP default
+  unsigned int m_nbParallelMovingEdgeThreads;
+  //! If true, the moving-edge mask responses are shared through a per-frame lookup
+  bool m_useMovingEdgeGradientLookup;
+  //! Per-frame lookup of the moving-edge mask responses, one for each scale level
+  std::vector<vpMeGradientLookup *> m_movingEdgeGradientLookups;
+  //! Lookup shared with other trackers and updated by its owner, NULL if none
+  const vpMeGradientLookup *m_sharedMovingEdgeGradientLookup;
+  //! Generation of the shared lookup when it was last bound, see vpMeGradientLookup::getGeneration()
+  unsigned int m_sharedMovingEdgeGradientLookupGeneration;
+  //! If true, the shared lookup was rejected for the current frame and the own lookup is used until the next one
+  bool m_sharedMovingEdgeGradientLookupRejected;
 
 public:
   vpMbEdgeTracker();
@@ -386,6 +401,30 @@ public:
    */
   inline double getGoodMovingEdgesRatioThreshold() const { return percentageGdPt; }
 
+  /*!
+    \return The number of threads used to process the moving edges, 0 when
+    the OpenMP default is used.
+
+    \sa setNbParallelMovingEdgeThreads()
+  */
+  inline unsigned int getNbParallelMovingEdgeThreads() const { return m_nbParallelMovingEdgeThreads; }
+
+  /*!
+    \return True if the moving edges of the primitives are processed
+    concurrently.
+
+    \sa setUseParallelMovingEdge()
+  */
+  inline bool getUseParallelMovingEdge() const { return m_useParallelMovingEdge; }
+
+  /*!
+    \return True if the moving-edge mask responses are shared through a
+    per-frame lookup.
+
+    \sa setUseMovingEdgeGradientLookup()
+  */
+  inline bool getUseMovingEdgeGradientLookup() const { return m_useMovingEdgeGradientLookup; }
+
   virtual inline vpColVector getError() const { return m_error_edge; }
 
   virtual inline vpColVector getRobustWeights() const { return m_w_edge; }
@@ -481,6 +520,16 @@ public:
 
   void setMovingEdge(const vpMe &me);
 
+  /*!
+    Set the number of threads used to process the moving edges when
+    setUseParallelMovingEdge() is enabled.
+
+    \param nbThreads : Number of threads, 0 to use the OpenMP default.
+  */
+  inline void setNbParallelMovingEdgeThreads(unsigned int nbThreads) { m_nbParallelMovingEdgeThreads = nbThreads; }
+
+  void setUseParallelMovingEdge(bool parallel);
+
   virtual void setPose(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cdMo);
   virtual void setPose(const vpImage<vpRGBa> &I_color, const vpHomogeneousMatrix &cdMo);
 
@@ -488,6 +537,10 @@ public:
 
   void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
 
+  void setSharedMovingEdgeGradientLookup(const vpMeGradientLookup *lookup);
+
+  void setUseMovingEdgeGradientLookup(bool use);
+
   virtual void track(const vpImage<unsigned char> &I);
   virtual void track(const vpImage<vpRGBa> &I);
   //@}
@@ -500,6 +553,7 @@ protected:
   void addCylinder(const vpPoint &P1, const vpPoint &P2, double r, int idFace = -1, const std::string &name = "");
   void addLine(vpPoint &p1, vpPoint &p2, int polygon = -1, std::string name = "");
   void addPolygon(vpMbtPolygon &p);
+  void bindMovingEdgeGradientLookup(const vpImage<unsigned char> &I, bool newFrame);
 
   void cleanPyramid(std::vector<const vpImage<unsigned char> *> &_pyramid);
   void computeProjectionError(const vpImage<unsigned char> &_I);
@@ -537,6 +591,7 @@ protected:
   void removeLine(const std::string &name);
   void resetMovingEdge();
   virtual void testTracking();
+  void shiftMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo);
   void trackMovingEdge(const vpImage<unsigned char> &I);
   void updateMovingEdge(const vpImage<unsigned char> &I);
   void updateMovingEdgeWeights();
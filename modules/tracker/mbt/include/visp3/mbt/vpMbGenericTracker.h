@@ -44,6 +44,12 @@
 #include <visp3/mbt/vpMbDepthNormalTracker.h>
 #include <visp3/mbt/vpMbEdgeTracker.h>
 #include <visp3/mbt/vpMbKltTracker.h>
+#include <visp3/mbt/vpMbtPosePredictor.h>
+#include <visp3/mbt/vpMbtTrackingStatistics.h>
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+#include <functional>
+#endif
 
 /*!
   \class vpMbGenericTracker
@@ -76,13 +82,28 @@
   There is also \ref tutorial-detection-object that shows how to initialize the tracker from
   an initial pose provided by a detection algorithm.
 
+  With a stereo or a RGB-D configuration, the cameras can be processed
+  concurrently, see setUseParallelTracking(). The moving-edge, KLT and depth
+  features of each camera are then extracted and tracked, and the per-camera
+  interaction matrices and residuals are computed, in parallel. The
+  per-camera blocks are always stacked in the order of the camera names, so
+  that the result does not depend on the thread scheduling.
+
+  To see where the tracking time goes, the timings and counters of each call
+  to track() can be measured for each camera with setUseTrackingStatistics()
+  and read with getTrackingStatistics():
+  \code
+  tracker.setUseTrackingStatistics(true);
+  tracker.track(I);
+  std::cout << tracker.getTrackingStatistics() << std::endl;
+  \endcode
 */
 class VISP_EXPORT vpMbGenericTracker : public vpMbTracker
 {
 public:
   enum vpTrackerType {
     EDGE_TRACKER = 1 << 0, /*!< Model-based tracking using moving edges features. */
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
     KLT_TRACKER = 1 << 1, /*!< Model-based tracking using KLT features. */
 #endif
     DEPTH_NORMAL_TRACKER = 1 << 2, /*!< Model-based tracking using depth normal features. */
@@ -141,7 +162,7 @@ public:
   virtual vpMbHiddenFaces<vpMbtPolygon> &getFaces();
   virtual vpMbHiddenFaces<vpMbtPolygon> &getFaces(const std::string &cameraName);
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual std::list<vpMbtDistanceCircle *> &getFeaturesCircle();
   virtual std::list<vpMbtDistanceKltCylinder *> &getFeaturesKltCylinder();
   virtual std::list<vpMbtDistanceKltPoints *> &getFeaturesKlt();
@@ -152,18 +173,25 @@ public:
 
   virtual double getGoodMovingEdgesRatioThreshold() const;
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual std::vector<vpImagePoint> getKltImagePoints() const;
   virtual std::map<int, vpImagePoint> getKltImagePointsWithId() const;
 
   virtual unsigned int getKltMaskBorder() const;
   virtual int getKltNbPoints() const;
 
+#if defined(VISP_HAVE_OPENCV)
   virtual vpKltOpencv getKltOpencv() const;
   virtual void getKltOpencv(vpKltOpencv &klt1, vpKltOpencv &klt2) const;
   virtual void getKltOpencv(std::map<std::string, vpKltOpencv> &mapOfKlts) const;
+#endif
+  virtual vpKlt getKlt() const;
+  virtual void getKlt(vpKlt &klt1, vpKlt &klt2) const;
+  virtual void getKlt(std::map<std::string, vpKlt> &mapOfKlts) const;
 
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+  virtual std::vector<vpImagePoint> getKltPoints() const;
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   virtual std::vector<cv::Point2f> getKltPoints() const;
 #endif
 
@@ -195,6 +223,14 @@ public:
   virtual void getMovingEdge(vpMe &me1, vpMe &me2) const;
   virtual void getMovingEdge(std::map<std::string, vpMe> &mapOfMovingEdges) const;
 
+  /*!
+    Get the number of threads used when the cameras are processed
+    concurrently. 0 means one thread per camera.
+
+    \sa setNbParallelTrackingThreads()
+  */
+  virtual inline unsigned int getNbParallelTrackingThreads() const { return m_nbParallelTrackingThreads; }
+
   virtual unsigned int getNbPoints(unsigned int level = 0) const;
   virtual void getNbPoints(std::map<std::string, unsigned int> &mapOfNbPoints, unsigned int level = 0) const;
 
@@ -216,12 +252,34 @@ public:
   virtual void getPose(vpHomogeneousMatrix &c1Mo, vpHomogeneousMatrix &c2Mo) const;
   virtual void getPose(std::map<std::string, vpHomogeneousMatrix> &mapOfCameraPoses) const;
 
+  /*!
+    Get the pose predictor, to select its motion model, to give it the
+    timestamps of the frames or an external measure of the camera twist, and
+    to read its statistics. The prediction is disabled by default.
+  */
+  virtual inline vpMbtPosePredictor &getPosePredictor() { return m_posePredictor; }
+
   virtual std::string getReferenceCameraName() const;
 
   virtual inline vpColVector getRobustWeights() const { return m_w; }
 
   virtual int getTrackerType() const;
 
+  /*!
+    Get the timings and counters of the last call to track(), for all the
+    cameras. They are measured only when enabled with
+    setUseTrackingStatistics().
+  */
+  virtual inline vpMbtTrackingStatistics getTrackingStatistics() const { return m_trackingStatistics; }
+  virtual void getTrackingStatistics(std::map<std::string, vpMbtTrackingStatistics> &mapOfStatistics) const;
+
+  /*!
+    Return true if the cameras are processed concurrently.
+
+    \sa setUseParallelTracking()
+  */
+  virtual inline bool getUseParallelTracking() const { return m_useParallelTracking; }
+
   virtual void init(const vpImage<unsigned char> &I);
 
 #ifdef VISP_HAVE_MODULE_GUI
@@ -334,6 +392,26 @@ public:
   virtual void setClipping(const unsigned int &flags1, const unsigned int &flags2);
   virtual void setClipping(const std::map<std::string, unsigned int> &mapOfClippingFlags);
 
+  /*!
+    When the cameras are processed concurrently, the per-camera blocks of the
+    interaction matrix and of the residual vector are always stacked in the
+    camera order. The only step whose result depends on how the work is split
+    is the computation of the weighted residual norm used in the stopping
+    criterion: by default it is accumulated in the camera order, which gives
+    results bit-identical to the sequential path. If \e deterministic is
+    false, each camera accumulates its own partial sums that are reduced
+    afterwards, which may change the last bits of the residual norm.
+
+    \param deterministic : If true (default), results are bit-identical to
+    the sequential path.
+
+    \sa setUseParallelTracking()
+  */
+  virtual inline void setDeterministicParallelTracking(bool deterministic)
+  {
+    m_deterministicParallelTracking = deterministic;
+  }
+
   virtual void setDepthDenseFilteringMaxDistance(double maxDistance);
   virtual void setDepthDenseFilteringMethod(int method);
   virtual void setDepthDenseFilteringMinDistance(double minDistance);
@@ -357,19 +435,22 @@ public:
 
   virtual void setGoodMovingEdgesRatioThreshold(double threshold);
 
-#ifdef VISP_HAVE_OGRE
   virtual void setGoodNbRayCastingAttemptsRatio(const double &ratio);
   virtual void setNbRayCastingAttemptsForVisibility(const unsigned int &attempts);
-#endif
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual void setKltMaskBorder(const unsigned int &e);
   virtual void setKltMaskBorder(const unsigned int &e1, const unsigned int &e2);
   virtual void setKltMaskBorder(const std::map<std::string, unsigned int> &mapOfErosions);
 
+#if defined(VISP_HAVE_OPENCV)
   virtual void setKltOpencv(const vpKltOpencv &t);
   virtual void setKltOpencv(const vpKltOpencv &t1, const vpKltOpencv &t2);
   virtual void setKltOpencv(const std::map<std::string, vpKltOpencv> &mapOfKlts);
+#endif
+  virtual void setKlt(const vpKlt &t);
+  virtual void setKlt(const vpKlt &t1, const vpKlt &t2);
+  virtual void setKlt(const std::map<std::string, vpKlt> &mapOfKlts);
 
   virtual void setKltThresholdAcceptation(double th);
 
@@ -386,6 +467,20 @@ public:
   virtual void setMovingEdge(const vpMe &me1, const vpMe &me2);
   virtual void setMovingEdge(const std::map<std::string, vpMe> &mapOfMe);
 
+  virtual void setNbParallelDepthDenseThreads(unsigned int nb);
+  virtual void setNbParallelMovingEdgeThreads(unsigned int nb);
+  virtual void setNbParallelScanLineThreads(unsigned int nb);
+
+  /*!
+    Set the number of threads used when the cameras are processed
+    concurrently.
+
+    \param nb : Number of threads. 0 (default) means one thread per camera.
+
+    \sa setUseParallelTracking()
+  */
+  virtual inline void setNbParallelTrackingThreads(unsigned int nb) { m_nbParallelTrackingThreads = nb; }
+
   virtual void setNearClippingDistance(const double &dist);
   virtual void setNearClippingDistance(const double &dist1, const double &dist2);
   virtual void setNearClippingDistance(const std::map<std::string, double> &mapOfDists);
@@ -414,17 +509,30 @@ public:
   virtual void setProjectionErrorDisplayArrowLength(unsigned int length);
   virtual void setProjectionErrorDisplayArrowThickness(unsigned int thickness);
 
+  virtual void setRayCastingVisibilityTest(bool v);
+
   virtual void setReferenceCameraName(const std::string &referenceCameraName);
 
+  virtual void setScanLineIncrementalThreshold(double threshold);
+  virtual void setScanLineOccluders(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > > &occluders);
+  virtual void setScanLineStep(unsigned int step);
   virtual void setScanLineVisibilityTest(const bool &v);
 
   virtual void setTrackerType(int type);
   virtual void setTrackerType(const std::map<std::string, int> &mapOfTrackerTypes);
 
+  virtual void setSharedMovingEdgeGradientLookup(const vpMeGradientLookup *lookup);
+  virtual void setUseMovingEdgeGradientLookup(bool use);
+  virtual void setUseParallelDepthDense(bool parallel);
+  virtual void setUseParallelMovingEdge(bool parallel);
+  virtual void setUseParallelScanLine(bool parallel);
+  virtual void setUseParallelTracking(bool parallel);
+  virtual void setUseTrackingStatistics(bool use);
+
   virtual void setUseDepthDenseTracking(const std::string &name, const bool &useDepthDenseTracking);
   virtual void setUseDepthNormalTracking(const std::string &name, const bool &useDepthNormalTracking);
   virtual void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual void setUseKltTracking(const std::string &name, const bool &useKltTracking);
 #endif
 
@@ -487,9 +595,29 @@ protected:
                            std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                            std::map<std::string, unsigned int> &mapOfPointCloudHeights);
 
+#ifdef VISP_HAVE_PCL
+  virtual void postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                            std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds);
+#endif
+  virtual void postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                            std::map<std::string, unsigned int> &mapOfPointCloudWidths,
+                            std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+
+  void predictPose(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages);
+
+  void startTrackingStatistics();
+  void stopTrackingStatistics();
+
+  bool useParallelTracking() const;
+
 private:
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  void runPerCamera(unsigned int nbCameras, const std::function<void(unsigned int)> &task) const;
+#endif
+
+
   class TrackerWrapper : public vpMbEdgeTracker,
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                          public vpMbKltTracker,
 #endif
                          public vpMbDepthNormalTracker,
@@ -508,6 +636,10 @@ private:
     vpColVector m_w;
     //! Weighted error
     vpColVector m_weightedError;
+    //! If true, the timings and counters of the tracking are measured
+    bool m_useTrackingStatistics;
+    //! Timings and counters of the last tracking step
+    vpMbtTrackingStatistics m_statistics;
 
     TrackerWrapper();
     explicit TrackerWrapper(int trackerType);
@@ -629,6 +761,16 @@ private:
                          const vpHomogeneousMatrix &cdMo);
   };
 
+  void computeVVSStatistics(TrackerWrapper *tracker, unsigned int start_index, const vpColVector &W_true);
+  void computeVVSWeightedResidual(TrackerWrapper *tracker, unsigned int start_index, vpColVector &W_true,
+                                  double &num, double &den);
+#ifdef VISP_HAVE_PCL
+  void postTracking(TrackerWrapper *tracker, const vpImage<unsigned char> *const ptr_I,
+                    const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud);
+#endif
+  void postTracking(TrackerWrapper *tracker, const vpImage<unsigned char> *const ptr_I,
+                    unsigned int pointcloud_width, unsigned int pointcloud_height);
+
 protected:
   //! (s - s*)
   vpColVector m_error;
@@ -654,5 +796,21 @@ protected:
   vpColVector m_w;
   //! Weighted error
   vpColVector m_weightedError;
+  //! If true, the cameras are processed concurrently
+  bool m_useParallelTracking;
+  //! Number of threads used to process the cameras concurrently (0: one per camera)
+  unsigned int m_nbParallelTrackingThreads;
+  //! If true, the parallel path gives results bit-identical to the sequential one
+  bool m_deterministicParallelTracking;
+  //! Motion model prediction of the pose of the next frame
+  vpMbtPosePredictor m_posePredictor;
+  //! Number of iterations of the last pose estimation
+  unsigned int m_nbVVSIterations;
+  //! If true, the timings and counters of the tracking are measured
+  bool m_useTrackingStatistics;
+  //! Timings and counters of the last tracking step, for all the cameras
+  vpMbtTrackingStatistics m_trackingStatistics;
+  //! Start time of the last tracking step, for the statistics
+  double m_trackingStartTime;
 };
 #endif
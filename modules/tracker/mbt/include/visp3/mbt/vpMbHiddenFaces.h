@@ -45,6 +45,7 @@
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpMeterPixelConversion.h>
 #include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/mbt/vpMbBoundingVolumeHierarchy.h>
 #include <visp3/mbt/vpMbScanLine.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 
@@ -52,6 +53,7 @@
 #include <visp3/ar/vpAROgre.h>
 #endif
 
+#include <cstdlib>
 #include <limits>
 #include <vector>
 
@@ -75,12 +77,20 @@ private:
   //! Number of visible polygon
   unsigned int nbVisiblePolygon;
   vpMbScanLine scanlineRender;
+  unsigned int nbRayAttempts;
+  double ratioVisibleRay;
+  //! Ray casting visibility test without Ogre
+  bool useRayCasting;
+  //! Hierarchy over the polygons used by the ray casting visibility test
+  vpMbBoundingVolumeHierarchy bvh;
+  //! For each polygon, true if its bounding box intersects the frustum
+  std::vector<bool> inFrustum;
+  //! Polygons of other objects rendered with the faces by the scanline visibility test, in the camera frame
+  std::vector<std::vector<std::pair<vpPoint, unsigned int> > > scanLineOccluders;
 
 #ifdef VISP_HAVE_OGRE
   vpImage<unsigned char> ogreBackground;
   bool ogreInitialised;
-  unsigned int nbRayAttempts;
-  double ratioVisibleRay;
   vpAROgre *ogre;
   std::vector<Ogre::ManualObject *> lOgrePolygons;
   bool ogreShowConfigDialog;
@@ -104,6 +114,8 @@ public:
                          bool &changed, bool useOgre, bool not_used, unsigned int width, unsigned int height,
                          const vpCameraParameters &cam, const vpTranslationVector &cameraPos, unsigned int index);
 
+  void computeBoundingVolumeHierarchy();
+
   void computeClippedPolygons(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam);
 
   void computeScanLineRender(const vpCameraParameters &cam, const unsigned int &w, const unsigned int &h);
@@ -111,8 +123,23 @@ public:
   void computeScanLineQuery(const vpPoint &a, const vpPoint &b, std::vector<std::pair<vpPoint, vpPoint> > &lines,
                             const bool &displayResults = false);
 
+  /*!
+    Get the bounding volume hierarchy used by the ray casting visibility
+    test. It is built by the first visibility test following a change of the
+    number of polygons, see computeBoundingVolumeHierarchy().
+  */
+  vpMbBoundingVolumeHierarchy &getBoundingVolumeHierarchy() { return bvh; }
+
   vpMbScanLine &getMbScanLineRenderer() { return scanlineRender; }
 
+  /*!
+    Get the polygons of other objects rendered by computeScanLineRender().
+  */
+  const std::vector<std::vector<std::pair<vpPoint, unsigned int> > > &getScanLineOccluders() const
+  {
+    return scanLineOccluders;
+  }
+
 #ifdef VISP_HAVE_OGRE
   void displayOgre(const vpHomogeneousMatrix &cMo);
 #endif
@@ -135,7 +162,6 @@ public:
   */
   unsigned int getNbVisiblePolygon() const { return nbVisiblePolygon; }
 
-#ifdef VISP_HAVE_OGRE
   /*!
     Get the number of rays that will be sent toward each polygon for
     visibility test. Each ray will go from the optic center of the camera to a
@@ -147,12 +173,14 @@ public:
   */
   unsigned int getNbRayCastingAttemptsForVisibility() { return nbRayAttempts; }
 
+#ifdef VISP_HAVE_OGRE
   /*!
     Get the Ogre3D Context.
 
     \return A pointer on a vpAROgre instance.
   */
   vpAROgre *getOgreContext() { return ogre; }
+#endif
 
   /*!
     Get the ratio of visibility attempts that has to be successful to consider
@@ -164,7 +192,13 @@ public:
     be between 0.0 (0%) and 1.0 (100%).
   */
   double getGoodNbRayCastingAttemptsRatio() { return ratioVisibleRay; }
-#endif
+
+  /*!
+    Tell whether the ray casting visibility test is used when Ogre is not.
+
+    \sa setRayCastingVisibilityTest()
+  */
+  bool getRayCastingVisibilityTest() const { return useRayCasting; }
 
   bool isAppearing(unsigned int i) { return Lpol[i]->isAppearing(); }
 
@@ -189,6 +223,7 @@ public:
 #ifdef VISP_HAVE_OGRE
   bool isVisibleOgre(const vpTranslationVector &cameraPos, const unsigned int &index);
 #endif
+  bool isVisibleRayCasting(const vpTranslationVector &cameraPos, const unsigned int &index);
 
   //! operator[] as modifier.
   inline PolygonType *operator[](unsigned int i) { return Lpol[i]; }
@@ -212,6 +247,7 @@ public:
   {
     ogreBackground = vpImage<unsigned char>(h, w, 0);
   }
+#endif
 
   /*!
     Set the number of rays that will be sent toward each polygon for
@@ -241,6 +277,8 @@ public:
     if (ratioVisibleRay < 0.0)
       ratioVisibleRay = 0.0;
   }
+
+#ifdef VISP_HAVE_OGRE
   /*!
     Enable/Disable the appearance of Ogre config dialog on startup.
 
@@ -254,6 +292,37 @@ public:
   inline void setOgreShowConfigDialog(bool showConfigDialog) { ogreShowConfigDialog = showConfigDialog; }
 #endif
 
+  /*!
+    Enable/Disable the ray casting visibility test when Ogre is not used.
+
+    As with the Ogre visibility test, a face passing the angle test, from
+    either side, is visible when its bounding box intersects the viewing
+    frustum and when enough of the rays sent from the optical center toward
+    the face are not stopped by another face, see
+    setNbRayCastingAttemptsForVisibility() and
+    setGoodNbRayCastingAttemptsRatio(). The faces are organised in a
+    bounding volume hierarchy so that the cost of a frame grows with the
+    logarithm of the number of faces instead of their square.
+
+    \param v : True to use the ray casting test. By default, only the angle
+    test is used.
+  */
+  void setRayCastingVisibilityTest(bool v) { useRayCasting = v; }
+
+  /*!
+    Set polygons of other objects that computeScanLineRender() renders with
+    the faces, so that the parts of the faces they hide are not visible. The
+    occluders are given the negative polygon indices -2, -3, ... in the
+    primitive ids of the renderer and are not drawn in its mask.
+
+    \param occluders : Clipped polygons expressed in the camera frame, an
+    empty vector to remove them.
+  */
+  void setScanLineOccluders(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > > &occluders)
+  {
+    scanLineOccluders = occluders;
+  }
+
   unsigned int setVisible(unsigned int width, unsigned int height, const vpCameraParameters &cam,
                           const vpHomogeneousMatrix &cMo, const double &angle, bool &changed);
   unsigned int setVisible(unsigned int width, unsigned int height, const vpCameraParameters &cam,
@@ -281,12 +350,12 @@ public:
   Basic constructor.
 */
 template <class PolygonType>
-vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces() : Lpol(), nbVisiblePolygon(0), scanlineRender()
+vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces()
+  : Lpol(), nbVisiblePolygon(0), scanlineRender(), nbRayAttempts(1), ratioVisibleRay(1.0), useRayCasting(false),
+    bvh(), inFrustum(), scanLineOccluders()
 {
 #ifdef VISP_HAVE_OGRE
   ogreInitialised = false;
-  nbRayAttempts = 1;
-  ratioVisibleRay = 1.0;
   ogreShowConfigDialog = false;
   ogre = new vpAROgre();
   ogreBackground = vpImage<unsigned char>(480, 640, 0);
@@ -329,11 +398,13 @@ template <class PolygonType> vpMbHiddenFaces<PolygonType>::~vpMbHiddenFaces()
 */
 template <class PolygonType>
 vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces(const vpMbHiddenFaces<PolygonType> &copy)
-  : Lpol(), nbVisiblePolygon(copy.nbVisiblePolygon), scanlineRender(copy.scanlineRender)
+  : Lpol(), nbVisiblePolygon(copy.nbVisiblePolygon), scanlineRender(copy.scanlineRender),
+    nbRayAttempts(copy.nbRayAttempts), ratioVisibleRay(copy.ratioVisibleRay), useRayCasting(copy.useRayCasting),
+    bvh(copy.bvh), inFrustum(copy.inFrustum), scanLineOccluders(copy.scanLineOccluders)
 #ifdef VISP_HAVE_OGRE
     ,
-    ogreBackground(copy.ogreBackground), ogreInitialised(copy.ogreInitialised), nbRayAttempts(copy.nbRayAttempts),
-    ratioVisibleRay(copy.ratioVisibleRay), ogre(NULL), lOgrePolygons(), ogreShowConfigDialog(copy.ogreShowConfigDialog)
+    ogreBackground(copy.ogreBackground), ogreInitialised(copy.ogreInitialised), ogre(NULL), lOgrePolygons(),
+    ogreShowConfigDialog(copy.ogreShowConfigDialog)
 #endif
 {
   // Copy the list of polygons
@@ -349,10 +420,14 @@ template <class PolygonType> void swap(vpMbHiddenFaces<PolygonType> &first, vpMb
   swap(first.Lpol, second.Lpol);
   swap(first.nbVisiblePolygon, second.nbVisiblePolygon);
   swap(first.scanlineRender, second.scanlineRender);
-#ifdef VISP_HAVE_OGRE
-  swap(first.ogreInitialised, second.ogreInitialised);
   swap(first.nbRayAttempts, second.nbRayAttempts);
   swap(first.ratioVisibleRay, second.ratioVisibleRay);
+  swap(first.useRayCasting, second.useRayCasting);
+  swap(first.bvh, second.bvh);
+  swap(first.inFrustum, second.inFrustum);
+  swap(first.scanLineOccluders, second.scanLineOccluders);
+#ifdef VISP_HAVE_OGRE
+  swap(first.ogreInitialised, second.ogreInitialised);
   swap(first.ogreShowConfigDialog, second.ogreShowConfigDialog);
   swap(first.ogre, second.ogre);
   swap(first.ogreBackground, second.ogreBackground);
@@ -405,6 +480,10 @@ template <class PolygonType> void vpMbHiddenFaces<PolygonType>::reset()
     Lpol[i] = NULL;
   }
   Lpol.resize(0);
+  bvh.clear();
+  inFrustum.clear();
+  nbRayAttempts = 1;
+  ratioVisibleRay = 1.0;
 
 #ifdef VISP_HAVE_OGRE
   if (ogre != NULL) {
@@ -423,13 +502,32 @@ template <class PolygonType> void vpMbHiddenFaces<PolygonType>::reset()
   lOgrePolygons.resize(0);
 
   ogreInitialised = false;
-  nbRayAttempts = 1;
-  ratioVisibleRay = 1.0;
   ogre = new vpAROgre();
   ogreBackground = vpImage<unsigned char>(480, 640);
 #endif
 }
 
+/*!
+  Build the bounding volume hierarchy over the polygons that have been added
+  via addPolygon(), from their coordinates in the object frame.
+
+  The hierarchy is automatically built by the ray casting visibility test
+  when the number of polygons changed. This function has only to be called
+  after a modification of the vertices of the polygons.
+*/
+template <class PolygonType> void vpMbHiddenFaces<PolygonType>::computeBoundingVolumeHierarchy()
+{
+  std::vector<std::vector<vpPoint> > polygons(Lpol.size());
+  std::vector<bool> occluders(Lpol.size());
+  for (unsigned int i = 0; i < Lpol.size(); i++) {
+    polygons[i].assign(Lpol[i]->p, Lpol[i]->p + Lpol[i]->nbpt);
+    // Lines and cylinder outlines do not hide anything
+    occluders[i] = Lpol[i]->nbpt >= 3 && Lpol[i]->isPolygonOriented();
+  }
+  bvh.build(polygons, occluders);
+  inFrustum.clear();
+}
+
 /*!
   Compute the clipped points of the polygons that have been added via
   addPolygon().
@@ -483,6 +581,14 @@ void vpMbHiddenFaces<PolygonType>::computeScanLineRender(const vpCameraParameter
     }
   }
 
+  // The faces of other objects hide the faces of the model but are not part of it
+  for (size_t i = 0; i < scanLineOccluders.size(); i++) {
+    if (scanLineOccluders[i].size() != 0) {
+      listPolyClipped.push_back(&scanLineOccluders[i]);
+      listPolyIndices.push_back(-2 - static_cast<int>(i));
+    }
+  }
+
   scanlineRender.drawScene(listPolyClipped, listPolyIndices, cam, w, h);
 }
 
@@ -537,6 +643,12 @@ unsigned int vpMbHiddenFaces<PolygonType>::setVisiblePrivate(const vpHomogeneous
 #else
     vpTRACE("ViSP doesn't have Ogre3D, simple visibility test used");
 #endif
+  } else if (useRayCasting) {
+    if (bvh.getNbPolygons() != Lpol.size()) {
+      computeBoundingVolumeHierarchy();
+    }
+    cMo.inverse().extract(cameraPos);
+    bvh.frustumCulling(cMo, cam, width, height, inFrustum);
   }
 
   for (unsigned int i = 0; i < Lpol.size(); i++) {
@@ -559,8 +671,8 @@ unsigned int vpMbHiddenFaces<PolygonType>::setVisiblePrivate(const vpHomogeneous
   \param not_used : Unused parameter.
   \param width, height Image size.
   \param cam : Camera parameters.
-  \param cameraPos : Position of the camera. Used only when Ogre is used as
-  3rd party.
+  \param cameraPos : Position of the camera. Used only when Ogre or the ray
+  casting visibility test is used.
   \param index : Index of the face to consider.
 
   \return Return true if the face is visible.
@@ -598,6 +710,9 @@ bool vpMbHiddenFaces<PolygonType>::computeVisibility(const vpHomogeneousMatrix &
           testDisappear = (!Lpol[i]->isVisible(cMo, angleDisappears, false, cam, width, height));
         }
 #endif
+        else if (useRayCasting)
+          testDisappear = ((!Lpol[i]->isVisible(cMo, angleDisappears, true, cam, width, height)) ||
+                           !isVisibleRayCasting(cameraPos, i));
         else
           testDisappear = (!Lpol[i]->isVisible(cMo, angleDisappears, false, cam, width, height));
       }
@@ -625,6 +740,9 @@ bool vpMbHiddenFaces<PolygonType>::computeVisibility(const vpHomogeneousMatrix &
 #else
           testAppear = (Lpol[i]->isVisible(cMo, angleAppears, false, cam, width, height));
 #endif
+        else if (useRayCasting)
+          testAppear = ((Lpol[i]->isVisible(cMo, angleAppears, true, cam, width, height)) &&
+                        isVisibleRayCasting(cameraPos, i));
         else
           testAppear = (Lpol[i]->isVisible(cMo, angleAppears, false, cam, width, height));
       }
@@ -706,6 +824,79 @@ unsigned int vpMbHiddenFaces<PolygonType>::setVisible(const vpHomogeneousMatrix
   return setVisiblePrivate(cMo, angleAppears, angleDisappears, changed, false);
 }
 
+/*!
+  Test the visibility of a polygon via ray casting, without Ogre3D.
+
+  The polygon is hidden if its bounding box is outside of the viewing
+  frustum computed by the last call to setVisible(). Otherwise, rays are sent
+  from the camera toward random points of the polygon, chosen as with
+  isVisibleOgre(), and the polygon is visible if the ratio of rays reaching
+  it without crossing another polygon is at least
+  getGoodNbRayCastingAttemptsRatio().
+
+  \param cameraPos : Position of the camera in the object frame.
+  \param index : Index of the polygon.
+
+  \return Return true if the polygon is visible, False otherwise.
+*/
+template <class PolygonType>
+bool vpMbHiddenFaces<PolygonType>::isVisibleRayCasting(const vpTranslationVector &cameraPos,
+                                                       const unsigned int &index)
+{
+  if (bvh.getNbPolygons() != Lpol.size()) {
+    computeBoundingVolumeHierarchy();
+  }
+
+  if (inFrustum.size() == Lpol.size() && !inFrustum[index]) {
+    Lpol[index]->isvisible = false;
+    return false;
+  }
+
+  vpColVector origin(3), target(3);
+  for (unsigned int k = 0; k < 3; k++) {
+    origin[k] = cameraPos[k];
+  }
+
+  unsigned int nbVisible = 0;
+  for (unsigned int i = 0; i < nbRayAttempts; i++) {
+    target = 0;
+    double totalFactor = 0.0;
+
+    for (unsigned int j = 0; j < Lpol[index]->getNbPoint(); j++) {
+      double factor = 1.0;
+
+      if (nbRayAttempts > 1) {
+        int r = rand() % 101;
+
+        if (r != 0)
+          factor = ((double)r) / 100.0;
+      }
+
+      target[0] += factor * Lpol[index]->getPoint(j).get_oX();
+      target[1] += factor * Lpol[index]->getPoint(j).get_oY();
+      target[2] += factor * Lpol[index]->getPoint(j).get_oZ();
+      totalFactor += factor;
+    }
+
+    if (totalFactor > 0.0) {
+      target /= totalFactor;
+    }
+
+    if (!bvh.isOccluded(origin, target, static_cast<int>(index)))
+      nbVisible++;
+  }
+
+  bool visible = true;
+  if (nbRayAttempts > 0) {
+    visible = ((double)nbVisible) / ((double)nbRayAttempts) > ratioVisibleRay ||
+              std::fabs(((double)nbVisible) / ((double)nbRayAttempts) - ratioVisibleRay) <
+                  ratioVisibleRay * std::numeric_limits<double>::epsilon();
+  }
+
+  Lpol[index]->isvisible = visible;
+  return visible;
+}
+
 #ifdef VISP_HAVE_OGRE
 /*!
   Initialise the ogre context for face visibility tests.
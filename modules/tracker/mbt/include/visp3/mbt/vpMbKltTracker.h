@@ -46,13 +46,14 @@
 
 #include <visp3/core/vpConfig.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
 #include <visp3/core/vpExponentialMap.h>
 #include <visp3/core/vpMeterPixelConversion.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/core/vpSubColVector.h>
 #include <visp3/core/vpSubMatrix.h>
+#include <visp3/klt/vpKlt.h>
 #include <visp3/klt/vpKltOpencv.h>
 #include <visp3/mbt/vpMbTracker.h>
 #include <visp3/mbt/vpMbtDistanceCircle.h>
@@ -65,7 +66,8 @@
   \ingroup group_mbt_trackers
   \warning This class is deprecated for user usage. You should rather use the high level
   vpMbGenericTracker class.
-  \warning This class is only available if OpenCV is installed, and used.
+  \warning When OpenCV is not available, the KLT points are tracked with the
+  native vpKlt tracker instead of vpKltOpencv.
 
   \brief Model based tracker using only KLT.
 
@@ -222,7 +224,7 @@ protected:
 //! Temporary OpenCV image for fast conversion.
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   cv::Mat cur;
-#else
+#elif defined(VISP_HAVE_OPENCV)
   IplImage *cur;
 #endif
   //! Initial pose.
@@ -242,7 +244,11 @@ protected:
   //! the initial position.
   vpHomogeneousMatrix ctTc0;
   //! Points tracker.
+#if defined(VISP_HAVE_OPENCV)
   vpKltOpencv tracker;
+#else
+  vpKlt tracker;
+#endif
   //!
   std::list<vpMbtDistanceKltPoints *> kltPolygons;
   //!
@@ -289,9 +295,11 @@ public:
 /*!
   Get the current list of KLT points.
 
-   \return the list of KLT points through vpKltOpencv.
+   \return the list of KLT points through the KLT tracker.
  */
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+  inline std::vector<vpImagePoint> getKltPoints() const { return tracker.getFeatures(); }
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   inline std::vector<cv::Point2f> getKltPoints() const { return tracker.getFeatures(); }
 #else
   inline CvPoint2D32f *getKltPoints() { return tracker.getFeatures(); }
@@ -301,6 +309,7 @@ public:
 
   std::map<int, vpImagePoint> getKltImagePointsWithId() const;
 
+#if defined(VISP_HAVE_OPENCV)
   /*!
     Get the klt tracker at the current state.
 
@@ -308,6 +317,16 @@ public:
    */
   inline vpKltOpencv getKltOpencv() const { return tracker; }
 
+  vpKlt getKlt() const;
+#else
+  /*!
+    Get the klt tracker at the current state.
+
+    \return klt tracker.
+   */
+  inline vpKlt getKlt() const { return tracker; }
+#endif
+
   /*!
     Get the erosion of the mask used on the Model faces.
 
@@ -360,7 +379,10 @@ public:
     faces.getMbScanLineRenderer().setMaskBorder(maskBorder);
   }
 
+#if defined(VISP_HAVE_OPENCV)
   virtual void setKltOpencv(const vpKltOpencv &t);
+#endif
+  virtual void setKlt(const vpKlt &t);
 
   /*!
     Set the threshold for the acceptation of a point.
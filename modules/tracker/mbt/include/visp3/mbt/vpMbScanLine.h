@@ -81,9 +81,9 @@ public:
 
   //! Structure to define a scanline intersection.
   struct vpMbScanLineSegment {
-    vpMbScanLineSegment() : type(START), edge(), p(0), P1(0), P2(0), Z1(0), Z2(0), ID(0), b_sample_Y(false) {}
+    vpMbScanLineSegment() : type(START), edge(-1), p(0), P1(0), P2(0), Z1(0), Z2(0), ID(0), b_sample_Y(false) {}
     vpMbScanLineType type;
-    vpMbScanLineEdge edge;
+    int edge;      // Index of the visibility samples of the edge.
     double p;      // This value can be either x or y-coordinate value depending if
                    // the structure is used in X or Y-axis scanlines computation.
     double P1, P2; // Same comment as previous value.
@@ -131,9 +131,42 @@ private:
   unsigned int maskBorder;
   vpImage<unsigned char> mask;
   vpImage<int> primitive_ids;
-  std::map<vpMbScanLineEdge, std::set<int>, vpMbScanLineEdgeComparator> visibility_samples;
+  //! Index of the visibility samples of each edge
+  std::map<vpMbScanLineEdge, int, vpMbScanLineEdgeComparator> edge_indices;
+  //! Sorted indices of the scanlines where an edge is visible
+  std::vector<std::vector<int> > visibility_samples;
+  //! Non null if the visibility samples of an edge are Y-axis scanlines
+  std::vector<unsigned char> visibility_samples_Y;
   double depthTreshold;
 
+  // Edge table: projected extremities of the edges of all the polygons, stored as a structure of arrays
+  std::vector<double> edge_x0, edge_y0, edge_z0, edge_x1, edge_y1, edge_z1;
+  std::vector<vpMbScanLineEdge> edge_keys;
+  std::vector<int> edge_samples;
+  std::vector<size_t> polygon_edges; // Edges of polygon i are in [polygon_edges[i], polygon_edges[i+1])
+  std::vector<int> polygon_ids;
+
+  // Segment pools kept from one frame to the other
+  std::vector<std::vector<vpMbScanLineSegment> > scanlinesY;
+  std::vector<std::vector<vpMbScanLineSegment> > scanlinesX;
+  std::vector<std::vector<std::vector<vpMbScanLineSegment> > > tile_local_scanlines;
+  std::vector<std::vector<std::pair<int, int> > > tile_samples;
+  vpImage<unsigned char> maskX, maskY;
+
+  bool useParallel;
+  unsigned int nbThreads;
+  unsigned int tileSize;
+  unsigned int scanLineStep;
+
+  // Incremental mode
+  double incrementalThreshold;
+  bool sceneReused;
+  bool referenceValid;
+  std::vector<double> ref_x0, ref_y0, ref_x1, ref_y1;
+  std::vector<int> ref_edge_samples;
+  std::vector<size_t> ref_polygon_edges;
+  std::vector<int> ref_polygon_ids;
+
 public:
 #if defined(DEBUG_DISP)
   vpDisplay *dispMaskDebug;
@@ -155,9 +188,36 @@ public:
     \return Current Threshold.
   */
   double getDepthTreshold() { return depthTreshold; }
+  /*!
+    \return The pixel displacement of the polygon vertices below which the
+    previous rendering is reused, 0 if the incremental mode is disabled.
+  */
+  double getIncrementalThreshold() const { return incrementalThreshold; }
   unsigned int getMaskBorder() { return maskBorder; }
   const vpImage<unsigned char> &getMask() const { return mask; }
+  /*!
+    \return The number of threads used to render the tiles, 0 for the OpenMP
+    default.
+  */
+  unsigned int getNbParallelThreads() const { return nbThreads; }
   const vpImage<int> &getPrimitiveIDs() const { return primitive_ids; }
+  /*!
+    \return The spacing in pixels between two rendered scanlines.
+  */
+  unsigned int getScanLineStep() const { return scanLineStep; }
+  /*!
+    \return The number of scanlines of a tile.
+  */
+  unsigned int getTileSize() const { return tileSize; }
+  /*!
+    \return True if the tiles are rendered concurrently.
+  */
+  bool getUseParallel() const { return useParallel; }
+  /*!
+    \return True if the last call to drawScene() reused the previous
+    rendering, see setIncrementalThreshold().
+  */
+  bool isSceneReused() const { return sceneReused; }
 
   void queryLineVisibility(const vpPoint &a, const vpPoint &b, std::vector<std::pair<vpPoint, vpPoint> > &lines,
                            const bool &displayResults = false);
@@ -169,25 +229,49 @@ public:
 
     \param treshold : New Threshold.
   */
-  void setDepthTreshold(const double &treshold) { depthTreshold = treshold; }
-  void setMaskBorder(const unsigned int &mb) { maskBorder = mb; }
+  void setDepthTreshold(const double &treshold)
+  {
+    referenceValid = referenceValid && (treshold == depthTreshold);
+    depthTreshold = treshold;
+  }
+  void setIncrementalThreshold(double threshold);
+  void setMaskBorder(const unsigned int &mb)
+  {
+    referenceValid = referenceValid && (mb == maskBorder);
+    maskBorder = mb;
+  }
+  /*!
+    Set the number of threads used to render the tiles when
+    setUseParallel() is enabled.
+
+    \param nb : Number of threads, 0 to use the OpenMP default.
+  */
+  void setNbParallelThreads(unsigned int nb) { nbThreads = nb; }
+  void setScanLineStep(unsigned int step);
+  void setTileSize(unsigned int size);
+  void setUseParallel(bool parallel);
 
 private:
+  void buildEdgeTable(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > *> &polygons,
+                      const std::vector<int> &listPolyIndices, const vpCameraParameters &cam);
+
   void createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
                                  std::vector<std::vector<vpMbScanLineSegment> > &localScanlines,
-                                 const unsigned int &size);
+                                 unsigned int first, unsigned int last, unsigned int offset);
+
+  void drawLineY(size_t edge, const int ID, std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
+                 unsigned int begin, unsigned int end, unsigned int offset, unsigned int &first, unsigned int &last);
 
-  void drawLineY(const vpColVector &a, const vpColVector &b, const vpMbScanLineEdge &line_ID, const int ID,
-                 std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  void drawLineX(size_t edge, const int ID, std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
+                 unsigned int begin, unsigned int end, unsigned int offset, unsigned int &first, unsigned int &last);
 
-  void drawLineX(const vpColVector &a, const vpColVector &b, const vpMbScanLineEdge &line_ID, const int ID,
-                 std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  bool isCloseToReference() const;
 
-  void drawPolygonY(const std::vector<std::pair<vpPoint, unsigned int> > &polygon, const int ID,
-                    std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  void renderTileY(unsigned int begin, unsigned int end, std::vector<std::vector<vpMbScanLineSegment> > &local,
+                   std::vector<std::pair<int, int> > &samples);
 
-  void drawPolygonX(const std::vector<std::pair<vpPoint, unsigned int> > &polygon, const int ID,
-                    std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  void renderTileX(unsigned int begin, unsigned int end, std::vector<std::vector<vpMbScanLineSegment> > &local,
+                   std::vector<std::pair<int, int> > &samples);
 
   // Static functions
   static vpMbScanLineEdge makeMbScanLineEdge(const vpPoint &a, const vpPoint &b);
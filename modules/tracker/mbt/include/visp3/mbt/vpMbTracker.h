@@ -60,6 +60,7 @@
 #include <visp3/core/vpRGBa.h>
 #include <visp3/core/vpRobust.h>
 #include <visp3/mbt/vpMbHiddenFaces.h>
+#include <visp3/mbt/vpMbtCadModel.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 
 #include <visp3/mbt/vpMbtDistanceCircle.h>
@@ -596,11 +597,87 @@ public:
 
   virtual void setScanLineVisibilityTest(const bool &v) { useScanLine = v; }
 
+  /*!
+    Set the number of threads used to render the scanline visibility when
+    setUseParallelScanLine() is enabled.
+
+    \param nb : Number of threads, 0 to use the OpenMP default.
+  */
+  virtual void setNbParallelScanLineThreads(unsigned int nb) { faces.getMbScanLineRenderer().setNbParallelThreads(nb); }
+
+  /*!
+    Enable the incremental scanline rendering: the rendering of the previous
+    call is reused as long as the visible polygons are the same and none of
+    their projected vertices moved by more than \e threshold pixels. This
+    mostly saves the renderings between two iterations of the pose
+    estimation, the visibility is then approximated by the one of the
+    previous rendering.
+
+    \param threshold : Displacement in pixels, 0 (the default) to render the
+    scene every time.
+  */
+  virtual void setScanLineIncrementalThreshold(double threshold)
+  {
+    faces.getMbScanLineRenderer().setIncrementalThreshold(threshold);
+  }
+
+  /*!
+    Set polygons that do not belong to the model but hide it in the scanline
+    visibility test, for instance the faces of another tracked object. They
+    are rendered with the faces of the model: the moving edges, KLT points
+    and depth features hidden by an occluder are discarded.
+
+    \param occluders : Clipped polygons expressed in the camera frame, see
+    vpPolygon3D::getPolygonClipped(), an empty vector to remove them. They
+    are used until the next call.
+
+    \note This option requires setScanLineVisibilityTest().
+  */
+  virtual void setScanLineOccluders(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > > &occluders)
+  {
+    faces.setScanLineOccluders(occluders);
+  }
+
+  /*!
+    Only render one scanline every \e step pixels for the scanline
+    visibility test. The visibility is coarser, edges shorter than \e step
+    pixels may be considered as hidden.
+
+    \param step : Spacing in pixels between two rendered scanlines, 1 (the
+    default) to render all of them.
+  */
+  virtual void setScanLineStep(unsigned int step) { faces.getMbScanLineRenderer().setScanLineStep(step); }
+
+  /*!
+    Enable the concurrent rendering of the scanline visibility. The image is
+    split in tiles of scanlines rendered independently, the result is the
+    same as the sequential rendering.
+
+    \param parallel : True to render the tiles concurrently.
+
+    \note This option requires OpenMP and C++11 support.
+  */
+  virtual void setUseParallelScanLine(bool parallel) { faces.getMbScanLineRenderer().setUseParallel(parallel); }
+
   virtual void setOgreVisibilityTest(const bool &v);
 
+  /*!
+    Enable/Disable the ray casting visibility test, which does not require
+    Ogre3D. A face is then visible only if it is in the field of view and if
+    it is not hidden by another face. The faces of the model are organised in
+    a bounding volume hierarchy, so that this test remains fast for models
+    with many faces.
+
+    \sa vpMbHiddenFaces::setRayCastingVisibilityTest(),
+    setNbRayCastingAttemptsForVisibility(), setGoodNbRayCastingAttemptsRatio()
+
+    \param v : True to use the ray casting visibility test. It is not used when
+    the Ogre visibility test is enabled.
+  */
+  virtual void setRayCastingVisibilityTest(bool v) { faces.setRayCastingVisibilityTest(v); }
+
   void savePose(const std::string &filename) const;
 
-#ifdef VISP_HAVE_OGRE
   /*!
     Set the ratio of visibility attempts that has to be successful to consider
     a polygon as visible.
@@ -624,7 +701,6 @@ public:
   {
     faces.setNbRayCastingAttemptsForVisibility(attempts);
   }
-#endif
 
   /*!
     Enable/Disable the appearance of Ogre config dialog on startup.
@@ -805,6 +881,9 @@ protected:
                                         vpColVector &R, const vpColVector &error, vpColVector &error_prev,
                                         vpColVector &LTR, double &mu, vpColVector &v, const vpColVector *const w = NULL,
                                         vpColVector *const m_w_prev = NULL);
+  void computeVVSPoseEstimation(const bool isoJoIdentity_, unsigned int iter, const vpMatrix &LTL,
+                                const vpColVector &LTR, const vpColVector &error, vpColVector &error_prev, double &mu,
+                                vpColVector &v, double svThreshold = 0.);
   virtual void computeVVSWeights(vpRobust &robust, const vpColVector &error, vpColVector &w);
 
 #ifdef VISP_HAVE_COIN3D
@@ -878,6 +957,8 @@ protected:
   */
   virtual void initFaceFromCorners(vpMbtPolygon &polygon) = 0;
   virtual void initFaceFromLines(vpMbtPolygon &polygon) = 0;
+  void initFromCadModel(const vpMbtCadModel &model, int &startIdFace,
+                        const vpHomogeneousMatrix &odTo = vpHomogeneousMatrix());
 
   void initProjectionErrorCircle(const vpPoint &p1, const vpPoint &p2, const vpPoint &p3, double radius,
                                  int idFace = 0, const std::string &name = "");
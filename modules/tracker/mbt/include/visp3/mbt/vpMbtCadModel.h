@@ -0,0 +1,193 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * CAD model description in the cao and binary formats.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtCadModel.h
+  \brief CAD model description in the cao and binary formats.
+*/
+
+#ifndef vpMbtCadModel_HH
+#define vpMbtCadModel_HH
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpPoint.h>
+
+/*!
+  \class vpMbtCadModel
+  \ingroup group_mbt_faces
+
+  \brief Description of a CAD model as the ordered list of the primitives a
+  model-based tracker creates when loading it.
+
+  The model is read from a text cao file with loadCAO(), whose format is
+  described in vpMbTracker::loadCAOModel(). The files included with
+  \c load() are flattened: their points are expressed in the frame of the
+  main file and their primitives come first, as when the tracker loads them.
+
+  The model can be saved in a compact binary file with saveBinary() and read
+  back with loadBinary(). The binary file stores the points, the point
+  indexes of the primitives, the cylinder and circle radii, the names and the
+  level of detail settings in flat arrays: loading it maps the file in memory
+  and copies these arrays, without any text parsing. Binary files have the
+  \c .bcao extension and can be given to vpMbTracker::loadModel():
+  \code
+#include <visp3/mbt/vpMbGenericTracker.h>
+#include <visp3/mbt/vpMbtCadModel.h>
+
+int main()
+{
+  // Once, offline
+  vpMbtCadModel model;
+  model.loadCAO("object.cao");
+  model.saveBinary("object.bcao");
+
+  // At each start of the application
+  vpMbGenericTracker tracker;
+  tracker.loadModel("object.bcao");
+}
+  \endcode
+
+  The level of detail settings that are not given in the cao file are not
+  stored: they are taken from the tracker when the model is loaded, as with
+  the cao file.
+*/
+class VISP_EXPORT vpMbtCadModel
+{
+public:
+  //! Kind of primitive, in the order of the sections of a cao file
+  typedef enum {
+    POLYGON_FROM_LINES,  ///< Face given by the indexes of its lines, the points are stored by pairs
+    LINE,                ///< Line that is not used by a face given by its lines
+    POLYGON_FROM_POINTS, ///< Face given by the indexes of its corners
+    CYLINDER,            ///< Cylinder given by the two points of its axis and its radius
+    CIRCLE               ///< Circle given by its center, two other points of its plane and its radius
+  } vpPrimitiveType;
+
+  //! Primitive of the model
+  struct vpPrimitive {
+    vpPrimitive()
+      : type(POLYGON_FROM_POINTS), first(0), nbPoints(0), radius(0.0), hasLod(false), useLod(false),
+        hasThreshold(false), threshold(0.0), name()
+    {
+    }
+
+    //! Kind of primitive
+    vpPrimitiveType type;
+    //! First point index of the primitive in getPointIndexes()
+    unsigned int first;
+    //! Number of point indexes of the primitive
+    unsigned int nbPoints;
+    //! Radius of a cylinder or a circle
+    double radius;
+    //! True if the level of detail activation is given in the model
+    bool hasLod;
+    //! Level of detail activation, if given in the model
+    bool useLod;
+    //! True if the level of detail threshold is given in the model
+    bool hasThreshold;
+    //! Minimal line length (lines and cylinders) or polygon area (faces and
+    //! circles) threshold, if given in the model
+    double threshold;
+    //! Name of the primitive, may be empty
+    std::string name;
+  };
+
+  vpMbtCadModel();
+
+  void appendCAO(const std::string &modelFile, std::vector<std::string> &vectorOfModelFilename, bool verbose,
+                 bool parent, const vpHomogeneousMatrix &oTo = vpHomogeneousMatrix());
+  void clear();
+
+  //! \return The number of circles declared in the cao files.
+  inline unsigned int getNbCircles() const { return m_nbCircles; }
+  //! \return The number of cylinders declared in the cao files.
+  inline unsigned int getNbCylinders() const { return m_nbCylinders; }
+  //! \return The number of lines declared in the cao files.
+  inline unsigned int getNbLines() const { return m_nbLines; }
+  //! \return The number of points of the model.
+  inline unsigned int getNbPoints() const { return static_cast<unsigned int>(m_points.size() / 3); }
+  //! \return The number of faces given by their corners in the cao files.
+  inline unsigned int getNbPolygonPoints() const { return m_nbPolygonPoints; }
+  //! \return The number of faces given by their lines in the cao files.
+  inline unsigned int getNbPolygonLines() const { return m_nbPolygonLines; }
+  //! \return The number of primitives.
+  inline unsigned int getNbPrimitives() const { return static_cast<unsigned int>(m_primitives.size()); }
+
+  //! \return The point indexes of all the primitives.
+  inline const std::vector<unsigned int> &getPointIndexes() const { return m_indexes; }
+  //! \return The coordinates of the points in the model frame, stored as x, y, z triplets.
+  inline const std::vector<double> &getPoints() const { return m_points; }
+  //! \return The primitive of index \e i.
+  inline const vpPrimitive &getPrimitive(unsigned int i) const { return m_primitives[i]; }
+
+  static bool isBinary(const std::string &modelFile);
+
+  void loadBinary(const std::string &modelFile);
+  void loadCAO(const std::string &modelFile, bool verbose = false);
+
+  void saveBinary(const std::string &modelFile) const;
+
+private:
+  void addPrimitive(vpPrimitiveType type, const std::vector<unsigned int> &indexes, double radius,
+                    const std::map<std::string, std::string> &mapOfParams, const std::string &thresholdName);
+  void parseBinary(const unsigned char *data, size_t size);
+
+  static std::map<std::string, std::string> parseParameters(std::string &endLine);
+  static void removeComment(std::ifstream &fileId);
+
+  //! Points coordinates, x, y, z for each point
+  std::vector<double> m_points;
+  //! Point indexes of the primitives
+  std::vector<unsigned int> m_indexes;
+  //! Primitives in the order they are created by the tracker
+  std::vector<vpPrimitive> m_primitives;
+  //! Number of lines declared in the cao files
+  unsigned int m_nbLines;
+  //! Number of faces given by their lines in the cao files
+  unsigned int m_nbPolygonLines;
+  //! Number of faces given by their corners in the cao files
+  unsigned int m_nbPolygonPoints;
+  //! Number of cylinders declared in the cao files
+  unsigned int m_nbCylinders;
+  //! Number of circles declared in the cao files
+  unsigned int m_nbCircles;
+};
+
+#endif
@@ -41,7 +41,7 @@
 
 #include <visp3/core/vpConfig.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
 #include <map>
 
@@ -51,6 +51,7 @@
 #include <visp3/core/vpGEMM.h>
 #include <visp3/core/vpPlane.h>
 #include <visp3/core/vpPolygon3D.h>
+#include <visp3/klt/vpKlt.h>
 #include <visp3/klt/vpKltOpencv.h>
 #include <visp3/mbt/vpMbHiddenFaces.h>
 #include <visp3/vision/vpHomography.h>
@@ -61,7 +62,8 @@
   \brief Implementation of a polygon of the model containing points of
   interest. It is used by the model-based tracker KLT, and hybrid.
 
-  \warning This class is only available if OpenCV is installed, and used.
+  \warning When OpenCV is not available, the KLT points are tracked with the
+  native vpKlt tracker instead of vpKltOpencv.
 
   \ingroup group_mbt_features
 */
@@ -137,7 +139,11 @@ public:
 
   void buildFrom(const vpPoint &p1, const vpPoint &p2, const double &r);
 
+#if defined(VISP_HAVE_OPENCV)
   unsigned int computeNbDetectedCurrent(const vpKltOpencv &_tracker);
+#else
+  unsigned int computeNbDetectedCurrent(const vpKlt &_tracker);
+#endif
   void computeInteractionMatrixAndResidu(const vpHomogeneousMatrix &cMc0, vpColVector &_R, vpMatrix &_J);
 
   void display(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
@@ -195,7 +201,11 @@ public:
   */
   inline bool isTracked() const { return isTrackedKltCylinder; }
 
+#if defined(VISP_HAVE_OPENCV)
   void init(const vpKltOpencv &_tracker, const vpHomogeneousMatrix &cMo);
+#else
+  void init(const vpKlt &_tracker, const vpHomogeneousMatrix &cMo);
+#endif
 
   void removeOutliers(const vpColVector &weight, const double &threshold_outlier);
 
@@ -213,7 +223,9 @@ public:
   */
   inline void setTracked(const bool &track) { this->isTrackedKltCylinder = track; }
 
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+  void updateMask(vpImage<unsigned char> &mask, unsigned char _nb = 255, unsigned int _shiftBorder = 0);
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   void updateMask(cv::Mat &mask, unsigned char _nb = 255, unsigned int _shiftBorder = 0);
 #else
   void updateMask(IplImage *mask, unsigned char _nb = 255, unsigned int _shiftBorder = 0);
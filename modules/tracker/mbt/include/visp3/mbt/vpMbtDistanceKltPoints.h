@@ -42,14 +42,16 @@
 
 #include <visp3/core/vpConfig.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
 #include <map>
+#include <vector>
 
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpGEMM.h>
 #include <visp3/core/vpPlane.h>
 #include <visp3/core/vpPolygon3D.h>
+#include <visp3/klt/vpKlt.h>
 #include <visp3/klt/vpKltOpencv.h>
 #include <visp3/mbt/vpMbHiddenFaces.h>
 #include <visp3/vision/vpHomography.h>
@@ -60,7 +62,8 @@
   \brief Implementation of a polygon of the model containing points of
   interest. It is used by the model-based tracker KLT, and hybrid.
 
-  \warning This class is only available if OpenCV is installed, and used.
+  \warning When OpenCV is not available, the KLT points are tracked with the
+  native vpKlt tracker instead of vpKltOpencv.
 
   \ingroup group_mbt_features
 */
@@ -100,6 +103,14 @@ private:
   vpCameraParameters cam;
   //! Boolean to specify if the klt points have to be tracked or not
   bool isTrackedKltPoints;
+  //! x coordinates in meter of the current points, in the order of curPoints
+  std::vector<double> m_xCur;
+  //! y coordinates in meter of the current points, in the order of curPoints
+  std::vector<double> m_yCur;
+  //! x coordinates in meter of the initial points, in the order of curPoints
+  std::vector<double> m_xInit;
+  //! y coordinates in meter of the initial points, in the order of curPoints
+  std::vector<double> m_yInit;
 
 public:
   //! Pointer to the polygon that define a face
@@ -113,6 +124,7 @@ private:
   double compute_1_over_Z(double x, double y);
   void computeP_mu_t(double x_in, double y_in, double &x_out, double &y_out, const vpMatrix &cHc0);
   bool isTrackedFeature(int id);
+  void updateFeatureArrays();
 
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -137,7 +149,11 @@ public:
   vpMbtDistanceKltPoints();
   virtual ~vpMbtDistanceKltPoints();
 
+#if defined(VISP_HAVE_OPENCV)
   unsigned int computeNbDetectedCurrent(const vpKltOpencv &_tracker, const vpImage<bool> *mask = NULL);
+#else
+  unsigned int computeNbDetectedCurrent(const vpKlt &_tracker, const vpImage<bool> *mask = NULL);
+#endif
   void computeHomography(const vpHomogeneousMatrix &_cTc0, vpHomography &cHc0);
   void computeInteractionMatrixAndResidu(vpColVector &_R, vpMatrix &_J);
 
@@ -190,7 +206,11 @@ public:
 
   inline bool hasEnoughPoints() const { return enoughPoints; }
 
+#if defined(VISP_HAVE_OPENCV)
   void init(const vpKltOpencv &_tracker, const vpImage<bool> *mask = NULL);
+#else
+  void init(const vpKlt &_tracker, const vpImage<bool> *mask = NULL);
+#endif
 
   /*!
    Return if the klt points are used for tracking.
@@ -206,7 +226,11 @@ public:
 
     \param _cam : the new camera parameters
   */
-  virtual inline void setCameraParameters(const vpCameraParameters &_cam) { cam = _cam; }
+  virtual inline void setCameraParameters(const vpCameraParameters &_cam)
+  {
+    cam = _cam;
+    updateFeatureArrays();
+  }
 
   /*!
     Set if the klt points have to considered during tracking phase.
@@ -215,7 +239,9 @@ public:
   */
   inline void setTracked(const bool &track) { this->isTrackedKltPoints = track; }
 
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+  void updateMask(vpImage<unsigned char> &mask, unsigned char _nb = 255, unsigned int _shiftBorder = 0);
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   void updateMask(cv::Mat &mask, unsigned char _nb = 255, unsigned int _shiftBorder = 0);
 #else
   void updateMask(IplImage *mask, unsigned char _nb = 255, unsigned int _shiftBorder = 0);
@@ -259,6 +259,8 @@ public:
   */
   void setVisible(bool _isvisible) { isvisible = _isvisible; }
 
+  void shiftMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo);
+
   void trackMovingEdge(const vpImage<unsigned char> &I);
 
   void updateMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo);
@@ -44,6 +44,7 @@
 #include <pcl/point_types.h>
 #endif
 
+#include <visp3/core/vpMatrixf.h>
 #include <visp3/core/vpPlane.h>
 #include <visp3/mbt/vpMbTracker.h>
 #include <visp3/mbt/vpMbtDistanceLine.h>
@@ -109,6 +110,10 @@ public:
   );
 
   void computeInteractionMatrixAndResidu(const vpHomogeneousMatrix &cMo, vpMatrix &L, vpColVector &error);
+  void computeInteractionMatrixAndResidu(const vpHomogeneousMatrix &cMo, vpMatrixf &L, vpColVector &error);
+  void computeNormalEquations(const vpHomogeneousMatrix &cMo, const double *w, const double *error, vpMatrix &LTL,
+                              vpColVector &LTR);
+  void computeResidu(const vpHomogeneousMatrix &cMo, double *error);
 
   void computeVisibility();
   void computeVisibilityDisplay();
@@ -61,6 +61,7 @@ public:
   enum vpFeatureEstimationType {
     ROBUST_FEATURE_ESTIMATION = 0,
     ROBUST_SVD_PLANE_ESTIMATION = 1,
+    MOMENT_PLANE_ESTIMATION = 3, ///< Robust plane fit from the first and second moments of the points, without PCL
 #ifdef VISP_HAVE_PCL
     PCL_PLANE_ESTIMATION = 2
 #endif
@@ -278,6 +279,9 @@ protected:
                                             const std::vector<double> &point_cloud_face, const vpHomogeneousMatrix &cMo,
                                             vpColVector &desired_features, vpColVector &desired_normal,
                                             vpColVector &centroid_point);
+  void computeDesiredFeaturesMoments(const std::vector<double> &point_cloud_face, const vpHomogeneousMatrix &cMo,
+                                     vpColVector &desired_features, vpColVector &desired_normal,
+                                     vpColVector &centroid_point);
   void computeDesiredFeaturesSVD(const std::vector<double> &point_cloud_face, const vpHomogeneousMatrix &cMo,
                                  vpColVector &desired_features, vpColVector &desired_normal,
                                  vpColVector &centroid_point);
@@ -297,6 +301,9 @@ protected:
   void estimateFeatures(const std::vector<double> &point_cloud_face, const vpHomogeneousMatrix &cMo,
                         vpColVector &x_estimated, std::vector<double> &weights);
 
+  void estimatePlaneEquationMoments(const std::vector<double> &point_cloud_face, const vpHomogeneousMatrix &cMo,
+                                    vpColVector &plane_equation_estimated, vpColVector &centroid);
+
   void estimatePlaneEquationSVD(const std::vector<double> &point_cloud_face, const vpHomogeneousMatrix &cMo,
                                 vpColVector &plane_equation_estimated, vpColVector &centroid);
 
@@ -110,6 +110,8 @@ public:
   void initTracking(const vpImage<unsigned char> &I, const vpImagePoint &ip1, const vpImagePoint &ip2, double rho,
                     double theta, bool doNoTrack);
 
+  void shiftSites(const vpImage<unsigned char> &I, double rho, double theta);
+
   void track(const vpImage<unsigned char> &I);
 
   void updateParameters(const vpImage<unsigned char> &I, double rho, double theta);
@@ -0,0 +1,183 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Tracking of several objects in the same camera with shared preprocessing.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtMultiObjectTracker.h
+  \brief Tracking of several objects in the same camera with shared
+  preprocessing.
+*/
+
+#ifndef vpMbtMultiObjectTracker_HH
+#define vpMbtMultiObjectTracker_HH
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+#include <visp3/me/vpMeGradientLookup.h>
+
+/*!
+  \class vpMbtMultiObjectTracker
+  \ingroup group_mbt_trackers
+
+  \brief Track several objects seen by the same camera, each one with its
+  own vpMbGenericTracker, sharing the per-frame products of the image.
+
+  Tracking the objects with independent trackers converts the color image
+  and convolves the moving-edge masks once per object. This class owns the
+  products shared by the objects:
+  - the grey level image, converted once per frame;
+  - the moving-edge mask responses, stored in a vpMeGradientLookup updated
+    once per frame and read by all the objects, see
+    setUseSharedGradientLookup();
+  - the point cloud, given once and read by all the objects.
+
+  The pose of each object is then estimated independently, concurrently when
+  setUseParallelTracking() is enabled.
+
+  With setUseOcclusionHandling(), the objects hide each other: before the
+  tracking of a frame, the visible faces of every object are clipped at its
+  current pose, and the scanline visibility test of each object renders them
+  with its own faces (see vpMbTracker::setScanLineOccluders()). The moving
+  edges, KLT points and depth points of an object hidden by another object
+  are discarded.
+
+  The trackers are created by addObject() with a single camera and are
+  configured, loaded and initialized through getTracker():
+  \code
+#include <visp3/mbt/vpMbtMultiObjectTracker.h>
+
+int main()
+{
+  vpMbtMultiObjectTracker tracker;
+  tracker.addObject("box");
+  tracker.addObject("cylinder");
+  tracker.getTracker("box").loadModel("box.cao");
+  tracker.getTracker("cylinder").loadModel("cylinder.cao");
+  tracker.setCameraParameters(vpCameraParameters(600, 600, 320, 240));
+  tracker.setUseOcclusionHandling(true);
+  tracker.setUseParallelTracking(true);
+
+  vpImage<unsigned char> I;
+  // ... acquire I and initialize the trackers with getTracker("box").initFromPose(), ...
+
+  while (true) {
+    // ... acquire I
+    tracker.track(I);
+    if (tracker.isTracked("box")) {
+      std::cout << "Pose of the box:\n" << tracker.getPose("box") << std::endl;
+    }
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpMbtMultiObjectTracker
+{
+public:
+  vpMbtMultiObjectTracker();
+  virtual ~vpMbtMultiObjectTracker();
+
+  vpMbGenericTracker &addObject(const std::string &name, int trackerType = vpMbGenericTracker::EDGE_TRACKER);
+
+  /*!
+    \return The grey level image of the last frame, shared by the objects.
+  */
+  inline const vpImage<unsigned char> &getImage() const { return m_I; }
+  //! \return The number of objects.
+  inline unsigned int getNbObjects() const { return static_cast<unsigned int>(m_mapOfTrackers.size()); }
+  std::vector<std::string> getObjectNames() const;
+  vpHomogeneousMatrix getPose(const std::string &name) const;
+  vpMbGenericTracker &getTracker(const std::string &name);
+  //! \return True if the objects hide each other.
+  inline bool getUseOcclusionHandling() const { return m_useOcclusionHandling; }
+  //! \return True if the objects are tracked concurrently.
+  inline bool getUseParallelTracking() const { return m_useParallelTracking; }
+  //! \return True if the moving-edge mask responses are shared by the objects.
+  inline bool getUseSharedGradientLookup() const { return m_useSharedGradientLookup; }
+
+  bool isTracked(const std::string &name) const;
+
+  void removeObject(const std::string &name);
+
+  void setCameraParameters(const vpCameraParameters &cam);
+  /*!
+    Set the number of threads used by setUseParallelTracking().
+
+    \param nb : Number of threads, 0 to use the OpenMP default.
+  */
+  inline void setNbParallelThreads(unsigned int nb) { m_nbParallelThreads = nb; }
+  void setUseOcclusionHandling(bool use);
+  void setUseParallelTracking(bool parallel);
+  void setUseSharedGradientLookup(bool use);
+
+  void track(const vpImage<unsigned char> &I);
+  void track(const vpImage<vpRGBa> &I_color);
+  void track(const vpImage<unsigned char> &I, const std::vector<vpColVector> &pointcloud, unsigned int width,
+             unsigned int height);
+  void track(const vpImage<vpRGBa> &I_color, const std::vector<vpColVector> &pointcloud, unsigned int width,
+             unsigned int height);
+
+private:
+  vpMbtMultiObjectTracker(const vpMbtMultiObjectTracker &);            // noncopyable
+  vpMbtMultiObjectTracker &operator=(const vpMbtMultiObjectTracker &); //
+
+  void computeOccluders(vpMbGenericTracker &tracker,
+                        std::vector<std::vector<std::pair<vpPoint, unsigned int> > > &occluders) const;
+  void trackObjects(const vpImage<unsigned char> &I, const std::vector<vpColVector> *pointcloud, unsigned int width,
+                    unsigned int height);
+
+  //! Tracker of each object
+  std::map<std::string, vpMbGenericTracker *> m_mapOfTrackers;
+  //! Tracking status of each object at the last frame
+  std::map<std::string, bool> m_mapOfTrackingStatus;
+  //! Grey level image of the last color frame
+  vpImage<unsigned char> m_I;
+  //! Moving-edge mask responses shared by the objects
+  vpMeGradientLookup m_gradientLookup;
+  //! If true, the objects hide each other
+  bool m_useOcclusionHandling;
+  //! If true, the objects are tracked concurrently
+  bool m_useParallelTracking;
+  //! Number of threads used to track the objects, 0 to use the OpenMP default
+  unsigned int m_nbParallelThreads;
+  //! If true, the moving-edge mask responses are shared by the objects
+  bool m_useSharedGradientLookup;
+};
+
+#endif
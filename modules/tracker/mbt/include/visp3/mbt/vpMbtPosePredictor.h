@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Motion model based prediction of the pose of a model-based tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtPosePredictor.h
+  \brief Motion model based prediction of the pose of a model-based tracker.
+*/
+
+#ifndef vpMbtPosePredictor_HH
+#define vpMbtPosePredictor_HH
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+
+/*!
+  \class vpMbtPosePredictor
+  \ingroup group_mbt_trackers
+
+  \brief Prediction of the pose of the next frame from the poses estimated on
+  the previous frames.
+
+  The motion of the camera between two frames is described by the twist
+  \f$ {\bf v} \f$ of the camera expressed in the camera frame, given by
+  vpExponentialMap::inverse(). With the constant velocity model, the twist
+  estimated between the two last frames is applied to the last pose:
+  \f[ {^{c}}{\bf M}_o(k+1) = \exp({\bf v}_k \, \Delta t_{k+1})^{-1} \;
+  {^{c}}{\bf M}_o(k) \f]
+  With the constant acceleration model, the twist is extrapolated from the
+  two last twists before being applied.
+
+  An external measure of the twist, given by an IMU or the robot odometry,
+  can be fused with the model with setExternalVelocity().
+
+  The time between the frames is given with setTimestamp(). Without
+  timestamps the frames are supposed to be evenly spaced and the twists are
+  expressed per frame.
+
+  vpMbGenericTracker uses a predictor, see
+  vpMbGenericTracker::getPosePredictor(): the predicted pose is the initial
+  guess of the pose estimation, which reduces the number of iterations of
+  the virtual visual servoing and allows a smaller moving-edges search range
+  (vpMe::setRange()) when the motion is fast but regular.
+
+  The predictor keeps statistics on the tracked frames: the number of
+  iterations of the pose estimation and the mean distance of the estimated
+  pose to the predicted pose and to the pose of the previous frame, which
+  measures what the prediction saves.
+*/
+class VISP_EXPORT vpMbtPosePredictor
+{
+public:
+  //! Motion model
+  typedef enum {
+    NO_PREDICTION,        ///< The pose of the previous frame is kept
+    CONSTANT_VELOCITY,    ///< The last twist is applied to the last pose
+    CONSTANT_ACCELERATION ///< The twist extrapolated from the two last twists is applied to the last pose
+  } vpPredictionModel;
+
+  vpMbtPosePredictor();
+
+  //! \return The mean number of iterations of the pose estimation per frame.
+  inline double getMeanIterations() const
+  {
+    return m_nbFrames > 0 ? m_nbIterations / static_cast<double>(m_nbFrames) : 0.0;
+  }
+  void getMeanMotion(double &translation, double &rotation) const;
+  void getMeanPredictionError(double &translation, double &rotation) const;
+  //! \return The number of frames given to update().
+  inline unsigned int getNbFrames() const { return m_nbFrames; }
+  //! \return The total number of iterations of the pose estimation given to update().
+  inline unsigned int getNbIterations() const { return m_nbIterations; }
+  //! \return The number of frames whose pose was predicted.
+  inline unsigned int getNbPredictions() const { return m_nbPredictions; }
+  //! \return The motion model.
+  inline vpPredictionModel getPredictionModel() const { return m_model; }
+
+  bool predict(const vpHomogeneousMatrix &cMo, vpHomogeneousMatrix &cMo_pred);
+
+  void reset();
+  void resetStatistics();
+
+  void setExternalVelocity(const vpColVector &c_v, double translationWeight = 1.0, double rotationWeight = 1.0);
+  /*!
+    Set the motion model.
+
+    \param model : Motion model, NO_PREDICTION disables the prediction.
+  */
+  inline void setPredictionModel(const vpPredictionModel &model) { m_model = model; }
+  void setTimestamp(double t);
+
+  void update(const vpHomogeneousMatrix &cMo, unsigned int nbIterations = 0);
+
+private:
+  //! Motion model
+  vpPredictionModel m_model;
+  //! Last pose given to update()
+  vpHomogeneousMatrix m_cMo;
+  //! Number of poses in the history, up to 3
+  unsigned int m_nbPoses;
+  //! Last twist of the camera
+  vpColVector m_v;
+  //! Twist of the camera before the last one
+  vpColVector m_v_prev;
+  //! Duration of the last motion
+  double m_dt;
+  //! Duration of the motion before the last one
+  double m_dt_prev;
+  //! Timestamp of the last pose
+  double m_time;
+  //! True if the timestamp of the next frame is given
+  bool m_hasNextTime;
+  //! Timestamp of the next frame
+  double m_nextTime;
+  //! External twist of the camera for the next frame
+  vpColVector m_v_ext;
+  //! Weights of the translational and rotational parts of the external twist
+  double m_extWeights[2];
+  //! True if an external twist is given for the next frame
+  bool m_hasExternalVelocity;
+  //! True if the pose of the next frame was predicted
+  bool m_hasPrediction;
+  //! Predicted pose of the next frame
+  vpHomogeneousMatrix m_cMo_pred;
+
+  //! Number of frames given to update()
+  unsigned int m_nbFrames;
+  //! Number of iterations given to update()
+  unsigned int m_nbIterations;
+  //! Number of frames whose pose was predicted
+  unsigned int m_nbPredictions;
+  //! Number of frames with a previous pose
+  unsigned int m_nbMotions;
+  //! Sum of the translation and rotation distances to the previous pose
+  double m_motion[2];
+  //! Sum of the translation and rotation distances to the predicted pose
+  double m_predictionError[2];
+};
+
+#endif
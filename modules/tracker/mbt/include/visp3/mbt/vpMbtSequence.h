@@ -0,0 +1,254 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Record and replay of the inputs of a model-based tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtSequence.h
+  \brief Record and replay of the inputs of a model-based tracker.
+*/
+
+#ifndef vpMbtSequence_HH
+#define vpMbtSequence_HH
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+
+/*!
+  \class vpMbtSequenceFrame
+  \ingroup group_mbt_trackers
+
+  \brief Inputs of a model-based tracker for one frame, as recorded by
+  vpMbtSequenceRecorder and read back by vpMbtSequencePlayer.
+
+  The images are given per camera name, a camera may have a grey level
+  image, a color image, a depth map and a point cloud. The reference pose,
+  when known, is the pose of the object in the reference camera frame.
+*/
+class VISP_EXPORT vpMbtSequenceFrame
+{
+public:
+  //! Timestamp of the frame in second, negative if none
+  double timestamp;
+  //! True if the reference pose cMo is known
+  bool hasPose;
+  //! Reference pose of the object, with respect to the reference camera
+  vpHomogeneousMatrix cMo;
+  //! Grey level images
+  std::map<std::string, vpImage<unsigned char> > images;
+  //! Color images
+  std::map<std::string, vpImage<vpRGBa> > colorImages;
+  //! Raw depth maps, see vpMbtSequencePlayer::getDepthScale()
+  std::map<std::string, vpImage<uint16_t> > depthImages;
+  //! Point clouds in meter, stored as float
+  std::map<std::string, std::vector<vpColVector> > pointClouds;
+  //! Width of the point clouds
+  std::map<std::string, unsigned int> pointCloudWidths;
+  //! Height of the point clouds
+  std::map<std::string, unsigned int> pointCloudHeights;
+
+  vpMbtSequenceFrame() : timestamp(-1.0), hasPose(false), cMo(), images(), colorImages(), depthImages(),
+    pointClouds(), pointCloudWidths(), pointCloudHeights()
+  {
+  }
+
+  void clear();
+};
+
+/*!
+  \class vpMbtSequenceRecorder
+  \ingroup group_mbt_trackers
+
+  \brief Record the inputs of a model-based tracker in a compact binary
+  sequence file, to replay them later with vpMbtSequencePlayer.
+
+  The file starts with the description of the setup: the model file, the
+  camera parameters, the transformations between the reference camera and
+  the other cameras and the scale of the depth maps. It is followed by the
+  frames, stored without compression: one byte per pixel for the grey level
+  images, three for the color images whose alpha channel is not stored, two
+  for the depth maps and three floats per point for the point clouds. All the
+  values are written in the byte order of the machine.
+
+  \code
+#include <visp3/mbt/vpMbtSequence.h>
+
+int main()
+{
+  std::map<std::string, vpCameraParameters> mapOfCameras;
+  mapOfCameras["Camera"] = vpCameraParameters(600, 600, 320, 240);
+  std::map<std::string, vpHomogeneousMatrix> mapOfTransformations;
+  mapOfTransformations["Camera"] = vpHomogeneousMatrix();
+
+  vpMbtSequenceRecorder recorder;
+  recorder.open("sequence.bseq", "object.cao", mapOfCameras, mapOfTransformations, "Camera");
+
+  vpMbtSequenceFrame frame;
+  while (true) {
+    // ... acquire frame.images["Camera"] and set the reference pose if known
+    recorder.record(frame);
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpMbtSequenceRecorder
+{
+public:
+  vpMbtSequenceRecorder();
+  virtual ~vpMbtSequenceRecorder();
+
+  void close();
+
+  //! \return The number of frames recorded since open().
+  inline unsigned int getNbFrames() const { return m_nbFrames; }
+  //! \return True if a sequence file is open.
+  inline bool isOpen() const { return m_file.is_open(); }
+
+  void open(const std::string &filename, const std::string &modelFile,
+            const std::map<std::string, vpCameraParameters> &mapOfCameraParameters,
+            const std::map<std::string, vpHomogeneousMatrix> &mapOfCameraTransformations,
+            const std::string &referenceCameraName, double depthScale = 0.001);
+
+  void record(const vpMbtSequenceFrame &frame);
+
+private:
+  vpMbtSequenceRecorder(const vpMbtSequenceRecorder &);            // noncopyable
+  vpMbtSequenceRecorder &operator=(const vpMbtSequenceRecorder &); //
+
+  //! Sequence file
+  std::ofstream m_file;
+  //! Number of recorded frames
+  unsigned int m_nbFrames;
+  //! Buffer of the frame being written
+  std::vector<char> m_buffer;
+};
+
+/*!
+  \class vpMbtSequencePlayer
+  \ingroup group_mbt_trackers
+
+  \brief Read back a sequence written by vpMbtSequenceRecorder.
+
+  open() reads the description of the setup and indexes the frames, which
+  can then be read in order with acquire() or at random with seek().
+
+  \code
+#include <visp3/mbt/vpMbGenericTracker.h>
+#include <visp3/mbt/vpMbtSequence.h>
+
+int main()
+{
+  vpMbtSequencePlayer player;
+  player.open("sequence.bseq");
+
+  vpMbGenericTracker tracker;
+  tracker.setCameraParameters(player.getCameraParameters()[player.getReferenceCameraName()]);
+  tracker.loadModel(player.getModelFile());
+
+  vpMbtSequenceFrame frame;
+  while (player.acquire(frame)) {
+    const vpImage<unsigned char> &I = frame.images[player.getReferenceCameraName()];
+    if (player.getFrameIndex() == 1) {
+      tracker.initFromPose(I, frame.cMo);
+    } else {
+      tracker.track(I);
+    }
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpMbtSequencePlayer
+{
+public:
+  vpMbtSequencePlayer();
+  virtual ~vpMbtSequencePlayer();
+
+  bool acquire(vpMbtSequenceFrame &frame);
+
+  void close();
+
+  //! \return The camera parameters of the cameras, by camera name.
+  inline std::map<std::string, vpCameraParameters> getCameraParameters() const { return m_mapOfCameraParameters; }
+  //! \return The transformations from the reference camera to the cameras, by camera name.
+  inline std::map<std::string, vpHomogeneousMatrix> getCameraTransformations() const
+  {
+    return m_mapOfCameraTransformations;
+  }
+  //! \return The scale from the raw depth values to meters.
+  inline double getDepthScale() const { return m_depthScale; }
+  //! \return The index of the next frame acquire() will read.
+  inline unsigned int getFrameIndex() const { return m_frameIndex; }
+  //! \return The model file given to the recorder.
+  inline std::string getModelFile() const { return m_modelFile; }
+  //! \return The number of frames of the sequence.
+  inline unsigned int getNbFrames() const { return static_cast<unsigned int>(m_frameOffsets.size()); }
+  //! \return The name of the reference camera.
+  inline std::string getReferenceCameraName() const { return m_referenceCameraName; }
+
+  void open(const std::string &filename);
+
+  void seek(unsigned int frameIndex);
+
+private:
+  vpMbtSequencePlayer(const vpMbtSequencePlayer &);            // noncopyable
+  vpMbtSequencePlayer &operator=(const vpMbtSequencePlayer &); //
+
+  //! Sequence file
+  std::ifstream m_file;
+  //! Model file given to the recorder
+  std::string m_modelFile;
+  //! Name of the reference camera
+  std::string m_referenceCameraName;
+  //! Camera parameters, by camera name
+  std::map<std::string, vpCameraParameters> m_mapOfCameraParameters;
+  //! Transformations from the reference camera, by camera name
+  std::map<std::string, vpHomogeneousMatrix> m_mapOfCameraTransformations;
+  //! Scale from the raw depth values to meters
+  double m_depthScale;
+  //! Position of the frames in the file
+  std::vector<std::streamoff> m_frameOffsets;
+  //! Index of the next frame to read
+  unsigned int m_frameIndex;
+  //! Buffer of the frame being read
+  std::vector<char> m_buffer;
+};
+
+#endif
@@ -0,0 +1,277 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Asynchronous pipelined front-end of the generic model-based tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtTrackingPipeline.h
+  \brief Asynchronous pipelined front-end of the generic model-based tracker.
+*/
+
+#ifndef vpMbtTrackingPipeline_HH
+#define vpMbtTrackingPipeline_HH
+
+#include <visp3/core/vpConfig.h>
+
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+#include <visp3/mbt/vpMbtTrackingStatistics.h>
+
+/*!
+  \class vpMbtTrackingPipeline
+  \ingroup group_mbt_trackers
+
+  \brief Asynchronous front-end of vpMbGenericTracker that overlaps the
+  preparation of a frame with the tracking of the previous one.
+
+  vpMbGenericTracker::track() is synchronous: the conversion of the color
+  images to grey level, the conversion of the depth maps to point clouds and
+  the pose estimation all run in the caller's thread. The pipeline splits
+  this work into two stages running in their own thread:
+  - the preprocessing stage converts the images of frame \e k+1;
+  - the tracking stage calls vpMbGenericTracker::track() on frame \e k.
+
+  push() copies the images of a frame in the input queue and returns
+  immediately a \c std::future holding the result of the tracking of this
+  frame. The throughput is therefore given by the slowest stage instead of
+  the sum of the stages.
+
+  The two queues are bounded. When a queue is full, push() either waits for
+  a free slot (BLOCK_WHEN_FULL) or drops the oldest frame of the queue
+  (DROP_STALE_FRAMES), the latter keeps the latency low when the frames
+  arrive faster than they are tracked. The result of a dropped frame is
+  marked with vpTrackingResult::dropped. When the frames are given a
+  timestamp, the timestamp is passed to the pose predictor (see
+  vpMbGenericTracker::getPosePredictor()), so that the predicted motion
+  accounts for the dropped frames.
+
+  An exception thrown while a frame is processed, for instance a
+  vpTrackingException when the object is lost, is rethrown by
+  \c std::future::get() for this frame.
+
+  The moving-edge gradient responses are computed lazily around the
+  projection of the predicted pose and the point cloud segmentation depends
+  on the pose, both stay in the tracking stage.
+
+  The tracker must be initialized before the pipeline is created and must
+  not be used directly while frames are pending. Call flush() to wait for
+  the pending frames, for instance before reinitializing the tracker.
+  \code
+#include <visp3/mbt/vpMbtTrackingPipeline.h>
+
+int main()
+{
+  vpMbGenericTracker tracker;
+  vpImage<vpRGBa> I;
+  // ... load the model, acquire I and initialize the tracker
+
+  vpMbtTrackingPipeline pipeline(tracker, 2, vpMbtTrackingPipeline::DROP_STALE_FRAMES);
+  std::future<vpMbtTrackingPipeline::vpTrackingResult> previous;
+  while (true) {
+    // ... acquire I
+    std::future<vpMbtTrackingPipeline::vpTrackingResult> current = pipeline.push(I);
+    if (previous.valid()) {
+      vpMbtTrackingPipeline::vpTrackingResult result = previous.get();
+      if (!result.dropped) {
+        std::cout << "Pose of frame " << result.frameIndex << ":\n" << result.cMo << std::endl;
+      }
+    }
+    previous = std::move(current);
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpMbtTrackingPipeline
+{
+public:
+  //! Behaviour of a full queue
+  typedef enum {
+    BLOCK_WHEN_FULL,  ///< Wait until the next stage takes a frame
+    DROP_STALE_FRAMES ///< Drop the oldest frame of the queue
+  } vpQueuePolicy;
+
+  //! Result of the tracking of a frame
+  class vpTrackingResult
+  {
+  public:
+    //! Index of the frame, in the order of the calls to push()
+    unsigned int frameIndex;
+    //! Timestamp given to push(), negative if none
+    double timestamp;
+    //! True if the frame was dropped and not tracked
+    bool dropped;
+    //! Estimated pose, with respect to the reference camera
+    vpHomogeneousMatrix cMo;
+    //! Projection error, see vpMbGenericTracker::getProjectionError()
+    double projectionError;
+    //! Time between push() and the end of the tracking, in milliseconds
+    double latency;
+    //! Statistics of the tracking, when enabled with vpMbGenericTracker::setUseTrackingStatistics()
+    vpMbtTrackingStatistics statistics;
+
+    vpTrackingResult()
+      : frameIndex(0), timestamp(-1.0), dropped(false), cMo(), projectionError(0.0), latency(0.0), statistics()
+    {
+    }
+  };
+
+  explicit vpMbtTrackingPipeline(vpMbGenericTracker &tracker, unsigned int queueSize = 2,
+                                 const vpQueuePolicy &policy = BLOCK_WHEN_FULL);
+  virtual ~vpMbtTrackingPipeline();
+
+  static void convertDepthToPointCloud(const vpImage<uint16_t> &I_depth, const vpCameraParameters &cam,
+                                       double depthScale, std::vector<vpColVector> &pointcloud);
+
+  void flush();
+
+  //! \return The scale from the raw depth values to meters.
+  inline double getDepthScale() const { return m_depthScale; }
+  double getMeanPreprocessingTime() const;
+  double getMeanTrackingTime() const;
+  unsigned int getNbDropped() const;
+  unsigned int getNbFailed() const;
+  unsigned int getNbPushed() const;
+  unsigned int getNbTracked() const;
+  //! \return The behaviour of a full queue.
+  inline vpQueuePolicy getQueuePolicy() const { return m_policy; }
+  //! \return The capacity of the queues.
+  inline unsigned int getQueueSize() const { return m_queueSize; }
+
+  std::future<vpTrackingResult> push(const vpImage<unsigned char> &I, double timestamp = -1.0);
+  std::future<vpTrackingResult> push(const vpImage<vpRGBa> &I_color, double timestamp = -1.0);
+  std::future<vpTrackingResult> push(const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                     const std::map<std::string, const vpImage<uint16_t> *> &mapOfDepthImages,
+                                     double timestamp = -1.0);
+  std::future<vpTrackingResult> push(const std::map<std::string, const vpImage<vpRGBa> *> &mapOfColorImages,
+                                     const std::map<std::string, const vpImage<uint16_t> *> &mapOfDepthImages,
+                                     double timestamp = -1.0);
+
+  void setDepthScale(double scale);
+
+private:
+  vpMbtTrackingPipeline(const vpMbtTrackingPipeline &);            // noncopyable
+  vpMbtTrackingPipeline &operator=(const vpMbtTrackingPipeline &); //
+
+  //! Images of a frame, as given to push() and once converted
+  struct vpFrame {
+    unsigned int index;
+    double timestamp;
+    double pushTime;
+    std::map<std::string, vpImage<unsigned char> > images;
+    std::map<std::string, vpImage<vpRGBa> > colorImages;
+    std::map<std::string, vpImage<uint16_t> > depthImages;
+    std::map<std::string, std::vector<vpColVector> > pointClouds;
+    std::map<std::string, unsigned int> depthWidths;
+    std::map<std::string, unsigned int> depthHeights;
+    std::promise<vpTrackingResult> promise;
+  };
+  typedef std::shared_ptr<vpFrame> vpFramePtr;
+
+  std::future<vpTrackingResult> enqueue(const vpFramePtr &frame);
+  void enqueueReady(const vpFramePtr &frame);
+  void drop(const vpFramePtr &frame);
+  void preprocess(vpFrame &frame, double depthScale) const;
+  void preprocessingLoop();
+  void trackingLoop();
+  void trackFrame(vpFrame &frame, vpTrackingResult &result);
+
+  //! Tracker driven by the pipeline
+  vpMbGenericTracker &m_tracker;
+  //! Name of the reference camera of the tracker
+  std::string m_referenceCameraName;
+  //! Camera parameters of the tracker, read at construction
+  std::map<std::string, vpCameraParameters> m_mapOfCameraParameters;
+  //! Scale from the raw depth values to meters
+  double m_depthScale;
+  //! Capacity of the queues
+  unsigned int m_queueSize;
+  //! Behaviour of a full queue
+  vpQueuePolicy m_policy;
+
+  //! Protects the queues and the counters
+  mutable std::mutex m_mutex;
+  //! Signaled when a frame enters the input queue
+  std::condition_variable m_inputCondition;
+  //! Signaled when a frame enters the queue of the preprocessed frames
+  std::condition_variable m_readyCondition;
+  //! Signaled when a slot of a queue is freed
+  std::condition_variable m_spaceCondition;
+  //! Signaled when the result of a frame is delivered
+  std::condition_variable m_doneCondition;
+  //! Frames waiting for the preprocessing
+  std::deque<vpFramePtr> m_inputQueue;
+  //! Preprocessed frames waiting for the tracking
+  std::deque<vpFramePtr> m_readyQueue;
+  //! True when the threads have to stop
+  bool m_stop;
+
+  //! Number of frames given to push()
+  unsigned int m_nbPushed;
+  //! Number of dropped frames
+  unsigned int m_nbDropped;
+  //! Number of tracked frames
+  unsigned int m_nbTracked;
+  //! Number of frames whose processing threw an exception
+  unsigned int m_nbFailed;
+  //! Cumulated time of the preprocessing stage, in milliseconds
+  double m_preprocessingTime;
+  //! Number of preprocessed frames
+  unsigned int m_nbPreprocessed;
+  //! Cumulated time of the tracking stage, in milliseconds
+  double m_trackingTime;
+
+  //! Point clouds of the last tracked frame, reused by the preprocessing stage
+  std::map<std::string, std::vector<vpColVector> > m_pointCloudPool;
+
+  //! Thread of the preprocessing stage
+  std::thread m_preprocessingThread;
+  //! Thread of the tracking stage
+  std::thread m_trackingThread;
+};
+
+#endif
+#endif
@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Timings and counters of a tracking step of a model-based tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtTrackingStatistics.h
+  \brief Timings and counters of a tracking step of a model-based tracker.
+*/
+
+#ifndef vpMbtTrackingStatistics_HH
+#define vpMbtTrackingStatistics_HH
+
+#include <iostream>
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpMbtTrackingStatistics
+  \ingroup group_mbt_trackers
+
+  \brief Timings and counters of one call to vpMbGenericTracker::track(),
+  for one camera or for all of them.
+
+  The statistics are filled only when enabled with
+  vpMbGenericTracker::setUseTrackingStatistics(). The times are wall times
+  in milliseconds, measured with vpTime::measureTimeMs(). When the cameras
+  are processed concurrently, the times of the cameras overlap and their sum
+  may exceed the time of the whole step.
+
+  A feature is counted as rejected when its robust weight at the last
+  iteration of the pose estimation is lower than 0.5. This includes the
+  moving edges that were lost by the tracking.
+*/
+class VISP_EXPORT vpMbtTrackingStatistics
+{
+public:
+  //! Time of the visibility test of the faces and of the scanline rendering
+  double visibilityTime;
+  //! Time of the moving-edges tracking, update and reinitialization
+  double edgeTime;
+  //! Time of the KLT points tracking and reinitialization
+  double kltTime;
+  //! Time of the point cloud segmentation for the depth normal features
+  double depthNormalTime;
+  //! Time of the point cloud segmentation for the dense depth features
+  double depthDenseTime;
+  //! Time of the computation of the interaction matrices and of the residuals
+  double jacobianTime;
+  //! Time of the robust weighting
+  double weightingTime;
+  //! Time of the resolution of the normal equations and of the pose update,
+  //! only for all the cameras
+  double solveTime;
+  //! Time of the whole tracking step, only for all the cameras
+  double totalTime;
+
+  //! Number of iterations of the pose estimation
+  unsigned int nbIterations;
+
+  //! Number of moving-edges features
+  unsigned int nbEdgeFeatures;
+  //! Number of rejected moving-edges features
+  unsigned int nbEdgeRejected;
+  //! Number of KLT features, two per point
+  unsigned int nbKltFeatures;
+  //! Number of rejected KLT features
+  unsigned int nbKltRejected;
+  //! Number of depth normal features, three per face
+  unsigned int nbDepthNormalFeatures;
+  //! Number of rejected depth normal features
+  unsigned int nbDepthNormalRejected;
+  //! Number of dense depth features
+  unsigned int nbDepthDenseFeatures;
+  //! Number of rejected dense depth features
+  unsigned int nbDepthDenseRejected;
+
+  //! Weighted residual norm at the first iteration of the pose estimation
+  double initialResidual;
+  //! Weighted residual norm at the last iteration of the pose estimation
+  double residual;
+
+  vpMbtTrackingStatistics()
+    : visibilityTime(0), edgeTime(0), kltTime(0), depthNormalTime(0), depthDenseTime(0), jacobianTime(0),
+      weightingTime(0), solveTime(0), totalTime(0), nbIterations(0), nbEdgeFeatures(0), nbEdgeRejected(0),
+      nbKltFeatures(0), nbKltRejected(0), nbDepthNormalFeatures(0), nbDepthNormalRejected(0),
+      nbDepthDenseFeatures(0), nbDepthDenseRejected(0), initialResidual(0), residual(0)
+  {
+  }
+
+  //! Reset all the timings and counters.
+  inline void reset() { *this = vpMbtTrackingStatistics(); }
+
+  //! \return The number of features used by the pose estimation.
+  inline unsigned int getNbFeatures() const
+  {
+    return nbEdgeFeatures + nbKltFeatures + nbDepthNormalFeatures + nbDepthDenseFeatures;
+  }
+  //! \return The number of rejected features.
+  inline unsigned int getNbRejected() const
+  {
+    return nbEdgeRejected + nbKltRejected + nbDepthNormalRejected + nbDepthDenseRejected;
+  }
+
+  /*!
+    Print the statistics.
+
+    \param os : Output stream.
+    \param stats : Statistics to print.
+  */
+  friend std::ostream &operator<<(std::ostream &os, const vpMbtTrackingStatistics &stats)
+  {
+    os << "Time (ms): total " << stats.totalTime << ", visibility " << stats.visibilityTime << ", edge "
+       << stats.edgeTime << ", klt " << stats.kltTime << ", depth normal " << stats.depthNormalTime
+       << ", depth dense " << stats.depthDenseTime << ", jacobian " << stats.jacobianTime << ", weighting "
+       << stats.weightingTime << ", solve " << stats.solveTime << "\n";
+    os << "Iterations: " << stats.nbIterations << ", residual: " << stats.initialResidual << " -> " << stats.residual
+       << "\n";
+    os << "Features (rejected): edge " << stats.nbEdgeFeatures << " (" << stats.nbEdgeRejected << "), klt "
+       << stats.nbKltFeatures << " (" << stats.nbKltRejected << "), depth normal " << stats.nbDepthNormalFeatures
+       << " (" << stats.nbDepthNormalRejected << "), depth dense " << stats.nbDepthDenseFeatures << " ("
+       << stats.nbDepthDenseRejected << ")";
+    return os;
+  }
+};
+
+#endif
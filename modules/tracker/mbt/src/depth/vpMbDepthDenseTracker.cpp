@@ -34,6 +34,7 @@
  *****************************************************************************/
 
 #include <iostream>
+#include <limits>
 
 #include <visp3/core/vpConfig.h>
 
@@ -52,10 +53,193 @@
 #include <visp3/gui/vpDisplayX.h>
 #endif
 
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+#include <exception>
+#include <omp.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+/*
+  Call task(i) for each of the nbFaces faces, concurrently if requested. A
+  face only modifies its own state and the rows of the stacked vectors and
+  matrices that belong to it, the result does not depend on the number of
+  threads.
+*/
+template <class Task> void runFaceTasks(Task &task, size_t nbFaces, bool parallel, unsigned int nbThreads)
+{
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (parallel && nbFaces > 1) {
+    // Exceptions cannot leave an OpenMP region, keep them by face to rethrow the one a sequential run would have
+    // raised
+    std::vector<std::exception_ptr> exceptions(nbFaces);
+    int nb_threads = nbThreads > 0 ? static_cast<int>(nbThreads) : omp_get_max_threads();
+    int nb_faces = static_cast<int>(nbFaces);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nb_threads)
+    for (int i = 0; i < nb_faces; i++) {
+      try {
+        task(static_cast<size_t>(i));
+      } catch (...) {
+        exceptions[static_cast<size_t>(i)] = std::current_exception();
+      }
+    }
+
+    for (size_t i = 0; i < exceptions.size(); i++) {
+      if (exceptions[i]) {
+        std::rethrow_exception(exceptions[i]);
+      }
+    }
+    return;
+  }
+#else
+  (void)parallel;
+  (void)nbThreads;
+#endif
+
+  for (size_t i = 0; i < nbFaces; i++) {
+    task(i);
+  }
+}
+
+// Index of the first row of each face in the stacked features
+void computeStartIndices(const std::vector<vpMbtFaceDepthDense *> &faces, std::vector<unsigned int> &startIndices)
+{
+  startIndices.resize(faces.size());
+  unsigned int start_index = 0;
+  for (size_t i = 0; i < faces.size(); i++) {
+    startIndices[i] = start_index;
+    start_index += faces[i]->getNbFeatures();
+  }
+}
+
+#if !DEBUG_DISPLAY_DEPTH_DENSE
+struct vpDesiredFeaturesTask {
+  vpDesiredFeaturesTask(const std::vector<vpMbtFaceDepthDense *> &faces_, const vpHomogeneousMatrix &cMo_,
+                        unsigned int width_, unsigned int height_, const std::vector<vpColVector> &point_cloud_,
+                        unsigned int stepX_, unsigned int stepY_, const vpImage<bool> *mask_,
+                        std::vector<unsigned char> &active_)
+    : faces(faces_), cMo(cMo_), width(width_), height(height_), point_cloud(point_cloud_), stepX(stepX_),
+      stepY(stepY_), mask(mask_), active(active_)
+  {
+  }
+
+  void operator()(size_t i)
+  {
+    active[i] = faces[i]->computeDesiredFeatures(cMo, width, height, point_cloud, stepX, stepY, mask) ? 1 : 0;
+  }
+
+  const std::vector<vpMbtFaceDepthDense *> &faces;
+  const vpHomogeneousMatrix &cMo;
+  unsigned int width, height;
+  const std::vector<vpColVector> &point_cloud;
+  unsigned int stepX, stepY;
+  const vpImage<bool> *mask;
+  std::vector<unsigned char> &active;
+};
+
+#ifdef VISP_HAVE_PCL
+struct vpDesiredFeaturesPclTask {
+  vpDesiredFeaturesPclTask(const std::vector<vpMbtFaceDepthDense *> &faces_, const vpHomogeneousMatrix &cMo_,
+                           const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud_, unsigned int stepX_,
+                           unsigned int stepY_, const vpImage<bool> *mask_, std::vector<unsigned char> &active_)
+    : faces(faces_), cMo(cMo_), point_cloud(point_cloud_), stepX(stepX_), stepY(stepY_), mask(mask_), active(active_)
+  {
+  }
+
+  void operator()(size_t i)
+  {
+    active[i] = faces[i]->computeDesiredFeatures(cMo, point_cloud, stepX, stepY, mask) ? 1 : 0;
+  }
+
+  const std::vector<vpMbtFaceDepthDense *> &faces;
+  const vpHomogeneousMatrix &cMo;
+  const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud;
+  unsigned int stepX, stepY;
+  const vpImage<bool> *mask;
+  std::vector<unsigned char> &active;
+};
+#endif
+#endif
+
+struct vpInteractionMatrixTask {
+  vpInteractionMatrixTask(const std::vector<vpMbtFaceDepthDense *> &faces_, const vpHomogeneousMatrix &cMo_,
+                          const std::vector<unsigned int> &startIndices_, vpMatrix *L_, vpMatrixf *Lf_,
+                          vpColVector &error_)
+    : faces(faces_), cMo(cMo_), startIndices(startIndices_), L(L_), Lf(Lf_), error(error_)
+  {
+  }
+
+  void operator()(size_t i)
+  {
+    vpColVector error_face;
+
+    if (Lf != NULL) {
+      vpMatrixf L_face;
+      faces[i]->computeInteractionMatrixAndResidu(cMo, L_face, error_face);
+      Lf->insert(L_face, startIndices[i], 0);
+    } else {
+      vpMatrix L_face;
+      faces[i]->computeInteractionMatrixAndResidu(cMo, L_face, error_face);
+      L->insert(L_face, startIndices[i], 0);
+    }
+
+    error.insert(startIndices[i], error_face);
+  }
+
+  const std::vector<vpMbtFaceDepthDense *> &faces;
+  const vpHomogeneousMatrix &cMo;
+  const std::vector<unsigned int> &startIndices;
+  vpMatrix *L;
+  vpMatrixf *Lf;
+  vpColVector &error;
+};
+
+struct vpResiduTask {
+  vpResiduTask(const std::vector<vpMbtFaceDepthDense *> &faces_, const vpHomogeneousMatrix &cMo_,
+               const std::vector<unsigned int> &startIndices_, vpColVector &error_)
+    : faces(faces_), cMo(cMo_), startIndices(startIndices_), error(error_)
+  {
+  }
+
+  void operator()(size_t i) { faces[i]->computeResidu(cMo, error.data + startIndices[i]); }
+
+  const std::vector<vpMbtFaceDepthDense *> &faces;
+  const vpHomogeneousMatrix &cMo;
+  const std::vector<unsigned int> &startIndices;
+  vpColVector &error;
+};
+
+struct vpNormalEquationsTask {
+  vpNormalEquationsTask(const std::vector<vpMbtFaceDepthDense *> &faces_, const vpHomogeneousMatrix &cMo_,
+                        const std::vector<unsigned int> &startIndices_, const vpColVector &w_,
+                        const vpColVector &error_, std::vector<vpMatrix> &LTL_, std::vector<vpColVector> &LTR_)
+    : faces(faces_), cMo(cMo_), startIndices(startIndices_), w(w_), error(error_), LTL(LTL_), LTR(LTR_)
+  {
+  }
+
+  void operator()(size_t i)
+  {
+    faces[i]->computeNormalEquations(cMo, w.data + startIndices[i], error.data + startIndices[i], LTL[i], LTR[i]);
+  }
+
+  const std::vector<vpMbtFaceDepthDense *> &faces;
+  const vpHomogeneousMatrix &cMo;
+  const std::vector<unsigned int> &startIndices;
+  const vpColVector &w;
+  const vpColVector &error;
+  std::vector<vpMatrix> &LTL;
+  std::vector<vpColVector> &LTR;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpMbDepthDenseTracker::vpMbDepthDenseTracker()
   : m_depthDenseHiddenFacesDisplay(), m_depthDenseListOfActiveFaces(),
     m_denseDepthNbFeatures(0), m_depthDenseFaces(), m_depthDenseSamplingStepX(2), m_depthDenseSamplingStepY(2),
-    m_error_depthDense(), m_L_depthDense(), m_robust_depthDense(), m_w_depthDense(), m_weightedError_depthDense()
+    m_error_depthDense(), m_L_depthDense(), m_Lf_depthDense(), m_useSinglePrecision_depthDense(false),
+    m_useFusedNormalEquations_depthDense(false), m_useParallel_depthDense(false), m_nbParallelThreads_depthDense(0),
+    m_robust_depthDense(), m_w_depthDense(), m_weightedError_depthDense()
 #if DEBUG_DISPLAY_DEPTH_DENSE
     ,
     m_debugDisp_depthDense(NULL), m_debugImage_depthDense()
@@ -167,7 +351,12 @@ void vpMbDepthDenseTracker::computeVVS()
   vpMatrix L_true, LVJ_true;
 
   while (std::fabs(normRes_1 - normRes) > m_stopCriteriaEpsilon && (iter < m_maxIter)) {
-    computeVVSInteractionMatrixAndResidu();
+    // With the fused normal equations, the interaction matrix is only needed to check its rank and for the covariance
+    if (!m_useFusedNormalEquations_depthDense || iter == 0 || computeCovariance) {
+      computeVVSInteractionMatrixAndResidu();
+    } else {
+      computeVVSResidu();
+    }
 
     bool reStartFromLastIncrement = false;
     computeVVSCheckLevenbergMarquardt(iter, m_error_depthDense, error_prev, cMo_prev, mu, reStartFromLastIncrement);
@@ -176,10 +365,10 @@ void vpMbDepthDenseTracker::computeVVS()
       computeVVSWeights();
 
       if (computeCovariance) {
-        L_true = m_L_depthDense;
+        L_true = m_useSinglePrecision_depthDense ? m_Lf_depthDense.toMatrix() : m_L_depthDense;
         if (!isoJoIdentity_) {
           cVo.buildFrom(m_cMo);
-          LVJ_true = (m_L_depthDense * cVo * oJo);
+          LVJ_true = (L_true * cVo * oJo);
         }
       }
 
@@ -196,7 +385,8 @@ void vpMbDepthDenseTracker::computeVVS()
           cVo.buildFrom(m_cMo);
 
           vpMatrix K; // kernel
-          unsigned int rank = (m_L_depthDense * cVo).kernel(K);
+          unsigned int rank = m_useSinglePrecision_depthDense ? (m_Lf_depthDense.toMatrix() * cVo).kernel(K)
+                                                              : (m_L_depthDense * cVo).kernel(K);
           if (rank == 0) {
             throw vpException(vpException::fatalError, "Rank=0, cannot estimate the pose !");
           }
@@ -212,20 +402,43 @@ void vpMbDepthDenseTracker::computeVVS()
       }
 
       double num = 0.0, den = 0.0;
-      for (unsigned int i = 0; i < m_L_depthDense.getRows(); i++) {
+      for (unsigned int i = 0; i < m_denseDepthNbFeatures; i++) {
         // Compute weighted errors and stop criteria
         m_weightedError_depthDense[i] = m_w_depthDense[i] * m_error_depthDense[i];
         num += m_w_depthDense[i] * vpMath::sqr(m_error_depthDense[i]);
         den += m_w_depthDense[i];
+      }
 
+      if (m_useFusedNormalEquations_depthDense) {
+        computeVVSNormalEquations(LTL, LTR);
+        computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error_depthDense, error_prev, mu, v);
+      } else if (m_useSinglePrecision_depthDense) {
         // weight interaction matrix
-        for (unsigned int j = 0; j < 6; j++) {
-          m_L_depthDense[i][j] *= m_w_depthDense[i];
+        for (unsigned int i = 0; i < m_denseDepthNbFeatures; i++) {
+          const float w = static_cast<float>(m_w_depthDense[i]);
+          for (unsigned int j = 0; j < 6; j++) {
+            m_Lf_depthDense[i][j] *= w;
+          }
         }
-      }
 
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L_depthDense, LTL, m_weightedError_depthDense,
-                               m_error_depthDense, error_prev, LTR, mu, v);
+        // Normal equations accumulated in double precision, the threshold of the pseudo-inverse accounts for the
+        // rounding of the interaction matrix
+        m_Lf_depthDense.AtA(LTL);
+        m_Lf_depthDense.AtB(m_weightedError_depthDense, LTR);
+        const double float_eps = std::numeric_limits<float>::epsilon();
+        computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error_depthDense, error_prev, mu, v,
+                                 float_eps * float_eps);
+      } else {
+        // weight interaction matrix
+        for (unsigned int i = 0; i < m_denseDepthNbFeatures; i++) {
+          for (unsigned int j = 0; j < 6; j++) {
+            m_L_depthDense[i][j] *= m_w_depthDense[i];
+          }
+        }
+
+        computeVVSPoseEstimation(isoJoIdentity_, iter, m_L_depthDense, LTL, m_weightedError_depthDense,
+                                 m_error_depthDense, error_prev, LTR, mu, v);
+      }
 
       cMo_prev = m_cMo;
       m_cMo = vpExponentialMap::direct(v).inverse() * m_cMo;
@@ -250,7 +463,11 @@ void vpMbDepthDenseTracker::computeVVSInit()
     m_denseDepthNbFeatures += face->getNbFeatures();
   }
 
-  m_L_depthDense.resize(m_denseDepthNbFeatures, 6, false, false);
+  if (m_useSinglePrecision_depthDense) {
+    m_Lf_depthDense.resize(m_denseDepthNbFeatures, 6, false, false);
+  } else {
+    m_L_depthDense.resize(m_denseDepthNbFeatures, 6, false, false);
+  }
   m_error_depthDense.resize(m_denseDepthNbFeatures, false);
   m_weightedError_depthDense.resize(m_denseDepthNbFeatures, false);
 
@@ -260,23 +477,55 @@ void vpMbDepthDenseTracker::computeVVSInit()
 
 void vpMbDepthDenseTracker::computeVVSInteractionMatrixAndResidu()
 {
-  unsigned int start_index = 0;
-  for (std::vector<vpMbtFaceDepthDense *>::const_iterator it = m_depthDenseListOfActiveFaces.begin();
-       it != m_depthDenseListOfActiveFaces.end(); ++it) {
-    vpMbtFaceDepthDense *face = *it;
+  std::vector<unsigned int> startIndices;
+  computeStartIndices(m_depthDenseListOfActiveFaces, startIndices);
 
-    vpMatrix L_face;
-    vpColVector error;
-
-    face->computeInteractionMatrixAndResidu(m_cMo, L_face, error);
+  vpInteractionMatrixTask task(m_depthDenseListOfActiveFaces, m_cMo, startIndices,
+                               m_useSinglePrecision_depthDense ? NULL : &m_L_depthDense,
+                               m_useSinglePrecision_depthDense ? &m_Lf_depthDense : NULL, m_error_depthDense);
+  runFaceTasks(task, m_depthDenseListOfActiveFaces.size(), m_useParallel_depthDense, m_nbParallelThreads_depthDense);
+}
 
-    m_error_depthDense.insert(start_index, error);
-    m_L_depthDense.insert(L_face, start_index, 0);
+/*!
+  Accumulate the weighted normal equations face by face, see
+  vpMbtFaceDepthDense::computeNormalEquations(). The contributions of the
+  faces are summed in the order of the faces, the result does not depend on
+  the number of threads.
 
-    start_index += error.getRows();
+  \param LTL : \f$ {\bf L}^T {\bf W}^2 {\bf L} \f$.
+  \param LTR : \f$ {\bf L}^T {\bf W}^2 {\bf e} \f$.
+*/
+void vpMbDepthDenseTracker::computeVVSNormalEquations(vpMatrix &LTL, vpColVector &LTR)
+{
+  std::vector<unsigned int> startIndices;
+  computeStartIndices(m_depthDenseListOfActiveFaces, startIndices);
+
+  std::vector<vpMatrix> LTL_faces(m_depthDenseListOfActiveFaces.size());
+  std::vector<vpColVector> LTR_faces(m_depthDenseListOfActiveFaces.size());
+  vpNormalEquationsTask task(m_depthDenseListOfActiveFaces, m_cMo, startIndices, m_w_depthDense, m_error_depthDense,
+                             LTL_faces, LTR_faces);
+  runFaceTasks(task, m_depthDenseListOfActiveFaces.size(), m_useParallel_depthDense, m_nbParallelThreads_depthDense);
+
+  LTL.resize(6, 6, true, false);
+  LTR.resize(6, true);
+  for (size_t i = 0; i < LTL_faces.size(); i++) {
+    LTL += LTL_faces[i];
+    LTR += LTR_faces[i];
   }
 }
 
+/*!
+  Compute the residuals of the active faces without the interaction matrix.
+*/
+void vpMbDepthDenseTracker::computeVVSResidu()
+{
+  std::vector<unsigned int> startIndices;
+  computeStartIndices(m_depthDenseListOfActiveFaces, startIndices);
+
+  vpResiduTask task(m_depthDenseListOfActiveFaces, m_cMo, startIndices, m_error_depthDense);
+  runFaceTasks(task, m_depthDenseListOfActiveFaces.size(), m_useParallel_depthDense, m_nbParallelThreads_depthDense);
+}
+
 void vpMbDepthDenseTracker::computeVVSWeights()
 {
   m_robust_depthDense.MEstimator(m_error_depthDense, m_w_depthDense, 1e-3);
@@ -555,29 +804,40 @@ void vpMbDepthDenseTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXY
   std::vector<std::vector<vpImagePoint> > roiPts_vec;
 #endif
 
+#if DEBUG_DISPLAY_DEPTH_DENSE
   for (std::vector<vpMbtFaceDepthDense *>::iterator it = m_depthDenseFaces.begin();
        it != m_depthDenseFaces.end(); ++it) {
     vpMbtFaceDepthDense *face = *it;
 
     if (face->isVisible() && face->isTracked()) {
-#if DEBUG_DISPLAY_DEPTH_DENSE
       std::vector<std::vector<vpImagePoint> > roiPts_vec_;
-#endif
-      if (face->computeDesiredFeatures(m_cMo, point_cloud, m_depthDenseSamplingStepX, m_depthDenseSamplingStepY
-#if DEBUG_DISPLAY_DEPTH_DENSE
-                                       ,
-                                       m_debugImage_depthDense, roiPts_vec_
-#endif
-                                       , m_mask
-                                       )) {
+      if (face->computeDesiredFeatures(m_cMo, point_cloud, m_depthDenseSamplingStepX, m_depthDenseSamplingStepY,
+                                       m_debugImage_depthDense, roiPts_vec_, m_mask)) {
         m_depthDenseListOfActiveFaces.push_back(*it);
-
-#if DEBUG_DISPLAY_DEPTH_DENSE
         roiPts_vec.insert(roiPts_vec.end(), roiPts_vec_.begin(), roiPts_vec_.end());
-#endif
       }
     }
   }
+#else
+  std::vector<vpMbtFaceDepthDense *> faces;
+  for (std::vector<vpMbtFaceDepthDense *>::iterator it = m_depthDenseFaces.begin();
+       it != m_depthDenseFaces.end(); ++it) {
+    if ((*it)->isVisible() && (*it)->isTracked()) {
+      faces.push_back(*it);
+    }
+  }
+
+  std::vector<unsigned char> active(faces.size(), 0);
+  vpDesiredFeaturesPclTask task(faces, m_cMo, point_cloud, m_depthDenseSamplingStepX, m_depthDenseSamplingStepY,
+                                m_mask, active);
+  runFaceTasks(task, faces.size(), m_useParallel_depthDense, m_nbParallelThreads_depthDense);
+
+  for (size_t i = 0; i < faces.size(); i++) {
+    if (active[i]) {
+      m_depthDenseListOfActiveFaces.push_back(faces[i]);
+    }
+  }
+#endif
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
   vpDisplay::display(m_debugImage_depthDense);
@@ -613,30 +873,40 @@ void vpMbDepthDenseTracker::segmentPointCloud(const std::vector<vpColVector> &po
   std::vector<std::vector<vpImagePoint> > roiPts_vec;
 #endif
 
+#if DEBUG_DISPLAY_DEPTH_DENSE
   for (std::vector<vpMbtFaceDepthDense *>::iterator it = m_depthDenseFaces.begin();
        it != m_depthDenseFaces.end(); ++it) {
     vpMbtFaceDepthDense *face = *it;
 
     if (face->isVisible() && face->isTracked()) {
-#if DEBUG_DISPLAY_DEPTH_DENSE
       std::vector<std::vector<vpImagePoint> > roiPts_vec_;
-#endif
       if (face->computeDesiredFeatures(m_cMo, width, height, point_cloud, m_depthDenseSamplingStepX,
-                                       m_depthDenseSamplingStepY
-#if DEBUG_DISPLAY_DEPTH_DENSE
-                                       ,
-                                       m_debugImage_depthDense, roiPts_vec_
-#endif
-                                       , m_mask
-                                       )) {
+                                       m_depthDenseSamplingStepY, m_debugImage_depthDense, roiPts_vec_, m_mask)) {
         m_depthDenseListOfActiveFaces.push_back(*it);
-
-#if DEBUG_DISPLAY_DEPTH_DENSE
         roiPts_vec.insert(roiPts_vec.end(), roiPts_vec_.begin(), roiPts_vec_.end());
-#endif
       }
     }
   }
+#else
+  std::vector<vpMbtFaceDepthDense *> faces;
+  for (std::vector<vpMbtFaceDepthDense *>::iterator it = m_depthDenseFaces.begin();
+       it != m_depthDenseFaces.end(); ++it) {
+    if ((*it)->isVisible() && (*it)->isTracked()) {
+      faces.push_back(*it);
+    }
+  }
+
+  std::vector<unsigned char> active(faces.size(), 0);
+  vpDesiredFeaturesTask task(faces, m_cMo, width, height, point_cloud, m_depthDenseSamplingStepX,
+                             m_depthDenseSamplingStepY, m_mask, active);
+  runFaceTasks(task, faces.size(), m_useParallel_depthDense, m_nbParallelThreads_depthDense);
+
+  for (size_t i = 0; i < faces.size(); i++) {
+    if (active[i]) {
+      m_depthDenseListOfActiveFaces.push_back(faces[i]);
+    }
+  }
+#endif
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
   vpDisplay::display(m_debugImage_depthDense);
@@ -708,6 +978,33 @@ void vpMbDepthDenseTracker::setUseDepthDenseTracking(const std::string &name, co
   }
 }
 
+/*!
+  Enable the concurrent processing of the faces when the point cloud is
+  segmented and when the residuals, the interaction matrix or the normal
+  equations are computed. Each face only fills its own rows, the tracking
+  result is thus the same as the sequential one.
+
+  \param parallel : True to process the faces concurrently.
+
+  \note This option requires OpenMP and C++11 support, otherwise the faces
+  are processed sequentially.
+
+  \sa setNbParallelDepthDenseThreads()
+*/
+void vpMbDepthDenseTracker::setUseParallelDepthDense(bool parallel)
+{
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  m_useParallel_depthDense = parallel;
+#else
+  if (parallel) {
+    std::cerr << "Parallel dense depth tracking requires OpenMP and C++11 support, the faces are processed "
+                 "sequentially."
+              << std::endl;
+  }
+  m_useParallel_depthDense = false;
+#endif
+}
+
 void vpMbDepthDenseTracker::testTracking() {}
 
 void vpMbDepthDenseTracker::track(const vpImage<unsigned char> &)
@@ -194,7 +194,11 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
     return false;
   }
 
-  m_pointCloudFace.reserve((size_t)(bb.getWidth() * bb.getHeight()));
+  // At most one point per sample of the bounding box, with 3 coordinates each
+  if (right > left && bottom > top) {
+    m_pointCloudFace.reserve(3 * (size_t)((right - left + stepX - 1) / stepX) *
+                             (size_t)((bottom - top + stepY - 1) / stepY));
+  }
 
   bool checkSSE2 = vpCPUFeatures::checkSSE2();
 #if !USE_SSE
@@ -317,7 +321,11 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
   bb.setLeft(left);
   bb.setRight(right);
 
-  m_pointCloudFace.reserve((size_t)(bb.getWidth() * bb.getHeight()));
+  // At most one point per sample of the bounding box, with 3 coordinates each
+  if (right > left && bottom > top) {
+    m_pointCloudFace.reserve(3 * (size_t)((right - left + stepX - 1) / stepX) *
+                             (size_t)((bottom - top + stepY - 1) / stepY));
+  }
 
   bool checkSSE2 = vpCPUFeatures::checkSSE2();
 #if !USE_SSE
@@ -327,41 +335,49 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
   double prev_x = 0.0, prev_y = 0.0, prev_z = 0.0;
 #endif
 
+  // The scan line buffer and the image size do not change inside the face, keep them out of the sampling loop
+  const vpImage<int> *primitiveIDs = m_useScanLine ? &m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs() : NULL;
+  const unsigned int idsHeight = primitiveIDs != NULL ? primitiveIDs->getHeight() : 0;
+  const unsigned int idsWidth = primitiveIDs != NULL ? primitiveIDs->getWidth() : 0;
+  const int polygonIndex = m_polygon->getIndex();
+
   int totalTheoreticalPoints = 0, totalPoints = 0;
   for (unsigned int i = top; i < bottom; i += stepY) {
+    const vpColVector *point_cloud_row = &point_cloud[i * width];
+    const int *ids_row = (primitiveIDs != NULL && i < idsHeight) ? (*primitiveIDs)[i] : NULL;
+
     for (unsigned int j = left; j < right; j += stepX) {
-      if ((m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
+      if ((m_useScanLine ? (ids_row != NULL && j < idsWidth && ids_row[j] == polygonIndex)
                          : polygon_2d.isInside(vpImagePoint(i, j)))) {
         totalTheoreticalPoints++;
 
-        if (vpMeTracker::inMask(mask, i, j) && point_cloud[i * width + j][2] > 0) {
+        const double *pt = point_cloud_row[j].data;
+        if (vpMeTracker::inMask(mask, i, j) && pt[2] > 0) {
           totalPoints++;
 
           if (checkSSE2) {
 #if USE_SSE
             if (!push) {
               push = true;
-              prev_x = point_cloud[i * width + j][0];
-              prev_y = point_cloud[i * width + j][1];
-              prev_z = point_cloud[i * width + j][2];
+              prev_x = pt[0];
+              prev_y = pt[1];
+              prev_z = pt[2];
             } else {
               push = false;
               m_pointCloudFace.push_back(prev_x);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][0]);
+              m_pointCloudFace.push_back(pt[0]);
 
               m_pointCloudFace.push_back(prev_y);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][1]);
+              m_pointCloudFace.push_back(pt[1]);
 
               m_pointCloudFace.push_back(prev_z);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][2]);
+              m_pointCloudFace.push_back(pt[2]);
             }
 #endif
           } else {
-            m_pointCloudFace.push_back(point_cloud[i * width + j][0]);
-            m_pointCloudFace.push_back(point_cloud[i * width + j][1]);
-            m_pointCloudFace.push_back(point_cloud[i * width + j][2]);
+            m_pointCloudFace.push_back(pt[0]);
+            m_pointCloudFace.push_back(pt[1]);
+            m_pointCloudFace.push_back(pt[2]);
           }
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
@@ -575,6 +591,307 @@ void vpMbtFaceDepthDense::computeInteractionMatrixAndResidu(const vpHomogeneousM
   }
 }
 
+/*!
+  Compute the interaction matrix in single precision and the residual in
+  double precision. The rows are computed in double precision before being
+  rounded to float, so that only the storage (and the following normal
+  equations product) is affected by the reduced precision.
+*/
+void vpMbtFaceDepthDense::computeInteractionMatrixAndResidu(const vpHomogeneousMatrix &cMo, vpMatrixf &L,
+                                                            vpColVector &error)
+{
+  if (m_pointCloudFace.empty()) {
+    L.resize(0, 0);
+    error.resize(0);
+    return;
+  }
+
+  L.resize(getNbFeatures(), 6, false, false);
+  error.resize(getNbFeatures(), false);
+
+  // Transform the plane equation for the current pose
+  m_planeCamera = m_planeObject;
+  m_planeCamera.changeFrame(cMo);
+
+  double nx = m_planeCamera.getA();
+  double ny = m_planeCamera.getB();
+  double nz = m_planeCamera.getC();
+  double D = m_planeCamera.getD();
+
+  const float nxf = static_cast<float>(nx);
+  const float nyf = static_cast<float>(ny);
+  const float nzf = static_cast<float>(nz);
+
+  bool checkSSE2 = vpCPUFeatures::checkSSE2();
+#if !USE_SSE
+  checkSSE2 = false;
+#endif
+
+  float *ptr_L = L.data;
+  double *ptr_error = error.data;
+  size_t cpt = 0;
+
+  if (checkSSE2) {
+#if USE_SSE
+    // The points are gathered by pairs, x0 x1 y0 y1 z0 z1, the last point of an odd count is stored as x y z
+    const __m128d vnx = _mm_set1_pd(nx);
+    const __m128d vny = _mm_set1_pd(ny);
+    const __m128d vnz = _mm_set1_pd(nz);
+    const __m128d vd = _mm_set1_pd(D);
+
+    float tmp_a1[4], tmp_a2[4], tmp_a3[4];
+
+    for (; cpt + 6 <= m_pointCloudFace.size(); cpt += 6) {
+      const double *ptr_point_cloud = &m_pointCloudFace[cpt];
+      const __m128d vx = _mm_loadu_pd(ptr_point_cloud);
+      const __m128d vy = _mm_loadu_pd(ptr_point_cloud + 2);
+      const __m128d vz = _mm_loadu_pd(ptr_point_cloud + 4);
+
+      const __m128d va1 = _mm_sub_pd(_mm_mul_pd(vnz, vy), _mm_mul_pd(vny, vz));
+      const __m128d va2 = _mm_sub_pd(_mm_mul_pd(vnx, vz), _mm_mul_pd(vnz, vx));
+      const __m128d va3 = _mm_sub_pd(_mm_mul_pd(vny, vx), _mm_mul_pd(vnx, vy));
+
+      _mm_storeu_ps(tmp_a1, _mm_cvtpd_ps(va1));
+      _mm_storeu_ps(tmp_a2, _mm_cvtpd_ps(va2));
+      _mm_storeu_ps(tmp_a3, _mm_cvtpd_ps(va3));
+
+      for (unsigned int k = 0; k < 2; k++) {
+        *ptr_L++ = nxf;
+        *ptr_L++ = nyf;
+        *ptr_L++ = nzf;
+        *ptr_L++ = tmp_a1[k];
+        *ptr_L++ = tmp_a2[k];
+        *ptr_L++ = tmp_a3[k];
+      }
+
+      const __m128d verror =
+          _mm_add_pd(_mm_add_pd(vd, _mm_mul_pd(vnx, vx)), _mm_add_pd(_mm_mul_pd(vny, vy), _mm_mul_pd(vnz, vz)));
+      _mm_storeu_pd(ptr_error, verror);
+      ptr_error += 2;
+    }
+#endif
+  }
+
+  for (; cpt < m_pointCloudFace.size(); cpt += 3) {
+    double x = m_pointCloudFace[cpt];
+    double y = m_pointCloudFace[cpt + 1];
+    double z = m_pointCloudFace[cpt + 2];
+
+    // L
+    *ptr_L++ = nxf;
+    *ptr_L++ = nyf;
+    *ptr_L++ = nzf;
+    *ptr_L++ = static_cast<float>((nz * y) - (ny * z));
+    *ptr_L++ = static_cast<float>((nx * z) - (nz * x));
+    *ptr_L++ = static_cast<float>((ny * x) - (nx * y));
+
+    // Error
+    *ptr_error++ = D + nx * x + ny * y + nz * z;
+  }
+}
+
+/*!
+  Accumulate the weighted normal equations of the face without building its
+  interaction matrix.
+
+  The rows of the interaction matrix share the plane normal \f$ {\bf n} \f$,
+  \f$ {\bf L}_i = ({\bf n}^T, {\bf a}_i^T) \f$ with \f$ {\bf a}_i = {\bf
+  p}_i \times {\bf n} \f$. The \f$ 6 \times 6 \f$ matrix \f$ \sum_i w_i^2
+  {\bf L}_i^T {\bf L}_i \f$ and the vector \f$ \sum_i w_i^2 e_i {\bf L}_i^T
+  \f$ are thus obtained from 14 sums over the points, \f$ \sum w_i^2 \f$,
+  \f$ \sum w_i^2 {\bf a}_i \f$, \f$ \sum w_i^2 {\bf a}_i {\bf a}_i^T \f$,
+  \f$ \sum w_i^2 e_i \f$ and \f$ \sum w_i^2 e_i {\bf a}_i \f$, accumulated in
+  double precision. The summation order only depends on the face, the result
+  is the same whatever the thread that processes the face.
+
+  \param cMo : Pose used to express the plane of the face in the camera frame.
+  \param w : Pointer to the getNbFeatures() robust weights of the face.
+  \param error : Pointer to the getNbFeatures() residuals of the face, see
+  computeResidu().
+  \param LTL : \f$ 6 \times 6 \f$ normal matrix of the face.
+  \param LTR : 6-dim right-hand side of the face.
+*/
+void vpMbtFaceDepthDense::computeNormalEquations(const vpHomogeneousMatrix &cMo, const double *w,
+                                                 const double *error, vpMatrix &LTL, vpColVector &LTR)
+{
+  LTL.resize(6, 6, true, false);
+  LTR.resize(6, true);
+
+  if (m_pointCloudFace.empty()) {
+    return;
+  }
+
+  // Transform the plane equation for the current pose
+  m_planeCamera = m_planeObject;
+  m_planeCamera.changeFrame(cMo);
+
+  const double n[3] = {m_planeCamera.getA(), m_planeCamera.getB(), m_planeCamera.getC()};
+
+  // sum(w2), sum(w2 a) (3), upper part of sum(w2 a a^T) (6), sum(w2 e), sum(w2 e a) (3)
+  double sums[14] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+  bool checkSSE2 = vpCPUFeatures::checkSSE2();
+#if !USE_SSE
+  checkSSE2 = false;
+#endif
+
+  size_t cpt = 0, idx = 0;
+
+  if (checkSSE2) {
+#if USE_SSE
+    // The points are gathered by pairs, x0 x1 y0 y1 z0 z1, the last point of an odd count is stored as x y z
+    const __m128d vnx = _mm_set1_pd(n[0]);
+    const __m128d vny = _mm_set1_pd(n[1]);
+    const __m128d vnz = _mm_set1_pd(n[2]);
+
+    __m128d vsums[14];
+    for (unsigned int k = 0; k < 14; k++) {
+      vsums[k] = _mm_setzero_pd();
+    }
+
+    for (; cpt + 6 <= m_pointCloudFace.size(); cpt += 6, idx += 2) {
+      const double *ptr_point_cloud = &m_pointCloudFace[cpt];
+      const __m128d vx = _mm_loadu_pd(ptr_point_cloud);
+      const __m128d vy = _mm_loadu_pd(ptr_point_cloud + 2);
+      const __m128d vz = _mm_loadu_pd(ptr_point_cloud + 4);
+
+      const __m128d va1 = _mm_sub_pd(_mm_mul_pd(vnz, vy), _mm_mul_pd(vny, vz));
+      const __m128d va2 = _mm_sub_pd(_mm_mul_pd(vnx, vz), _mm_mul_pd(vnz, vx));
+      const __m128d va3 = _mm_sub_pd(_mm_mul_pd(vny, vx), _mm_mul_pd(vnx, vy));
+
+      const __m128d vw = _mm_loadu_pd(w + idx);
+      const __m128d vw2 = _mm_mul_pd(vw, vw);
+      const __m128d vw2a1 = _mm_mul_pd(vw2, va1);
+      const __m128d vw2a2 = _mm_mul_pd(vw2, va2);
+      const __m128d vw2a3 = _mm_mul_pd(vw2, va3);
+      const __m128d vw2e = _mm_mul_pd(vw2, _mm_loadu_pd(error + idx));
+
+      vsums[0] = _mm_add_pd(vsums[0], vw2);
+      vsums[1] = _mm_add_pd(vsums[1], vw2a1);
+      vsums[2] = _mm_add_pd(vsums[2], vw2a2);
+      vsums[3] = _mm_add_pd(vsums[3], vw2a3);
+      vsums[4] = _mm_add_pd(vsums[4], _mm_mul_pd(vw2a1, va1));
+      vsums[5] = _mm_add_pd(vsums[5], _mm_mul_pd(vw2a1, va2));
+      vsums[6] = _mm_add_pd(vsums[6], _mm_mul_pd(vw2a1, va3));
+      vsums[7] = _mm_add_pd(vsums[7], _mm_mul_pd(vw2a2, va2));
+      vsums[8] = _mm_add_pd(vsums[8], _mm_mul_pd(vw2a2, va3));
+      vsums[9] = _mm_add_pd(vsums[9], _mm_mul_pd(vw2a3, va3));
+      vsums[10] = _mm_add_pd(vsums[10], vw2e);
+      vsums[11] = _mm_add_pd(vsums[11], _mm_mul_pd(vw2e, va1));
+      vsums[12] = _mm_add_pd(vsums[12], _mm_mul_pd(vw2e, va2));
+      vsums[13] = _mm_add_pd(vsums[13], _mm_mul_pd(vw2e, va3));
+    }
+
+    double tmp[2];
+    for (unsigned int k = 0; k < 14; k++) {
+      _mm_storeu_pd(tmp, vsums[k]);
+      sums[k] = tmp[0] + tmp[1];
+    }
+#endif
+  }
+
+  for (; cpt < m_pointCloudFace.size(); cpt += 3, idx++) {
+    double x = m_pointCloudFace[cpt];
+    double y = m_pointCloudFace[cpt + 1];
+    double z = m_pointCloudFace[cpt + 2];
+
+    double a1 = (n[2] * y) - (n[1] * z);
+    double a2 = (n[0] * z) - (n[2] * x);
+    double a3 = (n[1] * x) - (n[0] * y);
+
+    double w2 = w[idx] * w[idx];
+    double w2a1 = w2 * a1, w2a2 = w2 * a2, w2a3 = w2 * a3;
+    double w2e = w2 * error[idx];
+
+    sums[0] += w2;
+    sums[1] += w2a1;
+    sums[2] += w2a2;
+    sums[3] += w2a3;
+    sums[4] += w2a1 * a1;
+    sums[5] += w2a1 * a2;
+    sums[6] += w2a1 * a3;
+    sums[7] += w2a2 * a2;
+    sums[8] += w2a2 * a3;
+    sums[9] += w2a3 * a3;
+    sums[10] += w2e;
+    sums[11] += w2e * a1;
+    sums[12] += w2e * a2;
+    sums[13] += w2e * a3;
+  }
+
+  // Translation block n n^T sum(w2), coupling block n sum(w2 a)^T, rotation block sum(w2 a a^T)
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 3; j++) {
+      LTL[i][j] = n[i] * n[j] * sums[0];
+      LTL[i][3 + j] = n[i] * sums[1 + j];
+      LTL[3 + j][i] = LTL[i][3 + j];
+    }
+    LTR[i] = n[i] * sums[10];
+    LTR[3 + i] = sums[11 + i];
+  }
+  LTL[3][3] = sums[4];
+  LTL[3][4] = LTL[4][3] = sums[5];
+  LTL[3][5] = LTL[5][3] = sums[6];
+  LTL[4][4] = sums[7];
+  LTL[4][5] = LTL[5][4] = sums[8];
+  LTL[5][5] = sums[9];
+}
+
+/*!
+  Compute the point-to-plane residuals of the face without its interaction
+  matrix, see computeNormalEquations().
+
+  \param cMo : Pose used to express the plane of the face in the camera frame.
+  \param error : Pointer to the getNbFeatures() residuals to fill.
+*/
+void vpMbtFaceDepthDense::computeResidu(const vpHomogeneousMatrix &cMo, double *error)
+{
+  if (m_pointCloudFace.empty()) {
+    return;
+  }
+
+  // Transform the plane equation for the current pose
+  m_planeCamera = m_planeObject;
+  m_planeCamera.changeFrame(cMo);
+
+  double nx = m_planeCamera.getA();
+  double ny = m_planeCamera.getB();
+  double nz = m_planeCamera.getC();
+  double D = m_planeCamera.getD();
+
+  bool checkSSE2 = vpCPUFeatures::checkSSE2();
+#if !USE_SSE
+  checkSSE2 = false;
+#endif
+
+  size_t cpt = 0;
+
+  if (checkSSE2) {
+#if USE_SSE
+    const __m128d vnx = _mm_set1_pd(nx);
+    const __m128d vny = _mm_set1_pd(ny);
+    const __m128d vnz = _mm_set1_pd(nz);
+    const __m128d vd = _mm_set1_pd(D);
+
+    for (; cpt + 6 <= m_pointCloudFace.size(); cpt += 6, error += 2) {
+      const double *ptr_point_cloud = &m_pointCloudFace[cpt];
+      const __m128d vx = _mm_loadu_pd(ptr_point_cloud);
+      const __m128d vy = _mm_loadu_pd(ptr_point_cloud + 2);
+      const __m128d vz = _mm_loadu_pd(ptr_point_cloud + 4);
+
+      const __m128d verror =
+          _mm_add_pd(_mm_add_pd(vd, _mm_mul_pd(vnx, vx)), _mm_add_pd(_mm_mul_pd(vny, vy), _mm_mul_pd(vnz, vz)));
+      _mm_storeu_pd(error, verror);
+    }
+#endif
+  }
+
+  for (; cpt < m_pointCloudFace.size(); cpt += 3) {
+    // Same rounding as computeInteractionMatrixAndResidu()
+    *error++ = D + (nx * m_pointCloudFace[cpt] + ny * m_pointCloudFace[cpt + 1] + nz * m_pointCloudFace[cpt + 2]);
+  }
+}
+
 void vpMbtFaceDepthDense::computeROI(const vpHomogeneousMatrix &cMo, unsigned int width,
                                      unsigned int height, std::vector<vpImagePoint> &roiPts
 #if DEBUG_DISPLAY_DEPTH_DENSE
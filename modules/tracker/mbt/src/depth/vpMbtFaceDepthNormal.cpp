@@ -33,7 +33,11 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
+#include <limits>
+
 #include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpMath.h>
 #include <visp3/mbt/vpMbtFaceDepthNormal.h>
 #include <visp3/mbt/vpMbtTukeyEstimator.h>
 
@@ -202,7 +206,8 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
   if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
     point_cloud_face_custom.reserve((size_t)(3 * bb.getWidth() * bb.getHeight()));
     point_cloud_face_vec.reserve((size_t)(3 * bb.getWidth() * bb.getHeight()));
-  } else if (m_featureEstimationMethod == ROBUST_SVD_PLANE_ESTIMATION) {
+  } else if (m_featureEstimationMethod == ROBUST_SVD_PLANE_ESTIMATION ||
+             m_featureEstimationMethod == MOMENT_PLANE_ESTIMATION) {
     point_cloud_face_vec.reserve((size_t)(3 * bb.getWidth() * bb.getHeight()));
   } else if (m_featureEstimationMethod == PCL_PLANE_ESTIMATION) {
     point_cloud_face->reserve((size_t)(bb.getWidth() * bb.getHeight()));
@@ -228,6 +233,7 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
         if (m_featureEstimationMethod == PCL_PLANE_ESTIMATION) {
           point_cloud_face->push_back((*point_cloud)(j, i));
         } else if (m_featureEstimationMethod == ROBUST_SVD_PLANE_ESTIMATION ||
+                   m_featureEstimationMethod == MOMENT_PLANE_ESTIMATION ||
                    m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
           point_cloud_face_vec.push_back((*point_cloud)(j, i).x);
           point_cloud_face_vec.push_back((*point_cloud)(j, i).y);
@@ -292,6 +298,8 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
     }
   } else if (m_featureEstimationMethod == ROBUST_SVD_PLANE_ESTIMATION) {
     computeDesiredFeaturesSVD(point_cloud_face_vec, cMo, desired_features, desired_normal, centroid_point);
+  } else if (m_featureEstimationMethod == MOMENT_PLANE_ESTIMATION) {
+    computeDesiredFeaturesMoments(point_cloud_face_vec, cMo, desired_features, desired_normal, centroid_point);
   } else if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
     computeDesiredFeaturesRobustFeatures(point_cloud_face_custom, point_cloud_face_vec, cMo, desired_features,
                                          desired_normal, centroid_point);
@@ -451,6 +459,8 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
 #endif
       if (m_featureEstimationMethod == ROBUST_SVD_PLANE_ESTIMATION) {
     computeDesiredFeaturesSVD(point_cloud_face, cMo, desired_features, desired_normal, centroid_point);
+  } else if (m_featureEstimationMethod == MOMENT_PLANE_ESTIMATION) {
+    computeDesiredFeaturesMoments(point_cloud_face, cMo, desired_features, desired_normal, centroid_point);
   } else if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
     computeDesiredFeaturesRobustFeatures(point_cloud_face_custom, point_cloud_face, cMo, desired_features,
                                          desired_normal, centroid_point);
@@ -561,6 +571,23 @@ void vpMbtFaceDepthNormal::computeDesiredFeaturesRobustFeatures(const std::vecto
                           desired_normal);
 }
 
+void vpMbtFaceDepthNormal::computeDesiredFeaturesMoments(const std::vector<double> &point_cloud_face,
+                                                         const vpHomogeneousMatrix &cMo,
+                                                         vpColVector &desired_features, vpColVector &desired_normal,
+                                                         vpColVector &centroid_point)
+{
+  vpColVector plane_equation;
+  estimatePlaneEquationMoments(point_cloud_face, cMo, plane_equation, centroid_point);
+
+  desired_features.resize(3, false);
+  desired_features[0] = -plane_equation[0] / plane_equation[3];
+  desired_features[1] = -plane_equation[1] / plane_equation[3];
+  desired_features[2] = -plane_equation[2] / plane_equation[3];
+
+  computeNormalVisibility(-desired_features[0], -desired_features[1], -desired_features[2], centroid_point,
+                          desired_normal);
+}
+
 void vpMbtFaceDepthNormal::computeDesiredFeaturesSVD(const std::vector<double> &point_cloud_face,
                                                      const vpHomogeneousMatrix &cMo, vpColVector &desired_features,
                                                      vpColVector &desired_normal, vpColVector &centroid_point)
@@ -1485,6 +1512,296 @@ void vpMbtFaceDepthNormal::estimatePlaneEquationSVD(const std::vector<double> &p
   plane_equation_estimated[3] = D;
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Weighted moments of the points, in the order: sum(w), sum(w p), sum(w^2), sum(w^2 p) and the upper triangle of
+// sum(w^2 p p^T)
+void accumulatePlaneMoments(const double *x, const double *y, const double *z, const double *w, size_t n,
+                            double moments[14])
+{
+  for (int k = 0; k < 14; k++) {
+    moments[k] = 0.0;
+  }
+
+  size_t i = 0;
+#if USE_SSE
+  if (vpCPUFeatures::checkSSE2() && n >= 2) {
+    __m128d vsum[14];
+    for (int k = 0; k < 14; k++) {
+      vsum[k] = _mm_setzero_pd();
+    }
+
+    for (; i + 2 <= n; i += 2) {
+      const __m128d vw = _mm_loadu_pd(w + i);
+      const __m128d vx = _mm_loadu_pd(x + i);
+      const __m128d vy = _mm_loadu_pd(y + i);
+      const __m128d vz = _mm_loadu_pd(z + i);
+      const __m128d vw2 = _mm_mul_pd(vw, vw);
+      const __m128d vw2x = _mm_mul_pd(vw2, vx);
+      const __m128d vw2y = _mm_mul_pd(vw2, vy);
+
+      vsum[0] = _mm_add_pd(vsum[0], vw);
+      vsum[1] = _mm_add_pd(vsum[1], _mm_mul_pd(vw, vx));
+      vsum[2] = _mm_add_pd(vsum[2], _mm_mul_pd(vw, vy));
+      vsum[3] = _mm_add_pd(vsum[3], _mm_mul_pd(vw, vz));
+      vsum[4] = _mm_add_pd(vsum[4], vw2);
+      vsum[5] = _mm_add_pd(vsum[5], vw2x);
+      vsum[6] = _mm_add_pd(vsum[6], vw2y);
+      vsum[7] = _mm_add_pd(vsum[7], _mm_mul_pd(vw2, vz));
+      vsum[8] = _mm_add_pd(vsum[8], _mm_mul_pd(vw2x, vx));
+      vsum[9] = _mm_add_pd(vsum[9], _mm_mul_pd(vw2x, vy));
+      vsum[10] = _mm_add_pd(vsum[10], _mm_mul_pd(vw2x, vz));
+      vsum[11] = _mm_add_pd(vsum[11], _mm_mul_pd(vw2y, vy));
+      vsum[12] = _mm_add_pd(vsum[12], _mm_mul_pd(vw2y, vz));
+      vsum[13] = _mm_add_pd(vsum[13], _mm_mul_pd(_mm_mul_pd(vw2, vz), vz));
+    }
+
+    double tmp[2];
+    for (int k = 0; k < 14; k++) {
+      _mm_storeu_pd(tmp, vsum[k]);
+      moments[k] = tmp[0] + tmp[1];
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    const double w2 = w[i] * w[i];
+    moments[0] += w[i];
+    moments[1] += w[i] * x[i];
+    moments[2] += w[i] * y[i];
+    moments[3] += w[i] * z[i];
+    moments[4] += w2;
+    moments[5] += w2 * x[i];
+    moments[6] += w2 * y[i];
+    moments[7] += w2 * z[i];
+    moments[8] += w2 * x[i] * x[i];
+    moments[9] += w2 * x[i] * y[i];
+    moments[10] += w2 * x[i] * z[i];
+    moments[11] += w2 * y[i] * y[i];
+    moments[12] += w2 * y[i] * z[i];
+    moments[13] += w2 * z[i] * z[i];
+  }
+}
+
+// Distances of the points to the plane A x + B y + C z + D = 0, with a unit normal, and the weighted sum of the
+// distances
+double computePlaneResidues(const double *x, const double *y, const double *z, const double *w, size_t n, double A,
+                            double B, double C, double D, double *residues)
+{
+  double error = 0.0;
+  size_t i = 0;
+#if USE_SSE
+  if (vpCPUFeatures::checkSSE2() && n >= 2) {
+    const __m128d vA = _mm_set1_pd(A), vB = _mm_set1_pd(B), vC = _mm_set1_pd(C), vD = _mm_set1_pd(D);
+    const __m128d vsign = _mm_set1_pd(-0.0);
+    __m128d verror = _mm_setzero_pd();
+
+    for (; i + 2 <= n; i += 2) {
+      __m128d vr = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vA, _mm_loadu_pd(x + i)), _mm_mul_pd(vB, _mm_loadu_pd(y + i))),
+                              _mm_add_pd(_mm_mul_pd(vC, _mm_loadu_pd(z + i)), vD));
+      vr = _mm_andnot_pd(vsign, vr);
+      _mm_storeu_pd(residues + i, vr);
+      verror = _mm_add_pd(verror, _mm_mul_pd(_mm_loadu_pd(w + i), vr));
+    }
+
+    double tmp[2];
+    _mm_storeu_pd(tmp, verror);
+    error = tmp[0] + tmp[1];
+  }
+#endif
+
+  for (; i < n; i++) {
+    residues[i] = std::fabs(A * x[i] + B * y[i] + C * z[i] + D);
+    error += w[i] * residues[i];
+  }
+
+  return error;
+}
+
+// Unit eigenvector of the smallest eigenvalue of the symmetric matrix [a00 a01 a02; a01 a11 a12; a02 a12 a22], with
+// the closed-form eigenvalues of a 3x3 symmetric matrix. Return false when the eigenvector is not defined.
+bool smallestEigenVector(double a00, double a01, double a02, double a11, double a12, double a22, double normal[3])
+{
+  const double q = (a00 + a11 + a22) / 3.0;
+  const double p1 = a01 * a01 + a02 * a02 + a12 * a12;
+  const double p2 = (a00 - q) * (a00 - q) + (a11 - q) * (a11 - q) + (a22 - q) * (a22 - q) + 2.0 * p1;
+  const double p = sqrt(p2 / 6.0);
+  if (p <= std::numeric_limits<double>::epsilon() * std::fabs(q)) {
+    // Isotropic distribution, no preferred direction
+    return false;
+  }
+
+  // B = (A - q I) / p, its half determinant is the cosine of three times the angle of the eigenvalues
+  const double b00 = (a00 - q) / p, b11 = (a11 - q) / p, b22 = (a22 - q) / p;
+  const double b01 = a01 / p, b02 = a02 / p, b12 = a12 / p;
+  double r = 0.5 * (b00 * (b11 * b22 - b12 * b12) - b01 * (b01 * b22 - b12 * b02) + b02 * (b01 * b12 - b11 * b02));
+  r = std::max<double>(-1.0, std::min<double>(1.0, r));
+  const double phi = acos(r) / 3.0;
+  const double lambda = q + 2.0 * p * cos(phi + 2.0 * M_PI / 3.0);
+
+  // The eigenvector is orthogonal to the rows of A - lambda I, take the best conditioned cross product of two rows
+  const double r0[3] = {a00 - lambda, a01, a02};
+  const double r1[3] = {a01, a11 - lambda, a12};
+  const double r2[3] = {a02, a12, a22 - lambda};
+  const double *rows[3][2] = {{r0, r1}, {r0, r2}, {r1, r2}};
+
+  double best_norm = 0.0;
+  for (int k = 0; k < 3; k++) {
+    const double *u = rows[k][0], *v = rows[k][1];
+    const double c[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+    const double norm = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+    if (norm > best_norm) {
+      best_norm = norm;
+      normal[0] = c[0];
+      normal[1] = c[1];
+      normal[2] = c[2];
+    }
+  }
+
+  if (best_norm <= 0.0) {
+    return false;
+  }
+
+  best_norm = sqrt(best_norm);
+  normal[0] /= best_norm;
+  normal[1] /= best_norm;
+  normal[2] /= best_norm;
+  return true;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Robust estimation of the plane equation of the face from the first and
+  second order moments of the point cloud, without PCL.
+
+  This is the same iteratively reweighted least-squares fit as
+  estimatePlaneEquationSVD(): the normal is the eigenvector of the smallest
+  eigenvalue of the weighted scatter matrix of the points, the weights are
+  updated with a Tukey M-estimator from the point to plane distances. But the
+  scatter matrix is built in a single pass from the weighted moments of the
+  points and the eigenvector is obtained in closed form instead of with the
+  SVD of a \f$ 3 \times 3 \f$ matrix, which is much faster for small faces.
+
+  \param point_cloud_face : Points of the face, as xyz triplets in the camera
+  frame.
+  \param cMo : Current pose, used to initialize the weights from the model
+  plane.
+  \param plane_equation_estimated : Estimated plane equation, with a unit
+  normal.
+  \param centroid : Weighted centroid of the points.
+*/
+void vpMbtFaceDepthNormal::estimatePlaneEquationMoments(const std::vector<double> &point_cloud_face,
+                                                        const vpHomogeneousMatrix &cMo,
+                                                        vpColVector &plane_equation_estimated, vpColVector &centroid)
+{
+  unsigned int max_iter = 10;
+  double prev_error = 1e3;
+  double error = 1e3 - 1;
+
+  const size_t nb_points = point_cloud_face.size() / 3;
+  std::vector<double> weights(nb_points, 1.0);
+  std::vector<double> residues(nb_points);
+  vpMbtTukeyEstimator<double> tukey;
+
+  // Structure of arrays of the points, centered on their mean to limit the cancellation in the moments
+  std::vector<double> x(nb_points), y(nb_points), z(nb_points);
+  double mean_x = 0.0, mean_y = 0.0, mean_z = 0.0;
+  for (size_t i = 0; i < nb_points; i++) {
+    mean_x += point_cloud_face[3 * i];
+    mean_y += point_cloud_face[3 * i + 1];
+    mean_z += point_cloud_face[3 * i + 2];
+  }
+  if (nb_points > 0) {
+    mean_x /= nb_points;
+    mean_y /= nb_points;
+    mean_z /= nb_points;
+  }
+  for (size_t i = 0; i < nb_points; i++) {
+    x[i] = point_cloud_face[3 * i] - mean_x;
+    y[i] = point_cloud_face[3 * i + 1] - mean_y;
+    z[i] = point_cloud_face[3 * i + 2] - mean_z;
+  }
+
+  // Transform the plane equation for the current pose
+  m_planeCamera = m_planeObject;
+  m_planeCamera.changeFrame(cMo);
+
+  double normal[3] = {m_planeCamera.getA(), m_planeCamera.getB(), m_planeCamera.getC()};
+  double norm = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+  normal[0] /= norm;
+  normal[1] /= norm;
+  normal[2] /= norm;
+  double D = m_planeCamera.getD() / norm + normal[0] * mean_x + normal[1] * mean_y + normal[2] * mean_z;
+
+  // Distance of the points to the model plane
+  computePlaneResidues(&x[0], &y[0], &z[0], &weights[0], nb_points, normal[0], normal[1], normal[2], D, &residues[0]);
+  plane_equation_estimated.resize(4, false);
+
+  double c[3] = {0.0, 0.0, 0.0};
+  for (unsigned int iter = 0; iter < max_iter && std::fabs(error - prev_error) > 1e-6; iter++) {
+    tukey.MEstimator(residues, weights, 1e-4);
+
+    double m[14];
+    accumulatePlaneMoments(&x[0], &y[0], &z[0], &weights[0], nb_points, m);
+    const double total_w = m[0];
+
+    // Weighted centroid
+    c[0] = m[1] / total_w;
+    c[1] = m[2] / total_w;
+    c[2] = m[3] / total_w;
+
+    // Scatter matrix sum(w^2 (p - c) (p - c)^T) expanded with the moments
+    const double s00 = m[8] - 2.0 * c[0] * m[5] + m[4] * c[0] * c[0];
+    const double s01 = m[9] - c[0] * m[6] - c[1] * m[5] + m[4] * c[0] * c[1];
+    const double s02 = m[10] - c[0] * m[7] - c[2] * m[5] + m[4] * c[0] * c[2];
+    const double s11 = m[11] - 2.0 * c[1] * m[6] + m[4] * c[1] * c[1];
+    const double s12 = m[12] - c[1] * m[7] - c[2] * m[6] + m[4] * c[1] * c[2];
+    const double s22 = m[13] - 2.0 * c[2] * m[7] + m[4] * c[2] * c[2];
+
+    // Keep the previous normal for degenerate point distributions
+    smallestEigenVector(s00, s01, s02, s11, s12, s22, normal);
+    D = -(normal[0] * c[0] + normal[1] * c[1] + normal[2] * c[2]);
+
+    // Update plane equation
+    plane_equation_estimated[0] = normal[0];
+    plane_equation_estimated[1] = normal[1];
+    plane_equation_estimated[2] = normal[2];
+    plane_equation_estimated[3] = D - (normal[0] * mean_x + normal[1] * mean_y + normal[2] * mean_z);
+
+    // Compute error points to estimated plane
+    prev_error = error;
+    error = computePlaneResidues(&x[0], &y[0], &z[0], &weights[0], nb_points, normal[0], normal[1], normal[2], D,
+                                 &residues[0]) /
+            total_w;
+  }
+
+  // Update final weights
+  tukey.MEstimator(residues, weights, 1e-4);
+
+  // Update final centroid
+  double total_w = 0.0;
+  c[0] = c[1] = c[2] = 0.0;
+  for (size_t i = 0; i < nb_points; i++) {
+    c[0] += weights[i] * x[i];
+    c[1] += weights[i] * y[i];
+    c[2] += weights[i] * z[i];
+    total_w += weights[i];
+  }
+
+  centroid.resize(3, false);
+  centroid[0] = c[0] / total_w + mean_x;
+  centroid[1] = c[1] / total_w + mean_y;
+  centroid[2] = c[2] / total_w + mean_z;
+
+  // Compute final plane equation
+  plane_equation_estimated[0] = normal[0];
+  plane_equation_estimated[1] = normal[1];
+  plane_equation_estimated[2] = normal[2];
+  plane_equation_estimated[3] = -(normal[0] * centroid[0] + normal[1] * centroid[1] + normal[2] * centroid[2]);
+}
+
 /*!
   Return a list of features parameters for display.
   - Parameters are: `<feature id (here 2 for depth normal)>`, `<centroid.i()>`, `<centroid.j()>`,
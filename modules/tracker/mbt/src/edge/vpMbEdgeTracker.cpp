@@ -57,12 +57,18 @@
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
 #include <visp3/vision/vpPose.h>
 
+#include <algorithm>
 #include <float.h>
 #include <limits>
 #include <map>
 #include <sstream>
 #include <string>
 
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+#include <exception>
+#include <omp.h>
+#endif
+
 /*!
   Basic constructor
 */
@@ -71,7 +77,10 @@ vpMbEdgeTracker::vpMbEdgeTracker()
     percentageGdPt(0.4), scales(1), Ipyramid(0), scaleLevel(0), nbFeaturesForProjErrorComputation(0), m_factor(),
     m_robustLines(), m_robustCylinders(), m_robustCircles(), m_wLines(), m_wCylinders(), m_wCircles(), m_errorLines(),
     m_errorCylinders(), m_errorCircles(), m_L_edge(), m_error_edge(), m_w_edge(), m_weightedError_edge(),
-    m_robust_edge(), m_featuresToBeDisplayedEdge()
+    m_robust_edge(), m_featuresToBeDisplayedEdge(), m_useParallelMovingEdge(false), m_nbParallelMovingEdgeThreads(0),
+    m_useMovingEdgeGradientLookup(false), m_movingEdgeGradientLookups(),
+    m_sharedMovingEdgeGradientLookup(NULL), m_sharedMovingEdgeGradientLookupGeneration(0),
+    m_sharedMovingEdgeGradientLookupRejected(true)
 {
   scales[0] = true;
 
@@ -123,6 +132,86 @@ vpMbEdgeTracker::~vpMbEdgeTracker()
   }
 
   cleanPyramid(Ipyramid);
+
+  for (size_t i = 0; i < m_movingEdgeGradientLookups.size(); i++) {
+    delete m_movingEdgeGradientLookups[i];
+  }
+  m_movingEdgeGradientLookups.clear();
+}
+
+/*!
+  Use a lookup of the moving-edge mask responses shared with other trackers
+  processing the same image, for instance several objects tracked in the
+  same camera. The owner of the lookup must call vpMeGradientLookup::update()
+  once per frame, before the trackers process the image, and the trackers
+  must use the same mask size and number of masks.
+
+  The shared lookup is only used when setUseMovingEdgeGradientLookup() is
+  enabled and when it was updated with the image being tracked since the
+  previous frame, the own lookup of the tracker is used otherwise.
+
+  \param lookup : Shared lookup, NULL to only use the own lookup.
+*/
+void vpMbEdgeTracker::setSharedMovingEdgeGradientLookup(const vpMeGradientLookup *lookup)
+{
+  m_sharedMovingEdgeGradientLookup = lookup;
+  // The lookup has to be updated by its owner before its first use
+  m_sharedMovingEdgeGradientLookupGeneration = lookup != NULL ? lookup->getGeneration() : 0;
+  m_sharedMovingEdgeGradientLookupRejected = true;
+}
+
+/*!
+  Share the responses of the moving-edge masks through a per-frame lookup,
+  see vpMeGradientLookup. The candidates that were already evaluated during
+  the tracking of the current frame, with the same mask, are not convolved
+  again when the moving edges are updated and reinitialized. The tracking
+  result is unchanged.
+
+  The lookup needs 8 bytes per pixel for every active scale level.
+
+  \param use : True to use the lookup.
+*/
+void vpMbEdgeTracker::setUseMovingEdgeGradientLookup(bool use)
+{
+  m_useMovingEdgeGradientLookup = use;
+  if (!use) {
+    me.setGradientLookup(NULL);
+    for (size_t i = 0; i < m_movingEdgeGradientLookups.size(); i++) {
+      delete m_movingEdgeGradientLookups[i];
+    }
+    m_movingEdgeGradientLookups.clear();
+  }
+}
+
+/*!
+  Enable the concurrent processing of the lines, cylinders and circles when
+  the moving edges are initialized, tracked, updated and reinitialized.
+
+  The primitives with the most moving edges at the previous frame are
+  scheduled first and each thread picks the next remaining primitive, so that
+  the load stays balanced when a few long lines carry most of the sites. Each
+  primitive only modifies its own moving edges, the tracking result is thus
+  the same as the sequential one.
+
+  \param parallel : True to process the primitives concurrently.
+
+  \note This option requires OpenMP and C++11 support, otherwise the
+  primitives are processed sequentially.
+
+  \sa setNbParallelMovingEdgeThreads()
+*/
+void vpMbEdgeTracker::setUseParallelMovingEdge(bool parallel)
+{
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  m_useParallelMovingEdge = parallel;
+#else
+  if (parallel) {
+    std::cerr << "Parallel moving-edge tracking requires OpenMP and C++11 support, the primitives are processed "
+                 "sequentially."
+              << std::endl;
+  }
+  m_useParallelMovingEdge = false;
+#endif
 }
 
 /*!
@@ -1512,6 +1601,215 @@ void vpMbEdgeTracker::displayFeaturesOnImage(const vpImage<vpRGBa> &I)
   }
 }
 
+/*!
+  Attach the lookup of the current scale level to the moving-edge
+  parameters when setUseMovingEdgeGradientLookup() is enabled.
+
+  \param I : Image on which the moving edges are going to be processed.
+  \param newFrame : True if the image content may have changed since the
+  lookup was last updated, false if the stage follows another one on the
+  same image. In the latter case the responses already computed are reused.
+*/
+void vpMbEdgeTracker::bindMovingEdgeGradientLookup(const vpImage<unsigned char> &I, bool newFrame)
+{
+  if (!m_useMovingEdgeGradientLookup) {
+    return;
+  }
+
+  if (m_sharedMovingEdgeGradientLookup != NULL) {
+    const unsigned int generation = m_sharedMovingEdgeGradientLookup->getGeneration();
+    bool useShared = false;
+    if (newFrame) {
+      // A new frame needs a lookup updated since the previous one, the image may be the same buffer with a new
+      // content. When it is rejected, the own lookup is used until the next frame.
+      useShared = generation != m_sharedMovingEdgeGradientLookupGeneration &&
+                  m_sharedMovingEdgeGradientLookup->isValidFor(I, me);
+      m_sharedMovingEdgeGradientLookupGeneration = generation;
+      m_sharedMovingEdgeGradientLookupRejected = !useShared;
+    } else {
+      // The next stages on the same frame need the lookup accepted for that frame
+      useShared = !m_sharedMovingEdgeGradientLookupRejected &&
+                  generation == m_sharedMovingEdgeGradientLookupGeneration &&
+                  m_sharedMovingEdgeGradientLookup->isValidFor(I, me);
+    }
+
+    if (useShared) {
+      me.setGradientLookup(m_sharedMovingEdgeGradientLookup);
+      return;
+    }
+  }
+
+  if (m_movingEdgeGradientLookups.size() < scales.size()) {
+    m_movingEdgeGradientLookups.resize(scales.size(), NULL);
+  }
+  vpMeGradientLookup *&lookup = m_movingEdgeGradientLookups[scaleLevel];
+  if (lookup == NULL) {
+    lookup = new vpMeGradientLookup;
+  }
+
+  if (newFrame || !lookup->isValidFor(I, me)) {
+    lookup->update(I, me);
+  }
+  me.setGradientLookup(lookup);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+enum vpMovingEdgeStage { ME_STAGE_INIT, ME_STAGE_TRACK, ME_STAGE_UPDATE, ME_STAGE_REINIT };
+
+// One line, cylinder or circle to process. All the moving-edge state lives in the primitive, so that the primitives
+// can be processed concurrently without sharing anything but the read-only image, pose and mask.
+struct vpMovingEdgeTask {
+  vpMbtDistanceLine *line;
+  vpMbtDistanceCylinder *cylinder;
+  vpMbtDistanceCircle *circle;
+  unsigned int cost;
+  size_t order;
+};
+
+vpMovingEdgeTask makeTask(vpMbtDistanceLine *l, size_t order)
+{
+  vpMovingEdgeTask task = {l, NULL, NULL, l->nbFeatureTotal, order};
+  return task;
+}
+
+vpMovingEdgeTask makeTask(vpMbtDistanceCylinder *cy, size_t order)
+{
+  vpMovingEdgeTask task = {NULL, cy, NULL, cy->nbFeature, order};
+  return task;
+}
+
+vpMovingEdgeTask makeTask(vpMbtDistanceCircle *ci, size_t order)
+{
+  vpMovingEdgeTask task = {NULL, NULL, ci, ci->nbFeature, order};
+  return task;
+}
+
+void runTask(const vpMovingEdgeTask &task, vpMovingEdgeStage stage, const vpImage<unsigned char> &I,
+             const vpHomogeneousMatrix &cMo, const vpImage<bool> *mask)
+{
+  const bool doNotTrack = false;
+
+  if (task.line != NULL) {
+    vpMbtDistanceLine *l = task.line;
+    switch (stage) {
+    case ME_STAGE_INIT:
+      l->initMovingEdge(I, cMo, doNotTrack, mask);
+      break;
+    case ME_STAGE_TRACK:
+      if (l->meline.empty()) {
+        l->initMovingEdge(I, cMo, doNotTrack, mask);
+      }
+      l->trackMovingEdge(I);
+      break;
+    case ME_STAGE_UPDATE:
+      l->updateMovingEdge(I, cMo);
+      if (l->nbFeatureTotal == 0 && l->isVisible()) {
+        l->Reinit = true;
+      }
+      break;
+    case ME_STAGE_REINIT:
+      l->reinitMovingEdge(I, cMo, mask);
+      break;
+    }
+  } else if (task.cylinder != NULL) {
+    vpMbtDistanceCylinder *cy = task.cylinder;
+    switch (stage) {
+    case ME_STAGE_INIT:
+      cy->initMovingEdge(I, cMo, doNotTrack, mask);
+      break;
+    case ME_STAGE_TRACK:
+      if (cy->meline1 == NULL || cy->meline2 == NULL) {
+        cy->initMovingEdge(I, cMo, doNotTrack, mask);
+      }
+      cy->trackMovingEdge(I, cMo);
+      break;
+    case ME_STAGE_UPDATE:
+      cy->updateMovingEdge(I, cMo);
+      if ((cy->nbFeaturel1 == 0 || cy->nbFeaturel2 == 0) && cy->isVisible()) {
+        cy->Reinit = true;
+      }
+      break;
+    case ME_STAGE_REINIT:
+      cy->reinitMovingEdge(I, cMo, mask);
+      break;
+    }
+  } else if (task.circle != NULL) {
+    vpMbtDistanceCircle *ci = task.circle;
+    switch (stage) {
+    case ME_STAGE_INIT:
+      ci->initMovingEdge(I, cMo, doNotTrack, mask);
+      break;
+    case ME_STAGE_TRACK:
+      if (ci->meEllipse == NULL) {
+        ci->initMovingEdge(I, cMo, doNotTrack, mask);
+      }
+      ci->trackMovingEdge(I, cMo);
+      break;
+    case ME_STAGE_UPDATE:
+      ci->updateMovingEdge(I, cMo);
+      if (ci->nbFeature == 0 && ci->isVisible()) {
+        ci->Reinit = true;
+      }
+      break;
+    case ME_STAGE_REINIT:
+      ci->reinitMovingEdge(I, cMo, mask);
+      break;
+    }
+  }
+}
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+bool hasHigherCost(const vpMovingEdgeTask &a, const vpMovingEdgeTask &b) { return a.cost > b.cost; }
+#endif
+
+/*
+  Process the tasks in their original order, or concurrently when parallel is true. In the latter case the
+  primitives with the most sites at the previous frame are handed out first and the idle threads pick the next
+  remaining primitive, so that a few long lines do not end up on the same thread. Since each primitive only
+  touches its own state, the result does not depend on the number of threads.
+*/
+void runTasks(std::vector<vpMovingEdgeTask> &tasks, vpMovingEdgeStage stage, const vpImage<unsigned char> &I,
+              const vpHomogeneousMatrix &cMo, const vpImage<bool> *mask, bool parallel, unsigned int nbThreads)
+{
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (parallel && tasks.size() > 1) {
+    std::stable_sort(tasks.begin(), tasks.end(), hasHigherCost);
+
+    // Exceptions cannot leave an OpenMP region, keep them by original order to rethrow the one a sequential run
+    // would have raised
+    std::vector<std::exception_ptr> exceptions(tasks.size());
+    int nb_threads = nbThreads > 0 ? static_cast<int>(nbThreads) : omp_get_max_threads();
+    int nb_tasks = static_cast<int>(tasks.size());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nb_threads)
+    for (int i = 0; i < nb_tasks; i++) {
+      try {
+        runTask(tasks[static_cast<size_t>(i)], stage, I, cMo, mask);
+      } catch (...) {
+        exceptions[tasks[static_cast<size_t>(i)].order] = std::current_exception();
+      }
+    }
+
+    for (size_t i = 0; i < exceptions.size(); i++) {
+      if (exceptions[i]) {
+        std::rethrow_exception(exceptions[i]);
+      }
+    }
+    return;
+  }
+#else
+  (void)parallel;
+  (void)nbThreads;
+#endif
+
+  for (size_t i = 0; i < tasks.size(); i++) {
+    runTask(tasks[i], stage, I, cMo, mask);
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Initialize the moving edge thanks to a given pose of the camera.
   The 3D model is projected into the image to create moving edges along the
@@ -1522,7 +1820,9 @@ void vpMbEdgeTracker::displayFeaturesOnImage(const vpImage<vpRGBa> &I)
 */
 void vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo)
 {
-  const bool doNotTrack = false;
+  // The visibility is updated first, the moving edges of the newly visible primitives are then created together
+  std::vector<vpMovingEdgeTask> tasks;
+  bindMovingEdgeGradientLookup(I, true);
 
   for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[scaleLevel].begin(); it != lines[scaleLevel].end();
        ++it) {
@@ -1548,7 +1848,7 @@ void vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHo
       l->setVisible(true);
       l->updateTracked();
       if (l->meline.empty() && l->isTracked())
-        l->initMovingEdge(I, _cMo, doNotTrack, m_mask);
+        tasks.push_back(makeTask(l, tasks.size()));
     } else {
       l->setVisible(false);
       for (size_t a = 0; a < l->meline.size(); a++) {
@@ -1583,7 +1883,7 @@ void vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHo
       cy->setVisible(true);
       if (cy->meline1 == NULL || cy->meline2 == NULL) {
         if (cy->isTracked())
-          cy->initMovingEdge(I, _cMo, doNotTrack, m_mask);
+          tasks.push_back(makeTask(cy, tasks.size()));
       }
     } else {
       cy->setVisible(false);
@@ -1616,7 +1916,7 @@ void vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHo
       ci->setVisible(true);
       if (ci->meEllipse == NULL) {
         if (ci->isTracked())
-          ci->initMovingEdge(I, _cMo, doNotTrack, m_mask);
+          tasks.push_back(makeTask(ci, tasks.size()));
       }
     } else {
       ci->setVisible(false);
@@ -1626,6 +1926,27 @@ void vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHo
       ci->nbFeature = 0;
     }
   }
+
+  runTasks(tasks, ME_STAGE_INIT, I, _cMo, m_mask, m_useParallelMovingEdge, m_nbParallelMovingEdgeThreads);
+}
+
+/*!
+  Move the moving edges of the lines onto their projection with a predicted
+  pose, so that the tracking searches around the predicted position. The
+  moving edges of the cylinders and circles are not moved.
+
+  \param I : the image.
+  \param cMo : The predicted pose.
+*/
+void vpMbEdgeTracker::shiftMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo)
+{
+  for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[scaleLevel].begin(); it != lines[scaleLevel].end();
+       ++it) {
+    vpMbtDistanceLine *l = *it;
+    if (l->isVisible() && l->isTracked()) {
+      l->shiftMovingEdge(I, cMo);
+    }
+  }
 }
 
 /*!
@@ -1635,16 +1956,14 @@ void vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHo
 */
 void vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 {
-  const bool doNotTrack = false;
+  std::vector<vpMovingEdgeTask> tasks;
+  bindMovingEdgeGradientLookup(I, true);
 
   for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[scaleLevel].begin(); it != lines[scaleLevel].end();
        ++it) {
     vpMbtDistanceLine *l = *it;
     if (l->isVisible() && l->isTracked()) {
-      if (l->meline.empty()) {
-        l->initMovingEdge(I, m_cMo, doNotTrack, m_mask);
-      }
-      l->trackMovingEdge(I);
+      tasks.push_back(makeTask(l, tasks.size()));
     }
   }
 
@@ -1652,10 +1971,7 @@ void vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
        it != cylinders[scaleLevel].end(); ++it) {
     vpMbtDistanceCylinder *cy = *it;
     if (cy->isVisible() && cy->isTracked()) {
-      if (cy->meline1 == NULL || cy->meline2 == NULL) {
-        cy->initMovingEdge(I, m_cMo, doNotTrack, m_mask);
-      }
-      cy->trackMovingEdge(I, m_cMo);
+      tasks.push_back(makeTask(cy, tasks.size()));
     }
   }
 
@@ -1663,12 +1979,11 @@ void vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
        it != circles[scaleLevel].end(); ++it) {
     vpMbtDistanceCircle *ci = *it;
     if (ci->isVisible() && ci->isTracked()) {
-      if (ci->meEllipse == NULL) {
-        ci->initMovingEdge(I, m_cMo, doNotTrack, m_mask);
-      }
-      ci->trackMovingEdge(I, m_cMo);
+      tasks.push_back(makeTask(ci, tasks.size()));
     }
   }
+
+  runTasks(tasks, ME_STAGE_TRACK, I, m_cMo, m_mask, m_useParallelMovingEdge, m_nbParallelMovingEdgeThreads);
 }
 
 /*!
@@ -1678,41 +1993,31 @@ void vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 */
 void vpMbEdgeTracker::updateMovingEdge(const vpImage<unsigned char> &I)
 {
-  vpMbtDistanceLine *l;
+  std::vector<vpMovingEdgeTask> tasks;
+  bindMovingEdgeGradientLookup(I, false);
+
   for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[scaleLevel].begin(); it != lines[scaleLevel].end();
        ++it) {
     if ((*it)->isTracked()) {
-      l = *it;
-      l->updateMovingEdge(I, m_cMo);
-      if (l->nbFeatureTotal == 0 && l->isVisible()) {
-        l->Reinit = true;
-      }
+      tasks.push_back(makeTask(*it, tasks.size()));
     }
   }
 
-  vpMbtDistanceCylinder *cy;
   for (std::list<vpMbtDistanceCylinder *>::const_iterator it = cylinders[scaleLevel].begin();
        it != cylinders[scaleLevel].end(); ++it) {
     if ((*it)->isTracked()) {
-      cy = *it;
-      cy->updateMovingEdge(I, m_cMo);
-      if ((cy->nbFeaturel1 == 0 || cy->nbFeaturel2 == 0) && cy->isVisible()) {
-        cy->Reinit = true;
-      }
+      tasks.push_back(makeTask(*it, tasks.size()));
     }
   }
 
-  vpMbtDistanceCircle *ci;
   for (std::list<vpMbtDistanceCircle *>::const_iterator it = circles[scaleLevel].begin();
        it != circles[scaleLevel].end(); ++it) {
     if ((*it)->isTracked()) {
-      ci = *it;
-      ci->updateMovingEdge(I, m_cMo);
-      if (ci->nbFeature == 0 && ci->isVisible()) {
-        ci->Reinit = true;
-      }
+      tasks.push_back(makeTask(*it, tasks.size()));
     }
   }
+
+  runTasks(tasks, ME_STAGE_UPDATE, I, m_cMo, m_mask, m_useParallelMovingEdge, m_nbParallelMovingEdgeThreads);
 }
 
 void vpMbEdgeTracker::updateMovingEdgeWeights()
@@ -1878,35 +2183,31 @@ void vpMbEdgeTracker::updateMovingEdgeWeights()
 */
 void vpMbEdgeTracker::reinitMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo)
 {
-  vpMbtDistanceLine *l;
+  std::vector<vpMovingEdgeTask> tasks;
+  bindMovingEdgeGradientLookup(I, false);
+
   for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[scaleLevel].begin(); it != lines[scaleLevel].end();
        ++it) {
-    if ((*it)->isTracked()) {
-      l = *it;
-      if (l->Reinit && l->isVisible())
-        l->reinitMovingEdge(I, _cMo, m_mask);
+    if ((*it)->isTracked() && (*it)->Reinit && (*it)->isVisible()) {
+      tasks.push_back(makeTask(*it, tasks.size()));
     }
   }
 
-  vpMbtDistanceCylinder *cy;
   for (std::list<vpMbtDistanceCylinder *>::const_iterator it = cylinders[scaleLevel].begin();
        it != cylinders[scaleLevel].end(); ++it) {
-    if ((*it)->isTracked()) {
-      cy = *it;
-      if (cy->Reinit && cy->isVisible())
-        cy->reinitMovingEdge(I, _cMo, m_mask);
+    if ((*it)->isTracked() && (*it)->Reinit && (*it)->isVisible()) {
+      tasks.push_back(makeTask(*it, tasks.size()));
     }
   }
 
-  vpMbtDistanceCircle *ci;
   for (std::list<vpMbtDistanceCircle *>::const_iterator it = circles[scaleLevel].begin();
        it != circles[scaleLevel].end(); ++it) {
-    if ((*it)->isTracked()) {
-      ci = *it;
-      if (ci->Reinit && ci->isVisible())
-        ci->reinitMovingEdge(I, _cMo, m_mask);
+    if ((*it)->isTracked() && (*it)->Reinit && (*it)->isVisible()) {
+      tasks.push_back(makeTask(*it, tasks.size()));
     }
   }
+
+  runTasks(tasks, ME_STAGE_REINIT, I, _cMo, m_mask, m_useParallelMovingEdge, m_nbParallelMovingEdgeThreads);
 }
 
 void vpMbEdgeTracker::resetMovingEdge()
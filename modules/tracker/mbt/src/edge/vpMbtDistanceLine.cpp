@@ -444,6 +444,45 @@ void vpMbtDistanceLine::trackMovingEdge(const vpImage<unsigned char> &I)
   }
 }
 
+/*!
+  Move the moving edges onto the projection of the line with a predicted
+  pose, before the tracking.
+
+  \param I : the image.
+  \param cMo : The predicted pose of the camera.
+*/
+void vpMbtDistanceLine::shiftMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo)
+{
+  if (isvisible && !meline.empty()) {
+    line->changeFrame(cMo);
+    try {
+      line->projection();
+    } catch (...) {
+      // The sites are kept at their previous position
+      return;
+    }
+
+    double rho, theta;
+    vpMeterPixelConversion::convertLine(cam, line->getRho(), line->getTheta(), rho, theta);
+
+    while (theta > M_PI) {
+      theta -= M_PI;
+    }
+    while (theta < -M_PI) {
+      theta += M_PI;
+    }
+
+    if (theta < -M_PI / 2.0)
+      theta = -theta - 3 * M_PI / 2.0;
+    else
+      theta = M_PI / 2.0 - theta;
+
+    for (size_t i = 0; i < meline.size(); i++) {
+      meline[i]->shiftSites(I, rho, theta);
+    }
+  }
+}
+
 /*!
   Update the moving edges internal parameters.
 
@@ -278,8 +278,9 @@ void vpMbtMeLine::seekExtremities(const vpImage<unsigned char> &I)
   P.init((int)PExt[0].ifloat, (int)PExt[0].jfloat, delta_1, 0, sign);
   P.setDisplay(selectDisplay);
 
-  unsigned int memory_range = me->getRange();
-  me->setRange(1);
+  // The extremities are sought with a range of 1, given to the sites rather
+  // than set on the shared vpMe
+  const unsigned int range = 1;
 
   for (int i = 0; i < 3; i++) {
     P.ifloat = P.ifloat + di * sample_step;
@@ -290,8 +291,8 @@ void vpMbtMeLine::seekExtremities(const vpImage<unsigned char> &I)
     if ((P.i < imin) || (P.i > imax) || (P.j < jmin) || (P.j > jmax)) {
       if (vpDEBUG_ENABLE(3))
         vpDisplay::displayCross(I, P.i, P.j, 5, vpColor::cyan);
-    } else if (!outOfImage(P.i, P.j, (int)(me->getRange() + me->getMaskSize() + 1), (int)rows, (int)cols)) {
-      P.track(I, me, false);
+    } else if (!outOfImage(P.i, P.j, (int)(range + me->getMaskSize() + 1), (int)rows, (int)cols)) {
+      P.track(I, me, false, range);
 
       if (P.getState() == vpMeSite::NO_SUPPRESSION) {
         list.push_back(P);
@@ -315,8 +316,8 @@ void vpMbtMeLine::seekExtremities(const vpImage<unsigned char> &I)
         vpDisplay::displayCross(I, P.i, P.j, 5, vpColor::cyan);
     }
 
-    else if (!outOfImage(P.i, P.j, (int)(me->getRange() + me->getMaskSize() + 1), (int)rows, (int)cols)) {
-      P.track(I, me, false);
+    else if (!outOfImage(P.i, P.j, (int)(range + me->getMaskSize() + 1), (int)rows, (int)cols)) {
+      P.track(I, me, false, range);
 
       if (P.getState() == vpMeSite::NO_SUPPRESSION) {
         list.push_back(P);
@@ -327,8 +328,6 @@ void vpMbtMeLine::seekExtremities(const vpImage<unsigned char> &I)
     }
   }
 
-  me->setRange(memory_range);
-
   vpCDEBUG(1) << "end vpMeLine::sample() : ";
   vpCDEBUG(1) << n_sample << " point inserted in the list " << std::endl;
 }
@@ -633,6 +632,53 @@ void vpMbtMeLine::updateParameters(const vpImage<unsigned char> &I, const vpImag
   updateDelta();
 }
 
+/*!
+  Move the moving edges orthogonally onto the line of parameters \e rho_ and
+  \e theta_, before the tracking. This is used when the pose of the next
+  frame is predicted: the search starts around the predicted projection of
+  the line instead of its position in the previous frame. The moving edges
+  that leave the image are removed.
+
+  \param I : The image in which the line will be tracked.
+  \param rho_ : The \f$\rho\f$ parameter of the predicted line.
+  \param theta_ : The \f$\theta\f$ parameter of the predicted line.
+*/
+void vpMbtMeLine::shiftSites(const vpImage<unsigned char> &I, double rho_, double theta_)
+{
+  this->rho = rho_;
+  this->theta = theta_;
+  a = cos(theta);
+  b = sin(theta);
+  c = -rho;
+
+  const int half = static_cast<int>((me->getMaskSize() - 1) >> 1);
+  const int rows = static_cast<int>(I.getHeight());
+  const int cols = static_cast<int>(I.getWidth());
+
+  for (std::list<vpMeSite>::iterator it = list.begin(); it != list.end();) {
+    const double d = a * it->ifloat + b * it->jfloat + c;
+    it->ifloat -= d * a;
+    it->jfloat -= d * b;
+    it->i = vpMath::round(it->ifloat);
+    it->j = vpMath::round(it->jfloat);
+    if (outOfImage(it->i, it->j, half, rows, cols)) {
+      it = list.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for (unsigned int k = 0; k < 2; k++) {
+    const double d = a * PExt[k].ifloat + b * PExt[k].jfloat + c;
+    PExt[k].ifloat -= d * a;
+    PExt[k].jfloat -= d * b;
+    PExt[k].i = vpMath::round(PExt[k].ifloat);
+    PExt[k].j = vpMath::round(PExt[k].jfloat);
+  }
+
+  updateDelta();
+}
+
 /*!
   Seek in the list of available points the two extremities of the line.
 */
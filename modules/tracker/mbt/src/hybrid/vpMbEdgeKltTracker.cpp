@@ -45,7 +45,7 @@
 #include <visp3/mbt/vpMbEdgeKltTracker.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
 vpMbEdgeKltTracker::vpMbEdgeKltTracker()
   : m_thresholdKLT(2.), m_thresholdMBT(2.), m_maxIterKlt(30), m_w_mbt(), m_w_klt(), m_error_hybrid(), m_w_hybrid()
@@ -1385,7 +1385,7 @@ void vpMbEdgeKltTracker::reInitModel(const vpImage<unsigned char> &I, const std:
                                      const vpHomogeneousMatrix &T)
 {
   // Reinit klt
-  #if (VISP_HAVE_OPENCV_VERSION < 0x020408)
+  #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408)
     if (cur != NULL) {
       cvReleaseImage(&cur);
       cur = NULL;
@@ -43,17 +43,32 @@
 #include <visp3/mbt/vpMbKltTracker.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
 #if defined(__APPLE__) && defined(__MACH__) // Apple OSX and iOS (Darwin)
 #include <TargetConditionals.h>             // To detect OSX or IOS using TARGET_OS_IPHONE or TARGET_OS_IOS macro
 #endif
 
+namespace
+{
+// Copy the settings of a klt tracker, vpKlt or vpKltOpencv, without its features
+template <class SrcKlt, class DstKlt> void copyKltSettings(const SrcKlt &src, DstKlt &dst)
+{
+  dst.setMaxFeatures(src.getMaxFeatures());
+  dst.setWindowSize(src.getWindowSize());
+  dst.setQuality(src.getQuality());
+  dst.setMinDistance(src.getMinDistance());
+  dst.setHarrisFreeParameter(src.getHarrisFreeParameter());
+  dst.setBlockSize(src.getBlockSize());
+  dst.setPyramidLevels(src.getPyramidLevels());
+}
+}
+
 vpMbKltTracker::vpMbKltTracker()
   :
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
     cur(),
-#else
+#elif defined(VISP_HAVE_OPENCV)
     cur(NULL),
 #endif
     c0Mo(), firstInitialisation(true), maskBorder(5), threshold_outlier(0.5), percentGood(0.6), ctTc0(), tracker(),
@@ -84,7 +99,7 @@ vpMbKltTracker::vpMbKltTracker()
 */
 vpMbKltTracker::~vpMbKltTracker()
 {
-#if (VISP_HAVE_OPENCV_VERSION < 0x020408)
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408)
   if (cur != NULL) {
     cvReleaseImage(&cur);
     cur = NULL;
@@ -158,7 +173,9 @@ void vpMbKltTracker::reinit(const vpImage<unsigned char> &I)
   c0Mo = m_cMo;
   ctTc0.eye();
 
+#if defined(VISP_HAVE_OPENCV)
   vpImageConvert::convert(I, cur);
+#endif
 
   m_cam.computeFov(I.getWidth(), I.getHeight());
 
@@ -168,7 +185,9 @@ void vpMbKltTracker::reinit(const vpImage<unsigned char> &I)
   }
 
 // mask
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+  vpImage<unsigned char> mask(I.getHeight(), I.getWidth(), 0);
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   cv::Mat mask((int)I.getRows(), (int)I.getCols(), CV_8UC1, cv::Scalar(0));
 #else
   IplImage *mask = cvCreateImage(cvSize((int)I.getWidth(), (int)I.getHeight()), IPL_DEPTH_8U, 1);
@@ -178,7 +197,11 @@ void vpMbKltTracker::reinit(const vpImage<unsigned char> &I)
   vpMbtDistanceKltPoints *kltpoly;
   vpMbtDistanceKltCylinder *kltPolyCylinder;
   if (useScanLine) {
+#if defined(VISP_HAVE_OPENCV)
     vpImageConvert::convert(faces.getMbScanLineRenderer().getMask(), mask);
+#else
+    mask = faces.getMbScanLineRenderer().getMask();
+#endif
   } else {
     unsigned char val = 255 /* - i*15*/;
     for (std::list<vpMbtDistanceKltPoints *>::const_iterator it = kltPolygons.begin(); it != kltPolygons.end(); ++it) {
@@ -209,7 +232,11 @@ void vpMbKltTracker::reinit(const vpImage<unsigned char> &I)
     }
   }
 
+#if defined(VISP_HAVE_OPENCV)
   tracker.initTracking(cur, mask);
+#else
+  tracker.initTracking(I, &mask);
+#endif
   //  tracker.track(cur); // AY: Not sure to be usefull but makes sure that
   //  the points are valid for tracking and avoid too fast reinitialisations.
   //  vpCTRACE << "init klt. detected " << tracker.getNbFeatures() << "
@@ -230,7 +257,7 @@ void vpMbKltTracker::reinit(const vpImage<unsigned char> &I)
       kltPolyCylinder->init(tracker, m_cMo);
   }
 
-#if (VISP_HAVE_OPENCV_VERSION < 0x020408)
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408)
   cvReleaseImage(&mask);
 #endif
 }
@@ -243,7 +270,7 @@ void vpMbKltTracker::resetTracker()
 {
   m_cMo.eye();
 
-#if (VISP_HAVE_OPENCV_VERSION < 0x020408)
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408)
   if (cur != NULL) {
     cvReleaseImage(&cur);
     cur = NULL;
@@ -325,7 +352,7 @@ void vpMbKltTracker::resetTracker()
   \warning Contrary to getKltPoints which returns a pointer on CvPoint2D32f.
   This function convert and copy the openCV KLT points into vpImagePoints.
 
-  \return the list of KLT points through vpKltOpencv.
+  \return the list of KLT points through the KLT tracker.
 */
 std::vector<vpImagePoint> vpMbKltTracker::getKltImagePoints() const
 {
@@ -346,7 +373,7 @@ std::vector<vpImagePoint> vpMbKltTracker::getKltImagePoints() const
   \warning Contrary to getKltPoints which returns a pointer on CvPoint2D32f.
   This function convert and copy the openCV KLT points into vpImagePoints.
 
-  \return the list of KLT points and their id through vpKltOpencv.
+  \return the list of KLT points and their id through the KLT tracker.
 */
 std::map<int, vpImagePoint> vpMbKltTracker::getKltImagePointsWithId() const
 {
@@ -365,22 +392,36 @@ std::map<int, vpImagePoint> vpMbKltTracker::getKltImagePointsWithId() const
   return kltPoints;
 }
 
+#if defined(VISP_HAVE_OPENCV)
 /*!
-  Set the new value of the klt tracker.
+  Get the settings of the klt tracker as a vpKlt. The features tracked by the
+  underlying vpKltOpencv tracker are not copied, use getKltOpencv() to get
+  them.
 
-  \param t : Klt tracker containing the new values.
+  \return klt tracker with the current settings.
 */
-void vpMbKltTracker::setKltOpencv(const vpKltOpencv &t)
+vpKlt vpMbKltTracker::getKlt() const
 {
-  tracker.setMaxFeatures(t.getMaxFeatures());
-  tracker.setWindowSize(t.getWindowSize());
-  tracker.setQuality(t.getQuality());
-  tracker.setMinDistance(t.getMinDistance());
-  tracker.setHarrisFreeParameter(t.getHarrisFreeParameter());
-  tracker.setBlockSize(t.getBlockSize());
-  tracker.setPyramidLevels(t.getPyramidLevels());
+  vpKlt klt;
+  copyKltSettings(tracker, klt);
+  return klt;
 }
 
+/*!
+  Set the new value of the klt tracker.
+
+  \param t : Klt tracker containing the new values.
+*/
+void vpMbKltTracker::setKltOpencv(const vpKltOpencv &t) { copyKltSettings(t, tracker); }
+#endif
+
+/*!
+  Set the new value of the klt tracker.
+
+  \param t : Klt tracker containing the new values.
+*/
+void vpMbKltTracker::setKlt(const vpKlt &t) { copyKltSettings(t, tracker); }
+
 /*!
   Set the camera parameters.
 
@@ -427,7 +468,11 @@ void vpMbKltTracker::setPose(const vpImage<unsigned char> * const I, const vpIma
   } else {
     vpMbtDistanceKltPoints *kltpoly;
 
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+    std::vector<vpImagePoint> init_pts;
+    std::vector<long> init_ids;
+    std::vector<vpImagePoint> guess_pts;
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
     std::vector<cv::Point2f> init_pts;
     std::vector<long> init_ids;
     std::vector<cv::Point2f> guess_pts;
@@ -486,7 +531,7 @@ void vpMbKltTracker::setPose(const vpImage<unsigned char> * const I, const vpIma
         std::map<int, vpImagePoint>::const_iterator iter = kltpoly->getCurrentPoints().begin();
         // nbCur+= (unsigned int)kltpoly->getCurrentPoints().size();
         for (; iter != kltpoly->getCurrentPoints().end(); ++iter) {
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020408)
 #if TARGET_OS_IPHONE
           if (std::find(init_ids.begin(), init_ids.end(), (long)(kltpoly->getCurrentPointsInd())[(int)iter->first]) !=
               init_ids.end())
@@ -506,9 +551,13 @@ void vpMbKltTracker::setPose(const vpImage<unsigned char> * const I, const vpIma
           cdp[1] = iter->second.get_i();
           cdp[2] = 1.0;
 
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+          init_pts.push_back(vpImagePoint(cdp[1], cdp[0]));
+#else
           cv::Point2f p((float)cdp[0], (float)cdp[1]);
           init_pts.push_back(p);
+#endif
 #if TARGET_OS_IPHONE
           init_ids.push_back((size_t)(kltpoly->getCurrentPointsInd())[(int)iter->first]);
 #else
@@ -532,7 +581,9 @@ void vpMbKltTracker::setPose(const vpImage<unsigned char> * const I, const vpIma
           cdp[1] = (cdp[0] * cdGc[1][0] + cdp[1] * cdGc[1][1] + cdGc[1][2]) / p_mu_t_2;
 
 // Set value to the KLT tracker
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+          guess_pts.push_back(vpImagePoint(cdp[1], cdp[0]));
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
           cv::Point2f p_guess((float)cdp[0], (float)cdp[1]);
           guess_pts.push_back(p_guess);
 #else
@@ -543,13 +594,15 @@ void vpMbKltTracker::setPose(const vpImage<unsigned char> * const I, const vpIma
       }
     }
 
+#if defined(VISP_HAVE_OPENCV)
     if (I) {
       vpImageConvert::convert(*I, cur);
     } else {
       vpImageConvert::convert(m_I, cur);
     }
+#endif
 
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020408)
     tracker.setInitialGuess(init_pts, guess_pts, init_ids);
 #else
     tracker.setInitialGuess(&init_pts, &guess_pts, init_ids, iter_pts);
@@ -678,8 +731,12 @@ void vpMbKltTracker::initFaceFromLines(vpMbtPolygon &polygon)
 */
 void vpMbKltTracker::preTracking(const vpImage<unsigned char> &I)
 {
+#if defined(VISP_HAVE_OPENCV)
   vpImageConvert::convert(I, cur);
   tracker.track(cur);
+#else
+  tracker.track(I);
+#endif
 
   m_nbInfos = 0;
   m_nbFaceUsed = 0;
@@ -1398,7 +1455,7 @@ void vpMbKltTracker::reInitModel(const vpImage<unsigned char> &I, const std::str
 {
   m_cMo.eye();
 
-#if (VISP_HAVE_OPENCV_VERSION < 0x020408)
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408)
   if (cur != NULL) {
     cvReleaseImage(&cur);
     cur = NULL;
@@ -40,7 +40,7 @@
 #include <visp3/mbt/vpMbtDistanceKltCylinder.h>
 #include <visp3/mbt/vpMbtDistanceKltPoints.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
 #if defined(VISP_HAVE_CLIPPER)
 #include <clipper.hpp> // clipper private library
@@ -100,10 +100,14 @@ void vpMbtDistanceKltCylinder::buildFrom(const vpPoint &p1, const vpPoint &p2, c
   all the map detected in the image, are parsed in order to extract the id of
   the points that are indeed in the face.
 
-  \param _tracker : ViSP OpenCV KLT Tracker.
+  \param _tracker : ViSP KLT Tracker.
   \param cMo : Pose of the object in the camera frame at initialization.
 */
+#if defined(VISP_HAVE_OPENCV)
 void vpMbtDistanceKltCylinder::init(const vpKltOpencv &_tracker, const vpHomogeneousMatrix &cMo)
+#else
+void vpMbtDistanceKltCylinder::init(const vpKlt &_tracker, const vpHomogeneousMatrix &cMo)
+#endif
 {
   c0Mo = cMo;
   cylinder.changeFrame(cMo);
@@ -193,7 +197,11 @@ void vpMbtDistanceKltCylinder::init(const vpKltOpencv &_tracker, const vpHomogen
   \return the number of points that are tracked in this face and in this
   instanciation of the tracker
 */
+#if defined(VISP_HAVE_OPENCV)
 unsigned int vpMbtDistanceKltCylinder::computeNbDetectedCurrent(const vpKltOpencv &_tracker)
+#else
+unsigned int vpMbtDistanceKltCylinder::computeNbDetectedCurrent(const vpKlt &_tracker)
+#endif
 {
   long id;
   float x, y;
@@ -374,14 +382,19 @@ bool vpMbtDistanceKltCylinder::isTrackedFeature(int _id)
   built-in erosion) to avoid to consider pixels near the limits of the face.
 */
 void vpMbtDistanceKltCylinder::updateMask(
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+    vpImage<unsigned char> &mask,
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
     cv::Mat &mask,
 #else
     IplImage *mask,
 #endif
     unsigned char nb, unsigned int shiftBorder)
 {
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+  int width = (int)mask.getWidth();
+  int height = (int)mask.getHeight();
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   int width = mask.cols;
   int height = mask.rows;
 #else
@@ -464,9 +477,14 @@ void vpMbtDistanceKltCylinder::updateMask(
         j_max = width;
       }
 
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020408)
       for (int i = i_min; i < i_max; i++) {
         double i_d = (double)i;
+#if !defined(VISP_HAVE_OPENCV)
+        unsigned char *row = mask[i];
+#else
+        unsigned char *row = mask.ptr<uchar>(i);
+#endif
 
         for (int j = j_min; j < j_max; j++) {
           double j_d = (double)j;
@@ -474,7 +492,7 @@ void vpMbtDistanceKltCylinder::updateMask(
 #if defined(VISP_HAVE_CLIPPER)
           imPt.set_ij(i_d, j_d);
           if (polygon_test.isInside(imPt)) {
-            mask.ptr<uchar>(i)[j] = nb;
+            row[j] = nb;
           }
 #else
           if (shiftBorder != 0) {
@@ -483,11 +501,11 @@ void vpMbtDistanceKltCylinder::updateMask(
                 vpPolygon::isInside(roi, i_d - shiftBorder_d, j_d + shiftBorder_d) &&
                 vpPolygon::isInside(roi, i_d + shiftBorder_d, j_d - shiftBorder_d) &&
                 vpPolygon::isInside(roi, i_d - shiftBorder_d, j_d - shiftBorder_d)) {
-              mask.at<unsigned char>(i, j) = nb;
+              row[j] = nb;
             }
           } else {
             if (vpPolygon::isInside(roi, i, j)) {
-              mask.at<unsigned char>(i, j) = nb;
+              row[j] = nb;
             }
           }
 #endif
@@ -37,11 +37,17 @@
  *
  *****************************************************************************/
 
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpPolygon.h>
 #include <visp3/mbt/vpMbtDistanceKltPoints.h>
 #include <visp3/me/vpMeTracker.h>
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
 #if defined(VISP_HAVE_CLIPPER)
 #include <clipper.hpp> // clipper private library
@@ -58,8 +64,8 @@
 vpMbtDistanceKltPoints::vpMbtDistanceKltPoints()
   : H(), N(), N_cur(), invd0(1.), cRc0_0n(), initPoints(std::map<int, vpImagePoint>()),
     curPoints(std::map<int, vpImagePoint>()), curPointsInd(std::map<int, int>()), nbPointsCur(0), nbPointsInit(0),
-    minNbPoint(4), enoughPoints(false), dt(1.), d0(1.), cam(), isTrackedKltPoints(true), polygon(NULL),
-    hiddenface(NULL), useScanLine(false)
+    minNbPoint(4), enoughPoints(false), dt(1.), d0(1.), cam(), isTrackedKltPoints(true), m_xCur(), m_yCur(),
+    m_xInit(), m_yInit(), polygon(NULL), hiddenface(NULL), useScanLine(false)
 {
 }
 
@@ -74,10 +80,14 @@ vpMbtDistanceKltPoints::~vpMbtDistanceKltPoints() {}
   the map detected in the image, are parsed in order to extract the id of the
   points that are indeed in the face.
 
-  \param _tracker : ViSP OpenCV KLT Tracker.
+  \param _tracker : ViSP KLT Tracker.
   \param mask: Mask image or NULL if not wanted. Mask values that are set to true are considered in the tracking. To disable a pixel, set false.
 */
+#if defined(VISP_HAVE_OPENCV)
 void vpMbtDistanceKltPoints::init(const vpKltOpencv &_tracker, const vpImage<bool> *mask)
+#else
+void vpMbtDistanceKltPoints::init(const vpKlt &_tracker, const vpImage<bool> *mask)
+#endif
 {
   // extract ids of the points in the face
   nbPointsInit = 0;
@@ -124,6 +134,7 @@ void vpMbtDistanceKltPoints::init(const vpKltOpencv &_tracker, const vpImage<boo
 
   nbPointsInit = (unsigned int)initPoints.size();
   nbPointsCur = (unsigned int)curPoints.size();
+  updateFeatureArrays();
 
   if (nbPointsCur >= minNbPoint)
     enoughPoints = true;
@@ -150,7 +161,11 @@ void vpMbtDistanceKltPoints::init(const vpKltOpencv &_tracker, const vpImage<boo
   instanciation of the tracker
   \param mask: Mask image or NULL if not wanted. Mask values that are set to true are considered in the tracking. To disable a pixel, set false.
 */
+#if defined(VISP_HAVE_OPENCV)
 unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKltOpencv &_tracker, const vpImage<bool> *mask)
+#else
+unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKlt &_tracker, const vpImage<bool> *mask)
+#endif
 {
   long id;
   float x, y;
@@ -172,6 +187,7 @@ unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKltOpencv
   }
 
   nbPointsCur = (unsigned int)curPoints.size();
+  updateFeatureArrays();
 
   if (nbPointsCur >= minNbPoint)
     enoughPoints = true;
@@ -181,11 +197,35 @@ unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKltOpencv
   return nbPointsCur;
 }
 
+/*!
+  Copy the coordinates in meter of the current points and of their initial
+  position in contiguous arrays, in the order of curPoints. It has to be
+  called each time curPoints is modified, so that the computation of the
+  interaction matrix does not look the points up in the maps.
+*/
+void vpMbtDistanceKltPoints::updateFeatureArrays()
+{
+  m_xCur.resize(curPoints.size());
+  m_yCur.resize(curPoints.size());
+  m_xInit.resize(curPoints.size());
+  m_yInit.resize(curPoints.size());
+
+  size_t k = 0;
+  for (std::map<int, vpImagePoint>::const_iterator iter = curPoints.begin(); iter != curPoints.end(); ++iter, k++) {
+    vpPixelMeterConversion::convertPoint(cam, iter->second.get_j(), iter->second.get_i(), m_xCur[k], m_yCur[k]);
+
+    vpPixelMeterConversion::convertPoint(cam, initPoints[iter->first], m_xInit[k], m_yInit[k]);
+  }
+}
+
 /*!
   Compute the interaction matrix and the residu vector for the face.
   The method assumes that these two objects are properly sized in order to be
   able to improve the speed with the use of SubCoVector and subMatrix.
 
+  The points are read from contiguous arrays and two points are processed at
+  once with SSE2 when available.
+
   \warning The function preCompute must be called before the this method.
 
   \param _R : the residu vector
@@ -193,23 +233,85 @@ unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKltOpencv
 */
 void vpMbtDistanceKltPoints::computeInteractionMatrixAndResidu(vpColVector &_R, vpMatrix &_J)
 {
+  const unsigned int nbPoints = (unsigned int)m_xCur.size();
+  const double den = -(d0 - dt);
   unsigned int index_ = 0;
 
-  std::map<int, vpImagePoint>::const_iterator iter = curPoints.begin();
-  for (; iter != curPoints.end(); ++iter) {
-    int id(iter->first);
-    double i_cur(iter->second.get_i()), j_cur(iter->second.get_j());
-
-    double x_cur(0), y_cur(0);
-    vpPixelMeterConversion::convertPoint(cam, j_cur, i_cur, x_cur, y_cur);
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && nbPoints >= 2) {
+    const __m128d vh00 = _mm_set1_pd(H[0][0]), vh01 = _mm_set1_pd(H[0][1]), vh02 = _mm_set1_pd(H[0][2]);
+    const __m128d vh10 = _mm_set1_pd(H[1][0]), vh11 = _mm_set1_pd(H[1][1]), vh12 = _mm_set1_pd(H[1][2]);
+    const __m128d vh20 = _mm_set1_pd(H[2][0]), vh21 = _mm_set1_pd(H[2][1]), vh22 = _mm_set1_pd(H[2][2]);
+    const __m128d vn0 = _mm_set1_pd(cRc0_0n[0]), vn1 = _mm_set1_pd(cRc0_0n[1]), vn2 = _mm_set1_pd(cRc0_0n[2]);
+    const __m128d vden = _mm_set1_pd(den);
+    const __m128d vone = _mm_set1_pd(1.0);
+    const __m128d vsignMask = _mm_set1_pd(-0.0);
+    const __m128d veps = _mm_set1_pd(std::numeric_limits<double>::epsilon());
+
+    double invZ[2], xInvZ[2], yInvZ[2], xy[2], xx1[2], yy1[2];
+    for (; index_ + 1 < nbPoints; index_ += 2) {
+      const __m128d x0 = _mm_loadu_pd(&m_xInit[index_]);
+      const __m128d y0 = _mm_loadu_pd(&m_yInit[index_]);
+      const __m128d x = _mm_loadu_pd(&m_xCur[index_]);
+      const __m128d y = _mm_loadu_pd(&m_yCur[index_]);
+
+      // Transfer of the initial points with the homography
+      const __m128d p2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x0, vh20), _mm_mul_pd(y0, vh21)), vh22);
+      if (_mm_movemask_pd(_mm_cmplt_pd(_mm_andnot_pd(vsignMask, p2), veps)) != 0) {
+        throw vpException(vpException::divideByZeroError, "the depth of the point is calculated to zero");
+      }
+      const __m128d x0_transform =
+          _mm_div_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x0, vh00), _mm_mul_pd(y0, vh01)), vh02), p2);
+      const __m128d y0_transform =
+          _mm_div_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x0, vh10), _mm_mul_pd(y0, vh11)), vh12), p2);
+
+      const __m128d vinvZ =
+          _mm_div_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(vn0, x), _mm_mul_pd(vn1, y)), vn2), vden);
+
+      _mm_storeu_pd(invZ, vinvZ);
+      _mm_storeu_pd(xInvZ, _mm_mul_pd(x, vinvZ));
+      _mm_storeu_pd(yInvZ, _mm_mul_pd(y, vinvZ));
+      _mm_storeu_pd(xy, _mm_mul_pd(x, y));
+      _mm_storeu_pd(xx1, _mm_add_pd(vone, _mm_mul_pd(x, x)));
+      _mm_storeu_pd(yy1, _mm_add_pd(vone, _mm_mul_pd(y, y)));
+
+      // The residuals of the two points are interleaved as (x, y)
+      const __m128d ex = _mm_sub_pd(x0_transform, x);
+      const __m128d ey = _mm_sub_pd(y0_transform, y);
+      _mm_storeu_pd(&_R[2 * index_], _mm_unpacklo_pd(ex, ey));
+      _mm_storeu_pd(&_R[2 * index_ + 2], _mm_unpackhi_pd(ex, ey));
+
+      for (unsigned int k = 0; k < 2; k++) {
+        double *J0 = _J[2 * (index_ + k)];
+        double *J1 = _J[2 * (index_ + k) + 1];
+        const double x_cur = m_xCur[index_ + k];
+        const double y_cur = m_yCur[index_ + k];
+
+        J0[0] = -invZ[k];
+        J0[1] = 0;
+        J0[2] = xInvZ[k];
+        J0[3] = xy[k];
+        J0[4] = -xx1[k];
+        J0[5] = y_cur;
+
+        J1[0] = 0;
+        J1[1] = -invZ[k];
+        J1[2] = yInvZ[k];
+        J1[3] = yy1[k];
+        J1[4] = -xy[k];
+        J1[5] = -x_cur;
+      }
+    }
+  }
+#endif
 
-    vpImagePoint iP0 = initPoints[id];
-    double x0(0), y0(0);
-    vpPixelMeterConversion::convertPoint(cam, iP0, x0, y0);
+  for (; index_ < nbPoints; index_++) {
+    const double x_cur = m_xCur[index_];
+    const double y_cur = m_yCur[index_];
 
     double x0_transform,
         y0_transform; // equivalent x and y in the first image (reference)
-    computeP_mu_t(x0, y0, x0_transform, y0_transform, H);
+    computeP_mu_t(m_xInit[index_], m_yInit[index_], x0_transform, y0_transform, H);
 
     double invZ = compute_1_over_Z(x_cur, y_cur);
 
@@ -229,7 +331,6 @@ void vpMbtDistanceKltPoints::computeInteractionMatrixAndResidu(vpColVector &_R,
 
     _R[2 * index_] = (x0_transform - x_cur);
     _R[2 * index_ + 1] = (y0_transform - y_cur);
-    index_++;
   }
 }
 
@@ -352,14 +453,19 @@ bool vpMbtDistanceKltPoints::isTrackedFeature(int _id)
   built-in erosion) to avoid to consider pixels near the limits of the face.
 */
 void vpMbtDistanceKltPoints::updateMask(
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+    vpImage<unsigned char> &mask,
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
     cv::Mat &mask,
 #else
     IplImage *mask,
 #endif
     unsigned char nb, unsigned int shiftBorder)
 {
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV)
+  int width = (int)mask.getWidth();
+  int height = (int)mask.getHeight();
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   int width = mask.cols;
   int height = mask.rows;
 #else
@@ -440,9 +546,14 @@ void vpMbtDistanceKltPoints::updateMask(
     j_max = width;
   }
 
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   for (int i = i_min; i < i_max; i++) {
     double i_d = (double)i;
+#if !defined(VISP_HAVE_OPENCV)
+    unsigned char *row = mask[i];
+#else
+    unsigned char *row = mask.ptr<uchar>(i);
+#endif
 
     for (int j = j_min; j < j_max; j++) {
       double j_d = (double)j;
@@ -450,7 +561,7 @@ void vpMbtDistanceKltPoints::updateMask(
 #if defined(VISP_HAVE_CLIPPER)
       imPt.set_ij(i_d, j_d);
       if (polygon_test.isInside(imPt)) {
-        mask.ptr<uchar>(i)[j] = nb;
+        row[j] = nb;
       }
 #else
       if (shiftBorder != 0) {
@@ -458,11 +569,11 @@ void vpMbtDistanceKltPoints::updateMask(
             vpPolygon::isInside(roi, i_d - shiftBorder_d, j_d + shiftBorder_d) &&
             vpPolygon::isInside(roi, i_d + shiftBorder_d, j_d - shiftBorder_d) &&
             vpPolygon::isInside(roi, i_d - shiftBorder_d, j_d - shiftBorder_d)) {
-          mask.at<unsigned char>(i, j) = nb;
+          row[j] = nb;
         }
       } else {
         if (vpPolygon::isInside(roi, i, j)) {
-          mask.at<unsigned char>(i, j) = nb;
+          row[j] = nb;
         }
       }
 #endif
@@ -530,6 +641,7 @@ void vpMbtDistanceKltPoints::removeOutliers(const vpColVector &_w, const double
   if (nbSupp != 0) {
     curPoints = tmp;
     curPointsInd = tmp2;
+    updateFeatureArrays();
     if (nbPointsCur >= minNbPoint)
       enoughPoints = true;
     else
@@ -0,0 +1,443 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Bounding volume hierarchy over the faces of a CAD model.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbBoundingVolumeHierarchy.cpp
+  \brief Bounding volume hierarchy over the faces of a CAD model.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <visp3/core/vpException.h>
+#include <visp3/mbt/vpMbBoundingVolumeHierarchy.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Margin on the parameter of the segment, the hits at the extremities are not occlusions
+const double segment_margin = 1e-6;
+
+// Orders polygon indexes by the coordinate of their centroid along an axis
+struct vpCentroidComparator {
+  vpCentroidComparator(const std::vector<double> &centroids, unsigned int axis) : m_centroids(centroids), m_axis(axis)
+  {
+  }
+  bool operator()(unsigned int a, unsigned int b) const
+  {
+    return m_centroids[3 * a + m_axis] < m_centroids[3 * b + m_axis];
+  }
+  const std::vector<double> &m_centroids;
+  unsigned int m_axis;
+};
+
+// Checks if the segment origin + t dir, t in [0, 1], crosses a box
+bool intersectBox(const double *bmin, const double *bmax, const double *origin, const double *dir,
+                  const double *inv_dir)
+{
+  double tmin = 0.0, tmax = 1.0;
+  for (unsigned int i = 0; i < 3; i++) {
+    if (dir[i] == 0.0) {
+      if (origin[i] < bmin[i] || origin[i] > bmax[i]) {
+        return false;
+      }
+    } else {
+      double t1 = (bmin[i] - origin[i]) * inv_dir[i];
+      double t2 = (bmax[i] - origin[i]) * inv_dir[i];
+      if (t1 > t2) {
+        std::swap(t1, t2);
+      }
+      tmin = (std::max)(tmin, t1);
+      tmax = (std::min)(tmax, t2);
+      if (tmin > tmax) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Signed distance to a plane of the corner of a box the farthest along the normal (positive) or the opposite
+// direction (negative)
+inline double farthestCorner(const double *plane, const double *bmin, const double *bmax, bool positive)
+{
+  double d = plane[3];
+  for (unsigned int i = 0; i < 3; i++) {
+    d += plane[i] * (((plane[i] >= 0.0) == positive) ? bmax[i] : bmin[i]);
+  }
+  return d;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The hierarchy is empty until build() is called.
+*/
+vpMbBoundingVolumeHierarchy::vpMbBoundingVolumeHierarchy()
+  : m_maxLeafSize(4), m_nodes(), m_order(), m_boxes(), m_planes(), m_firstVertex(), m_vertices(), m_occluders()
+{
+}
+
+/*!
+  Build the hierarchy over polygons given in the object frame.
+
+  The polygons are recursively split in two halves along the largest extent
+  of their centroids, until there are no more than getMaxLeafSize() polygons
+  in a node.
+
+  \param polygons : Vertices of each polygon, only the object frame
+  coordinates are used. The polygons are identified in the queries by their
+  index in this list.
+  \param occluders : For each polygon, true if it stops the rays in
+  isOccluded(). Polygons with less than three vertices never stop the rays.
+*/
+void vpMbBoundingVolumeHierarchy::build(const std::vector<std::vector<vpPoint> > &polygons,
+                                        const std::vector<bool> &occluders)
+{
+  if (occluders.size() != polygons.size()) {
+    throw vpException(vpException::dimensionError, "%d polygons but %d occluder flags", (int)polygons.size(),
+                      (int)occluders.size());
+  }
+
+  clear();
+  const unsigned int nb = static_cast<unsigned int>(polygons.size());
+  m_boxes.resize(6 * nb);
+  m_planes.resize(4 * nb, 0.0);
+  m_firstVertex.resize(nb + 1);
+  m_occluders.resize(nb);
+  std::vector<double> centroids(3 * nb, 0.0);
+
+  for (unsigned int i = 0; i < nb; i++) {
+    const std::vector<vpPoint> &poly = polygons[i];
+    const unsigned int nbpt = static_cast<unsigned int>(poly.size());
+    m_firstVertex[i] = static_cast<unsigned int>(m_vertices.size() / 3);
+
+    double *box = &m_boxes[6 * i];
+    for (unsigned int k = 0; k < 3; k++) {
+      box[k] = (nbpt > 0) ? std::numeric_limits<double>::max() : 0.0;
+      box[k + 3] = (nbpt > 0) ? -std::numeric_limits<double>::max() : 0.0;
+    }
+    for (unsigned int j = 0; j < nbpt; j++) {
+      const double P[3] = {poly[j].get_oX(), poly[j].get_oY(), poly[j].get_oZ()};
+      for (unsigned int k = 0; k < 3; k++) {
+        m_vertices.push_back(P[k]);
+        centroids[3 * i + k] += P[k] / nbpt;
+        box[k] = (std::min)(box[k], P[k]);
+        box[k + 3] = (std::max)(box[k + 3], P[k]);
+      }
+    }
+
+    // Newell's method, robust to concave and slightly non planar polygons
+    double *plane = &m_planes[4 * i];
+    for (unsigned int j = 0; j < nbpt; j++) {
+      const vpPoint &cur = poly[j], &next = poly[(j + 1) % nbpt];
+      plane[0] += (cur.get_oY() - next.get_oY()) * (cur.get_oZ() + next.get_oZ());
+      plane[1] += (cur.get_oZ() - next.get_oZ()) * (cur.get_oX() + next.get_oX());
+      plane[2] += (cur.get_oX() - next.get_oX()) * (cur.get_oY() + next.get_oY());
+    }
+    double norm = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+    m_occluders[i] = occluders[i] && nbpt >= 3 && norm > std::numeric_limits<double>::epsilon();
+    if (m_occluders[i]) {
+      for (unsigned int k = 0; k < 3; k++) {
+        plane[k] /= norm;
+      }
+      plane[3] = -(plane[0] * centroids[3 * i] + plane[1] * centroids[3 * i + 1] + plane[2] * centroids[3 * i + 2]);
+    }
+  }
+  m_firstVertex[nb] = static_cast<unsigned int>(m_vertices.size() / 3);
+
+  if (nb > 0) {
+    m_order.resize(nb);
+    for (unsigned int i = 0; i < nb; i++) {
+      m_order[i] = i;
+    }
+    m_nodes.reserve(2 * nb);
+    buildNode(0, nb, centroids);
+  }
+}
+
+unsigned int vpMbBoundingVolumeHierarchy::buildNode(unsigned int first, unsigned int last,
+                                                    std::vector<double> &centroids)
+{
+  const unsigned int id = static_cast<unsigned int>(m_nodes.size());
+  m_nodes.push_back(vpNode());
+
+  vpNode node;
+  double cmin[3], cmax[3];
+  for (unsigned int k = 0; k < 3; k++) {
+    node.bmin[k] = cmin[k] = std::numeric_limits<double>::max();
+    node.bmax[k] = cmax[k] = -std::numeric_limits<double>::max();
+  }
+  for (unsigned int i = first; i < last; i++) {
+    const unsigned int index = m_order[i];
+    for (unsigned int k = 0; k < 3; k++) {
+      node.bmin[k] = (std::min)(node.bmin[k], m_boxes[6 * index + k]);
+      node.bmax[k] = (std::max)(node.bmax[k], m_boxes[6 * index + k + 3]);
+      cmin[k] = (std::min)(cmin[k], centroids[3 * index + k]);
+      cmax[k] = (std::max)(cmax[k], centroids[3 * index + k]);
+    }
+  }
+
+  if (last - first <= m_maxLeafSize) {
+    node.first = first;
+    node.count = last - first;
+    m_nodes[id] = node;
+    return id;
+  }
+
+  unsigned int axis = 0;
+  for (unsigned int k = 1; k < 3; k++) {
+    if (cmax[k] - cmin[k] > cmax[axis] - cmin[axis]) {
+      axis = k;
+    }
+  }
+  const unsigned int middle = first + (last - first) / 2;
+  std::nth_element(m_order.begin() + first, m_order.begin() + middle, m_order.begin() + last,
+                   vpCentroidComparator(centroids, axis));
+
+  m_nodes[id] = node;
+  buildNode(first, middle, centroids);
+  const unsigned int right = buildNode(middle, last, centroids);
+  m_nodes[id].right = right;
+  return id;
+}
+
+/*!
+  Release the hierarchy.
+*/
+void vpMbBoundingVolumeHierarchy::clear()
+{
+  m_nodes.clear();
+  m_order.clear();
+  m_boxes.clear();
+  m_planes.clear();
+  m_firstVertex.clear();
+  m_vertices.clear();
+  m_occluders.clear();
+}
+
+/*!
+  Flag the polygons whose bounding box intersects the viewing frustum.
+
+  A bounding box is outside of the frustum when it lies entirely behind the
+  camera or on the outer side of one of the planes going through the optical
+  center and a border of the image. This is the usual conservative test: a
+  box near a corner of the frustum may be flagged inside while the polygon
+  does not project in the image.
+
+  \param cMo : Pose of the object in the camera frame.
+  \param cam : Camera parameters.
+  \param width, height : Image size. When one of them is 0, only the polygons
+  entirely behind the camera are discarded.
+  \param inFrustum : For each polygon given to build(), true if its bounding
+  box intersects the frustum.
+*/
+void vpMbBoundingVolumeHierarchy::frustumCulling(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                                                 unsigned int width, unsigned int height,
+                                                 std::vector<bool> &inFrustum) const
+{
+  const unsigned int nb = getNbPolygons();
+  inFrustum.assign(nb, false);
+  if (m_nodes.empty()) {
+    return;
+  }
+
+  // Planes in the camera frame, the inner side is positive: z >= 0, u >= 0, u <= width, v >= 0, v <= height
+  const double px = cam.get_px(), py = cam.get_py(), u0 = cam.get_u0(), v0 = cam.get_v0();
+  double cplanes[5][3] = {{0.0, 0.0, 1.0},
+                          {px, 0.0, u0},
+                          {-px, 0.0, width - u0},
+                          {0.0, py, v0},
+                          {0.0, -py, height - v0}};
+  const unsigned int nbPlanes = (width > 0 && height > 0) ? 5 : 1;
+
+  // The planes go through the optical center, moved in the object frame
+  double planes[5][4];
+  for (unsigned int n = 0; n < nbPlanes; n++) {
+    for (unsigned int k = 0; k < 3; k++) {
+      planes[n][k] = cplanes[n][0] * cMo[0][k] + cplanes[n][1] * cMo[1][k] + cplanes[n][2] * cMo[2][k];
+    }
+    planes[n][3] = cplanes[n][0] * cMo[0][3] + cplanes[n][1] * cMo[1][3] + cplanes[n][2] * cMo[2][3];
+  }
+
+  // Depth-first traversal, each entry carries the planes its box still crosses
+  std::vector<std::pair<unsigned int, unsigned int> > stack;
+  stack.push_back(std::make_pair(0u, (1u << nbPlanes) - 1));
+  while (!stack.empty()) {
+    const unsigned int id = stack.back().first;
+    unsigned int mask = stack.back().second;
+    stack.pop_back();
+    const vpNode &node = m_nodes[id];
+
+    bool outside = false;
+    for (unsigned int n = 0; n < nbPlanes && !outside; n++) {
+      if (mask & (1u << n)) {
+        if (farthestCorner(planes[n], node.bmin, node.bmax, true) < 0.0) {
+          outside = true;
+        } else if (farthestCorner(planes[n], node.bmin, node.bmax, false) >= 0.0) {
+          mask &= ~(1u << n);
+        }
+      }
+    }
+    if (outside) {
+      continue;
+    }
+
+    if (node.count == 0) {
+      stack.push_back(std::make_pair(node.right, mask));
+      stack.push_back(std::make_pair(id + 1, mask));
+      continue;
+    }
+
+    for (unsigned int i = node.first; i < node.first + node.count; i++) {
+      const unsigned int index = m_order[i];
+      const double *bmin = &m_boxes[6 * index], *bmax = &m_boxes[6 * index + 3];
+      bool inside = true;
+      for (unsigned int n = 0; n < nbPlanes && inside; n++) {
+        if ((mask & (1u << n)) && farthestCorner(planes[n], bmin, bmax, true) < 0.0) {
+          inside = false;
+        }
+      }
+      inFrustum[index] = inside;
+    }
+  }
+}
+
+bool vpMbBoundingVolumeHierarchy::intersectPolygon(unsigned int index, const double *origin, const double *dir) const
+{
+  const double *plane = &m_planes[4 * index];
+  const double denom = plane[0] * dir[0] + plane[1] * dir[1] + plane[2] * dir[2];
+  if (std::fabs(denom) <= std::numeric_limits<double>::epsilon()) {
+    // Segment parallel to the plane
+    return false;
+  }
+  const double t = -(plane[0] * origin[0] + plane[1] * origin[1] + plane[2] * origin[2] + plane[3]) / denom;
+  if (t <= segment_margin || t >= 1.0 - segment_margin) {
+    return false;
+  }
+
+  // Even-odd rule in the coordinate plane the most parallel to the polygon
+  unsigned int drop = 0;
+  for (unsigned int k = 1; k < 3; k++) {
+    if (std::fabs(plane[k]) > std::fabs(plane[drop])) {
+      drop = k;
+    }
+  }
+  const unsigned int a = (drop + 1) % 3, b = (drop + 2) % 3;
+  const double pa = origin[a] + t * dir[a], pb = origin[b] + t * dir[b];
+
+  const unsigned int first = m_firstVertex[index], nbpt = m_firstVertex[index + 1] - first;
+  const double *vertices = &m_vertices[3 * first];
+  bool inside = false;
+  for (unsigned int i = 0, j = nbpt - 1; i < nbpt; j = i++) {
+    const double ia = vertices[3 * i + a], ib = vertices[3 * i + b];
+    const double ja = vertices[3 * j + a], jb = vertices[3 * j + b];
+    if (((ib > pb) != (jb > pb)) && (pa < (ja - ia) * (pb - ib) / (jb - ib) + ia)) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+/*!
+  Check if a segment crosses one of the occluding polygons.
+
+  The extremities of the segment are excluded, a polygon that contains the
+  target point does not occlude it.
+
+  \param origin : First extremity, usually the optical center, in the
+  object frame.
+  \param target : Second extremity, usually a point of a polygon, in the
+  object frame.
+  \param ignored : Index of a polygon that is not considered, usually the one
+  that contains the target point. Use -1 to consider all of them.
+
+  \return True if an occluding polygon crosses the segment.
+*/
+bool vpMbBoundingVolumeHierarchy::isOccluded(const vpColVector &origin, const vpColVector &target, int ignored) const
+{
+  if (origin.size() < 3 || target.size() < 3) {
+    throw vpException(vpException::dimensionError, "Points must have 3 coordinates");
+  }
+  if (m_nodes.empty()) {
+    return false;
+  }
+
+  const double o[3] = {origin[0], origin[1], origin[2]};
+  double dir[3], inv_dir[3];
+  for (unsigned int k = 0; k < 3; k++) {
+    dir[k] = target[k] - o[k];
+    inv_dir[k] = (dir[k] != 0.0) ? 1.0 / dir[k] : 0.0;
+  }
+
+  return isOccluded(0, o, dir, inv_dir, ignored);
+}
+
+bool vpMbBoundingVolumeHierarchy::isOccluded(unsigned int node_id, const double *origin, const double *dir,
+                                             const double *inv_dir, int ignored) const
+{
+  const vpNode &node = m_nodes[node_id];
+  if (!intersectBox(node.bmin, node.bmax, origin, dir, inv_dir)) {
+    return false;
+  }
+
+  if (node.count == 0) {
+    return isOccluded(node_id + 1, origin, dir, inv_dir, ignored) ||
+           isOccluded(node.right, origin, dir, inv_dir, ignored);
+  }
+
+  for (unsigned int i = node.first; i < node.first + node.count; i++) {
+    const unsigned int index = m_order[i];
+    if (m_occluders[index] && static_cast<int>(index) != ignored && intersectPolygon(index, origin, dir)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+  Set the maximal number of polygons in a leaf. It is taken into account by
+  the next call to build().
+
+  \param size : Maximal number of polygons, must be greater than 0.
+*/
+void vpMbBoundingVolumeHierarchy::setMaxLeafSize(unsigned int size)
+{
+  if (size == 0) {
+    throw vpException(vpException::badValue, "The maximal leaf size must be greater than 0");
+  }
+  m_maxLeafSize = size;
+}
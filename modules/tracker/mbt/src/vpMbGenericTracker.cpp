@@ -37,12 +37,54 @@
 
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpTime.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
 
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+#include <exception>
+#endif
+
+namespace
+{
+// Add the wall time of its scope to a tracking statistic, if enabled
+class vpScopedStatisticTimer
+{
+public:
+  vpScopedStatisticTimer(bool enabled, double &time)
+    : m_time(enabled ? &time : NULL), m_start(enabled ? vpTime::measureTimeMs() : 0.0)
+  {
+  }
+  ~vpScopedStatisticTimer()
+  {
+    if (m_time != NULL) {
+      *m_time += vpTime::measureTimeMs() - m_start;
+    }
+  }
+
+private:
+  double *m_time;
+  double m_start;
+};
+
+// Weighted residual norm of a block of rows
+double weightedResidual(const vpColVector &error, const vpColVector &W, unsigned int start, unsigned int size)
+{
+  double num = 0, den = 0;
+  for (unsigned int i = start; i < start + size; i++) {
+    num += W[i] * vpMath::sqr(error[i]);
+    den += W[i];
+  }
+  return den > 0 ? sqrt(num / den) : 0.0;
+}
+}
+
 vpMbGenericTracker::vpMbGenericTracker()
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(),
+    m_useParallelTracking(false), m_nbParallelTrackingThreads(0), m_deterministicParallelTracking(true),
+    m_posePredictor(), m_nbVVSIterations(0), m_useTrackingStatistics(false), m_trackingStatistics(),
+    m_trackingStartTime(0)
 {
   m_mapOfTrackers["Camera"] = new TrackerWrapper(EDGE_TRACKER);
 
@@ -52,7 +94,7 @@ vpMbGenericTracker::vpMbGenericTracker()
   // Add default ponderation between each feature type
   m_mapOfFeatureFactors[EDGE_TRACKER] = 1.0;
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   m_mapOfFeatureFactors[KLT_TRACKER] = 1.0;
 #endif
 
@@ -62,7 +104,10 @@ vpMbGenericTracker::vpMbGenericTracker()
 
 vpMbGenericTracker::vpMbGenericTracker(unsigned int nbCameras, int trackerType)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(),
+    m_useParallelTracking(false), m_nbParallelTrackingThreads(0), m_deterministicParallelTracking(true),
+    m_posePredictor(), m_nbVVSIterations(0), m_useTrackingStatistics(false), m_trackingStatistics(),
+    m_trackingStartTime(0)
 {
   if (nbCameras == 0) {
     throw vpException(vpTrackingException::fatalError, "Cannot use no camera!");
@@ -88,7 +133,7 @@ vpMbGenericTracker::vpMbGenericTracker(unsigned int nbCameras, int trackerType)
   // Add default ponderation between each feature type
   m_mapOfFeatureFactors[EDGE_TRACKER] = 1.0;
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   m_mapOfFeatureFactors[KLT_TRACKER] = 1.0;
 #endif
 
@@ -98,7 +143,10 @@ vpMbGenericTracker::vpMbGenericTracker(unsigned int nbCameras, int trackerType)
 
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(),
+    m_useParallelTracking(false), m_nbParallelTrackingThreads(0), m_deterministicParallelTracking(true),
+    m_posePredictor(), m_nbVVSIterations(0), m_useTrackingStatistics(false), m_trackingStatistics(),
+    m_trackingStartTime(0)
 {
   if (trackerTypes.empty()) {
     throw vpException(vpException::badValue, "There is no camera!");
@@ -126,7 +174,7 @@ vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes)
   // Add default ponderation between each feature type
   m_mapOfFeatureFactors[EDGE_TRACKER] = 1.0;
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   m_mapOfFeatureFactors[KLT_TRACKER] = 1.0;
 #endif
 
@@ -137,7 +185,10 @@ vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes)
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<std::string> &cameraNames,
                                        const std::vector<int> &trackerTypes)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(),
+    m_useParallelTracking(false), m_nbParallelTrackingThreads(0), m_deterministicParallelTracking(true),
+    m_posePredictor(), m_nbVVSIterations(0), m_useTrackingStatistics(false), m_trackingStatistics(),
+    m_trackingStartTime(0)
 {
   if (cameraNames.size() != trackerTypes.size() || cameraNames.empty()) {
     throw vpException(vpTrackingException::badValue,
@@ -157,7 +208,7 @@ vpMbGenericTracker::vpMbGenericTracker(const std::vector<std::string> &cameraNam
   // Add default ponderation between each feature type
   m_mapOfFeatureFactors[EDGE_TRACKER] = 1.0;
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   m_mapOfFeatureFactors[KLT_TRACKER] = 1.0;
 #endif
 
@@ -306,12 +357,14 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
     mapOfVelocityTwist[it->first] = cVo;
   }
 
-  double factorEdge = m_mapOfFeatureFactors[EDGE_TRACKER];
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-  double factorKlt = m_mapOfFeatureFactors[KLT_TRACKER];
-#endif
-  double factorDepth = m_mapOfFeatureFactors[DEPTH_NORMAL_TRACKER];
-  double factorDepthDense = m_mapOfFeatureFactors[DEPTH_DENSE_TRACKER];
+  // Per-camera blocks, in the stacking order
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<unsigned int> startIndices;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    startIndices.push_back(trackers.empty() ? 0 : startIndices.back() + trackers.back()->m_error.getRows());
+    trackers.push_back(it->second);
+  }
 
   while (std::fabs(normRes_1 - normRes) > m_stopCriteriaEpsilon && (iter < m_maxIter)) {
     computeVVSInteractionMatrixAndResidu(mapOfImages, mapOfVelocityTwist);
@@ -325,7 +378,7 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
 
         tracker->m_cMo = m_mapOfCameraTransformationMatrix[it->first] * cMo_prev;
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
         vpHomogeneousMatrix c_curr_tTc_curr0 =
             m_mapOfCameraTransformationMatrix[it->first] * cMo_prev * tracker->c0Mo.inverse();
         tracker->ctTc0 = c_curr_tTc_curr0;
@@ -336,6 +389,7 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
     if (!reStartFromLastIncrement) {
       computeVVSWeights();
 
+      double t_solve = m_useTrackingStatistics ? vpTime::measureTimeMs() : 0.0;
       if (computeCovariance) {
         L_true = m_L;
         if (!isoJoIdentity_) {
@@ -372,89 +426,56 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
           }
         }
       }
+      if (m_useTrackingStatistics) {
+        m_trackingStatistics.solveTime += vpTime::measureTimeMs() - t_solve;
+      }
 
       // Weighting
       double num = 0;
       double den = 0;
 
-      unsigned int start_index = 0;
-      for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-           it != m_mapOfTrackers.end(); ++it) {
-        TrackerWrapper *tracker = it->second;
-
-        if (tracker->m_trackerType & EDGE_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_edge.getRows(); i++) {
-            double wi = tracker->m_w_edge[i] * tracker->m_factor[i] * factorEdge;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+      if (useParallelTracking()) {
+        std::vector<double> nums(trackers.size(), 0.0), dens(trackers.size(), 0.0);
+        runPerCamera(static_cast<unsigned int>(trackers.size()), [&](unsigned int i) {
+          vpScopedStatisticTimer timer(m_useTrackingStatistics, trackers[i]->m_statistics.weightingTime);
+          computeVVSWeightedResidual(trackers[i], startIndices[i], W_true, nums[i], dens[i]);
+        });
+
+        if (m_deterministicParallelTracking) {
+          // Same summation order as the sequential path
+          for (unsigned int i = 0; i < m_error.getRows(); i++) {
+            num += W_true[i] * vpMath::sqr(m_error[i]);
+            den += W_true[i];
           }
-
-          start_index += tracker->m_error_edge.getRows();
-        }
-
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-        if (tracker->m_trackerType & KLT_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_klt.getRows(); i++) {
-            double wi = tracker->m_w_klt[i] * factorKlt;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
+        } else {
+          for (size_t i = 0; i < trackers.size(); i++) {
+            num += nums[i];
+            den += dens[i];
           }
-
-          start_index += tracker->m_error_klt.getRows();
         }
+      } else
 #endif
-
-        if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_depthNormal.getRows(); i++) {
-            double wi = tracker->m_w_depthNormal[i] * factorDepth;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_depthNormal.getRows();
-        }
-
-        if (tracker->m_trackerType & DEPTH_DENSE_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_depthDense.getRows(); i++) {
-            double wi = tracker->m_w_depthDense[i] * factorDepthDense;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_depthDense.getRows();
+      {
+        for (size_t i = 0; i < trackers.size(); i++) {
+          vpScopedStatisticTimer timer(m_useTrackingStatistics, trackers[i]->m_statistics.weightingTime);
+          computeVVSWeightedResidual(trackers[i], startIndices[i], W_true, num, den);
         }
       }
 
       normRes_1 = normRes;
       normRes = sqrt(num / den);
+      if (m_useTrackingStatistics) {
+        if (iter == 0) {
+          m_trackingStatistics.initialResidual = normRes;
+          for (size_t i = 0; i < trackers.size(); i++) {
+            trackers[i]->m_statistics.initialResidual =
+                weightedResidual(m_error, W_true, startIndices[i], trackers[i]->m_error.getRows());
+          }
+        }
+        m_trackingStatistics.residual = normRes;
+        t_solve = vpTime::measureTimeMs();
+      }
 
       computeVVSPoseEstimation(isoJoIdentity_, iter, m_L, LTL, m_weightedError, m_error, error_prev, LTR, mu, v);
 
@@ -462,7 +483,7 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
 
       m_cMo = vpExponentialMap::direct(v).inverse() * m_cMo;
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
       for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
            it != m_mapOfTrackers.end(); ++it) {
         TrackerWrapper *tracker = it->second;
@@ -479,10 +500,22 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
         TrackerWrapper *tracker = it->second;
         tracker->m_cMo = m_mapOfCameraTransformationMatrix[it->first] * m_cMo;
       }
+      if (m_useTrackingStatistics) {
+        m_trackingStatistics.solveTime += vpTime::measureTimeMs() - t_solve;
+      }
     }
 
     iter++;
   }
+  m_nbVVSIterations = iter;
+
+  if (m_useTrackingStatistics) {
+    m_trackingStatistics.nbIterations = iter;
+    for (size_t i = 0; i < trackers.size(); i++) {
+      trackers[i]->m_statistics.nbIterations = iter;
+      computeVVSStatistics(trackers[i], startIndices[i], W_true);
+    }
+  }
 
   computeCovarianceMatrixVVS(isoJoIdentity_, W_true, cMo_prev, L_true, LVJ_true, m_error);
 
@@ -496,6 +529,147 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
   }
 }
 
+/*!
+  Count the features of one camera used by the pose estimation and the
+  rejected ones, and compute its weighted residual norm, for the tracking
+  statistics.
+
+  \param tracker : The per-camera tracker.
+  \param start_index : First row of the camera block.
+  \param W_true : Stacked weights of the last iteration.
+*/
+void vpMbGenericTracker::computeVVSStatistics(TrackerWrapper *tracker, unsigned int start_index,
+                                              const vpColVector &W_true)
+{
+  vpMbtTrackingStatistics &stats = tracker->m_statistics;
+  stats.residual = weightedResidual(m_error, W_true, start_index, tracker->m_error.getRows());
+
+  if (tracker->m_trackerType & EDGE_TRACKER) {
+    stats.nbEdgeFeatures = tracker->m_error_edge.getRows();
+    for (unsigned int i = 0; i < stats.nbEdgeFeatures; i++) {
+      if (tracker->m_w_edge[i] * tracker->m_factor[i] < 0.5) {
+        stats.nbEdgeRejected++;
+      }
+    }
+  }
+
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+  if (tracker->m_trackerType & KLT_TRACKER) {
+    stats.nbKltFeatures = tracker->m_error_klt.getRows();
+    for (unsigned int i = 0; i < stats.nbKltFeatures; i++) {
+      if (tracker->m_w_klt[i] < 0.5) {
+        stats.nbKltRejected++;
+      }
+    }
+  }
+#endif
+
+  if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
+    stats.nbDepthNormalFeatures = tracker->m_error_depthNormal.getRows();
+    for (unsigned int i = 0; i < stats.nbDepthNormalFeatures; i++) {
+      if (tracker->m_w_depthNormal[i] < 0.5) {
+        stats.nbDepthNormalRejected++;
+      }
+    }
+  }
+
+  if (tracker->m_trackerType & DEPTH_DENSE_TRACKER) {
+    stats.nbDepthDenseFeatures = tracker->m_error_depthDense.getRows();
+    for (unsigned int i = 0; i < stats.nbDepthDenseFeatures; i++) {
+      if (tracker->m_w_depthDense[i] < 0.5) {
+        stats.nbDepthDenseRejected++;
+      }
+    }
+  }
+}
+
+/*!
+  Apply the robust weights and the feature factors of one camera to its block
+  of the stacked interaction matrix and residual vector, and accumulate the
+  terms of the weighted residual norm.
+
+  \param tracker : The per-camera tracker.
+  \param start_index : First row of the camera block.
+  \param W_true : Stacked weights, updated for the rows of the camera block.
+  \param num : Accumulated weighted squared residual.
+  \param den : Accumulated weights.
+*/
+void vpMbGenericTracker::computeVVSWeightedResidual(TrackerWrapper *tracker, unsigned int start_index,
+                                                    vpColVector &W_true, double &num, double &den)
+{
+  if (tracker->m_trackerType & EDGE_TRACKER) {
+    double factorEdge = m_mapOfFeatureFactors.find(EDGE_TRACKER)->second;
+    for (unsigned int i = 0; i < tracker->m_error_edge.getRows(); i++) {
+      double wi = tracker->m_w_edge[i] * tracker->m_factor[i] * factorEdge;
+      W_true[start_index + i] = wi;
+      m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+
+      for (unsigned int j = 0; j < m_L.getCols(); j++) {
+        m_L[start_index + i][j] *= wi;
+      }
+    }
+
+    start_index += tracker->m_error_edge.getRows();
+  }
+
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+  if (tracker->m_trackerType & KLT_TRACKER) {
+    double factorKlt = m_mapOfFeatureFactors.find(KLT_TRACKER)->second;
+    for (unsigned int i = 0; i < tracker->m_error_klt.getRows(); i++) {
+      double wi = tracker->m_w_klt[i] * factorKlt;
+      W_true[start_index + i] = wi;
+      m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+
+      for (unsigned int j = 0; j < m_L.getCols(); j++) {
+        m_L[start_index + i][j] *= wi;
+      }
+    }
+
+    start_index += tracker->m_error_klt.getRows();
+  }
+#endif
+
+  if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
+    double factorDepth = m_mapOfFeatureFactors.find(DEPTH_NORMAL_TRACKER)->second;
+    for (unsigned int i = 0; i < tracker->m_error_depthNormal.getRows(); i++) {
+      double wi = tracker->m_w_depthNormal[i] * factorDepth;
+      W_true[start_index + i] = wi;
+      m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+
+      for (unsigned int j = 0; j < m_L.getCols(); j++) {
+        m_L[start_index + i][j] *= wi;
+      }
+    }
+
+    start_index += tracker->m_error_depthNormal.getRows();
+  }
+
+  if (tracker->m_trackerType & DEPTH_DENSE_TRACKER) {
+    double factorDepthDense = m_mapOfFeatureFactors.find(DEPTH_DENSE_TRACKER)->second;
+    for (unsigned int i = 0; i < tracker->m_error_depthDense.getRows(); i++) {
+      double wi = tracker->m_w_depthDense[i] * factorDepthDense;
+      W_true[start_index + i] = wi;
+      m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+
+      for (unsigned int j = 0; j < m_L.getCols(); j++) {
+        m_L[start_index + i][j] *= wi;
+      }
+    }
+  }
+}
+
 void vpMbGenericTracker::computeVVSInit()
 {
   throw vpException(vpException::fatalError, "vpMbGenericTracker::computeVVSInit() should not be called!");
@@ -503,14 +677,29 @@ void vpMbGenericTracker::computeVVSInit()
 
 void vpMbGenericTracker::computeVVSInit(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages)
 {
-  unsigned int nbFeatures = 0;
-
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->computeVVSInit(mapOfImages[it->first]);
+    trackers.push_back(it->second);
+    images.push_back(mapOfImages[it->first]);
+  }
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (useParallelTracking()) {
+    runPerCamera(static_cast<unsigned int>(trackers.size()),
+                 [&](unsigned int i) { trackers[i]->computeVVSInit(images[i]); });
+  } else
+#endif
+  {
+    for (size_t i = 0; i < trackers.size(); i++) {
+      trackers[i]->computeVVSInit(images[i]);
+    }
+  }
 
-    nbFeatures += tracker->m_error.getRows();
+  unsigned int nbFeatures = 0;
+  for (size_t i = 0; i < trackers.size(); i++) {
+    nbFeatures += trackers[i]->m_error.getRows();
   }
 
   m_L.resize(nbFeatures, 6, false, false);
@@ -532,6 +721,10 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(
     std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
     std::map<std::string, vpVelocityTwistMatrix> &mapOfVelocityTwist)
 {
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<const vpVelocityTwistMatrix *> twists;
+  std::vector<unsigned int> startIndices;
   unsigned int start_index = 0;
 
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
@@ -539,29 +732,71 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(
     TrackerWrapper *tracker = it->second;
 
     tracker->m_cMo = m_mapOfCameraTransformationMatrix[it->first] * m_cMo;
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
     vpHomogeneousMatrix c_curr_tTc_curr0 = m_mapOfCameraTransformationMatrix[it->first] * m_cMo * tracker->c0Mo.inverse();
     tracker->ctTc0 = c_curr_tTc_curr0;
 #endif
 
-    tracker->computeVVSInteractionMatrixAndResidu(mapOfImages[it->first]);
-
-    m_L.insert(tracker->m_L * mapOfVelocityTwist[it->first], start_index, 0);
-    m_error.insert(start_index, tracker->m_error);
+    trackers.push_back(tracker);
+    images.push_back(mapOfImages[it->first]);
+    twists.push_back(&mapOfVelocityTwist[it->first]);
+    startIndices.push_back(start_index);
 
+    // The size of each block is fixed by computeVVSInit()
     start_index += tracker->m_error.getRows();
   }
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (useParallelTracking()) {
+    // Each camera writes its own rows of the stacked matrix and vector
+    runPerCamera(static_cast<unsigned int>(trackers.size()), [&](unsigned int i) {
+      vpScopedStatisticTimer timer(m_useTrackingStatistics, trackers[i]->m_statistics.jacobianTime);
+      trackers[i]->computeVVSInteractionMatrixAndResidu(images[i]);
+
+      m_L.insert(trackers[i]->m_L * (*twists[i]), startIndices[i], 0);
+      m_error.insert(startIndices[i], trackers[i]->m_error);
+    });
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < trackers.size(); i++) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, trackers[i]->m_statistics.jacobianTime);
+    trackers[i]->computeVVSInteractionMatrixAndResidu(images[i]);
+
+    m_L.insert(trackers[i]->m_L * (*twists[i]), startIndices[i], 0);
+    m_error.insert(startIndices[i], trackers[i]->m_error);
+  }
 }
 
 void vpMbGenericTracker::computeVVSWeights()
 {
-  unsigned int start_index = 0;
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (useParallelTracking()) {
+    std::vector<TrackerWrapper *> trackers;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      trackers.push_back(it->second);
+    }
 
+    runPerCamera(static_cast<unsigned int>(trackers.size()), [&](unsigned int i) {
+      vpScopedStatisticTimer timer(m_useTrackingStatistics, trackers[i]->m_statistics.weightingTime);
+      trackers[i]->computeVVSWeights();
+    });
+  } else
+#endif
+  {
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      vpScopedStatisticTimer timer(m_useTrackingStatistics, it->second->m_statistics.weightingTime);
+      it->second->computeVVSWeights();
+    }
+  }
+
+  unsigned int start_index = 0;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
-    tracker->computeVVSWeights();
-
     m_w.insert(start_index, tracker->m_w);
     start_index += tracker->m_w.getRows();
   }
@@ -903,7 +1138,7 @@ vpMbHiddenFaces<vpMbtPolygon> &vpMbGenericTracker::getFaces(const std::string &c
   return faces;
 }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 /*!
   Return the address of the circle feature list for the reference camera.
 */
@@ -1033,14 +1268,14 @@ void vpMbGenericTracker::getFeaturesForDisplay(std::map<std::string, std::vector
 */
 double vpMbGenericTracker::getGoodMovingEdgesRatioThreshold() const { return m_percentageGdPt; }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 /*!
   Get the current list of KLT points for the reference camera.
 
   \warning This function convert and copy the OpenCV KLT points into
   vpImagePoints.
 
-  \return the list of KLT points through vpKltOpencv.
+  \return the list of KLT points through the KLT tracker.
 */
 std::vector<vpImagePoint> vpMbGenericTracker::getKltImagePoints() const
 {
@@ -1061,7 +1296,7 @@ std::vector<vpImagePoint> vpMbGenericTracker::getKltImagePoints() const
   \warning This function convert and copy the openCV KLT points into
   vpImagePoints.
 
-  \return the list of KLT points and their id through vpKltOpencv.
+  \return the list of KLT points and their id through the KLT tracker.
 */
 std::map<int, vpImagePoint> vpMbGenericTracker::getKltImagePointsWithId() const
 {
@@ -1112,6 +1347,7 @@ int vpMbGenericTracker::getKltNbPoints() const
   return 0;
 }
 
+#if defined(VISP_HAVE_OPENCV)
 /*!
   Get the klt tracker at the current state for the reference camera.
 
@@ -1169,14 +1405,78 @@ void vpMbGenericTracker::getKltOpencv(std::map<std::string, vpKltOpencv> &mapOfK
     mapOfKlts[it->first] = tracker->getKltOpencv();
   }
 }
+#endif
+
+/*!
+  Get the klt tracker at the current state for the reference camera. When
+  OpenCV is available, only the settings of the klt tracker are returned.
+
+  \return klt tracker.
+*/
+vpKlt vpMbGenericTracker::getKlt() const
+{
+  std::map<std::string, TrackerWrapper *>::const_iterator it_tracker = m_mapOfTrackers.find(m_referenceCameraName);
+
+  if (it_tracker != m_mapOfTrackers.end()) {
+    TrackerWrapper *tracker;
+    tracker = it_tracker->second;
+    return tracker->getKlt();
+  } else {
+    std::cerr << "Cannot find the reference camera: " << m_referenceCameraName << "!" << std::endl;
+  }
+
+  return vpKlt();
+}
+
+/*!
+  Get the klt tracker at the current state.
+
+  \param klt1 : Klt tracker for the first camera.
+  \param klt2 : Klt tracker for the second camera.
+
+  \note This function assumes a stereo configuration of the generic tracker.
+*/
+void vpMbGenericTracker::getKlt(vpKlt &klt1, vpKlt &klt2) const
+{
+  if (m_mapOfTrackers.size() == 2) {
+    std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+    klt1 = it->second->getKlt();
+    ++it;
+
+    klt2 = it->second->getKlt();
+  } else {
+    std::cerr << "The tracker is not set as a stereo configuration! There are " << m_mapOfTrackers.size() << " cameras!"
+              << std::endl;
+  }
+}
+
+/*!
+  Get the klt tracker at the current state.
+
+  \param mapOfKlts : Map if klt trackers.
+*/
+void vpMbGenericTracker::getKlt(std::map<std::string, vpKlt> &mapOfKlts) const
+{
+  mapOfKlts.clear();
+
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    mapOfKlts[it->first] = tracker->getKlt();
+  }
+}
 
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+#if !defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020408)
 /*!
   Get the current list of KLT points for the reference camera.
 
-   \return the list of KLT points through vpKltOpencv.
+   \return the list of KLT points through the KLT tracker.
 */
+#if !defined(VISP_HAVE_OPENCV)
+std::vector<vpImagePoint> vpMbGenericTracker::getKltPoints() const
+#else
 std::vector<cv::Point2f> vpMbGenericTracker::getKltPoints() const
+#endif
 {
   std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.find(m_referenceCameraName);
   if (it != m_mapOfTrackers.end()) {
@@ -1186,7 +1486,11 @@ std::vector<cv::Point2f> vpMbGenericTracker::getKltPoints() const
     std::cerr << "Cannot find the reference camera: " << m_referenceCameraName << "!" << std::endl;
   }
 
+#if !defined(VISP_HAVE_OPENCV)
+  return std::vector<vpImagePoint>();
+#else
   return std::vector<cv::Point2f>();
+#endif
 }
 #endif
 
@@ -1754,6 +2058,25 @@ int vpMbGenericTracker::getTrackerType() const
   }
 }
 
+/*!
+  Get the timings and counters of the last call to track() for each camera.
+  The resolution time and the total time are only given for all the cameras,
+  see getTrackingStatistics().
+
+  \param mapOfStatistics : Map of statistics, the key is the camera name.
+
+  \sa setUseTrackingStatistics()
+*/
+void vpMbGenericTracker::getTrackingStatistics(
+    std::map<std::string, vpMbtTrackingStatistics> &mapOfStatistics) const
+{
+  mapOfStatistics.clear();
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    mapOfStatistics[it->first] = it->second->m_statistics;
+  }
+}
+
 void vpMbGenericTracker::init(const vpImage<unsigned char> &I)
 {
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
@@ -2886,10 +3209,10 @@ int main()
 is not wrl or cao.
 
   \param modelFile : the file containing the 3D model description.
-  The extension of this file is either .wrl or .cao.
+  The extension of this file is either .wrl, .cao or .bcao.
   \param verbose : verbose option to print additional information when loading
 CAO model files which include other CAO model files.
-  \param T : optional transformation matrix (currently only for .cao) to transform
+  \param T : optional transformation matrix (currently only for .cao and .bcao) to transform
   3D points expressed in the original object frame to the desired object frame.
 
   \note All the trackers will use the same model in case of stereo / multiple
@@ -2925,14 +3248,14 @@ int main()
 is not wrl or cao.
 
   \param modelFile1 : the file containing the 3D model description for the
-first camera. The extension of this file is either .wrl or .cao.
+first camera. The extension of this file is either .wrl, .cao or .bcao.
   \param modelFile2 : the file containing the the 3D model description for the second
-camera. The extension of this file is either .wrl or .cao.
+camera. The extension of this file is either .wrl, .cao or .bcao.
   \param verbose : verbose option to print additional information when loading CAO model files
 which include other CAO model files.
-  \param T1 : optional transformation matrix (currently only for .cao) to transform
+  \param T1 : optional transformation matrix (currently only for .cao and .bcao) to transform
   3D points in \a modelFile1 expressed in the original object frame to the desired object frame.
-  \param T2 : optional transformation matrix (currently only for .cao) to transform
+  \param T2 : optional transformation matrix (currently only for .cao and .bcao) to transform
   3D points in \a modelFile2 expressed in the original object frame to the desired object frame (
   T2==T1 if the two models have the same object frame which should be the case most of the time).
 
@@ -2975,10 +3298,10 @@ int main()
 is not wrl or cao.
 
   \param mapOfModelFiles : map of files containing the 3D model description.
-  The extension of this file is either .wrl or .cao.
+  The extension of this file is either .wrl, .cao or .bcao.
   \param verbose : verbose option to print additional information when loading
 CAO model files which include other CAO model files.
-  \param mapOfT : optional map of transformation matrices (currently only for .cao)
+  \param mapOfT : optional map of transformation matrices (currently only for .cao and .bcao)
   to transform 3D points in \a mapOfModelFiles expressed in the original object frame to
   the desired object frame (if the models have the same object frame which should be the
   case most of the time, all the transformation matrices are identical).
@@ -3007,14 +3330,101 @@ void vpMbGenericTracker::loadModel(const std::map<std::string, std::string> &map
   }
 }
 
+/*!
+  Predict the pose of the current frame with the motion model of the pose
+  predictor, see getPosePredictor(), and move the moving edges of the lines
+  onto the predicted projection of the model. Nothing is done when the
+  prediction is disabled.
+
+  \param mapOfImages : Map of images.
+*/
+void vpMbGenericTracker::predictPose(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages)
+{
+  vpHomogeneousMatrix cMo_pred;
+  if (!m_posePredictor.predict(m_cMo, cMo_pred)) {
+    return;
+  }
+
+  m_cMo = cMo_pred;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->m_cMo = m_mapOfCameraTransformationMatrix[it->first] * m_cMo;
+
+    std::map<std::string, const vpImage<unsigned char> *>::const_iterator it_img = mapOfImages.find(it->first);
+    if ((tracker->m_trackerType & EDGE_TRACKER) && it_img != mapOfImages.end() && it_img->second != NULL) {
+      tracker->shiftMovingEdge(*it_img->second, tracker->m_cMo);
+    }
+  }
+}
+
+/*!
+  Reset the tracking statistics of all the cameras at the beginning of a
+  tracking step.
+*/
+void vpMbGenericTracker::startTrackingStatistics()
+{
+  m_trackingStatistics.reset();
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    it->second->m_statistics.reset();
+  }
+  m_trackingStartTime = vpTime::measureTimeMs();
+}
+
+/*!
+  Sum the tracking statistics of the cameras at the end of a tracking step.
+*/
+void vpMbGenericTracker::stopTrackingStatistics()
+{
+  vpMbtTrackingStatistics &stats = m_trackingStatistics;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    const vpMbtTrackingStatistics &camera = it->second->m_statistics;
+    stats.visibilityTime += camera.visibilityTime;
+    stats.edgeTime += camera.edgeTime;
+    stats.kltTime += camera.kltTime;
+    stats.depthNormalTime += camera.depthNormalTime;
+    stats.depthDenseTime += camera.depthDenseTime;
+    stats.jacobianTime += camera.jacobianTime;
+    stats.weightingTime += camera.weightingTime;
+
+    stats.nbEdgeFeatures += camera.nbEdgeFeatures;
+    stats.nbEdgeRejected += camera.nbEdgeRejected;
+    stats.nbKltFeatures += camera.nbKltFeatures;
+    stats.nbKltRejected += camera.nbKltRejected;
+    stats.nbDepthNormalFeatures += camera.nbDepthNormalFeatures;
+    stats.nbDepthNormalRejected += camera.nbDepthNormalRejected;
+    stats.nbDepthDenseFeatures += camera.nbDepthDenseFeatures;
+    stats.nbDepthDenseRejected += camera.nbDepthDenseRejected;
+  }
+  stats.totalTime = vpTime::measureTimeMs() - m_trackingStartTime;
+}
+
 #ifdef VISP_HAVE_PCL
 void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
                                      std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds)
 {
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<pcl::PointCloud<pcl::PointXYZ>::ConstPtr> pointClouds;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->preTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
+    trackers.push_back(it->second);
+    images.push_back(mapOfImages[it->first]);
+    pointClouds.push_back(mapOfPointClouds[it->first]);
+  }
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (useParallelTracking()) {
+    runPerCamera(static_cast<unsigned int>(trackers.size()),
+                 [&](unsigned int i) { trackers[i]->preTracking(images[i], pointClouds[i]); });
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < trackers.size(); i++) {
+    trackers[i]->preTracking(images[i], pointClouds[i]);
   }
 }
 #endif
@@ -3024,24 +3434,143 @@ void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigne
                                      std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                                      std::map<std::string, unsigned int> &mapOfPointCloudHeights)
 {
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<const std::vector<vpColVector> *> pointClouds;
+  std::vector<unsigned int> widths, heights;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->preTracking(mapOfImages[it->first], mapOfPointClouds[it->first], mapOfPointCloudWidths[it->first],
-                         mapOfPointCloudHeights[it->first]);
+    trackers.push_back(it->second);
+    images.push_back(mapOfImages[it->first]);
+    pointClouds.push_back(mapOfPointClouds[it->first]);
+    widths.push_back(mapOfPointCloudWidths[it->first]);
+    heights.push_back(mapOfPointCloudHeights[it->first]);
+  }
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (useParallelTracking()) {
+    runPerCamera(static_cast<unsigned int>(trackers.size()), [&](unsigned int i) {
+      trackers[i]->preTracking(images[i], pointClouds[i], widths[i], heights[i]);
+    });
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < trackers.size(); i++) {
+    trackers[i]->preTracking(images[i], pointClouds[i], widths[i], heights[i]);
   }
 }
 
-/*!
-  Re-initialize the model used by the tracker.
+#ifdef VISP_HAVE_PCL
+void vpMbGenericTracker::postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                      std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds)
+{
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<pcl::PointCloud<pcl::PointXYZ>::ConstPtr> pointClouds;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    trackers.push_back(it->second);
+    images.push_back(mapOfImages[it->first]);
+    pointClouds.push_back(mapOfPointClouds[it->first]);
+  }
 
-  \param I : The grayscale image containing the object to initialize.
-  \param cad_name : Path to the file containing the 3D model description.
-  \param cMo : The new vpHomogeneousMatrix between the camera and the new
-  model.
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (useParallelTracking()) {
+    runPerCamera(static_cast<unsigned int>(trackers.size()),
+                 [&](unsigned int i) { postTracking(trackers[i], images[i], pointClouds[i]); });
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < trackers.size(); i++) {
+    postTracking(trackers[i], images[i], pointClouds[i]);
+  }
+}
+
+void vpMbGenericTracker::postTracking(TrackerWrapper *tracker, const vpImage<unsigned char> *const ptr_I,
+                                      const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
+{
+  if (tracker->m_trackerType & EDGE_TRACKER && displayFeatures) {
+    tracker->m_featuresToBeDisplayedEdge = tracker->getFeaturesForDisplayEdge();
+  }
+
+  tracker->postTracking(ptr_I, point_cloud);
+
+  if (displayFeatures) {
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+    if (tracker->m_trackerType & KLT_TRACKER) {
+      tracker->m_featuresToBeDisplayedKlt = tracker->getFeaturesForDisplayKlt();
+    }
+#endif
+
+    if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
+      tracker->m_featuresToBeDisplayedDepthNormal = tracker->getFeaturesForDisplayDepthNormal();
+    }
+  }
+}
+#endif
+
+void vpMbGenericTracker::postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                      std::map<std::string, unsigned int> &mapOfPointCloudWidths,
+                                      std::map<std::string, unsigned int> &mapOfPointCloudHeights)
+{
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<unsigned int> widths, heights;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    trackers.push_back(it->second);
+    images.push_back(mapOfImages[it->first]);
+    widths.push_back(mapOfPointCloudWidths[it->first]);
+    heights.push_back(mapOfPointCloudHeights[it->first]);
+  }
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (useParallelTracking()) {
+    runPerCamera(static_cast<unsigned int>(trackers.size()),
+                 [&](unsigned int i) { postTracking(trackers[i], images[i], widths[i], heights[i]); });
+    return;
+  }
+#endif
+
+  for (size_t i = 0; i < trackers.size(); i++) {
+    postTracking(trackers[i], images[i], widths[i], heights[i]);
+  }
+}
+
+void vpMbGenericTracker::postTracking(TrackerWrapper *tracker, const vpImage<unsigned char> *const ptr_I,
+                                      unsigned int pointcloud_width, unsigned int pointcloud_height)
+{
+  if (tracker->m_trackerType & EDGE_TRACKER && displayFeatures) {
+    tracker->m_featuresToBeDisplayedEdge = tracker->getFeaturesForDisplayEdge();
+  }
+
+  tracker->postTracking(ptr_I, pointcloud_width, pointcloud_height);
+
+  if (displayFeatures) {
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+    if (tracker->m_trackerType & KLT_TRACKER) {
+      tracker->m_featuresToBeDisplayedKlt = tracker->getFeaturesForDisplayKlt();
+    }
+#endif
+
+    if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
+      tracker->m_featuresToBeDisplayedDepthNormal = tracker->getFeaturesForDisplayDepthNormal();
+    }
+  }
+}
+
+/*!
+  Re-initialize the model used by the tracker.
+
+  \param I : The grayscale image containing the object to initialize.
+  \param cad_name : Path to the file containing the 3D model description.
+  \param cMo : The new vpHomogeneousMatrix between the camera and the new
+  model.
   \param verbose : verbose option to print additional information when
   loading CAO model files which include other CAO model files.
-  \param T : optional transformation matrix (currently only for .cao).
+  \param T : optional transformation matrix (currently only for .cao and .bcao).
 */
 void vpMbGenericTracker::reInitModel(const vpImage<unsigned char> &I, const std::string &cad_name,
                                      const vpHomogeneousMatrix &cMo, bool verbose,
@@ -3075,7 +3604,7 @@ void vpMbGenericTracker::reInitModel(const vpImage<unsigned char> &I, const std:
   model.
   \param verbose : verbose option to print additional information when
   loading CAO model files which include other CAO model files.
-  \param T : optional transformation matrix (currently only for .cao).
+  \param T : optional transformation matrix (currently only for .cao and .bcao).
 */
 void vpMbGenericTracker::reInitModel(const vpImage<vpRGBa> &I_color, const std::string &cad_name,
                                      const vpHomogeneousMatrix &cMo, bool verbose,
@@ -3112,9 +3641,9 @@ void vpMbGenericTracker::reInitModel(const vpImage<vpRGBa> &I_color, const std::
   \param c2Mo : The new vpHomogeneousMatrix between the second camera and the new model.
   \param verbose : verbose option to print additional information when
   loading CAO model files which include other CAO model files.
-  \param T1 : optional transformation matrix (currently only for .cao) to transform
+  \param T1 : optional transformation matrix (currently only for .cao and .bcao) to transform
   3D points in \a cad_name1 expressed in the original object frame to the desired object frame.
-  \param T2 : optional transformation matrix (currently only for .cao) to transform
+  \param T2 : optional transformation matrix (currently only for .cao and .bcao) to transform
   3D points in \a cad_name2 expressed in the original object frame to the desired object frame (
   T2==T1 if the two models have the same object frame which should be the case most of the time).
 
@@ -3159,9 +3688,9 @@ void vpMbGenericTracker::reInitModel(const vpImage<unsigned char> &I1, const vpI
   \param c2Mo : The new vpHomogeneousMatrix between the second camera and the new model.
   \param verbose : verbose option to print additional information when
   loading CAO model files which include other CAO model files.
-  \param T1 : optional transformation matrix (currently only for .cao) to transform
+  \param T1 : optional transformation matrix (currently only for .cao and .bcao) to transform
   3D points in \a cad_name1 expressed in the original object frame to the desired object frame.
-  \param T2 : optional transformation matrix (currently only for .cao) to transform
+  \param T2 : optional transformation matrix (currently only for .cao and .bcao) to transform
   3D points in \a cad_name2 expressed in the original object frame to the desired object frame (
   T2==T1 if the two models have the same object frame which should be the case most of the time).
 
@@ -3203,7 +3732,7 @@ void vpMbGenericTracker::reInitModel(const vpImage<vpRGBa> &I_color1, const vpIm
   and the current object position.
   \param verbose : Verbose option to print additional information when loading CAO model
   files which include other CAO model files.
-  \param mapOfT : optional map of transformation matrices (currently only for .cao) to transform
+  \param mapOfT : optional map of transformation matrices (currently only for .cao and .bcao) to transform
   3D points in \a mapOfModelFiles expressed in the original object frame to the desired object frame
   (if the models have the same object frame which should be the case most of the time,
   all the transformation matrices are identical).
@@ -3277,7 +3806,7 @@ void vpMbGenericTracker::reInitModel(const std::map<std::string, const vpImage<u
   and the current object position.
   \param verbose : Verbose option to print additional information when loading CAO model
   files which include other CAO model files.
-  \param mapOfT : optional map of transformation matrices (currently only for .cao) to transform
+  \param mapOfT : optional map of transformation matrices (currently only for .cao and .bcao) to transform
   3D points in \a mapOfModelFiles expressed in the original object frame to the desired object frame
   (if the models have the same object frame which should be the case most of the time,
   all the transformation matrices are identical).
@@ -3379,7 +3908,7 @@ void vpMbGenericTracker::resetTracker()
   // Reset default ponderation between each feature type
   m_mapOfFeatureFactors[EDGE_TRACKER] = 1.0;
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   m_mapOfFeatureFactors[KLT_TRACKER] = 1.0;
 #endif
 
@@ -4063,7 +4592,6 @@ void vpMbGenericTracker::setGoodMovingEdgesRatioThreshold(double threshold)
   }
 }
 
-#ifdef VISP_HAVE_OGRE
 /*!
   Set the ratio of visibility attempts that has to be successful to consider a
   polygon as visible.
@@ -4103,9 +4631,9 @@ void vpMbGenericTracker::setNbRayCastingAttemptsForVisibility(const unsigned int
     tracker->setNbRayCastingAttemptsForVisibility(attempts);
   }
 }
-#endif
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_OPENCV)
 /*!
   Set the new value of the klt tracker.
 
@@ -4160,6 +4688,62 @@ void vpMbGenericTracker::setKltOpencv(const std::map<std::string, vpKltOpencv> &
     }
   }
 }
+#endif
+
+/*!
+  Set the new value of the klt tracker.
+
+  \param t : Klt tracker containing the new values.
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setKlt(const vpKlt &t)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setKlt(t);
+  }
+}
+
+/*!
+  Set the new value of the klt tracker.
+
+  \param t1 : Klt tracker containing the new values for the first camera.
+  \param t2 : Klt tracker containing the new values for the second camera.
+
+  \note This function assumes a stereo configuration of the generic tracker.
+*/
+void vpMbGenericTracker::setKlt(const vpKlt &t1, const vpKlt &t2)
+{
+  if (m_mapOfTrackers.size() == 2) {
+    std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+    it->second->setKlt(t1);
+
+    ++it;
+    it->second->setKlt(t2);
+  } else {
+    throw vpException(vpTrackingException::fatalError, "Require two cameras! There are %d cameras!",
+                      m_mapOfTrackers.size());
+  }
+}
+
+/*!
+  Set the new value of the klt tracker.
+
+  \param mapOfKlts : Map of klt tracker containing the new values.
+*/
+void vpMbGenericTracker::setKlt(const std::map<std::string, vpKlt> &mapOfKlts)
+{
+  for (std::map<std::string, vpKlt>::const_iterator it = mapOfKlts.begin(); it != mapOfKlts.end(); ++it) {
+    std::map<std::string, TrackerWrapper *>::const_iterator it_tracker = m_mapOfTrackers.find(it->first);
+
+    if (it_tracker != m_mapOfTrackers.end()) {
+      TrackerWrapper *tracker = it_tracker->second;
+      tracker->setKlt(it->second);
+    }
+  }
+}
 
 /*!
   Set the threshold for the acceptation of a point.
@@ -4201,7 +4785,7 @@ void vpMbGenericTracker::setLod(bool useLod, const std::string &name)
   }
 }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 /*!
   Set the erosion of the mask used on the Model faces.
 
@@ -4373,6 +4957,57 @@ void vpMbGenericTracker::setMovingEdge(const std::map<std::string, vpMe> &mapOfM
   }
 }
 
+/*!
+  Set the number of threads used to process the dense depth faces of each
+  camera when setUseParallelDepthDense() is enabled.
+
+  \param nb : Number of threads, 0 to use the OpenMP default.
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setNbParallelDepthDenseThreads(unsigned int nb)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setNbParallelDepthDenseThreads(nb);
+  }
+}
+
+/*!
+  Set the number of threads used to process the moving edges of each camera
+  when setUseParallelMovingEdge() is enabled.
+
+  \param nb : Number of threads, 0 to use the OpenMP default.
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setNbParallelMovingEdgeThreads(unsigned int nb)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setNbParallelMovingEdgeThreads(nb);
+  }
+}
+
+/*!
+  Set the number of threads used to render the scanline visibility of each
+  camera when setUseParallelScanLine() is enabled.
+
+  \param nb : Number of threads, 0 to use the OpenMP default.
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setNbParallelScanLineThreads(unsigned int nb)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setNbParallelScanLineThreads(nb);
+  }
+}
+
 /*!
   Set the near distance for clipping.
 
@@ -4849,6 +5484,26 @@ void vpMbGenericTracker::setProjectionErrorDisplayArrowThickness(unsigned int th
   }
 }
 
+/*!
+  Enable/Disable the ray casting visibility test, which does not require
+  Ogre3D. The faces are organised in a bounding volume hierarchy so that the
+  test remains fast for models with many faces.
+
+  \param v : True to use the ray casting visibility test.
+
+  \note This function will set the new parameter for all the cameras.
+
+  \sa setNbRayCastingAttemptsForVisibility(), setGoodNbRayCastingAttemptsRatio()
+*/
+void vpMbGenericTracker::setRayCastingVisibilityTest(bool v)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setRayCastingVisibilityTest(v);
+  }
+}
+
 /*!
   Set the reference camera name.
 
@@ -4864,6 +5519,84 @@ void vpMbGenericTracker::setReferenceCameraName(const std::string &referenceCame
   }
 }
 
+/*!
+  Enable the incremental scanline rendering, see
+  vpMbTracker::setScanLineIncrementalThreshold().
+
+  \param threshold : Displacement in pixels of the projected polygons below
+  which the previous rendering is reused, 0 to render the scene every time.
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setScanLineIncrementalThreshold(double threshold)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setScanLineIncrementalThreshold(threshold);
+  }
+}
+
+/*!
+  Set the polygons of other objects hiding the model in the scanline
+  visibility test, see vpMbTracker::setScanLineOccluders().
+
+  \param occluders : Clipped polygons expressed in the frame of the reference
+  camera. They are moved to the frame of the other cameras with the camera
+  transformation matrices.
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setScanLineOccluders(
+    const std::vector<std::vector<std::pair<vpPoint, unsigned int> > > &occluders)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+
+    std::map<std::string, vpHomogeneousMatrix>::const_iterator it_M =
+        m_mapOfCameraTransformationMatrix.find(it->first);
+    if (it->first == m_referenceCameraName || it_M == m_mapOfCameraTransformationMatrix.end()) {
+      tracker->setScanLineOccluders(occluders);
+      continue;
+    }
+
+    const vpHomogeneousMatrix &cMc_ref = it_M->second;
+    std::vector<std::vector<std::pair<vpPoint, unsigned int> > > cameraOccluders = occluders;
+    for (size_t i = 0; i < cameraOccluders.size(); i++) {
+      for (size_t j = 0; j < cameraOccluders[i].size(); j++) {
+        vpPoint &P = cameraOccluders[i][j].first;
+        vpColVector cP(4, 1.0);
+        cP[0] = P.get_X();
+        cP[1] = P.get_Y();
+        cP[2] = P.get_Z();
+        cP = cMc_ref * cP;
+        P.set_X(cP[0]);
+        P.set_Y(cP[1]);
+        P.set_Z(cP[2]);
+      }
+    }
+    tracker->setScanLineOccluders(cameraOccluders);
+  }
+}
+
+/*!
+  Set the spacing between two rendered scanlines of the scanline visibility
+  test, see vpMbTracker::setScanLineStep().
+
+  \param step : Spacing in pixels, 1 to render all the scanlines.
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setScanLineStep(unsigned int step)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setScanLineStep(step);
+  }
+}
+
 void vpMbGenericTracker::setScanLineVisibilityTest(const bool &v)
 {
   vpMbTracker::setScanLineVisibilityTest(v);
@@ -4915,6 +5648,192 @@ void vpMbGenericTracker::setTrackerType(const std::map<std::string, int> &mapOfT
   }
 }
 
+/*!
+  Use a lookup of the moving-edge mask responses shared with other trackers,
+  see vpMbEdgeTracker::setSharedMovingEdgeGradientLookup().
+
+  \param lookup : Shared lookup, NULL to only use the own lookups.
+
+  \note This function will set the new parameter for all the cameras. The
+  lookup is only used by the cameras tracking the image it was updated with.
+*/
+void vpMbGenericTracker::setSharedMovingEdgeGradientLookup(const vpMeGradientLookup *lookup)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setSharedMovingEdgeGradientLookup(lookup);
+  }
+}
+
+/*!
+  Share the responses of the moving-edge masks through a per-frame lookup,
+  see vpMbEdgeTracker::setUseMovingEdgeGradientLookup().
+
+  \param use : True to use the lookup.
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setUseMovingEdgeGradientLookup(bool use)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setUseMovingEdgeGradientLookup(use);
+  }
+}
+
+/*!
+  Enable the concurrent processing of the dense depth faces of each camera,
+  see vpMbDepthDenseTracker::setUseParallelDepthDense(). It can be combined
+  with setUseParallelTracking().
+
+  \param parallel : True to process the faces concurrently.
+
+  \note This function will set the new parameter for all the cameras.
+
+  \sa setNbParallelDepthDenseThreads()
+*/
+void vpMbGenericTracker::setUseParallelDepthDense(bool parallel)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setUseParallelDepthDense(parallel);
+  }
+}
+
+/*!
+  Enable the concurrent processing of the lines, cylinders and circles of
+  each camera when the moving edges are initialized, tracked, updated and
+  reinitialized, see vpMbEdgeTracker::setUseParallelMovingEdge(). It can be
+  combined with setUseParallelTracking().
+
+  \param parallel : True to process the primitives concurrently.
+
+  \note This function will set the new parameter for all the cameras.
+
+  \sa setNbParallelMovingEdgeThreads()
+*/
+void vpMbGenericTracker::setUseParallelMovingEdge(bool parallel)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setUseParallelMovingEdge(parallel);
+  }
+}
+
+/*!
+  Enable the concurrent rendering of the scanline visibility of each camera,
+  see vpMbTracker::setUseParallelScanLine(). The result is the same as the
+  sequential rendering.
+
+  \param parallel : True to render the scanlines concurrently.
+
+  \note This function will set the new parameter for all the cameras.
+
+  \sa setNbParallelScanLineThreads()
+*/
+void vpMbGenericTracker::setUseParallelScanLine(bool parallel)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setUseParallelScanLine(parallel);
+  }
+}
+
+/*!
+  Enable or disable the concurrent processing of the cameras.
+
+  When enabled, the moving-edge, KLT and depth features of each camera are
+  tracked, and the per-camera interaction matrices, residuals and robust
+  weights are computed, concurrently on the OpenMP thread pool. The
+  per-camera blocks are then stacked in the order of the camera names. With
+  setDeterministicParallelTracking() set to true (default) the estimated pose
+  is bit-identical to the sequential path.
+
+  This option has no effect with a single camera, and requires OpenMP and
+  C++11 support.
+
+  \param parallel : If true, the cameras are processed concurrently.
+
+  \sa setNbParallelTrackingThreads(), setDeterministicParallelTracking()
+*/
+void vpMbGenericTracker::setUseParallelTracking(bool parallel)
+{
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  m_useParallelTracking = parallel;
+#else
+  if (parallel) {
+    std::cerr << "Parallel tracking requires OpenMP and C++11 support, the cameras are processed sequentially."
+              << std::endl;
+  }
+  m_useParallelTracking = false;
+#endif
+}
+
+/*!
+  Enable or disable the measure of the timings and counters of each tracking
+  step: wall time of the visibility test, of the features tracking, of the
+  interaction matrices computation, of the robust weighting and of the
+  resolution, number of iterations, number of used and rejected features and
+  residual norms. When disabled (default), nothing is measured.
+
+  \param use : If true, the statistics are measured.
+
+  \sa getTrackingStatistics()
+*/
+void vpMbGenericTracker::setUseTrackingStatistics(bool use)
+{
+  m_useTrackingStatistics = use;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    it->second->m_useTrackingStatistics = use;
+  }
+}
+
+/*!
+  Return true if the cameras have to be processed concurrently.
+*/
+bool vpMbGenericTracker::useParallelTracking() const
+{
+  return m_useParallelTracking && m_mapOfTrackers.size() > 1;
+}
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+/*!
+  Run \e task for each camera index on the OpenMP thread pool. An exception
+  thrown by a task does not leave the parallel region: it is kept and
+  rethrown once all the tasks are done. If several tasks failed, the
+  exception of the first camera is rethrown, as with the sequential path.
+
+  \param nbCameras : Number of cameras.
+  \param task : Per-camera task, called with the camera index.
+*/
+void vpMbGenericTracker::runPerCamera(unsigned int nbCameras, const std::function<void(unsigned int)> &task) const
+{
+  std::vector<std::exception_ptr> exceptions(nbCameras);
+  int nbThreads = static_cast<int>(m_nbParallelTrackingThreads > 0 ? m_nbParallelTrackingThreads : nbCameras);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nbThreads)
+  for (int i = 0; i < static_cast<int>(nbCameras); i++) {
+    try {
+      task(static_cast<unsigned int>(i));
+    } catch (...) {
+      exceptions[static_cast<size_t>(i)] = std::current_exception();
+    }
+  }
+
+  for (size_t i = 0; i < exceptions.size(); i++) {
+    if (exceptions[i]) {
+      std::rethrow_exception(exceptions[i]);
+    }
+  }
+}
+#endif
+
 /*!
   Set if the polygon that has the given name has to be considered during
   the tracking phase.
@@ -4969,7 +5888,7 @@ void vpMbGenericTracker::setUseEdgeTracking(const std::string &name, const bool
   }
 }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 /*!
   Set if the polygon that has the given name has to be considered during
   the tracking phase.
@@ -5161,7 +6080,7 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
     TrackerWrapper *tracker = it->second;
 
     if ((tracker->m_trackerType & (EDGE_TRACKER |
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                    KLT_TRACKER |
 #endif
                                    DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
@@ -5169,7 +6088,7 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
     }
 
     if (tracker->m_trackerType & (EDGE_TRACKER
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                   | KLT_TRACKER
 #endif
                                   ) &&
@@ -5183,6 +6102,12 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
     }
   }
 
+  if (m_useTrackingStatistics) {
+    startTrackingStatistics();
+  }
+
+  predictPose(mapOfImages);
+
   preTracking(mapOfImages, mapOfPointClouds);
 
   try {
@@ -5193,31 +6118,15 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
   }
 
   testTracking();
+  m_posePredictor.update(m_cMo, m_nbVVSIterations);
 
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-
-    if (tracker->m_trackerType & EDGE_TRACKER && displayFeatures) {
-      tracker->m_featuresToBeDisplayedEdge = tracker->getFeaturesForDisplayEdge();
-    }
-
-    tracker->postTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
+  postTracking(mapOfImages, mapOfPointClouds);
 
-    if (displayFeatures) {
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-      if (tracker->m_trackerType & KLT_TRACKER) {
-        tracker->m_featuresToBeDisplayedKlt = tracker->getFeaturesForDisplayKlt();
-      }
-#endif
+  computeProjectionError();
 
-      if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
-        tracker->m_featuresToBeDisplayedDepthNormal = tracker->getFeaturesForDisplayDepthNormal();
-      }
-    }
+  if (m_useTrackingStatistics) {
+    stopTrackingStatistics();
   }
-
-  computeProjectionError();
 }
 
 /*!
@@ -5237,7 +6146,7 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<vpRGBa> *> &m
     TrackerWrapper *tracker = it->second;
 
     if ((tracker->m_trackerType & (EDGE_TRACKER |
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                    KLT_TRACKER |
 #endif
                                    DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
@@ -5245,13 +6154,13 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<vpRGBa> *> &m
     }
 
     if (tracker->m_trackerType & (EDGE_TRACKER
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                   | KLT_TRACKER
 #endif
                                   ) && mapOfImages[it->first] == NULL) {
       throw vpException(vpException::fatalError, "Image pointer is NULL!");
     } else if (tracker->m_trackerType & (EDGE_TRACKER
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                   | KLT_TRACKER
 #endif
                                   ) && mapOfImages[it->first] != NULL) {
@@ -5265,6 +6174,12 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<vpRGBa> *> &m
     }
   }
 
+  if (m_useTrackingStatistics) {
+    startTrackingStatistics();
+  }
+
+  predictPose(mapOfImages);
+
   preTracking(mapOfImages, mapOfPointClouds);
 
   try {
@@ -5275,31 +6190,15 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<vpRGBa> *> &m
   }
 
   testTracking();
+  m_posePredictor.update(m_cMo, m_nbVVSIterations);
 
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-
-    if (tracker->m_trackerType & EDGE_TRACKER && displayFeatures) {
-      tracker->m_featuresToBeDisplayedEdge = tracker->getFeaturesForDisplayEdge();
-    }
-
-    tracker->postTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
+  postTracking(mapOfImages, mapOfPointClouds);
 
-    if (displayFeatures) {
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-      if (tracker->m_trackerType & KLT_TRACKER) {
-        tracker->m_featuresToBeDisplayedKlt = tracker->getFeaturesForDisplayKlt();
-      }
-#endif
+  computeProjectionError();
 
-      if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
-        tracker->m_featuresToBeDisplayedDepthNormal = tracker->getFeaturesForDisplayDepthNormal();
-      }
-    }
+  if (m_useTrackingStatistics) {
+    stopTrackingStatistics();
   }
-
-  computeProjectionError();
 }
 #endif
 
@@ -5323,7 +6222,7 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
     TrackerWrapper *tracker = it->second;
 
     if ((tracker->m_trackerType & (EDGE_TRACKER |
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                    KLT_TRACKER |
 #endif
                                    DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
@@ -5331,7 +6230,7 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
     }
 
     if (tracker->m_trackerType & (EDGE_TRACKER
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                   | KLT_TRACKER
 #endif
                                   ) &&
@@ -5345,6 +6244,12 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
     }
   }
 
+  if (m_useTrackingStatistics) {
+    startTrackingStatistics();
+  }
+
+  predictPose(mapOfImages);
+
   preTracking(mapOfImages, mapOfPointClouds, mapOfPointCloudWidths, mapOfPointCloudHeights);
 
   try {
@@ -5355,31 +6260,15 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
   }
 
   testTracking();
+  m_posePredictor.update(m_cMo, m_nbVVSIterations);
 
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-
-    if (tracker->m_trackerType & EDGE_TRACKER && displayFeatures) {
-      tracker->m_featuresToBeDisplayedEdge = tracker->getFeaturesForDisplayEdge();
-    }
-
-    tracker->postTracking(mapOfImages[it->first], mapOfPointCloudWidths[it->first], mapOfPointCloudHeights[it->first]);
+  postTracking(mapOfImages, mapOfPointCloudWidths, mapOfPointCloudHeights);
 
-    if (displayFeatures) {
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-      if (tracker->m_trackerType & KLT_TRACKER) {
-        tracker->m_featuresToBeDisplayedKlt = tracker->getFeaturesForDisplayKlt();
-      }
-#endif
+  computeProjectionError();
 
-      if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
-        tracker->m_featuresToBeDisplayedDepthNormal = tracker->getFeaturesForDisplayDepthNormal();
-      }
-    }
+  if (m_useTrackingStatistics) {
+    stopTrackingStatistics();
   }
-
-  computeProjectionError();
 }
 
 /*!
@@ -5403,7 +6292,7 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<vpRGBa> *> &m
     TrackerWrapper *tracker = it->second;
 
     if ((tracker->m_trackerType & (EDGE_TRACKER |
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                    KLT_TRACKER |
 #endif
                                    DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
@@ -5411,13 +6300,13 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<vpRGBa> *> &m
     }
 
     if (tracker->m_trackerType & (EDGE_TRACKER
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                   | KLT_TRACKER
 #endif
                                   ) && mapOfColorImages[it->first] == NULL) {
       throw vpException(vpException::fatalError, "Image pointer is NULL!");
     } else if (tracker->m_trackerType & (EDGE_TRACKER
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                                   | KLT_TRACKER
 #endif
                                   ) && mapOfColorImages[it->first] != NULL) {
@@ -5431,6 +6320,12 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<vpRGBa> *> &m
     }
   }
 
+  if (m_useTrackingStatistics) {
+    startTrackingStatistics();
+  }
+
+  predictPose(mapOfImages);
+
   preTracking(mapOfImages, mapOfPointClouds, mapOfPointCloudWidths, mapOfPointCloudHeights);
 
   try {
@@ -5441,36 +6336,21 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<vpRGBa> *> &m
   }
 
   testTracking();
+  m_posePredictor.update(m_cMo, m_nbVVSIterations);
 
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-
-    if (tracker->m_trackerType & EDGE_TRACKER && displayFeatures) {
-      tracker->m_featuresToBeDisplayedEdge = tracker->getFeaturesForDisplayEdge();
-    }
-
-    tracker->postTracking(mapOfImages[it->first], mapOfPointCloudWidths[it->first], mapOfPointCloudHeights[it->first]);
+  postTracking(mapOfImages, mapOfPointCloudWidths, mapOfPointCloudHeights);
 
-    if (displayFeatures) {
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-      if (tracker->m_trackerType & KLT_TRACKER) {
-        tracker->m_featuresToBeDisplayedKlt = tracker->getFeaturesForDisplayKlt();
-      }
-#endif
+  computeProjectionError();
 
-      if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
-        tracker->m_featuresToBeDisplayedDepthNormal = tracker->getFeaturesForDisplayDepthNormal();
-      }
-    }
+  if (m_useTrackingStatistics) {
+    stopTrackingStatistics();
   }
-
-  computeProjectionError();
 }
 
 /** TrackerWrapper **/
 vpMbGenericTracker::TrackerWrapper::TrackerWrapper()
-  : m_error(), m_L(), m_trackerType(EDGE_TRACKER), m_w(), m_weightedError()
+  : m_error(), m_L(), m_trackerType(EDGE_TRACKER), m_w(), m_weightedError(), m_useTrackingStatistics(false),
+    m_statistics()
 {
   m_lambda = 1.0;
   m_maxIter = 30;
@@ -5483,10 +6363,11 @@ vpMbGenericTracker::TrackerWrapper::TrackerWrapper()
 }
 
 vpMbGenericTracker::TrackerWrapper::TrackerWrapper(int trackerType)
-  : m_error(), m_L(), m_trackerType(trackerType), m_w(), m_weightedError()
+  : m_error(), m_L(), m_trackerType(trackerType), m_w(), m_weightedError(), m_useTrackingStatistics(false),
+    m_statistics()
 {
   if ((m_trackerType & (EDGE_TRACKER |
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                         KLT_TRACKER |
 #endif
                         DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
@@ -5519,7 +6400,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
   unsigned int iter = 0;
 
   double factorEdge = 1.0;
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   double factorKlt = 1.0;
 #endif
   double factorDepth = 1.0;
@@ -5531,7 +6412,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
 
   double mu = m_initialMu;
   vpHomogeneousMatrix cMo_prev;
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   vpHomogeneousMatrix ctTc0_Prev; // Only for KLT
 #endif
   bool isoJoIdentity_ = true;
@@ -5541,7 +6422,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
   vpMatrix L_true, LVJ_true;
 
   unsigned int nb_edge_features = m_error_edge.getRows();
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   unsigned int nb_klt_features = m_error_klt.getRows();
 #endif
   unsigned int nb_depth_features = m_error_depthNormal.getRows();
@@ -5553,7 +6434,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
     bool reStartFromLastIncrement = false;
     computeVVSCheckLevenbergMarquardt(iter, m_error, error_prev, cMo_prev, mu, reStartFromLastIncrement);
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
     if (reStartFromLastIncrement) {
       if (m_trackerType & KLT_TRACKER) {
         ctTc0 = ctTc0_Prev;
@@ -5623,7 +6504,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
         start_index += nb_edge_features;
       }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
       if (m_trackerType & KLT_TRACKER) {
         for (unsigned int i = 0; i < nb_klt_features; i++) {
           double wi = m_w_klt[i] * factorKlt;
@@ -5679,7 +6560,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
       computeVVSPoseEstimation(isoJoIdentity_, iter, m_L, LTL, m_weightedError, m_error, error_prev, LTR, mu, v);
 
       cMo_prev = m_cMo;
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
       if (m_trackerType & KLT_TRACKER) {
         ctTc0_Prev = ctTc0;
       }
@@ -5687,7 +6568,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
 
       m_cMo = vpExponentialMap::direct(v).inverse() * m_cMo;
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
       if (m_trackerType & KLT_TRACKER) {
         ctTc0 = vpExponentialMap::direct(v).inverse() * ctTc0;
       }
@@ -5729,7 +6610,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInit(const vpImage<unsigned c
     m_w_edge.clear();
   }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
     vpMbKltTracker::computeVVSInit();
     nbFeatures += m_error_klt.getRows();
@@ -5783,7 +6664,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(co
     vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(*ptr_I);
   }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
     vpMbKltTracker::computeVVSInteractionMatrixAndResidu();
   }
@@ -5805,7 +6686,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(co
     start_index += m_error_edge.getRows();
   }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
     m_L.insert(m_L_klt, start_index, 0);
     m_error.insert(start_index, m_error_klt);
@@ -5840,7 +6721,7 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSWeights()
     start_index += m_w_edge.getRows();
   }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
     vpMbTracker::computeVVSWeights(m_robust_klt, m_error_klt, m_w_klt);
     m_w.insert(start_index, m_w_klt);
@@ -5936,7 +6817,7 @@ void vpMbGenericTracker::TrackerWrapper::display(const vpImage<unsigned char> &I
 
 #ifdef VISP_HAVE_OGRE
   if ((m_trackerType & EDGE_TRACKER)
-    #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+    #if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
       || (m_trackerType & KLT_TRACKER)
     #endif
       ) {
@@ -6016,7 +6897,7 @@ void vpMbGenericTracker::TrackerWrapper::display(const vpImage<vpRGBa> &I, const
 
 #ifdef VISP_HAVE_OGRE
   if ((m_trackerType & EDGE_TRACKER)
-    #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+    #if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
       || (m_trackerType & KLT_TRACKER)
     #endif
       ) {
@@ -6035,7 +6916,7 @@ std::vector<std::vector<double> > vpMbGenericTracker::TrackerWrapper::getFeature
     features.insert(features.end(), m_featuresToBeDisplayedEdge.begin(), m_featuresToBeDisplayedEdge.end());
   }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
     //m_featuresToBeDisplayedKlt updated after postTracking()
     features.insert(features.end(), m_featuresToBeDisplayedKlt.begin(), m_featuresToBeDisplayedKlt.end());
@@ -6061,7 +6942,7 @@ std::vector<std::vector<double> > vpMbGenericTracker::TrackerWrapper::getModelFo
   if (m_trackerType == EDGE_TRACKER) {
     models = vpMbEdgeTracker::getModelForDisplay(width, height, cMo, cam, displayFullModel);
   }
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   else if (m_trackerType == KLT_TRACKER) {
     models = vpMbKltTracker::getModelForDisplay(width, height, cMo, cam, displayFullModel);
   }
@@ -6123,7 +7004,7 @@ void vpMbGenericTracker::TrackerWrapper::init(const vpImage<unsigned char> &I)
     faces.computeScanLineRender(m_cam, I.getWidth(), I.getHeight());
   }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER)
     vpMbKltTracker::reinit(I);
 #endif
@@ -6150,7 +7031,7 @@ void vpMbGenericTracker::TrackerWrapper::initCircle(const vpPoint &p1, const vpP
   if (m_trackerType & EDGE_TRACKER)
     vpMbEdgeTracker::initCircle(p1, p2, p3, radius, idFace, name);
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER)
     vpMbKltTracker::initCircle(p1, p2, p3, radius, idFace, name);
 #endif
@@ -6162,7 +7043,7 @@ void vpMbGenericTracker::TrackerWrapper::initCylinder(const vpPoint &p1, const v
   if (m_trackerType & EDGE_TRACKER)
     vpMbEdgeTracker::initCylinder(p1, p2, radius, idFace, name);
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER)
     vpMbKltTracker::initCylinder(p1, p2, radius, idFace, name);
 #endif
@@ -6173,7 +7054,7 @@ void vpMbGenericTracker::TrackerWrapper::initFaceFromCorners(vpMbtPolygon &polyg
   if (m_trackerType & EDGE_TRACKER)
     vpMbEdgeTracker::initFaceFromCorners(polygon);
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER)
     vpMbKltTracker::initFaceFromCorners(polygon);
 #endif
@@ -6190,7 +7071,7 @@ void vpMbGenericTracker::TrackerWrapper::initFaceFromLines(vpMbtPolygon &polygon
   if (m_trackerType & EDGE_TRACKER)
     vpMbEdgeTracker::initFaceFromLines(polygon);
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER)
     vpMbKltTracker::initFaceFromLines(polygon);
 #endif
@@ -6233,7 +7114,7 @@ void vpMbGenericTracker::TrackerWrapper::loadConfigFile(const std::string &confi
   xmlp.setKltHarrisParam(0.01);
   xmlp.setKltBlockSize(3);
   xmlp.setKltPyramidLevels(3);
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   xmlp.setKltMaskBorder(maskBorder);
 #endif
 
@@ -6255,7 +7136,7 @@ void vpMbGenericTracker::TrackerWrapper::loadConfigFile(const std::string &confi
     std::vector<std::string> tracker_names;
     if (m_trackerType & EDGE_TRACKER)
       tracker_names.push_back("Edge");
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
     if (m_trackerType & KLT_TRACKER)
       tracker_names.push_back("Klt");
 #endif
@@ -6312,7 +7193,7 @@ void vpMbGenericTracker::TrackerWrapper::loadConfigFile(const std::string &confi
   vpMbEdgeTracker::setMovingEdge(meParser);
 
 // KLT
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   tracker.setMaxFeatures((int)xmlp.getKltMaxFeatures());
   tracker.setWindowSize((int)xmlp.getKltWindowSize());
   tracker.setQuality(xmlp.getKltQuality());
@@ -6344,36 +7225,42 @@ void vpMbGenericTracker::TrackerWrapper::loadConfigFile(const std::string &confi
 void vpMbGenericTracker::TrackerWrapper::postTracking(const vpImage<unsigned char> *const ptr_I,
                                                       const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
 {
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   // KLT
   if (m_trackerType & KLT_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.kltTime);
     if (vpMbKltTracker::postTracking(*ptr_I, m_w_klt)) {
       vpMbKltTracker::reinit(*ptr_I);
     }
   }
 #endif
 
-  // Looking for new visible face
-  if (m_trackerType & EDGE_TRACKER) {
-    bool newvisibleface = false;
-    vpMbEdgeTracker::visibleFace(*ptr_I, m_cMo, newvisibleface);
+  {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.visibilityTime);
+
+    // Looking for new visible face
+    if (m_trackerType & EDGE_TRACKER) {
+      bool newvisibleface = false;
+      vpMbEdgeTracker::visibleFace(*ptr_I, m_cMo, newvisibleface);
 
-    if (useScanLine) {
-      faces.computeClippedPolygons(m_cMo, m_cam);
-      faces.computeScanLineRender(m_cam, ptr_I->getWidth(), ptr_I->getHeight());
+      if (useScanLine) {
+        faces.computeClippedPolygons(m_cMo, m_cam);
+        faces.computeScanLineRender(m_cam, ptr_I->getWidth(), ptr_I->getHeight());
+      }
     }
-  }
 
-  // Depth normal
-  if (m_trackerType & DEPTH_NORMAL_TRACKER)
-    vpMbDepthNormalTracker::computeVisibility(point_cloud->width, point_cloud->height);
+    // Depth normal
+    if (m_trackerType & DEPTH_NORMAL_TRACKER)
+      vpMbDepthNormalTracker::computeVisibility(point_cloud->width, point_cloud->height);
 
-  // Depth dense
-  if (m_trackerType & DEPTH_DENSE_TRACKER)
-    vpMbDepthDenseTracker::computeVisibility(point_cloud->width, point_cloud->height);
+    // Depth dense
+    if (m_trackerType & DEPTH_DENSE_TRACKER)
+      vpMbDepthDenseTracker::computeVisibility(point_cloud->width, point_cloud->height);
+  }
 
   // Edge
   if (m_trackerType & EDGE_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.edgeTime);
     vpMbEdgeTracker::updateMovingEdge(*ptr_I);
 
     vpMbEdgeTracker::initMovingEdge(*ptr_I, m_cMo);
@@ -6390,6 +7277,7 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
                                                      const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
 {
   if (m_trackerType & EDGE_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.edgeTime);
     try {
       vpMbEdgeTracker::trackMovingEdge(*ptr_I);
     } catch (...) {
@@ -6398,8 +7286,9 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
     }
   }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.kltTime);
     try {
       vpMbKltTracker::preTracking(*ptr_I);
     } catch (const vpException &e) {
@@ -6410,6 +7299,7 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
 #endif
 
   if (m_trackerType & DEPTH_NORMAL_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.depthNormalTime);
     try {
       vpMbDepthNormalTracker::segmentPointCloud(point_cloud);
     } catch (...) {
@@ -6419,6 +7309,7 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
   }
 
   if (m_trackerType & DEPTH_DENSE_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.depthDenseTime);
     try {
       vpMbDepthDenseTracker::segmentPointCloud(point_cloud);
     } catch (...) {
@@ -6433,36 +7324,42 @@ void vpMbGenericTracker::TrackerWrapper::postTracking(const vpImage<unsigned cha
                                                       const unsigned int pointcloud_width,
                                                       const unsigned int pointcloud_height)
 {
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   // KLT
   if (m_trackerType & KLT_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.kltTime);
     if (vpMbKltTracker::postTracking(*ptr_I, m_w_klt)) {
       vpMbKltTracker::reinit(*ptr_I);
     }
   }
 #endif
 
-  // Looking for new visible face
-  if (m_trackerType & EDGE_TRACKER) {
-    bool newvisibleface = false;
-    vpMbEdgeTracker::visibleFace(*ptr_I, m_cMo, newvisibleface);
+  {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.visibilityTime);
+
+    // Looking for new visible face
+    if (m_trackerType & EDGE_TRACKER) {
+      bool newvisibleface = false;
+      vpMbEdgeTracker::visibleFace(*ptr_I, m_cMo, newvisibleface);
 
-    if (useScanLine) {
-      faces.computeClippedPolygons(m_cMo, m_cam);
-      faces.computeScanLineRender(m_cam, ptr_I->getWidth(), ptr_I->getHeight());
+      if (useScanLine) {
+        faces.computeClippedPolygons(m_cMo, m_cam);
+        faces.computeScanLineRender(m_cam, ptr_I->getWidth(), ptr_I->getHeight());
+      }
     }
-  }
 
-  // Depth normal
-  if (m_trackerType & DEPTH_NORMAL_TRACKER)
-    vpMbDepthNormalTracker::computeVisibility(pointcloud_width, pointcloud_height);
+    // Depth normal
+    if (m_trackerType & DEPTH_NORMAL_TRACKER)
+      vpMbDepthNormalTracker::computeVisibility(pointcloud_width, pointcloud_height);
 
-  // Depth dense
-  if (m_trackerType & DEPTH_DENSE_TRACKER)
-    vpMbDepthDenseTracker::computeVisibility(pointcloud_width, pointcloud_height);
+    // Depth dense
+    if (m_trackerType & DEPTH_DENSE_TRACKER)
+      vpMbDepthDenseTracker::computeVisibility(pointcloud_width, pointcloud_height);
+  }
 
   // Edge
   if (m_trackerType & EDGE_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.edgeTime);
     vpMbEdgeTracker::updateMovingEdge(*ptr_I);
 
     vpMbEdgeTracker::initMovingEdge(*ptr_I, m_cMo);
@@ -6481,6 +7378,7 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
                                                      const unsigned int pointcloud_height)
 {
   if (m_trackerType & EDGE_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.edgeTime);
     try {
       vpMbEdgeTracker::trackMovingEdge(*ptr_I);
     } catch (...) {
@@ -6489,8 +7387,9 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
     }
   }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.kltTime);
     try {
       vpMbKltTracker::preTracking(*ptr_I);
     } catch (const vpException &e) {
@@ -6501,6 +7400,7 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
 #endif
 
   if (m_trackerType & DEPTH_NORMAL_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.depthNormalTime);
     try {
       vpMbDepthNormalTracker::segmentPointCloud(*point_cloud, pointcloud_width, pointcloud_height);
     } catch (...) {
@@ -6510,6 +7410,7 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
   }
 
   if (m_trackerType & DEPTH_DENSE_TRACKER) {
+    vpScopedStatisticTimer timer(m_useTrackingStatistics, m_statistics.depthDenseTime);
     try {
       vpMbDepthDenseTracker::segmentPointCloud(*point_cloud, pointcloud_width, pointcloud_height);
     } catch (...) {
@@ -6566,8 +7467,8 @@ void vpMbGenericTracker::TrackerWrapper::reInitModel(const vpImage<unsigned char
   nbvisiblepolygone = 0;
 
 // KLT
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-#if (VISP_HAVE_OPENCV_VERSION < 0x020408)
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408)
   if (cur != NULL) {
     cvReleaseImage(&cur);
     cur = NULL;
@@ -6649,7 +7550,7 @@ void vpMbGenericTracker::TrackerWrapper::reInitModel(const vpImage<vpRGBa> &I_co
 void vpMbGenericTracker::TrackerWrapper::resetTracker()
 {
   vpMbEdgeTracker::resetTracker();
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   vpMbKltTracker::resetTracker();
 #endif
   vpMbDepthNormalTracker::resetTracker();
@@ -6661,7 +7562,7 @@ void vpMbGenericTracker::TrackerWrapper::setCameraParameters(const vpCameraParam
   m_cam = cam;
 
   vpMbEdgeTracker::setCameraParameters(m_cam);
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   vpMbKltTracker::setCameraParameters(m_cam);
 #endif
   vpMbDepthNormalTracker::setCameraParameters(m_cam);
@@ -6699,7 +7600,7 @@ void vpMbGenericTracker::TrackerWrapper::setPose(const vpImage<unsigned char> *
     vpImageConvert::convert(*I_color, m_I);
   }
 
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
     performKltSetPose = true;
 
@@ -6771,7 +7672,7 @@ void vpMbGenericTracker::TrackerWrapper::setProjectionErrorComputation(const boo
 void vpMbGenericTracker::TrackerWrapper::setScanLineVisibilityTest(const bool &v)
 {
   vpMbEdgeTracker::setScanLineVisibilityTest(v);
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   vpMbKltTracker::setScanLineVisibilityTest(v);
 #endif
   vpMbDepthNormalTracker::setScanLineVisibilityTest(v);
@@ -6781,7 +7682,7 @@ void vpMbGenericTracker::TrackerWrapper::setScanLineVisibilityTest(const bool &v
 void vpMbGenericTracker::TrackerWrapper::setTrackerType(int type)
 {
   if ((type & (EDGE_TRACKER |
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                KLT_TRACKER |
 #endif
                DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
@@ -6805,7 +7706,7 @@ void vpMbGenericTracker::TrackerWrapper::track(const vpImage<unsigned char> &
 )
 {
   if ((m_trackerType & (EDGE_TRACKER
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                         | KLT_TRACKER
 #endif
                         )) == 0) {
@@ -6828,7 +7729,7 @@ void vpMbGenericTracker::TrackerWrapper::track(const vpImage<unsigned char> *con
                                                const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
 {
   if ((m_trackerType & (EDGE_TRACKER |
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                         KLT_TRACKER |
 #endif
                         DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
@@ -6837,7 +7738,7 @@ void vpMbGenericTracker::TrackerWrapper::track(const vpImage<unsigned char> *con
   }
 
   if (m_trackerType & (EDGE_TRACKER
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                        | KLT_TRACKER
 #endif
                        ) &&
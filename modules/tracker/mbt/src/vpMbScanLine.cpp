@@ -48,9 +48,15 @@
 #include <iostream>
 #include <utility>
 
+#include <visp3/core/vpException.h>
 #include <visp3/core/vpMeterPixelConversion.h>
 #include <visp3/mbt/vpMbScanLine.h>
 
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+#include <exception>
+#include <omp.h>
+#endif
+
 #if defined(DEBUG_DISP)
 #include <visp3/gui/vpDisplayGDI.h>
 #include <visp3/gui/vpDisplayX.h>
@@ -59,7 +65,12 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 vpMbScanLine::vpMbScanLine()
-  : w(0), h(0), K(), maskBorder(0), mask(), primitive_ids(), visibility_samples(), depthTreshold(1e-06)
+  : w(0), h(0), K(), maskBorder(0), mask(), primitive_ids(), edge_indices(), visibility_samples(),
+    visibility_samples_Y(), depthTreshold(1e-06), edge_x0(), edge_y0(), edge_z0(), edge_x1(), edge_y1(), edge_z1(),
+    edge_keys(), edge_samples(), polygon_edges(), polygon_ids(), scanlinesY(), scanlinesX(), tile_local_scanlines(),
+    tile_samples(), maskX(), maskY(), useParallel(false), nbThreads(0), tileSize(32), scanLineStep(1),
+    incrementalThreshold(0), sceneReused(false), referenceValid(false), ref_x0(), ref_y0(), ref_x1(), ref_y1(),
+    ref_edge_samples(), ref_polygon_edges(), ref_polygon_ids()
 #if defined(DEBUG_DISP)
     ,
     dispMaskDebug(NULL), dispLineDebug(NULL), linedebugImg()
@@ -83,25 +94,81 @@ vpMbScanLine::~vpMbScanLine()
     delete dispMaskDebug;
 #endif
 }
+
 /*!
-  Compute the intersections between Y-axis scanlines and a given line (two
-  points polygon).
+  Project the edges of the polygons in the image and store them in the edge
+  table. A polygon of two points is a single line, the edges of the other
+  polygons are closed.
 
-  \param a : First point of the line.
-  \param b : Second point of the line.
-  \param edge : Pair with the two points of the line.
-  \param ID : Id of the given line (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+  \param polygons : List of polygons composed by arrays of lines.
+  \param listPolyIndices : List of polygons IDs.
+  \param cam : Camera parameters.
+*/
+void vpMbScanLine::buildEdgeTable(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > *> &polygons,
+                                  const std::vector<int> &listPolyIndices, const vpCameraParameters &cam)
+{
+  edge_x0.clear();
+  edge_y0.clear();
+  edge_z0.clear();
+  edge_x1.clear();
+  edge_y1.clear();
+  edge_z1.clear();
+  edge_keys.clear();
+  polygon_edges.clear();
+  polygon_ids.clear();
+
+  const double px = cam.get_px(), py = cam.get_py(), u0 = cam.get_u0(), v0 = cam.get_v0();
+
+  polygon_edges.push_back(0);
+  for (size_t ID = 0; ID < polygons.size(); ++ID) {
+    const std::vector<std::pair<vpPoint, unsigned int> > &polygon = *(polygons[ID]);
+    const size_t nb_edges = polygon.size() < 2 ? 0 : (polygon.size() == 2 ? 1 : polygon.size());
+
+    for (size_t i = 0; i < nb_edges; ++i) {
+      const vpPoint &a = polygon[i].first;
+      const vpPoint &b = polygon[(i + 1) % polygon.size()].first;
+
+      // Same computation as createVectorFromPoint() followed by the perspective division
+      const double a0 = a.get_X() * px + u0 * a.get_Z(), a1 = a.get_Y() * py + v0 * a.get_Z(), a2 = a.get_Z();
+      const double b0 = b.get_X() * px + u0 * b.get_Z(), b1 = b.get_Y() * py + v0 * b.get_Z(), b2 = b.get_Z();
+      edge_x0.push_back(a0 / a2);
+      edge_y0.push_back(a1 / a2);
+      edge_z0.push_back(a2);
+      edge_x1.push_back(b0 / b2);
+      edge_y1.push_back(b1 / b2);
+      edge_z1.push_back(b2);
+      edge_keys.push_back(makeMbScanLineEdge(a, b));
+    }
+
+    polygon_edges.push_back(edge_x0.size());
+    polygon_ids.push_back(listPolyIndices[ID]);
+  }
+}
+
+/*!
+  Compute the intersections between the Y-axis scanlines of a tile and an
+  edge of the edge table.
+
+  \param edge : Index of the edge in the edge table.
+  \param ID : Id of the polygon of the edge (has to be know when using
+  queries).
+  \param scanlines : Resulting intersections, scanline y is stored at index
+  y - offset.
+  \param begin, end : Scanlines of the tile.
+  \param offset : Index of the first scanline in \e scanlines.
+  \param first, last : Updated with the range of the scanlines that have an
+  intersection.
 */
-void vpMbScanLine::drawLineY(const vpColVector &a, const vpColVector &b, const vpMbScanLineEdge &edge, const int ID,
-                             std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+void vpMbScanLine::drawLineY(size_t edge, const int ID, std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
+                             unsigned int begin, unsigned int end, unsigned int offset, unsigned int &first,
+                             unsigned int &last)
 {
-  double x0 = a[0] / a[2];
-  double y0 = a[1] / a[2];
-  double z0 = a[2];
-  double x1 = b[0] / b[2];
-  double y1 = b[1] / b[2];
-  double z1 = b[2];
+  double x0 = edge_x0[edge];
+  double y0 = edge_y0[edge];
+  double z0 = edge_z0[edge];
+  double x1 = edge_x1[edge];
+  double y1 = edge_y1[edge];
+  double z1 = edge_z1[edge];
   if (y0 > y1) {
     std::swap(x0, x1);
     std::swap(y0, y1);
@@ -112,12 +179,16 @@ void vpMbScanLine::drawLineY(const vpColVector &a, const vpColVector &b, const v
   if (y0 >= h - 1 || y1 < 0 || std::fabs(y1 - y0) <= std::numeric_limits<double>::epsilon())
     return;
 
-  const unsigned int _y0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(y0)));
+  const unsigned int _y0 = (unsigned int)(std::max)(0.0, std::ceil(y0));
   const double _y1 = (std::min)((double)h, (double)y1);
+  if (_y0 >= end || _y1 <= begin)
+    return;
 
   const bool b_sample_Y = (std::fabs(y0 - y1) > std::fabs(x0 - x1));
 
-  for (unsigned int y = _y0; y < _y1; ++y) {
+  // First rendered scanline of the tile
+  const unsigned int y_start = ((std::max)(_y0, begin) + scanLineStep - 1) / scanLineStep * scanLineStep;
+  for (unsigned int y = y_start; y < _y1 && y < end; y += scanLineStep) {
     double x = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
     const double alpha = getAlpha(y, y0 * z0, z0, y1 * z1, z1);
     vpMbScanLineSegment s;
@@ -126,31 +197,38 @@ void vpMbScanLine::drawLineY(const vpColVector &a, const vpColVector &b, const v
     s.Z2 = s.Z1 = mix(z0, z1, alpha);
     s.P2 = s.P1 = s.p * s.Z1;
     s.ID = ID;
-    s.edge = edge;
+    s.edge = edge_samples[edge];
     s.b_sample_Y = b_sample_Y;
-    scanlines[y].push_back(s);
+    scanlines[y - offset].push_back(s);
+    first = (std::min)(first, y);
+    last = (std::max)(last, y + 1);
   }
 }
 
 /*!
-  Compute the intersections between X-axis scanlines and a given line (two
-  points polygon).
-
-  \param a : First point of the line.
-  \param b : Second point of the line.
-  \param edge : Pair with the two points of the line.
-  \param ID : Id of the given line (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+  Compute the intersections between the X-axis scanlines of a tile and an
+  edge of the edge table.
+
+  \param edge : Index of the edge in the edge table.
+  \param ID : Id of the polygon of the edge (has to be know when using
+  queries).
+  \param scanlines : Resulting intersections, scanline x is stored at index
+  x - offset.
+  \param begin, end : Scanlines of the tile.
+  \param offset : Index of the first scanline in \e scanlines.
+  \param first, last : Updated with the range of the scanlines that have an
+  intersection.
 */
-void vpMbScanLine::drawLineX(const vpColVector &a, const vpColVector &b, const vpMbScanLineEdge &edge, const int ID,
-                             std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+void vpMbScanLine::drawLineX(size_t edge, const int ID, std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
+                             unsigned int begin, unsigned int end, unsigned int offset, unsigned int &first,
+                             unsigned int &last)
 {
-  double x0 = a[0] / a[2];
-  double y0 = a[1] / a[2];
-  double z0 = a[2];
-  double x1 = b[0] / b[2];
-  double y1 = b[1] / b[2];
-  double z1 = b[2];
+  double x0 = edge_x0[edge];
+  double y0 = edge_y0[edge];
+  double z0 = edge_z0[edge];
+  double x1 = edge_x1[edge];
+  double y1 = edge_y1[edge];
+  double z1 = edge_z1[edge];
   if (x0 > x1) {
     std::swap(x0, x1);
     std::swap(y0, y1);
@@ -161,12 +239,16 @@ void vpMbScanLine::drawLineX(const vpColVector &a, const vpColVector &b, const v
   if (x0 >= w - 1 || x1 < 0 || std::fabs(x1 - x0) <= std::numeric_limits<double>::epsilon())
     return;
 
-  const unsigned int _x0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(x0)));
+  const unsigned int _x0 = (unsigned int)(std::max)(0.0, std::ceil(x0));
   const double _x1 = (std::min)((double)w, (double)x1);
+  if (_x0 >= end || _x1 <= begin)
+    return;
 
   const bool b_sample_Y = (std::fabs(y0 - y1) > std::fabs(x0 - x1));
 
-  for (unsigned int x = _x0; x < _x1; ++x) {
+  // First rendered scanline of the tile
+  const unsigned int x_start = ((std::max)(_x0, begin) + scanLineStep - 1) / scanLineStep * scanLineStep;
+  for (unsigned int x = x_start; x < _x1 && x < end; x += scanLineStep) {
     double y = y0 + (y1 - y0) * (x - x0) / (x1 - x0);
     const double alpha = getAlpha(x, x0 * z0, z0, x1 * z1, z1);
     vpMbScanLineSegment s;
@@ -175,101 +257,31 @@ void vpMbScanLine::drawLineX(const vpColVector &a, const vpColVector &b, const v
     s.Z2 = s.Z1 = mix(z0, z1, alpha);
     s.P2 = s.P1 = s.p * s.Z1;
     s.ID = ID;
-    s.edge = edge;
+    s.edge = edge_samples[edge];
     s.b_sample_Y = b_sample_Y;
-    scanlines[x].push_back(s);
-  }
-}
-
-/*!
-  Compute the Y-axis scanlines intersections of a polygon.
-
-  \param polygon : Polygon composed by an array of lines.
-  \param ID : ID of the polygon (has to be know when using queries).
-  \param scanlines : Resulting intersections.
-*/
-void vpMbScanLine::drawPolygonY(const std::vector<std::pair<vpPoint, unsigned int> > &polygon, const int ID,
-                                std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
-{
-  if (polygon.size() < 2)
-    return;
-
-  if (polygon.size() == 2) {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon.front().first, p1, K);
-    createVectorFromPoint(polygon.back().first, p2, K);
-
-    drawLineY(p1, p2, makeMbScanLineEdge(polygon.front().first, polygon.back().first), ID, scanlines);
-    return;
-  }
-
-  std::vector<std::vector<vpMbScanLineSegment> > local_scanlines;
-  local_scanlines.resize(h);
-
-  for (size_t i = 0; i < polygon.size(); ++i) {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon[i].first, p1, K);
-    createVectorFromPoint(polygon[(i + 1) % polygon.size()].first, p2, K);
-
-    drawLineY(p1, p2, makeMbScanLineEdge(polygon[i].first, polygon[(i + 1) % polygon.size()].first), ID,
-              local_scanlines);
-  }
-
-  createScanLinesFromLocals(scanlines, local_scanlines, h);
-}
-
-/*!
-  Compute the X-axis scanlines intersections of a polygon.
-
-  \param polygon : Polygon composed by an array of lines.
-  \param ID : ID of the polygon (has to be know when using queries).
-  \param scanlines : Resulting intersections.
-*/
-void vpMbScanLine::drawPolygonX(const std::vector<std::pair<vpPoint, unsigned int> > &polygon, const int ID,
-                                std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
-{
-  if (polygon.size() < 2)
-    return;
-
-  if (polygon.size() == 2) {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon.front().first, p1, K);
-    createVectorFromPoint(polygon.back().first, p2, K);
-
-    drawLineX(p1, p2, makeMbScanLineEdge(polygon.front().first, polygon.back().first), ID, scanlines);
-    return;
-  }
-
-  std::vector<std::vector<vpMbScanLineSegment> > local_scanlines;
-  local_scanlines.resize(w);
-
-  for (size_t i = 0; i < polygon.size(); ++i) {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon[i].first, p1, K);
-    createVectorFromPoint(polygon[(i + 1) % polygon.size()].first, p2, K);
-
-    drawLineX(p1, p2, makeMbScanLineEdge(polygon[i].first, polygon[(i + 1) % polygon.size()].first), ID,
-              local_scanlines);
+    scanlines[x - offset].push_back(s);
+    first = (std::min)(first, x);
+    last = (std::max)(last, x + 1);
   }
-
-  createScanLinesFromLocals(scanlines, local_scanlines, w);
 }
 
 /*!
   Organise local scanlines in a global scanline vector.
   It also marks the computed intersections as starting or ending points.
-  This function will only be called by the drawPolygons functions.
+  The local scanlines are emptied to be reused by the next polygon.
 
   \param scanlines : Global scanline vector.
-  \param localScanlines : Local scanline vector (X or Y-axis).
-  \param size : Corresponding size (typically the width or the height).
+  \param localScanlines : Local scanline vector (X or Y-axis), scanline j is
+  stored at index j - offset.
+  \param first, last : Range of the scanlines to organise.
+  \param offset : Index of the first scanline in \e localScanlines.
 */
 void vpMbScanLine::createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
                                              std::vector<std::vector<vpMbScanLineSegment> > &localScanlines,
-                                             const unsigned int &size)
+                                             unsigned int first, unsigned int last, unsigned int offset)
 {
-  for (unsigned int j = 0; j < size; ++j) {
-    std::vector<vpMbScanLineSegment> &scanline = localScanlines[j];
+  for (unsigned int j = first; j < last; ++j) {
+    std::vector<vpMbScanLineSegment> &scanline = localScanlines[j - offset];
     sort(scanline.begin(), scanline.end(),
          vpMbScanLineSegmentComparator()); // Not sure its necessary
 
@@ -292,53 +304,52 @@ void vpMbScanLine::createScanLinesFromLocals(std::vector<std::vector<vpMbScanLin
       }
       scanlines[j].push_back(s);
     }
+    scanline.clear();
   }
 }
 
 /*!
-  Render a scene of polygons and compute scanlines intersections in order to
-  use queries.
-
-  \param polygons : List of polygons composed by arrays of lines.
-  \param listPolyIndices : List of polygons IDs (has to be know when using
-  queries). \param cam : Camera parameters. \param width : Width of the image
-  (render window). \param height : Height of the image (render window).
+  Render the Y-axis scanlines of a tile: compute the intersections with the
+  polygons, fill the primitive ids and the mask and collect the visibility
+  samples of the edges that are sampled along the Y-axis.
+
+  \param begin, end : Scanlines of the tile.
+  \param local : Local scanlines of the tile.
+  \param samples : Visibility samples of the tile, as (samples index,
+  scanline) pairs.
 */
-void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > *> &polygons,
-                             std::vector<int> listPolyIndices, const vpCameraParameters &cam, unsigned int width,
-                             unsigned int height)
+void vpMbScanLine::renderTileY(unsigned int begin, unsigned int end,
+                               std::vector<std::vector<vpMbScanLineSegment> > &local,
+                               std::vector<std::pair<int, int> > &samples)
 {
-  this->w = width;
-  this->h = height;
-  this->K = cam;
-
-  visibility_samples.clear();
-
-  std::vector<std::vector<vpMbScanLineSegment> > scanlinesY;
-  scanlinesY.resize(h);
-  std::vector<std::vector<vpMbScanLineSegment> > scanlinesX;
-  scanlinesX.resize(w);
-
-  mask.resize(h, w, 0);
-
-  vpImage<unsigned char> maskY(h, w, 0);
-  vpImage<unsigned char> maskX(h, w, 0);
-
-  primitive_ids.resize(h, w, -1);
+  samples.clear();
+  for (unsigned int y = begin; y < end; ++y) {
+    scanlinesY[y].clear();
+  }
+  local.resize(end - begin);
 
-  for (unsigned int ID = 0; ID < polygons.size(); ++ID) {
-    drawPolygonY(*(polygons[ID]), listPolyIndices[ID], scanlinesY);
-    drawPolygonX(*(polygons[ID]), listPolyIndices[ID], scanlinesX);
+  for (size_t i = 0; i + 1 < polygon_edges.size(); ++i) {
+    unsigned int first = end, last = begin;
+    if (polygon_edges[i + 1] - polygon_edges[i] == 1) {
+      drawLineY(polygon_edges[i], polygon_ids[i], scanlinesY, begin, end, 0, first, last);
+    } else {
+      for (size_t e = polygon_edges[i]; e < polygon_edges[i + 1]; ++e) {
+        drawLineY(e, polygon_ids[i], local, begin, end, begin, first, last);
+      }
+      createScanLinesFromLocals(scanlinesY, local, first, last, begin);
+    }
   }
 
-  // Y
-  int last_ID = -1;
-  vpMbScanLineSegment last_visible;
-  for (unsigned int y = 0; y < scanlinesY.size(); ++y) {
+  vpImage<unsigned char> &mask_Y = (maskBorder != 0) ? maskY : mask;
+  std::vector<std::pair<double, vpMbScanLineSegment> > stack;
+  for (unsigned int y = begin; y < end; y += scanLineStep) {
     std::vector<vpMbScanLineSegment> &scanline = scanlinesY[y];
     sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
 
-    std::vector<std::pair<double, vpMbScanLineSegment> > stack;
+    // Each scanline is independent, which allows to render the tiles concurrently
+    int last_ID = -1;
+    vpMbScanLineSegment last_visible;
+    stack.clear();
     for (size_t i = 0; i < scanline.size(); ++i) {
       const vpMbScanLineSegment &s = scanline[i];
 
@@ -372,29 +383,27 @@ void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, un
           switch (s.type) {
           case POINT:
             if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
-              visibility_samples[s.edge].insert((int)y);
+              samples.push_back(std::make_pair(s.edge, (int)y));
             break;
           case START:
             if (new_ID == s.ID)
-              visibility_samples[s.edge].insert((int)y);
+              samples.push_back(std::make_pair(s.edge, (int)y));
             break;
           case END:
             if (last_ID == s.ID)
-              visibility_samples[s.edge].insert((int)y);
+              samples.push_back(std::make_pair(s.edge, (int)y));
             break;
           }
 
-        // This part will only be used for MbKltTracking
+        // This part will only be used for MbKltTracking. The occluders, with an ID lower than -1, are not part of
+        // the mask
         if (last_ID != -1) {
-          const unsigned int x0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
+          const unsigned int x0 = (unsigned int)(std::max)(0.0, std::ceil(last_visible.p));
           double x1 = (std::min)((double)w, (double)s.p);
+          const unsigned char value = last_visible.ID >= 0 ? 255 : 0;
           for (unsigned int x = x0 + maskBorder; x < x1 - maskBorder; ++x) {
             primitive_ids[(unsigned int)y][(unsigned int)x] = last_visible.ID;
-
-            if (maskBorder != 0)
-              maskY[(unsigned int)y][(unsigned int)x] = 255;
-            else
-              mask[(unsigned int)y][(unsigned int)x] = 255;
+            mask_Y[(unsigned int)y][(unsigned int)x] = value;
           }
         }
 
@@ -405,15 +414,55 @@ void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, un
         }
       }
     }
+
+    // The skipped scanlines are copies of the rendered one
+    for (unsigned int y_skip = y + 1; y_skip < (std::min)(y + scanLineStep, end); ++y_skip) {
+      std::copy(primitive_ids[y], primitive_ids[y] + w, primitive_ids[y_skip]);
+      std::copy(mask_Y[y], mask_Y[y] + w, mask_Y[y_skip]);
+    }
+  }
+}
+
+/*!
+  Render the X-axis scanlines of a tile: compute the intersections with the
+  polygons, fill the X-axis mask and collect the visibility samples of the
+  edges that are sampled along the X-axis.
+
+  \param begin, end : Scanlines of the tile.
+  \param local : Local scanlines of the tile.
+  \param samples : Visibility samples of the tile, as (samples index,
+  scanline) pairs.
+*/
+void vpMbScanLine::renderTileX(unsigned int begin, unsigned int end,
+                               std::vector<std::vector<vpMbScanLineSegment> > &local,
+                               std::vector<std::pair<int, int> > &samples)
+{
+  samples.clear();
+  for (unsigned int x = begin; x < end; ++x) {
+    scanlinesX[x].clear();
+  }
+  local.resize(end - begin);
+
+  for (size_t i = 0; i + 1 < polygon_edges.size(); ++i) {
+    unsigned int first = end, last = begin;
+    if (polygon_edges[i + 1] - polygon_edges[i] == 1) {
+      drawLineX(polygon_edges[i], polygon_ids[i], scanlinesX, begin, end, 0, first, last);
+    } else {
+      for (size_t e = polygon_edges[i]; e < polygon_edges[i + 1]; ++e) {
+        drawLineX(e, polygon_ids[i], local, begin, end, begin, first, last);
+      }
+      createScanLinesFromLocals(scanlinesX, local, first, last, begin);
+    }
   }
 
-  // X
-  last_ID = -1;
-  for (unsigned int x = 0; x < scanlinesX.size(); ++x) {
+  std::vector<std::pair<double, vpMbScanLineSegment> > stack;
+  for (unsigned int x = begin; x < end; x += scanLineStep) {
     std::vector<vpMbScanLineSegment> &scanline = scanlinesX[x];
     sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
 
-    std::vector<std::pair<double, vpMbScanLineSegment> > stack;
+    int last_ID = -1;
+    vpMbScanLineSegment last_visible;
+    stack.clear();
     for (size_t i = 0; i < scanline.size(); ++i) {
       const vpMbScanLineSegment &s = scanline[i];
 
@@ -447,21 +496,21 @@ void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, un
           switch (s.type) {
           case POINT:
             if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
-              visibility_samples[s.edge].insert((int)x);
+              samples.push_back(std::make_pair(s.edge, (int)x));
             break;
           case START:
             if (new_ID == s.ID)
-              visibility_samples[s.edge].insert((int)x);
+              samples.push_back(std::make_pair(s.edge, (int)x));
             break;
           case END:
             if (last_ID == s.ID)
-              visibility_samples[s.edge].insert((int)x);
+              samples.push_back(std::make_pair(s.edge, (int)x));
             break;
           }
 
         // This part will only be used for MbKltTracking
-        if (maskBorder != 0 && last_ID != -1) {
-          const unsigned int y0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
+        if (maskBorder != 0 && last_ID != -1 && last_visible.ID >= 0) {
+          const unsigned int y0 = (unsigned int)(std::max)(0.0, std::ceil(last_visible.p));
           double y1 = (std::min)((double)h, (double)s.p);
           for (unsigned int y = y0 + maskBorder; y < y1 - maskBorder; ++y) {
             // primitive_ids[(unsigned int)y][(unsigned int)x] =
@@ -477,6 +526,164 @@ void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, un
         }
       }
     }
+
+    // The skipped scanlines are copies of the rendered one
+    if (maskBorder != 0) {
+      for (unsigned int x_skip = x + 1; x_skip < (std::min)(x + scanLineStep, end); ++x_skip) {
+        for (unsigned int y = 0; y < h; ++y) {
+          maskX[y][x_skip] = maskX[y][x];
+        }
+      }
+    }
+  }
+}
+
+/*!
+  Check that the polygons of the edge table moved less than the incremental
+  threshold since the reference rendering.
+
+  \return True if the polygons and their edges are the same as in the
+  reference rendering and if no extremity moved by more than the incremental
+  threshold in the image.
+*/
+bool vpMbScanLine::isCloseToReference() const
+{
+  if (polygon_ids != ref_polygon_ids || polygon_edges != ref_polygon_edges) {
+    return false;
+  }
+
+  for (size_t e = 0; e < edge_x0.size(); ++e) {
+    if (std::fabs(edge_x0[e] - ref_x0[e]) > incrementalThreshold ||
+        std::fabs(edge_y0[e] - ref_y0[e]) > incrementalThreshold ||
+        std::fabs(edge_x1[e] - ref_x1[e]) > incrementalThreshold ||
+        std::fabs(edge_y1[e] - ref_y1[e]) > incrementalThreshold) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*!
+  Render a scene of polygons and compute scanlines intersections in order to
+  use queries.
+
+  The image is split in tiles of getTileSize() Y-axis scanlines and of
+  getTileSize() X-axis scanlines. Each tile only writes its own scanlines,
+  the tiles can be rendered concurrently, see setUseParallel(), with the same
+  result as a sequential rendering.
+
+  \param polygons : List of polygons composed by arrays of lines.
+  \param listPolyIndices : List of polygons IDs (has to be know when using
+  queries). \param cam : Camera parameters. \param width : Width of the image
+  (render window). \param height : Height of the image (render window).
+
+  \sa setScanLineStep(), setIncrementalThreshold()
+*/
+void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > *> &polygons,
+                             std::vector<int> listPolyIndices, const vpCameraParameters &cam, unsigned int width,
+                             unsigned int height)
+{
+  buildEdgeTable(polygons, listPolyIndices, cam);
+
+  sceneReused = incrementalThreshold > 0 && referenceValid && width == w && height == h &&
+                cam.get_px() == K.get_px() && cam.get_py() == K.get_py() && cam.get_u0() == K.get_u0() &&
+                cam.get_v0() == K.get_v0() && isCloseToReference();
+  if (sceneReused) {
+    // Keep the reference rendering, only the keys of the edges are updated for the queries
+    edge_samples = ref_edge_samples;
+    edge_indices.clear();
+    for (size_t e = 0; e < edge_keys.size(); ++e) {
+      edge_indices.insert(std::make_pair(edge_keys[e], edge_samples[e]));
+    }
+    return;
+  }
+
+  this->w = width;
+  this->h = height;
+  this->K = cam;
+
+  // Edges shared by several polygons have the same visibility samples
+  edge_indices.clear();
+  edge_samples.resize(edge_keys.size());
+  for (size_t e = 0; e < edge_keys.size(); ++e) {
+    edge_samples[e] = edge_indices.insert(std::make_pair(edge_keys[e], (int)edge_indices.size())).first->second;
+  }
+  visibility_samples.resize(edge_indices.size());
+  for (size_t i = 0; i < visibility_samples.size(); ++i) {
+    visibility_samples[i].clear();
+  }
+  visibility_samples_Y.assign(edge_indices.size(), 0);
+
+  scanlinesY.resize(h);
+  scanlinesX.resize(w);
+
+  mask.resize(h, w, 0);
+  primitive_ids.resize(h, w, -1);
+  if (maskBorder != 0) {
+    maskY.resize(h, w, 0);
+    maskX.resize(h, w, 0);
+  }
+
+  // Tiles aligned on the rendered scanlines
+  const unsigned int tile = ((std::max)(tileSize, scanLineStep) + scanLineStep - 1) / scanLineStep * scanLineStep;
+  const unsigned int nb_tiles_Y = (h + tile - 1) / tile;
+  const unsigned int nb_tiles = nb_tiles_Y + (w + tile - 1) / tile;
+  tile_local_scanlines.resize(nb_tiles);
+  tile_samples.resize(nb_tiles);
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (useParallel && nb_tiles > 1) {
+    // Exceptions cannot leave an OpenMP region, keep them by tile to rethrow the one a sequential run would have
+    // raised
+    std::vector<std::exception_ptr> exceptions(nb_tiles);
+    int nb_threads = nbThreads > 0 ? static_cast<int>(nbThreads) : omp_get_max_threads();
+    int nb_tasks = static_cast<int>(nb_tiles);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nb_threads)
+    for (int k = 0; k < nb_tasks; k++) {
+      try {
+        const unsigned int t = static_cast<unsigned int>(k);
+        if (t < nb_tiles_Y) {
+          renderTileY(t * tile, (std::min)(h, (t + 1) * tile), tile_local_scanlines[t], tile_samples[t]);
+        } else {
+          renderTileX((t - nb_tiles_Y) * tile, (std::min)(w, (t - nb_tiles_Y + 1) * tile), tile_local_scanlines[t],
+                      tile_samples[t]);
+        }
+      } catch (...) {
+        exceptions[static_cast<size_t>(k)] = std::current_exception();
+      }
+    }
+
+    for (size_t k = 0; k < exceptions.size(); k++) {
+      if (exceptions[k]) {
+        std::rethrow_exception(exceptions[k]);
+      }
+    }
+  } else
+#endif
+  {
+    for (unsigned int t = 0; t < nb_tiles; t++) {
+      if (t < nb_tiles_Y) {
+        renderTileY(t * tile, (std::min)(h, (t + 1) * tile), tile_local_scanlines[t], tile_samples[t]);
+      } else {
+        renderTileX((t - nb_tiles_Y) * tile, (std::min)(w, (t - nb_tiles_Y + 1) * tile), tile_local_scanlines[t],
+                    tile_samples[t]);
+      }
+    }
+  }
+
+  // Gather the visibility samples of the tiles
+  for (unsigned int t = 0; t < nb_tiles; t++) {
+    const std::vector<std::pair<int, int> > &samples = tile_samples[t];
+    for (size_t i = 0; i < samples.size(); ++i) {
+      visibility_samples[(size_t)samples[i].first].push_back(samples[i].second);
+      visibility_samples_Y[(size_t)samples[i].first] = (t < nb_tiles_Y) ? 1 : 0;
+    }
+  }
+  for (size_t i = 0; i < visibility_samples.size(); ++i) {
+    std::vector<int> &samples = visibility_samples[i];
+    std::sort(samples.begin(), samples.end());
+    samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
   }
 
   if (maskBorder != 0)
@@ -485,6 +692,18 @@ void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, un
         if (maskX[i][j] == 255 && maskY[i][j] == 255)
           mask[i][j] = 255;
 
+  // Reference of the incremental mode
+  referenceValid = incrementalThreshold > 0;
+  if (referenceValid) {
+    ref_x0 = edge_x0;
+    ref_y0 = edge_y0;
+    ref_x1 = edge_x1;
+    ref_y1 = edge_y1;
+    ref_edge_samples = edge_samples;
+    ref_polygon_edges = polygon_edges;
+    ref_polygon_ids = polygon_ids;
+  }
+
 #if (defined(VISP_HAVE_X11) || defined(VISP_HAVE_GDI)) && defined(DEBUG_DISP)
   if (!dispMaskDebug->isInitialised()) {
     dispMaskDebug->init(mask, 800, 600);
@@ -516,6 +735,88 @@ void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, un
 #endif
 }
 
+/*!
+  Enable the incremental mode: drawScene() reuses the previous rendering as
+  long as the polygons are the same and none of their projected vertices
+  moved by more than \e threshold pixels since the last actual rendering.
+  The visibility queries then return the visible parts of the previous
+  rendering, which is an approximation that saves the whole rendering when
+  the object barely moves, for instance between two iterations of the pose
+  estimation.
+
+  \param threshold : Maximal displacement in pixels, 0 (the default) to
+  render every scene.
+
+  \sa isSceneReused()
+*/
+void vpMbScanLine::setIncrementalThreshold(double threshold)
+{
+  incrementalThreshold = (std::max)(0.0, threshold);
+  if (incrementalThreshold <= 0) {
+    referenceValid = false;
+    sceneReused = false;
+  }
+}
+
+/*!
+  Render only one Y-axis and one X-axis scanline every \e step pixels. The
+  skipped scanlines of the mask and of the primitive ids are copies of the
+  previous rendered one, and the visibility queries consider two samples
+  \e step pixels apart as consecutive. This divides the rendering time by
+  about \e step at the price of a coarser visibility, edges shorter than
+  \e step pixels may be missed.
+
+  \param step : Spacing between two rendered scanlines, 1 (the default) to
+  render all the scanlines.
+*/
+void vpMbScanLine::setScanLineStep(unsigned int step)
+{
+  if (step == 0) {
+    throw vpException(vpException::badValue, "The scanline step must be positive");
+  }
+  referenceValid = referenceValid && (step == scanLineStep);
+  scanLineStep = step;
+}
+
+/*!
+  Set the number of scanlines of a tile, the unit of work of the rendering.
+  The tiles are rounded up to a multiple of the scanline step.
+
+  \param size : Number of scanlines of a tile, 32 by default.
+*/
+void vpMbScanLine::setTileSize(unsigned int size)
+{
+  if (size == 0) {
+    throw vpException(vpException::badValue, "The tile size must be positive");
+  }
+  tileSize = size;
+}
+
+/*!
+  Enable the concurrent rendering of the tiles. Each tile only writes its
+  own scanlines, the result is the same as the sequential rendering.
+
+  \param parallel : True to render the tiles concurrently.
+
+  \note This option requires OpenMP and C++11 support, otherwise the tiles
+  are rendered sequentially.
+
+  \sa setNbParallelThreads(), setTileSize()
+*/
+void vpMbScanLine::setUseParallel(bool parallel)
+{
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  useParallel = parallel;
+#else
+  if (parallel) {
+    std::cerr << "Parallel scanline rendering requires OpenMP and C++11 support, the tiles are rendered "
+                 "sequentially."
+              << std::endl;
+  }
+  useParallel = false;
+#endif
+}
+
 /*!
   Test the visibility of a line. As a result, a subsampled line of the given
   one with all its visible parts.
@@ -556,8 +857,10 @@ void vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
 #endif
   }
 
-  if (!visibility_samples.count(edge))
+  std::map<vpMbScanLineEdge, int, vpMbScanLineEdgeComparator>::const_iterator it_edge = edge_indices.find(edge);
+  if (it_edge == edge_indices.end())
     return;
+  const std::vector<int> &visible_samples = visibility_samples[(size_t)it_edge->second];
 
   // Initialized as the biggest difference between the two points is on the
   // X-axis
@@ -565,8 +868,11 @@ void vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
   double *v1(&x1), *w1(&z1);
   unsigned int size(w);
 
-  if (std::fabs(y0 - y1) > std::fabs(x0 - x1)) // Test if the biggest difference is on the Y-axis
-  {
+  // Test if the biggest difference is on the Y-axis. When the rendering of a previous frame is reused, the edge may
+  // have turned since, the samples are read along the axis they were taken
+  const bool b_sample_Y = sceneReused ? (visibility_samples_Y[(size_t)it_edge->second] != 0)
+                                      : (std::fabs(y0 - y1) > std::fabs(x0 - x1));
+  if (b_sample_Y) {
     v0 = &y0;
     v1 = &y1;
     size = h;
@@ -597,27 +903,28 @@ void vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
   const int _v0 = (std::max)(0, int(std::ceil(*v0)));
   const int _v1 = (std::min)((int)(size - 1), (int)(std::ceil(*v1) - 1));
 
-  const std::set<int> &visible_samples = visibility_samples[edge];
+  // Two consecutive samples are getScanLineStep() scanlines apart
+  const int step = (int)scanLineStep;
   int last = _v0;
   vpPoint line_start;
   vpPoint line_end;
   bool b_line_started = false;
-  for (std::set<int>::const_iterator it = visible_samples.begin(); it != visible_samples.end(); ++it) {
+  for (std::vector<int>::const_iterator it = visible_samples.begin(); it != visible_samples.end(); ++it) {
     const int v = *it;
     const double alpha = getAlpha(v, (*v0) * (*w0), (*w0), (*v1) * (*w1), (*w1));
     // const vpPoint p = mix(a, b, alpha);
     const vpPoint p = mix(a_, b_, alpha);
-    if (last + 1 != v) {
+    if (v - last > step) {
       if (b_line_started)
         lines.push_back(std::make_pair(line_start, line_end));
       b_line_started = false;
     }
-    if (v == _v0) {
+    if (v >= _v0 && v - _v0 < step) {
       // line_start = a;
       line_start = a_;
       line_end = p;
       b_line_started = true;
-    } else if (v == _v1) {
+    } else if (v <= _v1 && _v1 - v < step) {
       // line_end = b;
       line_end = b_;
       if (!b_line_started)
@@ -71,6 +71,7 @@
 #include <visp3/core/vpMatrixException.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/mbt/vpMbTracker.h>
+#include <visp3/mbt/vpMbtCadModel.h>
 
 #include <visp3/core/vpImageFilter.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
@@ -101,18 +102,6 @@
 
 namespace
 {
-/*!
-  Structure to store info about segment in CAO model files.
- */
-struct SegmentInfo {
-  SegmentInfo() : extremities(), name(), useLod(false), minLineLengthThresh(0.) {}
-
-  std::vector<vpPoint> extremities;
-  std::string name;
-  bool useLod;
-  double minLineLengthThresh;
-};
-
 /*!
   Structure to store info about a polygon face represented by a vpPolygon and
   by a list of vpPoint representing the corners of the polygon face in 3D.
@@ -1438,8 +1427,9 @@ void vpMbTracker::addPolygon(const std::vector<std::vector<vpPoint> > &listFaces
 
 /*!
   Load a 3D model from the file in parameter. This file must either be a vrml
-  file (.wrl) or a CAO file (.cao). CAO format is described in the
-  loadCAOModel() method.
+  file (.wrl), a CAO file (.cao) or a binary CAO file (.bcao). CAO format is
+  described in the loadCAOModel() method. Binary CAO files are written by
+  vpMbtCadModel::saveBinary(), they are loaded without any text parsing.
 
   \warning When this class is called to load a vrml model, remember that you
   have to call Call SoDD::finish() before ending the program.
@@ -1454,14 +1444,14 @@ int main()
   \endcode
 
   \throw vpException::ioError if the file cannot be open, or if its extension
-is not wrl or cao.
+is not wrl, cao or bcao.
 
   \param modelFile : the file containing the the 3D model description.
-  The extension of this file is either .wrl or .cao.
+  The extension of this file is either .wrl, .cao or .bcao.
   \param verbose : verbose option to print additional information when loading
 CAO model files which include other CAO model files.
-  \param odTo : optional transformation matrix (currently only for .cao) to transform
-  3D points expressed in the original object frame to the desired object frame.
+  \param odTo : optional transformation matrix (currently only for .cao and .bcao) to
+  transform 3D points expressed in the original object frame to the desired object frame.
 */
 void vpMbTracker::loadModel(const std::string &modelFile, bool verbose, const vpHomogeneousMatrix &odTo)
 {
@@ -1480,11 +1470,26 @@ void vpMbTracker::loadModel(const std::string &modelFile, bool verbose, const vp
       nbCylinders = 0;
       nbCircles = 0;
       loadCAOModel(modelFile, vectorOfModelFilename, startIdFace, verbose, true, odTo);
+    } else if (modelFile.size() > 5 &&
+               ((*(it - 1) == 'o' && *(it - 2) == 'a' && *(it - 3) == 'c' && *(it - 4) == 'b' && *(it - 5) == '.') ||
+                (*(it - 1) == 'O' && *(it - 2) == 'A' && *(it - 3) == 'C' && *(it - 4) == 'B' && *(it - 5) == '.'))) {
+      vpMbtCadModel model;
+      model.loadBinary(modelFile);
+
+      int startIdFace = (int)faces.size();
+      nbPoints = 0;
+      nbLines = 0;
+      nbPolygonLines = 0;
+      nbPolygonPoints = 0;
+      nbCylinders = 0;
+      nbCircles = 0;
+      initFromCadModel(model, startIdFace, odTo);
     } else if ((*(it - 1) == 'l' && *(it - 2) == 'r' && *(it - 3) == 'w' && *(it - 4) == '.') ||
                (*(it - 1) == 'L' && *(it - 2) == 'R' && *(it - 3) == 'W' && *(it - 4) == '.')) {
       loadVRMLModel(modelFile);
     } else {
-      throw vpException(vpException::ioError, "Error: File %s doesn't contain a cao or wrl model", modelFile.c_str());
+      throw vpException(vpException::ioError, "Error: File %s doesn't contain a cao, bcao or wrl model",
+                        modelFile.c_str());
     }
   } else {
     throw vpException(vpException::ioError, "Error: File %s doesn't exist", modelFile.c_str());
@@ -1690,599 +1695,130 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
                                int &startIdFace, bool verbose, bool parent,
                                const vpHomogeneousMatrix &odTo)
 {
-  std::ifstream fileId;
-  fileId.exceptions(std::ifstream::failbit | std::ifstream::eofbit);
-  fileId.open(modelFile.c_str(), std::ifstream::in);
-  if (fileId.fail()) {
-    std::cout << "cannot read CAO model file: " << modelFile << std::endl;
-    throw vpException(vpException::ioError, "cannot read CAO model file");
-  }
-
-  if (verbose) {
-    std::cout << "Model file : " << modelFile << std::endl;
-  }
-  vectorOfModelFilename.push_back(modelFile);
-
-  try {
-    char c;
-    // Extraction of the version (remove empty line and commented ones
-    // (comment line begin with the #)).
-    // while ((fileId.get(c) != NULL) && (c == '#')) fileId.ignore(256, '\n');
-    removeComment(fileId);
-
-    //////////////////////////Read CAO Version (V1, V2,...)//////////////////////////
-    int caoVersion;
-    fileId.get(c);
-    if (c == 'V') {
-      fileId >> caoVersion;
-      fileId.ignore(256, '\n'); // skip the rest of the line
-    } else {
-      std::cout << "in vpMbTracker::loadCAOModel() -> Bad parameter header "
-                   "file : use V0, V1, ...";
-      throw vpException(vpException::badValue, "in vpMbTracker::loadCAOModel() -> Bad parameter "
-                                               "header file : use V0, V1, ...");
-    }
-
-    removeComment(fileId);
-
-    //////////////////////////Read the header part if present//////////////////////////
-    std::string line;
-    const std::string prefix_load = "load";
-
-    fileId.get(c);
-    fileId.unget();
-    bool header = false;
-    while (c == 'l' || c == 'L') {
-      getline(fileId, line);
-
-      if (!line.compare(0, prefix_load.size(), prefix_load)) {
-        //remove "load("
-        std::string paramsStr = line.substr(5);
-        //get parameters inside load()
-        paramsStr = paramsStr.substr(0, paramsStr.find_first_of(")"));
-        //split by comma
-        std::vector<std::string> params = vpIoTools::splitChain(paramsStr, ",");
-        //remove whitespaces
-        for (size_t i = 0; i < params.size(); i++) {
-          params[i] = vpIoTools::trim(params[i]);
-        }
-
-        if (!params.empty()) {
-          // Get the loaded model pathname
-          std::string headerPathRead = params[0];
-          headerPathRead = headerPathRead.substr(1);
-          headerPathRead = headerPathRead.substr(0, headerPathRead.find_first_of("\""));
-
-          std::string headerPath = headerPathRead;
-          if (!vpIoTools::isAbsolutePathname(headerPathRead)) {
-            std::string parentDirectory = vpIoTools::getParent(modelFile);
-            headerPath = vpIoTools::createFilePath(parentDirectory, headerPathRead);
-          }
-
-          // Normalize path
-          headerPath = vpIoTools::path(headerPath);
-
-          // Get real path
-          headerPath = vpIoTools::getAbsolutePathname(headerPath);
-
-          vpHomogeneousMatrix oTo_local;
-          vpTranslationVector t;
-          vpThetaUVector tu;
-          for (size_t i = 1; i < params.size(); i++) {
-            std::string param = params[i];
-            {
-              const std::string prefix = "t=[";
-              if (!param.compare(0, prefix.size(), prefix)) {
-                param = param.substr(prefix.size());
-                param = param.substr(0, param.find_first_of("]"));
-
-                std::vector<std::string> values = vpIoTools::splitChain(param, ";");
-                if (values.size() == 3) {
-                  t[0] = atof(values[0].c_str());
-                  t[1] = atof(values[1].c_str());
-                  t[2] = atof(values[2].c_str());
-                }
-              }
-            }
-            {
-              const std::string prefix = "tu=[";
-              if (!param.compare(0, prefix.size(), prefix)) {
-                param = param.substr(prefix.size());
-                param = param.substr(0, param.find_first_of("]"));
-
-                std::vector<std::string> values = vpIoTools::splitChain(param, ";");
-                if (values.size() == 3) {
-                  for (size_t j = 0; j < values.size(); j++) {
-                    std::string value = values[j];
-                    bool radian = true;
-                    size_t unitPos = value.find("deg");
-                    if (unitPos != std::string::npos) {
-                      value = value.substr(0, unitPos);
-                      radian = false;
-                    }
-
-                    unitPos = value.find("rad");
-                    if (unitPos != std::string::npos) {
-                      value = value.substr(0, unitPos);
-                    }
-                    tu[static_cast<unsigned int>(j)] = !radian ? vpMath::rad(atof(value.c_str())) : atof(value.c_str());
-                  }
-                }
-              }
-            }
-          }
-          oTo_local.buildFrom(t, tu);
-
-          bool cyclic = false;
-          for (std::vector<std::string>::const_iterator it = vectorOfModelFilename.begin();
-               it != vectorOfModelFilename.end() && !cyclic; ++it) {
-            if (headerPath == *it) {
-              cyclic = true;
-            }
-          }
-
-          if (!cyclic) {
-            if (vpIoTools::checkFilename(headerPath)) {
-              header = true;
-              loadCAOModel(headerPath, vectorOfModelFilename, startIdFace, verbose, false, odTo*oTo_local);
-            } else {
-              throw vpException(vpException::ioError, "file cannot be open");
-            }
-          } else {
-            std::cout << "WARNING Cyclic dependency detected with file " << headerPath << " declared in " << modelFile
-                      << std::endl;
-          }
-        }
-      }
-
-      removeComment(fileId);
-      fileId.get(c);
-      fileId.unget();
-    }
-
-    //////////////////////////Read the point declaration part//////////////////////////
-    unsigned int caoNbrPoint;
-    fileId >> caoNbrPoint;
-    fileId.ignore(256, '\n'); // skip the rest of the line
-
-    nbPoints += caoNbrPoint;
-    if (verbose || (parent && !header)) {
-      std::cout << "> " << caoNbrPoint << " points" << std::endl;
-    }
-
-    if (caoNbrPoint > 100000) {
-      throw vpException(vpException::badValue, "Exceed the max number of points in the CAO model.");
-    }
-
-    if (caoNbrPoint == 0 && !header) {
-      throw vpException(vpException::badValue, "in vpMbTracker::loadCAOModel() -> no points are defined");
-    }
-    vpPoint *caoPoints = new vpPoint[caoNbrPoint];
-
-    int i; // image coordinate (used for matching)
-    int j;
-
-    for (unsigned int k = 0; k < caoNbrPoint; k++) {
-      removeComment(fileId);
-
-      vpColVector pt_3d(4, 1.0);
-      fileId >> pt_3d[0];
-      fileId >> pt_3d[1];
-      fileId >> pt_3d[2];
-
-      if (caoVersion == 2) {
-        fileId >> i;
-        fileId >> j;
-      }
-
-      fileId.ignore(256, '\n'); // skip the rest of the line
-
-      vpColVector pt_3d_tf = odTo*pt_3d;
-      caoPoints[k].setWorldCoordinates(pt_3d_tf[0], pt_3d_tf[1], pt_3d_tf[2]);
-    }
-
-    removeComment(fileId);
-
-    //////////////////////////Read the segment declaration part//////////////////////////
-    // Store in a map the potential segments to add
-    std::map<std::pair<unsigned int, unsigned int>, SegmentInfo> segmentTemporaryMap;
-    unsigned int caoNbrLine;
-    fileId >> caoNbrLine;
-    fileId.ignore(256, '\n'); // skip the rest of the line
-
-    nbLines += caoNbrLine;
-    unsigned int *caoLinePoints = NULL;
-    if (verbose || (parent && !header)) {
-      std::cout << "> " << caoNbrLine << " lines" << std::endl;
-    }
-
-    if (caoNbrLine > 100000) {
-      delete[] caoPoints;
-      throw vpException(vpException::badValue, "Exceed the max number of lines in the CAO model.");
-    }
-
-    if (caoNbrLine > 0)
-      caoLinePoints = new unsigned int[2 * caoNbrLine];
-
-    unsigned int index1, index2;
-    // Initialization of idFace with startIdFace for dealing with recursive
-    // load in header
-    int idFace = startIdFace;
-
-    for (unsigned int k = 0; k < caoNbrLine; k++) {
-      removeComment(fileId);
-
-      fileId >> index1;
-      fileId >> index2;
-
-      //////////////////////////Read the parameter value if present//////////////////////////
-      // Get the end of the line
-      char buffer[256];
-      fileId.getline(buffer, 256);
-      std::string endLine(buffer);
-      std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
-
-      std::string segmentName = "";
-      double minLineLengthThresh = !applyLodSettingInConfig ? minLineLengthThresholdGeneral : 50.0;
-      bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
-      if (mapOfParams.find("name") != mapOfParams.end()) {
-        segmentName = mapOfParams["name"];
-      }
-      if (mapOfParams.find("minLineLengthThreshold") != mapOfParams.end()) {
-        minLineLengthThresh = std::atof(mapOfParams["minLineLengthThreshold"].c_str());
-      }
-      if (mapOfParams.find("useLod") != mapOfParams.end()) {
-        useLod = vpIoTools::parseBoolean(mapOfParams["useLod"]);
-      }
-
-      SegmentInfo segmentInfo;
-      segmentInfo.name = segmentName;
-      segmentInfo.useLod = useLod;
-      segmentInfo.minLineLengthThresh = minLineLengthThresh;
-
-      caoLinePoints[2 * k] = index1;
-      caoLinePoints[2 * k + 1] = index2;
-
-      if (index1 < caoNbrPoint && index2 < caoNbrPoint) {
-        std::vector<vpPoint> extremities;
-        extremities.push_back(caoPoints[index1]);
-        extremities.push_back(caoPoints[index2]);
-        segmentInfo.extremities = extremities;
-
-        std::pair<unsigned int, unsigned int> key(index1, index2);
+  vpMbtCadModel model;
+  model.appendCAO(modelFile, vectorOfModelFilename, verbose, parent);
+  initFromCadModel(model, startIdFace, odTo);
+}
 
-        segmentTemporaryMap[key] = segmentInfo;
+/*!
+  Create the faces, lines, cylinders and circles of a CAD model that was read
+  from a cao or a binary file.
+
+  The level of detail settings that are not given in the model are taken from
+  the tracker, see setLod(), setMinLineLengthThresh() and
+  setMinPolygonAreaThresh().
+
+  \param model : The CAD model.
+  \param startIdFace : Id of the first face created, updated with the id
+  following the last face created.
+  \param odTo : optional transformation matrix to transform 3D points
+  expressed in the original object frame to the desired object frame.
+*/
+void vpMbTracker::initFromCadModel(const vpMbtCadModel &model, int &startIdFace, const vpHomogeneousMatrix &odTo)
+{
+  nbPoints += model.getNbPoints();
+  nbLines += model.getNbLines();
+  nbPolygonLines += model.getNbPolygonLines();
+  nbPolygonPoints += model.getNbPolygonPoints();
+  nbCylinders += model.getNbCylinders();
+  nbCircles += model.getNbCircles();
+
+  const std::vector<double> &coordinates = model.getPoints();
+  std::vector<vpPoint> points(model.getNbPoints());
+  for (size_t k = 0; k < points.size(); k++) {
+    vpColVector pt_3d(4, 1.0);
+    pt_3d[0] = coordinates[3 * k];
+    pt_3d[1] = coordinates[3 * k + 1];
+    pt_3d[2] = coordinates[3 * k + 2];
+
+    vpColVector pt_3d_tf = odTo * pt_3d;
+    points[k].setWorldCoordinates(pt_3d_tf[0], pt_3d_tf[1], pt_3d_tf[2]);
+  }
+
+  const std::vector<unsigned int> &indexes = model.getPointIndexes();
+  const bool defaultUseLod = !applyLodSettingInConfig ? useLodGeneral : false;
+  const double defaultMinLineLengthThreshold = !applyLodSettingInConfig ? minLineLengthThresholdGeneral : 50.0;
+  const double defaultMinPolygonAreaThreshold = !applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0;
+
+  int idFace = startIdFace;
+  for (unsigned int k = 0; k < model.getNbPrimitives(); k++) {
+    const vpMbtCadModel::vpPrimitive &primitive = model.getPrimitive(k);
+    const bool useLod = primitive.hasLod ? primitive.useLod : defaultUseLod;
+    const unsigned int *index = indexes.empty() ? NULL : &indexes[primitive.first];
+
+    std::vector<vpPoint> corners(primitive.nbPoints);
+    for (unsigned int n = 0; n < primitive.nbPoints; n++) {
+      corners[n] = points[index[n]];
+    }
+
+    switch (primitive.type) {
+    case vpMbtCadModel::POLYGON_FROM_LINES:
+    case vpMbtCadModel::POLYGON_FROM_POINTS: {
+      const double minPolygonAreaThreshold =
+          primitive.hasThreshold ? primitive.threshold : defaultMinPolygonAreaThreshold;
+      addPolygon(corners, idFace, primitive.name, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
+      addProjectionErrorPolygon(corners, idFace++, primitive.name, useLod, minPolygonAreaThreshold,
+                                minLineLengthThresholdGeneral);
+
+      // Init from the last polygons that were added
+      if (primitive.type == vpMbtCadModel::POLYGON_FROM_LINES) {
+        initFaceFromLines(*(faces.getPolygon().back()));
+        initProjectionErrorFaceFromLines(*(m_projectionErrorFaces.getPolygon().back()));
       } else {
-        vpTRACE(" line %d has wrong coordinates.", k);
-      }
-    }
-
-    removeComment(fileId);
-
-    //////////////////////////Read the face segment declaration part//////////////////////////
-    /* Load polygon from the lines extracted earlier (the first point of the
-     * line is used)*/
-    // Store in a vector the indexes of the segments added in the face segment
-    // case
-    std::vector<std::pair<unsigned int, unsigned int> > faceSegmentKeyVector;
-    unsigned int caoNbrPolygonLine;
-    fileId >> caoNbrPolygonLine;
-    fileId.ignore(256, '\n'); // skip the rest of the line
-
-    nbPolygonLines += caoNbrPolygonLine;
-    if (verbose || (parent && !header)) {
-      std::cout << "> " << caoNbrPolygonLine << " polygon lines" << std::endl;
-    }
-
-    if (caoNbrPolygonLine > 100000) {
-      delete[] caoPoints;
-      delete[] caoLinePoints;
-      throw vpException(vpException::badValue, "Exceed the max number of polygon lines.");
-    }
-
-    unsigned int index;
-    for (unsigned int k = 0; k < caoNbrPolygonLine; k++) {
-      removeComment(fileId);
-
-      unsigned int nbLinePol;
-      fileId >> nbLinePol;
-      std::vector<vpPoint> corners;
-      if (nbLinePol > 100000) {
-        throw vpException(vpException::badValue, "Exceed the max number of lines.");
-      }
-
-      for (unsigned int n = 0; n < nbLinePol; n++) {
-        fileId >> index;
-
-        if (index >= caoNbrLine) {
-          throw vpException(vpException::badValue, "Exceed the max number of lines.");
-        }
-        corners.push_back(caoPoints[caoLinePoints[2 * index]]);
-        corners.push_back(caoPoints[caoLinePoints[2 * index + 1]]);
-
-        std::pair<unsigned int, unsigned int> key(caoLinePoints[2 * index], caoLinePoints[2 * index + 1]);
-        faceSegmentKeyVector.push_back(key);
-      }
-
-      //////////////////////////Read the parameter value if present//////////////////////////
-      // Get the end of the line
-      char buffer[256];
-      fileId.getline(buffer, 256);
-      std::string endLine(buffer);
-      std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
-
-      std::string polygonName = "";
-      bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
-      double minPolygonAreaThreshold = !applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0;
-      if (mapOfParams.find("name") != mapOfParams.end()) {
-        polygonName = mapOfParams["name"];
-      }
-      if (mapOfParams.find("minPolygonAreaThreshold") != mapOfParams.end()) {
-        minPolygonAreaThreshold = std::atof(mapOfParams["minPolygonAreaThreshold"].c_str());
-      }
-      if (mapOfParams.find("useLod") != mapOfParams.end()) {
-        useLod = vpIoTools::parseBoolean(mapOfParams["useLod"]);
-      }
-
-      addPolygon(corners, idFace, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
-      initFaceFromLines(*(faces.getPolygon().back())); // Init from the last polygon that was added
-
-      addProjectionErrorPolygon(corners, idFace++, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
-      initProjectionErrorFaceFromLines(*(m_projectionErrorFaces.getPolygon().back()));
-    }
-
-    // Add the segments which were not already added in the face segment case
-    for (std::map<std::pair<unsigned int, unsigned int>, SegmentInfo>::const_iterator it = segmentTemporaryMap.begin();
-         it != segmentTemporaryMap.end(); ++it) {
-      if (std::find(faceSegmentKeyVector.begin(), faceSegmentKeyVector.end(), it->first) ==
-          faceSegmentKeyVector.end()) {
-        addPolygon(it->second.extremities, idFace, it->second.name, it->second.useLod, minPolygonAreaThresholdGeneral,
-                   it->second.minLineLengthThresh);
-        initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
-
-        addProjectionErrorPolygon(it->second.extremities, idFace++, it->second.name, it->second.useLod, minPolygonAreaThresholdGeneral,
-                                  it->second.minLineLengthThresh);
+        initFaceFromCorners(*(faces.getPolygon().back()));
         initProjectionErrorFaceFromCorners(*(m_projectionErrorFaces.getPolygon().back()));
       }
+      break;
     }
 
-    removeComment(fileId);
-
-    //////////////////////////Read the face point declaration part//////////////////////////
-    /* Extract the polygon using the point coordinates (top of the file) */
-    unsigned int caoNbrPolygonPoint;
-    fileId >> caoNbrPolygonPoint;
-    fileId.ignore(256, '\n'); // skip the rest of the line
-
-    nbPolygonPoints += caoNbrPolygonPoint;
-    if (verbose || (parent && !header)) {
-      std::cout << "> " << caoNbrPolygonPoint << " polygon points" << std::endl;
-    }
-
-    if (caoNbrPolygonPoint > 100000) {
-      throw vpException(vpException::badValue, "Exceed the max number of polygon point.");
-    }
-
-    for (unsigned int k = 0; k < caoNbrPolygonPoint; k++) {
-      removeComment(fileId);
-
-      unsigned int nbPointPol;
-      fileId >> nbPointPol;
-      if (nbPointPol > 100000) {
-        throw vpException(vpException::badValue, "Exceed the max number of points.");
-      }
-      std::vector<vpPoint> corners;
-      for (unsigned int n = 0; n < nbPointPol; n++) {
-        fileId >> index;
-        if (index > caoNbrPoint - 1) {
-          throw vpException(vpException::badValue, "Exceed the max number of points.");
-        }
-        corners.push_back(caoPoints[index]);
-      }
-
-      //////////////////////////Read the parameter value if present//////////////////////////
-      // Get the end of the line
-      char buffer[256];
-      fileId.getline(buffer, 256);
-      std::string endLine(buffer);
-      std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
-
-      std::string polygonName = "";
-      bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
-      double minPolygonAreaThreshold = !applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0;
-      if (mapOfParams.find("name") != mapOfParams.end()) {
-        polygonName = mapOfParams["name"];
-      }
-      if (mapOfParams.find("minPolygonAreaThreshold") != mapOfParams.end()) {
-        minPolygonAreaThreshold = std::atof(mapOfParams["minPolygonAreaThreshold"].c_str());
-      }
-      if (mapOfParams.find("useLod") != mapOfParams.end()) {
-        useLod = vpIoTools::parseBoolean(mapOfParams["useLod"]);
-      }
-
-      addPolygon(corners, idFace, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
+    case vpMbtCadModel::LINE: {
+      const double minLineLengthThreshold = primitive.hasThreshold ? primitive.threshold : defaultMinLineLengthThreshold;
+      addPolygon(corners, idFace, primitive.name, useLod, minPolygonAreaThresholdGeneral, minLineLengthThreshold);
       initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
 
-      addProjectionErrorPolygon(corners, idFace++, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
+      addProjectionErrorPolygon(corners, idFace++, primitive.name, useLod, minPolygonAreaThresholdGeneral,
+                                minLineLengthThreshold);
       initProjectionErrorFaceFromCorners(*(m_projectionErrorFaces.getPolygon().back()));
+      break;
     }
 
-    //////////////////////////Read the cylinder declaration part//////////////////////////
-    unsigned int caoNbCylinder;
-    try {
-      removeComment(fileId);
-
-      if (fileId.eof()) { // check if not at the end of the file (for old
-                          // style files)
-        delete[] caoPoints;
-        delete[] caoLinePoints;
-        return;
-      }
-
-      /* Extract the cylinders */
-      fileId >> caoNbCylinder;
-      fileId.ignore(256, '\n'); // skip the rest of the line
-
-      nbCylinders += caoNbCylinder;
-      if (verbose || (parent && !header)) {
-        std::cout << "> " << caoNbCylinder << " cylinders" << std::endl;
-      }
-
-      if (caoNbCylinder > 100000) {
-        throw vpException(vpException::badValue, "Exceed the max number of cylinders.");
-      }
+    case vpMbtCadModel::CYLINDER: {
+      const double minLineLengthThreshold = primitive.hasThreshold ? primitive.threshold : defaultMinLineLengthThreshold;
+      int idRevolutionAxis = idFace;
+      addPolygon(corners[0], corners[1], idFace, primitive.name, useLod, minLineLengthThreshold);
 
-      for (unsigned int k = 0; k < caoNbCylinder; ++k) {
-        removeComment(fileId);
-
-        double radius;
-        unsigned int indexP1, indexP2;
-        fileId >> indexP1;
-        fileId >> indexP2;
-        fileId >> radius;
-
-        //////////////////////////Read the parameter value if present//////////////////////////
-        // Get the end of the line
-        char buffer[256];
-        fileId.getline(buffer, 256);
-        std::string endLine(buffer);
-        std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
-
-        std::string polygonName = "";
-        bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
-        double minLineLengthThreshold = !applyLodSettingInConfig ? minLineLengthThresholdGeneral : 50.0;
-        if (mapOfParams.find("name") != mapOfParams.end()) {
-          polygonName = mapOfParams["name"];
-        }
-        if (mapOfParams.find("minLineLengthThreshold") != mapOfParams.end()) {
-          minLineLengthThreshold = std::atof(mapOfParams["minLineLengthThreshold"].c_str());
-        }
-        if (mapOfParams.find("useLod") != mapOfParams.end()) {
-          useLod = vpIoTools::parseBoolean(mapOfParams["useLod"]);
-        }
+      addProjectionErrorPolygon(corners[0], corners[1], idFace++, primitive.name, useLod, minLineLengthThreshold);
 
-        int idRevolutionAxis = idFace;
-        addPolygon(caoPoints[indexP1], caoPoints[indexP2], idFace, polygonName, useLod, minLineLengthThreshold);
+      std::vector<std::vector<vpPoint> > listFaces;
+      createCylinderBBox(corners[0], corners[1], primitive.radius, listFaces);
+      addPolygon(listFaces, idFace, primitive.name, useLod, minLineLengthThreshold);
 
-        addProjectionErrorPolygon(caoPoints[indexP1], caoPoints[indexP2], idFace++, polygonName, useLod, minLineLengthThreshold);
+      initCylinder(corners[0], corners[1], primitive.radius, idRevolutionAxis, primitive.name);
 
-        std::vector<std::vector<vpPoint> > listFaces;
-        createCylinderBBox(caoPoints[indexP1], caoPoints[indexP2], radius, listFaces);
-        addPolygon(listFaces, idFace, polygonName, useLod, minLineLengthThreshold);
+      addProjectionErrorPolygon(listFaces, idFace, primitive.name, useLod, minLineLengthThreshold);
+      initProjectionErrorCylinder(corners[0], corners[1], primitive.radius, idRevolutionAxis, primitive.name);
 
-        initCylinder(caoPoints[indexP1], caoPoints[indexP2], radius, idRevolutionAxis, polygonName);
-
-        addProjectionErrorPolygon(listFaces, idFace, polygonName, useLod, minLineLengthThreshold);
-        initProjectionErrorCylinder(caoPoints[indexP1], caoPoints[indexP2], radius, idRevolutionAxis, polygonName);
-
-        idFace += 4;
-      }
-
-    } catch (...) {
-      std::cerr << "Cannot get the number of cylinders. Defaulting to zero." << std::endl;
-      caoNbCylinder = 0;
+      idFace += 4;
+      break;
     }
 
-    //////////////////////////Read the circle declaration part//////////////////////////
-    unsigned int caoNbCircle;
-    try {
-      removeComment(fileId);
-
-      if (fileId.eof()) { // check if not at the end of the file (for old
-                          // style files)
-        delete[] caoPoints;
-        delete[] caoLinePoints;
-        return;
-      }
-
-      /* Extract the circles */
-      fileId >> caoNbCircle;
-      fileId.ignore(256, '\n'); // skip the rest of the line
-
-      nbCircles += caoNbCircle;
-      if (verbose || (parent && !header)) {
-        std::cout << "> " << caoNbCircle << " circles" << std::endl;
-      }
-
-      if (caoNbCircle > 100000) {
-        throw vpException(vpException::badValue, "Exceed the max number of cicles.");
-      }
-
-      for (unsigned int k = 0; k < caoNbCircle; ++k) {
-        removeComment(fileId);
-
-        double radius;
-        unsigned int indexP1, indexP2, indexP3;
-        fileId >> radius;
-        fileId >> indexP1;
-        fileId >> indexP2;
-        fileId >> indexP3;
-
-        //////////////////////////Read the parameter value if present//////////////////////////
-        // Get the end of the line
-        char buffer[256];
-        fileId.getline(buffer, 256);
-        std::string endLine(buffer);
-        std::map<std::string, std::string> mapOfParams = parseParameters(endLine);
-
-        std::string polygonName = "";
-        bool useLod = !applyLodSettingInConfig ? useLodGeneral : false;
-        double minPolygonAreaThreshold = !applyLodSettingInConfig ? minPolygonAreaThresholdGeneral : 2500.0;
-        if (mapOfParams.find("name") != mapOfParams.end()) {
-          polygonName = mapOfParams["name"];
-        }
-        if (mapOfParams.find("minPolygonAreaThreshold") != mapOfParams.end()) {
-          minPolygonAreaThreshold = std::atof(mapOfParams["minPolygonAreaThreshold"].c_str());
-        }
-        if (mapOfParams.find("useLod") != mapOfParams.end()) {
-          useLod = vpIoTools::parseBoolean(mapOfParams["useLod"]);
-        }
+    case vpMbtCadModel::CIRCLE: {
+      const double minPolygonAreaThreshold =
+          primitive.hasThreshold ? primitive.threshold : defaultMinPolygonAreaThreshold;
+      addPolygon(corners[0], corners[1], corners[2], primitive.radius, idFace, primitive.name, useLod,
+                 minPolygonAreaThreshold);
 
-        addPolygon(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace, polygonName, useLod,
-                   minPolygonAreaThreshold);
-
-        initCircle(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace, polygonName);
-
-        addProjectionErrorPolygon(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace, polygonName, useLod,
-                                  minPolygonAreaThreshold);
-        initProjectionErrorCircle(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace++, polygonName);
-      }
+      initCircle(corners[0], corners[1], corners[2], primitive.radius, idFace, primitive.name);
 
-    } catch (...) {
-      std::cerr << "Cannot get the number of circles. Defaulting to zero." << std::endl;
-      caoNbCircle = 0;
+      addProjectionErrorPolygon(corners[0], corners[1], corners[2], primitive.radius, idFace, primitive.name, useLod,
+                                minPolygonAreaThreshold);
+      initProjectionErrorCircle(corners[0], corners[1], corners[2], primitive.radius, idFace++, primitive.name);
+      break;
     }
-
-    startIdFace = idFace;
-
-    delete[] caoPoints;
-    delete[] caoLinePoints;
-
-    if (header && parent) {
-      if (verbose) {
-        std::cout << "Global information for " << vpIoTools::getName(modelFile) << " :" << std::endl;
-        std::cout << "Total nb of points : " << nbPoints << std::endl;
-        std::cout << "Total nb of lines : " << nbLines << std::endl;
-        std::cout << "Total nb of polygon lines : " << nbPolygonLines << std::endl;
-        std::cout << "Total nb of polygon points : " << nbPolygonPoints << std::endl;
-        std::cout << "Total nb of cylinders : " << nbCylinders << std::endl;
-        std::cout << "Total nb of circles : " << nbCircles << std::endl;
-      } else {
-        std::cout << "> " << nbPoints << " points" << std::endl;
-        std::cout << "> " << nbLines << " lines" << std::endl;
-        std::cout << "> " << nbPolygonLines << " polygon lines" << std::endl;
-        std::cout << "> " << nbPolygonPoints << " polygon points" << std::endl;
-        std::cout << "> " << nbCylinders << " cylinders" << std::endl;
-        std::cout << "> " << nbCircles << " circles" << std::endl;
-      }
     }
-
-    //Go up: remove current model
-    vectorOfModelFilename.pop_back();
-  } catch (...) {
-    std::cerr << "Cannot read line!" << std::endl;
-    throw vpException(vpException::ioError, "cannot read line");
   }
+
+  startIdFace = idFace;
 }
 
 #ifdef VISP_HAVE_COIN3D
@@ -2985,6 +2521,75 @@ void vpMbTracker::computeVVSPoseEstimation(const bool isoJoIdentity_, unsigned i
   }
 }
 
+/*!
+  Compute the pose increment from the normal equations \f$ {\bf L}^T {\bf L}
+  \f$ and \f$ {\bf L}^T {\bf R} \f$ that were accumulated by the caller,
+  for instance in double precision from a single precision interaction matrix
+  (see vpMatrixf::AtA() and vpMatrixf::AtB()).
+
+  When the estimated degrees of freedom are restricted (\e isoJoIdentity_ is
+  false), the normal equations of \f$ {\bf L} {^c}{\bf V}_o {^o}{\bf J}_o
+  \f$ are obtained with \f$ {\bf J}^T ({\bf L}^T {\bf L}) {\bf J} \f$ and
+  \f$ {\bf J}^T ({\bf L}^T {\bf R}) \f$, \f$ {\bf J} = {^c}{\bf V}_o
+  {^o}{\bf J}_o \f$, without going back to the tall matrix.
+
+  The pseudo-inverse discards the singular values of the normal matrix
+  below \e svThreshold times the number of rows times the largest one. With
+  the default value, 0, the machine epsilon is used like in the other
+  overload. When \f$ {\bf L} \f$ is stored in single precision, its
+  rounding perturbs the small eigenvalues of \f$ {\bf L}^T {\bf L} \f$ by
+  up to the square of the float epsilon relative to the largest one, which
+  must then be used as threshold so that an unobservable direction (for
+  instance when the robust weights discard all the features of a face) is
+  not amplified.
+*/
+void vpMbTracker::computeVVSPoseEstimation(const bool isoJoIdentity_, unsigned int iter, const vpMatrix &LTL,
+                                           const vpColVector &LTR, const vpColVector &error,
+                                           vpColVector &error_prev, double &mu, vpColVector &v, double svThreshold)
+{
+  if (svThreshold <= 0.) {
+    svThreshold = std::numeric_limits<double>::epsilon();
+  }
+
+  vpVelocityTwistMatrix cVo;
+  vpMatrix A;
+  vpColVector b;
+  if (isoJoIdentity_) {
+    A = LTL;
+    b = LTR;
+  } else {
+    cVo.buildFrom(m_cMo);
+    vpMatrix J = cVo * oJo;
+    vpMatrix JT = J.t();
+    A = JT * LTL * J;
+    b = JT * LTR;
+  }
+
+  switch (m_optimizationMethod) {
+  case vpMbTracker::LEVENBERG_MARQUARDT_OPT: {
+    vpMatrix LMA(A.getRows(), A.getCols());
+    LMA.eye();
+    vpMatrix LTLmuI = A + (LMA * mu);
+    v = -m_lambda * LTLmuI.pseudoInverse(LTLmuI.getRows() * svThreshold) * b;
+
+    if (iter != 0)
+      mu /= 10.0;
+
+    error_prev = error;
+    break;
+  }
+
+  case vpMbTracker::GAUSS_NEWTON_OPT:
+  default:
+    v = -m_lambda * A.pseudoInverse(A.getRows() * svThreshold) * b;
+    break;
+  }
+
+  if (!isoJoIdentity_) {
+    v = cVo * v;
+  }
+}
+
 void vpMbTracker::computeVVSWeights(vpRobust &robust, const vpColVector &error, vpColVector &w)
 {
   if (error.getRows() > 0)
@@ -0,0 +1,976 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * CAD model description in the cao and binary formats.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtCadModel.cpp
+  \brief CAD model description in the cao and binary formats.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+#include <visp3/core/vpDebug.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/mbt/vpMbtCadModel.h>
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__)))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VP_MBT_CAD_MODEL_MMAP 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Layout of a binary model, all the values are in the byte order of the machine that wrote it:
+// - header: magic, version, byte order mark, then the sizes and the counters, 14 unsigned int
+// - the points coordinates, 3 double per point
+// - the primitives, see vpBinaryPrimitive
+// - the point indexes, 1 unsigned int per index
+// - the names, concatenated without separator
+const char binary_magic[8] = {'V', 'I', 'S', 'P', 'B', 'C', 'A', 'O'};
+const unsigned int binary_version = 1;
+const unsigned int binary_byte_order = 0x01020304;
+const size_t binary_header_size = sizeof(binary_magic) + 14 * sizeof(unsigned int);
+
+const unsigned int flag_has_lod = 1;
+const unsigned int flag_use_lod = 2;
+const unsigned int flag_has_threshold = 4;
+
+// Primitive as stored in a binary model, 40 bytes so that the doubles stay aligned
+struct vpBinaryPrimitive {
+  double radius;
+  double threshold;
+  unsigned int type;
+  unsigned int flags;
+  unsigned int first;
+  unsigned int nbPoints;
+  unsigned int nameOffset;
+  unsigned int nameLength;
+};
+
+std::map<std::string, std::string> parameterNames()
+{
+  std::map<std::string, std::string> mapOfParameterNames;
+  mapOfParameterNames["name"] = "string";
+  mapOfParameterNames["minPolygonAreaThreshold"] = "number";
+  mapOfParameterNames["minLineLengthThreshold"] = "number";
+  mapOfParameterNames["useLod"] = "boolean";
+  return mapOfParameterNames;
+}
+
+template <typename Type> void writeValues(std::ofstream &file, const Type *values, size_t nb)
+{
+  if (nb > 0) {
+    file.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(nb * sizeof(Type)));
+  }
+}
+
+// Copies nb values at an offset of a binary model, after checking that they are in the file
+template <typename Type>
+void readValues(const unsigned char *data, size_t size, size_t &offset, Type *values, size_t nb)
+{
+  const size_t bytes = nb * sizeof(Type);
+  if (nb > (size - offset) / sizeof(Type)) {
+    throw vpException(vpException::ioError, "Truncated binary model");
+  }
+  if (bytes > 0) {
+    memcpy(values, data + offset, bytes);
+  }
+  offset += bytes;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor of an empty model.
+*/
+vpMbtCadModel::vpMbtCadModel()
+  : m_points(), m_indexes(), m_primitives(), m_nbLines(0), m_nbPolygonLines(0), m_nbPolygonPoints(0),
+    m_nbCylinders(0), m_nbCircles(0)
+{
+}
+
+void vpMbtCadModel::addPrimitive(vpPrimitiveType type, const std::vector<unsigned int> &indexes, double radius,
+                                 const std::map<std::string, std::string> &mapOfParams,
+                                 const std::string &thresholdName)
+{
+  vpPrimitive primitive;
+  primitive.type = type;
+  primitive.first = static_cast<unsigned int>(m_indexes.size());
+  primitive.nbPoints = static_cast<unsigned int>(indexes.size());
+  primitive.radius = radius;
+
+  std::map<std::string, std::string>::const_iterator it = mapOfParams.find("name");
+  if (it != mapOfParams.end()) {
+    primitive.name = it->second;
+  }
+  it = mapOfParams.find(thresholdName);
+  if (it != mapOfParams.end()) {
+    primitive.hasThreshold = true;
+    primitive.threshold = std::atof(it->second.c_str());
+  }
+  it = mapOfParams.find("useLod");
+  if (it != mapOfParams.end()) {
+    primitive.hasLod = true;
+    primitive.useLod = vpIoTools::parseBoolean(it->second);
+  }
+
+  m_indexes.insert(m_indexes.end(), indexes.begin(), indexes.end());
+  m_primitives.push_back(primitive);
+}
+
+/*!
+  Append the content of a cao file to the model.
+
+  \param modelFile : Full name of the *.cao file.
+  \param vectorOfModelFilename : Files being loaded, used to detect cyclic
+  inclusions.
+  \param verbose : If true, will print additional information with CAO model
+  files which include other CAO model files.
+  \param parent : This parameter is set to true when parsing a parent CAO
+  model file, and false when parsing an included CAO model file.
+  \param oTo : Transformation from the frame of the file to the frame of the
+  model.
+
+  \sa loadCAO(), vpMbTracker::loadCAOModel()
+*/
+void vpMbtCadModel::appendCAO(const std::string &modelFile, std::vector<std::string> &vectorOfModelFilename,
+                              bool verbose, bool parent, const vpHomogeneousMatrix &oTo)
+{
+  std::ifstream fileId;
+  fileId.open(modelFile.c_str(), std::ifstream::in);
+  if (fileId.fail()) {
+    std::cout << "cannot read CAO model file: " << modelFile << std::endl;
+    throw vpException(vpException::ioError, "cannot read CAO model file");
+  }
+  fileId.exceptions(std::ifstream::failbit | std::ifstream::eofbit);
+
+  if (verbose) {
+    std::cout << "Model file : " << modelFile << std::endl;
+  }
+  vectorOfModelFilename.push_back(modelFile);
+
+  try {
+    char c;
+    // Extraction of the version (remove empty line and commented ones
+    // (comment line begin with the #)).
+    removeComment(fileId);
+
+    //////////////////////////Read CAO Version (V1, V2,...)//////////////////////////
+    int caoVersion;
+    fileId.get(c);
+    if (c == 'V') {
+      fileId >> caoVersion;
+      fileId.ignore(256, '\n'); // skip the rest of the line
+    } else {
+      std::cout << "in vpMbTracker::loadCAOModel() -> Bad parameter header "
+                   "file : use V0, V1, ...";
+      throw vpException(vpException::badValue, "in vpMbTracker::loadCAOModel() -> Bad parameter "
+                                               "header file : use V0, V1, ...");
+    }
+
+    removeComment(fileId);
+
+    //////////////////////////Read the header part if present//////////////////////////
+    std::string line;
+    const std::string prefix_load = "load";
+
+    fileId.get(c);
+    fileId.unget();
+    bool header = false;
+    while (c == 'l' || c == 'L') {
+      getline(fileId, line);
+
+      if (!line.compare(0, prefix_load.size(), prefix_load)) {
+        // remove "load("
+        std::string paramsStr = line.substr(5);
+        // get parameters inside load()
+        paramsStr = paramsStr.substr(0, paramsStr.find_first_of(")"));
+        // split by comma
+        std::vector<std::string> params = vpIoTools::splitChain(paramsStr, ",");
+        // remove whitespaces
+        for (size_t i = 0; i < params.size(); i++) {
+          params[i] = vpIoTools::trim(params[i]);
+        }
+
+        if (!params.empty()) {
+          // Get the loaded model pathname
+          std::string headerPathRead = params[0];
+          headerPathRead = headerPathRead.substr(1);
+          headerPathRead = headerPathRead.substr(0, headerPathRead.find_first_of("\""));
+
+          std::string headerPath = headerPathRead;
+          if (!vpIoTools::isAbsolutePathname(headerPathRead)) {
+            std::string parentDirectory = vpIoTools::getParent(modelFile);
+            headerPath = vpIoTools::createFilePath(parentDirectory, headerPathRead);
+          }
+
+          // Normalize path
+          headerPath = vpIoTools::path(headerPath);
+
+          // Get real path
+          headerPath = vpIoTools::getAbsolutePathname(headerPath);
+
+          vpHomogeneousMatrix oTo_local;
+          vpTranslationVector t;
+          vpThetaUVector tu;
+          for (size_t i = 1; i < params.size(); i++) {
+            std::string param = params[i];
+            {
+              const std::string prefix = "t=[";
+              if (!param.compare(0, prefix.size(), prefix)) {
+                param = param.substr(prefix.size());
+                param = param.substr(0, param.find_first_of("]"));
+
+                std::vector<std::string> values = vpIoTools::splitChain(param, ";");
+                if (values.size() == 3) {
+                  t[0] = atof(values[0].c_str());
+                  t[1] = atof(values[1].c_str());
+                  t[2] = atof(values[2].c_str());
+                }
+              }
+            }
+            {
+              const std::string prefix = "tu=[";
+              if (!param.compare(0, prefix.size(), prefix)) {
+                param = param.substr(prefix.size());
+                param = param.substr(0, param.find_first_of("]"));
+
+                std::vector<std::string> values = vpIoTools::splitChain(param, ";");
+                if (values.size() == 3) {
+                  for (size_t j = 0; j < values.size(); j++) {
+                    std::string value = values[j];
+                    bool radian = true;
+                    size_t unitPos = value.find("deg");
+                    if (unitPos != std::string::npos) {
+                      value = value.substr(0, unitPos);
+                      radian = false;
+                    }
+
+                    unitPos = value.find("rad");
+                    if (unitPos != std::string::npos) {
+                      value = value.substr(0, unitPos);
+                    }
+                    tu[static_cast<unsigned int>(j)] =
+                        !radian ? vpMath::rad(atof(value.c_str())) : atof(value.c_str());
+                  }
+                }
+              }
+            }
+          }
+          oTo_local.buildFrom(t, tu);
+
+          bool cyclic = false;
+          for (std::vector<std::string>::const_iterator it = vectorOfModelFilename.begin();
+               it != vectorOfModelFilename.end() && !cyclic; ++it) {
+            if (headerPath == *it) {
+              cyclic = true;
+            }
+          }
+
+          if (!cyclic) {
+            if (vpIoTools::checkFilename(headerPath)) {
+              header = true;
+              appendCAO(headerPath, vectorOfModelFilename, verbose, false, oTo * oTo_local);
+            } else {
+              throw vpException(vpException::ioError, "file cannot be open");
+            }
+          } else {
+            std::cout << "WARNING Cyclic dependency detected with file " << headerPath << " declared in " << modelFile
+                      << std::endl;
+          }
+        }
+      }
+
+      removeComment(fileId);
+      fileId.get(c);
+      fileId.unget();
+    }
+
+    //////////////////////////Read the point declaration part//////////////////////////
+    unsigned int caoNbrPoint;
+    fileId >> caoNbrPoint;
+    fileId.ignore(256, '\n'); // skip the rest of the line
+
+    if (verbose || (parent && !header)) {
+      std::cout << "> " << caoNbrPoint << " points" << std::endl;
+    }
+
+    if (caoNbrPoint > 100000) {
+      throw vpException(vpException::badValue, "Exceed the max number of points in the CAO model.");
+    }
+
+    if (caoNbrPoint == 0 && !header) {
+      throw vpException(vpException::badValue, "in vpMbTracker::loadCAOModel() -> no points are defined");
+    }
+
+    // Indexes of the points of this file in the model
+    const unsigned int firstPoint = getNbPoints();
+    m_points.reserve(m_points.size() + 3 * caoNbrPoint);
+
+    int i; // image coordinate (used for matching)
+    int j;
+
+    for (unsigned int k = 0; k < caoNbrPoint; k++) {
+      removeComment(fileId);
+
+      vpColVector pt_3d(4, 1.0);
+      fileId >> pt_3d[0];
+      fileId >> pt_3d[1];
+      fileId >> pt_3d[2];
+
+      if (caoVersion == 2) {
+        fileId >> i;
+        fileId >> j;
+      }
+
+      fileId.ignore(256, '\n'); // skip the rest of the line
+
+      vpColVector pt_3d_tf = oTo * pt_3d;
+      m_points.push_back(pt_3d_tf[0]);
+      m_points.push_back(pt_3d_tf[1]);
+      m_points.push_back(pt_3d_tf[2]);
+    }
+
+    removeComment(fileId);
+
+    //////////////////////////Read the segment declaration part//////////////////////////
+    // Store in a map the potential segments to add
+    std::map<std::pair<unsigned int, unsigned int>, std::map<std::string, std::string> > segmentTemporaryMap;
+    unsigned int caoNbrLine;
+    fileId >> caoNbrLine;
+    fileId.ignore(256, '\n'); // skip the rest of the line
+
+    m_nbLines += caoNbrLine;
+    if (verbose || (parent && !header)) {
+      std::cout << "> " << caoNbrLine << " lines" << std::endl;
+    }
+
+    if (caoNbrLine > 100000) {
+      throw vpException(vpException::badValue, "Exceed the max number of lines in the CAO model.");
+    }
+
+    std::vector<unsigned int> caoLinePoints(2 * caoNbrLine);
+    unsigned int index1, index2;
+
+    for (unsigned int k = 0; k < caoNbrLine; k++) {
+      removeComment(fileId);
+
+      fileId >> index1;
+      fileId >> index2;
+
+      //////////////////////////Read the parameter value if present//////////////////////////
+      // Get the end of the line
+      char buffer[256];
+      fileId.getline(buffer, 256);
+      std::string endLine(buffer);
+
+      caoLinePoints[2 * k] = index1;
+      caoLinePoints[2 * k + 1] = index2;
+
+      if (index1 < caoNbrPoint && index2 < caoNbrPoint) {
+        std::pair<unsigned int, unsigned int> key(index1, index2);
+        segmentTemporaryMap[key] = parseParameters(endLine);
+      } else {
+        vpTRACE(" line %d has wrong coordinates.", k);
+      }
+    }
+
+    removeComment(fileId);
+
+    //////////////////////////Read the face segment declaration part//////////////////////////
+    /* Load polygon from the lines extracted earlier (the first point of the
+     * line is used)*/
+    // Store in a vector the indexes of the segments added in the face segment
+    // case
+    std::vector<std::pair<unsigned int, unsigned int> > faceSegmentKeyVector;
+    unsigned int caoNbrPolygonLine;
+    fileId >> caoNbrPolygonLine;
+    fileId.ignore(256, '\n'); // skip the rest of the line
+
+    m_nbPolygonLines += caoNbrPolygonLine;
+    if (verbose || (parent && !header)) {
+      std::cout << "> " << caoNbrPolygonLine << " polygon lines" << std::endl;
+    }
+
+    if (caoNbrPolygonLine > 100000) {
+      throw vpException(vpException::badValue, "Exceed the max number of polygon lines.");
+    }
+
+    unsigned int index;
+    for (unsigned int k = 0; k < caoNbrPolygonLine; k++) {
+      removeComment(fileId);
+
+      unsigned int nbLinePol;
+      fileId >> nbLinePol;
+      std::vector<unsigned int> corners;
+      if (nbLinePol > 100000) {
+        throw vpException(vpException::badValue, "Exceed the max number of lines.");
+      }
+
+      for (unsigned int n = 0; n < nbLinePol; n++) {
+        fileId >> index;
+
+        if (index >= caoNbrLine) {
+          throw vpException(vpException::badValue, "Exceed the max number of lines.");
+        }
+        if (caoLinePoints[2 * index] >= caoNbrPoint || caoLinePoints[2 * index + 1] >= caoNbrPoint) {
+          throw vpException(vpException::badValue, "Exceed the max number of points.");
+        }
+        corners.push_back(firstPoint + caoLinePoints[2 * index]);
+        corners.push_back(firstPoint + caoLinePoints[2 * index + 1]);
+
+        std::pair<unsigned int, unsigned int> key(caoLinePoints[2 * index], caoLinePoints[2 * index + 1]);
+        faceSegmentKeyVector.push_back(key);
+      }
+
+      //////////////////////////Read the parameter value if present//////////////////////////
+      // Get the end of the line
+      char buffer[256];
+      fileId.getline(buffer, 256);
+      std::string endLine(buffer);
+
+      addPrimitive(POLYGON_FROM_LINES, corners, 0.0, parseParameters(endLine), "minPolygonAreaThreshold");
+    }
+
+    // Add the segments which were not already added in the face segment case
+    for (std::map<std::pair<unsigned int, unsigned int>, std::map<std::string, std::string> >::const_iterator it =
+             segmentTemporaryMap.begin();
+         it != segmentTemporaryMap.end(); ++it) {
+      if (std::find(faceSegmentKeyVector.begin(), faceSegmentKeyVector.end(), it->first) ==
+          faceSegmentKeyVector.end()) {
+        std::vector<unsigned int> extremities;
+        extremities.push_back(firstPoint + it->first.first);
+        extremities.push_back(firstPoint + it->first.second);
+        addPrimitive(LINE, extremities, 0.0, it->second, "minLineLengthThreshold");
+      }
+    }
+
+    removeComment(fileId);
+
+    //////////////////////////Read the face point declaration part//////////////////////////
+    /* Extract the polygon using the point coordinates (top of the file) */
+    unsigned int caoNbrPolygonPoint;
+    fileId >> caoNbrPolygonPoint;
+    fileId.ignore(256, '\n'); // skip the rest of the line
+
+    m_nbPolygonPoints += caoNbrPolygonPoint;
+    if (verbose || (parent && !header)) {
+      std::cout << "> " << caoNbrPolygonPoint << " polygon points" << std::endl;
+    }
+
+    if (caoNbrPolygonPoint > 100000) {
+      throw vpException(vpException::badValue, "Exceed the max number of polygon point.");
+    }
+
+    for (unsigned int k = 0; k < caoNbrPolygonPoint; k++) {
+      removeComment(fileId);
+
+      unsigned int nbPointPol;
+      fileId >> nbPointPol;
+      if (nbPointPol > 100000) {
+        throw vpException(vpException::badValue, "Exceed the max number of points.");
+      }
+      std::vector<unsigned int> corners;
+      for (unsigned int n = 0; n < nbPointPol; n++) {
+        fileId >> index;
+        if (index > caoNbrPoint - 1) {
+          throw vpException(vpException::badValue, "Exceed the max number of points.");
+        }
+        corners.push_back(firstPoint + index);
+      }
+
+      //////////////////////////Read the parameter value if present//////////////////////////
+      // Get the end of the line
+      char buffer[256];
+      fileId.getline(buffer, 256);
+      std::string endLine(buffer);
+
+      addPrimitive(POLYGON_FROM_POINTS, corners, 0.0, parseParameters(endLine), "minPolygonAreaThreshold");
+    }
+
+    //////////////////////////Read the cylinder declaration part//////////////////////////
+    bool endOfFile = false;
+    unsigned int caoNbCylinder;
+    try {
+      removeComment(fileId);
+
+      if (fileId.eof()) { // check if not at the end of the file (for old
+                          // style files)
+        endOfFile = true;
+      } else {
+        /* Extract the cylinders */
+        fileId >> caoNbCylinder;
+        fileId.ignore(256, '\n'); // skip the rest of the line
+
+        m_nbCylinders += caoNbCylinder;
+        if (verbose || (parent && !header)) {
+          std::cout << "> " << caoNbCylinder << " cylinders" << std::endl;
+        }
+
+        if (caoNbCylinder > 100000) {
+          throw vpException(vpException::badValue, "Exceed the max number of cylinders.");
+        }
+
+        for (unsigned int k = 0; k < caoNbCylinder; ++k) {
+          removeComment(fileId);
+
+          double radius;
+          unsigned int indexP1, indexP2;
+          fileId >> indexP1;
+          fileId >> indexP2;
+          fileId >> radius;
+
+          //////////////////////////Read the parameter value if present//////////////////////////
+          // Get the end of the line
+          char buffer[256];
+          fileId.getline(buffer, 256);
+          std::string endLine(buffer);
+
+          if (indexP1 >= caoNbrPoint || indexP2 >= caoNbrPoint) {
+            throw vpException(vpException::badValue, "Exceed the max number of points.");
+          }
+          std::vector<unsigned int> axis;
+          axis.push_back(firstPoint + indexP1);
+          axis.push_back(firstPoint + indexP2);
+          addPrimitive(CYLINDER, axis, radius, parseParameters(endLine), "minLineLengthThreshold");
+        }
+      }
+    } catch (...) {
+      std::cerr << "Cannot get the number of cylinders. Defaulting to zero." << std::endl;
+      caoNbCylinder = 0;
+    }
+
+    //////////////////////////Read the circle declaration part//////////////////////////
+    unsigned int caoNbCircle;
+    try {
+      if (!endOfFile) {
+        removeComment(fileId);
+      }
+
+      if (endOfFile || fileId.eof()) { // check if not at the end of the file (for old
+                                       // style files)
+        endOfFile = true;
+      } else {
+        /* Extract the circles */
+        fileId >> caoNbCircle;
+        fileId.ignore(256, '\n'); // skip the rest of the line
+
+        m_nbCircles += caoNbCircle;
+        if (verbose || (parent && !header)) {
+          std::cout << "> " << caoNbCircle << " circles" << std::endl;
+        }
+
+        if (caoNbCircle > 100000) {
+          throw vpException(vpException::badValue, "Exceed the max number of cicles.");
+        }
+
+        for (unsigned int k = 0; k < caoNbCircle; ++k) {
+          removeComment(fileId);
+
+          double radius;
+          unsigned int indexP1, indexP2, indexP3;
+          fileId >> radius;
+          fileId >> indexP1;
+          fileId >> indexP2;
+          fileId >> indexP3;
+
+          //////////////////////////Read the parameter value if present//////////////////////////
+          // Get the end of the line
+          char buffer[256];
+          fileId.getline(buffer, 256);
+          std::string endLine(buffer);
+
+          if (indexP1 >= caoNbrPoint || indexP2 >= caoNbrPoint || indexP3 >= caoNbrPoint) {
+            throw vpException(vpException::badValue, "Exceed the max number of points.");
+          }
+          std::vector<unsigned int> points;
+          points.push_back(firstPoint + indexP1);
+          points.push_back(firstPoint + indexP2);
+          points.push_back(firstPoint + indexP3);
+          addPrimitive(CIRCLE, points, radius, parseParameters(endLine), "minPolygonAreaThreshold");
+        }
+      }
+    } catch (...) {
+      std::cerr << "Cannot get the number of circles. Defaulting to zero." << std::endl;
+      caoNbCircle = 0;
+    }
+
+    if (header && parent && !endOfFile) {
+      if (verbose) {
+        std::cout << "Global information for " << vpIoTools::getName(modelFile) << " :" << std::endl;
+        std::cout << "Total nb of points : " << getNbPoints() << std::endl;
+        std::cout << "Total nb of lines : " << m_nbLines << std::endl;
+        std::cout << "Total nb of polygon lines : " << m_nbPolygonLines << std::endl;
+        std::cout << "Total nb of polygon points : " << m_nbPolygonPoints << std::endl;
+        std::cout << "Total nb of cylinders : " << m_nbCylinders << std::endl;
+        std::cout << "Total nb of circles : " << m_nbCircles << std::endl;
+      } else {
+        std::cout << "> " << getNbPoints() << " points" << std::endl;
+        std::cout << "> " << m_nbLines << " lines" << std::endl;
+        std::cout << "> " << m_nbPolygonLines << " polygon lines" << std::endl;
+        std::cout << "> " << m_nbPolygonPoints << " polygon points" << std::endl;
+        std::cout << "> " << m_nbCylinders << " cylinders" << std::endl;
+        std::cout << "> " << m_nbCircles << " circles" << std::endl;
+      }
+    }
+
+    // Go up: remove current model
+    vectorOfModelFilename.pop_back();
+  } catch (...) {
+    std::cerr << "Cannot read line!" << std::endl;
+    throw vpException(vpException::ioError, "cannot read line");
+  }
+}
+
+/*!
+  Remove all the points and primitives of the model.
+*/
+void vpMbtCadModel::clear()
+{
+  m_points.clear();
+  m_indexes.clear();
+  m_primitives.clear();
+  m_nbLines = 0;
+  m_nbPolygonLines = 0;
+  m_nbPolygonPoints = 0;
+  m_nbCylinders = 0;
+  m_nbCircles = 0;
+}
+
+/*!
+  Check if a file is a binary model written by saveBinary().
+
+  \param modelFile : Name of the file.
+
+  \return True if the file starts with the signature of the binary models.
+*/
+bool vpMbtCadModel::isBinary(const std::string &modelFile)
+{
+  std::ifstream file(modelFile.c_str(), std::ios::in | std::ios::binary);
+  char magic[sizeof(binary_magic)];
+  if (!file.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return memcmp(magic, binary_magic, sizeof(binary_magic)) == 0;
+}
+
+/*!
+  Load a binary model written by saveBinary(). The previous content of the
+  model is removed.
+
+  The file is mapped in memory on the platforms that support it, and read at
+  once otherwise. The arrays it contains are checked and copied, there is no
+  parsing.
+
+  \param modelFile : Name of the binary file.
+
+  \throw vpException::ioError if the file cannot be read, is not a binary
+  model, was written on a machine with another byte order, or is corrupted.
+*/
+void vpMbtCadModel::loadBinary(const std::string &modelFile)
+{
+  clear();
+
+#if defined(VP_MBT_CAD_MODEL_MMAP)
+  int fd = open(modelFile.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw vpException(vpException::ioError, "Cannot open the binary model %s", modelFile.c_str());
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    throw vpException(vpException::ioError, "Cannot read the binary model %s", modelFile.c_str());
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw vpException(vpException::ioError, "Cannot map the binary model %s", modelFile.c_str());
+  }
+
+  try {
+    parseBinary(static_cast<const unsigned char *>(data), size);
+  } catch (...) {
+    munmap(data, size);
+    clear();
+    throw;
+  }
+  munmap(data, size);
+#else
+  std::ifstream file(modelFile.c_str(), std::ios::in | std::ios::binary);
+  if (!file) {
+    throw vpException(vpException::ioError, "Cannot open the binary model %s", modelFile.c_str());
+  }
+  std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (data.empty()) {
+    throw vpException(vpException::ioError, "Cannot read the binary model %s", modelFile.c_str());
+  }
+
+  try {
+    parseBinary(&data[0], data.size());
+  } catch (...) {
+    clear();
+    throw;
+  }
+#endif
+}
+
+/*!
+  Load a cao model file and the files it includes. The previous content of
+  the model is removed.
+
+  \param modelFile : Full name of the main *.cao file containing the model.
+  \param verbose : If true, will print additional information with CAO model
+  files which include other CAO model files.
+
+  \sa appendCAO(), vpMbTracker::loadCAOModel() for the description of the
+  format.
+*/
+void vpMbtCadModel::loadCAO(const std::string &modelFile, bool verbose)
+{
+  clear();
+  std::vector<std::string> vectorOfModelFilename;
+  appendCAO(modelFile, vectorOfModelFilename, verbose, true);
+}
+
+void vpMbtCadModel::parseBinary(const unsigned char *data, size_t size)
+{
+  if (size < binary_header_size || memcmp(data, binary_magic, sizeof(binary_magic)) != 0) {
+    throw vpException(vpException::ioError, "Not a binary model");
+  }
+
+  size_t offset = sizeof(binary_magic);
+  unsigned int header[14];
+  readValues(data, size, offset, header, 14);
+  if (header[1] != binary_byte_order) {
+    throw vpException(vpException::ioError, "The binary model was written with another byte order");
+  }
+  if (header[0] != binary_version) {
+    throw vpException(vpException::ioError, "Unsupported binary model version %d", header[0]);
+  }
+
+  const unsigned int nbPoints = header[2], nbIndexes = header[3], nbPrimitives = header[4], nbNameBytes = header[5];
+  m_nbLines = header[6];
+  m_nbPolygonLines = header[7];
+  m_nbPolygonPoints = header[8];
+  m_nbCylinders = header[9];
+  m_nbCircles = header[10];
+
+  // The sizes are checked before any allocation
+  const size_t expected = binary_header_size + 3 * sizeof(double) * static_cast<size_t>(nbPoints) +
+                          sizeof(vpBinaryPrimitive) * static_cast<size_t>(nbPrimitives) +
+                          sizeof(unsigned int) * static_cast<size_t>(nbIndexes) + nbNameBytes;
+  if (size != expected) {
+    throw vpException(vpException::ioError, "Corrupted binary model");
+  }
+
+  m_points.resize(3 * static_cast<size_t>(nbPoints));
+  readValues(data, size, offset, m_points.empty() ? NULL : &m_points[0], m_points.size());
+
+  std::vector<vpBinaryPrimitive> records(nbPrimitives);
+  readValues(data, size, offset, records.empty() ? NULL : &records[0], records.size());
+
+  m_indexes.resize(nbIndexes);
+  readValues(data, size, offset, m_indexes.empty() ? NULL : &m_indexes[0], m_indexes.size());
+  for (unsigned int i = 0; i < nbIndexes; i++) {
+    if (m_indexes[i] >= nbPoints) {
+      throw vpException(vpException::ioError, "Corrupted binary model: point index out of range");
+    }
+  }
+
+  const char *names = reinterpret_cast<const char *>(data + offset);
+  m_primitives.resize(nbPrimitives);
+  for (unsigned int i = 0; i < nbPrimitives; i++) {
+    const vpBinaryPrimitive &record = records[i];
+    if (record.type > CIRCLE || record.first > nbIndexes || record.nbPoints > nbIndexes - record.first ||
+        record.nameOffset > nbNameBytes || record.nameLength > nbNameBytes - record.nameOffset) {
+      throw vpException(vpException::ioError, "Corrupted binary model: invalid primitive %d", i);
+    }
+    const unsigned int required[5] = {0, 2, 0, 2, 3};
+    if (required[record.type] > 0 && record.nbPoints != required[record.type]) {
+      throw vpException(vpException::ioError, "Corrupted binary model: invalid primitive %d", i);
+    }
+
+    vpPrimitive &primitive = m_primitives[i];
+    primitive.type = static_cast<vpPrimitiveType>(record.type);
+    primitive.first = record.first;
+    primitive.nbPoints = record.nbPoints;
+    primitive.radius = record.radius;
+    primitive.hasLod = (record.flags & flag_has_lod) != 0;
+    primitive.useLod = (record.flags & flag_use_lod) != 0;
+    primitive.hasThreshold = (record.flags & flag_has_threshold) != 0;
+    primitive.threshold = record.threshold;
+    primitive.name.assign(names + record.nameOffset, record.nameLength);
+  }
+}
+
+std::map<std::string, std::string> vpMbtCadModel::parseParameters(std::string &endLine)
+{
+  static const std::map<std::string, std::string> mapOfParameterNames = parameterNames();
+  std::map<std::string, std::string> mapOfParams;
+
+  bool exit = false;
+  while (!endLine.empty() && !exit) {
+    exit = true;
+
+    for (std::map<std::string, std::string>::const_iterator it = mapOfParameterNames.begin();
+         it != mapOfParameterNames.end(); ++it) {
+      endLine = vpIoTools::trim(endLine);
+      std::string param(it->first + "=");
+
+      // Compare with a potential parameter
+      if (endLine.compare(0, param.size(), param) == 0) {
+        exit = false;
+        endLine = endLine.substr(param.size());
+
+        bool parseQuote = false;
+        if (it->second == "string") {
+          // Check if the string is between quotes
+          if (endLine.size() > 2 && endLine[0] == '"') {
+            parseQuote = true;
+            endLine = endLine.substr(1);
+            size_t pos = endLine.find_first_of('"');
+
+            if (pos != std::string::npos) {
+              mapOfParams[it->first] = endLine.substr(0, pos);
+              endLine = endLine.substr(pos + 1);
+            } else {
+              parseQuote = false;
+            }
+          }
+        }
+
+        if (!parseQuote) {
+          // Deal with space or tabulation after parameter value to substring
+          // to the next sequence
+          size_t pos1 = endLine.find_first_of(' ');
+          size_t pos2 = endLine.find_first_of('\t');
+          size_t pos = pos1 < pos2 ? pos1 : pos2;
+
+          mapOfParams[it->first] = endLine.substr(0, pos);
+          endLine = endLine.substr(pos + 1);
+        }
+      }
+    }
+  }
+
+  return mapOfParams;
+}
+
+void vpMbtCadModel::removeComment(std::ifstream &fileId)
+{
+  char c;
+
+  fileId.get(c);
+  while (!fileId.fail() && (c == '#')) {
+    fileId.ignore(256, '\n');
+    fileId.get(c);
+  }
+  if (fileId.fail()) {
+    throw(vpException(vpException::ioError, "Reached end of file"));
+  }
+  fileId.unget();
+}
+
+/*!
+  Save the model in a binary file that can be read with loadBinary() or
+  vpMbTracker::loadModel(). The \c .bcao extension is expected by
+  vpMbTracker::loadModel().
+
+  \param modelFile : Name of the binary file.
+
+  \throw vpException::ioError if the file cannot be written.
+*/
+void vpMbtCadModel::saveBinary(const std::string &modelFile) const
+{
+  if (sizeof(unsigned int) != 4 || sizeof(vpBinaryPrimitive) != 40) {
+    throw vpException(vpException::fatalError, "Binary models are not supported on this platform");
+  }
+
+  std::vector<vpBinaryPrimitive> records(m_primitives.size());
+  std::string names;
+  for (size_t i = 0; i < m_primitives.size(); i++) {
+    const vpPrimitive &primitive = m_primitives[i];
+    vpBinaryPrimitive &record = records[i];
+    record.radius = primitive.radius;
+    record.threshold = primitive.threshold;
+    record.type = static_cast<unsigned int>(primitive.type);
+    record.flags = (primitive.hasLod ? flag_has_lod : 0) | (primitive.useLod ? flag_use_lod : 0) |
+                   (primitive.hasThreshold ? flag_has_threshold : 0);
+    record.first = primitive.first;
+    record.nbPoints = primitive.nbPoints;
+    record.nameOffset = static_cast<unsigned int>(names.size());
+    record.nameLength = static_cast<unsigned int>(primitive.name.size());
+    names += primitive.name;
+  }
+
+  const unsigned int header[14] = {binary_version,
+                                   binary_byte_order,
+                                   getNbPoints(),
+                                   static_cast<unsigned int>(m_indexes.size()),
+                                   static_cast<unsigned int>(m_primitives.size()),
+                                   static_cast<unsigned int>(names.size()),
+                                   m_nbLines,
+                                   m_nbPolygonLines,
+                                   m_nbPolygonPoints,
+                                   m_nbCylinders,
+                                   m_nbCircles,
+                                   0,
+                                   0,
+                                   0};
+
+  std::ofstream file(modelFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw vpException(vpException::ioError, "Cannot create the binary model %s", modelFile.c_str());
+  }
+  writeValues(file, binary_magic, sizeof(binary_magic));
+  writeValues(file, header, 14);
+  writeValues(file, m_points.empty() ? NULL : &m_points[0], m_points.size());
+  writeValues(file, records.empty() ? NULL : &records[0], records.size());
+  writeValues(file, m_indexes.empty() ? NULL : &m_indexes[0], m_indexes.size());
+  writeValues(file, names.data(), names.size());
+  if (!file) {
+    throw vpException(vpException::ioError, "Cannot write the binary model %s", modelFile.c_str());
+  }
+}
@@ -0,0 +1,442 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Tracking of several objects in the same camera with shared preprocessing.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtMultiObjectTracker.cpp
+  \brief Tracking of several objects in the same camera with shared
+  preprocessing.
+*/
+
+#include <iostream>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/mbt/vpMbtMultiObjectTracker.h>
+
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+#include <exception>
+#include <omp.h>
+#endif
+
+namespace
+{
+// Track one object, false if it is lost
+bool trackObject(vpMbGenericTracker &tracker, const vpImage<unsigned char> &I,
+                 const std::vector<vpColVector> *pointcloud, unsigned int width, unsigned int height)
+{
+  try {
+    if (pointcloud == NULL) {
+      tracker.track(I);
+    } else {
+      const std::string name = tracker.getReferenceCameraName();
+      std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
+      mapOfImages[name] = &I;
+      std::map<std::string, const std::vector<vpColVector> *> mapOfPointClouds;
+      mapOfPointClouds[name] = pointcloud;
+      std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
+      mapOfWidths[name] = width;
+      mapOfHeights[name] = height;
+      tracker.track(mapOfImages, mapOfPointClouds, mapOfWidths, mapOfHeights);
+    }
+  } catch (const vpException &) {
+    return false;
+  }
+
+  return true;
+}
+}
+
+/*!
+  Default constructor, without object.
+*/
+vpMbtMultiObjectTracker::vpMbtMultiObjectTracker()
+  : m_mapOfTrackers(), m_mapOfTrackingStatus(), m_I(), m_gradientLookup(), m_useOcclusionHandling(false),
+    m_useParallelTracking(false), m_nbParallelThreads(0), m_useSharedGradientLookup(false)
+{
+}
+
+/*!
+  Destructor, the trackers of the objects are destroyed.
+*/
+vpMbtMultiObjectTracker::~vpMbtMultiObjectTracker()
+{
+  for (std::map<std::string, vpMbGenericTracker *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    delete it->second;
+  }
+  m_mapOfTrackers.clear();
+}
+
+/*!
+  Add an object, tracked by a new vpMbGenericTracker with a single camera.
+  The current options of the multi-object tracker are applied to it.
+
+  \param name : Name of the object.
+  \param trackerType : Type of features of the tracker, see
+  vpMbGenericTracker::vpTrackerType.
+
+  \return The tracker of the object, to configure, load and initialize.
+*/
+vpMbGenericTracker &vpMbtMultiObjectTracker::addObject(const std::string &name, int trackerType)
+{
+  if (m_mapOfTrackers.find(name) != m_mapOfTrackers.end()) {
+    throw vpException(vpException::badValue, "The object %s is already tracked", name.c_str());
+  }
+
+  vpMbGenericTracker *tracker = new vpMbGenericTracker(1, trackerType);
+  m_mapOfTrackers[name] = tracker;
+  m_mapOfTrackingStatus[name] = true;
+
+  if (m_useOcclusionHandling) {
+    tracker->setScanLineVisibilityTest(true);
+  }
+  if (m_useSharedGradientLookup) {
+    tracker->setUseMovingEdgeGradientLookup(true);
+    tracker->setSharedMovingEdgeGradientLookup(&m_gradientLookup);
+  }
+
+  return *tracker;
+}
+
+/*!
+  Clip the visible faces of an object at its current pose.
+*/
+void vpMbtMultiObjectTracker::computeOccluders(
+    vpMbGenericTracker &tracker, std::vector<std::vector<std::pair<vpPoint, unsigned int> > > &occluders) const
+{
+  vpCameraParameters cam;
+  tracker.getCameraParameters(cam);
+  const vpHomogeneousMatrix cMo = tracker.getPose();
+
+  // The faces turned away from the camera are hidden by the visible ones, the lines of the model do not hide anything
+  vpMbHiddenFaces<vpMbtPolygon> &faces = tracker.getFaces();
+  for (unsigned int i = 0; i < faces.size(); i++) {
+    if (!faces[i]->isVisible() || faces[i]->getNbPoint() < 3) {
+      continue;
+    }
+
+    vpMbtPolygon polygon(*faces[i]);
+    polygon.changeFrame(cMo);
+    polygon.computePolygonClipped(cam);
+
+    std::vector<std::pair<vpPoint, unsigned int> > clipped;
+    polygon.getPolygonClipped(clipped);
+    if (clipped.size() > 2) {
+      occluders.push_back(clipped);
+    }
+  }
+}
+
+/*!
+  \return The names of the objects.
+*/
+std::vector<std::string> vpMbtMultiObjectTracker::getObjectNames() const
+{
+  std::vector<std::string> names;
+  for (std::map<std::string, vpMbGenericTracker *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    names.push_back(it->first);
+  }
+  return names;
+}
+
+/*!
+  \param name : Name of the object.
+
+  \return The pose of the object estimated at the last frame.
+*/
+vpHomogeneousMatrix vpMbtMultiObjectTracker::getPose(const std::string &name) const
+{
+  std::map<std::string, vpMbGenericTracker *>::const_iterator it = m_mapOfTrackers.find(name);
+  if (it == m_mapOfTrackers.end()) {
+    throw vpException(vpException::badValue, "There is no object %s", name.c_str());
+  }
+  return it->second->getPose();
+}
+
+/*!
+  \param name : Name of the object.
+
+  \return The tracker of the object.
+*/
+vpMbGenericTracker &vpMbtMultiObjectTracker::getTracker(const std::string &name)
+{
+  std::map<std::string, vpMbGenericTracker *>::const_iterator it = m_mapOfTrackers.find(name);
+  if (it == m_mapOfTrackers.end()) {
+    throw vpException(vpException::badValue, "There is no object %s", name.c_str());
+  }
+  return *it->second;
+}
+
+/*!
+  \param name : Name of the object.
+
+  \return False if the tracking of the object failed at the last frame, for
+  instance when not enough features were found. The tracker of the object
+  then has to be initialized again.
+*/
+bool vpMbtMultiObjectTracker::isTracked(const std::string &name) const
+{
+  std::map<std::string, bool>::const_iterator it = m_mapOfTrackingStatus.find(name);
+  if (it == m_mapOfTrackingStatus.end()) {
+    throw vpException(vpException::badValue, "There is no object %s", name.c_str());
+  }
+  return it->second;
+}
+
+/*!
+  Remove an object and destroy its tracker.
+
+  \param name : Name of the object.
+*/
+void vpMbtMultiObjectTracker::removeObject(const std::string &name)
+{
+  std::map<std::string, vpMbGenericTracker *>::iterator it = m_mapOfTrackers.find(name);
+  if (it == m_mapOfTrackers.end()) {
+    throw vpException(vpException::badValue, "There is no object %s", name.c_str());
+  }
+  delete it->second;
+  m_mapOfTrackers.erase(it);
+  m_mapOfTrackingStatus.erase(name);
+}
+
+/*!
+  Set the camera parameters of all the objects.
+
+  \param cam : Camera parameters.
+*/
+void vpMbtMultiObjectTracker::setCameraParameters(const vpCameraParameters &cam)
+{
+  for (std::map<std::string, vpMbGenericTracker *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    it->second->setCameraParameters(cam);
+  }
+}
+
+/*!
+  Let the objects hide each other. The scanline visibility test is enabled
+  for all the objects, see vpMbTracker::setScanLineVisibilityTest().
+
+  \param use : True to handle the occlusions between the objects.
+*/
+void vpMbtMultiObjectTracker::setUseOcclusionHandling(bool use)
+{
+  m_useOcclusionHandling = use;
+
+  const std::vector<std::vector<std::pair<vpPoint, unsigned int> > > noOccluder;
+  for (std::map<std::string, vpMbGenericTracker *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    if (use) {
+      it->second->setScanLineVisibilityTest(true);
+    } else {
+      it->second->setScanLineOccluders(noOccluder);
+    }
+  }
+}
+
+/*!
+  Track the objects concurrently. The objects are independent, the poses are
+  the same as with the sequential tracking.
+
+  \param parallel : True to track the objects concurrently.
+
+  \note This option requires OpenMP and C++11 support.
+*/
+void vpMbtMultiObjectTracker::setUseParallelTracking(bool parallel)
+{
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  m_useParallelTracking = parallel;
+#else
+  if (parallel) {
+    std::cerr << "Parallel multi-object tracking requires OpenMP and C++11 support, the objects are tracked "
+                 "sequentially."
+              << std::endl;
+  }
+  m_useParallelTracking = false;
+#endif
+}
+
+/*!
+  Share the moving-edge mask responses between the objects, see
+  vpMbEdgeTracker::setSharedMovingEdgeGradientLookup(). The lookup is
+  updated once per frame with the masks of the first object tracking moving
+  edges, the objects using other masks keep their own lookup. The poses are
+  unchanged.
+
+  \param use : True to share the responses.
+*/
+void vpMbtMultiObjectTracker::setUseSharedGradientLookup(bool use)
+{
+  m_useSharedGradientLookup = use;
+  for (std::map<std::string, vpMbGenericTracker *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    it->second->setUseMovingEdgeGradientLookup(use);
+    it->second->setSharedMovingEdgeGradientLookup(use ? &m_gradientLookup : NULL);
+  }
+  if (!use) {
+    m_gradientLookup.clear();
+  }
+}
+
+/*!
+  Track all the objects on a grey level image.
+
+  \param I : Image.
+*/
+void vpMbtMultiObjectTracker::track(const vpImage<unsigned char> &I) { trackObjects(I, NULL, 0, 0); }
+
+/*!
+  Track all the objects on a color image, converted once to grey level.
+
+  \param I_color : Image.
+*/
+void vpMbtMultiObjectTracker::track(const vpImage<vpRGBa> &I_color)
+{
+  vpImageConvert::convert(I_color, m_I);
+  trackObjects(m_I, NULL, 0, 0);
+}
+
+/*!
+  Track all the objects on a grey level image and a point cloud.
+
+  \param I : Image.
+  \param pointcloud : Point cloud, read by all the objects using depth
+  features.
+  \param width : Width of the point cloud.
+  \param height : Height of the point cloud.
+*/
+void vpMbtMultiObjectTracker::track(const vpImage<unsigned char> &I, const std::vector<vpColVector> &pointcloud,
+                                    unsigned int width, unsigned int height)
+{
+  trackObjects(I, &pointcloud, width, height);
+}
+
+/*!
+  Track all the objects on a color image, converted once to grey level, and
+  a point cloud.
+
+  \param I_color : Image.
+  \param pointcloud : Point cloud, read by all the objects using depth
+  features.
+  \param width : Width of the point cloud.
+  \param height : Height of the point cloud.
+*/
+void vpMbtMultiObjectTracker::track(const vpImage<vpRGBa> &I_color, const std::vector<vpColVector> &pointcloud,
+                                    unsigned int width, unsigned int height)
+{
+  vpImageConvert::convert(I_color, m_I);
+  trackObjects(m_I, &pointcloud, width, height);
+}
+
+/*!
+  Update the shared products and track the objects.
+*/
+void vpMbtMultiObjectTracker::trackObjects(const vpImage<unsigned char> &I,
+                                           const std::vector<vpColVector> *pointcloud, unsigned int width,
+                                           unsigned int height)
+{
+  std::vector<std::string> names;
+  std::vector<vpMbGenericTracker *> trackers;
+  for (std::map<std::string, vpMbGenericTracker *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    names.push_back(it->first);
+    trackers.push_back(it->second);
+  }
+
+  if (m_useSharedGradientLookup) {
+    for (size_t i = 0; i < trackers.size(); i++) {
+      if (trackers[i]->getTrackerType() & vpMbGenericTracker::EDGE_TRACKER) {
+        m_gradientLookup.update(I, trackers[i]->getMovingEdge());
+        break;
+      }
+    }
+  }
+
+  if (m_useOcclusionHandling) {
+    // The objects lost at the previous frame have no reliable pose and do not hide the others
+    std::vector<std::vector<std::vector<std::pair<vpPoint, unsigned int> > > > polygons(trackers.size());
+    for (size_t i = 0; i < trackers.size(); i++) {
+      if (m_mapOfTrackingStatus[names[i]]) {
+        computeOccluders(*trackers[i], polygons[i]);
+      }
+    }
+
+    for (size_t i = 0; i < trackers.size(); i++) {
+      std::vector<std::vector<std::pair<vpPoint, unsigned int> > > occluders;
+      for (size_t j = 0; j < trackers.size(); j++) {
+        if (j != i) {
+          occluders.insert(occluders.end(), polygons[j].begin(), polygons[j].end());
+        }
+      }
+      trackers[i]->setScanLineOccluders(occluders);
+    }
+  }
+
+  std::vector<unsigned char> status(trackers.size(), 0);
+#if defined(VISP_HAVE_OPENMP) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  if (m_useParallelTracking && trackers.size() > 1) {
+    int nb_threads = m_nbParallelThreads > 0 ? static_cast<int>(m_nbParallelThreads) : omp_get_max_threads();
+    int nb_objects = static_cast<int>(trackers.size());
+    // An exception other than vpException must not leave the parallel
+    // region, it is kept and the one of the first object is rethrown as with
+    // the sequential path
+    std::vector<std::exception_ptr> exceptions(trackers.size());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nb_threads)
+    for (int k = 0; k < nb_objects; k++) {
+      const size_t i = static_cast<size_t>(k);
+      try {
+        status[i] = trackObject(*trackers[i], I, pointcloud, width, height) ? 1 : 0;
+      } catch (...) {
+        exceptions[i] = std::current_exception();
+      }
+    }
+
+    for (size_t i = 0; i < exceptions.size(); i++) {
+      if (exceptions[i]) {
+        std::rethrow_exception(exceptions[i]);
+      }
+    }
+  } else
+#endif
+  {
+    for (size_t i = 0; i < trackers.size(); i++) {
+      status[i] = trackObject(*trackers[i], I, pointcloud, width, height) ? 1 : 0;
+    }
+  }
+
+  for (size_t i = 0; i < trackers.size(); i++) {
+    m_mapOfTrackingStatus[names[i]] = (status[i] != 0);
+  }
+}
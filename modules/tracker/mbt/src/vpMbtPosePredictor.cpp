@@ -0,0 +1,278 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Motion model based prediction of the pose of a model-based tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtPosePredictor.cpp
+  \brief Motion model based prediction of the pose of a model-based tracker.
+*/
+
+#include <algorithm>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpExponentialMap.h>
+#include <visp3/mbt/vpMbtPosePredictor.h>
+
+namespace
+{
+// Translation and rotation distances between two poses
+void poseDistance(const vpHomogeneousMatrix &cMo, const vpHomogeneousMatrix &cMo_ref, double &translation,
+                  double &rotation)
+{
+  translation = (cMo.getTranslationVector() - cMo_ref.getTranslationVector()).frobeniusNorm();
+  rotation = (cMo * cMo_ref.inverse()).getThetaUVector().getTheta();
+}
+}
+
+/*!
+  Default constructor, without prediction.
+*/
+vpMbtPosePredictor::vpMbtPosePredictor()
+  : m_model(NO_PREDICTION), m_cMo(), m_nbPoses(0), m_v(6, 0.0), m_v_prev(6, 0.0), m_dt(1.0), m_dt_prev(1.0),
+    m_time(0.0), m_hasNextTime(false), m_nextTime(0.0), m_v_ext(6, 0.0), m_hasExternalVelocity(false),
+    m_hasPrediction(false), m_cMo_pred(), m_nbFrames(0), m_nbIterations(0), m_nbPredictions(0), m_nbMotions(0)
+{
+  m_extWeights[0] = m_extWeights[1] = 1.0;
+  m_motion[0] = m_motion[1] = 0.0;
+  m_predictionError[0] = m_predictionError[1] = 0.0;
+}
+
+/*!
+  Get the mean motion between two consecutive frames, that is the mean
+  distance between the estimated pose and the pose of the previous frame.
+  This is the error of the initial guess of the pose estimation without
+  prediction.
+
+  \param translation : Mean distance between the translations, in meter.
+  \param rotation : Mean angle of the rotation between the poses, in radian.
+*/
+void vpMbtPosePredictor::getMeanMotion(double &translation, double &rotation) const
+{
+  translation = m_nbMotions > 0 ? m_motion[0] / m_nbMotions : 0.0;
+  rotation = m_nbMotions > 0 ? m_motion[1] / m_nbMotions : 0.0;
+}
+
+/*!
+  Get the mean distance between the estimated pose and the predicted pose,
+  over the frames whose pose was predicted.
+
+  \param translation : Mean distance between the translations, in meter.
+  \param rotation : Mean angle of the rotation between the poses, in radian.
+
+  \sa getMeanMotion()
+*/
+void vpMbtPosePredictor::getMeanPredictionError(double &translation, double &rotation) const
+{
+  translation = m_nbPredictions > 0 ? m_predictionError[0] / m_nbPredictions : 0.0;
+  rotation = m_nbPredictions > 0 ? m_predictionError[1] / m_nbPredictions : 0.0;
+}
+
+/*!
+  Predict the pose of the next frame.
+
+  \param cMo : Current pose, usually the last pose given to update(). If it
+  differs, the pose was modified by an initialization of the tracker: the
+  motion history is cleared and no motion is predicted.
+  \param cMo_pred : Predicted pose, \e cMo if there is no prediction.
+
+  \return true if a motion was predicted, false when the prediction is
+  disabled or when the history is too short and there is no external twist.
+*/
+bool vpMbtPosePredictor::predict(const vpHomogeneousMatrix &cMo, vpHomogeneousMatrix &cMo_pred)
+{
+  m_hasPrediction = false;
+  cMo_pred = cMo;
+
+  if (m_nbPoses > 0 && !(cMo == m_cMo)) {
+    m_nbPoses = 0;
+  }
+
+  if (m_model == NO_PREDICTION) {
+    return false;
+  }
+
+  double dt = 1.0;
+  if (m_hasNextTime) {
+    dt = m_nextTime - m_time;
+    if (m_nbPoses == 0 || dt <= 0.0) {
+      return false;
+    }
+  }
+
+  vpColVector v(6, 0.0);
+  bool hasVelocity = false;
+  if (m_nbPoses >= 2) {
+    v = m_v;
+    if (m_model == CONSTANT_ACCELERATION && m_nbPoses >= 3) {
+      // Acceleration at the middle of the last motion, extrapolated to the middle of the next one
+      vpColVector a = (m_v - m_v_prev) * (2.0 / (m_dt + m_dt_prev));
+      v += a * ((m_dt + dt) / 2.0);
+    }
+    hasVelocity = true;
+  }
+
+  if (m_hasExternalVelocity) {
+    for (unsigned int i = 0; i < 6; i++) {
+      const double w = hasVelocity ? m_extWeights[i < 3 ? 0 : 1] : 1.0;
+      v[i] = w * m_v_ext[i] + (1.0 - w) * v[i];
+    }
+    hasVelocity = true;
+  }
+
+  if (!hasVelocity) {
+    return false;
+  }
+
+  cMo_pred = vpExponentialMap::direct(v, dt).inverse() * cMo;
+  m_cMo_pred = cMo_pred;
+  m_hasPrediction = true;
+
+  return true;
+}
+
+/*!
+  Clear the motion history, for instance when the tracking was lost. The
+  timestamp and the external twist given for the next frame are cleared, the
+  statistics are kept.
+
+  \sa resetStatistics()
+*/
+void vpMbtPosePredictor::reset()
+{
+  m_nbPoses = 0;
+  m_hasNextTime = false;
+  m_hasExternalVelocity = false;
+  m_hasPrediction = false;
+}
+
+/*!
+  Reset the statistics on the tracked frames.
+*/
+void vpMbtPosePredictor::resetStatistics()
+{
+  m_nbFrames = 0;
+  m_nbIterations = 0;
+  m_nbPredictions = 0;
+  m_nbMotions = 0;
+  m_motion[0] = m_motion[1] = 0.0;
+  m_predictionError[0] = m_predictionError[1] = 0.0;
+}
+
+/*!
+  Give a measure of the twist of the camera for the next frame, for instance
+  from an IMU or from the odometry of a robot. It is fused with the twist of
+  the motion model for the next prediction only.
+
+  \param c_v : Twist of the camera expressed in the camera frame, in m/s and
+  rad/s when timestamps are given with setTimestamp(), per frame otherwise.
+  \param translationWeight : Weight in [0, 1] of the translational velocity
+  \e c_v[0..2] against the one of the motion model.
+  \param rotationWeight : Weight in [0, 1] of the rotational velocity
+  \e c_v[3..5] against the one of the motion model.
+
+  When the motion history is too short, \e c_v is used as it is.
+*/
+void vpMbtPosePredictor::setExternalVelocity(const vpColVector &c_v, double translationWeight, double rotationWeight)
+{
+  if (c_v.size() != 6) {
+    throw vpException(vpException::dimensionError, "The camera twist must be a 6-dim vector, not %d",
+                      c_v.size());
+  }
+  if (translationWeight < 0.0 || translationWeight > 1.0 || rotationWeight < 0.0 || rotationWeight > 1.0) {
+    throw vpException(vpException::badValue, "The weights of the external twist must be in [0, 1]");
+  }
+
+  m_v_ext = c_v;
+  m_extWeights[0] = translationWeight;
+  m_extWeights[1] = rotationWeight;
+  m_hasExternalVelocity = true;
+}
+
+/*!
+  Set the timestamp of the next frame. When used, it has to be given for
+  every frame, before the prediction.
+
+  \param t : Timestamp in second.
+*/
+void vpMbtPosePredictor::setTimestamp(double t)
+{
+  m_nextTime = t;
+  m_hasNextTime = true;
+}
+
+/*!
+  Add the estimated pose of a frame to the motion history.
+
+  \param cMo : Pose estimated on the frame.
+  \param nbIterations : Number of iterations of the pose estimation, for the
+  statistics.
+*/
+void vpMbtPosePredictor::update(const vpHomogeneousMatrix &cMo, unsigned int nbIterations)
+{
+  const double t = m_hasNextTime ? m_nextTime : m_time + 1.0;
+
+  m_nbFrames++;
+  m_nbIterations += nbIterations;
+
+  double translation = 0.0, rotation = 0.0;
+  if (m_nbPoses > 0) {
+    poseDistance(cMo, m_cMo, translation, rotation);
+    m_motion[0] += translation;
+    m_motion[1] += rotation;
+    m_nbMotions++;
+  }
+  if (m_hasPrediction) {
+    poseDistance(cMo, m_cMo_pred, translation, rotation);
+    m_predictionError[0] += translation;
+    m_predictionError[1] += rotation;
+    m_nbPredictions++;
+  }
+
+  if (m_nbPoses > 0 && t > m_time) {
+    m_v_prev = m_v;
+    m_dt_prev = m_dt;
+    m_dt = t - m_time;
+    // cMo(k) = exp(v dt)^-1 cMo(k-1)
+    m_v = vpExponentialMap::inverse(m_cMo * cMo.inverse(), m_dt);
+    m_nbPoses = (std::min)(m_nbPoses + 1, 3u);
+  } else {
+    m_nbPoses = 1;
+  }
+
+  m_cMo = cMo;
+  m_time = t;
+  m_hasNextTime = false;
+  m_hasExternalVelocity = false;
+  m_hasPrediction = false;
+}
@@ -0,0 +1,570 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Record and replay of the inputs of a model-based tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtSequence.cpp
+  \brief Record and replay of the inputs of a model-based tracker.
+*/
+
+#include <cstddef>
+#include <cstring>
+
+#include <visp3/core/vpException.h>
+#include <visp3/mbt/vpMbtSequence.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Layout of a sequence, all the values are in the byte order of the machine that wrote it:
+// - header: magic, version, byte order mark, model file, reference camera name, depth scale, then for each
+//   camera its name, its projection model, px, py, u0, v0, kud, kdu and the 16 values of its transformation
+// - the frames, each one given by the size of its content as an uint64_t followed by the timestamp, the pose
+//   flag, the 16 values of the pose, the number of streams and the streams
+// - a stream is its type, the camera name, the width, the height and the pixels or the points
+// The strings are stored as their length followed by their characters.
+const char sequence_magic[8] = {'V', 'I', 'S', 'P', 'M', 'S', 'E', 'Q'};
+const unsigned int sequence_version = 1;
+const unsigned int sequence_byte_order = 0x01020304;
+
+typedef enum { GREY_STREAM, COLOR_STREAM, DEPTH_STREAM, POINT_CLOUD_STREAM } vpStreamType;
+
+template <typename Type> void append(std::vector<char> &buffer, const Type *values, size_t nb)
+{
+  if (nb > 0) {
+    const size_t offset = buffer.size();
+    buffer.resize(offset + nb * sizeof(Type));
+    memcpy(&buffer[offset], values, nb * sizeof(Type));
+  }
+}
+
+template <typename Type> void append(std::vector<char> &buffer, const Type &value) { append(buffer, &value, 1); }
+
+void appendString(std::vector<char> &buffer, const std::string &str)
+{
+  append(buffer, static_cast<unsigned int>(str.size()));
+  append(buffer, str.c_str(), str.size());
+}
+
+void appendStreamHeader(std::vector<char> &buffer, vpStreamType type, const std::string &cameraName,
+                        unsigned int width, unsigned int height)
+{
+  append(buffer, static_cast<unsigned int>(type));
+  appendString(buffer, cameraName);
+  append(buffer, width);
+  append(buffer, height);
+}
+
+// Copies nb values at an offset of a buffer, after checking that they are in the buffer
+template <typename Type> void extract(const std::vector<char> &buffer, size_t &offset, Type *values, size_t nb)
+{
+  const size_t bytes = nb * sizeof(Type);
+  if (nb > (buffer.size() - offset) / sizeof(Type)) {
+    throw vpException(vpException::ioError, "Truncated sequence");
+  }
+  if (bytes > 0) {
+    memcpy(values, &buffer[offset], bytes);
+  }
+  offset += bytes;
+}
+
+template <typename Type> Type extract(const std::vector<char> &buffer, size_t &offset)
+{
+  Type value;
+  extract(buffer, offset, &value, 1);
+  return value;
+}
+
+std::string extractString(const std::vector<char> &buffer, size_t &offset)
+{
+  const unsigned int length = extract<unsigned int>(buffer, offset);
+  if (length > buffer.size() - offset) {
+    throw vpException(vpException::ioError, "Truncated sequence");
+  }
+  std::string str(buffer.begin() + static_cast<std::ptrdiff_t>(offset),
+                  buffer.begin() + static_cast<std::ptrdiff_t>(offset + length));
+  offset += length;
+  return str;
+}
+
+template <typename Type> Type readValue(std::ifstream &file)
+{
+  Type value;
+  if (!file.read(reinterpret_cast<char *>(&value), sizeof(Type))) {
+    throw vpException(vpException::ioError, "Truncated sequence");
+  }
+  return value;
+}
+
+std::string readString(std::ifstream &file, std::streamoff fileSize)
+{
+  const unsigned int length = readValue<unsigned int>(file);
+  if (static_cast<std::streamoff>(length) > fileSize - static_cast<std::streamoff>(file.tellg())) {
+    throw vpException(vpException::ioError, "Truncated sequence");
+  }
+  std::string str(length, '\0');
+  if (length > 0 && !file.read(&str[0], static_cast<std::streamsize>(length))) {
+    throw vpException(vpException::ioError, "Truncated sequence");
+  }
+  return str;
+}
+
+// Reads nb bytes of the file in the buffer
+void readBuffer(std::ifstream &file, std::vector<char> &buffer, size_t nb)
+{
+  buffer.resize(nb);
+  if (nb > 0 && !file.read(&buffer[0], static_cast<std::streamsize>(nb))) {
+    throw vpException(vpException::ioError, "Truncated sequence");
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Remove the images and the point clouds of the frame and reset its
+  timestamp and its pose.
+*/
+void vpMbtSequenceFrame::clear()
+{
+  timestamp = -1.0;
+  hasPose = false;
+  cMo.eye();
+  images.clear();
+  colorImages.clear();
+  depthImages.clear();
+  pointClouds.clear();
+  pointCloudWidths.clear();
+  pointCloudHeights.clear();
+}
+
+/*!
+  Default constructor, open() has to be called before recording.
+*/
+vpMbtSequenceRecorder::vpMbtSequenceRecorder() : m_file(), m_nbFrames(0), m_buffer() {}
+
+/*!
+  Destructor, closes the sequence file.
+*/
+vpMbtSequenceRecorder::~vpMbtSequenceRecorder() { close(); }
+
+/*!
+  Flush and close the sequence file.
+*/
+void vpMbtSequenceRecorder::close()
+{
+  if (m_file.is_open()) {
+    m_file.close();
+  }
+}
+
+/*!
+  Create a sequence file and write the description of the setup.
+
+  \param filename : Name of the sequence file, overwritten if it exists.
+  \param modelFile : Model file of the tracked object, only its name is
+  stored.
+  \param mapOfCameraParameters : Camera parameters, by camera name.
+  \param mapOfCameraTransformations : Transformations from the reference
+  camera to the cameras, by camera name, see
+  vpMbGenericTracker::setCameraTransformationMatrix(). A camera without
+  transformation is given the identity.
+  \param referenceCameraName : Name of the reference camera.
+  \param depthScale : Scale from the raw depth values to meters.
+
+  \throw vpException::ioError if the file cannot be created.
+  \throw vpException::badValue if a camera model is not supported.
+*/
+void vpMbtSequenceRecorder::open(const std::string &filename, const std::string &modelFile,
+                                 const std::map<std::string, vpCameraParameters> &mapOfCameraParameters,
+                                 const std::map<std::string, vpHomogeneousMatrix> &mapOfCameraTransformations,
+                                 const std::string &referenceCameraName, double depthScale)
+{
+  close();
+  m_nbFrames = 0;
+
+  m_buffer.clear();
+  append(m_buffer, sequence_magic, sizeof(sequence_magic));
+  append(m_buffer, sequence_version);
+  append(m_buffer, sequence_byte_order);
+  appendString(m_buffer, modelFile);
+  appendString(m_buffer, referenceCameraName);
+  append(m_buffer, depthScale);
+  append(m_buffer, static_cast<unsigned int>(mapOfCameraParameters.size()));
+  for (std::map<std::string, vpCameraParameters>::const_iterator it = mapOfCameraParameters.begin();
+       it != mapOfCameraParameters.end(); ++it) {
+    const vpCameraParameters &cam = it->second;
+    if (cam.get_projModel() != vpCameraParameters::perspectiveProjWithoutDistortion &&
+        cam.get_projModel() != vpCameraParameters::perspectiveProjWithDistortion) {
+      throw vpException(vpException::badValue, "Unsupported projection model for the camera %s", it->first.c_str());
+    }
+    appendString(m_buffer, it->first);
+    append(m_buffer, static_cast<unsigned int>(cam.get_projModel()));
+    const double values[6] = {cam.get_px(), cam.get_py(), cam.get_u0(), cam.get_v0(), cam.get_kud(), cam.get_kdu()};
+    append(m_buffer, values, 6);
+
+    std::map<std::string, vpHomogeneousMatrix>::const_iterator it_M = mapOfCameraTransformations.find(it->first);
+    const vpHomogeneousMatrix M = it_M != mapOfCameraTransformations.end() ? it_M->second : vpHomogeneousMatrix();
+    append(m_buffer, M.data, 16);
+  }
+
+  m_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_file || !m_file.write(&m_buffer[0], static_cast<std::streamsize>(m_buffer.size()))) {
+    close();
+    throw vpException(vpException::ioError, "Cannot create the sequence %s", filename.c_str());
+  }
+}
+
+/*!
+  Append a frame to the sequence.
+
+  \param frame : Frame to record. The point clouds must contain as many
+  points as given by their width and height.
+
+  \throw vpException::fatalError if no sequence is open.
+  \throw vpException::dimensionError if a point cloud is inconsistent.
+  \throw vpException::ioError if the frame cannot be written.
+*/
+void vpMbtSequenceRecorder::record(const vpMbtSequenceFrame &frame)
+{
+  if (!m_file.is_open()) {
+    throw vpException(vpException::fatalError, "No sequence is open");
+  }
+
+  m_buffer.clear();
+  append(m_buffer, frame.timestamp);
+  append(m_buffer, static_cast<unsigned int>(frame.hasPose ? 1 : 0));
+  append(m_buffer, frame.cMo.data, 16);
+  append(m_buffer, static_cast<unsigned int>(frame.images.size() + frame.colorImages.size() +
+                                             frame.depthImages.size() + frame.pointClouds.size()));
+
+  for (std::map<std::string, vpImage<unsigned char> >::const_iterator it = frame.images.begin();
+       it != frame.images.end(); ++it) {
+    appendStreamHeader(m_buffer, GREY_STREAM, it->first, it->second.getWidth(), it->second.getHeight());
+    append(m_buffer, it->second.bitmap, it->second.getSize());
+  }
+
+  for (std::map<std::string, vpImage<vpRGBa> >::const_iterator it = frame.colorImages.begin();
+       it != frame.colorImages.end(); ++it) {
+    appendStreamHeader(m_buffer, COLOR_STREAM, it->first, it->second.getWidth(), it->second.getHeight());
+    const size_t offset = m_buffer.size();
+    m_buffer.resize(offset + 3 * static_cast<size_t>(it->second.getSize()));
+    char *dst = m_buffer.empty() ? NULL : &m_buffer[offset];
+    for (unsigned int k = 0; k < it->second.getSize(); k++) {
+      const vpRGBa &rgba = it->second.bitmap[k];
+      dst[3 * k] = static_cast<char>(rgba.R);
+      dst[3 * k + 1] = static_cast<char>(rgba.G);
+      dst[3 * k + 2] = static_cast<char>(rgba.B);
+    }
+  }
+
+  for (std::map<std::string, vpImage<uint16_t> >::const_iterator it = frame.depthImages.begin();
+       it != frame.depthImages.end(); ++it) {
+    appendStreamHeader(m_buffer, DEPTH_STREAM, it->first, it->second.getWidth(), it->second.getHeight());
+    append(m_buffer, it->second.bitmap, it->second.getSize());
+  }
+
+  for (std::map<std::string, std::vector<vpColVector> >::const_iterator it = frame.pointClouds.begin();
+       it != frame.pointClouds.end(); ++it) {
+    std::map<std::string, unsigned int>::const_iterator it_width = frame.pointCloudWidths.find(it->first);
+    std::map<std::string, unsigned int>::const_iterator it_height = frame.pointCloudHeights.find(it->first);
+    const unsigned int width = it_width != frame.pointCloudWidths.end() ? it_width->second : 0;
+    const unsigned int height = it_height != frame.pointCloudHeights.end() ? it_height->second : 0;
+    if (static_cast<size_t>(width) * height != it->second.size()) {
+      throw vpException(vpException::dimensionError, "The point cloud of the camera %s has %d points, not %dx%d",
+                        it->first.c_str(), static_cast<int>(it->second.size()), width, height);
+    }
+
+    appendStreamHeader(m_buffer, POINT_CLOUD_STREAM, it->first, width, height);
+    const size_t offset = m_buffer.size();
+    m_buffer.resize(offset + 3 * sizeof(float) * it->second.size());
+    for (size_t k = 0; k < it->second.size(); k++) {
+      const vpColVector &pt = it->second[k];
+      const float xyz[3] = {pt.size() > 0 ? static_cast<float>(pt[0]) : 0.0f,
+                            pt.size() > 1 ? static_cast<float>(pt[1]) : 0.0f,
+                            pt.size() > 2 ? static_cast<float>(pt[2]) : 0.0f};
+      memcpy(&m_buffer[offset + 3 * sizeof(float) * k], xyz, sizeof(xyz));
+    }
+  }
+
+  const uint64_t size = m_buffer.size();
+  m_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  if (!m_file.write(&m_buffer[0], static_cast<std::streamsize>(m_buffer.size()))) {
+    throw vpException(vpException::ioError, "Cannot write the frame %d of the sequence", m_nbFrames);
+  }
+  m_nbFrames++;
+}
+
+/*!
+  Default constructor, open() has to be called before reading.
+*/
+vpMbtSequencePlayer::vpMbtSequencePlayer()
+  : m_file(), m_modelFile(), m_referenceCameraName(), m_mapOfCameraParameters(), m_mapOfCameraTransformations(),
+    m_depthScale(0.001), m_frameOffsets(), m_frameIndex(0), m_buffer()
+{
+}
+
+/*!
+  Destructor, closes the sequence file.
+*/
+vpMbtSequencePlayer::~vpMbtSequencePlayer() { close(); }
+
+/*!
+  Read the next frame of the sequence.
+
+  \param frame : Frame read. Its images and point clouds are reused when
+  their size does not change.
+
+  \return false at the end of the sequence.
+
+  \throw vpException::ioError if the frame is corrupted.
+*/
+bool vpMbtSequencePlayer::acquire(vpMbtSequenceFrame &frame)
+{
+  if (!m_file.is_open() || m_frameIndex >= m_frameOffsets.size()) {
+    return false;
+  }
+
+  m_file.clear();
+  m_file.seekg(m_frameOffsets[m_frameIndex]);
+  uint64_t size = 0;
+  if (!m_file.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+    throw vpException(vpException::ioError, "Cannot read the frame %d of the sequence", m_frameIndex);
+  }
+  readBuffer(m_file, m_buffer, static_cast<size_t>(size));
+  m_frameIndex++;
+
+  size_t offset = 0;
+  frame.timestamp = extract<double>(m_buffer, offset);
+  frame.hasPose = extract<unsigned int>(m_buffer, offset) != 0;
+  extract(m_buffer, offset, frame.cMo.data, 16);
+
+  std::map<std::string, vpImage<unsigned char> > images;
+  std::map<std::string, vpImage<vpRGBa> > colorImages;
+  std::map<std::string, vpImage<uint16_t> > depthImages;
+  std::map<std::string, std::vector<vpColVector> > pointClouds;
+  // Keep the buffers of the previous frame
+  images.swap(frame.images);
+  colorImages.swap(frame.colorImages);
+  depthImages.swap(frame.depthImages);
+  pointClouds.swap(frame.pointClouds);
+  frame.pointCloudWidths.clear();
+  frame.pointCloudHeights.clear();
+
+  const unsigned int nbStreams = extract<unsigned int>(m_buffer, offset);
+  for (unsigned int s = 0; s < nbStreams; s++) {
+    const unsigned int type = extract<unsigned int>(m_buffer, offset);
+    const std::string cameraName = extractString(m_buffer, offset);
+    const unsigned int width = extract<unsigned int>(m_buffer, offset);
+    const unsigned int height = extract<unsigned int>(m_buffer, offset);
+    const size_t nbPixels = static_cast<size_t>(width) * height;
+
+    switch (type) {
+    case GREY_STREAM: {
+      vpImage<unsigned char> &I = frame.images[cameraName];
+      swap(I, images[cameraName]);
+      if (nbPixels > m_buffer.size() - offset) {
+        throw vpException(vpException::ioError, "Truncated sequence");
+      }
+      I.resize(height, width);
+      extract(m_buffer, offset, I.bitmap, nbPixels);
+      break;
+    }
+
+    case COLOR_STREAM: {
+      vpImage<vpRGBa> &I = frame.colorImages[cameraName];
+      swap(I, colorImages[cameraName]);
+      if (nbPixels > (m_buffer.size() - offset) / 3) {
+        throw vpException(vpException::ioError, "Truncated sequence");
+      }
+      I.resize(height, width);
+      const unsigned char *src = reinterpret_cast<const unsigned char *>(&m_buffer[offset]);
+      for (size_t k = 0; k < nbPixels; k++) {
+        I.bitmap[k] = vpRGBa(src[3 * k], src[3 * k + 1], src[3 * k + 2], vpRGBa::alpha_default);
+      }
+      offset += 3 * nbPixels;
+      break;
+    }
+
+    case DEPTH_STREAM: {
+      vpImage<uint16_t> &I = frame.depthImages[cameraName];
+      swap(I, depthImages[cameraName]);
+      if (nbPixels > (m_buffer.size() - offset) / sizeof(uint16_t)) {
+        throw vpException(vpException::ioError, "Truncated sequence");
+      }
+      I.resize(height, width);
+      extract(m_buffer, offset, I.bitmap, nbPixels);
+      break;
+    }
+
+    case POINT_CLOUD_STREAM: {
+      std::vector<vpColVector> &pointcloud = frame.pointClouds[cameraName];
+      pointcloud.swap(pointClouds[cameraName]);
+      if (nbPixels > (m_buffer.size() - offset) / (3 * sizeof(float))) {
+        throw vpException(vpException::ioError, "Truncated sequence");
+      }
+      pointcloud.resize(nbPixels);
+      for (size_t k = 0; k < nbPixels; k++) {
+        float xyz[3];
+        extract(m_buffer, offset, xyz, 3);
+        vpColVector &pt = pointcloud[k];
+        if (pt.size() != 3) {
+          pt.resize(3, false);
+        }
+        pt[0] = xyz[0];
+        pt[1] = xyz[1];
+        pt[2] = xyz[2];
+      }
+      frame.pointCloudWidths[cameraName] = width;
+      frame.pointCloudHeights[cameraName] = height;
+      break;
+    }
+
+    default:
+      throw vpException(vpException::ioError, "Unknown stream type %d in the sequence", type);
+    }
+  }
+
+  return true;
+}
+
+/*!
+  Close the sequence file.
+*/
+void vpMbtSequencePlayer::close()
+{
+  if (m_file.is_open()) {
+    m_file.close();
+  }
+  m_frameOffsets.clear();
+  m_frameIndex = 0;
+}
+
+/*!
+  Open a sequence, read the description of the setup and index the frames.
+  An incomplete last frame, for instance when the recording was interrupted,
+  is ignored.
+
+  \param filename : Name of the sequence file.
+
+  \throw vpException::ioError if the file cannot be read, is not a sequence,
+  was written on a machine with another byte order or is corrupted.
+*/
+void vpMbtSequencePlayer::open(const std::string &filename)
+{
+  close();
+  m_mapOfCameraParameters.clear();
+  m_mapOfCameraTransformations.clear();
+
+  m_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!m_file) {
+    throw vpException(vpException::ioError, "Cannot open the sequence %s", filename.c_str());
+  }
+  m_file.seekg(0, std::ios::end);
+  const std::streamoff fileSize = m_file.tellg();
+  m_file.seekg(0, std::ios::beg);
+
+  try {
+    char magic[sizeof(sequence_magic)];
+    if (!m_file.read(magic, sizeof(magic)) || memcmp(magic, sequence_magic, sizeof(sequence_magic)) != 0) {
+      throw vpException(vpException::ioError, "%s is not a sequence", filename.c_str());
+    }
+    const unsigned int version = readValue<unsigned int>(m_file);
+    const unsigned int byteOrder = readValue<unsigned int>(m_file);
+    if (byteOrder != sequence_byte_order) {
+      throw vpException(vpException::ioError, "The sequence was written with another byte order");
+    }
+    if (version != sequence_version) {
+      throw vpException(vpException::ioError, "Unsupported sequence version %d", version);
+    }
+
+    m_modelFile = readString(m_file, fileSize);
+    m_referenceCameraName = readString(m_file, fileSize);
+    m_depthScale = readValue<double>(m_file);
+    const unsigned int nbCameras = readValue<unsigned int>(m_file);
+    for (unsigned int i = 0; i < nbCameras; i++) {
+      const std::string name = readString(m_file, fileSize);
+      const unsigned int projModel = readValue<unsigned int>(m_file);
+      double values[6];
+      for (unsigned int k = 0; k < 6; k++) {
+        values[k] = readValue<double>(m_file);
+      }
+      vpCameraParameters cam;
+      if (projModel == vpCameraParameters::perspectiveProjWithoutDistortion) {
+        cam.initPersProjWithoutDistortion(values[0], values[1], values[2], values[3]);
+      } else if (projModel == vpCameraParameters::perspectiveProjWithDistortion) {
+        cam.initPersProjWithDistortion(values[0], values[1], values[2], values[3], values[4], values[5]);
+      } else {
+        throw vpException(vpException::ioError, "Unsupported projection model %d in the sequence", projModel);
+      }
+      m_mapOfCameraParameters[name] = cam;
+
+      vpHomogeneousMatrix M;
+      for (unsigned int k = 0; k < 16; k++) {
+        M.data[k] = readValue<double>(m_file);
+      }
+      m_mapOfCameraTransformations[name] = M;
+    }
+
+    // Index the frames from their sizes, without reading them
+    std::streamoff position = m_file.tellg();
+    while (fileSize - position >= static_cast<std::streamoff>(sizeof(uint64_t))) {
+      m_file.seekg(position);
+      const uint64_t size = readValue<uint64_t>(m_file);
+      if (size > static_cast<uint64_t>(fileSize - position - static_cast<std::streamoff>(sizeof(uint64_t)))) {
+        break;
+      }
+      m_frameOffsets.push_back(position);
+      position += static_cast<std::streamoff>(sizeof(uint64_t) + size);
+    }
+  } catch (...) {
+    close();
+    throw;
+  }
+}
+
+/*!
+  Move to a frame of the sequence.
+
+  \param frameIndex : Index of the frame the next call to acquire() will
+  read.
+
+  \throw vpException::badValue if the index is out of the sequence.
+*/
+void vpMbtSequencePlayer::seek(unsigned int frameIndex)
+{
+  if (frameIndex > m_frameOffsets.size()) {
+    throw vpException(vpException::badValue, "The sequence has only %d frames", getNbFrames());
+  }
+  m_frameIndex = frameIndex;
+}
@@ -0,0 +1,579 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Asynchronous pipelined front-end of the generic model-based tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMbtTrackingPipeline.cpp
+  \brief Asynchronous pipelined front-end of the generic model-based tracker.
+*/
+
+#include <visp3/mbt/vpMbtTrackingPipeline.h>
+
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpTime.h>
+
+/*!
+  Create the pipeline and start its threads.
+
+  \param tracker : Initialized tracker. The camera parameters of the tracker
+  are read here and used to convert the depth maps.
+  \param queueSize : Capacity of the input queue and of the queue of the
+  preprocessed frames, at least 1.
+  \param policy : Behaviour of push() and of the preprocessing stage when
+  the next queue is full.
+*/
+vpMbtTrackingPipeline::vpMbtTrackingPipeline(vpMbGenericTracker &tracker, unsigned int queueSize,
+                                             const vpQueuePolicy &policy)
+  : m_tracker(tracker), m_referenceCameraName(tracker.getReferenceCameraName()), m_mapOfCameraParameters(),
+    m_depthScale(0.001), m_queueSize(queueSize), m_policy(policy), m_mutex(), m_inputCondition(),
+    m_readyCondition(), m_spaceCondition(), m_doneCondition(), m_inputQueue(), m_readyQueue(), m_stop(false),
+    m_nbPushed(0), m_nbDropped(0), m_nbTracked(0), m_nbFailed(0), m_preprocessingTime(0.0), m_nbPreprocessed(0),
+    m_trackingTime(0.0), m_pointCloudPool(), m_preprocessingThread(), m_trackingThread()
+{
+  if (queueSize == 0) {
+    throw vpException(vpException::badValue, "The queue size of the tracking pipeline must be at least 1");
+  }
+
+  tracker.getCameraParameters(m_mapOfCameraParameters);
+
+  m_preprocessingThread = std::thread(&vpMbtTrackingPipeline::preprocessingLoop, this);
+  m_trackingThread = std::thread(&vpMbtTrackingPipeline::trackingLoop, this);
+}
+
+/*!
+  Stop the threads. The frame being tracked is completed, the frames still
+  in the queues are dropped.
+*/
+vpMbtTrackingPipeline::~vpMbtTrackingPipeline()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_inputCondition.notify_all();
+  m_readyCondition.notify_all();
+  m_spaceCondition.notify_all();
+
+  m_preprocessingThread.join();
+  m_trackingThread.join();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (size_t i = 0; i < m_inputQueue.size(); i++) {
+    drop(m_inputQueue[i]);
+  }
+  for (size_t i = 0; i < m_readyQueue.size(); i++) {
+    drop(m_readyQueue[i]);
+  }
+  m_inputQueue.clear();
+  m_readyQueue.clear();
+}
+
+/*!
+  Convert a depth map to the point cloud expected by
+  vpMbGenericTracker::track(). Pixels without depth give a null point.
+
+  \param I_depth : Raw depth map.
+  \param cam : Camera parameters of the depth camera.
+  \param depthScale : Scale from the raw depth values to meters.
+  \param pointcloud : Point cloud, one 3-dim vector per pixel, in row-major
+  order.
+*/
+void vpMbtTrackingPipeline::convertDepthToPointCloud(const vpImage<uint16_t> &I_depth, const vpCameraParameters &cam,
+                                                     double depthScale, std::vector<vpColVector> &pointcloud)
+{
+  const unsigned int height = I_depth.getHeight(), width = I_depth.getWidth();
+  pointcloud.resize(static_cast<size_t>(height) * width);
+
+  // Without distortion the normalized coordinates are separable
+  const bool separable = cam.get_projModel() == vpCameraParameters::perspectiveProjWithoutDistortion;
+  std::vector<double> xs(separable ? width : 0), ys(separable ? height : 0);
+  for (unsigned int j = 0; j < xs.size(); j++) {
+    double y = 0.0;
+    vpPixelMeterConversion::convertPoint(cam, j, 0, xs[j], y);
+  }
+  for (unsigned int i = 0; i < ys.size(); i++) {
+    double x = 0.0;
+    vpPixelMeterConversion::convertPoint(cam, 0, i, x, ys[i]);
+  }
+
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      vpColVector &pt = pointcloud[static_cast<size_t>(i) * width + j];
+      if (pt.size() != 3) {
+        pt.resize(3, false);
+      }
+
+      const double Z = I_depth[i][j] * depthScale;
+      if (Z > 0.0) {
+        double x = 0.0, y = 0.0;
+        if (separable) {
+          x = xs[j];
+          y = ys[i];
+        } else {
+          vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+        }
+        pt[0] = x * Z;
+        pt[1] = y * Z;
+        pt[2] = Z;
+      } else {
+        pt = 0;
+      }
+    }
+  }
+}
+
+/*!
+  Drop a frame. The mutex must be locked.
+*/
+void vpMbtTrackingPipeline::drop(const vpFramePtr &frame)
+{
+  vpTrackingResult result;
+  result.frameIndex = frame->index;
+  result.timestamp = frame->timestamp;
+  result.dropped = true;
+  result.latency = vpTime::measureTimeMs() - frame->pushTime;
+  frame->promise.set_value(result);
+
+  m_nbDropped++;
+  m_doneCondition.notify_all();
+}
+
+/*!
+  Add a frame to the input queue.
+*/
+std::future<vpMbtTrackingPipeline::vpTrackingResult> vpMbtTrackingPipeline::enqueue(const vpFramePtr &frame)
+{
+  std::future<vpTrackingResult> future = frame->promise.get_future();
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    frame->index = m_nbPushed++;
+
+    if (m_policy == BLOCK_WHEN_FULL) {
+      m_spaceCondition.wait(lock, [this] { return m_stop || m_inputQueue.size() < m_queueSize; });
+    } else if (m_inputQueue.size() >= m_queueSize) {
+      drop(m_inputQueue.front());
+      m_inputQueue.pop_front();
+    }
+
+    if (m_stop) {
+      drop(frame);
+      return future;
+    }
+    m_inputQueue.push_back(frame);
+  }
+  m_inputCondition.notify_one();
+
+  return future;
+}
+
+/*!
+  Add a preprocessed frame to the queue of the tracking stage.
+*/
+void vpMbtTrackingPipeline::enqueueReady(const vpFramePtr &frame)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_policy == BLOCK_WHEN_FULL) {
+      m_spaceCondition.wait(lock, [this] { return m_stop || m_readyQueue.size() < m_queueSize; });
+    } else if (m_readyQueue.size() >= m_queueSize) {
+      drop(m_readyQueue.front());
+      m_readyQueue.pop_front();
+    }
+
+    if (m_stop) {
+      drop(frame);
+      return;
+    }
+    m_readyQueue.push_back(frame);
+  }
+  m_readyCondition.notify_one();
+}
+
+/*!
+  Wait until the results of all the frames given to push() are delivered.
+  The tracker can then be used directly, until the next call to push().
+*/
+void vpMbtTrackingPipeline::flush()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_doneCondition.wait(lock, [this] { return m_nbDropped + m_nbTracked + m_nbFailed == m_nbPushed; });
+}
+
+/*!
+  \return The mean time of the preprocessing of a frame, in milliseconds.
+*/
+double vpMbtTrackingPipeline::getMeanPreprocessingTime() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_nbPreprocessed > 0 ? m_preprocessingTime / m_nbPreprocessed : 0.0;
+}
+
+/*!
+  \return The mean time of the tracking of a frame, in milliseconds.
+*/
+double vpMbtTrackingPipeline::getMeanTrackingTime() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const unsigned int nbFrames = m_nbTracked + m_nbFailed;
+  return nbFrames > 0 ? m_trackingTime / nbFrames : 0.0;
+}
+
+/*!
+  \return The number of frames dropped because a queue was full.
+*/
+unsigned int vpMbtTrackingPipeline::getNbDropped() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_nbDropped;
+}
+
+/*!
+  \return The number of frames whose processing threw an exception.
+*/
+unsigned int vpMbtTrackingPipeline::getNbFailed() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_nbFailed;
+}
+
+/*!
+  \return The number of frames given to push().
+*/
+unsigned int vpMbtTrackingPipeline::getNbPushed() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_nbPushed;
+}
+
+/*!
+  \return The number of successfully tracked frames.
+*/
+unsigned int vpMbtTrackingPipeline::getNbTracked() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_nbTracked;
+}
+
+/*!
+  Convert the color images to grey level and the depth maps to point clouds.
+*/
+void vpMbtTrackingPipeline::preprocess(vpFrame &frame, double depthScale) const
+{
+  for (std::map<std::string, vpImage<vpRGBa> >::const_iterator it = frame.colorImages.begin();
+       it != frame.colorImages.end(); ++it) {
+    vpImageConvert::convert(it->second, frame.images[it->first]);
+  }
+  frame.colorImages.clear();
+
+  for (std::map<std::string, vpImage<uint16_t> >::const_iterator it = frame.depthImages.begin();
+       it != frame.depthImages.end(); ++it) {
+    std::map<std::string, vpCameraParameters>::const_iterator it_cam = m_mapOfCameraParameters.find(it->first);
+    if (it_cam == m_mapOfCameraParameters.end()) {
+      throw vpException(vpException::badValue, "There is no camera %s in the tracker", it->first.c_str());
+    }
+    convertDepthToPointCloud(it->second, it_cam->second, depthScale, frame.pointClouds[it->first]);
+  }
+  frame.depthImages.clear();
+}
+
+/*!
+  Thread of the preprocessing stage.
+*/
+void vpMbtTrackingPipeline::preprocessingLoop()
+{
+  while (true) {
+    vpFramePtr frame;
+    double depthScale = 0.0;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_inputCondition.wait(lock, [this] { return m_stop || !m_inputQueue.empty(); });
+      if (m_stop) {
+        return;
+      }
+      frame = m_inputQueue.front();
+      m_inputQueue.pop_front();
+      depthScale = m_depthScale;
+
+      // Reuse the point clouds of a tracked frame, the points are allocated only once
+      for (std::map<std::string, vpImage<uint16_t> >::const_iterator it = frame->depthImages.begin();
+           it != frame->depthImages.end(); ++it) {
+        frame->pointClouds[it->first].swap(m_pointCloudPool[it->first]);
+      }
+    }
+    m_spaceCondition.notify_all();
+
+    const double t = vpTime::measureTimeMs();
+    try {
+      preprocess(*frame, depthScale);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      frame->promise.set_exception(std::current_exception());
+      m_nbFailed++;
+      m_doneCondition.notify_all();
+      continue;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_preprocessingTime += vpTime::measureTimeMs() - t;
+      m_nbPreprocessed++;
+    }
+    enqueueReady(frame);
+  }
+}
+
+/*!
+  Set the scale from the raw depth values given to push() to meters, 0.001
+  by default for depth maps in millimeters.
+
+  \param scale : Depth scale, must be positive.
+*/
+void vpMbtTrackingPipeline::setDepthScale(double scale)
+{
+  if (scale <= 0.0) {
+    throw vpException(vpException::badValue, "The depth scale must be positive");
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_depthScale = scale;
+}
+
+/*!
+  Track a preprocessed frame.
+*/
+void vpMbtTrackingPipeline::trackFrame(vpFrame &frame, vpTrackingResult &result)
+{
+  std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
+  for (std::map<std::string, vpImage<unsigned char> >::const_iterator it = frame.images.begin();
+       it != frame.images.end(); ++it) {
+    mapOfImages[it->first] = &it->second;
+  }
+
+  if (frame.timestamp >= 0.0) {
+    m_tracker.getPosePredictor().setTimestamp(frame.timestamp);
+  }
+
+  if (frame.pointClouds.empty()) {
+    m_tracker.track(mapOfImages);
+  } else {
+    std::map<std::string, const std::vector<vpColVector> *> mapOfPointClouds;
+    std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
+    for (std::map<std::string, std::vector<vpColVector> >::const_iterator it = frame.pointClouds.begin();
+         it != frame.pointClouds.end(); ++it) {
+      mapOfPointClouds[it->first] = &it->second;
+    }
+    for (std::map<std::string, unsigned int>::const_iterator it = frame.depthWidths.begin();
+         it != frame.depthWidths.end(); ++it) {
+      mapOfWidths[it->first] = it->second;
+      mapOfHeights[it->first] = frame.depthHeights[it->first];
+    }
+    m_tracker.track(mapOfImages, mapOfPointClouds, mapOfWidths, mapOfHeights);
+  }
+
+  result.frameIndex = frame.index;
+  result.timestamp = frame.timestamp;
+  result.cMo = m_tracker.getPose();
+  result.projectionError = m_tracker.getProjectionError();
+  result.statistics = m_tracker.getTrackingStatistics();
+}
+
+/*!
+  Thread of the tracking stage.
+*/
+void vpMbtTrackingPipeline::trackingLoop()
+{
+  while (true) {
+    vpFramePtr frame;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_readyCondition.wait(lock, [this] { return m_stop || !m_readyQueue.empty(); });
+      if (m_stop) {
+        return;
+      }
+      frame = m_readyQueue.front();
+      m_readyQueue.pop_front();
+    }
+    m_spaceCondition.notify_all();
+
+    const double t = vpTime::measureTimeMs();
+    vpTrackingResult result;
+    bool success = true;
+    try {
+      trackFrame(*frame, result);
+    } catch (...) {
+      success = false;
+      frame->promise.set_exception(std::current_exception());
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (std::map<std::string, std::vector<vpColVector> >::iterator it = frame->pointClouds.begin();
+         it != frame->pointClouds.end(); ++it) {
+      m_pointCloudPool[it->first].swap(it->second);
+    }
+
+    const double t_end = vpTime::measureTimeMs();
+    m_trackingTime += t_end - t;
+    if (success) {
+      result.latency = t_end - frame->pushTime;
+      frame->promise.set_value(result);
+      m_nbTracked++;
+    } else {
+      m_nbFailed++;
+    }
+    m_doneCondition.notify_all();
+  }
+}
+
+/*!
+  Push a grey level image of the reference camera.
+
+  \param I : Image, copied.
+  \param timestamp : Timestamp of the image in second, given to the pose
+  predictor when positive.
+
+  \return The future result of the tracking of the image.
+*/
+std::future<vpMbtTrackingPipeline::vpTrackingResult> vpMbtTrackingPipeline::push(const vpImage<unsigned char> &I,
+                                                                                   double timestamp)
+{
+  vpFramePtr frame = std::make_shared<vpFrame>();
+  frame->timestamp = timestamp;
+  frame->pushTime = vpTime::measureTimeMs();
+  frame->images[m_referenceCameraName] = I;
+  return enqueue(frame);
+}
+
+/*!
+  Push a color image of the reference camera.
+
+  \param I_color : Image, copied and converted to grey level by the
+  preprocessing stage.
+  \param timestamp : Timestamp of the image in second, given to the pose
+  predictor when positive.
+
+  \return The future result of the tracking of the image.
+*/
+std::future<vpMbtTrackingPipeline::vpTrackingResult> vpMbtTrackingPipeline::push(const vpImage<vpRGBa> &I_color,
+                                                                                   double timestamp)
+{
+  vpFramePtr frame = std::make_shared<vpFrame>();
+  frame->timestamp = timestamp;
+  frame->pushTime = vpTime::measureTimeMs();
+  frame->colorImages[m_referenceCameraName] = I_color;
+  return enqueue(frame);
+}
+
+/*!
+  Push the grey level images and the depth maps of the cameras.
+
+  \param mapOfImages : Map of the grey level images, copied.
+  \param mapOfDepthImages : Map of the raw depth maps, copied and converted
+  to point clouds by the preprocessing stage with the camera parameters of
+  the same camera and the depth scale, see setDepthScale().
+  \param timestamp : Timestamp of the images in second, given to the pose
+  predictor when positive.
+
+  \return The future result of the tracking of the images.
+*/
+std::future<vpMbtTrackingPipeline::vpTrackingResult>
+vpMbtTrackingPipeline::push(const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                            const std::map<std::string, const vpImage<uint16_t> *> &mapOfDepthImages,
+                            double timestamp)
+{
+  vpFramePtr frame = std::make_shared<vpFrame>();
+  frame->timestamp = timestamp;
+  frame->pushTime = vpTime::measureTimeMs();
+  for (std::map<std::string, const vpImage<unsigned char> *>::const_iterator it = mapOfImages.begin();
+       it != mapOfImages.end(); ++it) {
+    if (it->second != NULL) {
+      frame->images[it->first] = *it->second;
+    }
+  }
+  for (std::map<std::string, const vpImage<uint16_t> *>::const_iterator it = mapOfDepthImages.begin();
+       it != mapOfDepthImages.end(); ++it) {
+    if (it->second != NULL) {
+      frame->depthImages[it->first] = *it->second;
+      frame->depthWidths[it->first] = it->second->getWidth();
+      frame->depthHeights[it->first] = it->second->getHeight();
+    }
+  }
+  return enqueue(frame);
+}
+
+/*!
+  Push the color images and the depth maps of the cameras.
+
+  \param mapOfColorImages : Map of the color images, copied and converted to
+  grey level by the preprocessing stage.
+  \param mapOfDepthImages : Map of the raw depth maps, copied and converted
+  to point clouds by the preprocessing stage with the camera parameters of
+  the same camera and the depth scale, see setDepthScale().
+  \param timestamp : Timestamp of the images in second, given to the pose
+  predictor when positive.
+
+  \return The future result of the tracking of the images.
+*/
+std::future<vpMbtTrackingPipeline::vpTrackingResult>
+vpMbtTrackingPipeline::push(const std::map<std::string, const vpImage<vpRGBa> *> &mapOfColorImages,
+                            const std::map<std::string, const vpImage<uint16_t> *> &mapOfDepthImages,
+                            double timestamp)
+{
+  vpFramePtr frame = std::make_shared<vpFrame>();
+  frame->timestamp = timestamp;
+  frame->pushTime = vpTime::measureTimeMs();
+  for (std::map<std::string, const vpImage<vpRGBa> *>::const_iterator it = mapOfColorImages.begin();
+       it != mapOfColorImages.end(); ++it) {
+    if (it->second != NULL) {
+      frame->colorImages[it->first] = *it->second;
+    }
+  }
+  for (std::map<std::string, const vpImage<uint16_t> *>::const_iterator it = mapOfDepthImages.begin();
+       it != mapOfDepthImages.end(); ++it) {
+    if (it->second != NULL) {
+      frame->depthImages[it->first] = *it->second;
+      frame->depthWidths[it->first] = it->second->getWidth();
+      frame->depthHeights[it->first] = it->second->getHeight();
+    }
+  }
+  return enqueue(frame);
+}
+
+#elif !defined(VISP_BUILD_SHARED_LIBS)
+// Work arround to avoid warning: libvisp_mbt.a(vpMbtTrackingPipeline.cpp.o) has no symbols
+void dummy_vpMbtTrackingPipeline(){};
+#endif
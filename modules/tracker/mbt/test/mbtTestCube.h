@@ -0,0 +1,389 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Synthetic cube shared by the model-based tracker tests.
+ *
+ *****************************************************************************/
+
+#ifndef _mbtTestCube_h_
+#define _mbtTestCube_h_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/mbt/vpMbDepthDenseTracker.h>
+#include <visp3/mbt/vpMbDepthNormalTracker.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+
+/*!
+  Synthetic scene used by the model-based tracker tests: a cube of side
+  cube_size whose model is written in the CAO format and whose image and
+  point cloud are obtained by ray casting.
+*/
+namespace mbtTestCube
+{
+const double cube_size = 0.1;
+
+inline void writeCubeModel(const std::string &filename, double size = cube_size)
+{
+  std::ofstream file(filename.c_str());
+  file << "V1\n";
+  file << "8\n";
+  file << " 0 0 0\n" << -size << " 0 0\n" << -size << " " << size << " 0\n";
+  file << " 0 " << size << " 0\n";
+  file << " 0 0 " << size << "\n" << -size << " 0 " << size << "\n";
+  file << -size << " " << size << " " << size << "\n";
+  file << " 0 " << size << " " << size << "\n";
+  file << "0\n0\n";
+  file << "6\n";
+  file << "4 0 4 5 1\n4 1 5 6 2\n4 6 7 3 2\n4 3 7 4 0\n4 0 1 2 3\n4 7 6 5 4\n";
+  file << "0\n0\n";
+}
+
+// Temporary directory of a test, removed with its content when the object is destroyed
+class vpTestDirectory
+{
+public:
+  explicit vpTestDirectory(const std::string &name) : m_path()
+  {
+#if defined(_WIN32)
+    m_path = "C:/temp/" + vpIoTools::getUserName() + "/" + name;
+#else
+    m_path = "/tmp/" + vpIoTools::getUserName() + "/" + name;
+#endif
+    vpIoTools::makeDirectory(m_path);
+  }
+  ~vpTestDirectory() { vpIoTools::remove(m_path); }
+
+  // Write the model of a cube in the directory and return its filename
+  std::string writeCubeModel(const std::string &filename = "cube.cao", double size = cube_size) const
+  {
+    const std::string model = m_path + vpIoTools::path("/") + filename;
+    mbtTestCube::writeCubeModel(model, size);
+    return model;
+  }
+
+private:
+  vpTestDirectory(const vpTestDirectory &);
+  vpTestDirectory &operator=(const vpTestDirectory &);
+
+  std::string m_path;
+};
+
+// Pose of the cube at each frame of the sequences
+inline vpHomogeneousMatrix cubePose(unsigned int frame)
+{
+  return vpHomogeneousMatrix(0.06 + 0.002 * frame, -0.06, 0.45, vpMath::rad(30 + 0.5 * frame), vpMath::rad(-35),
+                             vpMath::rad(10 + frame));
+}
+
+// Perturbed pose the trackers start from
+inline vpHomogeneousMatrix perturbedPose(const vpHomogeneousMatrix &cMo)
+{
+  return vpHomogeneousMatrix(0.002, -0.002, 0.003, vpMath::rad(0.5), 0, vpMath::rad(-0.5)) * cMo;
+}
+
+// Displacement of the second camera of the stereo sequences
+inline vpHomogeneousMatrix stereoTransformation()
+{
+  return vpHomogeneousMatrix(-0.08, 0.0, 0.0, 0.0, vpMath::rad(-6), 0.0);
+}
+
+// Depth along the optical axis of the intersection of the ray of normalized coordinates (x, y) with a cube, negative
+// if none. axis is the index of the normal of the intersected face.
+inline double intersectCube(const vpHomogeneousMatrix &oMc, double size, double x, double y, int &axis)
+{
+  const double bmin[3] = {-size, 0, 0};
+  const double bmax[3] = {0, size, size};
+  vpRotationMatrix oRc = oMc.getRotationMatrix();
+  vpTranslationVector oTc = oMc.getTranslationVector();
+
+  double dir[3];
+  for (unsigned int k = 0; k < 3; k++) {
+    dir[k] = oRc[k][0] * x + oRc[k][1] * y + oRc[k][2];
+  }
+
+  // Slab intersection, the depth along the optical axis is the ray parameter
+  double tnear = -1e30, tfar = 1e30;
+  axis = -1;
+  for (int k = 0; k < 3; k++) {
+    if (std::fabs(dir[k]) < 1e-12) {
+      if (oTc[k] < bmin[k] || oTc[k] > bmax[k]) {
+        tnear = 1e30;
+      }
+      continue;
+    }
+    double t1 = (bmin[k] - oTc[k]) / dir[k];
+    double t2 = (bmax[k] - oTc[k]) / dir[k];
+    if (t1 > t2) {
+      std::swap(t1, t2);
+    }
+    if (t1 > tnear) {
+      tnear = t1;
+      axis = k;
+    }
+    tfar = (std::min)(tfar, t2);
+  }
+
+  return (axis >= 0 && tnear <= tfar && tnear > 0) ? tnear : -1.0;
+}
+
+// Ray cast the cube to get the point cloud seen by the camera, the points without intersection are null
+inline void renderCube(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, unsigned int height,
+                       unsigned int width, std::vector<vpColVector> &pointcloud)
+{
+  const vpHomogeneousMatrix oMc = cMo.inverse();
+  pointcloud.resize(height * width);
+
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      double x = 0, y = 0;
+      vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+
+      int axis = -1;
+      const double Z = intersectCube(oMc, cube_size, x, y, axis);
+
+      vpColVector &pt = pointcloud[i * width + j];
+      pt.resize(3, false);
+      if (Z > 0) {
+        pt[0] = x * Z;
+        pt[1] = y * Z;
+        pt[2] = Z;
+      } else {
+        pt = 0;
+      }
+    }
+  }
+}
+
+// Ray cast the cube to get a 640x480 shaded image and the point cloud seen by the camera
+inline void renderCube(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, vpImage<unsigned char> &I,
+                       std::vector<vpColVector> &pointcloud)
+{
+  const unsigned char shade[3] = {90, 160, 230};
+  const vpHomogeneousMatrix oMc = cMo.inverse();
+
+  I.resize(480, 640, 20);
+  pointcloud.resize(I.getSize());
+
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double x = 0, y = 0;
+      vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+
+      int axis = -1;
+      const double Z = intersectCube(oMc, cube_size, x, y, axis);
+
+      vpColVector &pt = pointcloud[i * I.getWidth() + j];
+      pt.resize(3, false);
+      if (Z > 0) {
+        I[i][j] = shade[axis];
+        pt[0] = x * Z;
+        pt[1] = y * Z;
+        pt[2] = Z;
+      } else {
+        pt = 0;
+      }
+    }
+  }
+}
+
+// Visibility settings of the trackers
+template <class Tracker> void setVisibilityParameters(Tracker &tracker)
+{
+  tracker.setAngleAppear(vpMath::rad(85));
+  tracker.setAngleDisappear(vpMath::rad(89));
+  tracker.setNearClippingDistance(0.01);
+  tracker.setFarClippingDistance(2.0);
+}
+
+// Moving-edge, dense depth and visibility settings of the edge and dense depth trackers
+inline void setTrackerParameters(vpMbGenericTracker &tracker, unsigned int range = 12)
+{
+  vpMe me;
+  me.setMaskSize(5);
+  me.setMaskNumber(180);
+  me.setRange(range);
+  me.setThreshold(5000);
+  me.setMu1(0.5);
+  me.setMu2(0.5);
+  me.setSampleStep(4);
+  tracker.setMovingEdge(me);
+
+  tracker.setDepthDenseSamplingStep(4, 4);
+  setVisibilityParameters(tracker);
+}
+
+// Monocular tracker. The 3D lines of the model are built with rand(), the
+// seed is reset so that the models loaded by the trackers are identical
+inline void configure(vpMbGenericTracker &tracker, const std::string &model, const vpCameraParameters &cam,
+                      unsigned int range = 12)
+{
+  tracker.setCameraParameters(cam);
+  setTrackerParameters(tracker, range);
+  srand(0);
+  tracker.loadModel(model);
+}
+
+// Stereo tracker, the second camera is displaced by c2Mc1 and has the same intrinsic parameters
+inline void configure(vpMbGenericTracker &tracker, const std::string &model, const vpCameraParameters &cam,
+                      const vpHomogeneousMatrix &c2Mc1)
+{
+  std::map<std::string, vpCameraParameters> mapOfCams;
+  mapOfCams["Camera1"] = cam;
+  mapOfCams["Camera2"] = cam;
+  tracker.setCameraParameters(mapOfCams);
+
+  std::map<std::string, vpHomogeneousMatrix> mapOfTransformations;
+  mapOfTransformations["Camera1"] = vpHomogeneousMatrix();
+  mapOfTransformations["Camera2"] = c2Mc1;
+  tracker.setCameraTransformationMatrix(mapOfTransformations);
+
+  setTrackerParameters(tracker);
+
+  std::map<std::string, std::string> mapOfModels;
+  mapOfModels["Camera1"] = model;
+  mapOfModels["Camera2"] = model;
+  srand(0);
+  tracker.loadModel(mapOfModels);
+}
+
+// Dense depth tracker
+inline void configure(vpMbDepthDenseTracker &tracker, const std::string &model, const vpCameraParameters &cam)
+{
+  tracker.setCameraParameters(cam);
+  tracker.setDepthDenseSamplingStep(2, 2);
+  setVisibilityParameters(tracker);
+  tracker.loadModel(model);
+}
+
+// Depth normal tracker
+inline void configure(vpMbDepthNormalTracker &tracker, const std::string &model, const vpCameraParameters &cam)
+{
+  tracker.setCameraParameters(cam);
+  tracker.setDepthNormalSamplingStep(2, 2);
+  setVisibilityParameters(tracker);
+  tracker.loadModel(model);
+}
+
+/*!
+  Stereo tracker of the cube, with edge and dense depth features on the first
+  camera and edge features on the second one.
+*/
+class vpStereoTracker : public vpMbGenericTracker
+{
+public:
+  vpStereoTracker(const std::string &model, const vpCameraParameters &cam)
+    : vpMbGenericTracker(cameraNames(), trackerTypes())
+  {
+    configure(*this, model, cam, stereoTransformation());
+  }
+
+  void initStereo(const vpImage<unsigned char> &I1, const vpImage<unsigned char> &I2, const vpHomogeneousMatrix &c1Mo)
+  {
+    initFromPose(I1, I2, c1Mo, stereoTransformation() * c1Mo);
+  }
+
+  void trackStereo(const vpImage<unsigned char> &I1, const vpImage<unsigned char> &I2,
+                   const std::vector<vpColVector> &pointcloud1)
+  {
+    std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
+    mapOfImages["Camera1"] = &I1;
+    mapOfImages["Camera2"] = &I2;
+    std::map<std::string, const std::vector<vpColVector> *> mapOfPointClouds;
+    mapOfPointClouds["Camera1"] = &pointcloud1;
+    std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
+    mapOfWidths["Camera1"] = I1.getWidth();
+    mapOfHeights["Camera1"] = I1.getHeight();
+    track(mapOfImages, mapOfPointClouds, mapOfWidths, mapOfHeights);
+  }
+
+private:
+  static std::vector<std::string> cameraNames()
+  {
+    std::vector<std::string> names;
+    names.push_back("Camera1");
+    names.push_back("Camera2");
+    return names;
+  }
+  static std::vector<int> trackerTypes()
+  {
+    std::vector<int> types;
+    types.push_back(vpMbGenericTracker::EDGE_TRACKER | vpMbGenericTracker::DEPTH_DENSE_TRACKER);
+    types.push_back(vpMbGenericTracker::EDGE_TRACKER);
+    return types;
+  }
+};
+
+inline bool samePose(const vpHomogeneousMatrix &M1, const vpHomogeneousMatrix &M2, double tolerance)
+{
+  for (unsigned int i = 0; i < 16; i++) {
+    if (std::fabs(M1.data[i] - M2.data[i]) > tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Check that a pose is the reference one, print both with the message otherwise
+inline bool checkPose(unsigned int frame, const std::string &message, const vpHomogeneousMatrix &cMo_ref,
+                      const vpHomogeneousMatrix &cMo, double tolerance)
+{
+  if (samePose(cMo_ref, cMo, tolerance)) {
+    return true;
+  }
+  std::cerr << "Frame " << frame << ": " << message << ":\n" << cMo_ref << "\n" << cMo << std::endl;
+  return false;
+}
+
+// Check that the estimated pose follows the ground truth
+inline bool checkTracking(unsigned int frame, const vpHomogeneousMatrix &cMo, const vpHomogeneousMatrix &cMo_truth,
+                          double tolerance, const std::string &object = "")
+{
+  if (samePose(cMo, cMo_truth, tolerance)) {
+    return true;
+  }
+  std::cerr << "Frame " << frame << ": tracking failure" << (object.empty() ? "" : " of " + object)
+            << ", estimated pose:\n"
+            << cMo << "\nground truth:\n"
+            << cMo_truth << std::endl;
+  return false;
+}
+}
+
+#endif
@@ -0,0 +1,189 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark the loading of cao and binary CAD model files.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_CATCH2) && defined(VISP_HAVE_MODULE_MBT)
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_RUNNER
+#include <catch.hpp>
+
+#include <fstream>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+#include <visp3/mbt/vpMbtCadModel.h>
+
+namespace
+{
+bool g_runBenchmark = false;
+int g_nbBoxes = 200;
+
+std::string g_tmpDir;
+
+// Grid of boxes given by their corners, each one with a cylinder on top
+void writeModel(const std::string &filename, int nbBoxes)
+{
+  const double V[8][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+  const int F[6][4] = {{0, 4, 5, 1}, {1, 5, 6, 2}, {6, 7, 3, 2}, {3, 7, 4, 0}, {0, 1, 2, 3}, {7, 6, 5, 4}};
+  const double size = 0.01;
+
+  std::ofstream file(filename.c_str());
+  file << "V1\n# 3D Points\n" << 10 * nbBoxes << "\n";
+  for (int b = 0; b < nbBoxes; b++) {
+    const double x = 2 * size * (b % 100), y = 2 * size * (b / 100);
+    for (int k = 0; k < 8; k++) {
+      file << x + size * V[k][0] << " " << y + size * V[k][1] << " " << size * V[k][2] << "\n";
+    }
+    file << x + size / 2 << " " << y + size / 2 << " " << size << "\n";
+    file << x + size / 2 << " " << y + size / 2 << " " << 2 * size << "\n";
+  }
+  file << "# 3D Lines\n0\n# Faces from 3D lines\n0\n# Faces from 3D points\n" << 6 * nbBoxes << "\n";
+  for (int b = 0; b < nbBoxes; b++) {
+    for (int f = 0; f < 6; f++) {
+      file << "4";
+      for (int k = 0; k < 4; k++) {
+        file << " " << 10 * b + F[f][k];
+      }
+      file << " name=\"box_" << b << "\"\n";
+    }
+  }
+  file << "# 3D cylinders\n" << nbBoxes << "\n";
+  for (int b = 0; b < nbBoxes; b++) {
+    file << 10 * b + 8 << " " << 10 * b + 9 << " " << size / 4 << "\n";
+  }
+  file << "# 3D circles\n0\n";
+}
+}
+
+TEST_CASE("Benchmark cao and binary model loading", "[benchmark]")
+{
+  const int nbBoxes = g_runBenchmark ? g_nbBoxes : 10;
+  const std::string caoFile = g_tmpDir + "/model.cao";
+  const std::string binaryFile = g_tmpDir + "/model.bcao";
+  writeModel(caoFile, nbBoxes);
+
+  vpMbtCadModel model;
+  model.loadCAO(caoFile);
+  model.saveBinary(binaryFile);
+  CHECK(model.getNbPrimitives() == static_cast<unsigned int>(7 * nbBoxes));
+
+  vpMbtCadModel binary;
+  binary.loadBinary(binaryFile);
+  CHECK(binary.getPoints() == model.getPoints());
+  CHECK(binary.getPointIndexes() == model.getPointIndexes());
+
+  {
+    vpMbGenericTracker trackerCao, trackerBinary;
+    trackerCao.loadModel(caoFile);
+    trackerBinary.loadModel(binaryFile);
+    CHECK(trackerCao.getFaces().size() == static_cast<unsigned int>(11 * nbBoxes));
+    CHECK(trackerBinary.getFaces().size() == trackerCao.getFaces().size());
+  }
+
+  if (g_runBenchmark) {
+    BENCHMARK("Parse cao model")
+    {
+      vpMbtCadModel m;
+      m.loadCAO(caoFile);
+      return m.getNbPrimitives();
+    };
+
+    BENCHMARK("Map binary model")
+    {
+      vpMbtCadModel m;
+      m.loadBinary(binaryFile);
+      return m.getNbPrimitives();
+    };
+
+    BENCHMARK("vpMbGenericTracker::loadModel() cao")
+    {
+      vpMbGenericTracker tracker;
+      tracker.loadModel(caoFile);
+      return tracker.getNbPolygon();
+    };
+
+    BENCHMARK("vpMbGenericTracker::loadModel() bcao")
+    {
+      vpMbGenericTracker tracker;
+      tracker.loadModel(binaryFile);
+      return tracker.getNbPolygon();
+    };
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Catch::Session session; // There must be exactly one instance
+
+  // Build a new parser on top of Catch's
+  using namespace Catch::clara;
+  auto cli = session.cli()         // Get Catch's composite command line parser
+             | Opt(g_runBenchmark) // bind variable to a new option, with a hint string
+                   ["--benchmark"] // the option names it will respond to
+             ("run benchmark?")    // description string for the help output
+             | Opt(g_nbBoxes, "nbBoxes")["--nbBoxes"]("Number of boxes of the benchmark model");
+
+  // Now pass the new composite back to Catch so it uses that
+  session.cli(cli);
+
+  // Let Catch (using Clara) parse the command line
+  session.applyCommandLine(argc, argv);
+
+#if defined(_WIN32)
+  g_tmpDir = "C:/temp/";
+#else
+  g_tmpDir = "/tmp/";
+#endif
+  std::string username;
+  vpIoTools::getUserName(username);
+  g_tmpDir += username + "/perf_cad_model_loading";
+  vpIoTools::remove(g_tmpDir);
+  vpIoTools::makeDirectory(g_tmpDir);
+
+  int numFailed = session.run();
+
+  vpIoTools::remove(g_tmpDir);
+
+  // numFailed is clamped to 255 as some unices only use the lower 8 bits.
+  // This clamping has already been applied, so just return it here
+  // You can also do any post run clean-up here
+  return numFailed;
+}
+#else
+#include <iostream>
+
+int main() { return 0; }
+#endif
@@ -0,0 +1,480 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Replay a recorded sequence through the configurations of the generic
+ * model-based tracker and report the latency and the pose drift.
+ *
+ *****************************************************************************/
+
+/*!
+  \example perfGenericTrackerReplay.cpp
+
+  \brief Replay a sequence recorded with vpMbtSequenceRecorder through the
+  edge, KLT, depth normal and depth dense configurations of
+  vpMbGenericTracker. The percentiles of the per-frame latency and the drift
+  of the pose with respect to the recorded poses are printed.
+
+  Without \c --sequence, a synthetic sequence of a textured cube is rendered
+  and recorded first. Use \c --benchmark to also time the whole replays.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_CATCH2) && defined(VISP_HAVE_MODULE_MBT) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_RUNNER
+#include <catch.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+#include <visp3/mbt/vpMbtSequence.h>
+#include <visp3/mbt/vpMbtTrackingPipeline.h>
+
+#include "mbtTestCube.h"
+
+namespace
+{
+bool g_runBenchmark = false;
+std::string g_sequence = "";
+int g_nbFrames = 30;
+
+std::string g_tmpDir;
+
+// Ray cast the cube to get a textured image and the depth map seen by the camera
+void renderCube(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, double depthScale,
+                vpImage<unsigned char> &I, vpImage<uint16_t> &I_depth)
+{
+  const double shade[3] = {90, 160, 230};
+  const vpHomogeneousMatrix oMc = cMo.inverse();
+
+  I.resize(480, 640, 20);
+  I_depth.resize(480, 640, 0);
+
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double x = 0, y = 0;
+      vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+
+      int axis = -1;
+      const double depth = mbtTestCube::intersectCube(oMc, mbtTestCube::cube_size, x, y, axis);
+      if (depth > 0) {
+        // Smooth texture of low contrast so that the edges of the faces stay the strongest
+        const double X = (oMc[0][0] * x + oMc[0][1] * y + oMc[0][2]) * depth + oMc[0][3];
+        const double Y = (oMc[1][0] * x + oMc[1][1] * y + oMc[1][2]) * depth + oMc[1][3];
+        const double Z = (oMc[2][0] * x + oMc[2][1] * y + oMc[2][2]) * depth + oMc[2][3];
+        const double texture =
+            20 * std::sin(X * 400 + 1.3 * std::cos(Y * 300)) * std::cos(Y * 350 + Z * 280) + 10 * std::sin(Z * 600 + X * 250);
+        I[i][j] = static_cast<unsigned char>(vpMath::round(shade[axis] + texture));
+        I_depth[i][j] = static_cast<uint16_t>(vpMath::round(depth / depthScale));
+      }
+    }
+  }
+}
+
+void recordSyntheticSequence(const std::string &filename, const std::string &model, int nbFrames)
+{
+  const vpCameraParameters cam(600, 600, 320, 240);
+  const double depthScale = 1e-4;
+  std::map<std::string, vpCameraParameters> mapOfCameras;
+  mapOfCameras["Camera"] = cam;
+  std::map<std::string, vpHomogeneousMatrix> mapOfTransformations;
+  mapOfTransformations["Camera"] = vpHomogeneousMatrix();
+
+  vpMbtSequenceRecorder recorder;
+  recorder.open(filename, model, mapOfCameras, mapOfTransformations, "Camera", depthScale);
+
+  vpMbtSequenceFrame frame;
+  for (int k = 0; k < nbFrames; k++) {
+    frame.timestamp = k / 30.0;
+    frame.hasPose = true;
+    frame.cMo = vpHomogeneousMatrix(0.05 + 0.002 * k, -0.06 + 0.001 * k, 0.45 - 0.001 * k, vpMath::rad(30 + 0.6 * k),
+                                    vpMath::rad(-35 + 0.3 * k), vpMath::rad(10 + 0.8 * k));
+    renderCube(frame.cMo, cam, depthScale, frame.images["Camera"], frame.depthImages["Camera"]);
+    recorder.record(frame);
+  }
+}
+
+typedef enum { EDGE_CONFIGURATION, KLT_CONFIGURATION, DEPTH_NORMAL_CONFIGURATION, DEPTH_DENSE_CONFIGURATION } vpConfiguration;
+
+std::string configurationName(vpConfiguration configuration)
+{
+  switch (configuration) {
+  case EDGE_CONFIGURATION:
+    return "edge";
+  case KLT_CONFIGURATION:
+    return "klt";
+  case DEPTH_NORMAL_CONFIGURATION:
+    return "depth normal";
+  default:
+    return "depth dense";
+  }
+}
+
+void configure(vpMbGenericTracker &tracker, vpConfiguration configuration, const vpMbtSequencePlayer &player)
+{
+  const std::string referenceName = player.getReferenceCameraName();
+  tracker.setCameraParameters(player.getCameraParameters()[referenceName]);
+
+  switch (configuration) {
+  case EDGE_CONFIGURATION: {
+    vpMe me;
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setRange(8);
+    me.setThreshold(10000);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+    me.setSampleStep(4);
+    tracker.setMovingEdge(me);
+    break;
+  }
+  case KLT_CONFIGURATION: {
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+    vpKlt klt;
+    klt.setMaxFeatures(300);
+    klt.setWindowSize(5);
+    klt.setQuality(0.01);
+    klt.setMinDistance(5);
+    klt.setHarrisFreeParameter(0.01);
+    klt.setBlockSize(3);
+    klt.setPyramidLevels(3);
+    tracker.setKlt(klt);
+    tracker.setKltMaskBorder(5);
+#endif
+    break;
+  }
+  case DEPTH_NORMAL_CONFIGURATION:
+    tracker.setDepthNormalSamplingStep(2, 2);
+    tracker.setDepthNormalPclPlaneEstimationMethod(2);
+    break;
+  default:
+    tracker.setDepthDenseSamplingStep(2, 2);
+    break;
+  }
+
+  tracker.setAngleAppear(vpMath::rad(85));
+  tracker.setAngleDisappear(vpMath::rad(89));
+  tracker.setNearClippingDistance(0.01);
+  tracker.setFarClippingDistance(2.0);
+  tracker.loadModel(player.getModelFile());
+}
+
+int trackerType(vpConfiguration configuration)
+{
+  switch (configuration) {
+  case EDGE_CONFIGURATION:
+    return vpMbGenericTracker::EDGE_TRACKER;
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+  case KLT_CONFIGURATION:
+    return vpMbGenericTracker::KLT_TRACKER;
+#endif
+  case DEPTH_NORMAL_CONFIGURATION:
+    return vpMbGenericTracker::DEPTH_NORMAL_TRACKER;
+  default:
+    return vpMbGenericTracker::DEPTH_DENSE_TRACKER;
+  }
+}
+
+//! Result of the replay of a sequence
+struct vpReplayResult {
+  vpReplayResult() : latencies(), translationErrors(), rotationErrors() {}
+
+  //! Time of each call to track(), in milliseconds
+  std::vector<double> latencies;
+  //! Distance between the estimated and the recorded translations, in meter
+  std::vector<double> translationErrors;
+  //! Angle between the estimated and the recorded rotations, in degree
+  std::vector<double> rotationErrors;
+};
+
+// Replay the sequence from its first frame, the tracker is initialized with the recorded pose of the first frame
+vpReplayResult replay(vpMbtSequencePlayer &player, vpConfiguration configuration)
+{
+  vpMbGenericTracker tracker(1, trackerType(configuration));
+  configure(tracker, configuration, player);
+
+  const std::string referenceName = player.getReferenceCameraName();
+  const vpCameraParameters cam = player.getCameraParameters()[referenceName];
+
+  vpReplayResult result;
+  vpMbtSequenceFrame frame;
+  std::vector<vpColVector> pointcloud;
+  player.seek(0);
+  while (player.acquire(frame)) {
+    const vpImage<unsigned char> &I = frame.images[referenceName];
+
+    std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
+    mapOfImages[referenceName] = &I;
+    std::map<std::string, const std::vector<vpColVector> *> mapOfPointClouds;
+    std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
+    if (frame.pointClouds.find(referenceName) != frame.pointClouds.end()) {
+      mapOfPointClouds[referenceName] = &frame.pointClouds[referenceName];
+      mapOfWidths[referenceName] = frame.pointCloudWidths[referenceName];
+      mapOfHeights[referenceName] = frame.pointCloudHeights[referenceName];
+    } else if (frame.depthImages.find(referenceName) != frame.depthImages.end()) {
+      const vpImage<uint16_t> &I_depth = frame.depthImages[referenceName];
+      vpMbtTrackingPipeline::convertDepthToPointCloud(I_depth, cam, player.getDepthScale(), pointcloud);
+      mapOfPointClouds[referenceName] = &pointcloud;
+      mapOfWidths[referenceName] = I_depth.getWidth();
+      mapOfHeights[referenceName] = I_depth.getHeight();
+    }
+
+    if (player.getFrameIndex() == 1) {
+      REQUIRE(frame.hasPose);
+      tracker.initFromPose(I, frame.cMo);
+      continue;
+    }
+
+    const double t = vpTime::measureTimeMs();
+    tracker.track(mapOfImages, mapOfPointClouds, mapOfWidths, mapOfHeights);
+    result.latencies.push_back(vpTime::measureTimeMs() - t);
+
+    if (frame.hasPose) {
+      const vpHomogeneousMatrix cMo = tracker.getPose();
+      result.translationErrors.push_back(
+          (cMo.getTranslationVector() - frame.cMo.getTranslationVector()).frobeniusNorm());
+      result.rotationErrors.push_back(vpMath::deg((cMo * frame.cMo.inverse()).getThetaUVector().getTheta()));
+    }
+  }
+
+  return result;
+}
+
+// Nearest-rank percentile
+double percentile(std::vector<double> values, double p)
+{
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+  return values[rank > 0 ? rank - 1 : 0];
+}
+
+double mean(const std::vector<double> &values)
+{
+  double sum = 0.0;
+  for (size_t i = 0; i < values.size(); i++) {
+    sum += values[i];
+  }
+  return values.empty() ? 0.0 : sum / values.size();
+}
+
+void printResult(const std::string &name, const vpReplayResult &result)
+{
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << name << " (" << result.latencies.size() << " frames)\n";
+  std::cout << "  latency (ms): p50 " << percentile(result.latencies, 50) << ", p90 "
+            << percentile(result.latencies, 90) << ", p99 " << percentile(result.latencies, 99) << ", max "
+            << percentile(result.latencies, 100) << "\n";
+  if (!result.translationErrors.empty()) {
+    std::cout << "  drift: translation (mm) mean " << 1000 * mean(result.translationErrors) << ", max "
+              << 1000 * percentile(result.translationErrors, 100) << ", last "
+              << 1000 * result.translationErrors.back() << "; rotation (deg) mean " << mean(result.rotationErrors)
+              << ", max " << percentile(result.rotationErrors, 100) << ", last " << result.rotationErrors.back()
+              << "\n";
+  }
+  std::cout << std::defaultfloat << std::setprecision(6) << std::flush;
+}
+
+std::string sequenceFile()
+{
+  if (!g_sequence.empty()) {
+    return g_sequence;
+  }
+
+  const std::string filename = g_tmpDir + "/cube.bseq";
+  if (!vpIoTools::checkFilename(filename)) {
+    const std::string model = g_tmpDir + "/cube.cao";
+    mbtTestCube::writeCubeModel(model);
+    recordSyntheticSequence(filename, model, g_nbFrames);
+  }
+  return filename;
+}
+}
+
+TEST_CASE("Record and read back a sequence", "[sequence]")
+{
+  const std::string filename = g_tmpDir + "/roundtrip.bseq";
+  const vpCameraParameters cam(600, 610, 320, 240, -0.1, 0.1);
+  std::map<std::string, vpCameraParameters> mapOfCameras;
+  mapOfCameras["Camera1"] = cam;
+  mapOfCameras["Camera2"] = vpCameraParameters(500, 500, 160, 120);
+  std::map<std::string, vpHomogeneousMatrix> mapOfTransformations;
+  mapOfTransformations["Camera2"] = vpHomogeneousMatrix(0.1, 0, 0, 0, 0.2, 0);
+
+  vpMbtSequenceFrame frame;
+  frame.images["Camera1"].resize(4, 5, 7);
+  frame.images["Camera1"][3][4] = 200;
+  frame.colorImages["Camera1"].resize(2, 3, vpRGBa(1, 2, 3, vpRGBa::alpha_default));
+  frame.depthImages["Camera2"].resize(3, 2, 1000);
+  frame.pointClouds["Camera2"].resize(6, vpColVector(3, 0.5));
+  frame.pointCloudWidths["Camera2"] = 2;
+  frame.pointCloudHeights["Camera2"] = 3;
+  frame.hasPose = true;
+  frame.cMo = vpHomogeneousMatrix(0.1, 0.2, 0.3, 0.4, 0.5, 0.6);
+  frame.timestamp = 1.5;
+
+  {
+    vpMbtSequenceRecorder recorder;
+    recorder.open(filename, "model.cao", mapOfCameras, mapOfTransformations, "Camera1", 1e-4);
+    recorder.record(frame);
+    vpMbtSequenceFrame empty;
+    recorder.record(empty);
+    CHECK(recorder.getNbFrames() == 2);
+  }
+
+  // An interrupted recording ends with an incomplete frame
+  {
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+    file.write("\x10\x00\x00", 3);
+  }
+
+  vpMbtSequencePlayer player;
+  player.open(filename);
+  CHECK(player.getNbFrames() == 2);
+  CHECK(player.getModelFile() == "model.cao");
+  CHECK(player.getReferenceCameraName() == "Camera1");
+  CHECK(player.getDepthScale() == Approx(1e-4));
+  CHECK(player.getCameraParameters()["Camera1"] == cam);
+  CHECK(player.getCameraTransformations()["Camera1"] == vpHomogeneousMatrix());
+  CHECK(player.getCameraTransformations()["Camera2"] == mapOfTransformations["Camera2"]);
+
+  vpMbtSequenceFrame read;
+  REQUIRE(player.acquire(read));
+  CHECK(read.timestamp == frame.timestamp);
+  CHECK(read.hasPose);
+  CHECK(read.cMo == frame.cMo);
+  CHECK((read.images["Camera1"] == frame.images["Camera1"]));
+  CHECK((read.colorImages["Camera1"] == frame.colorImages["Camera1"]));
+  CHECK((read.depthImages["Camera2"] == frame.depthImages["Camera2"]));
+  CHECK(read.pointClouds["Camera2"] == frame.pointClouds["Camera2"]);
+  CHECK(read.pointCloudWidths["Camera2"] == 2);
+
+  REQUIRE(player.acquire(read));
+  CHECK(!read.hasPose);
+  CHECK(read.images.empty());
+  CHECK(read.pointClouds.empty());
+  CHECK(!player.acquire(read));
+
+  player.seek(0);
+  REQUIRE(player.acquire(read));
+  CHECK((read.images["Camera1"] == frame.images["Camera1"]));
+}
+
+TEST_CASE("Replay a sequence through the tracker configurations", "[benchmark]")
+{
+  vpMbtSequencePlayer player;
+  player.open(sequenceFile());
+  REQUIRE(player.getNbFrames() > 1);
+  const bool synthetic = g_sequence.empty();
+
+  std::vector<vpConfiguration> configurations;
+  configurations.push_back(EDGE_CONFIGURATION);
+#if defined(VISP_HAVE_MODULE_KLT) && (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+  configurations.push_back(KLT_CONFIGURATION);
+#endif
+  configurations.push_back(DEPTH_NORMAL_CONFIGURATION);
+  configurations.push_back(DEPTH_DENSE_CONFIGURATION);
+
+  for (size_t i = 0; i < configurations.size(); i++) {
+    const std::string name = configurationName(configurations[i]);
+    vpReplayResult result = replay(player, configurations[i]);
+    printResult(name, result);
+    CHECK(result.latencies.size() == player.getNbFrames() - 1);
+
+    if (synthetic) {
+      // The drift of the KLT tracker accumulates along the sequence
+      const double maxTranslation = configurations[i] == KLT_CONFIGURATION ? 1e-2 : 2e-3;
+      const double maxRotation = configurations[i] == KLT_CONFIGURATION ? 1.0 : 0.5;
+      INFO("Configuration " << name);
+      CHECK(percentile(result.translationErrors, 100) < maxTranslation);
+      CHECK(percentile(result.rotationErrors, 100) < maxRotation);
+    }
+
+    if (g_runBenchmark) {
+      BENCHMARK("Replay " + name) { return replay(player, configurations[i]).latencies.size(); };
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Catch::Session session; // There must be exactly one instance
+
+  // Build a new parser on top of Catch's
+  using namespace Catch::clara;
+  auto cli = session.cli()         // Get Catch's composite command line parser
+             | Opt(g_runBenchmark) // bind variable to a new option, with a hint string
+                   ["--benchmark"] // the option names it will respond to
+             ("run benchmark?")    // description string for the help output
+             | Opt(g_sequence, "sequence")["--sequence"]("Sequence recorded with vpMbtSequenceRecorder to replay")
+             | Opt(g_nbFrames, "nbFrames")["--nbFrames"]("Number of frames of the synthetic sequence");
+
+  // Now pass the new composite back to Catch so it uses that
+  session.cli(cli);
+
+  // Let Catch (using Clara) parse the command line
+  session.applyCommandLine(argc, argv);
+
+#if defined(_WIN32)
+  g_tmpDir = "C:/temp/";
+#else
+  g_tmpDir = "/tmp/";
+#endif
+  std::string username;
+  vpIoTools::getUserName(username);
+  g_tmpDir += username + "/perf_generic_tracker_replay";
+  if (vpIoTools::checkDirectory(g_tmpDir)) {
+    vpIoTools::remove(g_tmpDir);
+  }
+  vpIoTools::makeDirectory(g_tmpDir);
+
+  int numFailed = session.run();
+
+  vpIoTools::remove(g_tmpDir);
+
+  // numFailed is clamped to 255 as some unices only use the lower 8 bits.
+  // This clamping has already been applied, so just return it here
+  // You can also do any post run clean-up here
+  return numFailed;
+}
+#else
+#include <iostream>
+
+int main() { return 0; }
+#endif
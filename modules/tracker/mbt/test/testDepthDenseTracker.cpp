@@ -0,0 +1,124 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the pose estimation variants of vpMbDepthDenseTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testDepthDenseTracker.cpp
+
+  \brief Compare the sequential and the parallel processing of the faces,
+  the fused normal equations and the single precision interaction matrix of
+  vpMbDepthDenseTracker on a synthetic point cloud sequence of a cube.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/mbt/vpMbDepthDenseTracker.h>
+
+#include "mbtTestCube.h"
+
+int main()
+{
+  mbtTestCube::vpTestDirectory tmp_dir("testDepthDenseTracker");
+  const std::string model = tmp_dir.writeCubeModel();
+
+  vpCameraParameters cam(600, 600, 320, 240);
+  const unsigned int height = 480, width = 640;
+
+  // Reference, faces processed concurrently, fused normal equations (sequential and concurrent) and single precision
+  const unsigned int nb_trackers = 5;
+  vpMbDepthDenseTracker trackers[nb_trackers];
+  for (unsigned int k = 0; k < nb_trackers; k++) {
+    mbtTestCube::configure(trackers[k], model, cam);
+  }
+  trackers[1].setUseParallelDepthDense(true);
+  trackers[1].setNbParallelDepthDenseThreads(4);
+  trackers[2].setDepthDenseFusedNormalEquations(true);
+  trackers[3].setDepthDenseFusedNormalEquations(true);
+  trackers[3].setUseParallelDepthDense(true);
+  trackers[3].setNbParallelDepthDenseThreads(4);
+  trackers[4].setDepthDenseSinglePrecision(true);
+
+  const unsigned int nb_frames = 10;
+  std::vector<vpColVector> pointcloud;
+  bool success = true;
+
+  for (unsigned int frame = 0; frame < nb_frames && success; frame++) {
+    const vpHomogeneousMatrix cMo = mbtTestCube::cubePose(frame);
+    mbtTestCube::renderCube(cMo, cam, height, width, pointcloud);
+
+    if (frame == 0) {
+      for (unsigned int k = 0; k < nb_trackers; k++) {
+        trackers[k].setPose(vpImage<unsigned char>(height, width), mbtTestCube::perturbedPose(cMo));
+      }
+    }
+
+    vpHomogeneousMatrix poses[nb_trackers];
+    for (unsigned int k = 0; k < nb_trackers; k++) {
+      trackers[k].track(pointcloud, width, height);
+      trackers[k].getPose(poses[k]);
+    }
+
+    // Tolerance 0: bit-identical results
+    const double tolerances[nb_trackers] = {0, 0, 1e-6, 1e-6, 1e-4};
+    const char *names[nb_trackers] = {"sequential", "parallel", "fused", "parallel fused", "single precision"};
+    for (unsigned int k = 1; k < nb_trackers; k++) {
+      success = mbtTestCube::checkPose(frame, std::string("the ") + names[k] + " pose differs from the sequential one",
+                                       poses[0], poses[k], tolerances[k]) &&
+                success;
+    }
+    success = mbtTestCube::checkPose(frame, "the parallel fused pose differs from the sequential fused one", poses[2],
+                                     poses[3], 0) &&
+              success;
+    success = mbtTestCube::checkTracking(frame, poses[0], cMo, 1e-3) && success;
+  }
+
+  if (!success) {
+    std::cerr << "testDepthDenseTracker failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testDepthDenseTracker is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable MBT module (VISP_HAVE_MODULE_MBT) to launch this test." << std::endl;
+  return 0;
+}
+#endif
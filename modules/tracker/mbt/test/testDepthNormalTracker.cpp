@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the plane estimation methods of vpMbDepthNormalTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testDepthNormalTracker.cpp
+
+  \brief Compare the moment-based and the SVD-based robust plane estimations
+  of vpMbDepthNormalTracker on a synthetic point cloud sequence of a cube,
+  with noise and outliers.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/mbt/vpMbDepthNormalTracker.h>
+
+#include "mbtTestCube.h"
+
+namespace
+{
+// Ray cast the cube to get the point cloud seen by the camera, with depth noise and a few outliers
+void renderNoisyCube(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, unsigned int height,
+                     unsigned int width, std::vector<vpColVector> &pointcloud)
+{
+  mbtTestCube::renderCube(cMo, cam, height, width, pointcloud);
+  for (size_t i = 0; i < pointcloud.size(); i++) {
+    vpColVector &pt = pointcloud[i];
+    if (pt[2] > 0) {
+      double scale = 1.0 + 0.001 * (rand() / (double)RAND_MAX - 0.5);
+      if (rand() % 50 == 0) {
+        scale = 1.1;
+      }
+      pt *= scale;
+    }
+  }
+}
+}
+
+int main()
+{
+  mbtTestCube::vpTestDirectory tmp_dir("testDepthNormalTracker");
+  const std::string model = tmp_dir.writeCubeModel();
+
+  vpCameraParameters cam(600, 600, 320, 240);
+  const unsigned int height = 480, width = 640;
+
+  vpMbDepthNormalTracker tracker_svd, tracker_moments;
+  mbtTestCube::configure(tracker_svd, model, cam);
+  mbtTestCube::configure(tracker_moments, model, cam);
+  tracker_svd.setDepthNormalFeatureEstimationMethod(vpMbtFaceDepthNormal::ROBUST_SVD_PLANE_ESTIMATION);
+  tracker_moments.setDepthNormalFeatureEstimationMethod(vpMbtFaceDepthNormal::MOMENT_PLANE_ESTIMATION);
+
+  const unsigned int nb_frames = 10;
+  std::vector<vpColVector> pointcloud;
+  bool success = true;
+  srand(0);
+
+  for (unsigned int frame = 0; frame < nb_frames && success; frame++) {
+    const vpHomogeneousMatrix cMo = mbtTestCube::cubePose(frame);
+    renderNoisyCube(cMo, cam, height, width, pointcloud);
+
+    if (frame == 0) {
+      tracker_svd.setPose(vpImage<unsigned char>(height, width), mbtTestCube::perturbedPose(cMo));
+      tracker_moments.setPose(vpImage<unsigned char>(height, width), mbtTestCube::perturbedPose(cMo));
+    }
+
+    vpHomogeneousMatrix cMo_svd, cMo_moments;
+    tracker_svd.track(pointcloud, width, height);
+    tracker_svd.getPose(cMo_svd);
+    tracker_moments.track(pointcloud, width, height);
+    tracker_moments.getPose(cMo_moments);
+
+    // Same estimator, only the rounding differs
+    success = mbtTestCube::checkPose(frame, "the moment-based pose differs from the SVD-based one", cMo_svd,
+                                     cMo_moments, 1e-6) &&
+              success;
+    success = mbtTestCube::checkTracking(frame, cMo_moments, cMo, 2e-3) && success;
+  }
+
+  if (!success) {
+    std::cerr << "testDepthNormalTracker failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testDepthNormalTracker is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable MBT module (VISP_HAVE_MODULE_MBT) to launch this test." << std::endl;
+  return 0;
+}
+#endif
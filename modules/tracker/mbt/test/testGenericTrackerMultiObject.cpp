@@ -0,0 +1,225 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the tracking of several objects with vpMbtMultiObjectTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testGenericTrackerMultiObject.cpp
+
+  \brief Track two cubes hiding each other on a synthetic RGB-D sequence
+  with vpMbtMultiObjectTracker. The poses must be the same with the objects
+  tracked sequentially or concurrently and with or without the shared
+  moving-edge lookup, and must follow the ground truth when the occlusions
+  are handled.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/mbt/vpMbtMultiObjectTracker.h>
+
+#include "mbtTestCube.h"
+
+namespace
+{
+const double cube_size_A = 0.1;
+const double cube_size_B = 0.06;
+
+// Ray cast the two cubes to get a shaded image and the point cloud seen by the camera
+unsigned int renderCubes(const vpHomogeneousMatrix &cAo, const vpHomogeneousMatrix &cBo,
+                         const vpCameraParameters &cam, vpImage<unsigned char> &I,
+                         std::vector<vpColVector> &pointcloud)
+{
+  const unsigned char shade[2][3] = {{90, 160, 230}, {250, 10, 140}};
+  const vpHomogeneousMatrix oMc_A = cAo.inverse(), oMc_B = cBo.inverse();
+
+  I.resize(480, 640, 20);
+  pointcloud.resize(I.getSize());
+
+  unsigned int nbOccluded = 0;
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double x = 0, y = 0;
+      vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+
+      int axis_A = -1, axis_B = -1;
+      const double Z_A = mbtTestCube::intersectCube(oMc_A, cube_size_A, x, y, axis_A);
+      const double Z_B = mbtTestCube::intersectCube(oMc_B, cube_size_B, x, y, axis_B);
+
+      vpColVector &pt = pointcloud[i * I.getWidth() + j];
+      pt.resize(3, false);
+      pt = 0;
+      double Z = -1.0;
+      if (Z_B > 0 && (Z_A < 0 || Z_B < Z_A)) {
+        I[i][j] = shade[1][axis_B];
+        Z = Z_B;
+        nbOccluded += Z_A > 0 ? 1 : 0;
+      } else if (Z_A > 0) {
+        I[i][j] = shade[0][axis_A];
+        Z = Z_A;
+      }
+      if (Z > 0) {
+        pt[0] = x * Z;
+        pt[1] = y * Z;
+        pt[2] = Z;
+      }
+    }
+  }
+
+  return nbOccluded;
+}
+
+vpHomogeneousMatrix poseA(unsigned int frame)
+{
+  return vpHomogeneousMatrix(0.04, -0.05, 0.5, vpMath::rad(30), vpMath::rad(-35), vpMath::rad(10 + frame));
+}
+
+vpHomogeneousMatrix poseB(unsigned int frame)
+{
+  return vpHomogeneousMatrix(-0.05 + 0.004 * frame, -0.03, 0.35, vpMath::rad(35), vpMath::rad(-30),
+                             vpMath::rad(10 - 0.5 * frame));
+}
+
+void createTracker(vpMbtMultiObjectTracker &tracker, const std::string &modelA, const std::string &modelB,
+                   const vpCameraParameters &cam, bool occlusion)
+{
+  const int type = vpMbGenericTracker::EDGE_TRACKER | vpMbGenericTracker::DEPTH_DENSE_TRACKER;
+  mbtTestCube::configure(tracker.addObject("cubeA", type), modelA, cam);
+  mbtTestCube::configure(tracker.addObject("cubeB", type), modelB, cam);
+  tracker.setUseOcclusionHandling(occlusion);
+}
+
+void initialize(vpMbtMultiObjectTracker &tracker, const vpImage<unsigned char> &I)
+{
+  tracker.getTracker("cubeA").initFromPose(I, mbtTestCube::perturbedPose(poseA(0)));
+  tracker.getTracker("cubeB").initFromPose(I, mbtTestCube::perturbedPose(poseB(0)));
+}
+
+double poseError(const vpHomogeneousMatrix &M1, const vpHomogeneousMatrix &M2)
+{
+  double error = 0;
+  for (unsigned int i = 0; i < 16; i++) {
+    error = (std::max)(error, std::fabs(M1.data[i] - M2.data[i]));
+  }
+  return error;
+}
+}
+
+int main()
+{
+  mbtTestCube::vpTestDirectory tmp_dir("testGenericTrackerMultiObject");
+  const std::string modelA = tmp_dir.writeCubeModel("cubeA.cao", cube_size_A);
+  const std::string modelB = tmp_dir.writeCubeModel("cubeB.cao", cube_size_B);
+
+  vpCameraParameters cam(600, 600, 320, 240);
+
+  vpMbtMultiObjectTracker sequential, parallel, shared, ignored;
+  createTracker(sequential, modelA, modelB, cam, true);
+  createTracker(parallel, modelA, modelB, cam, true);
+  createTracker(shared, modelA, modelB, cam, true);
+  createTracker(ignored, modelA, modelB, cam, false);
+  parallel.setUseParallelTracking(true);
+  parallel.setNbParallelThreads(2);
+  parallel.setUseSharedGradientLookup(true);
+  shared.setUseSharedGradientLookup(true);
+
+  const unsigned int nb_frames = 20;
+  vpImage<unsigned char> I;
+  std::vector<vpColVector> pointcloud;
+  bool success = true;
+  double maxErrorOcclusion = 0, maxErrorIgnored = 0;
+
+  for (unsigned int frame = 0; frame < nb_frames && success; frame++) {
+    const unsigned int nbOccluded = renderCubes(poseA(frame), poseB(frame), cam, I, pointcloud);
+
+    if (frame == 0) {
+      initialize(sequential, I);
+      initialize(parallel, I);
+      initialize(shared, I);
+      initialize(ignored, I);
+    }
+
+    sequential.track(I, pointcloud, I.getWidth(), I.getHeight());
+    parallel.track(I, pointcloud, I.getWidth(), I.getHeight());
+    shared.track(I, pointcloud, I.getWidth(), I.getHeight());
+    ignored.track(I, pointcloud, I.getWidth(), I.getHeight());
+
+    std::vector<std::string> names = sequential.getObjectNames();
+    for (size_t i = 0; i < names.size(); i++) {
+      const vpHomogeneousMatrix cMo_truth = names[i] == "cubeA" ? poseA(frame) : poseB(frame);
+      const vpHomogeneousMatrix cMo = sequential.getPose(names[i]);
+
+      if (!sequential.isTracked(names[i])) {
+        std::cerr << "Frame " << frame << ": " << names[i] << " is lost" << std::endl;
+        success = false;
+      }
+      success = mbtTestCube::checkPose(frame,
+                                       "the pose of " + names[i] + " differs when the objects are tracked concurrently",
+                                       cMo, parallel.getPose(names[i]), 0) &&
+                success;
+      success = mbtTestCube::checkPose(frame, "the pose of " + names[i] + " differs with the shared moving-edge lookup",
+                                       cMo, shared.getPose(names[i]), 0) &&
+                success;
+      success = mbtTestCube::checkTracking(frame, cMo, cMo_truth, 1e-2, names[i]) && success;
+
+      maxErrorOcclusion = (std::max)(maxErrorOcclusion, poseError(cMo, cMo_truth));
+      if (ignored.isTracked(names[i])) {
+        maxErrorIgnored = (std::max)(maxErrorIgnored, poseError(ignored.getPose(names[i]), cMo_truth));
+      }
+    }
+
+    std::cout << "Frame " << frame << ": " << nbOccluded << " pixels of cubeA hidden by cubeB" << std::endl;
+  }
+
+  std::cout << "Maximal pose error with the occlusions handled: " << maxErrorOcclusion
+            << ", ignored: " << maxErrorIgnored << std::endl;
+
+  if (!success) {
+    std::cerr << "testGenericTrackerMultiObject failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testGenericTrackerMultiObject is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable MBT module (VISP_HAVE_MODULE_MBT) to launch this test." << std::endl;
+  return 0;
+}
+#endif
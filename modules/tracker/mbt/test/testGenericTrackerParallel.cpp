@@ -0,0 +1,131 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the sequential and the parallel paths of vpMbGenericTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testGenericTrackerParallel.cpp
+
+  \brief Compare the sequential and the parallel per-camera and
+  per-primitive paths of vpMbGenericTracker on a synthetic stereo sequence of
+  a cube, with edge features on both cameras and dense depth features on the
+  first one.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/mbt/vpMbGenericTracker.h>
+
+#include "mbtTestCube.h"
+
+int main()
+{
+  mbtTestCube::vpTestDirectory tmp_dir("testGenericTrackerParallel");
+  const std::string model = tmp_dir.writeCubeModel();
+
+  vpCameraParameters cam(600, 600, 320, 240);
+  mbtTestCube::vpStereoTracker sequential(model, cam);
+  mbtTestCube::vpStereoTracker deterministic(model, cam);
+  mbtTestCube::vpStereoTracker reduction(model, cam);
+  mbtTestCube::vpStereoTracker movingEdge(model, cam);
+  mbtTestCube::vpStereoTracker depthDense(model, cam);
+
+  deterministic.setUseParallelTracking(true);
+  reduction.setUseParallelTracking(true);
+  reduction.setDeterministicParallelTracking(false);
+  movingEdge.setUseParallelMovingEdge(true);
+  movingEdge.setNbParallelMovingEdgeThreads(4);
+  movingEdge.setUseMovingEdgeGradientLookup(true);
+  depthDense.setUseParallelDepthDense(true);
+  depthDense.setNbParallelDepthDenseThreads(4);
+
+  const unsigned int nb_frames = 10;
+  vpImage<unsigned char> I1, I2;
+  std::vector<vpColVector> pointcloud1, pointcloud2;
+  bool success = true;
+
+  for (unsigned int frame = 0; frame < nb_frames && success; frame++) {
+    const vpHomogeneousMatrix c1Mo = mbtTestCube::cubePose(frame);
+    mbtTestCube::renderCube(c1Mo, cam, I1, pointcloud1);
+    mbtTestCube::renderCube(mbtTestCube::stereoTransformation() * c1Mo, cam, I2, pointcloud2);
+
+    if (frame == 0) {
+      const vpHomogeneousMatrix c1Mo_init = mbtTestCube::perturbedPose(c1Mo);
+      sequential.initStereo(I1, I2, c1Mo_init);
+      deterministic.initStereo(I1, I2, c1Mo_init);
+      reduction.initStereo(I1, I2, c1Mo_init);
+      movingEdge.initStereo(I1, I2, c1Mo_init);
+      depthDense.initStereo(I1, I2, c1Mo_init);
+    }
+
+    sequential.trackStereo(I1, I2, pointcloud1);
+    deterministic.trackStereo(I1, I2, pointcloud1);
+    reduction.trackStereo(I1, I2, pointcloud1);
+    movingEdge.trackStereo(I1, I2, pointcloud1);
+    depthDense.trackStereo(I1, I2, pointcloud1);
+
+    const vpHomogeneousMatrix cMo_seq = sequential.getPose();
+    success = mbtTestCube::checkPose(frame, "the deterministic parallel pose differs from the sequential one",
+                                     cMo_seq, deterministic.getPose(), 0) &&
+              success;
+    success = mbtTestCube::checkPose(frame, "the parallel pose differs from the sequential one", cMo_seq,
+                                     reduction.getPose(), 1e-6) &&
+              success;
+    success = mbtTestCube::checkPose(frame, "the parallel moving-edge pose differs from the sequential one", cMo_seq,
+                                     movingEdge.getPose(), 0) &&
+              success;
+    success = mbtTestCube::checkPose(frame, "the parallel dense depth pose differs from the sequential one", cMo_seq,
+                                     depthDense.getPose(), 0) &&
+              success;
+    success = mbtTestCube::checkTracking(frame, cMo_seq, c1Mo, 5e-3) && success;
+  }
+
+  if (!success) {
+    std::cerr << "testGenericTrackerParallel failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testGenericTrackerParallel is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable MBT module (VISP_HAVE_MODULE_MBT) to launch this test." << std::endl;
+  return 0;
+}
+#endif
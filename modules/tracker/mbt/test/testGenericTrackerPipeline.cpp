@@ -0,0 +1,221 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the asynchronous pipelined front-end of vpMbGenericTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testGenericTrackerPipeline.cpp
+
+  \brief Track a synthetic RGB-D sequence of a cube with
+  vpMbtTrackingPipeline: without dropped frames the poses must be identical
+  to the ones of the synchronous tracker, with the stale frames dropped
+  every frame must get a result and the last one must be tracked.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT) && (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/mbt/vpMbtTrackingPipeline.h>
+
+#include "mbtTestCube.h"
+
+namespace
+{
+// Color image and depth map in millimeters of the cube
+void renderFrame(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, vpImage<vpRGBa> &I_color,
+                 vpImage<uint16_t> &I_depth)
+{
+  vpImage<unsigned char> I;
+  std::vector<vpColVector> pointcloud;
+  mbtTestCube::renderCube(cMo, cam, I, pointcloud);
+  vpImageConvert::convert(I, I_color);
+
+  I_depth.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I_depth[i][j] = static_cast<uint16_t>(vpMath::round(pointcloud[i * I.getWidth() + j][2] * 1000.0));
+    }
+  }
+}
+
+// Start from a perturbed pose
+void initialize(mbtTestCube::vpStereoTracker &tracker, const vpImage<vpRGBa> &I1, const vpImage<vpRGBa> &I2)
+{
+  vpImage<unsigned char> I1_grey, I2_grey;
+  vpImageConvert::convert(I1, I1_grey);
+  vpImageConvert::convert(I2, I2_grey);
+  tracker.initStereo(I1_grey, I2_grey, mbtTestCube::perturbedPose(mbtTestCube::cubePose(0)));
+}
+}
+
+int main()
+{
+  mbtTestCube::vpTestDirectory tmp_dir("testGenericTrackerPipeline");
+  const std::string model = tmp_dir.writeCubeModel();
+
+  vpCameraParameters cam(600, 600, 320, 240);
+
+  const unsigned int nb_frames = 20;
+  std::vector<vpImage<vpRGBa> > images1(nb_frames), images2(nb_frames);
+  std::vector<vpImage<uint16_t> > depths1(nb_frames), depths2(nb_frames);
+  for (unsigned int frame = 0; frame < nb_frames; frame++) {
+    vpHomogeneousMatrix c1Mo = mbtTestCube::cubePose(frame);
+    renderFrame(c1Mo, cam, images1[frame], depths1[frame]);
+    renderFrame(mbtTestCube::stereoTransformation() * c1Mo, cam, images2[frame], depths2[frame]);
+  }
+
+  bool success = true;
+
+  // Without dropped frames, the pipeline gives the poses of the synchronous tracker
+  {
+    mbtTestCube::vpStereoTracker synchronous(model, cam);
+    mbtTestCube::vpStereoTracker pipelined(model, cam);
+    initialize(synchronous, images1[0], images2[0]);
+    initialize(pipelined, images1[0], images2[0]);
+
+    vpMbtTrackingPipeline pipeline(pipelined, 2, vpMbtTrackingPipeline::BLOCK_WHEN_FULL);
+    std::vector<std::future<vpMbtTrackingPipeline::vpTrackingResult> > futures;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int frame = 0; frame < nb_frames; frame++) {
+      std::map<std::string, const vpImage<vpRGBa> *> mapOfColorImages;
+      mapOfColorImages["Camera1"] = &images1[frame];
+      mapOfColorImages["Camera2"] = &images2[frame];
+      std::map<std::string, const vpImage<uint16_t> *> mapOfDepthImages;
+      mapOfDepthImages["Camera1"] = &depths1[frame];
+      futures.push_back(pipeline.push(mapOfColorImages, mapOfDepthImages));
+    }
+    pipeline.flush();
+    const double t_pipeline = vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int frame = 0; frame < nb_frames && success; frame++) {
+      vpImage<unsigned char> I1, I2;
+      std::vector<vpColVector> pointcloud;
+      vpImageConvert::convert(images1[frame], I1);
+      vpImageConvert::convert(images2[frame], I2);
+      vpMbtTrackingPipeline::convertDepthToPointCloud(depths1[frame], cam, 0.001, pointcloud);
+      synchronous.trackStereo(I1, I2, pointcloud);
+
+      vpMbtTrackingPipeline::vpTrackingResult result = futures[frame].get();
+      if (result.dropped || result.frameIndex != frame) {
+        std::cerr << "Frame " << frame << ": unexpected result of frame " << result.frameIndex
+                  << (result.dropped ? ", dropped" : "") << std::endl;
+        success = false;
+      } else {
+        success = mbtTestCube::checkPose(frame, "the pipelined pose differs from the synchronous one",
+                                         synchronous.getPose(), result.cMo, 0) &&
+                  mbtTestCube::checkTracking(frame, result.cMo, mbtTestCube::cubePose(frame), 5e-3) && success;
+      }
+    }
+    const double t_synchronous = vpTime::measureTimeMs() - t;
+
+    std::cout << "Blocking pipeline: " << pipeline.getNbTracked() << " frames tracked in " << t_pipeline
+              << " ms (preprocessing " << pipeline.getMeanPreprocessingTime() << " ms, tracking "
+              << pipeline.getMeanTrackingTime() << " ms per frame), synchronous: " << t_synchronous << " ms"
+              << std::endl;
+    if (pipeline.getNbTracked() != nb_frames || pipeline.getNbDropped() != 0) {
+      std::cerr << "The blocking pipeline tracked " << pipeline.getNbTracked() << " frames and dropped "
+                << pipeline.getNbDropped() << std::endl;
+      success = false;
+    }
+  }
+
+  // Frames pushed by bursts of three: the stale ones are dropped and the motion of the dropped frames is predicted
+  {
+    mbtTestCube::vpStereoTracker tracker(model, cam);
+    initialize(tracker, images1[0], images2[0]);
+    tracker.getPosePredictor().setPredictionModel(vpMbtPosePredictor::CONSTANT_VELOCITY);
+
+    vpMbtTrackingPipeline pipeline(tracker, 1, vpMbtTrackingPipeline::DROP_STALE_FRAMES);
+    std::vector<std::future<vpMbtTrackingPipeline::vpTrackingResult> > futures;
+    for (unsigned int frame = 0; frame < nb_frames; frame++) {
+      std::map<std::string, const vpImage<vpRGBa> *> mapOfColorImages;
+      mapOfColorImages["Camera1"] = &images1[frame];
+      mapOfColorImages["Camera2"] = &images2[frame];
+      std::map<std::string, const vpImage<uint16_t> *> mapOfDepthImages;
+      mapOfDepthImages["Camera1"] = &depths1[frame];
+      futures.push_back(pipeline.push(mapOfColorImages, mapOfDepthImages, static_cast<double>(frame)));
+      if (frame % 3 == 2) {
+        pipeline.flush();
+      }
+    }
+    pipeline.flush();
+
+    unsigned int nbDropped = 0;
+    for (unsigned int frame = 0; frame < nb_frames; frame++) {
+      vpMbtTrackingPipeline::vpTrackingResult result;
+      try {
+        result = futures[frame].get();
+      } catch (const vpException &e) {
+        std::cerr << "Frame " << frame << ": " << e.getStringMessage() << std::endl;
+        success = false;
+        continue;
+      }
+      if (result.dropped) {
+        nbDropped++;
+      } else {
+        success = mbtTestCube::checkTracking(frame, result.cMo, mbtTestCube::cubePose(frame), 5e-3) && success;
+      }
+      if (frame == nb_frames - 1 && result.dropped) {
+        std::cerr << "The last frame was dropped" << std::endl;
+        success = false;
+      }
+    }
+
+    std::cout << "Dropping pipeline: " << pipeline.getNbTracked() << " frames tracked, " << pipeline.getNbDropped()
+              << " dropped" << std::endl;
+    if (nbDropped != pipeline.getNbDropped() || pipeline.getNbTracked() + pipeline.getNbDropped() + pipeline.getNbFailed() != nb_frames) {
+      std::cerr << "Inconsistent frame counters" << std::endl;
+      success = false;
+    }
+  }
+
+  if (!success) {
+    std::cerr << "testGenericTrackerPipeline failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testGenericTrackerPipeline is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable MBT module (VISP_HAVE_MODULE_MBT) and C++11 to launch this test." << std::endl;
+  return 0;
+}
+#endif
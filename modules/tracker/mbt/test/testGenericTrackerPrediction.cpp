@@ -0,0 +1,252 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the motion model pose prediction of vpMbGenericTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testGenericTrackerPrediction.cpp
+
+  \brief Test the motion models of vpMbtPosePredictor on exact motions, then
+  track a synthetic sequence of a cube moving fast with vpMbGenericTracker,
+  with and without pose prediction, and compare the number of iterations of
+  the pose estimation.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/core/vpExponentialMap.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+
+#include "mbtTestCube.h"
+
+namespace
+{
+// Pose of the cube at time t, the camera moves with a constant twist and a constant acceleration
+vpHomogeneousMatrix groundTruth(double t, double acceleration)
+{
+  vpHomogeneousMatrix c0Mo(0.05, -0.06, 0.45, vpMath::rad(30), vpMath::rad(-35), vpMath::rad(10));
+  vpColVector v(6);
+  v[0] = 0.004;
+  v[1] = 0.003;
+  v[2] = -0.002;
+  v[3] = vpMath::rad(0.5);
+  v[4] = vpMath::rad(-0.8);
+  v[5] = vpMath::rad(1.5);
+  // Integral of (1 + acceleration * t) between 0 and t
+  return vpExponentialMap::direct(v, t + acceleration * t * t / 2).inverse() * c0Mo;
+}
+
+bool testPredictor()
+{
+  bool success = true;
+  vpMbtPosePredictor predictor;
+  predictor.setPredictionModel(vpMbtPosePredictor::CONSTANT_VELOCITY);
+
+  // Constant twist with irregular timestamps: the prediction is exact
+  const double timestamps[5] = {0.0, 0.04, 0.07, 0.12, 0.15};
+  for (unsigned int k = 0; k < 5; k++) {
+    vpHomogeneousMatrix cMo = groundTruth(timestamps[k] * 25, 0), cMo_pred;
+    predictor.setTimestamp(timestamps[k]);
+    bool predicted = predictor.predict(predictor.getNbFrames() > 0 ? groundTruth(timestamps[k - 1] * 25, 0) : cMo,
+                                       cMo_pred);
+    if (predicted != (k >= 2) || (predicted && !mbtTestCube::samePose(cMo_pred, cMo, 1e-9))) {
+      std::cerr << "Constant velocity prediction " << k << " is wrong:\n" << cMo_pred << "\n" << cMo << std::endl;
+      success = false;
+    }
+    predictor.update(cMo);
+  }
+
+  // Constant acceleration, evenly spaced frames: the twist is extrapolated exactly
+  predictor.reset();
+  predictor.resetStatistics();
+  predictor.setPredictionModel(vpMbtPosePredictor::CONSTANT_ACCELERATION);
+  vpHomogeneousMatrix cMo_prev;
+  for (unsigned int k = 0; k < 6; k++) {
+    vpHomogeneousMatrix cMo = groundTruth(k, 0.2), cMo_pred;
+    bool predicted = predictor.predict(k > 0 ? cMo_prev : cMo, cMo_pred);
+    if (predicted != (k >= 2) || (k >= 3 && !mbtTestCube::samePose(cMo_pred, cMo, 1e-9))) {
+      std::cerr << "Constant acceleration prediction " << k << " is wrong:\n" << cMo_pred << "\n" << cMo << std::endl;
+      success = false;
+    }
+    predictor.update(cMo, 2);
+    cMo_prev = cMo;
+  }
+  if (predictor.getNbFrames() != 6 || predictor.getNbPredictions() != 4 || predictor.getNbIterations() != 12) {
+    std::cerr << "Wrong predictor statistics" << std::endl;
+    success = false;
+  }
+
+  // An external twist alone predicts the motion
+  predictor.reset();
+  predictor.setPredictionModel(vpMbtPosePredictor::CONSTANT_VELOCITY);
+  vpHomogeneousMatrix cMo0 = groundTruth(0, 0), cMo1 = groundTruth(1, 0), cMo_pred;
+  predictor.predict(cMo0, cMo_pred);
+  predictor.update(cMo0);
+  predictor.setExternalVelocity(vpExponentialMap::inverse(cMo0 * cMo1.inverse()));
+  if (!predictor.predict(cMo0, cMo_pred) || !mbtTestCube::samePose(cMo_pred, cMo1, 1e-9)) {
+    std::cerr << "Prediction with an external twist is wrong:\n" << cMo_pred << "\n" << cMo1 << std::endl;
+    success = false;
+  }
+
+  // A pose modified by an initialization resets the motion history
+  predictor.update(cMo1);
+  if (predictor.predict(cMo0, cMo_pred)) {
+    std::cerr << "The motion history is not reset by a new pose" << std::endl;
+    success = false;
+  }
+
+  return success;
+}
+
+bool trackSequence(const std::string &model, const vpMbtPosePredictor::vpPredictionModel &predictionModel,
+                   double acceleration, vpMbtPosePredictor &stats)
+{
+  vpCameraParameters cam(600, 600, 320, 240);
+  vpMbGenericTracker tracker(1, vpMbGenericTracker::EDGE_TRACKER | vpMbGenericTracker::DEPTH_DENSE_TRACKER);
+  mbtTestCube::configure(tracker, model, cam, 15);
+  tracker.getPosePredictor().setPredictionModel(predictionModel);
+
+  const unsigned int nb_frames = 20;
+  vpImage<unsigned char> I;
+  std::vector<vpColVector> pointcloud;
+  bool success = true;
+
+  for (unsigned int frame = 0; frame < nb_frames && success; frame++) {
+    vpHomogeneousMatrix cMo = groundTruth(frame, acceleration);
+    mbtTestCube::renderCube(cMo, cam, I, pointcloud);
+
+    if (frame == 0) {
+      tracker.initFromPose(I, cMo);
+    }
+
+    try {
+      std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
+      mapOfImages["Camera"] = &I;
+      std::map<std::string, const std::vector<vpColVector> *> mapOfPointClouds;
+      mapOfPointClouds["Camera"] = &pointcloud;
+      std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
+      mapOfWidths["Camera"] = I.getWidth();
+      mapOfHeights["Camera"] = I.getHeight();
+
+      tracker.track(mapOfImages, mapOfPointClouds, mapOfWidths, mapOfHeights);
+    } catch (const vpException &e) {
+      std::cerr << "Frame " << frame << ": " << e.what() << std::endl;
+      success = false;
+      break;
+    }
+
+    success = mbtTestCube::checkTracking(frame, tracker.getPose(), cMo, 5e-3) && success;
+  }
+
+  stats = tracker.getPosePredictor();
+  return success;
+}
+}
+
+int main()
+{
+  if (!testPredictor()) {
+    std::cerr << "testGenericTrackerPrediction failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  mbtTestCube::vpTestDirectory tmp_dir("testGenericTrackerPrediction");
+  const std::string model = tmp_dir.writeCubeModel();
+
+  const char *names[3] = {"no prediction", "constant velocity", "constant acceleration"};
+  const vpMbtPosePredictor::vpPredictionModel models[3] = {vpMbtPosePredictor::NO_PREDICTION,
+                                                           vpMbtPosePredictor::CONSTANT_VELOCITY,
+                                                           vpMbtPosePredictor::CONSTANT_ACCELERATION};
+  const double accelerations[2] = {0.0, 0.03};
+  bool success = true;
+
+  for (unsigned int a = 0; a < 2; a++) {
+    std::cout << (accelerations[a] > 0 ? "Accelerated motion" : "Constant velocity motion") << std::endl;
+    double meanIterations[3];
+    for (unsigned int m = 0; m < 3; m++) {
+      vpMbtPosePredictor stats;
+      if (!trackSequence(model, models[m], accelerations[a], stats)) {
+        if (models[m] == vpMbtPosePredictor::NO_PREDICTION && accelerations[a] > 0) {
+          // The motion ends up larger than the moving-edges search range
+          std::cout << "  " << names[m] << ": object lost after " << stats.getNbFrames() << " frames" << std::endl;
+        } else {
+          std::cerr << "Tracking with " << names[m] << " failed" << std::endl;
+          success = false;
+        }
+      }
+
+      double motion[2], error[2];
+      stats.getMeanMotion(motion[0], motion[1]);
+      stats.getMeanPredictionError(error[0], error[1]);
+      meanIterations[m] = stats.getMeanIterations();
+      std::cout << "  " << names[m] << ": " << meanIterations[m] << " iterations per frame";
+      if (stats.getNbPredictions() > 0) {
+        std::cout << ", prediction error " << error[0] * 1000 << " mm " << vpMath::deg(error[1])
+                  << " deg against a motion of " << motion[0] * 1000 << " mm " << vpMath::deg(motion[1]) << " deg";
+        if (error[0] >= motion[0] || error[1] >= motion[1]) {
+          std::cerr << "The prediction error is larger than the motion" << std::endl;
+          success = false;
+        }
+      }
+      std::cout << std::endl;
+    }
+
+    for (unsigned int m = 1; m < 3; m++) {
+      std::cout << "  " << names[m] << " saves " << 100 * (1 - meanIterations[m] / meanIterations[0])
+                << "% of the iterations" << std::endl;
+      if (meanIterations[m] >= meanIterations[0]) {
+        std::cerr << "The prediction does not reduce the number of iterations" << std::endl;
+        success = false;
+      }
+    }
+  }
+
+  if (!success) {
+    std::cerr << "testGenericTrackerPrediction failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testGenericTrackerPrediction is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable MBT module (VISP_HAVE_MODULE_MBT) to launch this test." << std::endl;
+  return 0;
+}
+#endif
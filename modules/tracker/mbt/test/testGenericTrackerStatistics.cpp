@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the tracking statistics of vpMbGenericTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testGenericTrackerStatistics.cpp
+
+  \brief Check the timings and counters measured by vpMbGenericTracker on a
+  synthetic stereo sequence of a cube, with edge features on both cameras and
+  dense depth features on the first one, and check that measuring them does
+  not change the estimated pose.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/mbt/vpMbGenericTracker.h>
+
+#include "mbtTestCube.h"
+
+namespace
+{
+bool checkStatistics(const vpMbGenericTracker &tracker, unsigned int frame)
+{
+  vpMbtTrackingStatistics stats = tracker.getTrackingStatistics();
+  std::map<std::string, vpMbtTrackingStatistics> mapOfStats;
+  tracker.getTrackingStatistics(mapOfStats);
+
+  bool success = true;
+  if (stats.nbIterations == 0 || stats.totalTime <= 0 || stats.residual > stats.initialResidual) {
+    std::cerr << "Frame " << frame << ": wrong statistics\n" << stats << std::endl;
+    success = false;
+  }
+  if (mapOfStats.size() != 2 || mapOfStats["Camera1"].nbDepthDenseFeatures == 0 ||
+      mapOfStats["Camera2"].nbDepthDenseFeatures != 0 || mapOfStats["Camera1"].nbEdgeFeatures == 0 ||
+      mapOfStats["Camera2"].nbEdgeFeatures == 0) {
+    std::cerr << "Frame " << frame << ": wrong number of features per camera" << std::endl;
+    success = false;
+  }
+
+  unsigned int nbFeatures = 0, nbRejected = 0;
+  double time = 0;
+  for (std::map<std::string, vpMbtTrackingStatistics>::const_iterator it = mapOfStats.begin();
+       it != mapOfStats.end(); ++it) {
+    nbFeatures += it->second.getNbFeatures();
+    nbRejected += it->second.getNbRejected();
+    time += it->second.visibilityTime + it->second.edgeTime + it->second.depthDenseTime +
+            it->second.jacobianTime + it->second.weightingTime;
+    if (it->second.nbIterations != stats.nbIterations || it->second.getNbRejected() > it->second.getNbFeatures()) {
+      std::cerr << "Frame " << frame << ": wrong statistics for " << it->first << "\n" << it->second << std::endl;
+      success = false;
+    }
+  }
+  if (nbFeatures != stats.getNbFeatures() || nbFeatures != tracker.getError().getRows() ||
+      nbRejected != stats.getNbRejected()) {
+    std::cerr << "Frame " << frame << ": the features of the cameras do not sum up" << std::endl;
+    success = false;
+  }
+  if (time + stats.solveTime > stats.totalTime + 1e-6) {
+    std::cerr << "Frame " << frame << ": the stage times exceed the total time\n" << stats << std::endl;
+    success = false;
+  }
+
+  return success;
+}
+}
+
+int main()
+{
+  mbtTestCube::vpTestDirectory tmp_dir("testGenericTrackerStatistics");
+  const std::string model = tmp_dir.writeCubeModel();
+
+  vpCameraParameters cam(600, 600, 320, 240);
+  mbtTestCube::vpStereoTracker reference(model, cam);
+  mbtTestCube::vpStereoTracker measured(model, cam);
+  measured.setUseTrackingStatistics(true);
+
+  const unsigned int nb_frames = 10;
+  vpImage<unsigned char> I1, I2;
+  std::vector<vpColVector> pointcloud1, pointcloud2;
+  bool success = true;
+
+  for (unsigned int frame = 0; frame < nb_frames && success; frame++) {
+    const vpHomogeneousMatrix c1Mo = mbtTestCube::cubePose(frame);
+    mbtTestCube::renderCube(c1Mo, cam, I1, pointcloud1);
+    mbtTestCube::renderCube(mbtTestCube::stereoTransformation() * c1Mo, cam, I2, pointcloud2);
+
+    if (frame == 0) {
+      reference.initStereo(I1, I2, c1Mo);
+      measured.initStereo(I1, I2, c1Mo);
+    }
+
+    reference.trackStereo(I1, I2, pointcloud1);
+    measured.trackStereo(I1, I2, pointcloud1);
+
+    success = mbtTestCube::checkPose(frame, "measuring the statistics changes the pose", reference.getPose(),
+                                     measured.getPose(), 0) &&
+              success;
+    if (reference.getTrackingStatistics().totalTime != 0 || reference.getTrackingStatistics().nbIterations != 0) {
+      std::cerr << "Frame " << frame << ": statistics measured while disabled" << std::endl;
+      success = false;
+    }
+    success = checkStatistics(measured, frame) && success;
+  }
+
+  std::cout << measured.getTrackingStatistics() << std::endl;
+
+  if (!success) {
+    std::cerr << "testGenericTrackerStatistics failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testGenericTrackerStatistics is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable MBT module (VISP_HAVE_MODULE_MBT) to launch this test." << std::endl;
+  return 0;
+}
+#endif
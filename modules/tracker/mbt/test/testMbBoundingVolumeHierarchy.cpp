@@ -0,0 +1,308 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the bounding volume hierarchy used by the ray casting visibility test.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbBoundingVolumeHierarchy.cpp
+
+  \brief Check that the frustum culling and the occlusion queries of the
+  bounding volume hierarchy give the same results as the per-polygon tests,
+  and check the ray casting visibility test of vpMbHiddenFaces on scenes of
+  boxes.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/core/vpTime.h>
+#include <visp3/mbt/vpMbBoundingVolumeHierarchy.h>
+#include <visp3/mbt/vpMbHiddenFaces.h>
+
+namespace
+{
+double random(double a, double b) { return a + (b - a) * rand() / (double)RAND_MAX; }
+
+// Faces of a box of size s placed at oMb, oriented toward the outside
+void boxFaces(const vpHomogeneousMatrix &oMb, double sx, double sy, double sz,
+              std::vector<std::vector<vpPoint> > &polygons)
+{
+  const double V[8][3] = {{0, 0, 0},  {sx, 0, 0},  {sx, sy, 0},  {0, sy, 0},
+                          {0, 0, sz}, {sx, 0, sz}, {sx, sy, sz}, {0, sy, sz}};
+  const int F[6][4] = {{0, 4, 5, 1}, {1, 5, 6, 2}, {6, 7, 3, 2}, {3, 7, 4, 0}, {0, 1, 2, 3}, {7, 6, 5, 4}};
+  for (int f = 0; f < 6; f++) {
+    std::vector<vpPoint> polygon;
+    for (int k = 0; k < 4; k++) {
+      vpPoint pt(V[F[f][k]][0], V[F[f][k]][1], V[F[f][k]][2]);
+      pt.changeFrame(oMb);
+      pt.setWorldCoordinates(pt.get_X(), pt.get_Y(), pt.get_Z());
+      polygon.push_back(pt);
+    }
+    polygons.push_back(polygon);
+  }
+}
+
+// Random boxes in [-1, 1]^3 and a few lines that never occlude
+void randomScene(unsigned int nbBoxes, std::vector<std::vector<vpPoint> > &polygons, std::vector<bool> &occluders)
+{
+  polygons.clear();
+  for (unsigned int n = 0; n < nbBoxes; n++) {
+    vpHomogeneousMatrix oMb(random(-1, 1), random(-1, 1), random(-1, 1), random(-M_PI, M_PI), random(-M_PI, M_PI),
+                            random(-M_PI, M_PI));
+    boxFaces(oMb, random(0.02, 0.2), random(0.02, 0.2), random(0.02, 0.2), polygons);
+  }
+  for (unsigned int n = 0; n < 10; n++) {
+    std::vector<vpPoint> line(2);
+    line[0].setWorldCoordinates(random(-1, 1), random(-1, 1), random(-1, 1));
+    line[1].setWorldCoordinates(random(-1, 1), random(-1, 1), random(-1, 1));
+    polygons.push_back(line);
+  }
+  occluders.assign(polygons.size(), true);
+}
+
+vpHomogeneousMatrix randomPose()
+{
+  // Camera at about 3 m from the center of the scene, looking toward it
+  vpHomogeneousMatrix cMo(random(-0.5, 0.5), random(-0.5, 0.5), random(2.5, 3.5), random(-0.3, 0.3),
+                          random(-0.3, 0.3), random(-M_PI, M_PI));
+  return cMo;
+}
+
+bool testQueries()
+{
+  srand(0);
+  std::vector<std::vector<vpPoint> > polygons;
+  std::vector<bool> occluders;
+  randomScene(500, polygons, occluders);
+
+  vpMbBoundingVolumeHierarchy bvh, linear;
+  bvh.build(polygons, occluders);
+  linear.setMaxLeafSize(static_cast<unsigned int>(polygons.size()));
+  linear.build(polygons, occluders);
+  if (linear.getNbNodes() != 1 || bvh.getNbNodes() < 2 || bvh.getNbPolygons() != polygons.size()) {
+    std::cerr << "Unexpected hierarchy: " << bvh.getNbNodes() << " nodes" << std::endl;
+    return false;
+  }
+
+  vpCameraParameters cam(600, 600, 320, 240);
+  unsigned int nbInside = 0, nbOccluded = 0, nbRays = 0;
+  double t_bvh = 0, t_linear = 0;
+  for (unsigned int n = 0; n < 20; n++) {
+    vpHomogeneousMatrix cMo = randomPose();
+    if (n == 0) {
+      // Some boxes are behind the camera
+      cMo[2][3] = 0.5;
+    }
+
+    std::vector<bool> in1, in2;
+    bvh.frustumCulling(cMo, cam, 640, 480, in1);
+    linear.frustumCulling(cMo, cam, 640, 480, in2);
+    if (in1 != in2) {
+      std::cerr << "Pose " << n << ": the frustum culling differs" << std::endl;
+      return false;
+    }
+    for (size_t i = 0; i < in1.size(); i++) {
+      nbInside += in1[i] ? 1 : 0;
+    }
+
+    // Rays from the camera to the centroid of each face
+    vpColVector origin(3), target(3);
+    vpTranslationVector oTc = cMo.inverse().getTranslationVector();
+    for (unsigned int k = 0; k < 3; k++) {
+      origin[k] = oTc[k];
+    }
+    for (unsigned int i = 0; i < polygons.size(); i++) {
+      target = 0;
+      for (size_t j = 0; j < polygons[i].size(); j++) {
+        target[0] += polygons[i][j].get_oX() / polygons[i].size();
+        target[1] += polygons[i][j].get_oY() / polygons[i].size();
+        target[2] += polygons[i][j].get_oZ() / polygons[i].size();
+      }
+      double t0 = vpTime::measureTimeMs();
+      bool o1 = bvh.isOccluded(origin, target, static_cast<int>(i));
+      double t1 = vpTime::measureTimeMs();
+      bool o2 = linear.isOccluded(origin, target, static_cast<int>(i));
+      double t2 = vpTime::measureTimeMs();
+      t_bvh += t1 - t0;
+      t_linear += t2 - t1;
+      if (o1 != o2) {
+        std::cerr << "Pose " << n << ": the occlusion of polygon " << i << " differs" << std::endl;
+        return false;
+      }
+      nbOccluded += o1 ? 1 : 0;
+      nbRays++;
+    }
+  }
+
+  std::cout << "Frustum culling: " << nbInside << " polygons inside over 20 poses" << std::endl;
+  std::cout << "Occlusion: " << nbOccluded << " / " << nbRays << " rays occluded, hierarchy " << t_bvh
+            << " ms, per-polygon " << t_linear << " ms" << std::endl;
+  if (nbInside == 0 || nbOccluded == 0 || nbOccluded == nbRays) {
+    std::cerr << "Degenerated scene" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+void addFaces(vpMbHiddenFaces<vpMbtPolygon> &faces, const std::vector<std::vector<vpPoint> > &polygons)
+{
+  for (unsigned int i = 0; i < polygons.size(); i++) {
+    vpMbtPolygon polygon;
+    polygon.setNbPoint(static_cast<unsigned int>(polygons[i].size()));
+    for (unsigned int j = 0; j < polygons[i].size(); j++) {
+      polygon.addPoint(j, polygons[i][j]);
+    }
+    polygon.setIndex(static_cast<int>(i));
+    faces.addPolygon(&polygon);
+  }
+}
+
+bool testHiddenFaces()
+{
+  // A small box hidden behind a large one, and a third box on the side
+  std::vector<std::vector<vpPoint> > polygons;
+  boxFaces(vpHomogeneousMatrix(-0.2, -0.2, 0, 0, 0, 0), 0.4, 0.4, 0.4, polygons);
+  boxFaces(vpHomogeneousMatrix(-0.05, -0.05, 1, 0, 0, 0), 0.1, 0.1, 0.1, polygons);
+  boxFaces(vpHomogeneousMatrix(0.5, -0.05, 0.5, 0, 0, 0), 0.1, 0.1, 0.1, polygons);
+
+  vpMbHiddenFaces<vpMbtPolygon> faces;
+  addFaces(faces, polygons);
+  faces.setRayCastingVisibilityTest(true);
+
+  vpCameraParameters cam(600, 600, 320, 240);
+  vpHomogeneousMatrix cMo(0, 0, 2, 0, 0, 0);
+  bool changed = false;
+  unsigned int nb = faces.setVisible(640, 480, cam, cMo, vpMath::rad(89), vpMath::rad(89), changed);
+
+  // Only the front face of the large box and the front and inner faces of the side box are not hidden
+  for (unsigned int i = 0; i < faces.size(); i++) {
+    bool expected = (i == 4 || i == 15 || i == 16);
+    if (faces.isVisible(i) != expected) {
+      std::cerr << "Face " << i << " visibility " << faces.isVisible(i) << " instead of " << expected << std::endl;
+      return false;
+    }
+  }
+  if (nb != 3 || !changed) {
+    std::cerr << nb << " visible faces instead of 3" << std::endl;
+    return false;
+  }
+
+  // Out of the field of view
+  cMo.buildFrom(3, 0, 2, 0, 0, 0);
+  nb = faces.setVisible(640, 480, cam, cMo, vpMath::rad(89), vpMath::rad(89), changed);
+  if (nb != 0) {
+    std::cerr << nb << " visible faces out of the field of view" << std::endl;
+    return false;
+  }
+
+  // Same flags as the per-face tests on a larger scene, with several rays per face
+  srand(0);
+  std::vector<bool> occluders;
+  randomScene(200, polygons, occluders);
+  vpMbHiddenFaces<vpMbtPolygon> faces_bvh, faces_linear;
+  addFaces(faces_bvh, polygons);
+  addFaces(faces_linear, polygons);
+  faces_linear.getBoundingVolumeHierarchy().setMaxLeafSize(faces_linear.size());
+  faces_linear.computeBoundingVolumeHierarchy();
+
+  vpMbHiddenFaces<vpMbtPolygon> *both[2] = {&faces_bvh, &faces_linear};
+  for (unsigned int k = 0; k < 2; k++) {
+    both[k]->setRayCastingVisibilityTest(true);
+    both[k]->setNbRayCastingAttemptsForVisibility(5);
+    both[k]->setGoodNbRayCastingAttemptsRatio(0.6);
+  }
+
+  double t_bvh = 0, t_linear = 0;
+  for (unsigned int n = 0; n < 20; n++) {
+    cMo = randomPose();
+    bool changed_bvh = false, changed_linear = false;
+    unsigned int seed = rand();
+
+    srand(seed);
+    double t0 = vpTime::measureTimeMs();
+    unsigned int nb_bvh =
+        faces_bvh.setVisible(640, 480, cam, cMo, vpMath::rad(80), vpMath::rad(85), changed_bvh);
+    double t1 = vpTime::measureTimeMs();
+    srand(seed);
+    unsigned int nb_linear =
+        faces_linear.setVisible(640, 480, cam, cMo, vpMath::rad(80), vpMath::rad(85), changed_linear);
+    double t2 = vpTime::measureTimeMs();
+    t_bvh += t1 - t0;
+    t_linear += t2 - t1;
+
+    if (nb_bvh != nb_linear || changed_bvh != changed_linear || nb_bvh == 0) {
+      std::cerr << "Pose " << n << ": " << nb_bvh << " and " << nb_linear << " visible faces" << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < faces_bvh.size(); i++) {
+      if (faces_bvh.isVisible(i) != faces_linear.isVisible(i) ||
+          faces_bvh.isAppearing(i) != faces_linear.isAppearing(i)) {
+        std::cerr << "Pose " << n << ": the visibility of face " << i << " differs" << std::endl;
+        return false;
+      }
+    }
+  }
+  std::cout << "Visibility of " << faces_bvh.size() << " faces: hierarchy " << t_bvh / 20 << " ms, per-face "
+            << t_linear / 20 << " ms" << std::endl;
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    if (!testQueries() || !testHiddenFaces()) {
+      std::cerr << "testMbBoundingVolumeHierarchy failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testMbBoundingVolumeHierarchy is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+#else
+int main()
+{
+  std::cout << "Cannot run this example: visp_mbt module is not available." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
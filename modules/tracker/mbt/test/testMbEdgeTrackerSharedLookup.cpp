@@ -0,0 +1,146 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the moving-edge lookup shared between model-based edge trackers.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbEdgeTrackerSharedLookup.cpp
+
+  \brief Bind the moving-edge lookup of a vpMbEdgeTracker sharing the lookup
+  of another owner, with frames rendered in the same image buffer. When the
+  owner does not update the shared lookup after the image is overwritten, the
+  tracker must use its own lookup for every stage of that frame.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/mbt/vpMbEdgeTracker.h>
+#include <visp3/me/vpMeGradientLookup.h>
+
+namespace
+{
+// Give access to the lookup bound by the stages of the tracking
+class vpMbEdgeTrackerLookup : public vpMbEdgeTracker
+{
+public:
+  const vpMeGradientLookup *bind(const vpImage<unsigned char> &I, bool newFrame)
+  {
+    bindMovingEdgeGradientLookup(I, newFrame);
+    return me.getGradientLookup();
+  }
+};
+
+void render(unsigned int frame, vpImage<unsigned char> &I)
+{
+  I.resize(120, 160);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = (j + 3 * frame) % 40 < 20 ? 50 : 200;
+    }
+  }
+}
+
+bool check(const std::string &stage, const vpMeGradientLookup *bound, const vpMeGradientLookup *expected)
+{
+  if (bound != expected) {
+    std::cerr << stage << ": the bound lookup is not the expected one" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  vpMbEdgeTrackerLookup tracker;
+  tracker.setUseMovingEdgeGradientLookup(true);
+  vpMeGradientLookup lookup;
+  tracker.setSharedMovingEdgeGradientLookup(&lookup);
+
+  // All the frames are rendered in the same image buffer
+  vpImage<unsigned char> I;
+  bool success = true;
+
+  // Not updated since it was shared
+  render(0, I);
+  const vpMeGradientLookup *own = tracker.bind(I, true);
+  if (own == &lookup || own == NULL) {
+    std::cerr << "Frame 0: the shared lookup is used before its first update" << std::endl;
+    success = false;
+  }
+  success = check("Frame 0, next stage", tracker.bind(I, false), own) && success;
+
+  for (unsigned int frame = 1; frame < 7; frame++) {
+    render(frame, I);
+    // The owner forgets to update the lookup every third frame
+    const bool updated = frame % 3 != 0;
+    if (updated) {
+      lookup.update(I, tracker.getMovingEdge());
+    }
+    const vpMeGradientLookup *expected = updated ? &lookup : own;
+
+    std::ostringstream name;
+    name << "Frame " << frame << (updated ? "" : " (lookup not updated)");
+    success = check(name.str() + ", first stage", tracker.bind(I, true), expected) && success;
+    success = check(name.str() + ", next stage", tracker.bind(I, false), expected) && success;
+    success = check(name.str() + ", last stage", tracker.bind(I, false), expected) && success;
+  }
+
+  // A shared lookup updated with another image is not used
+  vpImage<unsigned char> I2;
+  render(7, I2);
+  lookup.update(I2, tracker.getMovingEdge());
+  render(7, I);
+  success = check("Lookup of another image, first stage", tracker.bind(I, true), own) && success;
+  success = check("Lookup of another image, next stage", tracker.bind(I, false), own) && success;
+
+  if (!success) {
+    std::cerr << "testMbEdgeTrackerSharedLookup failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testMbEdgeTrackerSharedLookup is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable MBT module (VISP_HAVE_MODULE_MBT) to launch this test." << std::endl;
+  return 0;
+}
+#endif
@@ -0,0 +1,393 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the tiled, parallel and incremental scanline rendering.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbScanLine.cpp
+
+  \brief Check that the concurrent and tiled scanline renderings give the
+  same visibility as the sequential one, compare the primitive ids with a
+  ray casting of the scene, and check the sub-sampled and the incremental
+  renderings on random scenes of boxes.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/mbt/vpMbScanLine.h>
+
+namespace
+{
+typedef std::vector<std::pair<vpPoint, unsigned int> > vpPolygonPoints;
+
+struct vpBox {
+  vpHomogeneousMatrix cMo;
+  double size[3];
+};
+
+double random(double a, double b) { return a + (b - a) * rand() / (double)RAND_MAX; }
+
+void boxFaces(const vpBox &box, const vpHomogeneousMatrix &dcM, std::vector<vpPolygonPoints> &polygons)
+{
+  const double sx = box.size[0], sy = box.size[1], sz = box.size[2];
+  const double V[8][3] = {{0, 0, 0},   {sx, 0, 0},   {sx, sy, 0},   {0, sy, 0},
+                          {0, 0, sz},  {sx, 0, sz},  {sx, sy, sz},  {0, sy, sz}};
+  const int F[6][4] = {{0, 4, 5, 1}, {1, 5, 6, 2}, {6, 7, 3, 2}, {3, 7, 4, 0}, {0, 1, 2, 3}, {7, 6, 5, 4}};
+  for (int f = 0; f < 6; f++) {
+    vpPolygonPoints polygon;
+    for (int k = 0; k < 4; k++) {
+      vpPoint pt(V[F[f][k]][0], V[F[f][k]][1], V[F[f][k]][2]);
+      pt.changeFrame(dcM * box.cMo);
+      polygon.push_back(std::make_pair(pt, 0u));
+    }
+    polygons.push_back(polygon);
+  }
+}
+
+// Boxes that may intersect each other, or that are in separate depth ranges
+void randomScene(std::vector<vpBox> &boxes, bool separated = false)
+{
+  boxes.resize(1 + rand() % 4);
+  for (size_t b = 0; b < boxes.size(); b++) {
+    for (int k = 0; k < 3; k++) {
+      boxes[b].size[k] = separated ? random(0.05, 0.15) : random(0.05, 0.3);
+    }
+    const double z = separated ? 0.6 + 0.35 * b : random(0.6, 1.5);
+    boxes[b].cMo.buildFrom(random(-0.2, 0.2), random(-0.2, 0.2), z, random(-3, 3), random(-3, 3), random(-3, 3));
+  }
+}
+
+void draw(vpMbScanLine &scanline, const std::vector<vpBox> &boxes, const vpHomogeneousMatrix &dcM,
+          std::vector<vpPolygonPoints> &polygons)
+{
+  polygons.clear();
+  for (size_t b = 0; b < boxes.size(); b++) {
+    boxFaces(boxes[b], dcM, polygons);
+  }
+  // A line lying on the first face
+  vpPolygonPoints line;
+  line.push_back(polygons[0][0]);
+  line.push_back(polygons[0][2]);
+  polygons.push_back(line);
+
+  std::vector<vpPolygonPoints *> list_polygons;
+  std::vector<int> list_ids;
+  for (size_t i = 0; i < polygons.size(); i++) {
+    list_polygons.push_back(&polygons[i]);
+    list_ids.push_back((int)i);
+  }
+  scanline.drawScene(list_polygons, list_ids, vpCameraParameters(600, 600, 320, 240), 640, 480);
+}
+
+// Visible parts of all the edges of the polygons
+void queryAll(vpMbScanLine &scanline, const std::vector<vpPolygonPoints> &polygons,
+              std::vector<std::vector<std::pair<vpPoint, vpPoint> > > &lines)
+{
+  lines.clear();
+  for (size_t i = 0; i < polygons.size(); i++) {
+    for (size_t k = 0; k < polygons[i].size(); k++) {
+      std::vector<std::pair<vpPoint, vpPoint> > l;
+      scanline.queryLineVisibility(polygons[i][k].first, polygons[i][(k + 1) % polygons[i].size()].first, l);
+      lines.push_back(l);
+    }
+  }
+}
+
+bool sameLines(const std::vector<std::vector<std::pair<vpPoint, vpPoint> > > &l1,
+               const std::vector<std::vector<std::pair<vpPoint, vpPoint> > > &l2)
+{
+  if (l1.size() != l2.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < l1.size(); i++) {
+    if (l1[i].size() != l2[i].size()) {
+      return false;
+    }
+    for (size_t j = 0; j < l1[i].size(); j++) {
+      const vpPoint *p1[2] = {&l1[i][j].first, &l1[i][j].second};
+      const vpPoint *p2[2] = {&l2[i][j].first, &l2[i][j].second};
+      for (int k = 0; k < 2; k++) {
+        if (p1[k]->get_X() != p2[k]->get_X() || p1[k]->get_Y() != p2[k]->get_Y() || p1[k]->get_Z() != p2[k]->get_Z()) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+template <class Type> bool sameImage(const vpImage<Type> &I1, const vpImage<Type> &I2)
+{
+  if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth()) {
+    return false;
+  }
+  for (unsigned int k = 0; k < I1.getSize(); k++) {
+    if (I1.bitmap[k] != I2.bitmap[k]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Closest polygon seen through the pixel (i, j), -1 if none
+int rayCast(const std::vector<vpPolygonPoints> &polygons, unsigned int i, unsigned int j)
+{
+  vpColVector d(3);
+  d[0] = (j - 320.0) / 600.0;
+  d[1] = (i - 240.0) / 600.0;
+  d[2] = 1;
+
+  int closest = -1;
+  double closest_t = 1e30;
+  for (size_t k = 0; k < polygons.size(); k++) {
+    if (polygons[k].size() != 4) {
+      continue;
+    }
+    vpColVector A(3), B(3), C(3);
+    A[0] = polygons[k][0].first.get_X();
+    A[1] = polygons[k][0].first.get_Y();
+    A[2] = polygons[k][0].first.get_Z();
+    B[0] = polygons[k][1].first.get_X() - A[0];
+    B[1] = polygons[k][1].first.get_Y() - A[1];
+    B[2] = polygons[k][1].first.get_Z() - A[2];
+    C[0] = polygons[k][3].first.get_X() - A[0];
+    C[1] = polygons[k][3].first.get_Y() - A[1];
+    C[2] = polygons[k][3].first.get_Z() - A[2];
+
+    vpColVector N = vpColVector::crossProd(B, C);
+    double den = N * d;
+    if (std::fabs(den) < 1e-12) {
+      continue;
+    }
+    double t = (N * A) / den;
+    vpColVector P = t * d - A;
+    double bb = B * B, bc = B * C, cc = C * C, pb = P * B, pc = P * C, det = bb * cc - bc * bc;
+    double u = (pb * cc - pc * bc) / det, v = (pc * bb - pb * bc) / det;
+    if (t > 0 && u >= 0 && u <= 1 && v >= 0 && v <= 1 && t < closest_t) {
+      closest_t = t;
+      // Keep away from the borders of the face where both renderings may disagree
+      closest = (u > 0.02 && u < 0.98 && v > 0.02 && v < 0.98) ? (int)k : -1;
+    }
+  }
+  return closest;
+}
+
+bool testParallel()
+{
+  srand(0);
+  for (unsigned int scene = 0; scene < 30; scene++) {
+    std::vector<vpBox> boxes;
+    randomScene(boxes);
+
+    for (unsigned int mask_border = 0; mask_border <= 5; mask_border += 5) {
+      vpMbScanLine reference, parallel, tiled;
+      reference.setMaskBorder(mask_border);
+      parallel.setMaskBorder(mask_border);
+      parallel.setUseParallel(true);
+      parallel.setNbParallelThreads(4);
+      tiled.setMaskBorder(mask_border);
+      tiled.setTileSize(7);
+
+      std::vector<vpPolygonPoints> polygons;
+      std::vector<std::vector<std::pair<vpPoint, vpPoint> > > lines_reference, lines;
+      draw(reference, boxes, vpHomogeneousMatrix(), polygons);
+      queryAll(reference, polygons, lines_reference);
+
+      vpMbScanLine *renderers[2] = {&parallel, &tiled};
+      for (int r = 0; r < 2; r++) {
+        draw(*renderers[r], boxes, vpHomogeneousMatrix(), polygons);
+        queryAll(*renderers[r], polygons, lines);
+        if (!sameImage(reference.getMask(), renderers[r]->getMask()) ||
+            !sameImage(reference.getPrimitiveIDs(), renderers[r]->getPrimitiveIDs()) ||
+            !sameLines(lines_reference, lines)) {
+          std::cerr << "Scene " << scene << ": the " << (r == 0 ? "parallel" : "tiled")
+                    << " rendering differs from the sequential one" << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool testRayCasting()
+{
+  srand(1);
+  unsigned int nb_pixels = 0, nb_correct = 0;
+  for (unsigned int scene = 0; scene < 20; scene++) {
+    // The depth order of intersecting faces is only evaluated at their edges
+    std::vector<vpBox> boxes;
+    randomScene(boxes, true);
+
+    vpMbScanLine scanline;
+    std::vector<vpPolygonPoints> polygons;
+    draw(scanline, boxes, vpHomogeneousMatrix(), polygons);
+
+    for (unsigned int i = 0; i < 480; i += 5) {
+      for (unsigned int j = 0; j < 640; j += 5) {
+        int id = rayCast(polygons, i, j);
+        if (id >= 0) {
+          nb_pixels++;
+          nb_correct += (scanline.getPrimitiveIDs()[i][j] == id) ? 1 : 0;
+        }
+      }
+    }
+  }
+
+  std::cout << "Primitive ids equal to the ray casting: " << nb_correct << " / " << nb_pixels << std::endl;
+  if (nb_correct < 0.99 * nb_pixels) {
+    std::cerr << "The primitive ids differ from the ray casting" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testSubSampling()
+{
+  srand(2);
+  unsigned int nb_pixels = 0, nb_equal = 0;
+  for (unsigned int scene = 0; scene < 20; scene++) {
+    std::vector<vpBox> boxes;
+    randomScene(boxes);
+
+    vpMbScanLine reference, sampled;
+    sampled.setScanLineStep(2);
+    std::vector<vpPolygonPoints> polygons;
+    std::vector<std::vector<std::pair<vpPoint, vpPoint> > > lines_reference, lines;
+    draw(reference, boxes, vpHomogeneousMatrix(), polygons);
+    queryAll(reference, polygons, lines_reference);
+    draw(sampled, boxes, vpHomogeneousMatrix(), polygons);
+    queryAll(sampled, polygons, lines);
+
+    for (unsigned int k = 0; k < reference.getPrimitiveIDs().getSize(); k++) {
+      if (reference.getPrimitiveIDs().bitmap[k] != -1) {
+        nb_pixels++;
+        nb_equal += (reference.getPrimitiveIDs().bitmap[k] == sampled.getPrimitiveIDs().bitmap[k]) ? 1 : 0;
+      }
+    }
+
+    // A visible edge stays visible
+    for (size_t e = 0; e < lines.size(); e++) {
+      double length = 0;
+      for (size_t k = 0; k < lines_reference[e].size(); k++) {
+        length += sqrt(vpMath::sqr(lines_reference[e][k].first.get_X() - lines_reference[e][k].second.get_X()) +
+                       vpMath::sqr(lines_reference[e][k].first.get_Y() - lines_reference[e][k].second.get_Y()));
+      }
+      if (length > 0.02 && lines[e].empty()) {
+        std::cerr << "Scene " << scene << ": a visible edge is hidden with the sub-sampled rendering" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  if (nb_equal < 0.98 * nb_pixels) {
+    std::cerr << "The sub-sampled primitive ids differ too much: " << nb_equal << " / " << nb_pixels << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testIncremental()
+{
+  srand(3);
+  for (unsigned int scene = 0; scene < 10; scene++) {
+    std::vector<vpBox> boxes;
+    randomScene(boxes);
+
+    vpMbScanLine incremental, reference;
+    incremental.setIncrementalThreshold(0.5);
+    std::vector<vpPolygonPoints> polygons;
+    std::vector<std::vector<std::pair<vpPoint, vpPoint> > > lines_reference, lines;
+
+    draw(incremental, boxes, vpHomogeneousMatrix(), polygons);
+    draw(reference, boxes, vpHomogeneousMatrix(), polygons);
+    queryAll(reference, polygons, lines_reference);
+    if (incremental.isSceneReused()) {
+      std::cerr << "Scene " << scene << ": the first rendering cannot be reused" << std::endl;
+      return false;
+    }
+
+    // A displacement of about 0.1 pixel reuses the previous rendering
+    draw(incremental, boxes, vpHomogeneousMatrix(1e-4, 0, 0, 0, 0, 0), polygons);
+    if (!incremental.isSceneReused() || !sameImage(incremental.getPrimitiveIDs(), reference.getPrimitiveIDs())) {
+      std::cerr << "Scene " << scene << ": the previous rendering should be reused" << std::endl;
+      return false;
+    }
+    queryAll(incremental, polygons, lines);
+    for (size_t e = 0; e < lines.size(); e++) {
+      if (lines[e].empty() != lines_reference[e].empty()) {
+        std::cerr << "Scene " << scene << ": the visibility of an edge changed with the reused rendering"
+                  << std::endl;
+        return false;
+      }
+    }
+
+    // A displacement of several pixels renders the scene
+    draw(incremental, boxes, vpHomogeneousMatrix(1e-2, 0, 0, 0, 0, 0), polygons);
+    draw(reference, boxes, vpHomogeneousMatrix(1e-2, 0, 0, 0, 0, 0), polygons);
+    if (incremental.isSceneReused() || !sameImage(incremental.getPrimitiveIDs(), reference.getPrimitiveIDs())) {
+      std::cerr << "Scene " << scene << ": the scene should be rendered again" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    if (!testParallel() || !testRayCasting() || !testSubSampling() || !testIncremental()) {
+      std::cerr << "testMbScanLine failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testMbScanLine is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Enable MBT module (VISP_HAVE_MODULE_MBT) to launch this test." << std::endl;
+  return 0;
+}
+#endif
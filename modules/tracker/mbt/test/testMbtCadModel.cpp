@@ -0,0 +1,316 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the cao and binary CAD model files.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbtCadModel.cpp
+
+  \brief Check the parsing of a cao model including another one, the binary
+  model round trip, and that a tracker creates the same faces from the cao
+  and from the binary files.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT)
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+#include <visp3/mbt/vpMbtCadModel.h>
+
+namespace
+{
+bool sameValue(double a, double b) { return std::fabs(a - b) <= std::numeric_limits<double>::epsilon(); }
+
+void writeModels(const std::string &dir)
+{
+  std::ofstream box((dir + "/box.cao").c_str());
+  box << "V1\n"
+         "# 3D Points\n"
+         "8\n"
+         "0 0 0\n"
+         "0.1 0 0\n"
+         "0.1 0.1 0\n"
+         "0 0.1 0\n"
+         "0 0 0.1\n"
+         "0.1 0 0.1\n"
+         "0.1 0.1 0.1\n"
+         "0 0.1 0.1\n"
+         "# 3D Lines\n"
+         "5\n"
+         "0 1\n"
+         "1 2\n"
+         "2 3\n"
+         "3 0\n"
+         "4 6 name=\"diagonal\" useLod=true minLineLengthThreshold=20\n"
+         "# Faces from 3D lines\n"
+         "1\n"
+         "4 0 1 2 3 name=\"bottom\" minPolygonAreaThreshold=100\n"
+         "# Faces from 3D points\n"
+         "5\n"
+         "4 4 5 6 7 name=\"top\" useLod=false\n"
+         "4 0 4 5 1\n"
+         "4 1 5 6 2\n"
+         "4 2 6 7 3\n"
+         "4 3 7 4 0\n"
+         "# 3D cylinders\n"
+         "1\n"
+         "0 4 0.02 name=\"cylinder\" minLineLengthThreshold=30\n"
+         "# 3D circles\n"
+         "1\n"
+         "0.03 6 5 7 name=\"circle\" useLod=true\n";
+
+  std::ofstream main((dir + "/main.cao").c_str());
+  main << "V1\n"
+          "load(\"box.cao\", t=[0.2; 0; 0], tu=[0; 0; 90deg])\n"
+          "# 3D Points\n"
+          "3\n"
+          "0 0 0\n"
+          "0.05 0 0\n"
+          "0 0.05 0\n"
+          "# 3D Lines\n"
+          "1\n"
+          "1 2 name=\"free\"\n"
+          "# Faces from 3D lines\n"
+          "0\n"
+          "# Faces from 3D points\n"
+          "1\n"
+          "3 0 1 2 name=\"triangle\"\n"
+          "# 3D cylinders\n"
+          "0\n"
+          "# 3D circles\n"
+          "0\n";
+}
+
+bool samePrimitive(const vpMbtCadModel::vpPrimitive &p1, const vpMbtCadModel::vpPrimitive &p2)
+{
+  return p1.type == p2.type && p1.first == p2.first && p1.nbPoints == p2.nbPoints &&
+         sameValue(p1.radius, p2.radius) && p1.hasLod == p2.hasLod && p1.useLod == p2.useLod &&
+         p1.hasThreshold == p2.hasThreshold && sameValue(p1.threshold, p2.threshold) &&
+         p1.name == p2.name;
+}
+
+bool sameModel(const vpMbtCadModel &m1, const vpMbtCadModel &m2)
+{
+  if (m1.getPoints() != m2.getPoints() || m1.getPointIndexes() != m2.getPointIndexes() ||
+      m1.getNbPrimitives() != m2.getNbPrimitives() || m1.getNbLines() != m2.getNbLines() ||
+      m1.getNbPolygonLines() != m2.getNbPolygonLines() || m1.getNbPolygonPoints() != m2.getNbPolygonPoints() ||
+      m1.getNbCylinders() != m2.getNbCylinders() || m1.getNbCircles() != m2.getNbCircles()) {
+    return false;
+  }
+  for (unsigned int i = 0; i < m1.getNbPrimitives(); i++) {
+    if (!samePrimitive(m1.getPrimitive(i), m2.getPrimitive(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool sameFaces(vpMbHiddenFaces<vpMbtPolygon> &faces1, vpMbHiddenFaces<vpMbtPolygon> &faces2)
+{
+  if (faces1.size() != faces2.size()) {
+    std::cerr << "Different number of faces: " << faces1.size() << " vs " << faces2.size() << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < faces1.size(); i++) {
+    vpMbtPolygon &f1 = *faces1[i];
+    vpMbtPolygon &f2 = *faces2[i];
+    if (f1.getIndex() != f2.getIndex() || f1.getName() != f2.getName() || f1.useLod != f2.useLod ||
+        !sameValue(f1.minLineLengthThresh, f2.minLineLengthThresh) ||
+        !sameValue(f1.minPolygonAreaThresh, f2.minPolygonAreaThresh) ||
+        f1.getNbPoint() != f2.getNbPoint()) {
+      std::cerr << "Face " << i << " is different" << std::endl;
+      return false;
+    }
+    for (unsigned int j = 0; j < f1.getNbPoint(); j++) {
+      const vpPoint &p1 = f1.getPoint(j), &p2 = f2.getPoint(j);
+      if (!sameValue(p1.get_oX(), p2.get_oX()) || !sameValue(p1.get_oY(), p2.get_oY()) ||
+          !sameValue(p1.get_oZ(), p2.get_oZ())) {
+        std::cerr << "Point " << j << " of face " << i << " is different" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+#if defined(_WIN32)
+    std::string tmp_dir = "C:/temp/";
+#else
+    std::string tmp_dir = "/tmp/";
+#endif
+    std::string username;
+    vpIoTools::getUserName(username);
+    tmp_dir += username + "/test_mbt_cad_model";
+    vpIoTools::remove(tmp_dir);
+    vpIoTools::makeDirectory(tmp_dir);
+    writeModels(tmp_dir);
+
+    const std::string caoFile = tmp_dir + "/main.cao";
+    const std::string binaryFile = tmp_dir + "/main.bcao";
+
+    // Content of the flattened model
+    vpMbtCadModel model;
+    model.loadCAO(caoFile);
+    if (model.getNbPoints() != 11 || model.getNbPrimitives() != 11 || model.getNbLines() != 6 ||
+        model.getNbPolygonLines() != 1 || model.getNbPolygonPoints() != 6 || model.getNbCylinders() != 1 ||
+        model.getNbCircles() != 1) {
+      std::cerr << "Wrong number of points or primitives" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    const vpMbtCadModel::vpPrimitiveType types[11] = {
+        vpMbtCadModel::POLYGON_FROM_LINES,  vpMbtCadModel::LINE,
+        vpMbtCadModel::POLYGON_FROM_POINTS, vpMbtCadModel::POLYGON_FROM_POINTS,
+        vpMbtCadModel::POLYGON_FROM_POINTS, vpMbtCadModel::POLYGON_FROM_POINTS,
+        vpMbtCadModel::POLYGON_FROM_POINTS, vpMbtCadModel::CYLINDER,
+        vpMbtCadModel::CIRCLE,              vpMbtCadModel::LINE,
+        vpMbtCadModel::POLYGON_FROM_POINTS};
+    for (unsigned int i = 0; i < model.getNbPrimitives(); i++) {
+      if (model.getPrimitive(i).type != types[i]) {
+        std::cerr << "Wrong type for primitive " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    const vpMbtCadModel::vpPrimitive &diagonal = model.getPrimitive(1);
+    if (diagonal.name != "diagonal" || !diagonal.hasLod || !diagonal.useLod || !diagonal.hasThreshold ||
+        !sameValue(diagonal.threshold, 20.0) || model.getPointIndexes()[diagonal.first] != 4 ||
+        model.getPointIndexes()[diagonal.first + 1] != 6) {
+      std::cerr << "Wrong line parameters" << std::endl;
+      return EXIT_FAILURE;
+    }
+    const vpMbtCadModel::vpPrimitive &cylinder = model.getPrimitive(7);
+    if (cylinder.name != "cylinder" || cylinder.hasLod || !sameValue(cylinder.radius, 0.02) ||
+        !sameValue(cylinder.threshold, 30.0)) {
+      std::cerr << "Wrong cylinder parameters" << std::endl;
+      return EXIT_FAILURE;
+    }
+    const vpMbtCadModel::vpPrimitive &triangle = model.getPrimitive(10);
+    if (triangle.name != "triangle" || model.getPointIndexes()[triangle.first] != 8) {
+      std::cerr << "Wrong indexes of the main file" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The included file is rotated of 90 degrees around z and translated
+    const std::vector<double> &points = model.getPoints();
+    if (!vpMath::equal(points[3], 0.2, 1e-12) || !vpMath::equal(points[4], 0.1, 1e-12) ||
+        !vpMath::equal(points[5], 0.0, 1e-12) || !sameValue(points[27], 0.05)) {
+      std::cerr << "Wrong points coordinates" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Binary round trip
+    model.saveBinary(binaryFile);
+    if (!vpMbtCadModel::isBinary(binaryFile) || vpMbtCadModel::isBinary(caoFile)) {
+      std::cerr << "Wrong binary file detection" << std::endl;
+      return EXIT_FAILURE;
+    }
+    vpMbtCadModel binary;
+    binary.loadBinary(binaryFile);
+    if (!sameModel(model, binary)) {
+      std::cerr << "The binary model differs from the cao model" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // A truncated binary file is rejected
+    {
+      std::ifstream in(binaryFile.c_str(), std::ios::binary);
+      std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      std::ofstream out((tmp_dir + "/truncated.bcao").c_str(), std::ios::binary);
+      out.write(content.data(), static_cast<std::streamsize>(content.size() - 4));
+    }
+    bool rejected = false;
+    try {
+      vpMbtCadModel truncated;
+      truncated.loadBinary(tmp_dir + "/truncated.bcao");
+    } catch (const vpException &) {
+      rejected = true;
+    }
+    if (!rejected) {
+      std::cerr << "A truncated binary model is accepted" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The tracker creates the same faces from both files
+    vpHomogeneousMatrix odTo(0.01, -0.02, 0.03, 0.1, 0.2, -0.3);
+    vpMbGenericTracker trackerCao, trackerBinary;
+    trackerCao.loadModel(caoFile, false, odTo);
+    trackerBinary.loadModel(binaryFile, false, odTo);
+    if (trackerCao.getFaces().size() != 15 || !sameFaces(trackerCao.getFaces(), trackerBinary.getFaces())) {
+      std::cerr << "The tracker faces differ between the cao and the binary models" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::list<vpMbtDistanceLine *> linesCao, linesBinary;
+    std::list<vpMbtDistanceCylinder *> cylindersCao, cylindersBinary;
+    std::list<vpMbtDistanceCircle *> circlesCao, circlesBinary;
+    trackerCao.getLline(linesCao);
+    trackerBinary.getLline(linesBinary);
+    trackerCao.getLcylinder(cylindersCao);
+    trackerBinary.getLcylinder(cylindersBinary);
+    trackerCao.getLcircle(circlesCao);
+    trackerBinary.getLcircle(circlesBinary);
+    if (linesCao.size() != linesBinary.size() || cylindersCao.size() != 1 || cylindersBinary.size() != 1 ||
+        circlesCao.size() != 1 || circlesBinary.size() != 1) {
+      std::cerr << "The tracker features differ between the cao and the binary models" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpIoTools::remove(tmp_dir);
+    std::cout << "testMbtCadModel is ok!" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+int main()
+{
+  std::cout << "Nothing to run, visp_mbt module is required." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
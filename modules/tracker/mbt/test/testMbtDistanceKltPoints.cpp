@@ -0,0 +1,217 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the interaction matrix and the residual of the KLT points of a face.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbtDistanceKltPoints.cpp
+
+  \brief Compute the interaction matrix and the residual of a face with an
+  odd number of KLT points, where the points are processed by pairs with
+  SSE2 and the last one alone. Each pair of rows must be the one of a face
+  with only the corresponding point, that goes through the scalar path. The
+  coordinates of the current points read in the interaction matrix must be
+  the ones of getCurrentPoints(). This is checked after init(),
+  computeNbDetectedCurrent(), removeOutliers() and setCameraParameters().
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_MBT) && defined(VISP_HAVE_MODULE_KLT) &&                                                  \
+    (!defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/mbt/vpMbtDistanceKltPoints.h>
+
+namespace
+{
+#if defined(VISP_HAVE_OPENCV)
+typedef vpKltOpencv vpKltTracker;
+#else
+typedef vpKlt vpKltTracker;
+#endif
+
+const unsigned int nbPoints = 10;
+
+// Square face of the plane Z = 1, seen with the identity pose
+void createPolygon(const vpCameraParameters &cam, vpMbtPolygon &polygon)
+{
+  const double corners[4][2] = {{-0.2, -0.15}, {0.2, -0.15}, {0.2, 0.15}, {-0.2, 0.15}};
+  polygon.setNbPoint(4);
+  for (unsigned int i = 0; i < 4; i++) {
+    vpPoint P;
+    P.setWorldCoordinates(corners[i][0], corners[i][1], 1.);
+    polygon.addPoint(i, P);
+  }
+  polygon.changeFrame(vpHomogeneousMatrix());
+  polygon.computePolygonClipped(cam);
+}
+
+void setupFace(const vpCameraParameters &cam, vpMbtPolygon &polygon, vpMbtDistanceKltPoints &face)
+{
+  face.setCameraParameters(cam);
+  face.polygon = &polygon;
+  face.hiddenface = NULL;
+  face.useScanLine = false;
+}
+
+void computeInteractionMatrixAndResidu(vpMbtDistanceKltPoints &face, const vpHomogeneousMatrix &cTc0, vpMatrix &J,
+                                       vpColVector &R)
+{
+  vpHomography H;
+  face.computeHomography(cTc0, H);
+  J.resize(2 * face.getCurrentNumberPoints(), 6);
+  R.resize(2 * face.getCurrentNumberPoints());
+  face.computeInteractionMatrixAndResidu(R, J);
+}
+
+// Compare the rows of each point of the face to the ones of a face with only
+// that point
+bool check(const std::string &stage, vpMbtDistanceKltPoints &face, const vpCameraParameters &cam,
+           vpMbtPolygon &polygon, const std::map<long, vpImagePoint> &initPoints, const vpKltTracker &klt,
+           const vpHomogeneousMatrix &cTc0, unsigned int expectedNbPoints)
+{
+  vpMatrix J;
+  vpColVector R;
+  computeInteractionMatrixAndResidu(face, cTc0, J, R);
+  if (face.getCurrentNumberPoints() != expectedNbPoints) {
+    std::cerr << stage << ": " << face.getCurrentNumberPoints() << " points instead of " << expectedNbPoints
+              << std::endl;
+    return false;
+  }
+
+  const std::map<int, vpImagePoint> &curPoints = face.getCurrentPoints();
+  unsigned int k = 0;
+  for (std::map<int, vpImagePoint>::const_iterator it = curPoints.begin(); it != curPoints.end(); ++it, k++) {
+    double x, y;
+    vpPixelMeterConversion::convertPoint(cam, it->second, x, y);
+    if (J[2 * k][5] != y || J[2 * k + 1][5] != -x) {
+      std::cerr << stage << ": the coordinates of point " << it->first << " are not the current ones" << std::endl;
+      return false;
+    }
+
+    vpKltTracker kltInit;
+    const vpImagePoint &ip = initPoints.find(it->first)->second;
+    kltInit.addFeature(it->first, static_cast<float>(ip.get_u()), static_cast<float>(ip.get_v()));
+    vpMbtDistanceKltPoints single;
+    setupFace(cam, polygon, single);
+    single.init(kltInit);
+    single.computeNbDetectedCurrent(klt);
+
+    vpMatrix J_single;
+    vpColVector R_single;
+    computeInteractionMatrixAndResidu(single, cTc0, J_single, R_single);
+    for (unsigned int i = 0; i < 2; i++) {
+      if (R[2 * k + i] != R_single[i]) {
+        std::cerr << stage << ": the residual of point " << it->first << " differs from the scalar one" << std::endl;
+        return false;
+      }
+      for (unsigned int j = 0; j < 6; j++) {
+        if (J[2 * k + i][j] != J_single[i][j]) {
+          std::cerr << stage << ": the interaction matrix of point " << it->first << " differs from the scalar one"
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpCameraParameters cam(600, 600, 160, 120);
+    vpMbtPolygon polygon;
+    createPolygon(cam, polygon);
+
+    // Initial points, the point of id 3 is lost in the next image
+    vpKltTracker klt0, klt1;
+    std::map<long, vpImagePoint> initPoints;
+    for (long id = 0; id < static_cast<long>(nbPoints); id++) {
+      const float u = 60.f + 19.f * id, v = 50.f + 13.f * ((id * 7) % 10);
+      klt0.addFeature(id, u, v);
+      initPoints[id] = vpImagePoint(v, u);
+    }
+    // Current points, given in reverse order
+    for (long id = static_cast<long>(nbPoints) - 1; id >= 0; id--) {
+      if (id != 3) {
+        klt1.addFeature(id, 60.f + 19.f * id + 2.5f - 0.3f * id, 50.f + 13.f * ((id * 7) % 10) - 1.25f + 0.2f * id);
+      }
+    }
+    const vpHomogeneousMatrix cTc0(0.01, -0.02, 0.03, vpMath::rad(2), vpMath::rad(-1), vpMath::rad(3));
+
+    vpMbtDistanceKltPoints face;
+    setupFace(cam, polygon, face);
+    face.init(klt0);
+
+    bool success = check("init()", face, cam, polygon, initPoints, klt0, vpHomogeneousMatrix(), nbPoints);
+
+    face.computeNbDetectedCurrent(klt1);
+    success = success && check("computeNbDetectedCurrent()", face, cam, polygon, initPoints, klt1, cTc0, nbPoints - 1);
+
+    // Remove the 3rd and the 6th points
+    vpColVector w(2 * (nbPoints - 1), 1.);
+    w[2 * 2] = 0.;
+    w[2 * 5 + 1] = 0.;
+    face.removeOutliers(w, 0.5);
+    success = success && check("removeOutliers()", face, cam, polygon, initPoints, klt1, cTc0, nbPoints - 3);
+
+    vpCameraParameters cam2(580, 620, 158, 123);
+    face.setCameraParameters(cam2);
+    success = success && check("setCameraParameters()", face, cam2, polygon, initPoints, klt1, cTc0, nbPoints - 3);
+
+    if (!success) {
+      std::cerr << "testMbtDistanceKltPoints failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testMbtDistanceKltPoints is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+#else
+int main()
+{
+  std::cout << "Enable MBT and KLT modules to launch this test." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
@@ -50,6 +50,8 @@
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpMatrix.h>
 
+class vpMeGradientLookup;
+
 /*!
   \class vpMe
   \ingroup module_me
@@ -90,6 +92,8 @@ private:
   // int graph ;
   vpMatrix *mask; //! Array of matrices defining the different masks (one for
                   //! every angle step).
+  //! Optional per-frame lookup of the mask responses, not owned
+  const vpMeGradientLookup *m_gradientLookup;
 
 public:
   vpMe();
@@ -112,6 +116,14 @@ public:
     \return Value of anglestep.
   */
   inline unsigned int getAngleStep() const { return anglestep; }
+  /*!
+    Return the per-frame lookup of the mask responses used by the sites.
+
+    \return The lookup, NULL if the responses are computed at every candidate.
+
+    \sa setGradientLookup()
+  */
+  inline const vpMeGradientLookup *getGradientLookup() const { return m_gradientLookup; }
   /*!
     Get the matrix of the mask.
 
@@ -201,6 +213,16 @@ public:
     \param a : new angle step.
   */
   void setAngleStep(const unsigned int &a) { anglestep = a; }
+  /*!
+    Set the per-frame lookup of the mask responses used by the sites. The
+    lookup is not owned and must outlive the moving edges using these
+    parameters. It is only read for the image given to its last
+    vpMeGradientLookup::update(), the responses are computed at every
+    candidate otherwise.
+
+    \param lookup : Lookup to use, NULL to disable it.
+  */
+  void setGradientLookup(const vpMeGradientLookup *lookup) { m_gradientLookup = lookup; }
   /*!
     Set the number of mask applied to determine the object contour. The number
     of mask determines the precision of the normal of the edge for every
@@ -0,0 +1,163 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Per-frame lookup of the oriented moving-edge mask responses.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMeGradientLookup.h
+  \brief Per-frame lookup of the oriented moving-edge mask responses.
+*/
+
+#ifndef vpMeGradientLookup_H
+#define vpMeGradientLookup_H
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+#include <atomic>
+#include <cstdint>
+#endif
+
+class vpMe;
+
+/*!
+  \class vpMeGradientLookup
+  \ingroup module_me
+
+  \brief Per-frame lookup of the responses of the oriented moving-edge masks.
+
+  vpMeSite::convolution() applies a \f$ n \times n \f$ mask, selected by
+  the quantised normal angle, at every candidate pixel along the search
+  line. The sites of a contour share the same mask, and the search lines of
+  the initialisation, tracking and reinitialisation stages cover the same
+  pixels of a frame. This class keeps, for every pixel of the current frame,
+  the last mask response computed there: a candidate that was already
+  evaluated with the same mask costs a table read instead of a convolution.
+
+  The table is filled lazily, only the pixels that are actually searched are
+  convolved. The masks of vpMe have integer coefficients, so the stored
+  responses are exact and the tracking results are identical with or without
+  the lookup. Entries are updated atomically, the lookup can be shared by
+  moving edges tracked concurrently on the same frame.
+
+  The lookup is attached to the moving-edge parameters with
+  vpMe::setGradientLookup() and must be refreshed with update() every time
+  a new image is tracked:
+  \code
+#include <visp3/me/vpMeGradientLookup.h>
+#include <visp3/me/vpMeLine.h>
+
+int main()
+{
+  vpImage<unsigned char> I;
+  vpMe me;
+  vpMeGradientLookup lookup;
+  me.setGradientLookup(&lookup);
+
+  vpMeLine line;
+  line.setMe(&me);
+  // ... acquire I and call line.initTracking(I, ip1, ip2)
+
+  while (true) {
+    // ... acquire I
+    lookup.update(I, me); // invalidates the responses of the previous frame
+    line.track(I);
+  }
+}
+  \endcode
+
+  \sa vpMe::setGradientLookup()
+*/
+class VISP_EXPORT vpMeGradientLookup
+{
+public:
+  vpMeGradientLookup();
+  virtual ~vpMeGradientLookup();
+
+  void clear();
+
+  /*!
+    \return The number of calls to update() since the construction. It
+    identifies the frame the responses were computed on: a tracker sharing a
+    lookup owned by another object can check that the lookup was updated for
+    the current frame, even when the frames are stored in the same image.
+  */
+  inline unsigned int getGeneration() const { return m_generation; }
+
+  /*!
+    \return The image the lookup was last updated with, NULL if update() was
+    not called yet.
+  */
+  inline const vpImage<unsigned char> *getImage() const { return m_image; }
+
+  bool isValidFor(const vpImage<unsigned char> &I, const vpMe &me) const;
+
+  int response(const vpImage<unsigned char> &I, const vpMe &me, unsigned int i, unsigned int j,
+               unsigned int index_mask) const;
+
+  void update(const vpImage<unsigned char> &I, const vpMe &me);
+
+private:
+  vpMeGradientLookup(const vpMeGradientLookup &);            // noncopyable
+  vpMeGradientLookup &operator=(const vpMeGradientLookup &); //
+
+  void resize(unsigned int height, unsigned int width);
+
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+  typedef std::atomic<uint64_t> vpSlot;
+#else
+  typedef unsigned long long vpSlot;
+#endif
+
+  //! Image the responses were computed on
+  const vpImage<unsigned char> *m_image;
+  //! Number of rows of the table
+  unsigned int m_height;
+  //! Number of columns of the table
+  unsigned int m_width;
+  //! Mask size of the vpMe the responses were computed with
+  unsigned int m_maskSize;
+  //! Number of masks of the vpMe the responses were computed with
+  unsigned int m_maskNumber;
+  //! Frame counter, tags the valid entries of the table
+  unsigned int m_stamp;
+  //! Number of calls to update(), never recycled
+  unsigned int m_generation;
+  //! Number of allocated entries
+  unsigned int m_capacity;
+  //! One entry per pixel packing the response, the mask index and the frame counter
+  vpSlot *m_slots;
+};
+
+#endif
@@ -121,6 +121,7 @@ public:
   vpMeSite *getQueryList(const vpImage<unsigned char> &I, const int range);
 
   void track(const vpImage<unsigned char> &im, const vpMe *me, bool test_contraste = true);
+  void track(const vpImage<unsigned char> &im, const vpMe *me, bool test_contraste, unsigned int range);
 
   /*!
     Set the angle of tangent at site
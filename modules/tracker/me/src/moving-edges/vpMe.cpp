@@ -375,7 +375,8 @@ void vpMe::print()
 
 vpMe::vpMe()
   : threshold(1500), mu1(0.5), mu2(0.5), min_samplestep(4), anglestep(1), mask_sign(0), range(4), sample_step(10),
-    ntotal_sample(0), points_to_track(500), mask_size(5), n_mask(180), strip(2), mask(NULL)
+    ntotal_sample(0), points_to_track(500), mask_size(5), n_mask(180), strip(2), mask(NULL),
+    m_gradientLookup(NULL)
 {
   // ntotal_sample = 0; // not sure that it is used
   // points_to_track = 500; // not sure that it is used
@@ -386,7 +387,8 @@ vpMe::vpMe()
 
 vpMe::vpMe(const vpMe &me)
   : threshold(1500), mu1(0.5), mu2(0.5), min_samplestep(4), anglestep(1), mask_sign(0), range(4), sample_step(10),
-    ntotal_sample(0), points_to_track(500), mask_size(5), n_mask(180), strip(2), mask(NULL)
+    ntotal_sample(0), points_to_track(500), mask_size(5), n_mask(180), strip(2), mask(NULL),
+    m_gradientLookup(NULL)
 {
   *this = me;
 }
@@ -411,6 +413,7 @@ vpMe &vpMe::operator=(const vpMe &me)
   ntotal_sample = me.ntotal_sample;
   points_to_track = me.points_to_track;
   strip = me.strip;
+  m_gradientLookup = me.m_gradientLookup;
 
   initMask();
   return *this;
@@ -437,6 +440,7 @@ vpMe &vpMe::operator=(const vpMe &&me)
   ntotal_sample = std::move(me.ntotal_sample);
   points_to_track = std::move(me.points_to_track);
   strip = std::move(me.strip);
+  m_gradientLookup = std::move(me.m_gradientLookup);
 
   initMask();
   return *this;
@@ -0,0 +1,210 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Per-frame lookup of the oriented moving-edge mask responses.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMeGradientLookup.cpp
+  \brief Per-frame lookup of the oriented moving-edge mask responses.
+*/
+
+#include <visp3/me/vpMe.h>
+#include <visp3/me/vpMeGradientLookup.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// An entry packs the response in the 32 low bits, the mask index in the next 16 bits and the frame counter in the
+// 16 high bits. A null frame counter marks an empty entry.
+const unsigned int stamp_max = 0xFFFF;
+
+#if (VISP_CXX_STANDARD >= VISP_CXX_STANDARD_11)
+typedef uint64_t vpEntry;
+
+inline vpEntry loadEntry(const std::atomic<uint64_t> &slot) { return slot.load(std::memory_order_relaxed); }
+inline void storeEntry(std::atomic<uint64_t> &slot, vpEntry entry) { slot.store(entry, std::memory_order_relaxed); }
+#else
+typedef unsigned long long vpEntry;
+
+inline vpEntry loadEntry(const unsigned long long &slot) { return slot; }
+inline void storeEntry(unsigned long long &slot, vpEntry entry) { slot = entry; }
+#endif
+
+inline vpEntry makeTag(unsigned int stamp, unsigned int index_mask)
+{
+  return (static_cast<vpEntry>(stamp) << 48) | (static_cast<vpEntry>(index_mask & 0xFFFF) << 32);
+}
+
+const vpEntry tag_bits = ~static_cast<vpEntry>(0xFFFFFFFFu);
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The lookup is empty until update() is called.
+*/
+vpMeGradientLookup::vpMeGradientLookup()
+  : m_image(NULL), m_height(0), m_width(0), m_maskSize(0), m_maskNumber(0), m_stamp(0), m_generation(0),
+    m_capacity(0), m_slots(NULL)
+{
+}
+
+/*!
+  Destructor.
+*/
+vpMeGradientLookup::~vpMeGradientLookup() { clear(); }
+
+/*!
+  Release the table. The lookup is no more valid until the next call to
+  update().
+*/
+void vpMeGradientLookup::clear()
+{
+  if (m_slots != NULL) {
+    delete[] m_slots;
+    m_slots = NULL;
+  }
+  m_image = NULL;
+  m_height = 0;
+  m_width = 0;
+  m_stamp = 0;
+  m_capacity = 0;
+}
+
+/*!
+  Check that the lookup can be used to compute the mask responses on an
+  image.
+
+  \param I : Image on which the responses are requested.
+  \param me : Moving-edge parameters defining the masks.
+
+  \return True if update() was called with the same image and masks of the
+  same size and number. The content of the image is not checked: the caller
+  has to call update() when a new frame is stored in the same image, see
+  getGeneration().
+*/
+bool vpMeGradientLookup::isValidFor(const vpImage<unsigned char> &I, const vpMe &me) const
+{
+  return m_slots != NULL && m_image == &I && I.getHeight() == m_height && I.getWidth() == m_width &&
+         me.getMaskSize() == m_maskSize && me.getMaskNumber() == m_maskNumber;
+}
+
+void vpMeGradientLookup::resize(unsigned int height, unsigned int width)
+{
+  m_height = height;
+  m_width = width;
+
+  // The entries of the previous frames have an older frame counter, the table only needs to be emptied when it is
+  // reallocated or when the frame counter is recycled
+  if (m_height * m_width > m_capacity) {
+    if (m_slots != NULL) {
+      delete[] m_slots;
+    }
+    m_capacity = m_height * m_width;
+    m_slots = new vpSlot[m_capacity];
+    m_stamp = 0;
+  }
+
+  if (m_stamp == 0) {
+    for (unsigned int k = 0; k < m_capacity; k++) {
+      storeEntry(m_slots[k], 0);
+    }
+  }
+}
+
+/*!
+  Return the response of a moving-edge mask at a pixel, computing it only if
+  it was not already computed on the current frame with the same mask.
+
+  The caller must check with isValidFor() that the lookup corresponds to the
+  image and that the mask fully lies inside the image.
+
+  \param I : Image given to the last call to update().
+  \param me : Moving-edge parameters defining the masks.
+  \param i, j : Pixel at the center of the mask.
+  \param index_mask : Index of the mask in vpMe::getMask().
+
+  \return The response of the mask, without the mask sign of the site. It
+  is an integer since the coefficients of the masks are integers.
+*/
+int vpMeGradientLookup::response(const vpImage<unsigned char> &I, const vpMe &me, unsigned int i, unsigned int j,
+                                 unsigned int index_mask) const
+{
+  vpSlot &slot = m_slots[i * m_width + j];
+  const vpEntry tag = makeTag(m_stamp, index_mask);
+
+  vpEntry entry = loadEntry(slot);
+  if ((entry & tag_bits) == tag) {
+    return static_cast<int>(static_cast<unsigned int>(entry & 0xFFFFFFFFu));
+  }
+
+  // The coefficients of the masks are integers, the response is exact
+  const unsigned int msize = me.getMaskSize();
+  const unsigned int half = (msize - 1) >> 1;
+  const vpMatrix &mask = me.getMask()[index_mask];
+
+  int conv = 0;
+  for (unsigned int a = 0; a < msize; a++) {
+    const unsigned char *row = I[i - half + a] + j - half;
+    const double *mask_row = mask[a];
+    for (unsigned int b = 0; b < msize; b++) {
+      conv += static_cast<int>(mask_row[b]) * row[b];
+    }
+  }
+
+  storeEntry(slot, tag | static_cast<vpEntry>(static_cast<unsigned int>(conv)));
+  return conv;
+}
+
+/*!
+  Invalidate the responses of the previous frame and bind the lookup to a
+  new image. This is a constant time operation, except when the image is
+  larger than the previous ones since the table is then reallocated.
+
+  \param I : Image that will be tracked. It must stay unchanged until the
+  next call to update().
+  \param me : Moving-edge parameters defining the masks.
+*/
+void vpMeGradientLookup::update(const vpImage<unsigned char> &I, const vpMe &me)
+{
+  m_maskSize = me.getMaskSize();
+  m_maskNumber = me.getMaskNumber();
+
+  if (m_stamp == stamp_max) {
+    // Recycle the frame counter, the table has to be emptied
+    m_stamp = 0;
+  }
+  resize(I.getHeight(), I.getWidth());
+  m_stamp++;
+  m_generation++;
+  m_image = &I;
+}
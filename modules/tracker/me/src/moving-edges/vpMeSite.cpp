@@ -48,6 +48,7 @@
 #include <stdlib.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/me/vpMe.h>
+#include <visp3/me/vpMeGradientLookup.h>
 #include <visp3/me/vpMeSite.h>
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -326,6 +327,13 @@ double vpMeSite::convolution(const vpImage<unsigned char> &I, const vpMe *me)
 
     unsigned int i_ = static_cast<unsigned int>(i);
     unsigned int j_ = static_cast<unsigned int>(j);
+
+    const vpMeGradientLookup *lookup = me->getGradientLookup();
+    if (lookup != NULL && lookup->isValidFor(I, *me)) {
+      // The masks have integer coefficients, the result is the same as the convolution below
+      return static_cast<double>(mask_sign * lookup->response(I, *me, i_, j_, index_mask));
+    }
+
     unsigned int half_ = static_cast<unsigned int>(half);
 
     unsigned int ihalf = i_ - half_;
@@ -353,6 +361,26 @@ double vpMeSite::convolution(const vpImage<unsigned char> &I, const vpMe *me)
 
 */
 void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, bool test_contraste)
+{
+  track(I, me, test_contraste, me->getRange());
+}
+
+/*!
+
+  Track the site with a search range that may differ from the one of the
+  moving-edge parameters, without modifying \e me. This allows moving edges
+  that share the same vpMe to be tracked concurrently.
+
+  \param I : Image.
+  \param me : Moving-edge parameters.
+  \param test_contraste : If true, test the contrast with the previous site.
+  \param range : +/- range of pixels within which the correspondent of the
+  site is sought.
+
+  \warning To display the moving edges graphics a call to vpDisplay::flush()
+  is needed.
+*/
+void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, bool test_contraste, unsigned int range)
 {
   //   vpMeSite  *list_query_pixels ;
   //   int  max_rank =0 ;
@@ -488,10 +516,6 @@ void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, bool test_
   //  vpERROR_TRACE("getclcik %d",me->range) ;
   //  vpDisplay::getClick(I) ;
 
-  // range = +/- range of pixels within which the correspondent
-  // of the current pixel will be sought
-  unsigned int range = me->getRange();
-
   //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  <<
   //  std::endl ;
   vpMeSite *list_query_pixels = getQueryList(I, (int)range);
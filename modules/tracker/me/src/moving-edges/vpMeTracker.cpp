@@ -173,10 +173,6 @@ void vpMeTracker::initTracking(const vpImage<unsigned char> &I)
     throw(vpTrackingException(vpTrackingException::initializationError, "Moving edges not initialized"));
   }
 
-  // Must set range to 0
-  unsigned int range_tmp = me->getRange();
-  me->setRange(init_range);
-
   nGoodElement = 0;
 
   int d = 0;
@@ -189,7 +185,9 @@ void vpMeTracker::initTracking(const vpImage<unsigned char> &I)
     // If element hasn't been suppressed
     if (refp.getState() == vpMeSite::NO_SUPPRESSION) {
       try {
-        refp.track(I, me, false);
+        // The initial range is given to the site rather than set on the
+        // shared vpMe, that may be used concurrently by other trackers
+        refp.track(I, me, false, init_range);
       } catch (...) {
         // EM verifier quel signal est de sortie !!!
         vpERROR_TRACE("Error caught");
@@ -234,8 +232,6 @@ void vpMeTracker::initTracking(const vpImage<unsigned char> &I)
   return res ;
   }
   */
-
-  me->setRange(range_tmp);
 }
 
 /*!
@@ -0,0 +1,236 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the per-frame lookup of the moving-edge mask responses.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMeGradientLookup.cpp
+
+  \brief Check that the moving edges give the same results with and without
+  the per-frame lookup of the mask responses, on a synthetic sequence with a
+  straight edge and an ellipse.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/me/vpMeEllipse.h>
+#include <visp3/me/vpMeGradientLookup.h>
+#include <visp3/me/vpMeLine.h>
+
+namespace
+{
+// A bright half plane on the left of a tilted line and a bright ellipse, both translated with the frame index
+void render(unsigned int frame, vpImage<unsigned char> &I)
+{
+  const double du = 1.0 * frame, dv = 0.5 * frame;
+  const double ct = cos(vpMath::rad(20)), st = sin(vpMath::rad(20));
+
+  I.resize(240, 320);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double u = j - du, v = i - dv;
+      unsigned char value = 60;
+      if (u < 100 + 0.3 * v) {
+        value = 170;
+      }
+      double x = (u - 220) * ct + (v - 120) * st;
+      double y = -(u - 220) * st + (v - 120) * ct;
+      if ((x * x) / (50 * 50) + (y * y) / (30 * 30) < 1) {
+        value = 220;
+      }
+      I[i][j] = value;
+    }
+  }
+}
+
+bool sameSites(const std::list<vpMeSite> &l1, const std::list<vpMeSite> &l2)
+{
+  if (l1.size() != l2.size()) {
+    return false;
+  }
+  std::list<vpMeSite>::const_iterator it1 = l1.begin(), it2 = l2.begin();
+  for (; it1 != l1.end(); ++it1, ++it2) {
+    if (it1->i != it2->i || it1->j != it2->j || it1->convlt != it2->convlt ||
+        it1->getState() != it2->getState()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool testConvolution()
+{
+  vpImage<unsigned char> I(120, 160);
+  srand(0);
+  for (unsigned int k = 0; k < I.getSize(); k++) {
+    I.bitmap[k] = static_cast<unsigned char>(rand() % 256);
+  }
+
+  vpMe me;
+  me.setMaskSize(7);
+  vpMeGradientLookup lookup;
+  lookup.update(I, me);
+
+  vpMe me_lookup(me);
+  me_lookup.setGradientLookup(&lookup);
+
+  // Each site is convolved twice with the lookup to read back the stored response
+  for (unsigned int n = 0; n < 2000; n++) {
+    double ip = rand() % I.getHeight(), jp = rand() % I.getWidth();
+    double alpha = vpMath::rad(rand() % 360 - 180.0);
+    vpMeSite s1, s2;
+    s1.init(ip, jp, alpha, 0, (n % 2) ? 1 : -1);
+    s2 = s1;
+    double c1 = s1.convolution(I, &me);
+    double c2 = s2.convolution(I, &me_lookup);
+    double c3 = s2.convolution(I, &me_lookup);
+    if (c1 != c2 || c1 != c3) {
+      std::cerr << "Convolution at (" << ip << ", " << jp << ") differs: " << c1 << " " << c2 << " " << c3
+                << std::endl;
+      return false;
+    }
+  }
+
+  // The lookup is not used for another image
+  vpImage<unsigned char> I2(I);
+  if (lookup.isValidFor(I2, me) || !lookup.isValidFor(I, me)) {
+    std::cerr << "The lookup should only be valid for the image it was updated with" << std::endl;
+    return false;
+  }
+  me.setMaskSize(5);
+  if (lookup.isValidFor(I, me)) {
+    std::cerr << "The lookup should not be valid after a change of the masks" << std::endl;
+    return false;
+  }
+
+  // A new frame stored in the same image is only told apart by the generation
+  const unsigned int generation = lookup.getGeneration();
+  lookup.update(I, me);
+  lookup.clear();
+  lookup.update(I, me);
+  if (generation != 1 || lookup.getGeneration() != generation + 2) {
+    std::cerr << "The generation should count the calls to update(): " << generation << " "
+              << lookup.getGeneration() << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool testTracking()
+{
+  vpMe me;
+  me.setRange(10);
+  me.setThreshold(5000);
+  me.setSampleStep(4);
+  me.setMaskSize(5);
+
+  vpMeGradientLookup lookup;
+  vpMe me_lookup(me);
+  me_lookup.setGradientLookup(&lookup);
+
+  vpMeLine line, line_lookup;
+  line.setMe(&me);
+  line_lookup.setMe(&me_lookup);
+  vpMeEllipse ellipse, ellipse_lookup;
+  ellipse.setMe(&me);
+  ellipse_lookup.setMe(&me_lookup);
+
+  vpImage<unsigned char> I;
+  for (unsigned int frame = 0; frame < 10; frame++) {
+    render(frame, I);
+    lookup.update(I, me_lookup);
+
+    if (frame == 0) {
+      vpImagePoint ip1(40, 100 + 0.3 * 40), ip2(200, 100 + 0.3 * 200);
+      line.initTracking(I, ip1, ip2);
+      line_lookup.initTracking(I, ip1, ip2);
+
+      // Five points on the contour of the ellipse
+      std::vector<vpImagePoint> ips;
+      const double ct = cos(vpMath::rad(20)), st = sin(vpMath::rad(20));
+      for (unsigned int k = 0; k < 5; k++) {
+        double x = 50 * cos(vpMath::rad(72.0 * k)), y = 30 * sin(vpMath::rad(72.0 * k));
+        ips.push_back(vpImagePoint(120 + x * st + y * ct, 220 + x * ct - y * st));
+      }
+      ellipse.initTracking(I, ips);
+      ellipse_lookup.initTracking(I, ips);
+    } else {
+      line.track(I);
+      line_lookup.track(I);
+      ellipse.track(I);
+      ellipse_lookup.track(I);
+    }
+
+    if (line.getRho() != line_lookup.getRho() || line.getTheta() != line_lookup.getTheta() ||
+        !sameSites(line.getMeList(), line_lookup.getMeList())) {
+      std::cerr << "Frame " << frame << ": the line differs with the lookup" << std::endl;
+      return false;
+    }
+    if (ellipse.getCenter() != ellipse_lookup.getCenter() || ellipse.getA() != ellipse_lookup.getA() ||
+        ellipse.getB() != ellipse_lookup.getB() || ellipse.getE() != ellipse_lookup.getE() ||
+        !sameSites(ellipse.getMeList(), ellipse_lookup.getMeList())) {
+      std::cerr << "Frame " << frame << ": the ellipse differs with the lookup" << std::endl;
+      return false;
+    }
+    if (line.getNbPoints() == 0 || ellipse.getNbPoints() == 0) {
+      std::cerr << "Frame " << frame << ": tracking failure" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    if (!testConvolution() || !testTracking()) {
+      std::cerr << "testMeGradientLookup failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testMeGradientLookup is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -48,6 +48,7 @@
 #include <math.h>
 
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/tt/vpTemplateTrackerFrame.h>
 #include <visp3/tt/vpTemplateTrackerHeader.h>
 #include <visp3/tt/vpTemplateTrackerWarp.h>
 #include <visp3/tt/vpTemplateTrackerZone.h>
@@ -89,6 +90,11 @@ protected:
 
   vpTemplateTrackerPointCompo *ptTemplateCompo;     // pour ESM
   vpTemplateTrackerPointCompo **ptTemplateCompoPyr; // pour ESM
+  // Template points as a structure of arrays, see initTemplateArrays()
+  vpTemplateTrackerPointArrays *ptTemplateArrays;
+  vpTemplateTrackerPointArrays **ptTemplateArraysPyr;
+  // Partial sums of the blocks of points, see initBlockSums()
+  std::vector<double> blockSums;
   vpTemplateTrackerZone *zoneTracked;
   vpTemplateTrackerZone *zoneTrackedPyr;
 
@@ -141,6 +147,8 @@ protected:
   vpImage<double> BI;
   vpImage<double> dIx;
   vpImage<double> dIy;
+  // Products of the frame being tracked, see track(const vpTemplateTrackerFrame &)
+  const vpTemplateTrackerFrame *sharedFrame;
   vpTemplateTrackerZone zoneRef_; // Reference zone
 
 public:
@@ -149,13 +157,14 @@ public:
     : nbLvlPyr(0), l0Pyr(0), pyrInitialised(false), ptTemplate(NULL), ptTemplatePyr(NULL), ptTemplateInit(false),
       templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL),
       ptTemplateSelectInit(false), templateSelectSize(0), ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL),
-      ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(),
-      Hdesire(), HdesirePyr(NULL), HLM(), HLMdesire(), HLMdesirePyr(NULL), HLMdesireInverse(),
+      ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), ptTemplateArrays(NULL), ptTemplateArraysPyr(NULL),
+      blockSums(), zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(), Hdesire(), HdesirePyr(NULL), HLM(),
+      HLMdesire(), HLMdesirePyr(NULL), HLMdesireInverse(),
       HLMdesireInversePyr(NULL), G(), gain(0), thresholdGradient(0), costFunctionVerification(false), blur(false),
       useBrent(false), nbIterBrent(0), taillef(0), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(0), mod_j(0),
       nbParam(), lambdaDep(0), iterationMax(0), iterationGlobale(0), diverge(false), nbIteration(0),
       useCompositionnal(false), useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(),
-      zoneRef_()
+      sharedFrame(NULL), zoneRef_()
   {
   }
   explicit vpTemplateTracker(vpTemplateTrackerWarp *_warp);
@@ -164,13 +173,23 @@ public:
   void display(const vpImage<unsigned char> &I, const vpColor &col = vpColor::green, unsigned int thickness = 3);
   void display(const vpImage<vpRGBa> &I, const vpColor &col = vpColor::green, unsigned int thickness = 3);
 
+  //! \return True if the images are blurred before the tracking.
+  bool getBlur() const { return blur; }
   bool getDiverge() const { return diverge; }
   vpColVector getdp() { return dp; }
   vpColVector getG() const { return G; }
+  //! \return The size of the Gaussian filters, see setGaussianFilterSize().
+  unsigned int getGaussianFilterSize() const { return taillef; }
   vpMatrix getH() const { return H; }
+  //! \return The maximum number of iterations of the estimation scheme.
+  unsigned int getIterationMax() const { return iterationMax; }
   unsigned int getNbParam() const { return nbParam; }
   unsigned int getNbIteration() const { return nbIteration; }
+  //! \return The number of pyramid levels, see setPyramidal().
+  unsigned int getNbPyramidLevels() const { return nbLvlPyr; }
   vpColVector getp() const { return p; }
+  //! \return The last level of the pyramid that is tracked, see setPyramidal().
+  unsigned int getPyramidLevelToStop() const { return l0Pyr; }
   double getRatioPixelIn() const { return ratioPixelIn; }
 
   /*!
@@ -266,6 +285,7 @@ public:
   void setUseBrent(bool b) { useBrent = b; }
 
   void track(const vpImage<unsigned char> &I);
+  void track(const vpTemplateTrackerFrame &frame);
   void trackRobust(const vpImage<unsigned char> &I);
 
 #if defined(VISP_BUILD_DEPRECATED_FUNCTIONS)
@@ -283,18 +303,39 @@ public:
 #endif
 
 protected:
+  /*!
+    Add the upper triangle of the outer product \f$ t t^T \f$ to the
+    \e n x \e n matrix \e H stored row by row.
+  */
+  static inline void addOuterProductUpper(const double *t, unsigned int n, double *H)
+  {
+    for (unsigned int it = 0; it < n; it++) {
+      double *H_it = H + it * n;
+      for (unsigned int jt = it; jt < n; jt++)
+        H_it[jt] += t[it] * t[jt];
+    }
+  }
+  static void copyUpperToLower(const double *Hupper, unsigned int n, vpMatrix &H);
   void computeEvalRMS(const vpColVector &p);
   void computeOptimalBrentGain(const vpImage<unsigned char> &I, vpColVector &tp, double tMI, vpColVector &direction,
                                double &alpha);
+  void getBlockRange(unsigned int block, unsigned int &begin, unsigned int &end) const;
   virtual double getCost(const vpImage<unsigned char> &I, const vpColVector &tp) = 0;
-  void getGaussianBluredImage(const vpImage<unsigned char> &I) { vpImageFilter::filter(I, BI, fgG, taillef); }
+  void getGaussianBluredImage(const vpImage<unsigned char> &I);
+  void getGaussianGradients(const vpImage<unsigned char> &I);
   virtual void initHessienDesired(const vpImage<unsigned char> &I) = 0;
   virtual void initHessienDesiredPyr(const vpImage<unsigned char> &I);
+  unsigned int initBlockSums(unsigned int stride);
   void initPosEvalRMS(const vpColVector &p);
   virtual void initPyramidal(unsigned int nbLvl, unsigned int l0);
+  void initTemplateArrays(unsigned int dWSize, unsigned int HiGSize, unsigned int dWCompoSize);
   void initTracking(const vpImage<unsigned char> &I, vpTemplateTrackerZone &zone);
   virtual void initTrackingPyr(const vpImage<unsigned char> &I, vpTemplateTrackerZone &zone);
   virtual void trackNoPyr(const vpImage<unsigned char> &I) = 0;
   virtual void trackPyr(const vpImage<unsigned char> &I);
+  void reduceBlockSums(unsigned int nbBlocks, unsigned int stride, double *sums) const;
+  void releaseSharedImages();
+  unsigned int sampleTemplateArrays(const vpImage<unsigned char> &I, bool gradient, bool strict = false);
+  void warpTemplateArrays(const vpColVector &tp);
 };
 #endif
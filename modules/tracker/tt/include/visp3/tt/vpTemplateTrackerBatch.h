@@ -0,0 +1,226 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Tracking of several templates in the same frame with shared image products.
+ *
+ *****************************************************************************/
+/*!
+ \file vpTemplateTrackerBatch.h
+ \brief Tracking of several templates in the same frame with shared image
+ products.
+*/
+
+#ifndef vpTemplateTrackerBatch_hh
+#define vpTemplateTrackerBatch_hh
+
+#include <map>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/tt/vpTemplateTracker.h>
+#include <visp3/tt/vpTemplateTrackerFrame.h>
+
+/*!
+  \class vpTemplateTrackerBatch
+  \ingroup group_tt_tracker
+
+  \brief Track several templates in the same frame, each one with its own
+  vpTemplateTracker, sharing the products of the image.
+
+  Independent trackers blur and derive the whole image and build their own
+  pyramid for each template. The batch computes these products once per
+  frame in a vpTemplateTrackerFrame (one per Gaussian filter size in use),
+  and each tracker reads them through
+  vpTemplateTracker::track(const vpTemplateTrackerFrame &). The results are
+  the ones of vpTemplateTracker::track().
+
+  The templates are then tracked concurrently with OpenMP when
+  setUseParallelTracking() is enabled. Each template iterates until its own
+  stopping criterion, and its outcome is given by getStatus():
+  - vpTemplateTrackerBatch::CONVERGED when the residual criterion (see
+    vpTemplateTracker::setThresholdResidualDifference()) stopped the
+    estimation before the maximum number of iterations;
+  - vpTemplateTrackerBatch::MAX_ITERATIONS otherwise;
+  - vpTemplateTrackerBatch::LOST when the tracker threw an exception or
+    diverged;
+  - vpTemplateTrackerBatch::SKIPPED when the time budget of the frame was
+    exhausted before the template was started (see setTimeBudget()). The
+    parameters of a skipped template are unchanged, and the skipped
+    templates are tracked first at the next frame.
+
+  The trackers are created, configured and initialized by the caller, and
+  must stay alive while they are in the batch. Two trackers must not share
+  the same warp.
+  \code
+#include <visp3/tt/vpTemplateTrackerBatch.h>
+#include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomography.h>
+
+int main()
+{
+  vpImage<unsigned char> I;
+  // ... acquire I
+  std::vector<vpTemplateTrackerWarpHomography> warps(2);
+  vpTemplateTrackerSSDInverseCompositional tracker1(&warps[0]), tracker2(&warps[1]);
+  // ... initialize the trackers on I with initClick() or initFromPoints()
+
+  vpTemplateTrackerBatch batch;
+  batch.addTracker(tracker1);
+  batch.addTracker(tracker2);
+  batch.setUseParallelTracking(true);
+  batch.setTimeBudget(20); // ms per frame
+
+  while (true) {
+    // ... acquire I
+    batch.track(I);
+    for (unsigned int i = 0; i < batch.getNbTrackers(); i++) {
+      if (batch.getStatus(i) == vpTemplateTrackerBatch::LOST) {
+        // ... reinitialize the template
+      }
+    }
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpTemplateTrackerBatch
+{
+public:
+  //! Outcome of the tracking of a template at the last frame
+  typedef enum {
+    NOT_TRACKED,    ///< No frame tracked yet, or the template is disabled
+    CONVERGED,      ///< The residual criterion stopped the estimation
+    MAX_ITERATIONS, ///< The estimation reached the maximum number of iterations
+    SKIPPED,        ///< Not tracked, the time budget of the frame was exhausted
+    LOST            ///< The tracker threw an exception or diverged
+  } vpTemplateStatus;
+
+  vpTemplateTrackerBatch();
+  virtual ~vpTemplateTrackerBatch();
+
+  unsigned int addTracker(vpTemplateTracker &tracker);
+  void clear();
+
+  //! \return The number of templates that are LOST at the last frame.
+  inline unsigned int getNbLost() const { return getNbStatus(LOST); }
+  //! \return The number of templates that are SKIPPED at the last frame.
+  inline unsigned int getNbSkipped() const { return getNbStatus(SKIPPED); }
+  //! \return The number of trackers in the batch.
+  inline unsigned int getNbTrackers() const { return static_cast<unsigned int>(m_trackers.size()); }
+  /*!
+    \return The time in milliseconds spent at the last frame to compute the
+    shared image products.
+  */
+  inline double getPreprocessingTime() const { return m_preprocessingTime; }
+  vpTemplateStatus getStatus(unsigned int index) const;
+  //! \return The time budget of a frame in milliseconds, 0 if unlimited.
+  inline double getTimeBudget() const { return m_timeBudget; }
+  //! \return The time in milliseconds spent by the last call to track().
+  inline double getTotalTime() const { return m_totalTime; }
+  vpTemplateTracker &getTracker(unsigned int index);
+  double getTrackingTime(unsigned int index) const;
+  //! \return True if the templates are tracked concurrently.
+  inline bool getUseParallelTracking() const { return m_useParallelTracking; }
+  //! \return True if the image products are shared by the trackers.
+  inline bool getUseSharedFrame() const { return m_useSharedFrame; }
+
+  bool isEnabled(unsigned int index) const;
+
+  void setEnabled(unsigned int index, bool enabled);
+  /*!
+    Set the number of threads used by setUseParallelTracking().
+
+    \param nb : Number of threads, 0 to use the OpenMP default.
+  */
+  inline void setNbParallelThreads(unsigned int nb) { m_nbParallelThreads = nb; }
+  /*!
+    Set the time budget of a frame. Once the budget is exhausted, the
+    templates that are not started yet are skipped. A started template is
+    tracked until its stopping criterion, so that the budget may be exceeded
+    by the time of one template per thread.
+
+    \param budget : Time budget in milliseconds, including the computation
+    of the image products, 0 for no limit.
+  */
+  inline void setTimeBudget(double budget) { m_timeBudget = budget; }
+  /*!
+    Enable or disable the concurrent tracking of the templates. Without
+    OpenMP, the templates are tracked one after the other.
+
+    \param parallel : If true, the templates are tracked concurrently.
+  */
+  inline void setUseParallelTracking(bool parallel) { m_useParallelTracking = parallel; }
+  /*!
+    Enable or disable the sharing of the image products. When disabled, each
+    tracker computes its own pyramid, blurred image and gradients, as with
+    vpTemplateTracker::track().
+
+    \param use : If true, the image products are computed once per frame.
+  */
+  inline void setUseSharedFrame(bool use) { m_useSharedFrame = use; }
+
+  void track(const vpImage<unsigned char> &I);
+
+private:
+  vpTemplateTrackerBatch(const vpTemplateTrackerBatch &);            // noncopyable
+  vpTemplateTrackerBatch &operator=(const vpTemplateTrackerBatch &); //
+
+  void buildFrames(const vpImage<unsigned char> &I);
+  unsigned int getNbStatus(vpTemplateStatus status) const;
+  void trackTemplate(unsigned int index, const vpImage<unsigned char> &I, double startTime);
+
+  //! Trackers of the templates
+  std::vector<vpTemplateTracker *> m_trackers;
+  //! True if the template is tracked
+  std::vector<bool> m_enabled;
+  //! Outcome of each template at the last frame
+  std::vector<vpTemplateStatus> m_status;
+  //! Time of the tracking of each template at the last frame, in milliseconds
+  std::vector<double> m_trackingTimes;
+  //! Order in which the templates are started, the skipped templates first
+  std::vector<unsigned int> m_order;
+  //! Image products of the last frame, per Gaussian filter size
+  std::map<unsigned int, vpTemplateTrackerFrame> m_frames;
+  //! Time budget of a frame in milliseconds, 0 if unlimited
+  double m_timeBudget;
+  //! If true, the templates are tracked concurrently
+  bool m_useParallelTracking;
+  //! Number of threads used to track the templates, 0 to use the OpenMP default
+  unsigned int m_nbParallelThreads;
+  //! If true, the image products are computed once per frame
+  bool m_useSharedFrame;
+  //! Time spent to compute the image products at the last frame, in milliseconds
+  double m_preprocessingTime;
+  //! Time spent by the last call to track(), in milliseconds
+  double m_totalTime;
+};
+
+#endif
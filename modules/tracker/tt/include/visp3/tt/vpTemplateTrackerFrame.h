@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Image products of a frame shared by several template trackers.
+ *
+ *****************************************************************************/
+/*!
+ \file vpTemplateTrackerFrame.h
+ \brief Image products of a frame shared by several template trackers.
+*/
+
+#ifndef vpTemplateTrackerFrame_hh
+#define vpTemplateTrackerFrame_hh
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+
+/*!
+  \class vpTemplateTrackerFrame
+  \ingroup group_tt_tools
+
+  \brief Products of an image computed once and read by several template
+  trackers: the Gaussian pyramid and, at each level, the blurred image and
+  the image gradients.
+
+  Every template tracker blurs and derives the whole image in its own
+  trackNoPyr(), and builds its own pyramid. When several templates are
+  tracked in the same frame, build() computes these products once and
+  vpTemplateTracker::track(const vpTemplateTrackerFrame &) reads them
+  instead. The products are computed with the same filters as the trackers,
+  so that the results of the tracking are unchanged.
+
+  A frame can be used by a tracker if its Gaussian filter size is the one of
+  the tracker (see vpTemplateTracker::setGaussianFilterSize()), if it holds
+  the levels of the pyramid that the tracker processes and, when the tracker
+  blurs the images, the blurred images.
+
+  The frame must not be modified while a tracker reads it.
+*/
+class VISP_EXPORT vpTemplateTrackerFrame
+{
+public:
+  explicit vpTemplateTrackerFrame(unsigned int filterSize = 7, bool blur = true);
+
+  void build(const vpImage<unsigned char> &I, unsigned int nbLevels = 1, unsigned int firstLevel = 0);
+
+  //! \return True if the blurred images are computed.
+  inline bool getBlur() const { return m_blur; }
+  const vpImage<double> &getBlurredImage(unsigned int level) const;
+  //! \return The size of the Gaussian filters.
+  inline unsigned int getFilterSize() const { return m_filterSize; }
+  //! \return The first level whose blurred image and gradients are computed.
+  inline unsigned int getFirstLevel() const { return m_firstLevel; }
+  const vpImage<double> &getGradientX(unsigned int level) const;
+  const vpImage<double> &getGradientY(unsigned int level) const;
+  const vpImage<unsigned char> &getImage(unsigned int level) const;
+  int getLevel(const vpImage<unsigned char> &I) const;
+  //! \return The number of levels of the pyramid.
+  inline unsigned int getNbLevels() const { return static_cast<unsigned int>(m_pyramid.size()); }
+
+  bool isCompatible(unsigned int filterSize, bool blur, unsigned int nbLevels, unsigned int firstLevel) const;
+
+  void setBlur(bool blur);
+  void setFilterSize(unsigned int filterSize);
+
+private:
+  //! Size of the Gaussian filters
+  unsigned int m_filterSize;
+  //! If true, the blurred images are computed
+  bool m_blur;
+  //! Gaussian kernel
+  std::vector<double> m_fgG;
+  //! Gaussian derivative kernel
+  std::vector<double> m_fgdG;
+  //! First level whose blurred image and gradients are computed
+  unsigned int m_firstLevel;
+  //! Gaussian pyramid, level 0 is a copy of the image
+  std::vector<vpImage<unsigned char> > m_pyramid;
+  //! Blurred image of each level
+  std::vector<vpImage<double> > m_BI;
+  //! Gradient along the columns of each level
+  std::vector<vpImage<double> > m_dIx;
+  //! Gradient along the rows of each level
+  std::vector<vpImage<double> > m_dIy;
+};
+
+#endif
@@ -46,6 +46,7 @@
 #define vpTemplateTrackerHeader_hh
 
 #include <stdio.h>
+#include <vector>
 
 /*!
   \struct vpTemplateTrackerZPoint
@@ -87,6 +88,65 @@ struct vpTemplateTrackerPointCompo {
   vpTemplateTrackerPointCompo() : dW(NULL) {}
 };
 
+/*!
+  \struct vpTemplateTrackerPointArrays
+  \ingroup group_tt_tools
+
+  Points of a template stored as a structure of arrays. The i-th element of
+  each array belongs to the i-th point, the points being in the order of the
+  template. The derivatives of a point are stored contiguously, \e dWSize,
+  \e HiGSize or \e dWCompoSize values per point.
+
+  The last arrays hold the state of the points for the current estimate of
+  the warp parameters, they are updated at each iteration of the
+  minimization.
+*/
+struct vpTemplateTrackerPointArrays {
+  //! Coordinates along the columns
+  std::vector<double> x;
+  //! Coordinates along the rows
+  std::vector<double> y;
+  //! Gradient along the columns
+  std::vector<double> dx;
+  //! Gradient along the rows
+  std::vector<double> dy;
+  //! Intensity of the template
+  std::vector<double> val;
+  //! Derivative of the template with respect to the warp parameters
+  std::vector<double> dW;
+  //! Steepest descent images premultiplied by the inverse of the Hessian
+  std::vector<double> HiG;
+  //! Derivative of the warp with respect to the parameters at p=0
+  std::vector<double> dWCompo;
+  unsigned int dWSize;
+  unsigned int HiGSize;
+  unsigned int dWCompoSize;
+
+  //! Warped coordinates along the columns
+  std::vector<double> x2;
+  //! Warped coordinates along the rows
+  std::vector<double> y2;
+  //! 1 when the warped point is inside the image
+  std::vector<unsigned char> inImage;
+  //! Intensity of the image at the warped point
+  std::vector<double> IW;
+  //! Gradient of the image along the columns at the warped point
+  std::vector<double> dIWx;
+  //! Gradient of the image along the rows at the warped point
+  std::vector<double> dIWy;
+  //! Derivative of the warp at the warped point, 2 x nbParam values per point
+  std::vector<double> dWarp;
+
+  vpTemplateTrackerPointArrays()
+    : x(), y(), dx(), dy(), val(), dW(), HiG(), dWCompo(), dWSize(0), HiGSize(0), dWCompoSize(0), x2(), y2(),
+      inImage(), IW(), dIWx(), dIWy(), dWarp()
+  {
+  }
+
+  //! Number of points.
+  unsigned int size() const { return static_cast<unsigned int>(x.size()); }
+};
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 struct vpTemplateTrackerPointSuppMIInv {
   double et;
@@ -67,6 +67,7 @@ protected:
   vpRowVector temp;
 
 protected:
+  double computeHessianGradient(bool esm, vpMatrix &Hs, vpColVector &Gs, vpColVector *GInvs = NULL);
   double getCost(const vpImage<unsigned char> &I, const vpColVector &tp);
   double getCost(const vpImage<unsigned char> &I) { return getCost(I, p); }
   virtual void initHessienDesired(const vpImage<unsigned char> &I) = 0;
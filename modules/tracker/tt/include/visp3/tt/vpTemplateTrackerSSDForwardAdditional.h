@@ -66,7 +66,7 @@ private:
   vpMatrix KQuasiNewton;
 
 protected:
-  void initHessienDesired(const vpImage<unsigned char> & /*I*/) {}
+  void initHessienDesired(const vpImage<unsigned char> &I);
   void trackNoPyr(const vpImage<unsigned char> &I);
 
 public:
@@ -97,6 +97,46 @@ public:
   virtual void dWarpCompo(const vpColVector &X1, const vpColVector &X2, const vpColVector &ParamM, const double *dwdp0,
                           vpMatrix &dW) = 0;
 
+  /*!
+    Compute the compositionnal derivative of the warping function according to
+    its parameters for a list of points. The default implementation calls
+    computeDenom() and dWarpCompo() for each point.
+
+    \warning computeCoeff() has to be called with the same parameters before.
+
+    \param u : Coordinates along the columns of the points.
+    \param v : Coordinates along the rows of the points.
+    \param u2 : Coordinates along the columns of the warped points.
+    \param v2 : Coordinates along the rows of the warped points.
+    \param nbPoints : Number of points.
+    \param ParamM : Parameters of the warping function.
+    \param dwdp0 : Derivatives of the warping function according to the
+    initial parameters (p=0), 2*nbParam values per point as given by
+    getdWdp0().
+    \param dW : Resulting compositionnal derivatives, stored as \e dwdp0.
+  */
+  virtual void dWarpCompoPoints(const double *u, const double *v, const double *u2, const double *v2,
+                                unsigned int nbPoints, const vpColVector &ParamM, const double *dwdp0, double *dW);
+
+  /*!
+    Compute the derivative of the warping function according to its
+    parameters for a list of points. The default implementation calls
+    computeDenom() and dWarp() for each point.
+
+    \warning computeCoeff() has to be called with the same parameters before.
+
+    \param u : Coordinates along the columns of the points.
+    \param v : Coordinates along the rows of the points.
+    \param u2 : Coordinates along the columns of the warped points.
+    \param v2 : Coordinates along the rows of the warped points.
+    \param nbPoints : Number of points.
+    \param ParamM : Parameters of the warping function.
+    \param dW : Resulting derivatives. The 2 x nbParam matrix of the point \e i
+    is stored row by row at the offset 2*nbParam*i.
+  */
+  virtual void dWarpPoints(const double *u, const double *v, const double *u2, const double *v2, unsigned int nbPoints,
+                           const vpColVector &ParamM, double *dW);
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
   void findWarp(const double *ut0, const double *vt0, const double *u, const double *v, int nb_pt, vpColVector &p);
 #endif
@@ -224,6 +264,23 @@ public:
   */
   virtual void warpX(const vpColVector &vX, vpColVector &vXres, const vpColVector &ParamM) = 0;
 
+  /*!
+    Warp a list of points stored in contiguous arrays. The default
+    implementation calls computeDenom() and warpX() for each point, the
+    warping functions of ViSP process several points at once.
+
+    \warning computeCoeff() has to be called with the same parameters before.
+
+    \param u : Coordinates along the columns of the points to warp.
+    \param v : Coordinates along the rows of the points to warp.
+    \param nbPoints : Number of points.
+    \param ParamM : Parameters of the warping function.
+    \param u2 : Coordinates along the columns of the warped points.
+    \param v2 : Coordinates along the rows of the warped points.
+  */
+  virtual void warpPoints(const double *u, const double *v, unsigned int nbPoints, const vpColVector &ParamM,
+                          double *u2, double *v2);
+
   /*!
     Inverse Warp a point.
 
@@ -252,6 +309,14 @@ public:
     vpTemplateTracker::getp(). \param out : Resulting zone.
   */
   void warpZone(const vpTemplateTrackerZone &in, const vpColVector &p, vpTemplateTrackerZone &out);
+
+protected:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  static void dWarpCompoPointsLinear(const double *A, unsigned int nbPoints, unsigned int nbParam, const double *dwdp0,
+                                     double *dW);
+  static void warpPointsAffine(const double *u, const double *v, unsigned int nbPoints, const double *A, double *u2,
+                               double *v2);
+#endif
 };
 
 #endif
@@ -108,6 +108,13 @@ public:
   void dWarpCompo(const vpColVector &X1, const vpColVector &X2, const vpColVector &ParamM, const double *dwdp0,
                   vpMatrix &dW);
 
+  /*!
+    Compute the compositionnal derivative of the warping function for a list
+    of points, see vpTemplateTrackerWarp::dWarpCompoPoints().
+  */
+  void dWarpCompoPoints(const double *u, const double *v, const double *u2, const double *v2, unsigned int nbPoints,
+                        const vpColVector &ParamM, const double *dwdp0, double *dW);
+
   /*!
     Find the displacement/warping function parameters from a list of points.
 
@@ -203,6 +210,12 @@ public:
   */
   void pRondp(const vpColVector &p1, const vpColVector &p2, vpColVector &pres) const;
 
+  /*!
+    Warp a list of points, see vpTemplateTrackerWarp::warpPoints().
+  */
+  void warpPoints(const double *u, const double *v, unsigned int nbPoints, const vpColVector &ParamM, double *u2,
+                  double *v2);
+
   /*!
     Warp a point.
 
@@ -87,6 +87,20 @@ public:
   void dWarpCompo(const vpColVector &X1, const vpColVector &X2, const vpColVector &ParamM, const double *dwdp0,
                   vpMatrix &dW);
 
+  /*!
+    Compute the compositionnal derivative of the warping function for a list
+    of points, see vpTemplateTrackerWarp::dWarpCompoPoints().
+  */
+  void dWarpCompoPoints(const double *u, const double *v, const double *u2, const double *v2, unsigned int nbPoints,
+                        const vpColVector &ParamM, const double *dwdp0, double *dW);
+
+  /*!
+    Compute the derivative of the warping function for a list of points, see
+    vpTemplateTrackerWarp::dWarpPoints().
+  */
+  void dWarpPoints(const double *u, const double *v, const double *u2, const double *v2, unsigned int nbPoints,
+                   const vpColVector &ParamM, double *dW);
+
   /*!
       Compute the derivative of the image with relation to the warping
      function parameters.
@@ -152,6 +166,12 @@ public:
     */
   void pRondp(const vpColVector &p1, const vpColVector &p2, vpColVector &pres) const;
 
+  /*!
+    Warp a list of points, see vpTemplateTrackerWarp::warpPoints().
+  */
+  void warpPoints(const double *u, const double *v, unsigned int nbPoints, const vpColVector &ParamM, double *u2,
+                  double *v2);
+
   /*!
       Warp a point.
 
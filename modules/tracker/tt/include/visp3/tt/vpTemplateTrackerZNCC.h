@@ -69,6 +69,7 @@ protected:
   vpRowVector temp;
 
 protected:
+  void computeMeans(unsigned int Nbpoint, double &moyTij, double &moyIW);
   double getCost(const vpImage<unsigned char> &I, const vpColVector &tp);
   double getCost(const vpImage<unsigned char> &I)
   {
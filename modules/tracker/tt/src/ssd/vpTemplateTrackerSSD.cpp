@@ -38,6 +38,8 @@
  *
  *****************************************************************************/
 
+#include <vector>
+
 #include <visp3/tt/vpTemplateTrackerSSD.h>
 
 vpTemplateTrackerSSD::vpTemplateTrackerSSD(vpTemplateTrackerWarp *warp) : vpTemplateTracker(warp), DI(), temp()
@@ -56,32 +58,28 @@ vpTemplateTrackerSSD::vpTemplateTrackerSSD(vpTemplateTrackerWarp *warp) : vpTemp
 
 double vpTemplateTrackerSSD::getCost(const vpImage<unsigned char> &I, const vpColVector &tp)
 {
-  double erreur = 0;
-  double IW;
-  int Nbpoint = 0;
-
-  Warp->computeCoeff(tp);
-  for (unsigned int point = 0; point < templateSize; point++) {
-    int i = ptTemplate[point].y;
-    int j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-    Warp->computeDenom(X1, tp);
-    Warp->warpX(X1, X2, tp);
+  warpTemplateArrays(tp);
+  const unsigned int Nbpoint = sampleTemplateArrays(I, false);
+  const vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
 
-    double j2 = X2[0];
-    double i2 = X2[1];
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-      double Tij = ptTemplate[point].val;
-      if (!blur)
-        IW = I.getValue(i2, j2);
-      else
-        IW = BI.getValue(i2, j2);
-      // IW=getSubPixBspline4(I,i2,j2);
-      erreur += (Tij - IW) * (Tij - IW);
-      Nbpoint++;
+  const unsigned int nbBlocks = initBlockSums(1);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbBlocks > 1)
+#endif
+  for (int block = 0; block < static_cast<int>(nbBlocks); block++) {
+    unsigned int begin, end;
+    getBlockRange(static_cast<unsigned int>(block), begin, end);
+    double erreur = 0;
+    for (unsigned int point = begin; point < end; point++) {
+      if (pts.inImage[point]) {
+        double er = pts.val[point] - pts.IW[point];
+        erreur += er * er;
+      }
     }
+    blockSums[static_cast<unsigned int>(block)] = erreur;
   }
+  double erreur;
+  reduceBlockSums(nbBlocks, 1, &erreur);
   ratioPixelIn = static_cast<double>(Nbpoint) / static_cast<double>(templateSize);
 
   if (Nbpoint == 0)
@@ -89,6 +87,82 @@ double vpTemplateTrackerSSD::getCost(const vpImage<unsigned char> &I, const vpCo
   return erreur / Nbpoint;
 }
 
+/*!
+  Compute the Gauss-Newton approximation of the Hessian and the gradient of
+  the SSD from the points warped with warpTemplateArrays() and sampled with
+  sampleTemplateArrays(). The derivative of the warp of each point has to be
+  stored in ptTemplateArrays->dWarp.
+
+  \param esm : If true, the gradient of the template is added to the gradient
+  of the image as done by the ESM, and the gradient \e GInv of the inverse
+  compositional formulation is computed too.
+  \param Hs : Hessian.
+  \param Gs : Gradient.
+  \param GInvs : Gradient of the inverse formulation, only used with ESM.
+
+  \return The sum of the squared differences.
+*/
+double vpTemplateTrackerSSD::computeHessianGradient(bool esm, vpMatrix &Hs, vpColVector &Gs, vpColVector *GInvs)
+{
+  const vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  const unsigned int nbParam2 = nbParam * nbParam;
+  // Upper triangle of H, G, GInv and the error
+  const unsigned int stride = nbParam2 + 2 * nbParam + 1;
+
+  const unsigned int nbBlocks = initBlockSums(stride);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbBlocks > 1)
+#endif
+  for (int block = 0; block < static_cast<int>(nbBlocks); block++) {
+    unsigned int begin, end;
+    getBlockRange(static_cast<unsigned int>(block), begin, end);
+    double *Hblock = &blockSums[static_cast<unsigned int>(block) * stride];
+    double *Gblock = Hblock + nbParam2;
+    double *GInvblock = Gblock + nbParam;
+    double erreur = 0;
+    std::vector<double> tempt(nbParam);
+
+    for (unsigned int point = begin; point < end; point++) {
+      if (!pts.inImage[point]) {
+        continue;
+      }
+      double er = pts.val[point] - pts.IW[point];
+      double dIWx = pts.dIWx[point];
+      double dIWy = pts.dIWy[point];
+      if (esm) {
+        const double *dW0 = &pts.dW[point * pts.dWSize];
+        for (unsigned int it = 0; it < nbParam; it++)
+          GInvblock[it] += er * dW0[it];
+        dIWx += pts.dx[point];
+        dIWy += pts.dy[point];
+      }
+      erreur += er * er;
+
+      const double *dWp = &pts.dWarp[2 * nbParam * point];
+      for (unsigned int it = 0; it < nbParam; it++)
+        tempt[it] = dWp[it] * dIWx + dWp[nbParam + it] * dIWy;
+
+      addOuterProductUpper(&tempt[0], nbParam, Hblock);
+      for (unsigned int it = 0; it < nbParam; it++)
+        Gblock[it] += er * tempt[it];
+    }
+    GInvblock[nbParam] = erreur;
+  }
+
+  std::vector<double> sums(stride);
+  reduceBlockSums(nbBlocks, stride, &sums[0]);
+  copyUpperToLower(&sums[0], nbParam, Hs);
+  Gs.resize(nbParam, false);
+  for (unsigned int it = 0; it < nbParam; it++)
+    Gs[it] = sums[nbParam2 + it];
+  if (GInvs != NULL) {
+    GInvs->resize(nbParam, false);
+    for (unsigned int it = 0; it < nbParam; it++)
+      (*GInvs)[it] = sums[nbParam2 + nbParam + it];
+  }
+  return sums[stride - 1];
+}
+
 double vpTemplateTrackerSSD::getSSD(const vpImage<unsigned char> &I, const vpColVector &tp)
 {
   double erreur = 0;
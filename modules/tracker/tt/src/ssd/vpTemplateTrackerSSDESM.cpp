@@ -88,22 +88,19 @@ void vpTemplateTrackerSSDESM::initCompInverse(const vpImage<unsigned char> & /*I
   }
   vpMatrix::computeHLM(HInv, lambdaDep, HLMInv);
 
+  initTemplateArrays(nbParam, 0, 2 * nbParam);
   compoInitialised = true;
 }
 
 void vpTemplateTrackerSSDESM::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+    getGaussianBluredImage(I);
+  getGaussianGradients(I);
 
-  double IW, dIWx, dIWy;
-  double Tij;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   double alpha = 2.;
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
 
   initPosEvalRMS(p);
 
@@ -112,60 +109,17 @@ void vpTemplateTrackerSSDESM::trackNoPyr(const vpImage<unsigned char> &I)
   double evolRMS_delta;
 
   do {
-    unsigned int Nbpoint = 0;
-    double erreur = 0;
     dp = 0;
-    HDir = 0;
-    GDir = 0;
-    GInv = 0;
-    Warp->computeCoeff(p);
-    for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        // INVERSE
-        Tij = ptTemplate[point].val;
-        if (!blur)
-          IW = I.getValue(i2, j2);
-        else
-          IW = BI.getValue(i2, j2);
-        Nbpoint++;
-        double er = (Tij - IW);
-        for (unsigned int it = 0; it < nbParam; it++)
-          GInv[it] += er * ptTemplate[point].dW[it];
-
-        erreur += er * er;
-
-        dIWx = dIx.getValue(i2, j2) + ptTemplate[point].dx;
-        dIWy = dIy.getValue(i2, j2) + ptTemplate[point].dy;
-
-        // Calcul du Hessien
-        Warp->dWarpCompo(X1, X2, p, ptTemplateCompo[point].dW, dW);
-
-        double *tempt = new double[nbParam];
-        for (unsigned int it = 0; it < nbParam; it++)
-          tempt[it] = dW[0][it] * dIWx + dW[1][it] * dIWy;
-
-        for (unsigned int it = 0; it < nbParam; it++)
-          for (unsigned int jt = 0; jt < nbParam; jt++)
-            HDir[it][jt] += tempt[it] * tempt[jt];
-
-        for (unsigned int it = 0; it < nbParam; it++)
-          GDir[it] += er * tempt[it];
-        delete[] tempt;
-      }
-    }
+    warpTemplateArrays(p);
+    unsigned int Nbpoint = sampleTemplateArrays(I, true);
     if (Nbpoint == 0) {
       throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
     }
+    // Calcul du Hessien
+    pts.dWarp.resize(2 * nbParam * pts.size());
+    Warp->dWarpCompoPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dWCompo[0],
+                           &pts.dWarp[0]);
+    double erreur = computeHessianGradient(true, HDir, GDir, &GInv);
 
     vpMatrix::computeHLM(HDir, lambdaDep, HLMDir);
 
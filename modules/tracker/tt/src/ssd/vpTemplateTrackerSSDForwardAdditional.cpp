@@ -49,22 +49,21 @@ vpTemplateTrackerSSDForwardAdditional::vpTemplateTrackerSSDForwardAdditional(vpT
   useCompositionnal = false;
 }
 
+void vpTemplateTrackerSSDForwardAdditional::initHessienDesired(const vpImage<unsigned char> & /*I*/)
+{
+  initTemplateArrays(0, 0, 0);
+}
+
 void vpTemplateTrackerSSDForwardAdditional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
-
-  dW = 0;
+    getGaussianBluredImage(I);
+  getGaussianGradients(I);
 
   double lambda = lambdaDep;
-  double IW, dIWx, dIWy;
-  double Tij;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   double alpha = 2.;
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
 
   initPosEvalRMS(p);
 
@@ -73,54 +72,15 @@ void vpTemplateTrackerSSDForwardAdditional::trackNoPyr(const vpImage<unsigned ch
   double evolRMS_delta;
 
   do {
-    unsigned int Nbpoint = 0;
-    double erreur = 0;
-    G = 0;
-    H = 0;
-    Warp->computeCoeff(p);
-    for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Tij = ptTemplate[point].val;
-
-        if (!blur)
-          IW = I.getValue(i2, j2);
-        else
-          IW = BI.getValue(i2, j2);
-
-        dIWx = dIx.getValue(i2, j2);
-        dIWy = dIy.getValue(i2, j2);
-        Nbpoint++;
-        // Calcul du Hessien
-        Warp->dWarp(X1, X2, p, dW);
-        double *tempt = new double[nbParam];
-        for (unsigned int it = 0; it < nbParam; it++)
-          tempt[it] = dW[0][it] * dIWx + dW[1][it] * dIWy;
-
-        for (unsigned int it = 0; it < nbParam; it++)
-          for (unsigned int jt = 0; jt < nbParam; jt++)
-            H[it][jt] += tempt[it] * tempt[jt];
-
-        double er = (Tij - IW);
-        for (unsigned int it = 0; it < nbParam; it++)
-          G[it] += er * tempt[it];
-
-        erreur += (er * er);
-        delete[] tempt;
-      }
-    }
+    warpTemplateArrays(p);
+    unsigned int Nbpoint = sampleTemplateArrays(I, true);
     if (Nbpoint == 0) {
       throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
     }
+    // Calcul du Hessien
+    pts.dWarp.resize(2 * nbParam * pts.size());
+    Warp->dWarpPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dWarp[0]);
+    double erreur = computeHessianGradient(false, H, G);
 
     vpMatrix::computeHLM(H, lambda, HLM);
     try {
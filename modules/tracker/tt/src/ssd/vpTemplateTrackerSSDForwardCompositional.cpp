@@ -56,6 +56,7 @@ void vpTemplateTrackerSSDForwardCompositional::initCompo(const vpImage<unsigned
     Warp->computeDenom(X1, p);
     Warp->getdWdp0(i, j, ptTemplate[point].dW);
   }
+  initTemplateArrays(2 * nbParam, 0, 0);
   compoInitialised = true;
 }
 
@@ -68,20 +69,14 @@ void vpTemplateTrackerSSDForwardCompositional::trackNoPyr(const vpImage<unsigned
   }
 
   if (blur) {
-    vpImageFilter::filter(I, BI, fgG, taillef);
+    getGaussianBluredImage(I);
   }
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
-
-  dW = 0;
+  getGaussianGradients(I);
 
   double lambda = lambdaDep;
-  double IW, dIWx, dIWy;
-  double Tij;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   double alpha = 2.;
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
 
   initPosEvalRMS(p);
 
@@ -90,53 +85,14 @@ void vpTemplateTrackerSSDForwardCompositional::trackNoPyr(const vpImage<unsigned
   double evolRMS_delta;
 
   do {
-    unsigned int Nbpoint = 0;
-    double erreur = 0;
-    G = 0;
-    H = 0;
-    Warp->computeCoeff(p);
-    for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Tij = ptTemplate[point].val;
-        if (!blur)
-          IW = I.getValue(i2, j2);
-        else
-          IW = BI.getValue(i2, j2);
-        dIWx = dIx.getValue(i2, j2);
-        dIWy = dIy.getValue(i2, j2);
-        Nbpoint++;
-
-        Warp->dWarpCompo(X1, X2, p, ptTemplate[point].dW, dW);
-
-        double *tempt = new double[nbParam];
-        for (unsigned int it = 0; it < nbParam; it++)
-          tempt[it] = dW[0][it] * dIWx + dW[1][it] * dIWy;
-
-        for (unsigned int it = 0; it < nbParam; it++)
-          for (unsigned int jt = 0; jt < nbParam; jt++)
-            H[it][jt] += tempt[it] * tempt[jt];
-
-        double er = (Tij - IW);
-        for (unsigned int it = 0; it < nbParam; it++)
-          G[it] += er * tempt[it];
-
-        erreur += (er * er);
-        delete[] tempt;
-      }
-    }
+    warpTemplateArrays(p);
+    unsigned int Nbpoint = sampleTemplateArrays(I, true);
     if (Nbpoint == 0) {
       throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
     }
+    pts.dWarp.resize(2 * nbParam * pts.size());
+    Warp->dWarpCompoPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dW[0], &pts.dWarp[0]);
+    double erreur = computeHessianGradient(false, H, G);
 
     vpMatrix::computeHLM(H, lambda, HLM);
 
@@ -87,6 +87,7 @@ void vpTemplateTrackerSSDInverseCompositional::initCompInverse(const vpImage<uns
         ptTemplate[point].HiG[it] = HiGtemp[it];
     }
   }
+  initTemplateArrays(0, nbParam, 0);
   compoInitialised = true;
 }
 
@@ -98,55 +99,55 @@ void vpTemplateTrackerSSDInverseCompositional::initHessienDesired(const vpImage<
 void vpTemplateTrackerSSDInverseCompositional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
+    getGaussianBluredImage(I);
 
   vpColVector dpinv(nbParam);
-  double IW;
-  double Tij;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   double alpha = 2.;
   initPosEvalRMS(p);
 
-  vpTemplateTrackerPoint *pt;
+  const vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  // dp, the error and the number of points
+  const unsigned int stride = nbParam + 2;
+  std::vector<double> sums(stride);
 
   double evolRMS_init = 0;
   double evolRMS_prec = 0;
   double evolRMS_delta;
 
   do {
-    unsigned int Nbpoint = 0;
-    double erreur = 0;
-    dp = 0;
-    Warp->computeCoeff(p);
-    for (unsigned int point = 0; point < templateSize; point++) {
-      if ((!useTemplateSelect) || (ptTemplateSelect[point])) {
-        pt = &ptTemplate[point];
-        i = pt->y;
-        j = pt->x;
-        X1[0] = j;
-        X1[1] = i;
-        Warp->computeDenom(X1, p);
-        Warp->warpX(X1, X2, p);
-        j2 = X2[0];
-        i2 = X2[1];
-
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-          Tij = pt->val;
-          if (!blur)
-            IW = I.getValue(i2, j2);
-          else
-            IW = BI.getValue(i2, j2);
+    warpTemplateArrays(p);
+    sampleTemplateArrays(I, false);
+
+    const unsigned int nbBlocks = initBlockSums(stride);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbBlocks > 1)
+#endif
+    for (int block = 0; block < static_cast<int>(nbBlocks); block++) {
+      unsigned int begin, end;
+      getBlockRange(static_cast<unsigned int>(block), begin, end);
+      double *dpblock = &blockSums[static_cast<unsigned int>(block) * stride];
+      double erreur = 0;
+      unsigned int Nbpoint = 0;
+      for (unsigned int point = begin; point < end; point++) {
+        if (pts.inImage[point] && ((!useTemplateSelect) || (ptTemplateSelect[point]))) {
           Nbpoint++;
-          double er = (Tij - IW);
+          double er = pts.val[point] - pts.IW[point];
+          const double *HiG = &pts.HiG[point * nbParam];
           for (unsigned int it = 0; it < nbParam; it++)
-            dp[it] += er * pt->HiG[it];
+            dpblock[it] += er * HiG[it];
 
           erreur += er * er;
         }
       }
+      dpblock[nbParam] = erreur;
+      dpblock[nbParam + 1] = Nbpoint;
     }
+    reduceBlockSums(nbBlocks, stride, &sums[0]);
+    for (unsigned int it = 0; it < nbParam; it++)
+      dp[it] = sums[it];
+    double erreur = sums[nbParam];
+    unsigned int Nbpoint = static_cast<unsigned int>(sums[nbParam + 1]);
     if (Nbpoint == 0) {
       throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
     }
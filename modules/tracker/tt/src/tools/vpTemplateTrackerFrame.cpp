@@ -0,0 +1,219 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Image products of a frame shared by several template trackers.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/tt/vpTemplateTrackerFrame.h>
+
+/*!
+  Constructor.
+
+  \param filterSize : Size of the Gaussian filters, see
+  vpTemplateTracker::setGaussianFilterSize().
+  \param blur : If true, the blurred images are computed.
+*/
+vpTemplateTrackerFrame::vpTemplateTrackerFrame(unsigned int filterSize, bool blur)
+  : m_filterSize(0), m_blur(blur), m_fgG(), m_fgdG(), m_firstLevel(0), m_pyramid(), m_BI(), m_dIx(), m_dIy()
+{
+  setFilterSize(filterSize);
+}
+
+/*!
+  Compute the products of an image: the Gaussian pyramid and, from level \e
+  firstLevel, the blurred images and the gradients.
+
+  The filters are the ones of vpTemplateTracker::trackNoPyr() and
+  vpTemplateTracker::trackPyr(). The products of the levels are computed
+  concurrently when OpenMP is available.
+
+  \param I : Image of the frame.
+  \param nbLevels : Number of levels of the pyramid, at least 1.
+  \param firstLevel : First level whose blurred image and gradients are
+  computed. The lower levels are only used to build the pyramid.
+*/
+void vpTemplateTrackerFrame::build(const vpImage<unsigned char> &I, unsigned int nbLevels, unsigned int firstLevel)
+{
+  if (nbLevels == 0) {
+    nbLevels = 1;
+  }
+  if (firstLevel >= nbLevels) {
+    throw(vpException(vpException::badValue, "First level %d of the frame is not lower than the number of levels %d",
+                      firstLevel, nbLevels));
+  }
+
+  m_firstLevel = firstLevel;
+  m_pyramid.resize(nbLevels);
+  m_BI.resize(nbLevels);
+  m_dIx.resize(nbLevels);
+  m_dIy.resize(nbLevels);
+
+  m_pyramid[0] = I;
+  for (unsigned int i = 1; i < nbLevels; i++) {
+    vpImageFilter::getGaussPyramidal(m_pyramid[i - 1], m_pyramid[i]);
+  }
+
+  // The products of the unused levels are released
+  for (unsigned int i = 0; i < firstLevel; i++) {
+    m_BI[i].destroy();
+    m_dIx[i].destroy();
+    m_dIy[i].destroy();
+  }
+  if (!m_blur) {
+    for (unsigned int i = firstLevel; i < nbLevels; i++) {
+      m_BI[i].destroy();
+    }
+  }
+
+  // One task per product and per level: gradient along x, along y, blurred image
+  const unsigned int nbProducts = m_blur ? 3 : 2;
+  const int nbTasks = static_cast<int>(nbProducts * (nbLevels - firstLevel));
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(dynamic, 1) if (nbTasks > 1)
+#endif
+  for (int task = 0; task < nbTasks; task++) {
+    const unsigned int level = firstLevel + static_cast<unsigned int>(task) / nbProducts;
+    const unsigned int product = static_cast<unsigned int>(task) % nbProducts;
+    if (product == 0) {
+      vpImageFilter::getGradXGauss2D(m_pyramid[level], m_dIx[level], &m_fgG[0], &m_fgdG[0], m_filterSize);
+    } else if (product == 1) {
+      vpImageFilter::getGradYGauss2D(m_pyramid[level], m_dIy[level], &m_fgG[0], &m_fgdG[0], m_filterSize);
+    } else {
+      vpImageFilter::filter(m_pyramid[level], m_BI[level], &m_fgG[0], m_filterSize);
+    }
+  }
+}
+
+/*!
+  \return The blurred image of a level.
+
+  \param level : Level of the pyramid, computed by the last call to build().
+*/
+const vpImage<double> &vpTemplateTrackerFrame::getBlurredImage(unsigned int level) const
+{
+  if (!m_blur || level < m_firstLevel || level >= m_BI.size()) {
+    throw(vpException(vpException::badValue, "No blurred image at level %d of the frame", level));
+  }
+  return m_BI[level];
+}
+
+/*!
+  \return The gradient along the columns of a level.
+
+  \param level : Level of the pyramid, computed by the last call to build().
+*/
+const vpImage<double> &vpTemplateTrackerFrame::getGradientX(unsigned int level) const
+{
+  if (level < m_firstLevel || level >= m_dIx.size()) {
+    throw(vpException(vpException::badValue, "No gradient at level %d of the frame", level));
+  }
+  return m_dIx[level];
+}
+
+/*!
+  \return The gradient along the rows of a level.
+
+  \param level : Level of the pyramid, computed by the last call to build().
+*/
+const vpImage<double> &vpTemplateTrackerFrame::getGradientY(unsigned int level) const
+{
+  if (level < m_firstLevel || level >= m_dIy.size()) {
+    throw(vpException(vpException::badValue, "No gradient at level %d of the frame", level));
+  }
+  return m_dIy[level];
+}
+
+/*!
+  \return The image of a level of the pyramid.
+
+  \param level : Level of the pyramid, 0 for the image given to build().
+*/
+const vpImage<unsigned char> &vpTemplateTrackerFrame::getImage(unsigned int level) const
+{
+  if (level >= m_pyramid.size()) {
+    throw(vpException(vpException::badValue, "No level %d in the frame", level));
+  }
+  return m_pyramid[level];
+}
+
+/*!
+  \return The level of the pyramid stored at the address of \e I, or -1 if
+  \e I is not an image of the frame or if its products are not computed.
+
+  \param I : Image given by getImage().
+*/
+int vpTemplateTrackerFrame::getLevel(const vpImage<unsigned char> &I) const
+{
+  for (size_t i = m_firstLevel; i < m_pyramid.size(); i++) {
+    if (&m_pyramid[i] == &I) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+/*!
+  \return True if the products of the frame can be used by a tracker.
+
+  \param filterSize : Size of the Gaussian filters of the tracker.
+  \param blur : True if the tracker uses the blurred images.
+  \param nbLevels : Number of levels of the pyramid processed by the tracker.
+  \param firstLevel : Lowest level processed by the tracker.
+*/
+bool vpTemplateTrackerFrame::isCompatible(unsigned int filterSize, bool blur, unsigned int nbLevels,
+                                          unsigned int firstLevel) const
+{
+  return filterSize == m_filterSize && (m_blur || !blur) && nbLevels <= m_pyramid.size() && firstLevel >= m_firstLevel;
+}
+
+/*!
+  Enable or disable the computation of the blurred images by build().
+
+  \param blur : If true, the blurred images are computed.
+*/
+void vpTemplateTrackerFrame::setBlur(bool blur) { m_blur = blur; }
+
+/*!
+  Set the size of the Gaussian filters used by build().
+
+  \param filterSize : Size of the filters, odd.
+*/
+void vpTemplateTrackerFrame::setFilterSize(unsigned int filterSize)
+{
+  m_filterSize = filterSize;
+  m_fgG.resize((filterSize + 1) / 2);
+  vpImageFilter::getGaussianKernel(&m_fgG[0], filterSize);
+  m_fgdG.resize((filterSize + 1) / 2);
+  vpImageFilter::getGaussianDerivativeKernel(&m_fgdG[0], filterSize);
+}
@@ -38,20 +38,112 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
+
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/tt/vpTemplateTracker.h>
 #include <visp3/tt/vpTemplateTrackerBSpline.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Number of points of a block. The points are accumulated block by block in
+// a fixed order so that the result does not depend on the number of threads.
+const unsigned int blockSize = 256;
+
+// Make I a view of the image S, without copy
+void shareImage(const vpImage<double> &S, vpImage<double> &I)
+{
+  I.init(const_cast<double *>(S.bitmap), S.getHeight(), S.getWidth(), false);
+}
+
+/*
+  Bilinear interpolation of nbImages images at n points lying in
+  [0, height-1[ x [0, width-1[, with the same result as
+  vpImage<double>::getValue(). The weights of a point are shared by the
+  images and two points are processed at once with SSE2 when available.
+*/
+void interpolate(const vpImage<double> *const *images, unsigned int nbImages, const double *i, const double *j,
+                 unsigned int n, double *const *values)
+{
+  unsigned int k = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && n >= 2) {
+    const __m128d vone = _mm_set1_pd(1.0);
+    int iround[4], jround[4];
+    for (; k + 1 < n; k += 2) {
+      const __m128d vi = _mm_loadu_pd(i + k);
+      const __m128d vj = _mm_loadu_pd(j + k);
+      // The coordinates are positive, the truncation is the floor
+      const __m128i vir = _mm_cvttpd_epi32(vi);
+      const __m128i vjr = _mm_cvttpd_epi32(vj);
+      const __m128d rratio = _mm_sub_pd(vi, _mm_cvtepi32_pd(vir));
+      const __m128d cratio = _mm_sub_pd(vj, _mm_cvtepi32_pd(vjr));
+      const __m128d rfrac = _mm_sub_pd(vone, rratio);
+      const __m128d cfrac = _mm_sub_pd(vone, cratio);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(iround), vir);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(jround), vjr);
+
+      for (unsigned int im = 0; im < nbImages; im++) {
+        const vpImage<double> &I = *images[im];
+        const double *up0 = I[iround[0]] + jround[0], *down0 = I[iround[0] + 1] + jround[0];
+        const double *up1 = I[iround[1]] + jround[1], *down1 = I[iround[1] + 1] + jround[1];
+        const __m128d vup = _mm_set_pd(up1[0], up0[0]);
+        const __m128d vdown = _mm_set_pd(down1[0], down0[0]);
+        const __m128d vup_1 = _mm_set_pd(up1[1], up0[1]);
+        const __m128d vdown_1 = _mm_set_pd(down1[1], down0[1]);
+        const __m128d value =
+            _mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(vup, rfrac), _mm_mul_pd(vdown, rratio)), cfrac),
+                       _mm_mul_pd(_mm_add_pd(_mm_mul_pd(vup_1, rfrac), _mm_mul_pd(vdown_1, rratio)), cratio));
+        _mm_storeu_pd(values[im] + k, value);
+      }
+    }
+  }
+#endif
+
+  for (; k < n; k++) {
+    const unsigned int iround = static_cast<unsigned int>(i[k]);
+    const unsigned int jround = static_cast<unsigned int>(j[k]);
+    const double rratio = i[k] - static_cast<double>(iround);
+    const double cratio = j[k] - static_cast<double>(jround);
+    const double rfrac = 1.0 - rratio;
+    const double cfrac = 1.0 - cratio;
+    for (unsigned int im = 0; im < nbImages; im++) {
+      const vpImage<double> &I = *images[im];
+      const double *up = I[iround] + jround, *down = I[iround + 1] + jround;
+      values[im][k] = (up[0] * rfrac + down[0] * rratio) * cfrac + (up[1] * rfrac + down[1] * rratio) * cratio;
+    }
+  }
+}
+
+// Append the n values of an array of derivatives, or n zeros if not computed
+void appendArray(const double *values, unsigned int n, std::vector<double> &array)
+{
+  if (values != NULL) {
+    array.insert(array.end(), values, values + n);
+  } else {
+    array.insert(array.end(), n, 0.0);
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
   : nbLvlPyr(1), l0Pyr(0), pyrInitialised(false), evolRMS(0), x_pos(), y_pos(),
     evolRMS_eps(1e-4), ptTemplate(NULL), ptTemplatePyr(NULL), ptTemplateInit(false),
     templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL),
     ptTemplateSelectInit(false), templateSelectSize(0), ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL),
-    ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(),
-    Hdesire(), HdesirePyr(), HLM(), HLMdesire(), HLMdesirePyr(), HLMdesireInverse(), HLMdesireInversePyr(), G(),
+    ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), ptTemplateArrays(NULL), ptTemplateArraysPyr(NULL), blockSums(),
+    zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(), Hdesire(), HdesirePyr(), HLM(), HLMdesire(), HLMdesirePyr(), HLMdesireInverse(), HLMdesireInversePyr(), G(),
     gain(1.), thresholdGradient(40), costFunctionVerification(false), blur(true), useBrent(false), nbIterBrent(3),
     taillef(7), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0), lambdaDep(0.001),
     iterationMax(30), iterationGlobale(0), diverge(false), nbIteration(0), useCompositionnal(true), useInverse(false),
-    Warp(_warp), p(0), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_()
+    Warp(_warp), p(0), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), sharedFrame(NULL), zoneRef_()
 {
   nbParam = Warp->getNbParam();
   p.resize(nbParam);
@@ -211,6 +303,15 @@ void vpTemplateTracker::resetTracker()
       ptTemplateCompoPyr = NULL;
     }
 
+    if (ptTemplateArraysPyr) {
+      for (unsigned int i = 0; i < nbLvlPyr; i++) {
+        delete ptTemplateArraysPyr[i];
+      }
+      delete[] ptTemplateArraysPyr;
+      ptTemplateArraysPyr = NULL;
+    }
+    ptTemplateArrays = NULL;
+
     if (ptTemplateSuppPyr) {
       for (unsigned int i = 0; i < nbLvlPyr; i++) {
         if (ptTemplateSuppPyr[i]) {
@@ -284,6 +385,10 @@ void vpTemplateTracker::resetTracker()
       delete[] ptTemplateCompo;
       ptTemplateCompo = NULL;
     }
+    if (ptTemplateArrays) {
+      delete ptTemplateArrays;
+      ptTemplateArrays = NULL;
+    }
     if (ptTemplateSupp) {
       for (unsigned int point = 0; point < templateSize; point++) {
         delete[] ptTemplateSupp[point].Bt;
@@ -597,11 +702,13 @@ void vpTemplateTracker::initPyramidal(unsigned int nbLvl, unsigned int l0)
   ptTemplateSelectPyr = new bool *[nbLvlPyr];
   ptTemplateSuppPyr = new vpTemplateTrackerPointSuppMIInv *[nbLvlPyr];
   ptTemplateCompoPyr = new vpTemplateTrackerPointCompo *[nbLvlPyr];
+  ptTemplateArraysPyr = new vpTemplateTrackerPointArrays *[nbLvlPyr];
   for (unsigned int i = 0; i < nbLvlPyr; i++) {
     ptTemplatePyr[i] = NULL;
     ptTemplateSuppPyr[i] = NULL;
     ptTemplateSelectPyr[i] = NULL;
     ptTemplateCompoPyr[i] = NULL;
+    ptTemplateArraysPyr[i] = NULL;
   }
   templateSizePyr = new unsigned int[nbLvlPyr];
   HdesirePyr = new vpMatrix[nbLvlPyr];
@@ -740,17 +847,20 @@ void vpTemplateTracker::initHessienDesiredPyr(const vpImage<unsigned char> &I)
   // ptTemplateCompo=ptTemplateCompoPyr[0];
   ptTemplate = ptTemplatePyr[0];
   ptTemplateSelect = ptTemplateSelectPyr[0];
+  ptTemplateArrays = NULL;
   //  ptTemplateSupp=new vpTemplateTrackerPointSuppMIInv[templateSize];
   try {
     initHessienDesired(I);
     ptTemplateSuppPyr[0] = ptTemplateSupp;
     ptTemplateCompoPyr[0] = ptTemplateCompo;
+    ptTemplateArraysPyr[0] = ptTemplateArrays;
     HdesirePyr[0] = Hdesire;
     HLMdesirePyr[0] = HLMdesire;
     HLMdesireInversePyr[0] = HLMdesireInverse;
   } catch (const vpException &e) {
     ptTemplateSuppPyr[0] = ptTemplateSupp;
     ptTemplateCompoPyr[0] = ptTemplateCompo;
+    ptTemplateArraysPyr[0] = ptTemplateArrays;
     HdesirePyr[0] = Hdesire;
     HLMdesirePyr[0] = HLMdesire;
     HLMdesireInversePyr[0] = HLMdesireInverse;
@@ -766,18 +876,21 @@ void vpTemplateTracker::initHessienDesiredPyr(const vpImage<unsigned char> &I)
       templateSize = templateSizePyr[i];
       ptTemplate = ptTemplatePyr[i];
       ptTemplateSelect = ptTemplateSelectPyr[i];
+      ptTemplateArrays = NULL;
       // ptTemplateSupp=ptTemplateSuppPyr[i];
       // ptTemplateCompo=ptTemplateCompoPyr[i];
       try {
         initHessienDesired(Itemp);
         ptTemplateSuppPyr[i] = ptTemplateSupp;
         ptTemplateCompoPyr[i] = ptTemplateCompo;
+        ptTemplateArraysPyr[i] = ptTemplateArrays;
         HdesirePyr[i] = Hdesire;
         HLMdesirePyr[i] = HLMdesire;
         HLMdesireInversePyr[i] = HLMdesireInverse;
       } catch (const vpException &e) {
         ptTemplateSuppPyr[i] = ptTemplateSupp;
         ptTemplateCompoPyr[i] = ptTemplateCompo;
+        ptTemplateArraysPyr[i] = ptTemplateArrays;
         HdesirePyr[i] = Hdesire;
         HLMdesirePyr[i] = HLMdesire;
         HLMdesireInversePyr[i] = HLMdesireInverse;
@@ -800,13 +913,54 @@ void vpTemplateTracker::track(const vpImage<unsigned char> &I)
     trackNoPyr(I);
 }
 
+/*!
+   Track the template on a frame whose pyramid, blurred images and gradients
+   are already computed, for instance by vpTemplateTrackerBatch. The result is
+   the one of track() on the image of the frame.
+
+   The images of the frame are read without copy. If the frame was not built
+   with the Gaussian filter size, the blur and the pyramid levels of the
+   tracker (see vpTemplateTrackerFrame::isCompatible()), the products are
+   computed by the tracker as in track().
+
+   \param frame : Products of the image to process.
+ */
+void vpTemplateTracker::track(const vpTemplateTrackerFrame &frame)
+{
+  const unsigned int nbLevels = nbLvlPyr > 1 ? nbLvlPyr : 1;
+  const unsigned int firstLevel = nbLvlPyr > 1 ? l0Pyr : 0;
+  if (frame.isCompatible(taillef, blur, nbLevels, firstLevel)) {
+    sharedFrame = &frame;
+  }
+
+  try {
+    track(frame.getImage(0));
+  } catch (...) {
+    releaseSharedImages();
+    throw;
+  }
+  releaseSharedImages();
+}
+
 void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
 {
   // vpTRACE("trackPyr");
   vpImage<unsigned char> *pyr_I;
   //  pyr_I=new vpImage<unsigned char>[nbLvlPyr+1]; // Why +1 ?
   pyr_I = new vpImage<unsigned char>[nbLvlPyr]; // Why +1 ?
-  pyr_I[0] = I;
+  // Levels of the pyramid, read from the shared frame when I is its image
+  std::vector<const vpImage<unsigned char> *> levels(nbLvlPyr);
+  const bool useSharedFrame = (sharedFrame != NULL && &sharedFrame->getImage(0) == &I);
+  if (useSharedFrame) {
+    for (unsigned int i = 0; i < nbLvlPyr; i++) {
+      levels[i] = &sharedFrame->getImage(i);
+    }
+  } else {
+    pyr_I[0] = I;
+    for (unsigned int i = 0; i < nbLvlPyr; i++) {
+      levels[i] = &pyr_I[i];
+    }
+  }
 
   try {
     vpColVector ptemp(nbParam);
@@ -816,7 +970,9 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
 
       //    p_sauv[0]=p;
       for (unsigned int i = 1; i < nbLvlPyr; i++) {
-        vpImageFilter::getGaussPyramidal(pyr_I[i - 1], pyr_I[i]);
+        if (!useSharedFrame) {
+          vpImageFilter::getGaussPyramidal(pyr_I[i - 1], pyr_I[i]);
+        }
         // test getParamPyramidDown
         /*vpColVector vX_test(2);vX_test[0]=15.;vX_test[1]=30.;
         vpColVector vX_test2(2);
@@ -848,11 +1004,12 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
           ptTemplateSelect = ptTemplateSelectPyr[i];
           ptTemplateSupp = ptTemplateSuppPyr[i];
           ptTemplateCompo = ptTemplateCompoPyr[i];
+          ptTemplateArrays = ptTemplateArraysPyr[i];
           H = HdesirePyr[i];
           HLM = HLMdesirePyr[i];
           HLMdesireInverse = HLMdesireInversePyr[i];
           //        zoneTracked=&zoneTrackedPyr[i];
-          trackRobust(pyr_I[i]);
+          trackRobust(*levels[i]);
         }
         // std::cout<<"get p up"<<std::endl;
         //      ptemp=p_sauv[i-1];
@@ -916,6 +1073,65 @@ void vpTemplateTracker::trackRobust(const vpImage<unsigned char> &I)
     trackNoPyr(I);
 }
 
+/*!
+  Compute the blurred image #BI of \e I. When \e I is an image of the frame
+  given to track(const vpTemplateTrackerFrame &), #BI is a view of the
+  blurred image of the frame.
+
+  \param I : Image to process.
+ */
+void vpTemplateTracker::getGaussianBluredImage(const vpImage<unsigned char> &I)
+{
+  const int level = (sharedFrame != NULL) ? sharedFrame->getLevel(I) : -1;
+  if (level >= 0) {
+    shareImage(sharedFrame->getBlurredImage(static_cast<unsigned int>(level)), BI);
+  } else {
+    if (sharedFrame != NULL) {
+      // BI may be a view of the frame, that must not be overwritten
+      BI.destroy();
+    }
+    vpImageFilter::filter(I, BI, fgG, taillef);
+  }
+}
+
+/*!
+  Compute the gradients #dIx and #dIy of \e I. When \e I is an image of the
+  frame given to track(const vpTemplateTrackerFrame &), #dIx and #dIy are
+  views of the gradients of the frame.
+
+  \param I : Image to process.
+ */
+void vpTemplateTracker::getGaussianGradients(const vpImage<unsigned char> &I)
+{
+  const int level = (sharedFrame != NULL) ? sharedFrame->getLevel(I) : -1;
+  if (level >= 0) {
+    shareImage(sharedFrame->getGradientX(static_cast<unsigned int>(level)), dIx);
+    shareImage(sharedFrame->getGradientY(static_cast<unsigned int>(level)), dIy);
+  } else {
+    if (sharedFrame != NULL) {
+      // dIx and dIy may be views of the frame, that must not be overwritten
+      dIx.destroy();
+      dIy.destroy();
+    }
+    vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
+    vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+  }
+}
+
+/*!
+  Detach #BI, #dIx and #dIy from the frame given to
+  track(const vpTemplateTrackerFrame &).
+ */
+void vpTemplateTracker::releaseSharedImages()
+{
+  if (sharedFrame != NULL) {
+    BI.destroy();
+    dIx.destroy();
+    dIy.destroy();
+    sharedFrame = NULL;
+  }
+}
+
 /*!
   Compute residual. Before using this function you need to call initPosEvalRMS() once.
   \param[in] param : Warp function parameters.
@@ -977,3 +1193,219 @@ void vpTemplateTracker::initPosEvalRMS(const vpColVector &param)
     }
   }
 }
+
+/*!
+  Copy the template points of the current pyramid level in
+  #ptTemplateArrays, as a structure of arrays. Has to be called by
+  initHessienDesired() once the derivatives of the points are computed.
+
+  \param dWSize : Number of values of ptTemplate[i].dW to copy, 0 if unused.
+  \param HiGSize : Number of values of ptTemplate[i].HiG to copy, 0 if unused.
+  \param dWCompoSize : Number of values of ptTemplateCompo[i].dW to copy, 0 if
+  unused.
+
+  The derivatives of the points that were not computed, for instance for the
+  points that are not selected, are set to 0.
+*/
+void vpTemplateTracker::initTemplateArrays(unsigned int dWSize, unsigned int HiGSize, unsigned int dWCompoSize)
+{
+  if (ptTemplateArrays == NULL) {
+    ptTemplateArrays = new vpTemplateTrackerPointArrays;
+  }
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  pts = vpTemplateTrackerPointArrays();
+  pts.dWSize = dWSize;
+  pts.HiGSize = HiGSize;
+  pts.dWCompoSize = dWCompoSize;
+
+  pts.x.reserve(templateSize);
+  pts.y.reserve(templateSize);
+  pts.dx.reserve(templateSize);
+  pts.dy.reserve(templateSize);
+  pts.val.reserve(templateSize);
+  pts.dW.reserve(templateSize * dWSize);
+  pts.HiG.reserve(templateSize * HiGSize);
+  pts.dWCompo.reserve(templateSize * dWCompoSize);
+  for (unsigned int point = 0; point < templateSize; point++) {
+    const vpTemplateTrackerPoint &pt = ptTemplate[point];
+    pts.x.push_back(pt.x);
+    pts.y.push_back(pt.y);
+    pts.dx.push_back(pt.dx);
+    pts.dy.push_back(pt.dy);
+    pts.val.push_back(pt.val);
+    appendArray(pt.dW, dWSize, pts.dW);
+    appendArray(pt.HiG, HiGSize, pts.HiG);
+    appendArray(dWCompoSize > 0 ? ptTemplateCompo[point].dW : NULL, dWCompoSize, pts.dWCompo);
+  }
+}
+
+/*!
+  Warp the points of #ptTemplateArrays with the parameters \e tp, the warped
+  coordinates are stored in ptTemplateArrays->x2 and ptTemplateArrays->y2.
+*/
+void vpTemplateTracker::warpTemplateArrays(const vpColVector &tp)
+{
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  const unsigned int nbPoints = pts.size();
+  pts.x2.resize(nbPoints);
+  pts.y2.resize(nbPoints);
+
+  Warp->computeCoeff(tp);
+  if (nbPoints > 0) {
+    Warp->warpPoints(&pts.x[0], &pts.y[0], nbPoints, tp, &pts.x2[0], &pts.y2[0]);
+  }
+}
+
+/*!
+  Interpolate the image at the warped points of #ptTemplateArrays, see
+  warpTemplateArrays(). The blurred image #BI is used instead of \e I when
+  the blur is enabled.
+
+  \param I : Current image.
+  \param gradient : If true, the gradients #dIx and #dIy are interpolated too.
+  \param strict : If true, the points on the first row or column are
+  considered outside of the image.
+
+  \return The number of warped points inside the image. The points are
+  flagged in ptTemplateArrays->inImage, the interpolated values are stored in
+  ptTemplateArrays->IW, dIWx and dIWy.
+*/
+unsigned int vpTemplateTracker::sampleTemplateArrays(const vpImage<unsigned char> &I, bool gradient, bool strict)
+{
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  const unsigned int nbPoints = pts.size();
+  pts.inImage.resize(nbPoints);
+  pts.IW.resize(nbPoints);
+  if (gradient) {
+    pts.dIWx.resize(nbPoints);
+    pts.dIWy.resize(nbPoints);
+  }
+
+  const double height = I.getHeight() - 1;
+  const double width = I.getWidth() - 1;
+  const unsigned int nbBlocks = (nbPoints + blockSize - 1) / blockSize;
+  std::vector<unsigned int> nbInImage(nbBlocks, 0);
+
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbBlocks > 1)
+#endif
+  for (int block = 0; block < static_cast<int>(nbBlocks); block++) {
+    unsigned int begin, end;
+    getBlockRange(static_cast<unsigned int>(block), begin, end);
+
+    unsigned int index[blockSize];
+    double i2[blockSize], j2[blockSize];
+    double IW[blockSize], dIWx[blockSize], dIWy[blockSize];
+    unsigned int n = 0;
+    for (unsigned int point = begin; point < end; point++) {
+      const double i = pts.y2[point];
+      const double j = pts.x2[point];
+      const bool inside = strict ? ((j < width) && (i < height) && (i > 0) && (j > 0))
+                                 : ((i >= 0) && (j >= 0) && (i < height) && (j < width));
+      pts.inImage[point] = inside ? 1 : 0;
+      if (inside) {
+        index[n] = point;
+        i2[n] = i;
+        j2[n] = j;
+        n++;
+      }
+    }
+
+    if (blur) {
+      const vpImage<double> *images[1] = {&BI};
+      double *values[1] = {IW};
+      interpolate(images, 1, i2, j2, n, values);
+    } else {
+      for (unsigned int k = 0; k < n; k++) {
+        IW[k] = I.getValue(i2[k], j2[k]);
+      }
+    }
+    for (unsigned int k = 0; k < n; k++) {
+      pts.IW[index[k]] = IW[k];
+    }
+
+    if (gradient) {
+      const vpImage<double> *images[2] = {&dIx, &dIy};
+      double *values[2] = {dIWx, dIWy};
+      interpolate(images, 2, i2, j2, n, values);
+      for (unsigned int k = 0; k < n; k++) {
+        pts.dIWx[index[k]] = dIWx[k];
+        pts.dIWy[index[k]] = dIWy[k];
+      }
+    }
+    nbInImage[static_cast<unsigned int>(block)] = n;
+  }
+
+  unsigned int Nbpoint = 0;
+  for (unsigned int block = 0; block < nbBlocks; block++) {
+    Nbpoint += nbInImage[block];
+  }
+  return Nbpoint;
+}
+
+/*!
+  Get the points of a block of #ptTemplateArrays, see initBlockSums().
+
+  \param block : Index of the block.
+  \param begin : Index of the first point of the block.
+  \param end : Index following the last point of the block.
+*/
+void vpTemplateTracker::getBlockRange(unsigned int block, unsigned int &begin, unsigned int &end) const
+{
+  begin = block * blockSize;
+  end = (std::min)(begin + blockSize, ptTemplateArrays->size());
+}
+
+/*!
+  Split the points of #ptTemplateArrays in blocks and reset the partial sums
+  of the blocks. The blocks can be processed concurrently, each one
+  accumulating \e stride values in its own part of #blockSums. Summing the
+  blocks in their order with reduceBlockSums() gives a result that does not
+  depend on the number of threads.
+
+  \param stride : Number of values accumulated by a block.
+
+  \return The number of blocks.
+*/
+unsigned int vpTemplateTracker::initBlockSums(unsigned int stride)
+{
+  const unsigned int nbBlocks = (ptTemplateArrays->size() + blockSize - 1) / blockSize;
+  blockSums.assign(static_cast<size_t>(nbBlocks) * stride, 0.0);
+  return nbBlocks;
+}
+
+/*!
+  Sum the partial sums of the blocks, in the order of the blocks.
+
+  \param nbBlocks : Number of blocks, as returned by initBlockSums().
+  \param stride : Number of values accumulated by a block.
+  \param sums : The \e stride sums.
+*/
+void vpTemplateTracker::reduceBlockSums(unsigned int nbBlocks, unsigned int stride, double *sums) const
+{
+  std::fill(sums, sums + stride, 0.0);
+  for (unsigned int block = 0; block < nbBlocks; block++) {
+    const double *blockSum = &blockSums[static_cast<size_t>(block) * stride];
+    for (unsigned int k = 0; k < stride; k++) {
+      sums[k] += blockSum[k];
+    }
+  }
+}
+
+/*!
+  Fill the symmetric matrix \e H from its upper triangle.
+
+  \param Hupper : \e n x \e n matrix stored row by row, only the upper
+  triangle is read.
+  \param n : Size of the matrix.
+  \param H : Resulting symmetric matrix.
+*/
+void vpTemplateTracker::copyUpperToLower(const double *Hupper, unsigned int n, vpMatrix &H)
+{
+  H.resize(n, n, false, false);
+  for (unsigned int it = 0; it < n; it++) {
+    for (unsigned int jt = it; jt < n; jt++) {
+      H[it][jt] = H[jt][it] = Hupper[it * n + jt];
+    }
+  }
+}
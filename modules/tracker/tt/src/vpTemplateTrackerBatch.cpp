@@ -0,0 +1,328 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Tracking of several templates in the same frame with shared image products.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/tt/vpTemplateTrackerBatch.h>
+
+#if defined(VISP_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Levels of the pyramid processed by a tracker
+void getLevels(const vpTemplateTracker &tracker, unsigned int &nbLevels, unsigned int &firstLevel)
+{
+  if (tracker.getNbPyramidLevels() > 1) {
+    nbLevels = tracker.getNbPyramidLevels();
+    firstLevel = tracker.getPyramidLevelToStop();
+  } else {
+    nbLevels = 1;
+    firstLevel = 0;
+  }
+}
+
+// Predicate of std::stable_partition(), true for the skipped templates
+class vpIsSkipped
+{
+public:
+  explicit vpIsSkipped(const std::vector<vpTemplateTrackerBatch::vpTemplateStatus> &status) : m_status(status) {}
+  bool operator()(unsigned int index) const { return m_status[index] == vpTemplateTrackerBatch::SKIPPED; }
+
+private:
+  const std::vector<vpTemplateTrackerBatch::vpTemplateStatus> &m_status;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The batch is empty, the templates are tracked one
+  after the other with shared image products and without time budget.
+*/
+vpTemplateTrackerBatch::vpTemplateTrackerBatch()
+  : m_trackers(), m_enabled(), m_status(), m_trackingTimes(), m_order(), m_frames(), m_timeBudget(0),
+    m_useParallelTracking(false), m_nbParallelThreads(0), m_useSharedFrame(true), m_preprocessingTime(0),
+    m_totalTime(0)
+{
+}
+
+/*!
+  Destructor. The trackers are not destroyed.
+*/
+vpTemplateTrackerBatch::~vpTemplateTrackerBatch() {}
+
+/*!
+  Add a tracker to the batch. The tracker is not copied and must stay alive
+  while it is in the batch.
+
+  \param tracker : Tracker of a template, initialized or not. It must be
+  initialized before the next call to track().
+
+  \return The index of the tracker in the batch.
+*/
+unsigned int vpTemplateTrackerBatch::addTracker(vpTemplateTracker &tracker)
+{
+  const unsigned int index = getNbTrackers();
+  m_trackers.push_back(&tracker);
+  m_enabled.push_back(true);
+  m_status.push_back(NOT_TRACKED);
+  m_trackingTimes.push_back(0);
+  m_order.push_back(index);
+  return index;
+}
+
+/*!
+  Compute the image products of the frame for each Gaussian filter size used
+  by the enabled trackers, with the levels of the pyramid they process.
+*/
+void vpTemplateTrackerBatch::buildFrames(const vpImage<unsigned char> &I)
+{
+  std::map<unsigned int, vpTemplateTrackerFrame> frames;
+  std::map<unsigned int, unsigned int> nbLevels, firstLevels;
+  for (size_t i = 0; i < m_trackers.size(); i++) {
+    if (!m_enabled[i]) {
+      continue;
+    }
+    const vpTemplateTracker &tracker = *m_trackers[i];
+    const unsigned int filterSize = tracker.getGaussianFilterSize();
+    unsigned int nb, first;
+    getLevels(tracker, nb, first);
+
+    if (frames.find(filterSize) == frames.end()) {
+      // Reuse the memory of the previous frame
+      std::map<unsigned int, vpTemplateTrackerFrame>::iterator it = m_frames.find(filterSize);
+      if (it != m_frames.end()) {
+        std::swap(frames[filterSize], it->second);
+      } else {
+        frames[filterSize].setFilterSize(filterSize);
+      }
+      frames[filterSize].setBlur(tracker.getBlur());
+      nbLevels[filterSize] = nb;
+      firstLevels[filterSize] = first;
+    } else {
+      vpTemplateTrackerFrame &frame = frames[filterSize];
+      frame.setBlur(frame.getBlur() || tracker.getBlur());
+      nbLevels[filterSize] = std::max(nbLevels[filterSize], nb);
+      firstLevels[filterSize] = std::min(firstLevels[filterSize], first);
+    }
+  }
+
+  for (std::map<unsigned int, vpTemplateTrackerFrame>::iterator it = frames.begin(); it != frames.end(); ++it) {
+    it->second.build(I, nbLevels[it->first], firstLevels[it->first]);
+  }
+  m_frames.swap(frames);
+}
+
+/*!
+  Remove all the trackers from the batch.
+*/
+void vpTemplateTrackerBatch::clear()
+{
+  m_trackers.clear();
+  m_enabled.clear();
+  m_status.clear();
+  m_trackingTimes.clear();
+  m_order.clear();
+  m_frames.clear();
+}
+
+/*!
+  \return The number of templates with a given outcome at the last frame.
+*/
+unsigned int vpTemplateTrackerBatch::getNbStatus(vpTemplateStatus status) const
+{
+  return static_cast<unsigned int>(std::count(m_status.begin(), m_status.end(), status));
+}
+
+/*!
+  \return The outcome of the tracking of a template at the last frame.
+
+  \param index : Index of the tracker, as returned by addTracker().
+*/
+vpTemplateTrackerBatch::vpTemplateStatus vpTemplateTrackerBatch::getStatus(unsigned int index) const
+{
+  if (index >= m_status.size()) {
+    throw(vpException(vpException::badValue, "No tracker %d in the batch", index));
+  }
+  return m_status[index];
+}
+
+/*!
+  \return The tracker of a template.
+
+  \param index : Index of the tracker, as returned by addTracker().
+*/
+vpTemplateTracker &vpTemplateTrackerBatch::getTracker(unsigned int index)
+{
+  if (index >= m_trackers.size()) {
+    throw(vpException(vpException::badValue, "No tracker %d in the batch", index));
+  }
+  return *m_trackers[index];
+}
+
+/*!
+  \return The time in milliseconds spent to track a template at the last
+  frame, 0 if it was not tracked.
+
+  \param index : Index of the tracker, as returned by addTracker().
+*/
+double vpTemplateTrackerBatch::getTrackingTime(unsigned int index) const
+{
+  if (index >= m_trackingTimes.size()) {
+    throw(vpException(vpException::badValue, "No tracker %d in the batch", index));
+  }
+  return m_trackingTimes[index];
+}
+
+/*!
+  \return True if a template is tracked by track().
+
+  \param index : Index of the tracker, as returned by addTracker().
+*/
+bool vpTemplateTrackerBatch::isEnabled(unsigned int index) const
+{
+  if (index >= m_enabled.size()) {
+    throw(vpException(vpException::badValue, "No tracker %d in the batch", index));
+  }
+  return m_enabled[index];
+}
+
+/*!
+  Enable or disable the tracking of a template, for instance while it is
+  reinitialized. A disabled template keeps its parameters and its status is
+  NOT_TRACKED.
+
+  \param index : Index of the tracker, as returned by addTracker().
+  \param enabled : If true, the template is tracked by track().
+*/
+void vpTemplateTrackerBatch::setEnabled(unsigned int index, bool enabled)
+{
+  if (index >= m_enabled.size()) {
+    throw(vpException(vpException::badValue, "No tracker %d in the batch", index));
+  }
+  m_enabled[index] = enabled;
+}
+
+/*!
+  Track all the enabled templates on an image.
+
+  The image products are computed once (see setUseSharedFrame()), then the
+  templates are tracked, concurrently if setUseParallelTracking() is
+  enabled. The exceptions thrown by the trackers are caught, the outcome of
+  each template is given by getStatus().
+
+  \param I : Image to process.
+*/
+void vpTemplateTrackerBatch::track(const vpImage<unsigned char> &I)
+{
+  const double startTime = vpTime::measureTimeMs();
+
+  if (m_useSharedFrame) {
+    buildFrames(I);
+  } else {
+    m_frames.clear();
+  }
+  m_preprocessingTime = vpTime::measureTimeMs() - startTime;
+
+#if defined(VISP_HAVE_OPENMP)
+  if (m_useParallelTracking && m_trackers.size() > 1) {
+    int nb_threads = m_nbParallelThreads > 0 ? static_cast<int>(m_nbParallelThreads) : omp_get_max_threads();
+    int nb_templates = static_cast<int>(m_order.size());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nb_threads)
+    for (int k = 0; k < nb_templates; k++) {
+      trackTemplate(m_order[static_cast<size_t>(k)], I, startTime);
+    }
+  } else
+#endif
+  {
+    for (size_t k = 0; k < m_order.size(); k++) {
+      trackTemplate(m_order[k], I, startTime);
+    }
+  }
+
+  // The skipped templates are started first at the next frame
+  std::stable_partition(m_order.begin(), m_order.end(), vpIsSkipped(m_status));
+
+  m_totalTime = vpTime::measureTimeMs() - startTime;
+}
+
+/*!
+  Track a template on the image or on its shared products, and update its
+  status and its tracking time.
+
+  \param index : Index of the tracker.
+  \param I : Image to process.
+  \param startTime : Time of the beginning of the frame, for the time budget.
+*/
+void vpTemplateTrackerBatch::trackTemplate(unsigned int index, const vpImage<unsigned char> &I, double startTime)
+{
+  m_trackingTimes[index] = 0;
+  if (!m_enabled[index]) {
+    m_status[index] = NOT_TRACKED;
+    return;
+  }
+
+  const double t = vpTime::measureTimeMs();
+  if (m_timeBudget > 0 && t - startTime >= m_timeBudget) {
+    m_status[index] = SKIPPED;
+    return;
+  }
+
+  vpTemplateTracker &tracker = *m_trackers[index];
+  try {
+    std::map<unsigned int, vpTemplateTrackerFrame>::const_iterator it =
+        m_frames.find(tracker.getGaussianFilterSize());
+    if (it != m_frames.end()) {
+      tracker.track(it->second);
+    } else {
+      tracker.track(I);
+    }
+
+    if (tracker.getDiverge()) {
+      m_status[index] = LOST;
+    } else if (tracker.getNbIteration() < tracker.getIterationMax()) {
+      m_status[index] = CONVERGED;
+    } else {
+      m_status[index] = MAX_ITERATIONS;
+    }
+  } catch (const vpException &) {
+    m_status[index] = LOST;
+  }
+  m_trackingTimes[index] = vpTime::measureTimeMs() - t;
+}
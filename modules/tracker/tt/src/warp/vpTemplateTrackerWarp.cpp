@@ -37,8 +37,16 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <algorithm>
+
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/tt/vpTemplateTrackerWarp.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 void vpTemplateTrackerWarp::warpTriangle(const vpTemplateTrackerTriangle &in, const vpColVector &p,
                                          vpTemplateTrackerTriangle &out)
 {
@@ -96,18 +104,107 @@ void vpTemplateTrackerWarp::warp(const double *ut0, const double *vt0, int nb_pt
                                  double *v)
 {
   computeCoeff(p);
+  if (nb_pt > 0) {
+    warpPoints(ut0, vt0, static_cast<unsigned int>(nb_pt), p, u, v);
+  }
+}
+
+void vpTemplateTrackerWarp::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                       const vpColVector &ParamM, double *u2, double *v2)
+{
   vpColVector X1(2), X2(2);
-  for (int i = 0; i < nb_pt; i++) {
-    X1[0] = ut0[i];
-    X1[1] = vt0[i];
-    computeDenom(X1, p);
-    warpX(X1, X2, p);
-    u[i] = X2[0];
-    v[i] = X2[1];
-    // std::cout<<"warp "<<X2[0]<<","<<X2[1]<<std::endl;
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    X1[0] = u[i];
+    X1[1] = v[i];
+    computeDenom(X1, ParamM);
+    warpX(X1, X2, ParamM);
+    u2[i] = X2[0];
+    v2[i] = X2[1];
   }
 }
 
+void vpTemplateTrackerWarp::dWarpPoints(const double *u, const double *v, const double *u2, const double *v2,
+                                        unsigned int nbPoints, const vpColVector &ParamM, double *dW_)
+{
+  vpColVector X1(2), X2(2);
+  vpMatrix dWpt(2, nbParam);
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    X1[0] = u[i];
+    X1[1] = v[i];
+    X2[0] = u2[i];
+    X2[1] = v2[i];
+    computeDenom(X1, ParamM);
+    dWarp(X1, X2, ParamM, dWpt);
+    std::copy(dWpt.data, dWpt.data + 2 * nbParam, dW_ + 2 * nbParam * i);
+  }
+}
+
+void vpTemplateTrackerWarp::dWarpCompoPoints(const double *u, const double *v, const double *u2, const double *v2,
+                                             unsigned int nbPoints, const vpColVector &ParamM, const double *dwdp0,
+                                             double *dW_)
+{
+  vpColVector X1(2), X2(2);
+  vpMatrix dWpt(2, nbParam);
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    X1[0] = u[i];
+    X1[1] = v[i];
+    X2[0] = u2[i];
+    X2[1] = v2[i];
+    computeDenom(X1, ParamM);
+    dWarpCompo(X1, X2, ParamM, dwdp0 + 2 * nbParam * i, dWpt);
+    std::copy(dWpt.data, dWpt.data + 2 * nbParam, dW_ + 2 * nbParam * i);
+  }
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Compositionnal derivative of a warping function whose derivative with
+  respect to the point does not depend on the point:
+  dW = A * dwdp0 with A the 2x2 matrix stored row by row.
+*/
+void vpTemplateTrackerWarp::dWarpCompoPointsLinear(const double *A, unsigned int nbPoints, unsigned int nbParam_,
+                                                   const double *dwdp0, double *dW_)
+{
+  const unsigned int size = 2 * nbParam_ * nbPoints;
+  for (unsigned int k = 0; k < size; k += 2 * nbParam_) {
+    const double *dwdp0_x = dwdp0 + k;
+    const double *dwdp0_y = dwdp0_x + nbParam_;
+    double *dW_x = dW_ + k;
+    double *dW_y = dW_x + nbParam_;
+    for (unsigned int i = 0; i < nbParam_; i++) {
+      dW_x[i] = A[0] * dwdp0_x[i] + A[1] * dwdp0_y[i];
+      dW_y[i] = A[2] * dwdp0_x[i] + A[3] * dwdp0_y[i];
+    }
+  }
+}
+
+/*
+  Warp the points with the affine transformation A stored row by row as a 2x3
+  matrix: u2 = A[0] u + A[1] v + A[2], v2 = A[3] u + A[4] v + A[5].
+*/
+void vpTemplateTrackerWarp::warpPointsAffine(const double *u, const double *v, unsigned int nbPoints, const double *A,
+                                             double *u2, double *v2)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && nbPoints >= 2) {
+    const __m128d a0 = _mm_set1_pd(A[0]), a1 = _mm_set1_pd(A[1]), a2 = _mm_set1_pd(A[2]);
+    const __m128d a3 = _mm_set1_pd(A[3]), a4 = _mm_set1_pd(A[4]), a5 = _mm_set1_pd(A[5]);
+    for (; i + 1 < nbPoints; i += 2) {
+      const __m128d vu = _mm_loadu_pd(u + i);
+      const __m128d vv = _mm_loadu_pd(v + i);
+      _mm_storeu_pd(u2 + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(a0, vu), _mm_mul_pd(a1, vv)), a2));
+      _mm_storeu_pd(v2 + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(a3, vu), _mm_mul_pd(a4, vv)), a5));
+    }
+  }
+#endif
+  for (; i < nbPoints; i++) {
+    u2[i] = A[0] * u[i] + A[1] * v[i] + A[2];
+    v2[i] = A[3] * u[i] + A[4] * v[i] + A[5];
+  }
+}
+#endif // #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 void vpTemplateTrackerWarp::findWarp(const double *ut0, const double *vt0, const double *u, const double *v, int nb_pt,
                                      vpColVector &p)
@@ -187,3 +187,41 @@ void vpTemplateTrackerWarpAffine::pRondp(const vpColVector &p1, const vpColVecto
   pres[4] = TransRes[0];
   pres[5] = TransRes[1];
 }
+
+void vpTemplateTrackerWarpAffine::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                             const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double A[6] = {1.0 + ParamM[0], ParamM[2], ParamM[4], ParamM[1], 1.0 + ParamM[3], ParamM[5]};
+  warpPointsAffine(u, v, nbPoints, A, u2, v2);
+}
+
+void vpTemplateTrackerWarpAffine::dWarpPoints(const double *u, const double *v, const double * /*u2*/,
+                                              const double * /*v2*/, unsigned int nbPoints,
+                                              const vpColVector & /*ParamM*/, double *dW_)
+{
+  for (unsigned int k = 0; k < nbPoints; k++, dW_ += 2 * nbParam) {
+    const double j = u[k];
+    const double i = v[k];
+    dW_[0] = j;
+    dW_[1] = 0;
+    dW_[2] = i;
+    dW_[3] = 0;
+    dW_[4] = 1;
+    dW_[5] = 0;
+
+    dW_[6] = 0;
+    dW_[7] = j;
+    dW_[8] = 0;
+    dW_[9] = i;
+    dW_[10] = 0;
+    dW_[11] = 1;
+  }
+}
+
+void vpTemplateTrackerWarpAffine::dWarpCompoPoints(const double * /*u*/, const double * /*v*/, const double * /*u2*/,
+                                                   const double * /*v2*/, unsigned int nbPoints,
+                                                   const vpColVector &ParamM, const double *dwdp0, double *dW_)
+{
+  const double A[4] = {1. + ParamM[0], ParamM[2], ParamM[1], 1. + ParamM[3]};
+  dWarpCompoPointsLinear(A, nbPoints, nbParam, dwdp0, dW_);
+}
@@ -37,9 +37,15 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/tt/vpTemplateTrackerWarpHomography.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 vpTemplateTrackerWarpHomography::vpTemplateTrackerWarpHomography()
 {
   nbParam = 8;
@@ -218,3 +224,89 @@ void vpTemplateTrackerWarpHomography::pRondp(const vpColVector &p1, const vpColV
   vpHomography H = H1 * H2;
   getParam(H, pres);
 }
+
+void vpTemplateTrackerWarpHomography::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                                 const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double h00 = 1. + ParamM[0], h01 = ParamM[3], h02 = ParamM[6];
+  const double h10 = ParamM[1], h11 = 1. + ParamM[4], h12 = ParamM[7];
+  const double h20 = ParamM[2], h21 = ParamM[5];
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && nbPoints >= 2) {
+    const __m128d vh00 = _mm_set1_pd(h00), vh01 = _mm_set1_pd(h01), vh02 = _mm_set1_pd(h02);
+    const __m128d vh10 = _mm_set1_pd(h10), vh11 = _mm_set1_pd(h11), vh12 = _mm_set1_pd(h12);
+    const __m128d vh20 = _mm_set1_pd(h20), vh21 = _mm_set1_pd(h21);
+    const __m128d vone = _mm_set1_pd(1.);
+    const __m128d vsignMask = _mm_set1_pd(-0.0);
+    const __m128d veps = _mm_set1_pd(std::numeric_limits<double>::epsilon());
+    for (; i + 1 < nbPoints; i += 2) {
+      const __m128d vu = _mm_loadu_pd(u + i);
+      const __m128d vv = _mm_loadu_pd(v + i);
+      const __m128d value = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vh20, vu), _mm_mul_pd(vh21, vv)), vone);
+      if (_mm_movemask_pd(_mm_cmple_pd(_mm_andnot_pd(vsignMask, value), veps)) != 0) {
+        throw(vpTrackingException(vpTrackingException::fatalError,
+                                  "Division by zero in vpTemplateTrackerWarpHomography::warpPoints()"));
+      }
+      const __m128d vdenom = _mm_div_pd(vone, value);
+      _mm_storeu_pd(u2 + i,
+                    _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(vh00, vu), _mm_mul_pd(vh01, vv)), vh02), vdenom));
+      _mm_storeu_pd(v2 + i,
+                    _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(vh10, vu), _mm_mul_pd(vh11, vv)), vh12), vdenom));
+    }
+  }
+#endif
+
+  for (; i < nbPoints; i++) {
+    const double value = h20 * u[i] + h21 * v[i] + 1.;
+    if (std::fabs(value) <= std::numeric_limits<double>::epsilon()) {
+      throw(vpTrackingException(vpTrackingException::fatalError,
+                                "Division by zero in vpTemplateTrackerWarpHomography::warpPoints()"));
+    }
+    const double denom_ = 1. / value;
+    u2[i] = (h00 * u[i] + h01 * v[i] + h02) * denom_;
+    v2[i] = (h10 * u[i] + h11 * v[i] + h12) * denom_;
+  }
+}
+
+void vpTemplateTrackerWarpHomography::dWarpPoints(const double *u, const double *v, const double *u2,
+                                                  const double *v2, unsigned int nbPoints, const vpColVector &ParamM,
+                                                  double *dW_)
+{
+  for (unsigned int k = 0; k < nbPoints; k++, dW_ += 16) {
+    const double j = u[k];
+    const double i = v[k];
+    const double denom_ = 1. / (ParamM[2] * j + ParamM[5] * i + 1.);
+    dW_[0] = j * denom_;
+    dW_[1] = 0;
+    dW_[2] = -j * u2[k] * denom_;
+    dW_[3] = i * denom_;
+    dW_[4] = 0;
+    dW_[5] = -i * u2[k] * denom_;
+    dW_[6] = denom_;
+    dW_[7] = 0;
+
+    dW_[8] = 0;
+    dW_[9] = j * denom_;
+    dW_[10] = -j * v2[k] * denom_;
+    dW_[11] = 0;
+    dW_[12] = i * denom_;
+    dW_[13] = -i * v2[k] * denom_;
+    dW_[14] = 0;
+    dW_[15] = denom_;
+  }
+}
+
+void vpTemplateTrackerWarpHomography::dWarpCompoPoints(const double *u, const double *v, const double *u2,
+                                                       const double *v2, unsigned int nbPoints,
+                                                       const vpColVector &ParamM, const double *dwdp0, double *dW_)
+{
+  for (unsigned int k = 0; k < nbPoints; k++) {
+    const double denom_ = 1. / (ParamM[2] * u[k] + ParamM[5] * v[k] + 1.);
+    // Derivative of the warp with respect to the point, row by row
+    const double A[4] = {((1. + ParamM[0]) - u2[k] * ParamM[2]) * denom_, (ParamM[3] - u2[k] * ParamM[5]) * denom_,
+                         (ParamM[1] - v2[k] * ParamM[2]) * denom_, ((1. + ParamM[4]) - v2[k] * ParamM[5]) * denom_};
+    dWarpCompoPointsLinear(A, 1, nbParam, dwdp0 + 2 * nbParam * k, dW_ + 2 * nbParam * k);
+  }
+}
@@ -37,8 +37,14 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/tt/vpTemplateTrackerWarpHomographySL3.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 // findWarp special a SL3 car methode additionnelle ne marche pas (la derivee
 // n est calculable qu en p=0)
 // => resout le probleme de maniere compositionnelle
@@ -409,3 +415,55 @@ void vpTemplateTrackerWarpHomographySL3::pRondp(const vpColVector &p1, const vpC
   // vrai que si commutatif ...
   pres = p1 + p2;
 }
+
+void vpTemplateTrackerWarpHomographySL3::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                                    const vpColVector & /*ParamM*/, double *u2, double *v2)
+{
+  const double g00 = G[0][0], g01 = G[0][1], g02 = G[0][2];
+  const double g10 = G[1][0], g11 = G[1][1], g12 = G[1][2];
+  const double g20 = G[2][0], g21 = G[2][1], g22 = G[2][2];
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && nbPoints >= 2) {
+    const __m128d vg00 = _mm_set1_pd(g00), vg01 = _mm_set1_pd(g01), vg02 = _mm_set1_pd(g02);
+    const __m128d vg10 = _mm_set1_pd(g10), vg11 = _mm_set1_pd(g11), vg12 = _mm_set1_pd(g12);
+    const __m128d vg20 = _mm_set1_pd(g20), vg21 = _mm_set1_pd(g21), vg22 = _mm_set1_pd(g22);
+    for (; i + 1 < nbPoints; i += 2) {
+      const __m128d vu = _mm_loadu_pd(u + i);
+      const __m128d vv = _mm_loadu_pd(v + i);
+      const __m128d vdenom = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vu, vg20), _mm_mul_pd(vv, vg21)), vg22);
+      _mm_storeu_pd(u2 + i,
+                    _mm_div_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(vu, vg00), _mm_mul_pd(vv, vg01)), vg02), vdenom));
+      _mm_storeu_pd(v2 + i,
+                    _mm_div_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(vu, vg10), _mm_mul_pd(vv, vg11)), vg12), vdenom));
+    }
+  }
+#endif
+
+  for (; i < nbPoints; i++) {
+    const double denom_ = u[i] * g20 + v[i] * g21 + g22;
+    u2[i] = (u[i] * g00 + v[i] * g01 + g02) / denom_;
+    v2[i] = (u[i] * g10 + v[i] * g11 + g12) / denom_;
+  }
+}
+
+void vpTemplateTrackerWarpHomographySL3::dWarpCompoPoints(const double *u, const double *v, const double *u2,
+                                                          const double *v2, unsigned int nbPoints,
+                                                          const vpColVector & /*ParamM*/, const double *dwdp0,
+                                                          double *dW_)
+{
+  for (unsigned int k = 0; k < nbPoints; k++) {
+    const double denom_ = u[k] * G[2][0] + v[k] * G[2][1] + G[2][2];
+    const double a00 = G[0][0] - u2[k] * G[2][0], a01 = G[0][1] - u2[k] * G[2][1];
+    const double a10 = G[1][0] - v2[k] * G[2][0], a11 = G[1][1] - v2[k] * G[2][1];
+    const double *dwdp0_x = dwdp0 + 2 * nbParam * k;
+    const double *dwdp0_y = dwdp0_x + nbParam;
+    double *dW_x = dW_ + 2 * nbParam * k;
+    double *dW_y = dW_x + nbParam;
+    for (unsigned int i = 0; i < nbParam; i++) {
+      dW_x[i] = denom_ * (a00 * dwdp0_x[i] + a01 * dwdp0_y[i]);
+      dW_y[i] = denom_ * (a10 * dwdp0_x[i] + a11 * dwdp0_y[i]);
+    }
+  }
+}
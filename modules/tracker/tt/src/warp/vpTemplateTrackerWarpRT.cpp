@@ -176,3 +176,41 @@ void vpTemplateTrackerWarpRT::pRondp(const vpColVector &p1, const vpColVector &p
   pres[1] = TransRes[0];
   pres[2] = TransRes[1];
 }
+
+void vpTemplateTrackerWarpRT::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                         const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double c = cos(ParamM[0]);
+  const double s = sin(ParamM[0]);
+  const double A[6] = {c, -s, ParamM[1], s, c, ParamM[2]};
+  warpPointsAffine(u, v, nbPoints, A, u2, v2);
+}
+
+void vpTemplateTrackerWarpRT::dWarpPoints(const double *u, const double *v, const double * /*u2*/,
+                                          const double * /*v2*/, unsigned int nbPoints, const vpColVector &ParamM,
+                                          double *dW_)
+{
+  const double c = cos(ParamM[0]);
+  const double s = sin(ParamM[0]);
+  for (unsigned int k = 0; k < nbPoints; k++, dW_ += 6) {
+    const double j = u[k];
+    const double i = v[k];
+    dW_[0] = (-s * j) - (c * i);
+    dW_[1] = 1;
+    dW_[2] = 0;
+
+    dW_[3] = c * j - s * i;
+    dW_[4] = 0;
+    dW_[5] = 1;
+  }
+}
+
+void vpTemplateTrackerWarpRT::dWarpCompoPoints(const double * /*u*/, const double * /*v*/, const double * /*u2*/,
+                                               const double * /*v2*/, unsigned int nbPoints,
+                                               const vpColVector &ParamM, const double *dwdp0, double *dW_)
+{
+  const double c = cos(ParamM[0]);
+  const double s = sin(ParamM[0]);
+  const double A[4] = {c, -s, s, c};
+  dWarpCompoPointsLinear(A, nbPoints, nbParam, dwdp0, dW_);
+}
@@ -186,3 +186,46 @@ void vpTemplateTrackerWarpSRT::pRondp(const vpColVector &p1, const vpColVector &
   pres[2] = TransRes[0];
   pres[3] = TransRes[1];
 }
+
+void vpTemplateTrackerWarpSRT::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                          const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double c = (1.0 + ParamM[0]) * cos(ParamM[1]);
+  const double s = (1.0 + ParamM[0]) * sin(ParamM[1]);
+  const double A[6] = {c, -s, ParamM[2], s, c, ParamM[3]};
+  warpPointsAffine(u, v, nbPoints, A, u2, v2);
+}
+
+void vpTemplateTrackerWarpSRT::dWarpPoints(const double *u, const double *v, const double * /*u2*/,
+                                           const double * /*v2*/, unsigned int nbPoints, const vpColVector &ParamM,
+                                           double *dW_)
+{
+  const double c = cos(ParamM[1]);
+  const double s = sin(ParamM[1]);
+  const double sc_c = (1.0 + ParamM[0]) * cos(ParamM[1]);
+  const double sc_s = (1.0 + ParamM[0]) * sin(ParamM[1]);
+  const double msc_s = -(1.0 + ParamM[0]) * sin(ParamM[1]);
+  for (unsigned int k = 0; k < nbPoints; k++, dW_ += 8) {
+    const double j = u[k];
+    const double i = v[k];
+    dW_[0] = c * j - s * i;
+    dW_[1] = (msc_s * j) - (sc_c * i);
+    dW_[2] = 1;
+    dW_[3] = 0;
+
+    dW_[4] = s * j + c * i;
+    dW_[5] = sc_c * j - sc_s * i;
+    dW_[6] = 0;
+    dW_[7] = 1;
+  }
+}
+
+void vpTemplateTrackerWarpSRT::dWarpCompoPoints(const double * /*u*/, const double * /*v*/, const double * /*u2*/,
+                                                const double * /*v2*/, unsigned int nbPoints,
+                                                const vpColVector &ParamM, const double *dwdp0, double *dW_)
+{
+  const double c = (1. + ParamM[0]) * cos(ParamM[1]);
+  const double s = (1.0 + ParamM[0]) * sin(ParamM[1]);
+  const double A[4] = {c, -s, s, c};
+  dWarpCompoPointsLinear(A, nbPoints, nbParam, dwdp0, dW_);
+}
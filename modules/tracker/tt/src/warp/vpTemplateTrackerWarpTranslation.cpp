@@ -37,6 +37,8 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <algorithm>
+
 #include <visp3/tt/vpTemplateTrackerWarpTranslation.h>
 
 vpTemplateTrackerWarpTranslation::vpTemplateTrackerWarpTranslation()
@@ -126,3 +128,34 @@ void vpTemplateTrackerWarpTranslation::pRondp(const vpColVector &p1, const vpCol
   pres[0] = p1[0] + p2[0];
   pres[1] = p1[1] + p2[1];
 }
+
+void vpTemplateTrackerWarpTranslation::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                                  const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double tu = ParamM[0];
+  const double tv = ParamM[1];
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    u2[i] = u[i] + tu;
+    v2[i] = v[i] + tv;
+  }
+}
+
+void vpTemplateTrackerWarpTranslation::dWarpPoints(const double * /*u*/, const double * /*v*/, const double * /*u2*/,
+                                                   const double * /*v2*/, unsigned int nbPoints,
+                                                   const vpColVector & /*ParamM*/, double *dW_)
+{
+  for (unsigned int k = 0; k < nbPoints; k++, dW_ += 4) {
+    dW_[0] = 1;
+    dW_[1] = 0;
+    dW_[2] = 0;
+    dW_[3] = 1;
+  }
+}
+
+void vpTemplateTrackerWarpTranslation::dWarpCompoPoints(const double * /*u*/, const double * /*v*/,
+                                                        const double * /*u2*/, const double * /*v2*/,
+                                                        unsigned int nbPoints, const vpColVector & /*ParamM*/,
+                                                        const double *dwdp0, double *dW_)
+{
+  std::copy(dwdp0, dwdp0 + 2 * nbParam * nbPoints, dW_);
+}
@@ -53,75 +53,81 @@ vpTemplateTrackerZNCC::vpTemplateTrackerZNCC(vpTemplateTrackerWarp *warp) : vpTe
   DI.resize(2);
 }
 
-double vpTemplateTrackerZNCC::getCost(const vpImage<unsigned char> &I, const vpColVector &tp)
-{
-  double IW, Tij;
-  int i, j;
-  double i2, j2;
-  int Nbpoint = 0;
-
-  Warp->computeCoeff(tp);
+/*!
+  Compute the mean intensities of the template and of the image over the
+  points of the template warped inside the image, see
+  sampleTemplateArrays().
 
-  double moyTij = 0;
-  double moyIW = 0;
-  for (unsigned int point = 0; point < templateSize; point++) {
-    i = ptTemplate[point].y;
-    j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-    Warp->computeDenom(X1, tp);
-    Warp->warpX(X1, X2, tp);
-
-    j2 = X2[0];
-    i2 = X2[1];
-    if ((j2 < I.getWidth() - 1) && (i2 < I.getHeight() - 1) && (i2 > 0) && (j2 > 0)) {
-      Tij = ptTemplate[point].val;
-      if (!blur)
-        IW = I.getValue(i2, j2);
-      else
-        IW = BI.getValue(i2, j2);
-      // IW=getSubPixBspline4(I,i2,j2);
-      moyTij += Tij;
-      moyIW += IW;
-      Nbpoint++;
+  \param Nbpoint : Number of points inside the image, must be positive.
+  \param moyTij : Mean intensity of the template.
+  \param moyIW : Mean intensity of the warped image.
+*/
+void vpTemplateTrackerZNCC::computeMeans(unsigned int Nbpoint, double &moyTij, double &moyIW)
+{
+  const vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  const unsigned int nbBlocks = initBlockSums(2);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbBlocks > 1)
+#endif
+  for (int block = 0; block < static_cast<int>(nbBlocks); block++) {
+    unsigned int begin, end;
+    getBlockRange(static_cast<unsigned int>(block), begin, end);
+    double sumTij = 0, sumIW = 0;
+    for (unsigned int point = begin; point < end; point++) {
+      if (pts.inImage[point]) {
+        sumTij += pts.val[point];
+        sumIW += pts.IW[point];
+      }
     }
+    blockSums[2 * static_cast<unsigned int>(block)] = sumTij;
+    blockSums[2 * static_cast<unsigned int>(block) + 1] = sumIW;
   }
+  double sums[2];
+  reduceBlockSums(nbBlocks, 2, sums);
+  moyTij = sums[0] / Nbpoint;
+  moyIW = sums[1] / Nbpoint;
+}
+
+double vpTemplateTrackerZNCC::getCost(const vpImage<unsigned char> &I, const vpColVector &tp)
+{
+  warpTemplateArrays(tp);
+  const unsigned int Nbpoint = sampleTemplateArrays(I, false, true);
+  const vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+
   ratioPixelIn = (double)Nbpoint / (double)templateSize;
   if (!Nbpoint) {
     throw(vpException(vpException::divideByZeroError, "Cannot get cost: size = 0"));
   }
 
-  moyTij = moyTij / Nbpoint;
-  moyIW = moyIW / Nbpoint;
-
-  double nom = 0; //,denom=0;
-  double var1 = 0, var2 = 0;
-  for (unsigned int point = 0; point < templateSize; point++) {
-    i = ptTemplate[point].y;
-    j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-    Warp->computeDenom(X1, tp);
-    Warp->warpX(X1, X2, tp);
-
-    j2 = X2[0];
-    i2 = X2[1];
-    if ((j2 < I.getWidth() - 1) && (i2 < I.getHeight() - 1) && (i2 > 0) && (j2 > 0)) {
-      Tij = ptTemplate[point].val;
-      if (!blur)
-        IW = I.getValue(i2, j2);
-      else
-        IW = BI.getValue(i2, j2);
-      // IW=getSubPixBspline4(I,i2,j2);
-      nom += (Tij - moyTij) * (IW - moyIW);
-      // denom+=(Tij-moyTij)*(Tij-moyTij)*(IW-moyIW)*(IW-moyIW);
-      var1 += (IW - moyIW) * (IW - moyIW);
-      var2 += (Tij - moyTij) * (Tij - moyTij);
+  double moyTij, moyIW;
+  computeMeans(Nbpoint, moyTij, moyIW);
 
-      Nbpoint++;
+  // nom, var1 and var2
+  const unsigned int nbBlocks = initBlockSums(3);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbBlocks > 1)
+#endif
+  for (int block = 0; block < static_cast<int>(nbBlocks); block++) {
+    unsigned int begin, end;
+    getBlockRange(static_cast<unsigned int>(block), begin, end);
+    double nom = 0;
+    double var1 = 0, var2 = 0;
+    for (unsigned int point = begin; point < end; point++) {
+      if (pts.inImage[point]) {
+        double Tij = pts.val[point];
+        double IW = pts.IW[point];
+        nom += (Tij - moyTij) * (IW - moyIW);
+        var1 += (IW - moyIW) * (IW - moyIW);
+        var2 += (Tij - moyTij) * (Tij - moyTij);
+      }
     }
+    double *sums = &blockSums[3 * static_cast<unsigned int>(block)];
+    sums[0] = nom;
+    sums[1] = var1;
+    sums[2] = var2;
   }
-  // if(Nbpoint==0)return 10e10; // cannot occur
+  double sums[3];
+  reduceBlockSums(nbBlocks, 3, sums);
   // return -nom/sqrt(denom);
-  return -nom / sqrt(var1 * var2);
+  return -sums[0] / sqrt(sums[1] * sums[2]);
 }
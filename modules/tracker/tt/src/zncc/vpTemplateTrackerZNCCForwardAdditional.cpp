@@ -147,23 +147,22 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
   vpMatrix::computeHLM(Hdesire, lambdaDep, HLMdesire);
   HLMdesireInverse = HLMdesire.inverseByLU();
   // std::cout<<"Hdesire = "<<Hdesire<<std::endl;
+
+  initTemplateArrays(0, 0, 0);
 }
 
 void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+    getGaussianBluredImage(I);
+  getGaussianGradients(I);
 
-  dW = 0;
-
-  double IW, dIWx, dIWy;
-  double Tij;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   double alpha = 2.;
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  // G, the error and the denominator
+  const unsigned int stride = nbParam + 2;
+  std::vector<double> sums(stride);
 
   initPosEvalRMS(p);
 
@@ -172,82 +171,58 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
   double evolRMS_delta;
 
   do {
-    int Nbpoint = 0;
-    double erreur = 0;
-    G = 0;
     H = 0;
-    Warp->computeCoeff(p);
-    double moyTij = 0;
-    double moyIW = 0;
-    double denom = 0;
-    for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Tij = ptTemplate[point].val;
-
-        if (!blur)
-          IW = I.getValue(i2, j2);
-        else
-          IW = BI.getValue(i2, j2);
-
-        Nbpoint++;
-        moyTij += Tij;
-        moyIW += IW;
-      }
-    }
+    warpTemplateArrays(p);
+    unsigned int Nbpoint = sampleTemplateArrays(I, true);
 
     if (!Nbpoint) {
       throw(vpException(vpException::divideByZeroError, "Cannot track the template: no point"));
     }
 
-    moyTij = moyTij / Nbpoint;
-    moyIW = moyIW / Nbpoint;
-    for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Tij = ptTemplate[point].val;
-
-        if (!blur)
-          IW = I.getValue(i2, j2);
-        else
-          IW = BI.getValue(i2, j2);
-
-        dIWx = dIx.getValue(i2, j2);
-        dIWy = dIy.getValue(i2, j2);
-        // Calcul du Hessien
-        Warp->dWarp(X1, X2, p, dW);
-        double *tempt = new double[nbParam];
-        for (unsigned int it = 0; it < nbParam; it++)
-          tempt[it] = dW[0][it] * dIWx + dW[1][it] * dIWy;
+    double moyTij, moyIW;
+    computeMeans(Nbpoint, moyTij, moyIW);
+
+    // Calcul du Hessien
+    pts.dWarp.resize(2 * nbParam * pts.size());
+    Warp->dWarpPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dWarp[0]);
+
+    const unsigned int nbBlocks = initBlockSums(stride);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbBlocks > 1)
+#endif
+    for (int block = 0; block < static_cast<int>(nbBlocks); block++) {
+      unsigned int begin, end;
+      getBlockRange(static_cast<unsigned int>(block), begin, end);
+      double *Gblock = &blockSums[static_cast<unsigned int>(block) * stride];
+      double erreur = 0;
+      double denom = 0;
+      for (unsigned int point = begin; point < end; point++) {
+        if (!pts.inImage[point]) {
+          continue;
+        }
+        double Tij = pts.val[point];
+        double IW = pts.IW[point];
+        double dIWx = pts.dIWx[point];
+        double dIWy = pts.dIWy[point];
+        const double *dWp = &pts.dWarp[2 * nbParam * point];
 
         double prod = (Tij - moyTij);
         for (unsigned int it = 0; it < nbParam; it++)
-          G[it] += prod * tempt[it];
+          Gblock[it] += prod * (dWp[it] * dIWx + dWp[nbParam + it] * dIWy);
 
         double er = (Tij - IW);
         erreur += (er * er);
         denom += (Tij - moyTij) * (Tij - moyTij) * (IW - moyIW) * (IW - moyIW);
-        delete[] tempt;
       }
+      Gblock[nbParam] = erreur;
+      Gblock[nbParam + 1] = denom;
     }
+    reduceBlockSums(nbBlocks, stride, &sums[0]);
+    for (unsigned int it = 0; it < nbParam; it++)
+      G[it] = sums[it];
+    double erreur = sums[nbParam];
+    double denom = sums[nbParam + 1];
+
     G = G / sqrt(denom);
     H = H / sqrt(denom);
 
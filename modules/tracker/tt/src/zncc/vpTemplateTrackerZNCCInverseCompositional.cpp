@@ -64,6 +64,7 @@ void vpTemplateTrackerZNCCInverseCompositional::initCompInverse(const vpImage<un
 
     Warp->getdW0(i, j, dy, dx, ptTemplate[point].dW);
   }
+  initTemplateArrays(nbParam, 0, 0);
   compoInitialised = true;
 }
 
@@ -236,90 +237,72 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
 void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
+    getGaussianBluredImage(I);
 
   vpColVector dpinv(nbParam);
-  double Ic;
-  double Iref;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   initPosEvalRMS(p);
 
+  const vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  // sIcdIref, sIrefdIref, covarIref, covarIc and sIcIref
+  const unsigned int stride = 2 * nbParam + 3;
+  std::vector<double> sums(stride);
+
   double evolRMS_init = 0;
   double evolRMS_prec = 0;
   double evolRMS_delta;
 
   do {
-    unsigned int Nbpoint = 0;
     G = 0;
-    Warp->computeCoeff(p);
-    double moyIref = 0;
-    double moyIc = 0;
-    for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Iref = ptTemplate[point].val;
-
-        if (!blur)
-          Ic = I.getValue(i2, j2);
-        else
-          Ic = BI.getValue(i2, j2);
-
-        Nbpoint++;
-        moyIref += Iref;
-        moyIc += Ic;
-      }
-    }
+    warpTemplateArrays(p);
+    unsigned int Nbpoint = sampleTemplateArrays(I, false);
     if (Nbpoint > 0) {
-      moyIref = moyIref / Nbpoint;
-      moyIc = moyIc / Nbpoint;
-      double sIcIref = 0;
-      double covarIref = 0, covarIc = 0;
-      vpColVector sIcdIref(nbParam);
-      sIcdIref = 0;
-      vpColVector sIrefdIref(nbParam);
-      sIrefdIref = 0;
-
-      for (unsigned int point = 0; point < templateSize; point++) {
-        i = ptTemplate[point].y;
-        j = ptTemplate[point].x;
-        X1[0] = j;
-        X1[1] = i;
-
-        Warp->computeDenom(X1, p);
-        Warp->warpX(X1, X2, p);
-
-        j2 = X2[0];
-        i2 = X2[1];
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-          Iref = ptTemplate[point].val;
-
-          if (!blur)
-            Ic = I.getValue(i2, j2);
-          else
-            Ic = BI.getValue(i2, j2);
+      double moyIref, moyIc;
+      computeMeans(Nbpoint, moyIref, moyIc);
+
+      const unsigned int nbBlocks = initBlockSums(stride);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbBlocks > 1)
+#endif
+      for (int block = 0; block < static_cast<int>(nbBlocks); block++) {
+        unsigned int begin, end;
+        getBlockRange(static_cast<unsigned int>(block), begin, end);
+        double *sIcdIref = &blockSums[static_cast<unsigned int>(block) * stride];
+        double *sIrefdIref = sIcdIref + nbParam;
+        double sIcIref = 0;
+        double covarIref = 0, covarIc = 0;
+        for (unsigned int point = begin; point < end; point++) {
+          if (!pts.inImage[point]) {
+            continue;
+          }
+          double Iref = pts.val[point];
+          double Ic = pts.IW[point];
+          const double *dW0 = &pts.dW[point * nbParam];
 
           double prod = (Ic - moyIc);
           for (unsigned int it = 0; it < nbParam; it++)
-            sIcdIref[it] += prod * (ptTemplate[point].dW[it] - moydIrefdp[it]);
+            sIcdIref[it] += prod * (dW0[it] - moydIrefdp[it]);
           for (unsigned int it = 0; it < nbParam; it++)
-            sIrefdIref[it] += (Iref - moyIref) * (ptTemplate[point].dW[it] - moydIrefdp[it]);
+            sIrefdIref[it] += (Iref - moyIref) * (dW0[it] - moydIrefdp[it]);
 
           covarIref += (Iref - moyIref) * (Iref - moyIref);
           covarIc += (Ic - moyIc) * (Ic - moyIc);
           sIcIref += (Iref - moyIref) * (Ic - moyIc);
         }
+        sIrefdIref[nbParam] = covarIref;
+        sIrefdIref[nbParam + 1] = covarIc;
+        sIrefdIref[nbParam + 2] = sIcIref;
       }
+      reduceBlockSums(nbBlocks, stride, &sums[0]);
+      vpColVector sIcdIref(nbParam), sIrefdIref(nbParam);
+      for (unsigned int it = 0; it < nbParam; it++) {
+        sIcdIref[it] = sums[it];
+        sIrefdIref[it] = sums[nbParam + it];
+      }
+      double covarIref = sums[2 * nbParam];
+      double covarIc = sums[2 * nbParam + 1];
+      double sIcIref = sums[2 * nbParam + 2];
+
       covarIref = sqrt(covarIref);
       covarIc = sqrt(covarIc);
       double denom = covarIref * covarIc;
@@ -0,0 +1,863 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the template trackers to a point by point reference implementation.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTemplateTrackerArrays.cpp
+
+  \brief Track templates of up to 256 points on a synthetic sequence with
+  every SSD and ZNCC tracker, every warp and several pyramid settings. The
+  parameters must be bit for bit the ones of a reference implementation that
+  warps, interpolates and accumulates the template point by point, as the
+  trackers did before the points were stored as arrays.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_TT)
+
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpTrackingException.h>
+#include <visp3/tt/vpTemplateTrackerSSDESM.h>
+#include <visp3/tt/vpTemplateTrackerSSDForwardAdditional.h>
+#include <visp3/tt/vpTemplateTrackerSSDForwardCompositional.h>
+#include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
+#include <visp3/tt/vpTemplateTrackerWarpAffine.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomography.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomographySL3.h>
+#include <visp3/tt/vpTemplateTrackerWarpRT.h>
+#include <visp3/tt/vpTemplateTrackerWarpSRT.h>
+#include <visp3/tt/vpTemplateTrackerWarpTranslation.h>
+#include <visp3/tt/vpTemplateTrackerZNCCForwardAdditional.h>
+#include <visp3/tt/vpTemplateTrackerZNCCInverseCompositional.h>
+
+namespace
+{
+const unsigned int height = 160;
+const unsigned int width = 200;
+// Size of the blocks of points accumulated by the trackers
+const unsigned int blockSize = 256;
+
+double texture(double u, double v)
+{
+  return 128 + 50 * sin(u * 0.11) * cos(v * 0.07) + 40 * sin((u + 2 * v) * 0.05) + 20 * cos(u * 0.3 - v * 0.2);
+}
+
+// Frame k: the texture rotated and translated about the center of the image
+void render(int k, vpImage<unsigned char> &I)
+{
+  const double a = 0.01 * k, tx = 1. * k, ty = -0.5 * k;
+  I.resize(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      const double x = j - width / 2. - tx, y = i - height / 2. - ty;
+      const double u = cos(a) * x + sin(a) * y + width / 2., v = -sin(a) * x + cos(a) * y + height / 2.;
+      I[i][j] = static_cast<unsigned char>(std::max(0., std::min(255., texture(u, v))));
+    }
+  }
+}
+
+// Reference SSD cost, used by the Brent line search
+template <class Tracker> class vpSSDCostReference : public Tracker
+{
+public:
+  explicit vpSSDCostReference(vpTemplateTrackerWarp *warp) : Tracker(warp) {}
+  unsigned int getTemplateSize() const { return this->templateSizePyr ? this->templateSizePyr[0] : this->templateSize; }
+
+protected:
+  double getCost(const vpImage<unsigned char> &I, const vpColVector &tp)
+  {
+    double erreur = 0;
+    int Nbpoint = 0;
+
+    this->Warp->computeCoeff(tp);
+    for (unsigned int point = 0; point < this->templateSize; point++) {
+      this->X1[0] = this->ptTemplate[point].x;
+      this->X1[1] = this->ptTemplate[point].y;
+      this->Warp->computeDenom(this->X1, tp);
+      this->Warp->warpX(this->X1, this->X2, tp);
+
+      double j2 = this->X2[0];
+      double i2 = this->X2[1];
+      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+        double Tij = this->ptTemplate[point].val;
+        double IW = this->blur ? this->BI.getValue(i2, j2) : I.getValue(i2, j2);
+        erreur += (Tij - IW) * (Tij - IW);
+        Nbpoint++;
+      }
+    }
+    this->ratioPixelIn = static_cast<double>(Nbpoint) / static_cast<double>(this->templateSize);
+
+    if (Nbpoint == 0)
+      return 10e10;
+    return erreur / Nbpoint;
+  }
+};
+
+// Reference ZNCC cost, used by the Brent line search
+template <class Tracker> class vpZNCCCostReference : public Tracker
+{
+public:
+  explicit vpZNCCCostReference(vpTemplateTrackerWarp *warp) : Tracker(warp) {}
+  unsigned int getTemplateSize() const { return this->templateSizePyr ? this->templateSizePyr[0] : this->templateSize; }
+
+protected:
+  double getCost(const vpImage<unsigned char> &I, const vpColVector &tp)
+  {
+    std::vector<double> Tij, IW;
+    this->Warp->computeCoeff(tp);
+    for (unsigned int point = 0; point < this->templateSize; point++) {
+      this->X1[0] = this->ptTemplate[point].x;
+      this->X1[1] = this->ptTemplate[point].y;
+      this->Warp->computeDenom(this->X1, tp);
+      this->Warp->warpX(this->X1, this->X2, tp);
+
+      double j2 = this->X2[0];
+      double i2 = this->X2[1];
+      if ((j2 < I.getWidth() - 1) && (i2 < I.getHeight() - 1) && (i2 > 0) && (j2 > 0)) {
+        Tij.push_back(this->ptTemplate[point].val);
+        IW.push_back(this->blur ? this->BI.getValue(i2, j2) : I.getValue(i2, j2));
+      }
+    }
+    const unsigned int Nbpoint = static_cast<unsigned int>(Tij.size());
+    this->ratioPixelIn = static_cast<double>(Nbpoint) / static_cast<double>(this->templateSize);
+    if (!Nbpoint) {
+      throw(vpException(vpException::divideByZeroError, "Cannot get cost: size = 0"));
+    }
+
+    double moyTij = 0, moyIW = 0;
+    for (unsigned int k = 0; k < Nbpoint; k++) {
+      moyTij += Tij[k];
+      moyIW += IW[k];
+    }
+    moyTij = moyTij / Nbpoint;
+    moyIW = moyIW / Nbpoint;
+
+    double nom = 0, var1 = 0, var2 = 0;
+    for (unsigned int k = 0; k < Nbpoint; k++) {
+      nom += (Tij[k] - moyTij) * (IW[k] - moyIW);
+      var1 += (IW[k] - moyIW) * (IW[k] - moyIW);
+      var2 += (Tij[k] - moyTij) * (Tij[k] - moyTij);
+    }
+    return -nom / sqrt(var1 * var2);
+  }
+};
+
+// Stopping criterion shared by the reference trackers
+class vpEvolRMS
+{
+public:
+  vpEvolRMS() : iteration(0), evolRMS_init(0), evolRMS_prec(0), evolRMS_delta(0) {}
+
+  void update(double evolRMS)
+  {
+    if (iteration == 0) {
+      evolRMS_init = evolRMS;
+    }
+    iteration++;
+    evolRMS_delta = std::fabs(evolRMS - evolRMS_prec);
+    evolRMS_prec = evolRMS;
+  }
+  bool stop(unsigned int iterationMax, double evolRMS_eps) const
+  {
+    return (iteration >= iterationMax) || (evolRMS_delta <= std::fabs(evolRMS_init) * evolRMS_eps);
+  }
+
+  unsigned int iteration;
+  double evolRMS_init;
+  double evolRMS_prec;
+  double evolRMS_delta;
+};
+
+class vpSSDForwardAdditionalReference : public vpSSDCostReference<vpTemplateTrackerSSDForwardAdditional>
+{
+public:
+  explicit vpSSDForwardAdditionalReference(vpTemplateTrackerWarp *warp) : vpSSDCostReference(warp) {}
+
+protected:
+  // Newton minimization, the default one
+  void trackNoPyr(const vpImage<unsigned char> &I)
+  {
+    if (blur)
+      vpImageFilter::filter(I, BI, fgG, taillef);
+    vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
+    vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+
+    dW = 0;
+    initPosEvalRMS(p);
+    vpEvolRMS evol;
+    do {
+      unsigned int Nbpoint = 0;
+      double erreur = 0;
+      G = 0;
+      H = 0;
+      Warp->computeCoeff(p);
+      for (unsigned int point = 0; point < templateSize; point++) {
+        X1[0] = ptTemplate[point].x;
+        X1[1] = ptTemplate[point].y;
+        Warp->computeDenom(X1, p);
+        Warp->warpX(X1, X2, p);
+        double j2 = X2[0];
+        double i2 = X2[1];
+        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+          double Tij = ptTemplate[point].val;
+          double IW = blur ? BI.getValue(i2, j2) : I.getValue(i2, j2);
+          double dIWx = dIx.getValue(i2, j2);
+          double dIWy = dIy.getValue(i2, j2);
+          Nbpoint++;
+          Warp->dWarp(X1, X2, p, dW);
+          std::vector<double> tempt(nbParam);
+          for (unsigned int it = 0; it < nbParam; it++)
+            tempt[it] = dW[0][it] * dIWx + dW[1][it] * dIWy;
+          for (unsigned int it = 0; it < nbParam; it++)
+            for (unsigned int jt = 0; jt < nbParam; jt++)
+              H[it][jt] += tempt[it] * tempt[jt];
+          double er = (Tij - IW);
+          for (unsigned int it = 0; it < nbParam; it++)
+            G[it] += er * tempt[it];
+          erreur += (er * er);
+        }
+      }
+      if (Nbpoint == 0) {
+        throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
+      }
+
+      vpMatrix::computeHLM(H, lambdaDep, HLM);
+      dp = HLM.inverseByLU() * G;
+      if (useBrent) {
+        double alpha = 2.;
+        computeOptimalBrentGain(I, p, erreur, dp, alpha);
+        dp = alpha * dp;
+      }
+      p += dp;
+
+      computeEvalRMS(p);
+      evol.update(evolRMS);
+      iterationGlobale++;
+    } while (!evol.stop(iterationMax, evolRMS_eps));
+    nbIteration = evol.iteration;
+  }
+};
+
+class vpSSDForwardCompositionalReference : public vpSSDCostReference<vpTemplateTrackerSSDForwardCompositional>
+{
+public:
+  explicit vpSSDForwardCompositionalReference(vpTemplateTrackerWarp *warp) : vpSSDCostReference(warp) {}
+
+protected:
+  void trackNoPyr(const vpImage<unsigned char> &I)
+  {
+    if (blur)
+      vpImageFilter::filter(I, BI, fgG, taillef);
+    vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
+    vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+
+    dW = 0;
+    initPosEvalRMS(p);
+    vpEvolRMS evol;
+    do {
+      unsigned int Nbpoint = 0;
+      double erreur = 0;
+      G = 0;
+      H = 0;
+      Warp->computeCoeff(p);
+      for (unsigned int point = 0; point < templateSize; point++) {
+        X1[0] = ptTemplate[point].x;
+        X1[1] = ptTemplate[point].y;
+        Warp->computeDenom(X1, p);
+        Warp->warpX(X1, X2, p);
+        double j2 = X2[0];
+        double i2 = X2[1];
+        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+          double Tij = ptTemplate[point].val;
+          double IW = blur ? BI.getValue(i2, j2) : I.getValue(i2, j2);
+          double dIWx = dIx.getValue(i2, j2);
+          double dIWy = dIy.getValue(i2, j2);
+          Nbpoint++;
+          Warp->dWarpCompo(X1, X2, p, ptTemplate[point].dW, dW);
+          std::vector<double> tempt(nbParam);
+          for (unsigned int it = 0; it < nbParam; it++)
+            tempt[it] = dW[0][it] * dIWx + dW[1][it] * dIWy;
+          for (unsigned int it = 0; it < nbParam; it++)
+            for (unsigned int jt = 0; jt < nbParam; jt++)
+              H[it][jt] += tempt[it] * tempt[jt];
+          double er = (Tij - IW);
+          for (unsigned int it = 0; it < nbParam; it++)
+            G[it] += er * tempt[it];
+          erreur += (er * er);
+        }
+      }
+      if (Nbpoint == 0) {
+        throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
+      }
+
+      vpMatrix::computeHLM(H, lambdaDep, HLM);
+      dp = HLM.inverseByLU() * G;
+      dp = gain * dp;
+      if (useBrent) {
+        double alpha = 2.;
+        computeOptimalBrentGain(I, p, erreur / Nbpoint, dp, alpha);
+        dp = alpha * dp;
+      }
+      Warp->pRondp(p, dp, p);
+
+      computeEvalRMS(p);
+      evol.update(evolRMS);
+    } while (!evol.stop(iterationMax, evolRMS_eps));
+    nbIteration = evol.iteration;
+  }
+};
+
+class vpSSDInverseCompositionalReference : public vpSSDCostReference<vpTemplateTrackerSSDInverseCompositional>
+{
+public:
+  explicit vpSSDInverseCompositionalReference(vpTemplateTrackerWarp *warp) : vpSSDCostReference(warp) {}
+
+protected:
+  void trackNoPyr(const vpImage<unsigned char> &I)
+  {
+    if (blur)
+      vpImageFilter::filter(I, BI, fgG, taillef);
+
+    vpColVector dpinv(nbParam);
+    initPosEvalRMS(p);
+    vpEvolRMS evol;
+    do {
+      unsigned int Nbpoint = 0;
+      double erreur = 0;
+      dp = 0;
+      Warp->computeCoeff(p);
+      for (unsigned int point = 0; point < templateSize; point++) {
+        if ((!useTemplateSelect) || (ptTemplateSelect[point])) {
+          X1[0] = ptTemplate[point].x;
+          X1[1] = ptTemplate[point].y;
+          Warp->computeDenom(X1, p);
+          Warp->warpX(X1, X2, p);
+          double j2 = X2[0];
+          double i2 = X2[1];
+          if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+            double Tij = ptTemplate[point].val;
+            double IW = blur ? BI.getValue(i2, j2) : I.getValue(i2, j2);
+            Nbpoint++;
+            double er = (Tij - IW);
+            for (unsigned int it = 0; it < nbParam; it++)
+              dp[it] += er * ptTemplate[point].HiG[it];
+            erreur += er * er;
+          }
+        }
+      }
+      if (Nbpoint == 0) {
+        throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
+      }
+      dp = gain * dp;
+      if (useBrent) {
+        double alpha = 2.;
+        computeOptimalBrentGain(I, p, erreur / Nbpoint, dp, alpha);
+        dp = alpha * dp;
+      }
+      Warp->getParamInverse(dp, dpinv);
+      Warp->pRondp(p, dpinv, p);
+
+      computeEvalRMS(p);
+      evol.update(evolRMS);
+    } while (!evol.stop(iterationMax, evolRMS_eps));
+    nbIteration = evol.iteration;
+  }
+};
+
+class vpSSDESMReference : public vpSSDCostReference<vpTemplateTrackerSSDESM>
+{
+public:
+  explicit vpSSDESMReference(vpTemplateTrackerWarp *warp) : vpSSDCostReference(warp) {}
+
+protected:
+  void trackNoPyr(const vpImage<unsigned char> &I)
+  {
+    if (blur)
+      vpImageFilter::filter(I, BI, fgG, taillef);
+    vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
+    vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+
+    initPosEvalRMS(p);
+    vpEvolRMS evol;
+    do {
+      unsigned int Nbpoint = 0;
+      double erreur = 0;
+      dp = 0;
+      HDir = 0;
+      GDir = 0;
+      GInv = 0;
+      Warp->computeCoeff(p);
+      for (unsigned int point = 0; point < templateSize; point++) {
+        X1[0] = ptTemplate[point].x;
+        X1[1] = ptTemplate[point].y;
+        Warp->computeDenom(X1, p);
+        Warp->warpX(X1, X2, p);
+        double j2 = X2[0];
+        double i2 = X2[1];
+        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+          double Tij = ptTemplate[point].val;
+          double IW = blur ? BI.getValue(i2, j2) : I.getValue(i2, j2);
+          Nbpoint++;
+          double er = (Tij - IW);
+          for (unsigned int it = 0; it < nbParam; it++)
+            GInv[it] += er * ptTemplate[point].dW[it];
+          erreur += er * er;
+
+          double dIWx = dIx.getValue(i2, j2) + ptTemplate[point].dx;
+          double dIWy = dIy.getValue(i2, j2) + ptTemplate[point].dy;
+          Warp->dWarpCompo(X1, X2, p, ptTemplateCompo[point].dW, dW);
+          std::vector<double> tempt(nbParam);
+          for (unsigned int it = 0; it < nbParam; it++)
+            tempt[it] = dW[0][it] * dIWx + dW[1][it] * dIWy;
+          for (unsigned int it = 0; it < nbParam; it++)
+            for (unsigned int jt = 0; jt < nbParam; jt++)
+              HDir[it][jt] += tempt[it] * tempt[jt];
+          for (unsigned int it = 0; it < nbParam; it++)
+            GDir[it] += er * tempt[it];
+        }
+      }
+      if (Nbpoint == 0) {
+        throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
+      }
+
+      vpMatrix::computeHLM(HDir, lambdaDep, HLMDir);
+      dp = HLMDir.inverseByLU() * GDir;
+      dp = gain * dp;
+      if (useBrent) {
+        double alpha = 2.;
+        computeOptimalBrentGain(I, p, erreur / Nbpoint, dp, alpha);
+        dp = alpha * dp;
+      }
+      p += dp;
+
+      computeEvalRMS(p);
+      evol.update(evolRMS);
+    } while (!evol.stop(iterationMax, evolRMS_eps));
+    nbIteration = evol.iteration;
+  }
+};
+
+class vpZNCCForwardAdditionalReference : public vpZNCCCostReference<vpTemplateTrackerZNCCForwardAdditional>
+{
+public:
+  explicit vpZNCCForwardAdditionalReference(vpTemplateTrackerWarp *warp) : vpZNCCCostReference(warp) {}
+
+protected:
+  void trackNoPyr(const vpImage<unsigned char> &I)
+  {
+    if (blur)
+      vpImageFilter::filter(I, BI, fgG, taillef);
+    vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
+    vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+
+    dW = 0;
+    initPosEvalRMS(p);
+    vpEvolRMS evol;
+    do {
+      int Nbpoint = 0;
+      double erreur = 0;
+      G = 0;
+      H = 0;
+      Warp->computeCoeff(p);
+      double moyTij = 0;
+      double moyIW = 0;
+      double denom = 0;
+      for (unsigned int point = 0; point < templateSize; point++) {
+        X1[0] = ptTemplate[point].x;
+        X1[1] = ptTemplate[point].y;
+        Warp->computeDenom(X1, p);
+        Warp->warpX(X1, X2, p);
+        double j2 = X2[0];
+        double i2 = X2[1];
+        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+          Nbpoint++;
+          moyTij += ptTemplate[point].val;
+          moyIW += blur ? BI.getValue(i2, j2) : I.getValue(i2, j2);
+        }
+      }
+      if (!Nbpoint) {
+        throw(vpException(vpException::divideByZeroError, "Cannot track the template: no point"));
+      }
+      moyTij = moyTij / Nbpoint;
+      moyIW = moyIW / Nbpoint;
+
+      for (unsigned int point = 0; point < templateSize; point++) {
+        X1[0] = ptTemplate[point].x;
+        X1[1] = ptTemplate[point].y;
+        Warp->computeDenom(X1, p);
+        Warp->warpX(X1, X2, p);
+        double j2 = X2[0];
+        double i2 = X2[1];
+        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+          double Tij = ptTemplate[point].val;
+          double IW = blur ? BI.getValue(i2, j2) : I.getValue(i2, j2);
+          double dIWx = dIx.getValue(i2, j2);
+          double dIWy = dIy.getValue(i2, j2);
+          Warp->dWarp(X1, X2, p, dW);
+          std::vector<double> tempt(nbParam);
+          for (unsigned int it = 0; it < nbParam; it++)
+            tempt[it] = dW[0][it] * dIWx + dW[1][it] * dIWy;
+          double prod = (Tij - moyTij);
+          for (unsigned int it = 0; it < nbParam; it++)
+            G[it] += prod * tempt[it];
+          double er = (Tij - IW);
+          erreur += (er * er);
+          denom += (Tij - moyTij) * (Tij - moyTij) * (IW - moyIW) * (IW - moyIW);
+        }
+      }
+      G = G / sqrt(denom);
+      H = H / sqrt(denom);
+
+      dp = HLMdesireInverse * G;
+      dp = gain * dp;
+      if (useBrent) {
+        double alpha = 2.;
+        computeOptimalBrentGain(I, p, erreur / Nbpoint, dp, alpha);
+        dp = alpha * dp;
+      }
+      p -= dp;
+
+      computeEvalRMS(p);
+      evol.update(evolRMS);
+    } while (!evol.stop(iterationMax, evolRMS_eps));
+    nbIteration = evol.iteration;
+  }
+};
+
+class vpZNCCInverseCompositionalReference : public vpZNCCCostReference<vpTemplateTrackerZNCCInverseCompositional>
+{
+public:
+  explicit vpZNCCInverseCompositionalReference(vpTemplateTrackerWarp *warp) : vpZNCCCostReference(warp) {}
+
+protected:
+  void trackNoPyr(const vpImage<unsigned char> &I)
+  {
+    if (blur)
+      vpImageFilter::filter(I, BI, fgG, taillef);
+
+    vpColVector dpinv(nbParam);
+    initPosEvalRMS(p);
+    vpEvolRMS evol;
+    do {
+      unsigned int Nbpoint = 0;
+      G = 0;
+      Warp->computeCoeff(p);
+      double moyIref = 0;
+      double moyIc = 0;
+      for (unsigned int point = 0; point < templateSize; point++) {
+        X1[0] = ptTemplate[point].x;
+        X1[1] = ptTemplate[point].y;
+        Warp->computeDenom(X1, p);
+        Warp->warpX(X1, X2, p);
+        double j2 = X2[0];
+        double i2 = X2[1];
+        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+          Nbpoint++;
+          moyIref += ptTemplate[point].val;
+          moyIc += blur ? BI.getValue(i2, j2) : I.getValue(i2, j2);
+        }
+      }
+      if (Nbpoint > 0) {
+        moyIref = moyIref / Nbpoint;
+        moyIc = moyIc / Nbpoint;
+        double sIcIref = 0;
+        double covarIref = 0, covarIc = 0;
+        vpColVector sIcdIref(nbParam);
+        vpColVector sIrefdIref(nbParam);
+
+        for (unsigned int point = 0; point < templateSize; point++) {
+          X1[0] = ptTemplate[point].x;
+          X1[1] = ptTemplate[point].y;
+          Warp->computeDenom(X1, p);
+          Warp->warpX(X1, X2, p);
+          double j2 = X2[0];
+          double i2 = X2[1];
+          if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+            double Iref = ptTemplate[point].val;
+            double Ic = blur ? BI.getValue(i2, j2) : I.getValue(i2, j2);
+            double prod = (Ic - moyIc);
+            for (unsigned int it = 0; it < nbParam; it++)
+              sIcdIref[it] += prod * (ptTemplate[point].dW[it] - moydIrefdp[it]);
+            for (unsigned int it = 0; it < nbParam; it++)
+              sIrefdIref[it] += (Iref - moyIref) * (ptTemplate[point].dW[it] - moydIrefdp[it]);
+            covarIref += (Iref - moyIref) * (Iref - moyIref);
+            covarIc += (Ic - moyIc) * (Ic - moyIc);
+            sIcIref += (Iref - moyIref) * (Ic - moyIc);
+          }
+        }
+        covarIref = sqrt(covarIref);
+        covarIc = sqrt(covarIc);
+        double denom = covarIref * covarIc;
+
+        if (std::fabs(denom) <= std::numeric_limits<double>::epsilon()) {
+          diverge = true;
+        } else {
+          double NCC = sIcIref / denom;
+          vpColVector dcovarIref(nbParam);
+          dcovarIref = sIrefdIref / covarIref;
+          G = (sIcdIref / denom - NCC * dcovarIref / covarIref);
+          dp = -HLMdesireInverse * G;
+          Warp->getParamInverse(dp, dpinv);
+          Warp->pRondp(p, dpinv, p);
+          computeEvalRMS(p);
+        }
+      } else {
+        diverge = true;
+      }
+      evol.update(evolRMS);
+    } while (!diverge && !evol.stop(iterationMax, evolRMS_eps));
+    nbIteration = evol.iteration;
+  }
+};
+
+enum vpTrackerType {
+  SSD_FORWARD_ADDITIONAL,
+  SSD_FORWARD_COMPOSITIONAL,
+  SSD_INVERSE_COMPOSITIONAL,
+  SSD_ESM,
+  ZNCC_FORWARD_ADDITIONAL,
+  ZNCC_INVERSE_COMPOSITIONAL,
+  NB_TRACKER_TYPES
+};
+const char *trackerNames[] = {"SSD forward additional",    "SSD forward compositional", "SSD inverse compositional",
+                              "SSD ESM",                   "ZNCC forward additional",   "ZNCC inverse compositional"};
+
+enum vpWarpType { TRANSLATION, SRT, RT, AFFINE, HOMOGRAPHY, HOMOGRAPHY_SL3, NB_WARP_TYPES };
+const char *warpNames[] = {"translation", "SRT", "RT", "affine", "homography", "homography SL3"};
+
+vpTemplateTrackerWarp *createWarp(int type)
+{
+  switch (type) {
+  case TRANSLATION:
+    return new vpTemplateTrackerWarpTranslation;
+  case SRT:
+    return new vpTemplateTrackerWarpSRT;
+  case RT:
+    return new vpTemplateTrackerWarpRT;
+  case AFFINE:
+    return new vpTemplateTrackerWarpAffine;
+  case HOMOGRAPHY:
+    return new vpTemplateTrackerWarpHomography;
+  default:
+    return new vpTemplateTrackerWarpHomographySL3;
+  }
+}
+
+// Settings of the templates
+struct vpTemplateSetting {
+  unsigned int nbLvlPyr;
+  unsigned int l0Pyr;
+  int sampling;
+  double halfSize;
+  bool brent;
+};
+
+vpTemplateTracker *initTracker(vpTemplateTracker *tracker, const vpTemplateSetting &setting,
+                               const vpImage<unsigned char> &I)
+{
+  tracker->setPyramidal(setting.nbLvlPyr, setting.l0Pyr);
+  tracker->setSampling(setting.sampling, setting.sampling);
+  tracker->setUseBrent(setting.brent);
+  tracker->setLambda(0.001);
+  tracker->setIterationMax(30);
+
+  const double ci = height / 2., cj = width / 2., half = setting.halfSize;
+  std::vector<vpImagePoint> v_ip;
+  v_ip.push_back(vpImagePoint(ci - half, cj - half));
+  v_ip.push_back(vpImagePoint(ci + half, cj - half));
+  v_ip.push_back(vpImagePoint(ci + half, cj + half));
+  v_ip.push_back(vpImagePoint(ci - half, cj - half));
+  v_ip.push_back(vpImagePoint(ci + half, cj + half));
+  v_ip.push_back(vpImagePoint(ci - half, cj + half));
+  tracker->initFromPoints(I, v_ip);
+  return tracker;
+}
+
+template <class Reference>
+vpTemplateTracker *initReference(vpTemplateTrackerWarp *warp, const vpTemplateSetting &setting,
+                                 const vpImage<unsigned char> &I, unsigned int &nbPoints)
+{
+  Reference *tracker = new Reference(warp);
+  initTracker(tracker, setting, I);
+  nbPoints = tracker->getTemplateSize();
+  return tracker;
+}
+
+// Create and initialize the tracker, and its reference that also gives the
+// number of points of the template at the finest level
+void createTrackers(int type, vpTemplateTrackerWarp *warp, vpTemplateTrackerWarp *warpRef,
+                    const vpTemplateSetting &setting, const vpImage<unsigned char> &I, vpTemplateTracker *&tracker,
+                    vpTemplateTracker *&reference, unsigned int &nbPoints)
+{
+  switch (type) {
+  case SSD_FORWARD_ADDITIONAL:
+    tracker = new vpTemplateTrackerSSDForwardAdditional(warp);
+    reference = initReference<vpSSDForwardAdditionalReference>(warpRef, setting, I, nbPoints);
+    break;
+  case SSD_FORWARD_COMPOSITIONAL:
+    tracker = new vpTemplateTrackerSSDForwardCompositional(warp);
+    reference = initReference<vpSSDForwardCompositionalReference>(warpRef, setting, I, nbPoints);
+    break;
+  case SSD_INVERSE_COMPOSITIONAL:
+    tracker = new vpTemplateTrackerSSDInverseCompositional(warp);
+    reference = initReference<vpSSDInverseCompositionalReference>(warpRef, setting, I, nbPoints);
+    break;
+  case SSD_ESM:
+    tracker = new vpTemplateTrackerSSDESM(warp);
+    reference = initReference<vpSSDESMReference>(warpRef, setting, I, nbPoints);
+    break;
+  case ZNCC_FORWARD_ADDITIONAL:
+    tracker = new vpTemplateTrackerZNCCForwardAdditional(warp);
+    reference = initReference<vpZNCCForwardAdditionalReference>(warpRef, setting, I, nbPoints);
+    break;
+  default:
+    tracker = new vpTemplateTrackerZNCCInverseCompositional(warp);
+    reference = initReference<vpZNCCInverseCompositionalReference>(warpRef, setting, I, nbPoints);
+    break;
+  }
+  initTracker(tracker, setting, I);
+}
+
+// Track and return the message of the exception if the template is lost
+std::string track(vpTemplateTracker *tracker, const vpImage<unsigned char> &I)
+{
+  try {
+    tracker->track(I);
+  } catch (const vpException &e) {
+    return e.getStringMessage();
+  }
+  return std::string();
+}
+
+bool sameParameters(const vpColVector &p1, const vpColVector &p2)
+{
+  if (p1.size() != p2.size()) {
+    return false;
+  }
+  for (unsigned int i = 0; i < p1.size(); i++) {
+    if (p1[i] != p2[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  const int nbFrames = 4;
+  std::vector<vpImage<unsigned char> > frames(nbFrames);
+  for (int k = 0; k < nbFrames; k++) {
+    render(k, frames[static_cast<size_t>(k)]);
+  }
+
+  // Pyramid settings, sampling and size of the templates, and line search
+  const vpTemplateSetting settings[] = {{1, 0, 1, 4., false}, {1, 0, 2, 15., false}, {2, 0, 1, 7.5, false},
+                                        {2, 1, 2, 15., false}, {3, 0, 1, 7.5, false}, {1, 0, 1, 7.5, true},
+                                        {2, 0, 2, 15., true}};
+  const unsigned int nbSettings = sizeof(settings) / sizeof(settings[0]);
+
+  bool success = true;
+  unsigned int maxNbPoints = 0;
+  try {
+    for (int type = 0; type < NB_TRACKER_TYPES; type++) {
+      for (int warpType = 0; warpType < NB_WARP_TYPES; warpType++) {
+        for (unsigned int s = 0; s < nbSettings; s++) {
+          vpTemplateTrackerWarp *warp = createWarp(warpType);
+          vpTemplateTrackerWarp *warpRef = createWarp(warpType);
+          if (type == SSD_ESM && !warp->isESMcompatible()) {
+            delete warp;
+            delete warpRef;
+            continue;
+          }
+          vpTemplateTracker *tracker = NULL, *reference = NULL;
+          unsigned int nbPoints = 0;
+          createTrackers(type, warp, warpRef, settings[s], frames[0], tracker, reference, nbPoints);
+          maxNbPoints = std::max(maxNbPoints, nbPoints);
+          if (nbPoints > blockSize) {
+            std::cerr << "The template has " << nbPoints << " points, more than " << blockSize << std::endl;
+            success = false;
+          }
+
+          for (int k = 1; k < nbFrames; k++) {
+            // A lost template must be lost by the reference too
+            const std::string lost = track(tracker, frames[static_cast<size_t>(k)]);
+            const std::string lostRef = track(reference, frames[static_cast<size_t>(k)]);
+            if (lost != lostRef || !sameParameters(tracker->getp(), reference->getp()) ||
+                tracker->getNbIteration() != reference->getNbIteration()) {
+              std::cerr << trackerNames[type] << " tracker with the " << warpNames[warpType] << " warp, setting " << s
+                        << ", frame " << k << ": the tracking differs from the reference:\n"
+                        << lost << " / " << lostRef << "\n"
+                        << tracker->getp().t() << " (" << tracker->getNbIteration() << " iterations)\n"
+                        << reference->getp().t() << " (" << reference->getNbIteration() << " iterations)"
+                        << std::endl;
+              success = false;
+              break;
+            }
+          }
+
+          delete tracker;
+          delete reference;
+          delete warp;
+          delete warpRef;
+        }
+      }
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Templates of up to " << maxNbPoints << " points" << std::endl;
+
+  if (!success) {
+    std::cerr << "testTemplateTrackerArrays failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "testTemplateTrackerArrays is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+#else
+int main()
+{
+  std::cout << "Enable TT module (VISP_HAVE_MODULE_TT) to launch this test." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
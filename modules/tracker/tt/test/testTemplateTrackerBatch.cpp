@@ -0,0 +1,274 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the tracking of several templates with vpTemplateTrackerBatch.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTemplateTrackerBatch.cpp
+
+  \brief Track several templates on a synthetic sequence with
+  vpTemplateTrackerBatch. The parameters must be the same as with the
+  templates tracked one by one, with the templates tracked sequentially or
+  concurrently and with or without the shared image products. The skipped
+  and disabled templates must keep their parameters.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_TT)
+
+#include <visp3/tt/vpTemplateTrackerBatch.h>
+#include <visp3/tt/vpTemplateTrackerSSDESM.h>
+#include <visp3/tt/vpTemplateTrackerSSDForwardCompositional.h>
+#include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
+#include <visp3/tt/vpTemplateTrackerWarpAffine.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomography.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomographySL3.h>
+#include <visp3/tt/vpTemplateTrackerWarpSRT.h>
+#include <visp3/tt/vpTemplateTrackerZNCCInverseCompositional.h>
+
+namespace
+{
+const unsigned int height = 240;
+const unsigned int width = 320;
+const unsigned int nbTemplates = 5;
+
+double texture(double u, double v)
+{
+  return 128 + 50 * sin(u * 0.11) * cos(v * 0.07) + 40 * sin((u + 2 * v) * 0.05) + 20 * cos(u * 0.3 - v * 0.2);
+}
+
+// Frame k: the texture rotated and translated about the center of the image
+void render(int k, vpImage<unsigned char> &I)
+{
+  const double a = 0.01 * k, tx = 1.5 * k, ty = -1. * k;
+  I.resize(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      const double x = j - width / 2. - tx, y = i - height / 2. - ty;
+      const double u = cos(a) * x + sin(a) * y + width / 2., v = -sin(a) * x + cos(a) * y + height / 2.;
+      I[i][j] = static_cast<unsigned char>(std::max(0., std::min(255., texture(u, v))));
+    }
+  }
+}
+
+// Templates of different types, warps, pyramids and filter sizes
+class vpTemplates
+{
+public:
+  explicit vpTemplates(const vpImage<unsigned char> &I) : warps(), trackers()
+  {
+    warps.push_back(new vpTemplateTrackerWarpAffine);
+    trackers.push_back(new vpTemplateTrackerSSDForwardCompositional(warps.back()));
+    trackers.back()->setPyramidal(2, 1);
+
+    warps.push_back(new vpTemplateTrackerWarpHomography);
+    trackers.push_back(new vpTemplateTrackerSSDInverseCompositional(warps.back()));
+
+    warps.push_back(new vpTemplateTrackerWarpSRT);
+    trackers.push_back(new vpTemplateTrackerZNCCInverseCompositional(warps.back()));
+    trackers.back()->setPyramidal(3, 0);
+
+    warps.push_back(new vpTemplateTrackerWarpHomographySL3);
+    trackers.push_back(new vpTemplateTrackerSSDESM(warps.back()));
+    trackers.back()->setBlur(false);
+
+    warps.push_back(new vpTemplateTrackerWarpAffine);
+    trackers.push_back(new vpTemplateTrackerSSDInverseCompositional(warps.back()));
+    trackers.back()->setGaussianFilterSize(5);
+    trackers.back()->setPyramidal(2, 0);
+
+    for (unsigned int t = 0; t < nbTemplates; t++) {
+      trackers[t]->setSampling(2, 2);
+      trackers[t]->setLambda(0.001);
+      trackers[t]->setIterationMax(50);
+
+      const double ci = 70. + 50. * (t % 3), cj = 80. + 60. * t / 2.;
+      const double half = 25.;
+      std::vector<vpImagePoint> v_ip;
+      v_ip.push_back(vpImagePoint(ci - half, cj - half));
+      v_ip.push_back(vpImagePoint(ci + half, cj - half));
+      v_ip.push_back(vpImagePoint(ci + half, cj + half));
+      v_ip.push_back(vpImagePoint(ci - half, cj - half));
+      v_ip.push_back(vpImagePoint(ci + half, cj + half));
+      v_ip.push_back(vpImagePoint(ci - half, cj + half));
+      trackers[t]->initFromPoints(I, v_ip);
+    }
+  }
+
+  ~vpTemplates()
+  {
+    for (size_t t = 0; t < trackers.size(); t++) {
+      delete trackers[t];
+      delete warps[t];
+    }
+  }
+
+  std::vector<vpTemplateTrackerWarp *> warps;
+  std::vector<vpTemplateTracker *> trackers;
+};
+
+bool sameParameters(const vpColVector &p1, const vpColVector &p2)
+{
+  if (p1.size() != p2.size()) {
+    return false;
+  }
+  for (unsigned int i = 0; i < p1.size(); i++) {
+    if (p1[i] != p2[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  const int nbFrames = 6;
+  std::vector<vpImage<unsigned char> > frames(nbFrames);
+  for (int k = 0; k < nbFrames; k++) {
+    render(k, frames[static_cast<size_t>(k)]);
+  }
+
+  try {
+    // Reference: the templates tracked one by one
+    vpTemplates reference(frames[0]);
+    std::vector<std::vector<vpColVector> > p_ref(nbFrames, std::vector<vpColVector>(nbTemplates));
+    for (int k = 1; k < nbFrames; k++) {
+      for (unsigned int t = 0; t < nbTemplates; t++) {
+        reference.trackers[t]->track(frames[static_cast<size_t>(k)]);
+        p_ref[static_cast<size_t>(k)][t] = reference.trackers[t]->getp();
+      }
+    }
+
+    bool success = true;
+    for (int config = 0; config < 3; config++) {
+      const bool shared = (config != 1);
+      const bool parallel = (config == 2);
+      vpTemplates templates(frames[0]);
+      vpTemplateTrackerBatch batch;
+      for (unsigned int t = 0; t < nbTemplates; t++) {
+        batch.addTracker(*templates.trackers[t]);
+      }
+      batch.setUseSharedFrame(shared);
+      batch.setUseParallelTracking(parallel);
+      batch.setNbParallelThreads(3);
+
+      for (int k = 1; k < nbFrames; k++) {
+        batch.track(frames[static_cast<size_t>(k)]);
+        for (unsigned int t = 0; t < nbTemplates; t++) {
+          if (batch.getStatus(t) != vpTemplateTrackerBatch::CONVERGED &&
+              batch.getStatus(t) != vpTemplateTrackerBatch::MAX_ITERATIONS) {
+            std::cerr << "Config " << config << ", frame " << k << ": template " << t << " is not tracked"
+                      << std::endl;
+            success = false;
+          } else if (!sameParameters(templates.trackers[t]->getp(), p_ref[static_cast<size_t>(k)][t])) {
+            std::cerr << "Config " << config << ", frame " << k << ": the parameters of template " << t
+                      << " differ from the ones tracked alone:\n"
+                      << templates.trackers[t]->getp().t() << "\n"
+                      << p_ref[static_cast<size_t>(k)][t].t() << std::endl;
+            success = false;
+          }
+        }
+      }
+      std::cout << "Config shared: " << shared << ", parallel: " << parallel
+                << ", last frame: " << batch.getPreprocessingTime() << " ms preprocessing, " << batch.getTotalTime()
+                << " ms total" << std::endl;
+    }
+
+    // Time budget and disabled templates
+    {
+      vpTemplates templates(frames[0]);
+      vpTemplateTrackerBatch batch;
+      for (unsigned int t = 0; t < nbTemplates; t++) {
+        batch.addTracker(*templates.trackers[t]);
+      }
+      batch.setEnabled(1, false);
+      std::vector<vpColVector> p_init(nbTemplates);
+      for (unsigned int t = 0; t < nbTemplates; t++) {
+        p_init[t] = templates.trackers[t]->getp();
+      }
+
+      // The budget is exhausted by the computation of the image products
+      batch.setTimeBudget(1e-9);
+      batch.track(frames[1]);
+      if (batch.getNbSkipped() != nbTemplates - 1 || batch.getStatus(1) != vpTemplateTrackerBatch::NOT_TRACKED) {
+        std::cerr << "Expected " << nbTemplates - 1 << " skipped templates, got " << batch.getNbSkipped()
+                  << std::endl;
+        success = false;
+      }
+      for (unsigned int t = 0; t < nbTemplates; t++) {
+        if (!sameParameters(templates.trackers[t]->getp(), p_init[t])) {
+          std::cerr << "The parameters of the skipped template " << t << " changed" << std::endl;
+          success = false;
+        }
+      }
+
+      batch.setTimeBudget(0);
+      batch.track(frames[1]);
+      for (unsigned int t = 0; t < nbTemplates; t++) {
+        if (t == 1) {
+          if (batch.getStatus(t) != vpTemplateTrackerBatch::NOT_TRACKED ||
+              !sameParameters(templates.trackers[t]->getp(), p_init[t])) {
+            std::cerr << "The disabled template " << t << " was tracked" << std::endl;
+            success = false;
+          }
+        } else if (!sameParameters(templates.trackers[t]->getp(), p_ref[1][t])) {
+          std::cerr << "The parameters of template " << t << " differ after a skipped frame" << std::endl;
+          success = false;
+        }
+      }
+    }
+
+    if (!success) {
+      std::cerr << "testTemplateTrackerBatch failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testTemplateTrackerBatch is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+#else
+int main()
+{
+  std::cout << "Enable TT module (VISP_HAVE_MODULE_TT) to launch this test." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
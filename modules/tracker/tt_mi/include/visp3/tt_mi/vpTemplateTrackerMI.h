@@ -70,6 +70,13 @@ public:
   typedef enum { BSPLINE_THIRD_ORDER = 3, BSPLINE_FOURTH_ORDER = 4 } vpBsplineType;
 
 protected:
+  //! Terms of the joint probabilities filled by computeJointProbabilities()
+  typedef enum {
+    JOINT_PROBABILITY,             ///< Joint probabilities only
+    JOINT_PROBABILITY_FIRST_ORDER, ///< Joint probabilities and first derivatives
+    JOINT_PROBABILITY_SECOND_ORDER ///< Joint probabilities, first and second derivatives
+  } vpJointProbabilityType;
+
   vpHessienType hessianComputation;
   vpHessienApproximationType ApproxHessian;
   double lambda;
@@ -114,10 +121,16 @@ protected:
   std::vector< std::vector<double> > m_d2v;
   std::vector< std::vector<double> > m_dA;
 
+  // Partial joint probabilities of the threads, see initThreadProbabilities()
+  std::vector<double> m_threadProbabilities;
+  unsigned int m_nbThreadProbabilities;
+  unsigned int m_threadProbabilitiesSize;
+
 protected:
   void computeGradient();
   void computeHessien(vpMatrix &H);
   void computeHessienNormalized(vpMatrix &H);
+  void computeJointProbabilities(vpJointProbabilityType type, bool inverse, const bool *select = NULL);
   void computeMI(double &MI);
   void computeProba(int &nbpoint);
 
@@ -125,7 +138,11 @@ protected:
   double getCost(const vpImage<unsigned char> &I) { return getCost(I, p); }
   double getNormalizedCost(const vpImage<unsigned char> &I, const vpColVector &tp);
   double getNormalizedCost(const vpImage<unsigned char> &I) { return getNormalizedCost(I, p); }
+  double *getThreadProbabilities(unsigned int thread, double *probabilities, unsigned int offset = 0);
+  void getThreadRange(unsigned int thread, unsigned int nbPoints, unsigned int &begin, unsigned int &end) const;
   virtual void initHessienDesired(const vpImage<unsigned char> &I) = 0;
+  unsigned int initThreadProbabilities(unsigned int nbPoints, unsigned int size);
+  void reduceThreadProbabilities(unsigned int offset, unsigned int size, double *probabilities) const;
   virtual void trackNoPyr(const vpImage<unsigned char> &I) = 0;
   void zeroProbabilities();
 
@@ -157,7 +174,8 @@ public:
       Prt(NULL), dPrt(NULL), Pt(NULL), Pr(NULL), d2Prt(NULL), PrtTout(NULL), dprtemp(NULL), PrtD(NULL), dPrtD(NULL),
       influBspline(0), bspline(0), Nc(0), Ncb(0), d2Ix(), d2Iy(), d2Ixy(), MI_preEstimation(0), MI_postEstimation(0),
       NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false),
-      m_du(), m_dv(), m_A(), m_dB(), m_d2u(), m_d2v(), m_dA()
+      m_du(), m_dv(), m_A(), m_dB(), m_d2u(), m_d2v(), m_dA(), m_threadProbabilities(), m_nbThreadProbabilities(1),
+      m_threadProbabilitiesSize(0)
   {
   }
   explicit vpTemplateTrackerMI(vpTemplateTrackerWarp *_warp);
@@ -37,10 +37,25 @@
  * Fabien Spindler
  *
  *****************************************************************************/
+#include <algorithm>
+
 #include <visp3/core/vpException.h>
 #include <visp3/tt_mi/vpTemplateTrackerMI.h>
 #include <visp3/tt_mi/vpTemplateTrackerMIBSpline.h>
 
+#if defined(VISP_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Minimal number of points per thread. Below, zeroing and summing the partial
+// joint probabilities of a thread costs more than filling them.
+const unsigned int minThreadPoints = 1024;
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 void vpTemplateTrackerMI::setBspline(const vpBsplineType &newbs)
 {
   bspline = (int)newbs;
@@ -82,7 +97,8 @@ vpTemplateTrackerMI::vpTemplateTrackerMI(vpTemplateTrackerWarp *_warp)
   : vpTemplateTracker(_warp), hessianComputation(USE_HESSIEN_NORMAL), ApproxHessian(HESSIAN_NEW), lambda(0), temp(NULL),
     Prt(NULL), dPrt(NULL), Pt(NULL), Pr(NULL), d2Prt(NULL), PrtTout(NULL), dprtemp(NULL), PrtD(NULL), dPrtD(NULL),
     influBspline(0), bspline(3), Nc(8), Ncb(0), d2Ix(), d2Iy(), d2Ixy(), MI_preEstimation(0), MI_postEstimation(0),
-    NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false)
+    NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false), m_du(), m_dv(), m_A(),
+    m_dB(), m_d2u(), m_d2v(), m_dA(), m_threadProbabilities(), m_nbThreadProbabilities(1), m_threadProbabilitiesSize(0)
 {
   Ncb = Nc + bspline;
   influBspline = bspline * bspline;
@@ -148,8 +164,6 @@ void vpTemplateTrackerMI::setNc(int nc)
 double vpTemplateTrackerMI::getCost(const vpImage<unsigned char> &I, const vpColVector &tp)
 {
   double MI = 0;
-  int Nbpoint = 0;
-  double IW;
 
   unsigned int Ncb_ = (unsigned int)Ncb;
   unsigned int Nc_ = (unsigned int)Nc;
@@ -158,40 +172,38 @@ double vpTemplateTrackerMI::getCost(const vpImage<unsigned char> &I, const vpCol
   memset(Prt, 0, Ncb_ * Ncb_ * sizeof(double));
   memset(PrtD, 0, Nc_ * Nc_ * influBspline_ * sizeof(double));
 
-  // Warp->ComputeMAtWarp(tp);
-  Warp->computeCoeff(tp);
-  for (unsigned int point = 0; point < templateSize; point++) {
-    X1[0] = ptTemplate[point].x;
-    X1[1] = ptTemplate[point].y;
-
-    Warp->computeDenom(X1, tp);
-    Warp->warpX(X1, X2, tp);
-    double j2 = X2[0];
-    double i2 = X2[1];
-
-    // Tij=Templ[i-(int)Triangle->GetMiny()][j-(int)Triangle->GetMinx()];
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-      Nbpoint++;
-
-      double Tij = ptTemplate[point].val;
-      if (!blur)
-        IW = I.getValue(i2, j2);
-      else
-        IW = BI.getValue(i2, j2);
-
-      double Nc_1 = (Nc - 1.)/255.;
-      double IW_Nc = IW * Nc_1;
-      double Tij_Nc = Tij * Nc_1;
-      int cr = static_cast<int>(IW_Nc);
-      int ct = static_cast<int>(Tij_Nc);
-      double er = IW_Nc - cr;
-      double et = Tij_Nc - ct;
-
-      // Calcul de l'histogramme joint par interpolation bilinÃaire
-      // (Bspline ordre 1)
-      vpTemplateTrackerMIBSpline::PutPVBsplineD(PrtD, cr, er, ct, et, Nc, 1., bspline);
+  const vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  warpTemplateArrays(tp);
+  int Nbpoint = static_cast<int>(sampleTemplateArrays(I, false));
+
+  const unsigned int nbThreads = initThreadProbabilities(pts.size(), Nc_ * Nc_ * influBspline_);
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbThreads > 1)
+#endif
+  for (int thread = 0; thread < static_cast<int>(nbThreads); thread++) {
+    double *PrtD_ = getThreadProbabilities(static_cast<unsigned int>(thread), PrtD);
+    unsigned int begin, end;
+    getThreadRange(static_cast<unsigned int>(thread), pts.size(), begin, end);
+    for (unsigned int point = begin; point < end; point++) {
+      if (pts.inImage[point]) {
+        double Tij = pts.val[point];
+        double IW = pts.IW[point];
+
+        double Nc_1 = (Nc - 1.)/255.;
+        double IW_Nc = IW * Nc_1;
+        double Tij_Nc = Tij * Nc_1;
+        int cr = static_cast<int>(IW_Nc);
+        int ct = static_cast<int>(Tij_Nc);
+        double er = IW_Nc - cr;
+        double et = Tij_Nc - ct;
+
+        // Calcul de l'histogramme joint par interpolation bilinÃaire
+        // (Bspline ordre 1)
+        vpTemplateTrackerMIBSpline::PutPVBsplineD(PrtD_, cr, er, ct, et, Nc, 1., bspline);
+      }
     }
   }
+  reduceThreadProbabilities(0, Nc_ * Nc_ * influBspline_, PrtD);
 
   ratioPixelIn = (double)Nbpoint / (double)templateSize;
 
@@ -598,6 +610,188 @@ void vpTemplateTrackerMI::zeroProbabilities()
   memset(PrtTout, 0, Nc_ * Nc_ * influBspline_ * (1 + nbParam + nbParam * nbParam) * sizeof(double));
 }
 
+/*!
+  Add the contribution of the points of ptTemplateArrays that are inside the
+  image to the joint probabilities #PrtTout. The points have to be warped and
+  sampled before, see warpTemplateArrays() and sampleTemplateArrays().
+
+  \param type : Terms to compute.
+  \param inverse : If false, the template is the reference (r) and the
+  derivatives are given by the gradient of the image at the warped points and
+  by ptTemplateArrays->dWarp. If true, the image is the reference and the
+  derivatives are given by ptTemplateArrays->dW.
+  \param select : If not NULL, only the points flagged in this array are
+  considered.
+
+  The points are shared between the threads, each thread filling its own
+  joint probabilities, see initThreadProbabilities().
+*/
+void vpTemplateTrackerMI::computeJointProbabilities(vpJointProbabilityType type, bool inverse, const bool *select)
+{
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  const unsigned int size =
+      static_cast<unsigned int>(Nc * Nc * influBspline) * (1 + nbParam + nbParam * nbParam);
+  const unsigned int nbThreads = initThreadProbabilities(pts.size(), size);
+
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbThreads > 1)
+#endif
+  for (int thread = 0; thread < static_cast<int>(nbThreads); thread++) {
+    double *PrtTout_ = getThreadProbabilities(static_cast<unsigned int>(thread), PrtTout);
+    unsigned int begin, end;
+    getThreadRange(static_cast<unsigned int>(thread), pts.size(), begin, end);
+
+    int Nc_ = Nc;
+    int bspline_ = bspline;
+    unsigned int nbParam_ = nbParam;
+    std::vector<double> tptemp(nbParam);
+    for (unsigned int point = begin; point < end; point++) {
+      if (!pts.inImage[point] || (select && !select[point])) {
+        continue;
+      }
+
+      // Bins of the image and of the template
+      double IW = pts.IW[point];
+      int ci = static_cast<int>((IW * (Nc - 1)) / 255.);
+      double ei = (IW * (Nc - 1)) / 255. - ci;
+      int cT;
+      double eT;
+      if (ptTemplateSupp) {
+        cT = ptTemplateSupp[point].ct;
+        eT = ptTemplateSupp[point].et;
+      } else {
+        double Tij = pts.val[point];
+        cT = static_cast<int>((Tij * (Nc - 1)) / 255.);
+        eT = (Tij * (Nc - 1)) / 255. - cT;
+      }
+
+      double *val;
+      int cr, ct;
+      double er, et;
+      if (inverse) {
+        cr = ci;
+        er = ei;
+        ct = cT;
+        et = eT;
+        val = &pts.dW[point * pts.dWSize];
+      } else {
+        cr = cT;
+        er = eT;
+        ct = ci;
+        et = ei;
+        double dx = pts.dIWx[point] * (Nc - 1) / 255.;
+        double dy = pts.dIWy[point] * (Nc - 1) / 255.;
+        const double *dW_ = &pts.dWarp[2 * nbParam * point];
+        for (unsigned int it = 0; it < nbParam; it++)
+          tptemp[it] = dW_[it] * dx + dW_[nbParam + it] * dy;
+        val = &tptemp[0];
+      }
+
+      switch (type) {
+      case JOINT_PROBABILITY_SECOND_ORDER:
+        vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout_, cr, er, ct, et, Nc_, val, nbParam_, bspline_);
+        break;
+      case JOINT_PROBABILITY_FIRST_ORDER:
+        vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout_, cr, er, ct, et, Nc_, val, nbParam_, bspline_);
+        break;
+      default:
+        vpTemplateTrackerMIBSpline::PutTotPVBsplinePrtTout(PrtTout_, cr, er, ct, et, Nc_, nbParam_, bspline_);
+      }
+    }
+  }
+
+  reduceThreadProbabilities(0, size, PrtTout);
+}
+
+/*!
+  Get the joint probabilities filled by a thread, see
+  initThreadProbabilities().
+
+  \param thread : Index of the thread.
+  \param probabilities : Joint probabilities of the tracker, used by the
+  first thread.
+  \param offset : Offset of \e probabilities in the partial joint
+  probabilities of a thread, when several tables are filled together.
+*/
+double *vpTemplateTrackerMI::getThreadProbabilities(unsigned int thread, double *probabilities, unsigned int offset)
+{
+  if (thread == 0) {
+    return probabilities;
+  }
+  return &m_threadProbabilities[(thread - 1) * m_threadProbabilitiesSize + offset];
+}
+
+/*!
+  Get the points handled by a thread, see initThreadProbabilities(). The
+  points are split in contiguous ranges, the first thread takes the first
+  points.
+
+  \param thread : Index of the thread.
+  \param nbPoints : Number of points.
+  \param begin : Index of the first point of the thread.
+  \param end : Index after the last point of the thread.
+*/
+void vpTemplateTrackerMI::getThreadRange(unsigned int thread, unsigned int nbPoints, unsigned int &begin,
+                                         unsigned int &end) const
+{
+  begin = static_cast<unsigned int>((static_cast<unsigned long long>(nbPoints) * thread) / m_nbThreadProbabilities);
+  end = static_cast<unsigned int>((static_cast<unsigned long long>(nbPoints) * (thread + 1)) /
+                                  m_nbThreadProbabilities);
+}
+
+/*!
+  Prepare the partial joint probabilities of the threads. The joint
+  probabilities are sums over the points, each thread sums the points of
+  its range into its own tables, that are added afterwards with
+  reduceThreadProbabilities(). The first thread writes directly in the
+  tables of the tracker, the others in zeroed tables of \e size values.
+
+  The number of threads is bounded so that each thread has at least 1024
+  points. The tables are added in the order of the threads, so the result
+  only depends on their number.
+
+  \param nbPoints : Number of points.
+  \param size : Number of values of the tables filled by a thread.
+
+  \return The number of threads.
+*/
+unsigned int vpTemplateTrackerMI::initThreadProbabilities(unsigned int nbPoints, unsigned int size)
+{
+  unsigned int nbThreads = 1;
+#if defined(VISP_HAVE_OPENMP)
+  nbThreads = std::min(static_cast<unsigned int>(omp_get_max_threads()), nbPoints / minThreadPoints);
+  nbThreads = std::max(nbThreads, 1u);
+#else
+  (void)nbPoints;
+#endif
+  m_nbThreadProbabilities = nbThreads;
+  m_threadProbabilitiesSize = size;
+  m_threadProbabilities.assign((nbThreads - 1) * size, 0.);
+
+  return nbThreads;
+}
+
+/*!
+  Add the partial joint probabilities of the threads to the ones of the
+  tracker, see initThreadProbabilities().
+
+  \param offset : Offset of the table in the partial joint probabilities of
+  a thread.
+  \param size : Number of values of the table.
+  \param probabilities : Joint probabilities of the tracker, filled by the
+  first thread.
+*/
+void vpTemplateTrackerMI::reduceThreadProbabilities(unsigned int offset, unsigned int size,
+                                                    double *probabilities) const
+{
+  for (unsigned int thread = 1; thread < m_nbThreadProbabilities; thread++) {
+    const double *partial = &m_threadProbabilities[(thread - 1) * m_threadProbabilitiesSize + offset];
+    for (unsigned int i = 0; i < size; i++) {
+      probabilities[i] += partial[i];
+    }
+  }
+}
+
 double vpTemplateTrackerMI::getMI(const vpImage<unsigned char> &I, int &nc, const int &bspline_, vpColVector &tp)
 {
   unsigned int tNcb = static_cast<unsigned int>(nc + bspline_);
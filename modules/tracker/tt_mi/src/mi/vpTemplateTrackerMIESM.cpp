@@ -40,10 +40,6 @@
 
 #include <visp3/tt_mi/vpTemplateTrackerMIESM.h>
 
-#ifdef VISP_HAVE_OPENMP
-#include <omp.h>
-#endif
-
 vpTemplateTrackerMIESM::vpTemplateTrackerMIESM(vpTemplateTrackerWarp *_warp)
   : vpTemplateTrackerMI(_warp), minimizationMethod(USE_NEWTON), CompoInitialised(false), HDirect(), HInverse(),
     HdesireDirect(), HdesireInverse(), GDirect(), GInverse()
@@ -62,52 +58,17 @@ void vpTemplateTrackerMIESM::initHessienDesired(const vpImage<unsigned char> &I)
 
   dW = 0;
 
-  int Nbpoint = 0;
-
-  double i2, j2;
-  double IW, dx, dy;
-  int i, j;
-  int cr, ct;
-  double er, et;
-
-  Nbpoint = 0;
-
   if (blur)
     vpImageFilter::filter(I, BI, fgG, taillef);
 
-  zeroProbabilities();
-
-  vpColVector tptemp(nbParam);
-
-  Warp->computeCoeff(p);
-  for (unsigned int point = 0; point < templateSize; point++) {
-    i = ptTemplate[point].y;
-    j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-
-    Warp->computeDenom(X1, p);
-    Warp->warpX(X1, X2, p);
-
-    j2 = X2[0];
-    i2 = X2[1];
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  vpJointProbabilityType type =
+      (ApproxHessian == HESSIAN_NONSECOND) ? JOINT_PROBABILITY_FIRST_ORDER : JOINT_PROBABILITY_SECOND_ORDER;
 
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-      Nbpoint++;
-
-      if (blur)
-        IW = BI.getValue(i2,j2);
-      else
-        IW = I.getValue(i2,j2);
-
-      ct = ptTemplateSupp[point].ct;
-      et = ptTemplateSupp[point].et;
-      cr = static_cast<int>((IW*(Nc-1))/255.);
-      er = (IW*(Nc-1))/255.-cr;
-
-      vpTemplateTrackerMIBSpline::computeProbabilities(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam, bspline, ApproxHessian, false);
-    }
-  }
+  zeroProbabilities();
+  warpTemplateArrays(p);
+  int Nbpoint = static_cast<int>(sampleTemplateArrays(I, false));
+  computeJointProbabilities(type, true);
 
   double MI;
   computeProba(Nbpoint);
@@ -123,45 +84,13 @@ void vpTemplateTrackerMIESM::initHessienDesired(const vpImage<unsigned char> &I)
     vpImageFilter::getGradY(dIy, d2Iy, fgdG, taillef);
   }
 
-  Nbpoint = 0;
   zeroProbabilities();
-
-  Warp->computeCoeff(p);
-  for (unsigned int point = 0; point < templateSize; point++) {
-    i = ptTemplate[point].y;
-    j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-
-    Warp->computeDenom(X1, p);
-    Warp->warpX(X1, X2, p);
-
-    j2 = X2[0];
-    i2 = X2[1];
-
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight()) && (j2 < I.getWidth())) {
-      Nbpoint++;
-
-      if(!blur)
-        IW=I.getValue(i2,j2);
-      else
-        IW=BI.getValue(i2,j2);
-
-      dx = dIx.getValue(i2, j2) * (Nc - 1) / 255.;
-      dy = dIy.getValue(i2, j2) * (Nc - 1) / 255.;
-
-      cr = ptTemplateSupp[point].ct;
-      er = ptTemplateSupp[point].et;
-      ct = static_cast<int>((IW*(Nc-1))/255.);
-      et = (IW*(Nc-1))/255.-ct;
-
-      Warp->dWarpCompo(X1, X2, p, ptTemplateCompo[point].dW, dW);
-
-      for (unsigned int it = 0; it < nbParam; it++)
-        tptemp[it] = dW[0][it] * dx + dW[1][it] * dy;
-
-      vpTemplateTrackerMIBSpline::computeProbabilities(PrtTout, cr, er, ct, et, Nc, tptemp.data, nbParam, bspline, ApproxHessian, false);
-    }
+  Nbpoint = static_cast<int>(sampleTemplateArrays(I, true));
+  if (Nbpoint > 0) {
+    pts.dWarp.resize(2 * nbParam * pts.size());
+    Warp->dWarpCompoPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dWCompo[0],
+                           &pts.dWarp[0]);
+    computeJointProbabilities(type, false);
   }
 
   computeProba(Nbpoint);
@@ -215,6 +144,7 @@ void vpTemplateTrackerMIESM::initCompInverse()
       ptTemplateSupp[point].dBt[it + 1] = vpTemplateTrackerMIBSpline::dBspline4(-it + et);
     }
   }
+  initTemplateArrays(nbParam, 0, 2 * nbParam);
   CompoInitialised = true;
 }
 
@@ -226,28 +156,22 @@ void vpTemplateTrackerMIESM::trackNoPyr(const vpImage<unsigned char> &I)
   dW = 0;
 
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
-
-  int point;
+    getGaussianBluredImage(I);
+  getGaussianGradients(I);
 
   MI_preEstimation = -getCost(I, p);
 
   lambda = lambdaDep;
 
-  double i2, j2;
-  double IW;
-  int cr, ct;
-  double er, et;
-
   vpColVector dpinv(nbParam);
 
   double alpha = 2.;
 
-  int i, j;
   unsigned int iteration = 0;
-  vpColVector tptemp(nbParam);
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  vpJointProbabilityType type = (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == USE_HESSIEN_DESIRE)
+                                    ? JOINT_PROBABILITY_FIRST_ORDER
+                                    : JOINT_PROBABILITY_SECOND_ORDER;
 
   do {
     int Nbpoint = 0;
@@ -257,35 +181,9 @@ void vpTemplateTrackerMIESM::trackNoPyr(const vpImage<unsigned char> &I)
 
     /////////////////////////////////////////////////////////////////////////
     // Inverse
-    Warp->computeCoeff(p);
-    for (point = 0; point < static_cast<int>(templateSize); point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Nbpoint++;
-
-        if(!blur)
-          IW=I.getValue(i2,j2);
-        else
-          IW=BI.getValue(i2,j2);
-
-        ct = ptTemplateSupp[point].ct;
-        et = ptTemplateSupp[point].et;
-        cr = static_cast<int>((IW*(Nc-1))/255.);
-        er = (IW*(Nc-1))/255.-cr;
-
-        vpTemplateTrackerMIBSpline::computeProbabilities(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam, bspline, ApproxHessian, hessianComputation==USE_HESSIEN_DESIRE);
-      }
-    }
+    warpTemplateArrays(p);
+    Nbpoint = static_cast<int>(sampleTemplateArrays(I, true));
+    computeJointProbabilities(type, true);
 
     if (Nbpoint == 0) {
       diverge = true;
@@ -303,52 +201,14 @@ void vpTemplateTrackerMIESM::trackNoPyr(const vpImage<unsigned char> &I)
       /////////////////////////////////////////////////////////////////////////
       // DIRECT
 
-      Nbpoint = 0;
       MI = 0;
 
       zeroProbabilities();
 
-      Warp->computeCoeff(p);
-#ifdef VISP_HAVE_OPENMP
-      int nthreads = omp_get_num_procs();
-      // std::cout << "file: " __FILE__ << " line: " << __LINE__ << "
-      // function: " << __FUNCTION__ << " nthread: " << nthreads << std::endl;
-      omp_set_num_threads(nthreads);
-#pragma omp parallel for private(point, i, j, i2, j2) default(shared)
-#endif
-      for (point = 0; point < static_cast<int>(templateSize); point++) {
-        i = ptTemplate[point].y;
-        j = ptTemplate[point].x;
-        X1[0] = j;
-        X1[1] = i;
-        Warp->computeDenom(X1, p);
-        Warp->warpX(i, j, i2, j2, p);
-        X2[0] = j2;
-        X2[1] = i2;
-
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-          Nbpoint++;
-
-          if(!blur)
-            IW=I.getValue(i2,j2);
-          else
-            IW=BI.getValue(i2,j2);
-
-          double dx = dIx.getValue(i2, j2) * (Nc - 1) / 255.;
-          double dy = dIy.getValue(i2, j2) * (Nc - 1) / 255.;
-
-          ct = static_cast<int>((IW*(Nc-1))/255.);
-          et = (IW*(Nc-1))/255.-ct;
-          cr = ptTemplateSupp[point].ct;
-          er = ptTemplateSupp[point].et;
-          Warp->dWarpCompo(X1, X2, p, ptTemplateCompo[point].dW, dW);
-
-          for (unsigned int it = 0; it < nbParam; it++)
-            tptemp[it] = dW[0][it] * dx + dW[1][it] * dy;
-
-          vpTemplateTrackerMIBSpline::computeProbabilities(PrtTout,cr, er, ct, et, Nc, tptemp.data, nbParam, bspline, ApproxHessian, hessianComputation==USE_HESSIEN_DESIRE);
-        }
-      }
+      pts.dWarp.resize(2 * nbParam * pts.size());
+      Warp->dWarpCompoPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dWCompo[0],
+                             &pts.dWarp[0]);
+      computeJointProbabilities(type, false);
 
       computeProba(Nbpoint);
       computeMI(MI);
@@ -40,10 +40,6 @@
 
 #include <visp3/tt_mi/vpTemplateTrackerMIForwardAdditional.h>
 
-#ifdef VISP_HAVE_OPENMP
-#include <omp.h>
-#endif
-
 vpTemplateTrackerMIForwardAdditional::vpTemplateTrackerMIForwardAdditional(vpTemplateTrackerWarp *_warp)
   : vpTemplateTrackerMI(_warp), minimizationMethod(USE_NEWTON), p_prec(), G_prec(), KQuasiNewton()
 {
@@ -61,57 +57,22 @@ void vpTemplateTrackerMIForwardAdditional::initHessienDesired(const vpImage<unsi
   vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
   vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
 
-  double Tij;
-  double IW, dx, dy;
-  int cr, ct;
-  double er, et;
-
-  Nbpoint = 0;
+  if (ptTemplateArrays == NULL) {
+    initTemplateArrays(0, 0, 0);
+  }
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
 
   zeroProbabilities();
-  Warp->computeCoeff(p);
-  for (unsigned int point = 0; point < templateSize; point++) {
-    int i = ptTemplate[point].y;
-    int j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-    X2[0] = j;
-    X2[1] = i;
-
-    Warp->computeDenom(X1, p);
-    Warp->warpX(X1, X2, p);
-
-    double j2 = X2[0];
-    double i2 = X2[1];
-
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-      Nbpoint++;
-      Tij = ptTemplate[point].val;
-      if (!blur)
-        IW = I.getValue(i2, j2);
-      else
-        IW = BI.getValue(i2, j2);
-
-      dx = dIx.getValue(i2, j2) * (Nc - 1) / 255.;
-      dy = dIy.getValue(i2, j2) * (Nc - 1) / 255.;
-
-      ct = static_cast<int>((IW * (Nc - 1)) / 255.);
-      cr = static_cast<int>((Tij * (Nc - 1)) / 255.);
-      et = (IW * (Nc - 1)) / 255. - ct;
-      er = (static_cast<double>(Tij) * (Nc - 1)) / 255. - cr;
-      Warp->dWarp(X1, X2, p, dW);
-
-      double *tptemp = new double[nbParam];
-      for (unsigned int it = 0; it < nbParam; it++)
-        tptemp[it] = dW[0][it] * dx + dW[1][it] * dy;
-
-      if (ApproxHessian == HESSIAN_NONSECOND)
-        vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-      else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
-        vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
+  warpTemplateArrays(p);
+  Nbpoint = static_cast<int>(sampleTemplateArrays(I, true));
+  if (Nbpoint > 0) {
+    pts.dWarp.resize(2 * nbParam * pts.size());
+    Warp->dWarpPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dWarp[0]);
 
-      delete[] tptemp;
-    }
+    if (ApproxHessian == HESSIAN_NONSECOND)
+      computeJointProbabilities(JOINT_PROBABILITY_FIRST_ORDER, false);
+    else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
+      computeJointProbabilities(JOINT_PROBABILITY_SECOND_ORDER, false);
   }
 
   if (Nbpoint > 0) {
@@ -135,9 +96,8 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
 
   int Nbpoint = 0;
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+    getGaussianBluredImage(I);
+  getGaussianGradients(I);
 
   double MI = 0, MIprec = -1000;
 
@@ -161,57 +121,17 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
     // erreur=0;
 
     zeroProbabilities();
-
-    Warp->computeCoeff(p);
-#ifdef VISP_HAVE_OPENMP
-    int nthreads = omp_get_num_procs();
-    // std::cout << "file: " __FILE__ << " line: " << __LINE__ << " function:
-    // " << __FUNCTION__ << " nthread: " << nthreads << std::endl;
-    omp_set_num_threads(nthreads);
-#pragma omp parallel for default(shared)
-#endif
-    for (int point = 0; point < (int)templateSize; point++) {
-      int i = ptTemplate[point].y;
-      int j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      double j2 = X2[0];
-      double i2 = X2[1];
-
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Nbpoint++;
-        double Tij = ptTemplate[point].val;
-        double IW;
-        if (!blur)
-          IW = I.getValue(i2, j2);
-        else
-          IW = BI.getValue(i2, j2);
-
-        double dx = dIx.getValue(i2, j2) * (Nc - 1) / 255.;
-        double dy = dIy.getValue(i2, j2) * (Nc - 1) / 255.;
-
-        int ct = (int)((IW * (Nc - 1)) / 255.);
-        int cr = (int)((Tij * (Nc - 1)) / 255.);
-        double et = (IW * (Nc - 1)) / 255. - ct;
-        double er = ((double)Tij * (Nc - 1)) / 255. - cr;
-
-        Warp->dWarp(X1, X2, p, dW);
-
-        double *tptemp = new double[nbParam];
-        ;
-        for (unsigned int it = 0; it < nbParam; it++)
-          tptemp[it] = (dW[0][it] * dx + dW[1][it] * dy);
-        if (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
-          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-        else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
-          vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-        delete[] tptemp;
-      }
+    warpTemplateArrays(p);
+    Nbpoint = static_cast<int>(sampleTemplateArrays(I, true));
+    if (Nbpoint > 0) {
+      vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+      pts.dWarp.resize(2 * nbParam * pts.size());
+      Warp->dWarpPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dWarp[0]);
+
+      if (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
+        computeJointProbabilities(JOINT_PROBABILITY_FIRST_ORDER, false);
+      else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
+        computeJointProbabilities(JOINT_PROBABILITY_SECOND_ORDER, false);
     }
 
     if (Nbpoint == 0) {
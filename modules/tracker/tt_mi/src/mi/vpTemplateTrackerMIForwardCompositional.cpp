@@ -68,6 +68,7 @@ void vpTemplateTrackerMIForwardCompositional::initCompo()
       ptTemplateSupp[point].dBt[it + 1] = vpTemplateTrackerMIBSpline::dBspline4(-it + et);
     }
   }
+  initTemplateArrays(2 * nbParam, 0, 0);
   CompoInitialised = true;
 }
 void vpTemplateTrackerMIForwardCompositional::initHessienDesired(const vpImage<unsigned char> &I)
@@ -81,54 +82,15 @@ void vpTemplateTrackerMIForwardCompositional::initHessienDesired(const vpImage<u
   vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
   vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
 
-  int Nbpoint = 0;
-
-  double IW, dx, dy;
-  int cr, ct;
-  double er, et;
-
-  Nbpoint = 0;
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
 
   zeroProbabilities();
-
-  Warp->computeCoeff(p);
-  for (unsigned int point = 0; point < templateSize; point++) {
-    int i = ptTemplate[point].y;
-    int j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-
-    Warp->computeDenom(X1, p);
-    Warp->warpX(X1, X2, p);
-
-    double j2 = X2[0];
-    double i2 = X2[1];
-
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-      Nbpoint++;
-      if (!blur)
-        IW = I.getValue(i2, j2);
-      else
-        IW = BI.getValue(i2, j2);
-
-      dx = dIx.getValue(i2, j2) * (Nc - 1) / 255.;
-      dy = dIy.getValue(i2, j2) * (Nc - 1) / 255.;
-
-      cr = ptTemplateSupp[point].ct;
-      er = ptTemplateSupp[point].et;
-      ct = (int)((IW * (Nc - 1)) / 255.);
-      et = ((double)IW * (Nc - 1)) / 255. - ct;
-
-      Warp->dWarpCompo(X1, X2, p, ptTemplate[point].dW, dW);
-
-      double *tptemp = new double[nbParam];
-      for (unsigned int it = 0; it < nbParam; it++)
-        tptemp[it] = dW[0][it] * dx + dW[1][it] * dy;
-
-      vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-      delete[] tptemp;
-    }
+  warpTemplateArrays(p);
+  int Nbpoint = static_cast<int>(sampleTemplateArrays(I, true));
+  if (Nbpoint > 0) {
+    pts.dWarp.resize(2 * nbParam * pts.size());
+    Warp->dWarpCompoPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dW[0], &pts.dWarp[0]);
+    computeJointProbabilities(JOINT_PROBABILITY_SECOND_ORDER, false);
   }
   double MI;
   computeProba(Nbpoint);
@@ -149,10 +111,9 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
   dW = 0;
 
   if (blur) {
-    vpImageFilter::filter(I, BI, fgG, taillef);
+    getGaussianBluredImage(I);
   }
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+  getGaussianGradients(I);
 
   lambda = lambdaDep;
   double MI = 0, MIprec = -1000;
@@ -161,69 +122,32 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
 
   initPosEvalRMS(p);
 
-  double i2, j2;
-  double IW;
-  int cr, ct;
-  double er, et;
-  double dx, dy;
-
   vpColVector dpinv(nbParam);
   double alpha = 2.;
 
-  int i, j;
   unsigned int iteration = 0;
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
 
   double evolRMS_init = 0;
   double evolRMS_prec = 0;
   double evolRMS_delta;
 
   do {
-    int Nbpoint = 0;
     MIprec = MI;
     MI = 0;
 
     zeroProbabilities();
-
-    Warp->computeCoeff(p);
-
-    for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-      Warp->warpX(i, j, i2, j2, p);
-      X2[0] = j2;
-      X2[1] = i2;
-
-      Warp->computeDenom(X1, p);
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Nbpoint++;
-        if (!blur)
-          IW = I.getValue(i2, j2);
-        else
-          IW = BI.getValue(i2, j2);
-
-        dx = dIx.getValue(i2, j2) * (Nc - 1) / 255.;
-        dy = dIy.getValue(i2, j2) * (Nc - 1) / 255.;
-
-        ct = (int)((IW * (Nc - 1)) / 255.);
-        et = ((double)IW * (Nc - 1)) / 255. - ct;
-        cr = ptTemplateSupp[point].ct;
-        er = ptTemplateSupp[point].et;
-
-        Warp->dWarpCompo(X1, X2, p, ptTemplate[point].dW, dW);
-
-        double *tptemp = new double[nbParam];
-        for (unsigned int it = 0; it < nbParam; it++)
-          tptemp[it] = dW[0][it] * dx + dW[1][it] * dy;
-
-        if (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
-          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-        else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
-          vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-        delete[] tptemp;
-      }
+    warpTemplateArrays(p);
+    int Nbpoint = static_cast<int>(sampleTemplateArrays(I, true));
+    if (Nbpoint > 0) {
+      pts.dWarp.resize(2 * nbParam * pts.size());
+      Warp->dWarpCompoPoints(&pts.x[0], &pts.y[0], &pts.x2[0], &pts.y2[0], pts.size(), p, &pts.dW[0],
+                             &pts.dWarp[0]);
+
+      if (ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
+        computeJointProbabilities(JOINT_PROBABILITY_FIRST_ORDER, false);
+      else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
+        computeJointProbabilities(JOINT_PROBABILITY_SECOND_ORDER, false);
     }
     if (Nbpoint == 0) {
       diverge = true;
@@ -117,6 +117,7 @@ void vpTemplateTrackerMIInverseCompositional::initCompInverse(const vpImage<unsi
     ptTemplateSupp[point].et = et;
     ptTemplateSupp[point].ct = ct;
   }
+  initTemplateArrays(nbParam, 0, 0);
   CompoInitialised = true;
 }
 
@@ -124,59 +125,20 @@ void vpTemplateTrackerMIInverseCompositional::initHessienDesired(const vpImage<u
 {
   initCompInverse(I);
 
-  int Nbpoint = 0;
-
-  double IW;
-  int cr, ct;
-  double er, et;
-
-  Nbpoint = 0;
-
   if (blur)
     vpImageFilter::filter(I, BI, fgG, taillef);
 
   zeroProbabilities();
-  Warp->computeCoeff(p);
+  warpTemplateArrays(p);
+  int Nbpoint = static_cast<int>(sampleTemplateArrays(I, false));
 
-  for (unsigned int point = 0; point < templateSize; point++) {
-    int i = ptTemplate[point].y;
-    int j = ptTemplate[point].x;
-    X1[0] = j;
-    X1[1] = i;
-
-    Warp->computeDenom(X1, p);
-    Warp->warpX(X1, X2, p);
-
-    double j2 = X2[0];
-    double i2 = X2[1];
-
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-      Nbpoint++;
-
-      if (blur)
-        IW = BI.getValue(i2, j2);
-      else
-        IW = I.getValue(i2, j2);
-
-      ct = ptTemplateSupp[point].ct;
-      et = ptTemplateSupp[point].et;
-      cr = static_cast<int>((IW * (Nc - 1)) / 255.);
-      er = (IW * (Nc - 1)) / 255. - cr;
-
-      if (ApproxHessian == HESSIAN_NONSECOND && (ptTemplateSelect[point] || !useTemplateSelect)) {
-        vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam,
-                                                            bspline);
-      } else if ((ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW) &&
-                 (ptTemplateSelect[point] || !useTemplateSelect)) {
-        if (bspline == 3) {
-          vpTemplateTrackerMIBSpline::PutTotPVBspline3(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam);
-        } else {
-          vpTemplateTrackerMIBSpline::PutTotPVBspline4(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam);
-        }
-      } else if (ptTemplateSelect[point] || !useTemplateSelect)
-        vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(PrtTout, cr, er, ct, et, Nc, nbParam, bspline);
-    }
-  }
+  const bool *select = useTemplateSelect ? ptTemplateSelect : NULL;
+  if (ApproxHessian == HESSIAN_NONSECOND)
+    computeJointProbabilities(JOINT_PROBABILITY_FIRST_ORDER, true, select);
+  else if (ApproxHessian == HESSIAN_0 || ApproxHessian == HESSIAN_NEW)
+    computeJointProbabilities(JOINT_PROBABILITY_SECOND_ORDER, true, select);
+  else
+    computeJointProbabilities(JOINT_PROBABILITY, true, select);
 
   double MI;
   computeProba(Nbpoint);
@@ -200,7 +162,7 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
   dW = 0;
 
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
+    getGaussianBluredImage(I);
 
   lambda = lambdaDep;
   double MI = 0, MIprec = -1000;
@@ -226,57 +188,63 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
   vpColVector dpinv_test_LMA(nbParam);
   vpColVector p_test_LMA(nbParam);
 
+  vpTemplateTrackerPointArrays &pts = *ptTemplateArrays;
+  const unsigned int Ncb2 = static_cast<unsigned int>(Ncb * Ncb);
+
   do {
-    int Nbpoint = 0;
     MIprec = MI;
     MI = 0;
 
     zeroProbabilities();
-
-    Warp->computeCoeff(p);
-
-    for (int point = 0; point < static_cast<int>(templateSize); point++) {
-      X1[0] = static_cast<double>(ptTemplate[point].x);
-      X1[1] = static_cast<double>(ptTemplate[point].y);
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      double j2 = X2[0];
-      double i2 = X2[1];
-
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-
-        Nbpoint++;
-        double IW;
-        if (!blur)
-          IW = static_cast<double>(I.getValue(i2, j2));
-        else
-          IW = BI.getValue(i2, j2);
+    warpTemplateArrays(p);
+    int Nbpoint = static_cast<int>(sampleTemplateArrays(I, false));
+
+    // Each thread fills its own Prt, dPrt and d2Prt, stored contiguously
+    const unsigned int nbThreads = initThreadProbabilities(pts.size(), Ncb2 * (1 + nbParam + nbParam * nbParam));
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static) if (nbThreads > 1)
+#endif
+    for (int thread = 0; thread < static_cast<int>(nbThreads); thread++) {
+      double *Prt_ = getThreadProbabilities(static_cast<unsigned int>(thread), Prt);
+      double *dPrt_ = getThreadProbabilities(static_cast<unsigned int>(thread), dPrt, Ncb2);
+      double *d2Prt_ = getThreadProbabilities(static_cast<unsigned int>(thread), d2Prt, Ncb2 * (1 + nbParam));
+      unsigned int begin, end;
+      getThreadRange(static_cast<unsigned int>(thread), pts.size(), begin, end);
+
+      int Ncb_ = Ncb;
+      int bspline_ = bspline;
+      unsigned int nbParam_ = nbParam;
+      for (unsigned int point = begin; point < end; point++) {
+        if (!pts.inImage[point]) {
+          continue;
+        }
+        double IW = pts.IW[point];
 
         int ct = ptTemplateSupp[point].ct;
         double et = ptTemplateSupp[point].et;
         double tmp = IW * (static_cast<double>(Nc) - 1.) / 255.;
         int cr = static_cast<int>(tmp);
         double er = tmp - static_cast<double>(cr);
+        double *dW_ = &pts.dW[point * nbParam];
 
         if ((ApproxHessian == HESSIAN_NONSECOND || hessianComputation == vpTemplateTrackerMI::USE_HESSIEN_DESIRE) &&
             (ptTemplateSelect[point] || !useTemplateSelect)) {
-          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(Prt, dPrt, cr, er, ct, et, Ncb, ptTemplate[point].dW,
-                                                              nbParam, bspline);
+          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(Prt_, dPrt_, cr, er, ct, et, Ncb_, dW_, nbParam_,
+                                                              bspline_);
         } else if (ptTemplateSelect[point] || !useTemplateSelect) {
           if (bspline == 3) {
-            vpTemplateTrackerMIBSpline::PutTotPVBspline3(Prt, dPrt, d2Prt, cr, er, ct, et, Ncb,
-                                                         ptTemplate[point].dW, nbParam);
+            vpTemplateTrackerMIBSpline::PutTotPVBspline3(Prt_, dPrt_, d2Prt_, cr, er, ct, et, Ncb_, dW_, nbParam_);
           } else {
-            vpTemplateTrackerMIBSpline::PutTotPVBspline4(Prt, dPrt, d2Prt, cr, er, ct, et, Ncb,
-                                                         ptTemplate[point].dW, nbParam);
+            vpTemplateTrackerMIBSpline::PutTotPVBspline4(Prt_, dPrt_, d2Prt_, cr, er, ct, et, Ncb_, dW_, nbParam_);
           }
         } else {
-          vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(Prt, cr, er, ct, et, Ncb, nbParam, bspline);
+          vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(Prt_, cr, er, ct, et, Ncb_, nbParam_, bspline_);
         }
       }
     }
+    reduceThreadProbabilities(0, Ncb2, Prt);
+    reduceThreadProbabilities(Ncb2, Ncb2 * nbParam, dPrt);
+    reduceThreadProbabilities(Ncb2 * (1 + nbParam), Ncb2 * nbParam * nbParam, d2Prt);
 
     if (Nbpoint == 0) {
       diverge = true;
@@ -735,12 +735,13 @@ void vpTemplateTrackerMIBSpline::PutTotPVBspline4PrtTout(double *PrtTout, int &c
 void vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(double *Prt, int &cr, double &er, int &ct, double &et, int &Ncb,
                                                     unsigned int &NbParam, int &degree)
 {
+  (void)NbParam;
   switch (degree) {
   case 4:
-    PutTotPVBspline4PrtTout(Prt, cr, er, ct, et, Ncb, NbParam);
+    PutTotPVBspline4Prt(Prt, cr, er, ct, et, Ncb);
     break;
   default:
-    PutTotPVBspline3PrtTout(Prt, cr, er, ct, et, Ncb, NbParam);
+    PutTotPVBspline3Prt(Prt, cr, er, ct, et, Ncb);
   }
 }
 
@@ -0,0 +1,281 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Track a synthetic sequence with the mutual information template trackers
+ * and report the time per frame.
+ *
+ *****************************************************************************/
+
+/*!
+  \example perfTemplateTrackerMI.cpp
+
+  \brief Track a canned synthetic sequence with the forward additional,
+  forward compositional, inverse compositional and ESM mutual information
+  template trackers, and with the SSD forward compositional tracker as a
+  reference. The mean time per frame and the final error of the warped
+  template corners are printed.
+
+  The sequence is rendered from a procedural texture moved by an affine
+  transformation. Use \c --benchmark to also time the whole sequences.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_CATCH2) && defined(VISP_HAVE_MODULE_TT_MI)
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_RUNNER
+#include <catch.hpp>
+
+#include <algorithm>
+#include <iomanip>
+
+#include <visp3/core/vpTime.h>
+#include <visp3/tt/vpTemplateTrackerSSDForwardCompositional.h>
+#include <visp3/tt/vpTemplateTrackerWarpAffine.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomographySL3.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIESM.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIForwardAdditional.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIForwardCompositional.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIInverseCompositional.h>
+
+#if defined(VISP_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+namespace
+{
+bool g_runBenchmark = false;
+int g_nbFrames = 10;
+int g_templateSize = 100;
+
+const unsigned int height = 240;
+const unsigned int width = 320;
+
+typedef enum { SSD_FORWARD_COMPOSITIONAL, MI_FORWARD_ADDITIONAL, MI_FORWARD_COMPOSITIONAL, MI_INVERSE_COMPOSITIONAL, MI_ESM } vpTrackerType;
+
+// Affine transformation of the frame k, about the center of the image
+void motion(int k, double A[2][3])
+{
+  const double a = 0.01 * k, s = 1. + 0.005 * k;
+  const double tx = 1.5 * k, ty = -1. * k;
+  A[0][0] = s * cos(a);
+  A[0][1] = -s * sin(a);
+  A[1][0] = s * sin(a);
+  A[1][1] = s * cos(a);
+  A[0][2] = width / 2. + tx - A[0][0] * width / 2. - A[0][1] * height / 2.;
+  A[1][2] = height / 2. + ty - A[1][0] * width / 2. - A[1][1] * height / 2.;
+}
+
+double texture(double u, double v)
+{
+  return 128 + 50 * sin(u * 0.11) * cos(v * 0.07) + 40 * sin((u + 2 * v) * 0.05) + 20 * cos(u * 0.3 - v * 0.2);
+}
+
+// Frame k: the texture seen through the inverse of the transformation
+void render(int k, vpImage<unsigned char> &I)
+{
+  double A[2][3];
+  motion(k, A);
+  const double det = A[0][0] * A[1][1] - A[0][1] * A[1][0];
+
+  I.resize(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      const double x = j - A[0][2], y = i - A[1][2];
+      const double u = (A[1][1] * x - A[0][1] * y) / det;
+      const double v = (-A[1][0] * x + A[0][0] * y) / det;
+      I[i][j] = static_cast<unsigned char>(std::max(0., std::min(255., texture(u, v))));
+    }
+  }
+}
+
+std::string trackerName(vpTrackerType type)
+{
+  switch (type) {
+  case SSD_FORWARD_COMPOSITIONAL:
+    return "SSD forward compositional";
+  case MI_FORWARD_ADDITIONAL:
+    return "MI forward additional";
+  case MI_FORWARD_COMPOSITIONAL:
+    return "MI forward compositional";
+  case MI_INVERSE_COMPOSITIONAL:
+    return "MI inverse compositional";
+  default:
+    return "MI ESM";
+  }
+}
+
+vpTemplateTracker *createTracker(vpTrackerType type, vpTemplateTrackerWarp *warp)
+{
+  switch (type) {
+  case SSD_FORWARD_COMPOSITIONAL:
+    return new vpTemplateTrackerSSDForwardCompositional(warp);
+  case MI_FORWARD_ADDITIONAL:
+    return new vpTemplateTrackerMIForwardAdditional(warp);
+  case MI_FORWARD_COMPOSITIONAL:
+    return new vpTemplateTrackerMIForwardCompositional(warp);
+  case MI_INVERSE_COMPOSITIONAL:
+    return new vpTemplateTrackerMIInverseCompositional(warp);
+  default:
+    return new vpTemplateTrackerMIESM(warp);
+  }
+}
+
+struct vpSequenceResult {
+  // Mean time of track() in ms
+  double meanTime;
+  // Largest distance in pixel between the warped corners of the template and the true ones, at the last frame
+  double error;
+};
+
+vpSequenceResult trackSequence(vpTrackerType type, const std::vector<vpImage<unsigned char> > &frames)
+{
+  // The ESM needs a warp defined on a Lie group, the affine motion is a particular homography
+  vpTemplateTrackerWarp *warp = NULL;
+  if (type == MI_ESM) {
+    warp = new vpTemplateTrackerWarpHomographySL3;
+  } else {
+    warp = new vpTemplateTrackerWarpAffine;
+  }
+  vpTemplateTracker *tracker = createTracker(type, warp);
+  tracker->setSampling(2, 2);
+  tracker->setLambda(0.001);
+  tracker->setIterationMax(30);
+  tracker->setPyramidal(2, 1);
+
+  const double half = g_templateSize / 2.;
+  const double ci = height / 2., cj = width / 2.;
+  std::vector<vpImagePoint> corners;
+  corners.push_back(vpImagePoint(ci - half, cj - half));
+  corners.push_back(vpImagePoint(ci + half, cj - half));
+  corners.push_back(vpImagePoint(ci + half, cj + half));
+  corners.push_back(vpImagePoint(ci - half, cj + half));
+
+  std::vector<vpImagePoint> triangles;
+  triangles.push_back(corners[0]);
+  triangles.push_back(corners[1]);
+  triangles.push_back(corners[2]);
+  triangles.push_back(corners[0]);
+  triangles.push_back(corners[2]);
+  triangles.push_back(corners[3]);
+  tracker->initFromPoints(frames[0], triangles);
+
+  vpSequenceResult result;
+  result.meanTime = 0;
+  for (size_t k = 1; k < frames.size(); k++) {
+    double t = vpTime::measureTimeMs();
+    tracker->track(frames[k]);
+    result.meanTime += vpTime::measureTimeMs() - t;
+  }
+  result.meanTime /= std::max(static_cast<double>(frames.size()) - 1., 1.);
+
+  double A[2][3];
+  motion(static_cast<int>(frames.size()) - 1, A);
+  vpColVector p = tracker->getp();
+  warp->computeCoeff(p);
+  result.error = 0;
+  for (size_t c = 0; c < corners.size(); c++) {
+    vpColVector X1(2), X2(2);
+    X1[0] = corners[c].get_j();
+    X1[1] = corners[c].get_i();
+    warp->computeDenom(X1, p);
+    warp->warpX(X1, X2, p);
+    const double j = A[0][0] * X1[0] + A[0][1] * X1[1] + A[0][2];
+    const double i = A[1][0] * X1[0] + A[1][1] * X1[1] + A[1][2];
+    result.error = std::max(result.error, sqrt(vpMath::sqr(X2[0] - j) + vpMath::sqr(X2[1] - i)));
+  }
+
+  delete tracker;
+  delete warp;
+  return result;
+}
+}
+
+TEST_CASE("Track a synthetic sequence with the MI template trackers", "[benchmark]")
+{
+  std::vector<vpImage<unsigned char> > frames(static_cast<size_t>(std::max(g_nbFrames, 2)));
+  for (size_t k = 0; k < frames.size(); k++) {
+    render(static_cast<int>(k), frames[k]);
+  }
+
+#if defined(VISP_HAVE_OPENMP)
+  std::cout << "OpenMP threads: " << omp_get_max_threads() << std::endl;
+#endif
+
+  const vpTrackerType types[] = {SSD_FORWARD_COMPOSITIONAL, MI_FORWARD_ADDITIONAL, MI_FORWARD_COMPOSITIONAL,
+                                 MI_INVERSE_COMPOSITIONAL, MI_ESM};
+  for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+    const std::string name = trackerName(types[i]);
+    vpSequenceResult result = trackSequence(types[i], frames);
+    std::cout << std::setw(28) << std::left << name << std::right << " time/frame: " << std::fixed
+              << std::setprecision(2) << std::setw(8) << result.meanTime << " ms, error: " << std::setprecision(3)
+              << result.error << " px" << std::endl;
+
+    INFO("Tracker " << name);
+    CHECK(result.error < 1.);
+
+    if (g_runBenchmark) {
+      BENCHMARK("Track " + name) { return trackSequence(types[i], frames).error; };
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Catch::Session session; // There must be exactly one instance
+
+  // Build a new parser on top of Catch's
+  using namespace Catch::clara;
+  auto cli = session.cli()         // Get Catch's composite command line parser
+             | Opt(g_runBenchmark) // bind variable to a new option, with a hint string
+                   ["--benchmark"] // the option names it will respond to
+             ("run benchmark?")    // description string for the help output
+             | Opt(g_nbFrames, "nbFrames")["--nbFrames"]("Number of frames of the sequence")
+             | Opt(g_templateSize, "templateSize")["--templateSize"]("Size in pixel of the square template");
+
+  // Now pass the new composite back to Catch so it uses that
+  session.cli(cli);
+
+  // Let Catch (using Clara) parse the command line
+  session.applyCommandLine(argc, argv);
+
+  int numFailed = session.run();
+
+  // numFailed is clamped to 255 as some unices only use the lower 8 bits.
+  // This clamping has already been applied, so just return it here
+  // You can also do any post run clean-up here
+  return numFailed;
+}
+#else
+#include <iostream>
+
+int main() { return 0; }
+#endif
@@ -41,6 +41,7 @@
 
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpMatrixf.h>
 #include <visp3/visual_features/vpBasicFeature.h>
 
 /*!
@@ -120,6 +121,7 @@ public:
   void init(unsigned int _nbr, unsigned int _nbc, double _Z);
   vpMatrix interaction(unsigned int select = FEATURE_ALL);
   void interaction(vpMatrix &L);
+  void interaction(vpMatrixf &L);
 
   vpFeatureLuminance &operator=(const vpFeatureLuminance &f);
 
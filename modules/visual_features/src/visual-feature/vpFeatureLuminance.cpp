@@ -246,6 +246,46 @@ void vpFeatureLuminance::interaction(vpMatrix &L)
   }
 }
 
+/*!
+  Compute the interaction matrix \f$ L_I \f$ in single precision. Each row
+  is computed in double precision before being rounded to float. This is
+  useful for large images where the normal equations can then be accumulated
+  in double precision with vpMatrixf::AtA() and vpMatrixf::AtB():
+
+  \code
+  vpMatrixf Lsd;
+  vpMatrix LTL;
+  vpColVector e, LTe;
+  sI.interaction(Lsd);
+  sI.error(sId, e);
+  Lsd.AtA(LTL);
+  Lsd.AtB(e, LTe);
+  \endcode
+
+  \sa interaction(vpMatrix &)
+*/
+void vpFeatureLuminance::interaction(vpMatrixf &L)
+{
+  L.resize(dim_s, 6, false, false);
+
+  float *ptr_L = L.data;
+  for (unsigned int m = 0; m < dim_s; m++) {
+    double Ix = pixInfo[m].Ix;
+    double Iy = pixInfo[m].Iy;
+
+    double x = pixInfo[m].x;
+    double y = pixInfo[m].y;
+    double Zinv = 1 / pixInfo[m].Z;
+
+    *ptr_L++ = static_cast<float>(Ix * Zinv);
+    *ptr_L++ = static_cast<float>(Iy * Zinv);
+    *ptr_L++ = static_cast<float>(-(x * Ix + y * Iy) * Zinv);
+    *ptr_L++ = static_cast<float>(-Ix * x * y - (1 + y * y) * Iy);
+    *ptr_L++ = static_cast<float>((1 + x * x) * Ix + Iy * x * y);
+    *ptr_L++ = static_cast<float>(Iy * x - Ix * y);
+  }
+}
+
 /*!
   Compute and return the interaction matrix \f$ L_I \f$. The computation is
   made thanks to the values of the luminance features \f$ I \f$